@@ -57,49 +57,53 @@ function init()
         onExit = exit
     })
 
-    g_window.setMinimumSize({
-        width = 600,
-        height = 480
-    })
     if musicChannel then
         g_sounds.preload(musicFilename)
     end
 
-    -- initialize in fullscreen mode on mobile devices
-    if g_window.getPlatformType() == 'X11-EGL' then
-        g_window.setFullscreen(true)
-    else
-        -- window size
-        local size = {
-            width = 800,
-            height = 600
-        }
-        size = g_settings.getSize('window-size', size)
-        g_window.resize(size)
-
-        -- window position, default is the screen center
-        local displaySize = g_window.getDisplaySize()
-        local defaultPos = {
-            x = (displaySize.width - size.width) / 2,
-            y = (displaySize.height - size.height) / 2
-        }
-        local pos = g_settings.getPoint('window-pos', defaultPos)
-        pos.x = math.max(pos.x, 0)
-        pos.y = math.max(pos.y, 0)
-        g_window.move(pos)
-
-        -- window maximized?
-        local maximized = g_settings.getBoolean('window-maximized', false)
-        if maximized then
-            g_window.maximize()
+    -- headless instances have no window to set up
+    if not g_app.isHeadless() then
+        g_window.setMinimumSize({
+            width = 600,
+            height = 480
+        })
+
+        -- initialize in fullscreen mode on mobile devices
+        if g_window.getPlatformType() == 'X11-EGL' then
+            g_window.setFullscreen(true)
+        else
+            -- window size
+            local size = {
+                width = 800,
+                height = 600
+            }
+            size = g_settings.getSize('window-size', size)
+            g_window.resize(size)
+
+            -- window position, default is the screen center
+            local displaySize = g_window.getDisplaySize()
+            local defaultPos = {
+                x = (displaySize.width - size.width) / 2,
+                y = (displaySize.height - size.height) / 2
+            }
+            local pos = g_settings.getPoint('window-pos', defaultPos)
+            pos.x = math.max(pos.x, 0)
+            pos.y = math.max(pos.y, 0)
+            g_window.move(pos)
+
+            -- window maximized?
+            local maximized = g_settings.getBoolean('window-maximized', false)
+            if maximized then
+                g_window.maximize()
+            end
         end
-    end
 
-    g_window.setTitle(g_app.getName())
-    g_window.setIcon('/images/clienticon')
+        g_window.setTitle(g_app.getName())
+        g_window.setIcon('/images/clienticon')
 
-    -- poll resize events
-    g_window.poll()
+        -- poll resize events
+        g_window.poll()
+    end
 
     -- generate machine uuid, this is a security measure for storing passwords
     if not g_crypt.setMachineUUID(g_settings.get('uuid')) then
@@ -114,9 +118,11 @@ function terminate()
         onExit = exit
     })
     -- save window configs
-    g_settings.set('window-size', g_window.getUnmaximizedSize())
-    g_settings.set('window-pos', g_window.getUnmaximizedPos())
-    g_settings.set('window-maximized', g_window.isMaximized())
+    if not g_app.isHeadless() then
+        g_settings.set('window-size', g_window.getUnmaximizedSize())
+        g_settings.set('window-pos', g_window.getUnmaximizedPos())
+        g_settings.set('window-maximized', g_window.isMaximized())
+    end
 end
 
 function exit()
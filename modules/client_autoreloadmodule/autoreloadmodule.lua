@@ -9,7 +9,9 @@ function init()
 end
 
 function live_module_reload(module)
-    if not module:isReloadble() or not module:canReload() then
+    -- modules with loaded dependents are fine: g_modules.reloadModule
+    -- reloads the dependents along with them
+    if not module:isReloadble() then
         return
     end
 
@@ -36,7 +38,7 @@ function live_module_reload(module)
             if newtime > time then
                 pcolored('Reloading ' .. name, 'green')
                 modules.client_terminal.flushLines()
-                module:reload()
+                g_modules.reloadModule(name)
                 files[filepath] = newtime
 
                 if name == 'client_terminal' then
@@ -36,6 +36,7 @@ local defaultOptions = {
     crosshair = 'default',
     enableHighlightMouseTarget = true,
     antialiasingMode = 1,
+    lightResolutionScale = 1,
     shadowFloorIntensity = 30,
     optimizeFps = true,
     forceEffectOptimization = false,
@@ -58,6 +59,7 @@ local audioButton
 
 local crosshairCombobox
 local antialiasingModeCombobox
+local lightResolutionScaleCombobox
 local floorViewModeCombobox
 
 function init()
@@ -133,6 +135,16 @@ function setupComboBox()
         setOption('antialiasingMode', comboBox:getCurrentOption().data)
     end
 
+    lightResolutionScaleCombobox = graphicsPanel:recursiveGetChildById('lightResolutionScale')
+
+    lightResolutionScaleCombobox:addOption('Full', 1)
+    lightResolutionScaleCombobox:addOption('Half', 2)
+    lightResolutionScaleCombobox:addOption('Quarter', 4)
+
+    lightResolutionScaleCombobox.onOptionChange = function(comboBox, option)
+        setOption('lightResolutionScale', comboBox:getCurrentOption().data)
+    end
+
     floorViewModeCombobox = graphicsPanel:recursiveGetChildById('floorViewMode')
 
     floorViewModeCombobox:addOption('Normal', 0)
@@ -313,6 +325,9 @@ function setOption(key, value, force)
     elseif key == 'antialiasingMode' then
         gameMapPanel:setAntiAliasingMode(value)
         antialiasingModeCombobox:setCurrentOptionByData(value, true)
+    elseif key == 'lightResolutionScale' then
+        gameMapPanel:setLightResolutionScale(value)
+        lightResolutionScaleCombobox:setCurrentOptionByData(value, true)
     elseif key == 'floorViewMode' then
         gameMapPanel:setFloorViewMode(value)
         floorViewModeCombobox:setCurrentOptionByData(value, true)
@@ -116,7 +116,7 @@ function HTTP.cancel(operationId)
   return g_http.cancel(operationId)
 end
 
-function HTTP.onGet(operationId, url, err, data)
+function HTTP.onGet(operationId, url, err, data, buffer)
   local operation = HTTP.operations[operationId]
   if operation == nil then
     return
@@ -124,21 +124,30 @@ function HTTP.onGet(operationId, url, err, data)
   if err and err:len() == 0 then
     err = nil
   end
-  if not err and operation.json then
-    if data:len() == 0 then
-      data = "null"
+  if not err and operation.json and buffer and buffer:hasJson() then
+    -- already parsed on the network thread, no decode or body copy needed
+    data = buffer:getJson()
+  else
+    -- large bodies arrive only through the buffer handle, materialize on demand
+    if buffer and data:len() == 0 and buffer:getLength() > 0 then
+      data = buffer:getData()
     end
-    local status, result = pcall(function() return json.decode(data) end)
-    if not status then
-      err = "JSON ERROR: " .. result
-      if data and data:len() > 0 then
-        err = err .. " (" .. data:sub(1, 100) .. ")"
+    if not err and operation.json then
+      if data:len() == 0 then
+        data = "null"
       end
-    end  
-    data = result
+      local status, result = pcall(function() return json.decode(data) end)
+      if not status then
+        err = "JSON ERROR: " .. result
+        if data and data:len() > 0 then
+          err = err .. " (" .. data:sub(1, 100) .. ")"
+        end
+      end
+      data = result
+    end
   end
   if operation.callback then
-    operation.callback(data, err)
+    operation.callback(data, err, buffer)
   end
 end
 
@@ -150,7 +159,7 @@ function HTTP.onGetProgress(operationId, url, progress)
   
 end
 
-function HTTP.onPost(operationId, url, err, data)
+function HTTP.onPost(operationId, url, err, data, buffer)
   local operation = HTTP.operations[operationId]
   if operation == nil then
     return
@@ -158,21 +167,30 @@ function HTTP.onPost(operationId, url, err, data)
   if err and err:len() == 0 then
     err = nil
   end
-  if not err and operation.json then
-    if data:len() == 0 then
-      data = "null"
+  if not err and operation.json and buffer and buffer:hasJson() then
+    -- already parsed on the network thread, no decode or body copy needed
+    data = buffer:getJson()
+  else
+    -- large bodies arrive only through the buffer handle, materialize on demand
+    if buffer and data:len() == 0 and buffer:getLength() > 0 then
+      data = buffer:getData()
     end
-    local status, result = pcall(function() return json.decode(data) end)
-    if not status then
-      err = "JSON ERROR: " .. result
-      if data and data:len() > 0 then
-        err = err .. " (" .. data:sub(1, 100) .. ")"
+    if not err and operation.json then
+      if data:len() == 0 then
+        data = "null"
       end
-    end  
-    data = result
+      local status, result = pcall(function() return json.decode(data) end)
+      if not status then
+        err = "JSON ERROR: " .. result
+        if data and data:len() > 0 then
+          err = err .. " (" .. data:sub(1, 100) .. ")"
+        end
+      end
+      data = result
+    end
   end
   if operation.callback then
-    operation.callback(data, err)
+    operation.callback(data, err, buffer)
   end
 end
 
@@ -183,7 +201,7 @@ function HTTP.onPostProgress(operationId, url, progress)
   end
 end
 
-function HTTP.onDownload(operationId, url, err, path, checksum)
+function HTTP.onDownload(operationId, url, err, path, checksum, buffer)
   local operation = HTTP.operations[operationId]
   if operation == nil then
     return
@@ -198,7 +216,7 @@ function HTTP.onDownload(operationId, url, err, path, checksum)
       end
       operation.callback('/downloads/' .. path, err)    
     else
-      operation.callback(path, checksum, err)
+      operation.callback(path, checksum, err, buffer)
     end
   end
 end
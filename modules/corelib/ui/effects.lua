@@ -1,47 +1,39 @@
 -- @docclass
 g_effects = {}
 
+-- fades run on the native tween engine, ticked once per frame in C++
+-- instead of rescheduling a lua event every few milliseconds
 function g_effects.fadeIn(widget, time, elapsed)
-    if not elapsed then
-        elapsed = 0
-    end
     if not time then
         time = 300
     end
-    widget:setOpacity(math.min(elapsed / time, 1))
-    removeEvent(widget.fadeEvent)
-    if elapsed < time then
-        removeEvent(widget.fadeEvent)
-        widget.fadeEvent = scheduleEvent(function()
-            g_effects.fadeIn(widget, time, elapsed + 30)
-        end, 30)
-    else
-        widget.fadeEvent = nil
+    if elapsed then
+        widget:setOpacity(math.min(elapsed / time, 1))
     end
+    g_effects.cancelFade(widget)
+    local remaining = math.max((1 - widget:getOpacity()) * time, 1)
+    widget.fadeTween = widget:tween():fadeTo(1):setDuration(remaining)
+    widget.fadeTween:start()
 end
 
 function g_effects.fadeOut(widget, time, elapsed)
-    if not elapsed then
-        elapsed = 0
-    end
     if not time then
         time = 300
     end
-    elapsed = math.max((1 - widget:getOpacity()) * time, elapsed)
-    removeEvent(widget.fadeEvent)
-    widget:setOpacity(math.max((time - elapsed) / time, 0))
-    if elapsed < time then
-        widget.fadeEvent = scheduleEvent(function()
-            g_effects.fadeOut(widget, time, elapsed + 30)
-        end, 30)
-    else
-        widget.fadeEvent = nil
+    if elapsed then
+        widget:setOpacity(math.max((time - elapsed) / time, 0))
     end
+    g_effects.cancelFade(widget)
+    local remaining = math.max(widget:getOpacity() * time, 1)
+    widget.fadeTween = widget:tween():fadeTo(0):setDuration(remaining)
+    widget.fadeTween:start()
 end
 
 function g_effects.cancelFade(widget)
-    removeEvent(widget.fadeEvent)
-    widget.fadeEvent = nil
+    if widget.fadeTween then
+        widget.fadeTween:stop()
+        widget.fadeTween = nil
+    end
 end
 
 function g_effects.startBlink(widget, duration, interval, clickCancel)
@@ -48,9 +48,14 @@ function destroy(container)
 end
 
 function refreshContainerItems(container)
+    -- only touch the widgets whose slot actually changed, a one item move
+    -- in a full backpack repaints one or two cells instead of all of them
     for slot = 0, container:getCapacity() - 1 do
         local itemWidget = container.itemsPanel:getChildById('item' .. slot)
-        itemWidget:setItem(container:getItem(slot))
+        local item = container:getItem(slot)
+        if itemWidget:getItem() ~= item then
+            itemWidget:setItem(item)
+        end
     end
 
     if container:hasPages() then
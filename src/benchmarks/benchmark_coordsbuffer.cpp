@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <framework/graphics/coordsbuffer.h>
+
+static void BM_CoordsBufferAddRect(benchmark::State& state)
+{
+    const int rects = state.range(0);
+    CoordsBuffer coords;
+
+    for (auto _ : state) {
+        coords.clear();
+        for (int i = 0; i < rects; ++i) {
+            const Rect dest(i % 64 * 32, i / 64 * 32, 32, 32);
+            coords.addRect(dest);
+        }
+        benchmark::DoNotOptimize(coords.getVertexCount());
+    }
+
+    state.SetItemsProcessed(state.iterations() * rects);
+}
+BENCHMARK(BM_CoordsBufferAddRect)->Arg(256)->Arg(2048);
+
+static void BM_CoordsBufferAddTexturedRect(benchmark::State& state)
+{
+    const int rects = state.range(0);
+    const Rect src(0, 0, 32, 32);
+    CoordsBuffer coords;
+
+    for (auto _ : state) {
+        coords.clear();
+        for (int i = 0; i < rects; ++i) {
+            const Rect dest(i % 64 * 32, i / 64 * 32, 32, 32);
+            coords.addRect(dest, src);
+        }
+        benchmark::DoNotOptimize(coords.getVertexCount());
+    }
+
+    state.SetItemsProcessed(state.iterations() * rects);
+}
+BENCHMARK(BM_CoordsBufferAddTexturedRect)->Arg(256)->Arg(2048);
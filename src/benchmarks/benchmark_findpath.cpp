@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <client/map.h>
+
+static void BM_MapFindPath(benchmark::State& state)
+{
+    // the synthetic map is the default-constructed world: no tiles are
+    // known, so the search crosses unseen minimap tiles at uniform cost
+    const int distance = state.range(0);
+    const Position start(1000, 1000, 7);
+    const Position goal(1000 + distance, 1000 + distance, 7);
+
+    for (auto _ : state) {
+        // invalidate the path cache, otherwise only the first iteration searches
+        g_map.notificateTileUpdate(start, nullptr, Otc::OPERATION_CLEAN);
+
+        auto result = g_map.findPath(start, goal, 100000, Otc::PathFindAllowNotSeenTiles);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapFindPath)->Arg(8)->Arg(16)->Arg(32)->Arg(64);
+
+static void BM_MapFindPathCached(benchmark::State& state)
+{
+    const Position start(1000, 1000, 7);
+    const Position goal(1032, 1032, 7);
+
+    for (auto _ : state) {
+        auto result = g_map.findPath(start, goal, 100000, Otc::PathFindAllowNotSeenTiles);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapFindPathCached);
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <framework/net/inputmessage.h>
+
+namespace
+{
+    // alternating integers and a short string, the shape of a typical
+    // server payload (creature updates, container items, market offers)
+    std::string makePacket(const size_t blocks)
+    {
+        std::string packet;
+        for (size_t i = 0; i < blocks; ++i) {
+            packet.push_back(static_cast<char>(i));
+            const uint16_t u16 = i * 7;
+            packet.append(reinterpret_cast<const char*>(&u16), 2);
+            const uint32_t u32 = i * 2654435761u;
+            packet.append(reinterpret_cast<const char*>(&u32), 4);
+            const uint16_t len = 8;
+            packet.append(reinterpret_cast<const char*>(&len), 2);
+            packet.append("itemname");
+        }
+        return packet;
+    }
+}
+
+static void BM_InputMessageParse(benchmark::State& state)
+{
+    const auto& packet = makePacket(state.range(0));
+    const auto& msg = InputMessage::create();
+
+    for (auto _ : state) {
+        msg->setBuffer(packet);
+        msg->setReadPos(InputMessage::MAX_HEADER_SIZE);
+        while (msg->getUnreadSize() >= 17) {
+            benchmark::DoNotOptimize(msg->getU8());
+            benchmark::DoNotOptimize(msg->getU16());
+            benchmark::DoNotOptimize(msg->getU32());
+            benchmark::DoNotOptimize(msg->getString());
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * packet.size());
+}
+BENCHMARK(BM_InputMessageParse)->Arg(64)->Arg(512)->Arg(2048);
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <framework/otml/otml.h>
+
+#include <sstream>
+
+namespace
+{
+    // nested widget-style document, the shape of the .otui/.otmod files
+    // parsed on every module load
+    std::string makeDocument(const int panels)
+    {
+        std::string doc;
+        for (int i = 0; i < panels; ++i) {
+            doc += stdext::format("Panel\n  id: panel%d\n  size: 256 128\n  margin: 2 4 2 4\n", i);
+            for (int j = 0; j < 8; ++j) {
+                doc += stdext::format("  Button\n    id: button%d\n    text: Click %d\n    enabled: true\n    opacity: 0.87\n", j, j);
+            }
+        }
+        return doc;
+    }
+}
+
+static void BM_OtmlParse(benchmark::State& state)
+{
+    const auto& doc = makeDocument(state.range(0));
+
+    for (auto _ : state) {
+        std::istringstream in(doc);
+        const auto& parsed = OTMLDocument::parse(in, "benchmark");
+        benchmark::DoNotOptimize(parsed->size());
+    }
+
+    state.SetBytesProcessed(state.iterations() * doc.size());
+}
+BENCHMARK(BM_OtmlParse)->Arg(4)->Arg(32);
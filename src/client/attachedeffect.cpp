@@ -56,7 +56,16 @@ void AttachedEffect::draw(const Point& dest, bool isOnTop, LightView* lightView)
 
     if (m_shader) g_drawPool.setShaderProgram(m_shader, true);
     if (m_opacity < 100) g_drawPool.setOpacity(getOpacity(), true);
-    m_thingType->draw(dest - (dirControl.offset * g_drawPool.getScaleFactor()), 0, m_direction, 0, 0, getCurrentAnimationPhase(), Otc::DrawThingsAndLights, Color::white, lightView);
+
+    // effects of the same type all sample the same sprite sheet, so the
+    // on-top pass groups them the way missiles already do: every aura in
+    // the scene appends coords to one pool entry instead of each issuing
+    // its own draw; the bottom pass stays ungrouped to keep its stacking
+    // against the owner
+    static const DrawConductor GROUPED_CONDUCTOR{ true, DrawOrder::FIFTH };
+    const auto& conductor = isOnTop ? GROUPED_CONDUCTOR : DEFAULT_DRAW_CONDUCTOR;
+
+    m_thingType->draw(dest - (dirControl.offset * g_drawPool.getScaleFactor()), 0, m_direction, 0, 0, getCurrentAnimationPhase(), Otc::DrawThingsAndLights, Color::white, lightView, conductor);
 }
 
 int AttachedEffect::getCurrentAnimationPhase()
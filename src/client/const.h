@@ -46,6 +46,11 @@ namespace Otc
         DrawBars = 1 << 2,
         DrawNames = 1 << 3,
         DrawManaBar = 1 << 4,
+        // zoom detail tiers set by MapView::drawFloor() once tiles shrink
+        // to a few on-screen pixels: low drops effects and animated texts,
+        // minimal also collapses outfit layers and per-tile elevation
+        DrawLowDetail = 1 << 5,
+        DrawMinimalDetail = 1 << 6,
         DrawThingsAndLights = DrawThings | DrawLights,
         DrawCreatureInfo = DrawBars | DrawNames | DrawManaBar,
     };
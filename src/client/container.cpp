@@ -48,7 +48,7 @@ void Container::onAddItem(const ItemPtr& item, int slot)
     ++m_size;
     // indicates that there is a new item on next page
     if (m_hasPages && slot > m_capacity) {
-        callLuaField("onSizeChange", m_size);
+        notifySizeChange();
         return;
     }
 
@@ -58,7 +58,7 @@ void Container::onAddItem(const ItemPtr& item, int slot)
         m_items.emplace_back(item);
     updateItemsPositions();
 
-    callLuaField("onSizeChange", m_size);
+    notifySizeChange();
     callLuaField("onAddItem", slot, item);
 }
 
@@ -97,7 +97,7 @@ void Container::onRemoveItem(int slot, const ItemPtr& lastItem)
     slot -= m_firstIndex;
     if (m_hasPages && slot >= static_cast<int>(m_items.size())) {
         --m_size;
-        callLuaField("onSizeChange", m_size);
+        notifySizeChange();
         return;
     }
 
@@ -118,7 +118,7 @@ void Container::onRemoveItem(int slot, const ItemPtr& lastItem)
 
     updateItemsPositions();
 
-    callLuaField("onSizeChange", m_size);
+    notifySizeChange();
     callLuaField("onRemoveItem", slot, item);
 }
 
@@ -127,3 +127,27 @@ void Container::updateItemsPositions()
     for (int slot = 0; slot < static_cast<int>(m_items.size()); ++slot)
         m_items[slot]->setPosition(getSlotPosition(slot));
 }
+
+void Container::commitUpdate()
+{
+    if (m_pendingUpdates == 0 || --m_pendingUpdates > 0)
+        return;
+
+    if (m_sizeChanged) {
+        m_sizeChanged = false;
+        callLuaField("onSizeChange", m_size);
+    }
+}
+
+void Container::notifySizeChange()
+{
+    // onSizeChange drives the full window refresh, so inside a transaction
+    // it is deferred to commitUpdate; the per slot onAddItem/onRemoveItem
+    // events still fire immediately for anyone listening to them
+    if (m_pendingUpdates > 0) {
+        m_sizeChanged = true;
+        return;
+    }
+
+    callLuaField("onSizeChange", m_size);
+}
@@ -48,6 +48,14 @@ public:
     int getFirstIndex() { return m_firstIndex; }
     ItemPtr findItemById(uint32_t itemId, int subType) const;
 
+    // transactional updates: between beginUpdate and the matching
+    // commitUpdate the onSizeChange notification is coalesced, so a burst
+    // of slot packets repaints the container window once instead of once
+    // per item; calls may nest, only the outermost commit notifies
+    void beginUpdate() { ++m_pendingUpdates; }
+    void commitUpdate();
+    bool isUpdating() { return m_pendingUpdates > 0; }
+
 protected:
     Container(uint8_t id, uint8_t capacity, const std::string_view name, const ItemPtr& containerItem, bool hasParent, bool isUnlocked, bool hasPages, uint16_t containerSize, uint16_t firstIndex)
         :m_id(id), m_capacity(capacity), m_containerItem(containerItem), m_name(name), m_hasParent(hasParent), m_unlocked(isUnlocked), m_hasPages(hasPages), m_size(containerSize), m_firstIndex(firstIndex)
@@ -64,6 +72,7 @@ protected:
 
 private:
     void updateItemsPositions();
+    void notifySizeChange();
 
     uint8_t m_id;
     uint8_t m_capacity;
@@ -75,5 +84,7 @@ private:
     bool m_hasPages;
     uint16_t m_size;
     uint16_t m_firstIndex;
+    int m_pendingUpdates{ 0 };
+    bool m_sizeChanged{ false };
     std::deque<ItemPtr> m_items;
 };
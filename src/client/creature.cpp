@@ -33,6 +33,7 @@
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/graphics/drawpoolmanager.h>
+#include <framework/graphics/framebuffer.h>
 #include <framework/graphics/graphics.h>
 #include <framework/graphics/texturemanager.h>
 
@@ -40,6 +41,42 @@ double Creature::speedA = 0;
 double Creature::speedB = 0;
 double Creature::speedC = 0;
 
+namespace
+{
+    // animation LOD policy: creatures within NEAR_RANGE of the camera on
+    // its floor animate at full rate, farther ones at half, anything past
+    // FAR_RANGE or on another floor at quarter; a dense scene (boss events
+    // routinely show hundreds of creatures) drops everyone one extra level
+    constexpr int LOD_NEAR_RANGE = 5;
+    constexpr int LOD_FAR_RANGE = 9;
+    constexpr size_t LOD_DENSE_CREATURES = 150;
+
+    Position g_lodCamera;
+    uint8_t g_lodDensityPenalty = 0;
+}
+
+void Creature::setAnimationLodReference(const Position& camera, const size_t creatureCount)
+{
+    g_lodCamera = camera;
+    g_lodDensityPenalty = creatureCount > LOD_DENSE_CREATURES ? 1 : 0;
+}
+
+void Creature::updateAnimationLod()
+{
+    if (isLocalPlayer() || !g_lodCamera.isValid()) {
+        m_animationLod = 0;
+        return;
+    }
+
+    uint8_t lod = 0;
+    if (m_position.z != g_lodCamera.z)
+        lod = 2;
+    else if (!m_position.isInRange(g_lodCamera, LOD_NEAR_RANGE, LOD_NEAR_RANGE))
+        lod = m_position.isInRange(g_lodCamera, LOD_FAR_RANGE, LOD_FAR_RANGE) ? 1 : 2;
+
+    m_animationLod = std::min<uint8_t>(lod + g_lodDensityPenalty, 2);
+}
+
 Creature::Creature() :m_type(Proto::CreatureTypeUnknown)
 {
     m_name.setFont(g_fonts.getFont("verdana-11px-rounded"));
@@ -66,6 +103,9 @@ void Creature::draw(const Point& dest, uint32_t flags, LightView* lightView)
         return;
 
     if (flags & Otc::DrawThings) {
+        // grade the animation rate by relevance before any phase is read
+        updateAnimationLod();
+
         if (m_showTimedSquare) {
             g_drawPool.addBoundingRect(Rect(dest + (m_walkOffset - getDisplacement() + 2) * g_drawPool.getScaleFactor(), Size(28 * g_drawPool.getScaleFactor())), m_timedSquareColor, std::max<int>(static_cast<int>(2 * g_drawPool.getScaleFactor()), 1));
         }
@@ -76,10 +116,12 @@ void Creature::draw(const Point& dest, uint32_t flags, LightView* lightView)
 
         const auto& _dest = dest + m_walkOffset * g_drawPool.getScaleFactor();
 
-        internalDraw(_dest, false, Color::white, lightView);
+        const bool baseLayerOnly = flags & Otc::DrawMinimalDetail;
+
+        internalDraw(_dest, false, Color::white, lightView, baseLayerOnly);
 
         if (isMarked())
-            internalDraw(_dest, true, getMarkedColor());
+            internalDraw(_dest, true, getMarkedColor(), nullptr, baseLayerOnly);
     }
 
     if (lightView && flags & Otc::DrawLights) {
@@ -99,7 +141,7 @@ void Creature::draw(const Point& dest, uint32_t flags, LightView* lightView)
     }
 }
 
-void Creature::internalDraw(Point dest, bool isMarked, const Color& color, LightView* lightView)
+void Creature::internalDraw(Point dest, bool isMarked, const Color& color, LightView* lightView, const bool baseLayerOnly)
 {
     int animationPhase = 0;
 
@@ -130,8 +172,10 @@ void Creature::internalDraw(Point dest, bool isMarked, const Color& color, Light
 
         const auto& datType = getThingType();
 
-        // yPattern => creature addon
-        for (int yPattern = 0; yPattern < getNumPatternY(); ++yPattern) {
+        // yPattern => creature addon; at overview zoom the outfit collapses
+        // to its base sprite, skipping addons and the color mask layers
+        const int numPatternY = baseLayerOnly ? 1 : getNumPatternY();
+        for (int yPattern = 0; yPattern < numPatternY; ++yPattern) {
             // continue if we dont have this addon
             if (yPattern > 0 && !(m_outfit.getAddons() & (1 << (yPattern - 1))))
                 continue;
@@ -139,9 +183,15 @@ void Creature::internalDraw(Point dest, bool isMarked, const Color& color, Light
             if (!isMarked && m_shader)
                 g_drawPool.setShaderProgram(m_shader, true, m_shaderAction);
 
-            datType->draw(dest, 0, m_numPatternX, yPattern, m_numPatternZ, animationPhase, Otc::DrawThingsAndLights, color);
+            const bool colorize = m_drawOutfitColor && !isMarked && !baseLayerOnly && getLayers() > 1;
+
+            // prefer the cached composed texture, which draws the colored
+            // outfit in a single pass without breaking the pool batch
+            const auto& composedTexture = colorize ? datType->getColorizedTexture(animationPhase, m_outfit) : nullptr;
 
-            if (m_drawOutfitColor && !isMarked && getLayers() > 1) {
+            datType->draw(dest, 0, m_numPatternX, yPattern, m_numPatternZ, animationPhase, Otc::DrawThingsAndLights, color, nullptr, DEFAULT_DRAW_CONDUCTOR, composedTexture);
+
+            if (colorize && !composedTexture) {
                 g_drawPool.setCompositionMode(CompositionMode::MULTIPLY);
                 datType->draw(dest, SpriteMaskYellow, m_numPatternX, yPattern, m_numPatternZ, animationPhase, Otc::DrawThingsAndLights, m_outfit.getHeadColor());
                 datType->draw(dest, SpriteMaskRed, m_numPatternX, yPattern, m_numPatternZ, animationPhase, Otc::DrawThingsAndLights, m_outfit.getBodyColor());
@@ -163,6 +213,8 @@ void Creature::internalDraw(Point dest, bool isMarked, const Color& color, Light
             animateTicks = INVISIBLE_TICKS_PER_FRAME;
         }
 
+        animateTicks <<= m_animationLod;
+
         if (animationPhases > 1) {
             animationPhase = (g_clock.millis() % (static_cast<long long>(animateTicks) * animationPhases)) / animateTicks;
         }
@@ -190,9 +242,48 @@ void Creature::drawOutfit(const Rect& destRect, uint8_t size, const Color& color
     if (size > 0)
         frameSize = std::max<int>(frameSize * (size / 100.f), 2 * SPRITE_SIZE * (size / 100.f));
 
-    g_drawPool.bindFrameBuffer(frameSize);
+    // ui previews are drawn every frame but their pixels only change on an
+    // animation phase or outfit change; unchanged frames replay the cached
+    // buffer as a single quad instead of re-recording every layer
+    size_t previewHash = 0;
+    if (m_outfit.isCreature() && m_attachedEffects.empty() && !m_shader && !m_mountShader) {
+        stdext::hash_combine(previewHash, m_outfit.getCategory());
+        stdext::hash_combine(previewHash, m_outfit.getId());
+        stdext::hash_combine(previewHash, m_outfit.getAuxId());
+        stdext::hash_combine(previewHash, m_outfit.getMount());
+        stdext::hash_combine(previewHash, m_outfit.getHead());
+        stdext::hash_combine(previewHash, m_outfit.getBody());
+        stdext::hash_combine(previewHash, m_outfit.getLegs());
+        stdext::hash_combine(previewHash, m_outfit.getFeet());
+        stdext::hash_combine(previewHash, m_outfit.getAddons());
+        stdext::hash_combine(previewHash, m_outfit.getHeadColor().rgba());
+        stdext::hash_combine(previewHash, m_outfit.getBodyColor().rgba());
+        stdext::hash_combine(previewHash, m_outfit.getLegsColor().rgba());
+        stdext::hash_combine(previewHash, m_outfit.getFeetColor().rgba());
+        stdext::hash_combine(previewHash, m_direction);
+        stdext::hash_combine(previewHash, getCurrentAnimationPhase());
+        if (m_outfit.hasMount())
+            stdext::hash_combine(previewHash, getCurrentAnimationPhase(true));
+        stdext::hash_combine(previewHash, frameSize);
+        stdext::hash_combine(previewHash, color.rgba());
+    }
+
+    if (previewHash != 0 && previewHash == m_outfitPreviewHash && m_outfitPreviewBuffer) {
+        g_drawPool.drawFrameBuffer(m_outfitPreviewBuffer, destRect);
+        return;
+    }
+
+    FrameBufferPtr frame;
+    if (previewHash != 0) {
+        if (!m_outfitPreviewBuffer)
+            m_outfitPreviewBuffer = std::make_shared<FrameBuffer>();
+        frame = m_outfitPreviewBuffer;
+        m_outfitPreviewHash = previewHash;
+    }
+
+    g_drawPool.bindFrameBuffer(frameSize, frame);
     internalDraw(Point(frameSize - SPRITE_SIZE) + getDisplacement(), false, color);
-    g_drawPool.releaseFrameBuffer(destRect);
+    g_drawPool.releaseFrameBuffer(destRect, frame);
 }
 
 void Creature::drawInformation(const MapPosInfo& mapRect, const Point& dest, bool useGray, int drawFlags)
@@ -497,7 +588,8 @@ void Creature::updateWalkAnimation()
             footAnimDelay /= 1.5;
     }
 
-    const int footDelay = std::max<int>(m_stepCache.getDuration(m_lastStepDirection) / footAnimDelay, minFootDelay);
+    // a reduced animation LOD paces the walk cycle down as well
+    const int footDelay = std::max<int>(m_stepCache.getDuration(m_lastStepDirection) / footAnimDelay, minFootDelay) << m_animationLod;
 
     if (m_footTimer.ticksElapsed() >= footDelay) {
         if (m_walkAnimationPhase == footAnimPhases) m_walkAnimationPhase = 1;
@@ -526,13 +618,17 @@ void Creature::updateWalkingTile()
     // determine new walking tile
     TilePtr newWalkingTile;
 
-    const Rect virtualCreatureRect(SPRITE_SIZE + (m_walkOffset.x - getDisplacementX()),
-                                   SPRITE_SIZE + (m_walkOffset.y - getDisplacementY()),
+    // pipelined pre-walks can carry the local player more than one tile
+    // away from its confirmed position, widen the search accordingly
+    const int range = std::max<int>(1, (std::max<int>(std::abs(m_walkOffset.x), std::abs(m_walkOffset.y)) + SPRITE_SIZE - 1) / SPRITE_SIZE);
+
+    const Rect virtualCreatureRect(range * SPRITE_SIZE + (m_walkOffset.x - getDisplacementX()),
+                                   range * SPRITE_SIZE + (m_walkOffset.y - getDisplacementY()),
                                    SPRITE_SIZE, SPRITE_SIZE);
 
-    for (int xi = -1; xi <= 1 && !newWalkingTile; ++xi) {
-        for (int yi = -1; yi <= 1 && !newWalkingTile; ++yi) {
-            Rect virtualTileRect((xi + 1) * SPRITE_SIZE, (yi + 1) * SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE);
+    for (int xi = -range; xi <= range && !newWalkingTile; ++xi) {
+        for (int yi = -range; yi <= range && !newWalkingTile; ++yi) {
+            Rect virtualTileRect((xi + range) * SPRITE_SIZE, (yi + range) * SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE);
 
             // only render creatures where bottom right is inside tile rect
             if (virtualTileRect.contains(virtualCreatureRect.bottomRight())) {
@@ -558,24 +654,19 @@ void Creature::updateWalkingTile()
 
 void Creature::nextWalkUpdate()
 {
-    // remove any previous scheduled walk updates
-    if (m_walkUpdateEvent)
-        m_walkUpdateEvent->cancel();
-
     // do the update
     updateWalk();
     if (isLocalPlayer()) {
         g_map.notificateCameraMove(m_walkOffset);
     }
 
-    if (!m_walking) return;
-
-    // schedules next update
-    auto self = static_self_cast<Creature>();
-    m_walkUpdateEvent = g_dispatcher.scheduleEvent([self] {
-        self->m_walkUpdateEvent = nullptr;
-        self->nextWalkUpdate();
-    }, m_stepCache.walkDuration);
+    // while walking the creature is advanced once per frame in a single
+    // batch pass over all walking creatures, see Map::updateWalkingCreatures()
+    const auto self = static_self_cast<Creature>();
+    if (m_walking)
+        g_map.registerWalkingCreature(self);
+    else
+        g_map.unregisterWalkingCreature(self);
 }
 
 void Creature::updateWalk(const bool isPreWalking)
@@ -598,11 +689,8 @@ void Creature::updateWalk(const bool isPreWalking)
 
 void Creature::terminateWalk()
 {
-    // remove any scheduled walk update
-    if (m_walkUpdateEvent) {
-        m_walkUpdateEvent->cancel();
-        m_walkUpdateEvent = nullptr;
-    }
+    // leave the batched walk update pass
+    g_map.unregisterWalkingCreature(static_self_cast<Creature>());
 
     // now the walk has ended, do any scheduled turn
     if (m_walkTurnDirection != Otc::InvalidDirection) {
@@ -742,14 +830,17 @@ void Creature::setSkull(uint8_t skull) { callLuaField("onSkullChange", m_skull =
 void Creature::setShield(uint8_t shield) { callLuaField("onShieldChange", m_shield = shield); }
 void Creature::setEmblem(uint8_t emblem) { callLuaField("onEmblemChange", m_emblem = emblem); }
 
-void Creature::setTypeTexture(const std::string& filename) { m_typeTexture = g_textures.getTexture(filename); }
-void Creature::setIconTexture(const std::string& filename) { m_iconTexture = g_textures.getTexture(filename); }
-void Creature::setSkullTexture(const std::string& filename) { m_skullTexture = g_textures.getTexture(filename); }
-void Creature::setEmblemTexture(const std::string& filename) { m_emblemTexture = g_textures.getTexture(filename); }
+// info icons go through the sprite atlas: the information pool always
+// groups draws by state, so with every icon on the same page the skulls,
+// shields and emblems of all visible creatures collapse into one draw
+void Creature::setTypeTexture(const std::string& filename) { m_typeTexture = g_textures.getAtlasTexture(filename); }
+void Creature::setIconTexture(const std::string& filename) { m_iconTexture = g_textures.getAtlasTexture(filename); }
+void Creature::setSkullTexture(const std::string& filename) { m_skullTexture = g_textures.getAtlasTexture(filename); }
+void Creature::setEmblemTexture(const std::string& filename) { m_emblemTexture = g_textures.getAtlasTexture(filename); }
 
 void Creature::setShieldTexture(const std::string& filename, bool blink)
 {
-    m_shieldTexture = g_textures.getTexture(filename);
+    m_shieldTexture = g_textures.getAtlasTexture(filename);
     m_showShieldTexture = true;
 
     if (blink && !m_shieldBlink) {
@@ -881,12 +972,24 @@ uint16_t Creature::getCurrentAnimationPhase(const bool mount)
 
     auto* idleAnimator = thingType->getIdleAnimator();
     if (idleAnimator) {
-        if (m_walkAnimationPhase == 0) return idleAnimator->getPhase();
+        if (m_walkAnimationPhase == 0) {
+            if (m_animationLod == 0)
+                return idleAnimator->getPhase();
+
+            // under a reduced LOD the idle micro-animation is only sampled
+            // every few hundred milliseconds, holding the phase in between
+            auto& held = m_lodIdlePhase[mount ? 1 : 0];
+            if (held.refreshedAt == -1 || g_clock.millis() - held.refreshedAt >= (250 << m_animationLod)) {
+                held.phase = idleAnimator->getPhase();
+                held.refreshedAt = g_clock.millis();
+            }
+            return held.phase;
+        }
         return m_walkAnimationPhase + idleAnimator->getAnimationPhases() - 1;
     }
 
     if (thingType->isAnimateAlways()) {
-        const int ticksPerFrame = std::round(1000 / thingType->getAnimationPhases());
+        const int ticksPerFrame = static_cast<int>(std::round(1000 / thingType->getAnimationPhases())) << m_animationLod;
         return (g_clock.millis() % (static_cast<long long>(ticksPerFrame) * thingType->getAnimationPhases())) / ticksPerFrame;
     }
 
@@ -53,7 +53,13 @@ public:
 
     void draw(const Point& dest, uint32_t flags, LightView* lightView = nullptr) override;
 
-    void internalDraw(Point dest, bool isMarked, const Color& color, LightView* lightView = nullptr);
+    void internalDraw(Point dest, bool isMarked, const Color& color, LightView* lightView = nullptr, bool baseLayerOnly = false);
+
+    /// Frame reference for the animation level of detail: creatures far
+    /// from the camera (or any creature in a dense scene) advance their
+    /// phases at half or quarter rate, see updateAnimationLod()
+    static void setAnimationLodReference(const Position& camera, size_t creatureCount);
+    uint8_t getAnimationLod() const { return m_animationLod; }
 
     void drawOutfit(const Rect& destRect, uint8_t size, const Color& color = Color::white);
     void drawInformation(const MapPosInfo& mapRect, const Point& dest, bool useGray, int drawFlags);
@@ -165,11 +171,14 @@ protected:
     Timer m_walkTimer;
 
 private:
+    friend class Map;
+
     void nextWalkUpdate();
     void updateJump();
     void updateShield();
     void updateWalkingTile();
     void updateWalkAnimation();
+    void updateAnimationLod();
 
     uint16_t getCurrentAnimationPhase(bool mount = false);
 
@@ -201,6 +210,16 @@ private:
     uint8_t m_walkAnimationPhase{ 0 };
     uint8_t m_walkedPixels{ 0 };
 
+    // animation level of detail: 0 full rate, 1 half, 2 quarter; reduced
+    // levels hold the idle phase in m_lodIdlePhase between refreshes
+    struct LodIdlePhase
+    {
+        uint16_t phase{ 0 };
+        ticks_t refreshedAt{ -1 };
+    };
+    uint8_t m_animationLod{ 0 };
+    std::array<LodIdlePhase, 2> m_lodIdlePhase; // [outfit, mount]
+
     uint8_t m_exactSize{ 0 };
 
     uint16_t m_calculatedStepSpeed{ 0 };
@@ -235,7 +254,6 @@ private:
     CachedText m_name;
     CachedStep m_stepCache;
 
-    ScheduledEventPtr m_walkUpdateEvent;
     ScheduledEventPtr m_walkFinishAnimEvent;
     ScheduledEventPtr m_outfitColorUpdateEvent;
 
@@ -263,6 +281,11 @@ private:
     PainterShaderProgramPtr m_mountShader;
     std::function<void()> m_mountShaderAction{ nullptr };
 
+    // cached drawOutfit preview, replayed while the animation phase and
+    // outfit stay the same
+    FrameBufferPtr m_outfitPreviewBuffer;
+    size_t m_outfitPreviewHash{ 0 };
+
     ThingType* m_mountType{ nullptr };
 };
 
@@ -26,8 +26,10 @@
 #include "creature.h"
 #include "map.h"
 
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/xml/tinyxml.h>
+#include <framework/xml/xmlpullparser.h>
 
 CreatureManager g_creatures;
 
@@ -49,22 +51,31 @@ void CreatureManager::terminate()
     m_nullCreature = nullptr;
 }
 
-void Spawn::load(TiXmlElement* node)
+void Spawn::load(XmlPullParser& parser)
 {
     Position centerPos;
-    centerPos.x = node->readType<int>("centerx");
-    centerPos.y = node->readType<int>("centery");
-    centerPos.z = node->readType<int>("centerz");
+    centerPos.x = parser.readType<int>("centerx");
+    centerPos.y = parser.readType<int>("centery");
+    centerPos.z = parser.readType<int>("centerz");
 
     setCenterPos(centerPos);
-    setRadius(node->readType<int32_t>("radius"));
+    setRadius(parser.readType<int32_t>("radius"));
+
+    const int spawnDepth = parser.depth();
 
     CreatureTypePtr cType;
-    for (TiXmlElement* cNode = node->FirstChildElement(); cNode; cNode = cNode->NextSiblingElement()) {
-        if (cNode->ValueStr() != "monster" && cNode->ValueStr() != "npc")
-            throw Exception("invalid spawn-subnode %s", cNode->ValueStr());
+    XmlPullParser::Token token;
+    while ((token = parser.next()) != XmlPullParser::Token::End) {
+        if (token == XmlPullParser::Token::EndElement) {
+            if (parser.depth() < spawnDepth)
+                break;
+            continue;
+        }
+
+        if (parser.name() != "monster" && parser.name() != "npc")
+            throw Exception("invalid spawn-subnode %s", std::string{ parser.name() });
 
-        std::string cName = cNode->Attribute("name");
+        std::string cName = parser.attribute("name");
         stdext::tolower(cName);
         stdext::trim(cName);
         stdext::ucwords(cName);
@@ -72,20 +83,20 @@ void Spawn::load(TiXmlElement* node)
         if (!(cType = g_creatures.getCreatureByName(cName)))
             continue;
 
-        cType->setSpawnTime(cNode->readType<int>("spawntime"));
+        cType->setSpawnTime(parser.readType<int>("spawntime"));
         Otc::Direction dir = Otc::North;
-        auto dir_ = cNode->readType<int16_t>("direction");
+        auto dir_ = parser.readType<int16_t>("direction");
         if (dir_ >= Otc::East && dir_ <= Otc::West)
             dir = static_cast<Otc::Direction>(dir_);
 
         cType->setDirection(dir);
 
         Position placePos;
-        placePos.x = centerPos.x + cNode->readType<int>("x");
-        placePos.y = centerPos.y + cNode->readType<int>("y");
-        placePos.z = cNode->readType<int>("z");
+        placePos.x = centerPos.x + parser.readType<int>("x");
+        placePos.y = centerPos.y + parser.readType<int>("y");
+        placePos.z = parser.readType<int>("z");
 
-        cType->setRace(cNode->ValueStr() == "npc" ? CreatureRaceNpc : CreatureRaceMonster);
+        cType->setRace(parser.name() == "npc" ? CreatureRaceNpc : CreatureRaceMonster);
         addCreature(placePos, cType);
     }
 }
@@ -182,24 +193,40 @@ void CreatureManager::clearSpawns()
 
 void CreatureManager::loadMonsters(const std::string& file)
 {
-    TiXmlDocument doc;
-    doc.Parse(g_resources.readFileContents(file).c_str());
-    if (doc.Error())
-        throw Exception("cannot open monsters file '%s': '%s'", file, doc.ErrorDesc());
-
-    TiXmlElement* root = doc.FirstChildElement();
-    if (!root || root->ValueStr() != "monsters")
+    const std::string buffer = g_resources.readFileContents(file);
+    XmlPullParser parser(buffer);
+    if (parser.next() != XmlPullParser::Token::StartElement || parser.name() != "monsters")
         throw Exception("malformed monsters xml file");
 
-    for (TiXmlElement* monster = root->FirstChildElement(); monster; monster = monster->NextSiblingElement()) {
-        std::string fname = file.substr(0, file.find_last_of('/')) + '/' + monster->Attribute("file");
+    // read each monster file on this thread, physfs is not meant for
+    // concurrent access, but parse the buffers on the worker pool since
+    // the XML decode is what dominates the load time
+    std::vector<std::shared_future<CreatureTypePtr>> futures;
+
+    XmlPullParser::Token token;
+    while ((token = parser.next()) != XmlPullParser::Token::End) {
+        if (token != XmlPullParser::Token::StartElement || parser.depth() != 2)
+            continue;
+
+        std::string fname = file.substr(0, file.find_last_of('/')) + '/' + parser.attribute("file");
         if (fname.substr(fname.length() - 4) != ".xml")
             fname += ".xml";
 
-        loadSingleCreature(fname);
+        futures.emplace_back(g_asyncDispatcher.schedule([buffer = g_resources.readFileContents(fname), fname] {
+            try {
+                return parseCreatureBuffer(buffer);
+            } catch (const std::exception& e) {
+                g_logger.error(stdext::format("Failed to load creature '%s': %s", fname, e.what()));
+                return CreatureTypePtr(nullptr);
+            }
+        }));
+    }
+
+    for (const auto& future : futures) {
+        if (const auto& creature = future.get())
+            m_creatures.emplace_back(creature);
     }
 
-    doc.Clear();
     m_loaded = true;
 }
 
@@ -235,24 +262,22 @@ void CreatureManager::loadSpawns(const std::string& fileName)
     }
 
     try {
-        TiXmlDocument doc;
-        doc.Parse(g_resources.readFileContents(fileName).c_str());
-        if (doc.Error())
-            throw Exception("cannot load spawns xml file '%s: '%s'", fileName, doc.ErrorDesc());
-
-        TiXmlElement* root = doc.FirstChildElement();
-        if (!root || root->ValueStr() != "spawns")
+        const std::string buffer = g_resources.readFileContents(fileName);
+        XmlPullParser parser(buffer);
+        if (parser.next() != XmlPullParser::Token::StartElement || parser.name() != "spawns")
             throw Exception("malformed spawns file");
 
-        for (TiXmlElement* node = root->FirstChildElement(); node; node = node->NextSiblingElement()) {
-            if (node->ValueTStr() != "spawn")
+        XmlPullParser::Token token;
+        while ((token = parser.next()) != XmlPullParser::Token::End) {
+            if (token != XmlPullParser::Token::StartElement)
+                continue;
+            if (parser.name() != "spawn")
                 throw Exception("invalid spawn node");
 
             const auto& spawn = std::make_shared<Spawn>();
-            spawn->load(node);
+            spawn->load(parser);
             m_spawns.emplace(spawn->getCenterPos(), spawn);
         }
-        doc.Clear();
         m_spawnLoaded = true;
     } catch (const std::exception& e) {
         g_logger.error(stdext::format("Failed to load '%s': %s", fileName, e.what()));
@@ -286,60 +311,54 @@ void CreatureManager::saveSpawns(const std::string& fileName)
 
 void CreatureManager::loadCreatureBuffer(const std::string& buffer)
 {
-    TiXmlDocument doc;
-    doc.Parse(buffer.c_str());
-    if (doc.Error())
-        throw Exception("cannot load creature buffer: %s", doc.ErrorDesc());
-
-    TiXmlElement* root = doc.FirstChildElement();
+    if (const auto& newType = parseCreatureBuffer(buffer))
+        m_creatures.emplace_back(newType);
+}
 
-    if (!root || (root->ValueStr() != "monster" && root->ValueStr() != "npc"))
+CreatureTypePtr CreatureManager::parseCreatureBuffer(const std::string& buffer)
+{
+    // touches no manager state, so monster files can be parsed
+    // concurrently on the worker pool
+    XmlPullParser parser(buffer);
+    if (parser.next() != XmlPullParser::Token::StartElement || (parser.name() != "monster" && parser.name() != "npc"))
         throw Exception("invalid root tag name");
 
-    std::string cName = root->Attribute("name");
-
+    std::string cName = parser.attribute("name");
     stdext::tolower(cName);
     stdext::trim(cName);
     stdext::ucwords(cName);
 
     const auto& newType = std::make_shared<CreatureType>(cName);
-    for (TiXmlElement* attrib = root->FirstChildElement(); attrib; attrib = attrib->NextSiblingElement()) {
-        if (attrib->ValueStr() != "look")
-            continue;
 
-        internalLoadCreatureBuffer(attrib, newType);
-        break;
-    }
-
-    doc.Clear();
-}
+    XmlPullParser::Token token;
+    while ((token = parser.next()) != XmlPullParser::Token::End) {
+        if (token != XmlPullParser::Token::StartElement || parser.name() != "look")
+            continue;
 
-void CreatureManager::internalLoadCreatureBuffer(const TiXmlElement* attrib, const CreatureTypePtr& m)
-{
-    if (std::find(m_creatures.begin(), m_creatures.end(), m) != m_creatures.end())
-        return;
+        Outfit out;
 
-    Outfit out;
+        if (const auto type = parser.readType<int32_t>("type"); type > 0) {
+            out.setCategory(ThingCategoryCreature);
+            out.setId(type);
+        } else {
+            out.setCategory(ThingCategoryItem);
+            out.setAuxId(parser.readType<int32_t>("typeex"));
+        }
 
-    if (const auto type = attrib->readType<int32_t>("type"); type > 0) {
-        out.setCategory(ThingCategoryCreature);
-        out.setId(type);
-    } else {
-        out.setCategory(ThingCategoryItem);
-        out.setAuxId(attrib->readType<int32_t>("typeex"));
-    }
+        out.setHead(parser.readType<int>("head"));
+        out.setBody(parser.readType<int>("body"));
+        out.setLegs(parser.readType<int>("legs"));
+        out.setFeet(parser.readType<int>("feet"));
+        out.setAddons(parser.readType<int>("addons"));
+        out.setMount(parser.readType<int>("mount"));
 
-    {
-        out.setHead(attrib->readType<int>("head"));
-        out.setBody(attrib->readType<int>("body"));
-        out.setLegs(attrib->readType<int>("legs"));
-        out.setFeet(attrib->readType<int>("feet"));
-        out.setAddons(attrib->readType<int>("addons"));
-        out.setMount(attrib->readType<int>("mount"));
+        newType->setOutfit(out);
+        return newType;
     }
 
-    m->setOutfit(out);
-    m_creatures.push_back(m);
+    // creatures without a look block were never registered before, keep
+    // that behavior
+    return nullptr;
 }
 
 const CreatureTypePtr& CreatureManager::getCreatureByName(std::string name)
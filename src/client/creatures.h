@@ -30,6 +30,8 @@
 #include "declarations.h"
 #include "outfit.h"
 
+class XmlPullParser;
+
 enum CreatureRace : uint8_t
 {
     CreatureRaceNone = 0,
@@ -55,7 +57,7 @@ public:
     void clear() { m_creatures.clear(); }
 
 protected:
-    void load(TiXmlElement* node);
+    void load(XmlPullParser& parser);
     void save(TiXmlElement* node);
 
 private:
@@ -127,7 +129,7 @@ public:
     const std::vector<CreatureTypePtr>& getCreatures() { return m_creatures; }
 
 protected:
-    void internalLoadCreatureBuffer(const TiXmlElement* attrib, const CreatureTypePtr& m);
+    static CreatureTypePtr parseCreatureBuffer(const std::string& buffer);
 
 private:
     std::vector<CreatureTypePtr> m_creatures;
@@ -23,9 +23,22 @@
 #include "effect.h"
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/graphicalapplication.h>
+#include "animator.h"
 #include "game.h"
 #include "map.h"
 
+namespace {
+    struct SharedPhase
+    {
+        ticks_t frame{ -1 };
+        int phase{ 0 };
+    };
+
+    // AoE casts spawn the same effect id on dozens of tiles with identical
+    // appear ticks, so one phase resolution per frame serves all of them
+    stdext::map<uint64_t, SharedPhase> g_sharedPhases;
+}
+
 void Effect::drawEffect(const Point& dest, uint32_t flags, int offsetX, int offsetY, LightView* lightView)
 {
     if (!canDraw()) return;
@@ -41,7 +54,7 @@ void Effect::drawEffect(const Point& dest, uint32_t flags, int offsetX, int offs
             return;
 
         // This requires a separate getPhaseAt method as using getPhase would make all magic effects use the same phase regardless of their appearance time
-        animationPhase = animator->getPhaseAt(m_animationTimer);
+        animationPhase = resolveAnimationPhase(animator);
     } else {
         // hack to fix some animation phases duration, currently there is no better solution
         int ticks = EFFECT_TICKS_PER_FRAME;
@@ -72,6 +85,32 @@ void Effect::drawEffect(const Point& dest, uint32_t flags, int offsetX, int offs
     getThingType()->draw(dest, 0, xPattern, yPattern, 0, animationPhase, flags, Color::white, lightView, m_drawConductor);
 }
 
+int Effect::resolveAnimationPhase(const Animator* animator)
+{
+    const uint64_t key = static_cast<uint64_t>(m_clientId) << 32 | (m_animationTimer.startTicks() & 0xffffffff);
+    const ticks_t now = g_clock.millis();
+
+    auto& entry = g_sharedPhases[key];
+    if (entry.frame != now) {
+        entry.frame = now;
+        entry.phase = animator->getPhaseAt(m_animationTimer);
+    }
+    const int phase = entry.phase;
+
+    // entries whose effects expired stop being refreshed; sweep them
+    // opportunistically so the cache stays a handful of keys
+    if (g_sharedPhases.size() > 64) {
+        for (auto it = g_sharedPhases.begin(); it != g_sharedPhases.end();) {
+            if (it->second.frame != now)
+                it = g_sharedPhases.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    return phase;
+}
+
 void Effect::onAppear()
 {
     if (g_game.getFeature(Otc::GameEnhancedAnimations)) {
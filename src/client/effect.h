@@ -44,6 +44,8 @@ protected:
     void onAppear() override;
 
 private:
+    int resolveAnimationPhase(const Animator* animator);
+
     Timer m_animationTimer;
 
     uint16_t m_duration{ 0 };
@@ -23,6 +23,7 @@
 #include "game.h"
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/resourcemanager.h>
 #include "container.h"
 #include "creature.h"
 #include "localplayer.h"
@@ -65,6 +66,11 @@ void Game::resetGameStates()
     m_localPlayer = nullptr;
     m_pingSent = 0;
     m_pingReceived = 0;
+    m_pingLost = 0;
+    m_pingSampleIndex = 0;
+    m_pingSampleCount = 0;
+    m_pingEwma = -1;
+    m_pingJitter = 0;
     m_unjustifiedPoints = UnjustifiedPoints();
     m_nextScheduledDir = Otc::InvalidDirection;
 
@@ -257,6 +263,17 @@ void Game::processPingBack()
 
         m_ping = m_pingTimer.elapsed_millis();
 
+        m_pingSamples[m_pingSampleIndex] = m_ping;
+        m_pingSampleIndex = (m_pingSampleIndex + 1) % m_pingSamples.size();
+        m_pingSampleCount = std::min(m_pingSampleCount + 1, m_pingSamples.size());
+
+        if (m_pingEwma < 0) {
+            m_pingEwma = m_ping;
+        } else {
+            m_pingJitter += (std::abs(m_ping - m_pingEwma) - m_pingJitter) / 4.0;
+            m_pingEwma += (m_ping - m_pingEwma) / 8.0;
+        }
+
         if (oldPing != m_ping)
             g_lua.callGlobalField("g_game", "onPingBack", m_ping);
     } else
@@ -265,6 +282,40 @@ void Game::processPingBack()
     m_pingEvent = g_dispatcher.scheduleEvent([] { g_game.ping(); }, m_pingDelay);
 }
 
+stdext::map<std::string, double> Game::getNetworkStats()
+{
+    stdext::map<std::string, double> stats;
+    stats["ping"] = m_ping;
+    stats["pingEwma"] = m_pingEwma;
+    stats["pingJitter"] = m_pingJitter;
+    stats["pingSent"] = m_pingSent;
+    stats["pingLost"] = m_pingLost;
+
+    if (m_pingSampleCount > 0) {
+        std::vector<ticks_t> sorted(m_pingSamples.begin(), m_pingSamples.begin() + m_pingSampleCount);
+        std::sort(sorted.begin(), sorted.end());
+        stats["pingMedian"] = sorted[m_pingSampleCount / 2];
+        stats["pingP95"] = sorted[m_pingSampleCount * 95 / 100];
+        stats["pingMax"] = sorted.back();
+    }
+
+    if (m_protocolGame) {
+        if (const auto& connection = m_protocolGame->getConnection()) {
+            stats["bytesSent"] = connection->getSentBytes();
+            stats["bytesReceived"] = connection->getReceivedBytes();
+            stats["sendFlushes"] = connection->getSentFlushes();
+            stats["timeouts"] = connection->getTimeouts();
+        }
+
+        // stream compression effectiveness; wire vs inflated bytes give the
+        // ratio the negotiated deflate layer achieves on this link
+        stats["compressedMessages"] = m_protocolGame->getCompressedMessages();
+        stats["compressedBytes"] = m_protocolGame->getCompressedBytes();
+        stats["inflatedBytes"] = m_protocolGame->getInflatedBytes();
+    }
+    return stats;
+}
+
 void Game::processTextMessage(Otc::MessageMode mode, const std::string_view text)
 {
     g_lua.callGlobalField("g_game", "onTextMessage", mode, text);
@@ -281,6 +332,8 @@ void Game::processOpenContainer(int containerId, const ItemPtr& containerItem, c
     const auto previousContainer = getContainer(containerId);
 
     m_containers[containerId] = container;
+    if (m_containerBatchDepth > 0)
+        container->beginUpdate();
     container->onAddItems(items);
 
     // we might want to close a container here
@@ -300,6 +353,28 @@ void Game::processCloseContainer(int containerId)
     }
 }
 
+void Game::beginContainerBatch()
+{
+    if (++m_containerBatchDepth > 1)
+        return;
+
+    for (const auto& it : m_containers) {
+        if (it.second)
+            it.second->beginUpdate();
+    }
+}
+
+void Game::endContainerBatch()
+{
+    if (m_containerBatchDepth == 0 || --m_containerBatchDepth > 0)
+        return;
+
+    for (const auto& it : m_containers) {
+        if (it.second)
+            it.second->commitUpdate();
+    }
+}
+
 void Game::processContainerAddItem(int containerId, const ItemPtr& item, int slot)
 {
     if (const auto& container = getContainer(containerId))
@@ -508,6 +583,29 @@ void Game::loginWorld(const std::string_view account, const std::string_view pas
     m_protocolGame->login(account, password, worldHost, static_cast<uint16_t>(worldPort), characterName, authenticatorToken, sessionKey);
     m_characterName = characterName;
     m_worldName = worldName;
+
+    // warm the in-game UI textures while the connecting screen is up, so
+    // first-open dialogs don't hitch on disk reads and png decodes
+    const auto& images = g_resources.listDirectoryFiles("/images/game", true, false, true);
+    g_resources.prefetch({ images.begin(), images.end() }, AsyncDispatcher::Priority::LOW);
+}
+
+void Game::playRecord(const std::string_view fileName, const bool maxSpeed)
+{
+    if (m_protocolGame || isOnline())
+        throw Exception("Unable to replay a session while already online or logging.");
+
+    // replay drives the same parse path as a live login, so the game
+    // state must be staged exactly like loginWorld does
+    resetGameStates();
+
+    m_localPlayer = std::make_shared<LocalPlayer>();
+    m_protocolGame = std::make_shared<ProtocolGame>();
+
+    if (!m_protocolGame->playRecord(fileName, maxSpeed)) {
+        m_protocolGame = nullptr;
+        m_localPlayer = nullptr;
+    }
 }
 
 void Game::cancelLogin()
@@ -1470,8 +1568,10 @@ void Game::ping()
     if (!m_protocolGame || !m_protocolGame->isConnected())
         return;
 
-    if (m_pingReceived != m_pingSent)
+    if (m_pingReceived != m_pingSent) {
+        ++m_pingLost;
         return;
+    }
 
     m_denyBotCall = false;
     m_protocolGame->sendPing();
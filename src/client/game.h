@@ -160,6 +160,7 @@ public:
     void loginWorld(const std::string_view account, const std::string_view password, const std::string_view worldName, const std::string_view worldHost, int worldPort, const std::string_view characterName, const std::string_view authenticatorToken, const std::string_view sessionKey);
     void cancelLogin();
     void forceLogout();
+    void playRecord(const std::string_view fileName, bool maxSpeed = false);
     void safeLogout();
 
     // walk related
@@ -330,6 +331,7 @@ public:
     bool isConnectionOk() { return m_protocolGame && m_protocolGame->getElapsedTicksSinceLastRead() < 5000; }
 
     int getPing() { return m_ping; }
+    stdext::map<std::string, double> getNetworkStats();
     ContainerPtr getContainer(int index) { return m_containers[index]; }
     stdext::map<int, ContainerPtr> getContainers() { return m_containers; }
     stdext::map<int, Vip> getVips() { return m_vips; }
@@ -352,6 +354,11 @@ public:
     std::string formatCreatureName(const std::string_view name);
     int findEmptyContainerId();
 
+    // brackets a burst of container slot packets into one transaction per
+    // open container, so each window refreshes once when the batch ends
+    void beginContainerBatch();
+    void endContainerBatch();
+
     void setLastSupportedVersion(int version)
     {
         m_lastSupportedVersion = version;
@@ -393,6 +400,7 @@ private:
     ProtocolGamePtr m_protocolGame;
     stdext::map<int, ContainerPtr> m_containers;
     stdext::map<int, Vip> m_vips;
+    int m_containerBatchDepth{ 0 };
 
     bool m_forceNewWalkingFormula{ false };
     bool m_online{ false };
@@ -403,8 +411,17 @@ private:
     ticks_t m_ping{ -1 };
     uint32_t m_pingSent{ 0 };
     uint32_t m_pingReceived{ 0 };
+    uint32_t m_pingLost{ 0 };
     uint32_t m_seq{ 0 };
 
+    // ring of recent round trips for the network stats surface; EWMA and
+    // jitter follow the usual RFC 6298 smoothing factors
+    std::array<ticks_t, 60> m_pingSamples{};
+    size_t m_pingSampleIndex{ 0 };
+    size_t m_pingSampleCount{ 0 };
+    double m_pingEwma{ -1 };
+    double m_pingJitter{ 0 };
+
     stdext::timer m_pingTimer;
     Timer m_dashTimer;
     uint16_t m_pingDelay{ 1000 };
@@ -26,6 +26,7 @@
 #include "map.h"
 
 #include <framework/core/resourcemanager.h>
+#include <framework/xml/xmlpullparser.h>
 
 HouseManager g_houses;
 
@@ -42,6 +43,7 @@ void House::setTile(const TilePtr& tile)
     tile->setFlag(TILESTATE_HOUSE);
     tile->setHouseId(getId());
     m_tiles.emplace(tile->getPosition(), tile);
+    g_houses.indexHouseTile(tile->getPosition(), static_self_cast<House>());
 }
 
 TilePtr House::getTile(const Position& position)
@@ -67,22 +69,22 @@ void House::removeDoorById(uint32_t doorId)
     m_doors[doorId] = nullptr;
 }
 
-void House::load(const TiXmlElement* elem)
+void House::load(const XmlPullParser& parser)
 {
-    std::string name = elem->Attribute("name");
+    std::string name = parser.attribute("name");
     if (name.empty())
         name = stdext::format("Unnamed house #%lu", getId());
 
     setName(name);
-    setRent(elem->readType<uint32_t >("rent"));
-    setSize(elem->readType<uint32_t >("size"));
-    setTownId(elem->readType<uint32_t >("townid"));
-    m_isGuildHall = elem->readType<bool>("guildhall");
+    setRent(parser.readType<uint32_t>("rent"));
+    setSize(parser.readType<uint32_t>("size"));
+    setTownId(parser.readType<uint32_t>("townid"));
+    m_isGuildHall = parser.readType<bool>("guildhall");
 
     Position entryPos;
-    entryPos.x = elem->readType<int>("entryx");
-    entryPos.y = elem->readType<int>("entryy");
-    entryPos.z = elem->readType<int>("entryz");
+    entryPos.x = parser.readType<int>("entryx");
+    entryPos.y = parser.readType<int>("entryy");
+    entryPos.z = parser.readType<int>("entryz");
     setEntry(entryPos);
 }
 
@@ -114,8 +116,12 @@ void HouseManager::addHouse(const HousePtr& house)
 void HouseManager::removeHouse(uint32_t houseId)
 {
     const auto it = findHouse(houseId);
-    if (it != m_houses.end())
-        m_houses.erase(it);
+    if (it == m_houses.end())
+        return;
+
+    for (const auto& [pos, tile] : (*it)->m_tiles)
+        m_tileIndex.erase(pos);
+    m_houses.erase(it);
 }
 
 HousePtr HouseManager::getHouse(uint32_t houseId)
@@ -124,6 +130,12 @@ HousePtr HouseManager::getHouse(uint32_t houseId)
     return it != m_houses.end() ? *it : nullptr;
 }
 
+HousePtr HouseManager::getHouseByPos(const Position& pos)
+{
+    const auto it = m_tileIndex.find(pos);
+    return it != m_tileIndex.end() ? it->second : nullptr;
+}
+
 HousePtr HouseManager::getHouseByName(const std::string_view name)
 {
     const auto it = std::find_if(m_houses.begin(), m_houses.end(),
@@ -134,25 +146,24 @@ HousePtr HouseManager::getHouseByName(const std::string_view name)
 void HouseManager::load(const std::string& fileName)
 {
     try {
-        TiXmlDocument doc;
-        doc.Parse(g_resources.readFileContents(fileName).c_str());
-        if (doc.Error())
-            throw Exception("failed to load '%s': %s (House XML)", fileName, doc.ErrorDesc());
-
-        TiXmlElement* root = doc.FirstChildElement();
-        if (!root || root->ValueTStr() != "houses")
+        const std::string buffer = g_resources.readFileContents(fileName);
+        XmlPullParser parser(buffer);
+        if (parser.next() != XmlPullParser::Token::StartElement || parser.name() != "houses")
             throw Exception("invalid root tag name");
 
-        for (TiXmlElement* elem = root->FirstChildElement(); elem; elem = elem->NextSiblingElement()) {
-            if (elem->ValueTStr() != "house")
+        XmlPullParser::Token token;
+        while ((token = parser.next()) != XmlPullParser::Token::End) {
+            if (token != XmlPullParser::Token::StartElement)
+                continue;
+            if (parser.name() != "house")
                 throw Exception("invalid house tag.");
 
-            const auto houseId = elem->readType<uint32_t >("houseid");
+            const auto houseId = parser.readType<uint32_t>("houseid");
             HousePtr house = getHouse(houseId);
             if (!house)
                 house = std::make_shared<House>(houseId), addHouse(house);
 
-            house->load(elem);
+            house->load(parser);
         }
     } catch (const std::exception& e) {
         g_logger.error(stdext::format("Failed to load '%s': %s", fileName, e.what()));
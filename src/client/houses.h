@@ -28,6 +28,8 @@
 
 #include <framework/luaengine/luaobject.h>
 
+class XmlPullParser;
+
 class House : public LuaObject
 {
 public:
@@ -61,7 +63,7 @@ public:
     void removeDoorById(uint32_t doorId);
 
 protected:
-    void load(const TiXmlElement* elem);
+    void load(const XmlPullParser& parser);
     void save(TiXmlElement* elem);
 
 private:
@@ -90,18 +92,26 @@ public:
     void removeHouse(uint32_t houseId);
     HousePtr getHouse(uint32_t houseId);
     HousePtr getHouseByName(const std::string_view name);
+    HousePtr getHouseByPos(const Position& pos);
+
+    // kept in sync by House::setTile, see m_tileIndex
+    void indexHouseTile(const Position& pos, const HousePtr& house) { m_tileIndex[pos] = house; }
 
     void load(const std::string& fileName);
     void save(const std::string& fileName);
 
     void sort();
-    void clear() { m_houses.clear(); }
+    void clear() { m_houses.clear(); m_tileIndex.clear(); }
     HouseList getHouseList() { return m_houses; }
     HouseList filterHouses(uint32_t townId);
 
 private:
     HouseList m_houses;
 
+    // position-keyed spatial hash over every house tile, so per-tile house
+    // resolution is O(1) instead of a scan over the whole house list
+    stdext::map<Position, HousePtr, Position::Hasher> m_tileIndex;
+
 protected:
     HouseList::iterator findHouse(uint32_t houseId);
 };
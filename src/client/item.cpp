@@ -229,7 +229,8 @@ int Item::calculateAnimationPhase()
     if (getIdleAnimator()) return getIdleAnimator()->getPhase();
 
     if (m_async) {
-        return (g_clock.millis() % (ITEM_TICKS_PER_FRAME * getAnimationPhases())) / ITEM_TICKS_PER_FRAME;
+        // the phase only depends on the type and the clock, share it
+        return getThingType()->getAsyncAnimationPhase();
     }
 
     if (g_clock.millis() - m_lastPhase >= ITEM_TICKS_PER_FRAME) {
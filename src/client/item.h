@@ -165,7 +165,7 @@ private:
 
 #ifdef FRAMEWORK_EDITOR
     uint16_t m_serverId{ 0 };
-    stdext::dynamic_storage<ItemAttr> m_attribs;
+    stdext::dynamic_storage<ItemAttr, uint8_t, uint16_t, uint32_t, Position, std::string> m_attribs;
     ItemVector m_containerItems;
 #endif
 };
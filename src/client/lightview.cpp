@@ -23,33 +23,112 @@
 #include "lightview.h"
 #include "map.h"
 #include "mapview.h"
+#include "shadermanager.h"
 #include "spritemanager.h"
 
 #include <framework/core/eventdispatcher.h>
 #include <framework/graphics/drawpoolmanager.h>
+#include <framework/graphics/shader/shadersources.h>
+
+ // radius is encoded in the color alpha (tiles / LIGHT_RADIUS_SCALE)
+static constexpr float LIGHT_RADIUS_SCALE = 25.5f;
+
+static constexpr std::string_view lightFragmentShader = "\n\
+    varying mediump vec2 v_TexCoord;\n\
+    uniform lowp vec4 u_Color;\n\
+    lowp vec4 calculatePixel() {\n\
+        mediump float radius = u_Color.a * 25.5;\n\
+        mediump float intensity = clamp(0.2 * radius * (1.0 - 2.0 * length(v_TexCoord - 0.5)), 0.0, 1.0);\n\
+        return vec4(u_Color.rgb * intensity, 1.0);\n\
+    }\n";
+
+// samples the map color and the light texture in the same fullscreen pass;
+// both are upside-down framebuffer textures, so the light uv is a pure
+// rescale of the map uv around the flipped origin
+static constexpr std::string_view compositionFragmentShader = "\n\
+    varying mediump vec2 v_TexCoord;\n\
+    uniform lowp vec4 u_Color;\n\
+    uniform sampler2D u_Tex0;\n\
+    uniform sampler2D u_Tex1;\n\
+    uniform highp vec2 u_LightUvScale;\n\
+    lowp vec4 calculatePixel() {\n\
+        mediump vec2 lightUv = vec2(v_TexCoord.x * u_LightUvScale.x, 1.0 - (1.0 - v_TexCoord.y) * u_LightUvScale.y);\n\
+        lowp vec4 map = texture2D(u_Tex0, v_TexCoord);\n\
+        return vec4(map.rgb * texture2D(u_Tex1, lightUv).rgb, map.a) * u_Color;\n\
+    }\n";
 
 LightView::LightView(const Size& size, const uint16_t tileSize) : m_pool(g_drawPool.get(DrawPoolType::LIGHT)) {
     resize(size, tileSize);
     g_mainDispatcher.addEvent([&] {
-        m_texture = std::make_shared<Texture>(m_mapSize);
-        m_texture->setSmooth(true);
+        m_framebuffer = std::make_shared<FrameBuffer>();
+        m_framebuffer->resize(bufferSize());
+
+        m_lightShader = std::make_shared<PainterShaderProgram>();
+        m_lightShader->addShaderFromSourceCode(ShaderType::VERTEX, std::string{ glslMainWithTexCoordsVertexShader } + glslPositionOnlyVertexShader.data());
+        m_lightShader->addShaderFromSourceCode(ShaderType::FRAGMENT, std::string{ lightFragmentShader });
+        if (!m_lightShader->link()) {
+            g_logger.error("unable to link light shader");
+            m_lightShader = nullptr;
+        }
+
+        m_compositionShader = std::make_shared<PainterShaderProgram>();
+        m_compositionShader->addShaderFromSourceCode(ShaderType::VERTEX, std::string{ glslMainWithTexCoordsVertexShader } + glslPositionOnlyVertexShader.data());
+        m_compositionShader->addShaderFromSourceCode(ShaderType::FRAGMENT, std::string{ compositionFragmentShader });
+        if (m_compositionShader->link()) {
+            m_compositionShader->bindUniformLocation(ShaderManager::LIGHT_UV_SCALE, "u_LightUvScale");
+        } else {
+            g_logger.error("unable to link light composition shader, keeping the two-pass path");
+            m_compositionShader = nullptr;
+        }
     });
 }
 
 void LightView::resize(const Size& size, const uint16_t tileSize) {
+    if (m_mapSize == size && m_tileSize == tileSize)
+        return;
+
     m_mapSize = size;
     m_tileSize = tileSize;
-    m_tiles.resize(size.area());
-    if (m_pixels.size() < 4u * m_mapSize.area())
-        m_pixels.resize(m_mapSize.area() * 4);
-    if (m_texture)
-        m_texture->setupSize(m_mapSize);
+
+    if (m_framebuffer) {
+        g_mainDispatcher.addEvent([this] {
+            m_framebuffer->resize(bufferSize());
+        });
+    }
+}
+
+void LightView::setResolutionScale(uint8_t scale)
+{
+    // power of two up to 4; one light texel then covers scale x scale tiles
+    scale = scale >= 4 ? 4 : scale >= 2 ? 2 : 1;
+    if (m_resolutionScale == scale)
+        return;
+
+    m_resolutionScale = scale;
+    m_src = {}; // composition coords are in texel units, recompute them
+
+    if (m_framebuffer) {
+        g_mainDispatcher.addEvent([this] {
+            m_framebuffer->resize(bufferSize());
+        });
+    }
+}
+
+Size LightView::bufferSize() const
+{
+    if (m_resolutionScale == 1)
+        return m_mapSize;
+    return { (m_mapSize.width() + m_resolutionScale - 1) / m_resolutionScale,
+             (m_mapSize.height() + m_resolutionScale - 1) / m_resolutionScale };
 }
 
 void LightView::addLightSource(const Point& pos, const Light& light, float brightness)
 {
     if (!isDark()) return;
 
+    if (light.intensity == 0)
+        return;
+
     if (!m_lights.empty()) {
         auto& prevLight = m_lights.back();
         if (prevLight.pos == pos && prevLight.color == light.color) {
@@ -69,32 +148,144 @@ void LightView::addLightSource(const Point& pos, const Light& light, float brigh
 
 void LightView::resetShade(const Point& pos)
 {
-    size_t index = (pos.y / m_tileSize) * m_mapSize.width() + (pos.x / m_tileSize);
-    if (index >= m_tiles.size()) return;
-    m_tiles[index] = m_lights.size();
+    // shade markers replay in order on the GPU, overwriting earlier lights on this tile
+    m_lights.emplace_back(pos, 0, 0, 0.f);
+    stdext::hash_union(m_updatingHash, pos.hash());
 }
 
 void LightView::draw(const Rect& dest, const Rect& src)
 {
-    // draw light, only if there is darkness
-    m_pool->setEnable(isDark());
+    // draw light, only if there is darkness; the standalone pool blit only
+    // runs when single-pass composition is off
+    m_pool->setEnable(!m_composited && isDark());
     if (!isDark() || !m_pool->isValid()) return;
 
-    g_drawPool.use(DrawPoolType::LIGHT);
+    if (!m_composited)
+        g_drawPool.use(DrawPoolType::LIGHT);
 
     updateCoords(dest, src);
-    updatePixels();
 
-    g_drawPool.addAction([&] {
-        m_texture->updatePixels(m_pixels.data());
+    // a scale change reshapes the buffer, so it must force a re-render
+    stdext::hash_combine(m_updatingHash, m_resolutionScale);
+
+    bool dirty = false;
+    if (m_updatingHash != m_hash) {
+        m_hash = m_updatingHash;
+        dirty = true;
+    }
+    m_updatingHash = 0;
+
+    if (m_composited) {
+        // hand the recorded lights to the render thread, which re-renders
+        // the buffer from setupComposition() before the MAP blit
+        std::scoped_lock l(m_pendingMutex);
+        if (dirty) {
+            m_pendingLights = std::move(m_lights);
+            m_pendingDirty = true;
+        }
+        m_lights.clear();
+        return;
+    }
+
+    g_drawPool.addAction([this, dirty, lights = std::move(m_lights)] {
+        if (!m_framebuffer)
+            return;
+
+        if (dirty)
+            renderLights(lights);
+
         g_painter->resetColor();
-        g_painter->setTexture(m_texture.get());
+        g_painter->setTexture(m_framebuffer->getTexture().get());
         g_painter->setCompositionMode(CompositionMode::MULTIPLY);
         g_painter->drawCoords(m_coords);
     });
 
     m_lights.clear();
-    m_tiles.assign(m_mapSize.area(), {});
+}
+
+void LightView::setupComposition(const TexturePtr& mapTexture)
+{
+    if (!isDark() || !m_compositionShader || !m_framebuffer || !mapTexture)
+        return;
+
+    std::vector<TileLight> lights;
+    bool dirty;
+    {
+        std::scoped_lock l(m_pendingMutex);
+        dirty = m_pendingDirty;
+        m_pendingDirty = false;
+        if (dirty)
+            lights = std::move(m_pendingLights);
+    }
+
+    if (dirty)
+        renderLights(lights);
+
+    const auto& lightTexture = m_framebuffer->getTexture();
+    if (!lightTexture)
+        return;
+
+    m_compositionShader->bind();
+    m_compositionShader->setUniformValue(ShaderManager::LIGHT_UV_SCALE,
+                                         mapTexture->getWidth() / (texelSize() * lightTexture->getWidth()),
+                                         mapTexture->getHeight() / (texelSize() * lightTexture->getHeight()));
+
+    m_compositionShader->clearMultiTextures();
+    m_compositionShader->addMultiTexture(lightTexture);
+
+    g_painter->setShaderProgram(m_compositionShader);
+}
+
+void LightView::renderLights(const std::vector<TileLight>& lights)
+{
+    m_framebuffer->bind();
+
+    g_painter->setTexture(nullptr);
+    g_painter->clear(m_globalLightColor);
+
+    for (const auto& light : lights) {
+        if (light.isShadeMarker()) {
+            // overwrite everything drawn so far on this tile with the global light
+            g_painter->setShaderProgram(nullptr);
+            g_painter->setBlendEquation(BlendEquation::ADD);
+            g_painter->setCompositionMode(CompositionMode::REPLACE);
+            g_painter->setColor(m_globalLightColor);
+
+            m_lightCoords.clear();
+            m_lightCoords.addRect(Rect(light.pos.x / (m_tileSize * m_resolutionScale), light.pos.y / (m_tileSize * m_resolutionScale), 1, 1));
+            g_painter->drawCoords(m_lightCoords);
+            continue;
+        }
+
+        if (!m_lightShader)
+            continue;
+
+        // radius stays in tiles for the alpha encoding, the quad shrinks with the buffer
+        const float radius = light.intensity * light.brightness;
+        const float texelRadius = radius / m_resolutionScale;
+        const PointF center(light.pos.x / texelSize(), light.pos.y / texelSize());
+
+        auto color = Color::from8bit(light.color);
+        color.setAlpha(std::min<float>(radius / LIGHT_RADIUS_SCALE, 1.f));
+
+        g_painter->setShaderProgram(m_lightShader);
+        g_painter->setCompositionMode(CompositionMode::NORMAL);
+        g_painter->setBlendEquation(BlendEquation::MAX);
+        g_painter->setTextureMatrix(DEFAULT_MATRIX3);
+        g_painter->setColor(color);
+
+        m_lightCoords.clear();
+        m_lightCoords.addRect(RectF(center.x - texelRadius, center.y - texelRadius, texelRadius * 2.f, texelRadius * 2.f),
+                              RectF(0.f, 0.f, 1.f, 1.f));
+        g_painter->drawCoords(m_lightCoords);
+    }
+
+    g_painter->setShaderProgram(nullptr);
+    g_painter->resetBlendEquation();
+    g_painter->resetCompositionMode();
+    g_painter->resetColor();
+
+    m_framebuffer->release();
 }
 
 void LightView::updateCoords(const Rect& dest, const Rect& src) {
@@ -109,42 +300,6 @@ void LightView::updateCoords(const Rect& dest, const Rect& src) {
 
     m_coords.clear();
     m_coords.addRect(RectF(m_dest.left(), m_dest.top(), m_dest.width(), m_dest.height()),
-               RectF(static_cast<float>(offset.x) / m_tileSize, static_cast<float>(offset.y) / m_tileSize,
-                     static_cast<float>(size.width()) / m_tileSize, static_cast<float>(size.height()) / m_tileSize));
-}
-
-void LightView::updatePixels() {
-    if (m_updatingHash == m_hash)
-        return;
-
-    for (int x = 0; x < m_mapSize.width(); ++x) {
-        for (int y = 0; y < m_mapSize.height(); ++y) {
-            const Point pos(x * m_tileSize + m_tileSize / 2, y * m_tileSize + m_tileSize / 2);
-            const int index = (y * m_mapSize.width() + x);
-            const int colorIndex = index * 4;
-
-            m_pixels[colorIndex] = m_globalLightColor.r();
-            m_pixels[colorIndex + 1] = m_globalLightColor.g();
-            m_pixels[colorIndex + 2] = m_globalLightColor.b();
-            m_pixels[colorIndex + 3] = 255; // alpha channel
-            for (size_t i = m_tiles[index]; i < m_lights.size(); ++i) {
-                const auto& light = m_lights[i];
-                float distance = std::sqrt((pos.x - light.pos.x) * (pos.x - light.pos.x) +
-                                           (pos.y - light.pos.y) * (pos.y - light.pos.y));
-                distance /= m_tileSize;
-
-                float intensity = (-distance + (light.intensity * light.brightness)) * .2f;
-                if (intensity < .01f) continue;
-                if (intensity > 1.f) intensity = 1.f;
-
-                const auto& lightColor = Color::from8bit(light.color) * intensity;
-                m_pixels[colorIndex] = std::max<int>(m_pixels[colorIndex], lightColor.r());
-                m_pixels[colorIndex + 1] = std::max<int>(m_pixels[colorIndex + 1], lightColor.g());
-                m_pixels[colorIndex + 2] = std::max<int>(m_pixels[colorIndex + 2], lightColor.b());
-            }
-        }
-    }
-
-    m_hash = m_updatingHash;
-    m_updatingHash = 0;
+               RectF(offset.x / texelSize(), offset.y / texelSize(),
+                     size.width() / texelSize(), size.height() / texelSize()));
 }
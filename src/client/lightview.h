@@ -35,9 +35,21 @@ public:
     void resize(const Size& size, uint16_t tileSize);
     void draw(const Rect& dest, const Rect& src);
 
+    // single-pass composition: instead of a second fullscreen multiply
+    // blit, the MAP framebuffer blit goes through a shader that samples
+    // the light texture, halving fullscreen bandwidth; MapView enables it
+    // per frame and calls setupComposition() from its before-draw hook
+    bool canCompose() const { return m_compositionShader != nullptr; }
+    void setComposited(const bool on) { m_composited = on; }
+    bool isComposited() const { return m_composited; }
+    void setupComposition(const TexturePtr& mapTexture);
+
     void addLightSource(const Point& pos, const Light& light, float brightness = 1.f);
     void resetShade(const Point& pos);
 
+    void setResolutionScale(uint8_t scale);
+    uint8_t getResolutionScale() const { return m_resolutionScale; }
+
     void setGlobalLight(const Light& light)
     {
         m_isDark = light.intensity < 250;
@@ -53,13 +65,24 @@ private:
         float brightness{ 1.f };
 
         TileLight(const Point& pos, uint8_t intensity, uint8_t color, float brightness) : Light(intensity, color), pos(pos), brightness(brightness) {}
+
+        // intensity 0 marks a shade reset of the tile at pos
+        bool isShadeMarker() const { return intensity == 0; }
     };
 
     void updateCoords(const Rect& dest, const Rect& src);
-    void updatePixels();
+    void renderLights(const std::vector<TileLight>& lights);
+
+    Size bufferSize() const;
+    // pixels covered by one light texel
+    float texelSize() const { return static_cast<float>(m_tileSize) * m_resolutionScale; }
 
     bool m_isDark{ false };
 
+    // side of the square of tiles sharing one light texel; the smooth
+    // framebuffer texture upsamples the result back at composition
+    uint8_t m_resolutionScale{ 1 };
+
     uint16_t m_tileSize{ SPRITE_SIZE };
     size_t m_hash{ 0 }, m_updatingHash{ 0 };
 
@@ -70,9 +93,18 @@ private:
     Color m_globalLightColor{ Color::white };
 
     CoordsBuffer m_coords;
-    TexturePtr m_texture;
+    CoordsBuffer m_lightCoords;
+
+    // lights accumulate on the GPU, one texel per resolution-scale tile block
+    FrameBufferPtr m_framebuffer;
+    PainterShaderProgramPtr m_lightShader;
+    PainterShaderProgramPtr m_compositionShader;
 
-    std::vector<size_t> m_tiles;
-    std::vector<uint8_t> m_pixels;
     std::vector<TileLight> m_lights;
+
+    // handoff of the recorded lights to the render thread when composited
+    std::mutex m_pendingMutex;
+    std::vector<TileLight> m_pendingLights;
+    bool m_pendingDirty{ false };
+    bool m_composited{ false };
 };
@@ -53,6 +53,12 @@ bool LocalPlayer::canWalk(bool ignoreLock)
     if (mustStabilizeCam())
         stepDuration -= 9;
 
+    // while the prediction window has room we keep stepping on the walk
+    // rhythm alone; waiting for the ping too is what stalls walking on
+    // slow links, the confirmations just have to arrive eventually
+    if (m_preWalks.size() < MAX_PREWALK_STEPS)
+        return m_walkTimer.ticksElapsed() >= stepDuration;
+
     return m_walkTimer.ticksElapsed() >= std::max<int>(stepDuration, g_game.getPing());
 }
 
@@ -61,11 +67,21 @@ void LocalPlayer::walk(const Position& oldPos, const Position& newPos)
     m_autoWalkRetries = 0;
 
     if (m_preWalking) {
-        m_preWalking = false;
-        if (newPos == m_lastPrewalkDestination) {
+        if (!m_preWalks.empty() && newPos == m_preWalks.front()) {
+            // the oldest predicted step got confirmed; offsets are
+            // anchored at the confirmed position, so any remaining
+            // predictions keep animating seamlessly from the new one
+            m_preWalks.pop_front();
+            if (m_preWalks.empty())
+                m_preWalking = false;
             updateWalk();
             return;
         }
+
+        // misprediction, drop the whole pipeline and let the server
+        // positions take over
+        m_preWalks.clear();
+        m_preWalking = false;
     }
 
     Creature::walk(oldPos, newPos);
@@ -73,15 +89,19 @@ void LocalPlayer::walk(const Position& oldPos, const Position& newPos)
 
 void LocalPlayer::preWalk(Otc::Direction direction)
 {
-    // avoid reanimating prewalks
-    if (m_preWalking)
+    // avoid reanimating the step still in progress, and stop predicting
+    // once the window of unconfirmed steps is full
+    if ((m_preWalking && m_walkTimer.ticksElapsed() < getStepDuration()) || m_preWalks.size() >= MAX_PREWALK_STEPS)
         return;
 
     m_preWalking = true;
 
-    // start walking to direction
-    m_lastPrewalkDestination = m_position.translatedToDirection(direction);
-    Creature::walk(m_position, m_lastPrewalkDestination);
+    // start walking to direction, chaining onto the last predicted step
+    // when confirmations are still in flight
+    const Position startPos = m_preWalks.empty() ? m_position : m_preWalks.back();
+    m_lastPrewalkDestination = startPos.translatedToDirection(direction);
+    m_preWalks.emplace_back(m_lastPrewalkDestination);
+    Creature::walk(startPos, m_lastPrewalkDestination);
 }
 
 bool LocalPlayer::retryAutoWalk()
@@ -142,6 +162,12 @@ bool LocalPlayer::autoWalk(const Position& destination, bool retry)
         return true;
 
     m_autoWalkDestination = destination;
+
+    // a retry usually means a single step got blocked mid-path; splicing
+    // around the obstruction reuses the remainder and skips the full search
+    if (retry && repairAutoWalkPath())
+        return true;
+
     auto self(asLocalPlayer());
     g_map.findPathAsync(m_position, destination, [self](const auto& result) {
         if (self->m_autoWalkDestination != result->destination)
@@ -170,6 +196,9 @@ bool LocalPlayer::autoWalk(const Position& destination, bool retry)
             self->m_lastAutoWalkPosition = result->destination;
         }
 
+        self->m_autoWalkPath = result->path;
+        self->m_autoWalkPathStart = result->start;
+
         g_game.autoWalk(result->path, result->start);
     });
 
@@ -179,11 +208,60 @@ bool LocalPlayer::autoWalk(const Position& destination, bool retry)
     return true;
 }
 
+bool LocalPlayer::repairAutoWalkPath()
+{
+    if (m_autoWalkPath.empty() || !m_autoWalkPathStart.isValid())
+        return false;
+
+    const auto& positions = m_autoWalkPathStart.translatedToDirections(m_autoWalkPath);
+    if (positions.empty() || positions.back() != m_autoWalkDestination)
+        return false;
+
+    // find how far along the old path the player got before being blocked
+    size_t progress = positions.size();
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (positions[i] == m_position) {
+            progress = i;
+            break;
+        }
+    }
+
+    // pushed off the path entirely, only a full search helps
+    if (progress == positions.size())
+        return false;
+
+    // try to rejoin a few steps ahead, skipping the blocked tile itself; the
+    // local search is kept tiny, failing over to the full one is cheaper
+    // than a large detour
+    static constexpr size_t REPAIR_WINDOW = 5;
+    const size_t last = std::min<size_t>(progress + 1 + REPAIR_WINDOW, positions.size() - 1);
+    for (size_t rejoin = progress + 2; rejoin <= last; ++rejoin) {
+        auto&& [splice, result] = g_map.findPath(m_position, positions[rejoin], 64, 0);
+        if (result != Otc::PathFindResultOk)
+            continue;
+
+        splice.insert(splice.end(), m_autoWalkPath.begin() + rejoin, m_autoWalkPath.end());
+
+        // the protocol cap would truncate the repaired path
+        if (splice.size() > 127)
+            return false;
+
+        m_autoWalkPath = std::move(splice);
+        m_autoWalkPathStart = m_position;
+        g_game.autoWalk(m_autoWalkPath, m_autoWalkPathStart);
+        return true;
+    }
+
+    return false;
+}
+
 void LocalPlayer::stopAutoWalk()
 {
     m_autoWalkDestination = {};
     m_lastAutoWalkPosition = {};
     m_knownCompletePath = false;
+    m_autoWalkPath.clear();
+    m_autoWalkPathStart = {};
 
     if (m_autoWalkContinueEvent)
         m_autoWalkContinueEvent->cancel();
@@ -193,6 +271,7 @@ void LocalPlayer::stopWalk()
 {
     Creature::stopWalk(); // will call terminateWalk
 
+    m_preWalks.clear();
     m_lastPrewalkDestination = {};
 }
 
@@ -203,22 +282,33 @@ void LocalPlayer::updateWalkOffset(uint8_t totalPixelsWalked)
         return;
     }
 
-    // pre walks offsets are calculated in the oposite direction
+    // pre walks offsets are calculated in the oposite direction, anchored
+    // at the last confirmed position; fully predicted steps contribute a
+    // whole tile each while the newest one is still being animated
     m_walkOffset = {};
+    if (m_preWalks.empty())
+        return;
+
+    const auto& predictedPos = m_preWalks.back();
+    m_walkOffset.x = (predictedPos.x - m_position.x) * SPRITE_SIZE;
+    m_walkOffset.y = (predictedPos.y - m_position.y) * SPRITE_SIZE;
+
+    const int remainingPixels = SPRITE_SIZE - totalPixelsWalked;
     if (m_direction == Otc::North || m_direction == Otc::NorthEast || m_direction == Otc::NorthWest)
-        m_walkOffset.y = -totalPixelsWalked;
+        m_walkOffset.y += remainingPixels;
     else if (m_direction == Otc::South || m_direction == Otc::SouthEast || m_direction == Otc::SouthWest)
-        m_walkOffset.y = totalPixelsWalked;
+        m_walkOffset.y -= remainingPixels;
 
     if (m_direction == Otc::East || m_direction == Otc::NorthEast || m_direction == Otc::SouthEast)
-        m_walkOffset.x = totalPixelsWalked;
+        m_walkOffset.x -= remainingPixels;
     else if (m_direction == Otc::West || m_direction == Otc::NorthWest || m_direction == Otc::SouthWest)
-        m_walkOffset.x = -totalPixelsWalked;
+        m_walkOffset.x += remainingPixels;
 }
 
 void LocalPlayer::terminateWalk()
 {
     Creature::terminateWalk();
+    m_preWalks.clear();
     m_preWalking = false;
 }
 
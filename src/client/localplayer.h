@@ -33,6 +33,7 @@ public:
     void stopAutoWalk();
 
     bool autoWalk(const Position& destination, bool retry = false);
+    bool repairAutoWalkPath();
     bool canWalk(bool ignoreLock = false);
 
     void setStates(uint32_t states);
@@ -138,10 +139,20 @@ private:
     bool m_forceWalk{ false };
 
     // walk related
+    // steps predicted ahead of the server, front is the oldest one still
+    // awaiting confirmation; bounded so a lag spike can't run us far ahead
+    static constexpr uint8_t MAX_PREWALK_STEPS = 3;
+    std::deque<Position> m_preWalks;
+
     Position m_lastPrewalkDestination;
     Position m_lastAutoWalkPosition;
     Position m_autoWalkDestination;
 
+    // last auto-walk path as sent, kept so a blocked step can be spliced
+    // around locally instead of recomputing the whole path
+    std::vector<Otc::Direction> m_autoWalkPath;
+    Position m_autoWalkPathStart;
+
     ScheduledEventPtr m_autoWalkContinueEvent;
     ticks_t m_walkLockExpiration{ 0 };
 
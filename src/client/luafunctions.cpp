@@ -88,6 +88,7 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_houses", "save", &HouseManager::save, &g_houses);
     g_lua.bindSingletonFunction("g_houses", "getHouse", &HouseManager::getHouse, &g_houses);
     g_lua.bindSingletonFunction("g_houses", "getHouseByName", &HouseManager::getHouseByName, &g_houses);
+    g_lua.bindSingletonFunction("g_houses", "getHouseByPos", &HouseManager::getHouseByPos, &g_houses);
     g_lua.bindSingletonFunction("g_houses", "addHouse", &HouseManager::addHouse, &g_houses);
     g_lua.bindSingletonFunction("g_houses", "removeHouse", &HouseManager::removeHouse, &g_houses);
     g_lua.bindSingletonFunction("g_houses", "getHouseList", &HouseManager::getHouseList, &g_houses);
@@ -97,6 +98,7 @@ void Client::registerLuaFunctions()
     g_lua.registerSingletonClass("g_towns");
     g_lua.bindSingletonFunction("g_towns", "getTown", &TownManager::getTown, &g_towns);
     g_lua.bindSingletonFunction("g_towns", "getTownByName", &TownManager::getTownByName, &g_towns);
+    g_lua.bindSingletonFunction("g_towns", "getTownByPos", &TownManager::getTownByPos, &g_towns);
     g_lua.bindSingletonFunction("g_towns", "addTown", &TownManager::addTown, &g_towns);
     g_lua.bindSingletonFunction("g_towns", "removeTown", &TownManager::removeTown, &g_towns);
     g_lua.bindSingletonFunction("g_towns", "getTowns", &TownManager::getTowns, &g_towns);
@@ -136,6 +138,7 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_map", "cleanTexts", &Map::cleanTexts, &g_map);
     g_lua.bindSingletonFunction("g_map", "getTile", &Map::getTile, &g_map);
     g_lua.bindSingletonFunction("g_map", "getTiles", &Map::getTiles, &g_map);
+    g_lua.bindSingletonFunction("g_map", "getTilesInfo", &Map::getTilesInfo, &g_map);
     g_lua.bindSingletonFunction("g_map", "setCentralPosition", &Map::setCentralPosition, &g_map);
     g_lua.bindSingletonFunction("g_map", "getCentralPosition", &Map::getCentralPosition, &g_map);
     g_lua.bindSingletonFunction("g_map", "getCreatureById", &Map::getCreatureById, &g_map);
@@ -149,6 +152,7 @@ void Client::registerLuaFunctions()
 
 #ifdef FRAMEWORK_EDITOR
     g_lua.bindSingletonFunction("g_map", "loadOtbm", &Map::loadOtbm, &g_map);
+    g_lua.bindSingletonFunction("g_map", "loadOtbmAsync", &Map::loadOtbmAsync, &g_map);
     g_lua.bindSingletonFunction("g_map", "saveOtbm", &Map::saveOtbm, &g_map);
     g_lua.bindSingletonFunction("g_map", "loadOtcm", &Map::loadOtcm, &g_map);
     g_lua.bindSingletonFunction("g_map", "saveOtcm", &Map::saveOtcm, &g_map);
@@ -208,6 +212,7 @@ void Client::registerLuaFunctions()
 
     g_lua.registerSingletonClass("g_game");
     g_lua.bindSingletonFunction("g_game", "loginWorld", &Game::loginWorld, &g_game);
+    g_lua.bindSingletonFunction("g_game", "playRecord", &Game::playRecord, &g_game);
     g_lua.bindSingletonFunction("g_game", "cancelLogin", &Game::cancelLogin, &g_game);
     g_lua.bindSingletonFunction("g_game", "forceLogout", &Game::forceLogout, &g_game);
     g_lua.bindSingletonFunction("g_game", "safeLogout", &Game::safeLogout, &g_game);
@@ -300,6 +305,7 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_game", "isFollowing", &Game::isFollowing, &g_game);
     g_lua.bindSingletonFunction("g_game", "isConnectionOk", &Game::isConnectionOk, &g_game);
     g_lua.bindSingletonFunction("g_game", "getPing", &Game::getPing, &g_game);
+    g_lua.bindSingletonFunction("g_game", "getNetworkStats", &Game::getNetworkStats, &g_game);
     g_lua.bindSingletonFunction("g_game", "getContainer", &Game::getContainer, &g_game);
     g_lua.bindSingletonFunction("g_game", "getContainers", &Game::getContainers, &g_game);
     g_lua.bindSingletonFunction("g_game", "getVips", &Game::getVips, &g_game);
@@ -366,6 +372,13 @@ void Client::registerLuaFunctions()
     g_lua.registerClass<ProtocolGame, Protocol>();
     g_lua.bindClassStaticFunction<ProtocolGame>("create", [] { return std::make_shared<ProtocolGame>(); });
     g_lua.bindClassMemberFunction<ProtocolGame>("sendExtendedOpcode", &ProtocolGame::sendExtendedOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("setOpcodeProfiling", &ProtocolGame::setOpcodeProfiling);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isOpcodeProfilingEnabled", &ProtocolGame::isOpcodeProfilingEnabled);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getOpcodeProfile", &ProtocolGame::getOpcodeProfile);
+    g_lua.bindClassStaticFunction<ProtocolGame>("resetOpcodeProfile", &ProtocolGame::resetOpcodeProfile);
+    g_lua.bindClassMemberFunction<ProtocolGame>("startRecording", &ProtocolGame::startRecording);
+    g_lua.bindClassMemberFunction<ProtocolGame>("stopRecording", &ProtocolGame::stopRecording);
+    g_lua.bindClassMemberFunction<ProtocolGame>("isRecording", &ProtocolGame::isRecording);
 
     g_lua.registerClass<Container>();
     g_lua.bindClassMemberFunction<Container>("getItem", &Container::getItem);
@@ -382,6 +395,9 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<Container>("hasPages", &Container::hasPages);
     g_lua.bindClassMemberFunction<Container>("getSize", &Container::getSize);
     g_lua.bindClassMemberFunction<Container>("getFirstIndex", &Container::getFirstIndex);
+    g_lua.bindClassMemberFunction<Container>("beginUpdate", &Container::beginUpdate);
+    g_lua.bindClassMemberFunction<Container>("commitUpdate", &Container::commitUpdate);
+    g_lua.bindClassMemberFunction<Container>("isUpdating", &Container::isUpdating);
 
     g_lua.registerClass<Thing>();
     g_lua.bindClassMemberFunction<Thing>("setId", &Thing::setId);
@@ -832,6 +848,7 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIMap>("setDrawNames", &UIMap::setDrawNames);
     g_lua.bindClassMemberFunction<UIMap>("setDrawHealthBars", &UIMap::setDrawHealthBars);
     g_lua.bindClassMemberFunction<UIMap>("setDrawLights", &UIMap::setDrawLights);
+    g_lua.bindClassMemberFunction<UIMap>("setLightResolutionScale", &UIMap::setLightResolutionScale);
     g_lua.bindClassMemberFunction<UIMap>("setLimitVisibleDimension", &UIMap::setLimitVisibleDimension);
     g_lua.bindClassMemberFunction<UIMap>("setDrawManaBar", &UIMap::setDrawManaBar);
     g_lua.bindClassMemberFunction<UIMap>("setKeepAspectRatio", &UIMap::setKeepAspectRatio);
@@ -866,6 +883,8 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIMap>("setCrosshairTexture", &UIMap::setCrosshairTexture);
     g_lua.bindClassMemberFunction<UIMap>("setDrawHighlightTarget", &UIMap::setDrawHighlightTarget);
     g_lua.bindClassMemberFunction<UIMap>("setAntiAliasingMode", &UIMap::setAntiAliasingMode);
+    g_lua.bindClassMemberFunction<UIMap>("setRenderScale", &UIMap::setRenderScale);
+    g_lua.bindClassMemberFunction<UIMap>("getRenderScale", &UIMap::getRenderScale);
     g_lua.bindClassMemberFunction<UIMap>("setFloorFading", &UIMap::setFloorFading);
 
     g_lua.registerClass<UIMinimap, UIWidget>();
@@ -88,6 +88,23 @@ void Map::notificateTileUpdate(const Position& pos, const ThingPtr& thing, const
     if (!pos.isMapPosition())
         return;
 
+    // any tile change can invalidate previously computed paths
+    ++m_pathFindGeneration;
+
+    if (m_tileUpdateBatchDepth > 0) {
+        m_batchTileUpdated = true;
+        if (thing) {
+            if (thing->isOpaque() && operation == Otc::OPERATION_REMOVE)
+                m_batchCoveredResets.emplace(pos);
+            if (thing->isItem())
+                m_batchMinimapTiles.emplace(pos);
+        }
+        return;
+    }
+
+    if (thing && thing->isOpaque() && operation == Otc::OPERATION_REMOVE)
+        invalidateCoveredCache(pos);
+
     for (const auto& mapView : m_mapViews) {
         mapView->onTileUpdate(pos, thing, operation);
     }
@@ -97,12 +114,63 @@ void Map::notificateTileUpdate(const Position& pos, const ThingPtr& thing, const
     }
 }
 
+void Map::beginTileUpdateBatch()
+{
+    ++m_tileUpdateBatchDepth;
+}
+
+void Map::endTileUpdateBatch()
+{
+    if (m_tileUpdateBatchDepth == 0 || --m_tileUpdateBatchDepth > 0)
+        return;
+
+    if (!m_batchTileUpdated)
+        return;
+
+    for (const auto& pos : m_batchCoveredResets)
+        invalidateCoveredCache(pos);
+
+    for (const auto& mapView : m_mapViews)
+        mapView->onTileUpdateBatch();
+
+    for (const auto& pos : m_batchMinimapTiles)
+        g_minimap.updateTile(pos, getTile(pos));
+
+    m_batchMinimapTiles.clear();
+    m_batchCoveredResets.clear();
+    m_batchTileUpdated = false;
+}
+
+void Map::invalidateCoveredCache(const Position& pos)
+{
+    // cover probes from a tile walk the covered-up diagonal and inspect at
+    // most one tile around each step, so a change at pos can only affect the
+    // 3x3 neighborhoods along the covered-down diagonal below it; everything
+    // else keeps its cached result across floor changes and camera moves
+    Position tilePos = pos;
+    while (tilePos.coveredDown()) {
+        for (int_fast8_t x = -2; ++x < 2;) {
+            for (int_fast8_t y = -2; ++y < 2;) {
+                if (const auto& tile = getTile(tilePos.translated(x, y)))
+                    tile->resetCoveredCache();
+            }
+        }
+    }
+}
+
 void Map::clean()
 {
     cleanDynamicThings();
 
-    for (int_fast8_t i = -1; ++i <= MAX_Z;)
+    m_pathFindCache.clear();
+    ++m_pathFindGeneration;
+
+    for (int_fast8_t i = -1; ++i <= MAX_Z;) {
         m_tileBlocks[i].clear();
+        m_creatureBlocks[i].clear();
+    }
+    m_blockSweepQueue.clear();
+    m_awareGrid.clear();
 
 #ifdef FRAMEWORK_EDITOR
     m_waypoints.clear();
@@ -118,6 +186,8 @@ void Map::cleanDynamicThings()
         removeThing(creature);
     }
     m_knownCreatures.clear();
+    m_removedCreatures.clear();
+    m_walkingCreatures.clear();
 
     for (int_fast8_t i = -1; ++i <= MAX_Z;)
         m_floorMissiles[i].clear();
@@ -142,7 +212,14 @@ void Map::addThing(const ThingPtr& thing, const Position& pos, int16_t stackPos)
 
     if (const auto& tile = getOrCreateTile(pos)) {
         if (m_floatingEffect || !thing->isEffect() || tile->getGround()) {
+            const Position oldPos = thing->getPosition();
             tile->addThing(thing, stackPos);
+            if (thing->isCreature()) {
+                const auto& creature = thing->static_self_cast<Creature>();
+                if (oldPos.isMapPosition())
+                    removeCreatureFromBlock(creature, oldPos);
+                addCreatureToBlock(creature, pos);
+            }
             notificateTileUpdate(pos, thing, Otc::OPERATION_ADD);
         }
     }
@@ -224,6 +301,8 @@ bool Map::removeThing(const ThingPtr& thing)
 
     if (const auto& tile = thing->getTile()) {
         if (tile->removeThing(thing)) {
+            if (thing->isCreature())
+                removeCreatureFromBlock(thing->static_self_cast<Creature>(), thing->getPosition());
             notificateTileUpdate(thing->getPosition(), thing, Otc::OPERATION_REMOVE);
             return true;
         }
@@ -264,7 +343,7 @@ void Map::colorizeThing(const ThingPtr& thing, const Color& color)
         return;
 
     if (thing->isItem())
-        thing->static_self_cast<Item>()->setColor(color);
+        thing->static_self<Item>()->setColor(color);
     else if (thing->isCreature()) {
         const auto& tile = thing->getTile();
         assert(tile);
@@ -272,7 +351,7 @@ void Map::colorizeThing(const ThingPtr& thing, const Color& color)
         const auto& topThing = tile->getTopThing();
         assert(topThing);
 
-        topThing->static_self_cast<Item>()->setColor(color);
+        topThing->static_self<Item>()->setColor(color);
     }
 }
 
@@ -282,7 +361,7 @@ void Map::removeThingColor(const ThingPtr& thing)
         return;
 
     if (thing->isItem())
-        thing->static_self_cast<Item>()->setColor(Color::alpha);
+        thing->static_self<Item>()->setColor(Color::alpha);
     else if (thing->isCreature()) {
         const auto& tile = thing->getTile();
         assert(tile);
@@ -290,7 +369,7 @@ void Map::removeThingColor(const ThingPtr& thing)
         const auto& topThing = tile->getTopThing();
         assert(topThing);
 
-        topThing->static_self_cast<Item>()->setColor(Color::alpha);
+        topThing->static_self<Item>()->setColor(Color::alpha);
     }
 }
 
@@ -305,8 +384,37 @@ StaticTextPtr Map::getStaticText(const Position& pos) const
     return nullptr;
 }
 
-const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? m_tileBlocks[pos.z][getBlockIndex(pos)].create(pos) : m_nulltile; }
-const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? m_tileBlocks[pos.z][getBlockIndex(pos)].getOrCreate(pos) : m_nulltile; }
+const TilePtr& Map::createTile(const Position& pos)
+{
+    if (!pos.isMapPosition())
+        return m_nulltile;
+
+    const uint32_t index = getBlockIndex(pos);
+    const auto& [it, inserted] = m_tileBlocks[pos.z].try_emplace(index);
+    if (inserted)
+        m_blockSweepQueue.emplace_back(pos.z, index);
+
+    const auto& tile = it->second.create(pos);
+    if (m_awareGrid.contains(pos))
+        m_awareGrid.at(pos) = tile;
+    return tile;
+}
+
+const TilePtr& Map::getOrCreateTile(const Position& pos)
+{
+    if (!pos.isMapPosition())
+        return m_nulltile;
+
+    const uint32_t index = getBlockIndex(pos);
+    const auto& [it, inserted] = m_tileBlocks[pos.z].try_emplace(index);
+    if (inserted)
+        m_blockSweepQueue.emplace_back(pos.z, index);
+
+    const auto& tile = it->second.getOrCreate(pos);
+    if (m_awareGrid.contains(pos))
+        m_awareGrid.at(pos) = tile;
+    return tile;
+}
 
 template <typename... Items>
 const TilePtr& Map::createTileEx(const Position& pos, const Items&... items)
@@ -323,6 +431,11 @@ const TilePtr& Map::createTileEx(const Position& pos, const Items&... items)
 
 const TilePtr& Map::getTile(const Position& pos)
 {
+    // hot path: anything inside the aware grid is a bounds check plus
+    // an array index, including misses
+    if (m_awareGrid.contains(pos))
+        return m_awareGrid.at(pos);
+
     if (!pos.isMapPosition())
         return m_nulltile;
 
@@ -363,6 +476,55 @@ TileList Map::getTiles(int8_t floor/* = -1*/)
     return tiles;
 }
 
+std::vector<uint32_t> Map::getTilesInfo(const Position& topLeft, const int width, const int height)
+{
+    enum : uint32_t
+    {
+        TILE_INFO_EXISTS = 1 << 0,
+        TILE_INFO_WALKABLE = 1 << 1,
+        TILE_INFO_PATHABLE = 1 << 2,
+        TILE_INFO_HAS_CREATURE = 1 << 3,
+    };
+
+    std::vector<uint32_t> info;
+    if (!topLeft.isValid() || width <= 0 || height <= 0)
+        return info;
+
+    info.reserve(static_cast<size_t>(width) * height * 4);
+
+    Position pos = topLeft;
+    for (int dy = 0; dy < height; ++dy) {
+        pos.y = topLeft.y + dy;
+        for (int dx = 0; dx < width; ++dx) {
+            pos.x = topLeft.x + dx;
+
+            const auto& tile = getTile(pos);
+            if (!tile) {
+                info.insert(info.end(), { 0, 0, 0, 0 });
+                continue;
+            }
+
+            uint32_t flags = TILE_INFO_EXISTS;
+            if (tile->isWalkable(true))
+                flags |= TILE_INFO_WALKABLE;
+            if (tile->isPathable())
+                flags |= TILE_INFO_PATHABLE;
+            if (tile->hasCreature())
+                flags |= TILE_INFO_HAS_CREATURE;
+
+            const auto& topThing = tile->getTopThing();
+            const auto& topCreature = tile->getTopCreature();
+
+            info.push_back(flags);
+            info.push_back(topThing ? static_cast<uint32_t>(topThing->getId()) : 0);
+            info.push_back(topCreature ? topCreature->getId() : 0);
+            info.push_back(static_cast<uint32_t>(tile->getGroundSpeed()));
+        }
+    }
+
+    return info;
+}
+
 void Map::cleanTile(const Position& pos)
 {
     if (!pos.isMapPosition())
@@ -372,9 +534,13 @@ void Map::cleanTile(const Position& pos)
     if (it != m_tileBlocks[pos.z].end()) {
         auto& block = it->second;
         if (const auto& tile = block.get(pos)) {
+            for (const auto& creature : tile->getCreatures())
+                removeCreatureFromBlock(creature, pos);
             tile->clean();
-            if (tile->canErase())
+            if (tile->canErase()) {
                 block.remove(pos);
+                m_awareGrid.remove(pos);
+            }
 
             notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
         } else {
@@ -398,6 +564,8 @@ void Map::setShowZone(tileflags_t zone, bool show)
         m_zoneFlags |= static_cast<uint32_t>(zone);
     else
         m_zoneFlags &= ~static_cast<uint32_t>(zone);
+
+    bumpZoneVersion();
 }
 
 void Map::setShowZones(bool show)
@@ -406,6 +574,8 @@ void Map::setShowZones(bool show)
         m_zoneFlags = 0;
     else if (m_zoneFlags == 0)
         m_zoneFlags = TILESTATE_HOUSE | TILESTATE_PROTECTIONZONE;
+
+    bumpZoneVersion();
 }
 
 void Map::setZoneColor(tileflags_t zone, const Color& color)
@@ -483,8 +653,69 @@ void Map::removeCreatureById(uint32_t  id)
         return;
 
     const auto it = m_knownCreatures.find(id);
-    if (it != m_knownCreatures.end())
-        m_knownCreatures.erase(it);
+    if (it == m_knownCreatures.end())
+        return;
+
+    // monsters go to a bounded reuse list instead of being destroyed, the
+    // server usually brings the same ones right back
+    if (it->second->isMonster()) {
+        static constexpr size_t MAX_REMOVED_CREATURES = 128;
+        if (m_removedCreatures.size() >= MAX_REMOVED_CREATURES)
+            m_removedCreatures.pop_front();
+        m_removedCreatures.emplace_back(it->second);
+    }
+
+    m_knownCreatures.erase(it);
+}
+
+CreaturePtr Map::takeRemovedCreature(const uint32_t id, const std::string_view name)
+{
+    // prefer the exact creature when the server reused its id, otherwise any
+    // monster of the same name, whose outfit and cached sprites stay warm
+    auto found = m_removedCreatures.end();
+    for (auto it = m_removedCreatures.begin(); it != m_removedCreatures.end(); ++it) {
+        if ((*it)->getId() == id) {
+            found = it;
+            break;
+        }
+        if (found == m_removedCreatures.end() && (*it)->getName() == name)
+            found = it;
+    }
+
+    if (found == m_removedCreatures.end())
+        return nullptr;
+
+    const auto creature = *found;
+    m_removedCreatures.erase(found);
+    return creature;
+}
+
+void Map::registerWalkingCreature(const CreaturePtr& creature)
+{
+    if (std::find(m_walkingCreatures.begin(), m_walkingCreatures.end(), creature) == m_walkingCreatures.end())
+        m_walkingCreatures.emplace_back(creature);
+}
+
+void Map::unregisterWalkingCreature(const CreaturePtr& creature)
+{
+    const auto it = std::find(m_walkingCreatures.begin(), m_walkingCreatures.end(), creature);
+    if (it != m_walkingCreatures.end())
+        m_walkingCreatures.erase(it);
+}
+
+void Map::updateWalkingCreatures()
+{
+    // several map views can draw in the same frame, one pass is enough
+    if (m_walkingCreatures.empty() || m_lastWalkUpdateTick == g_clock.millis())
+        return;
+
+    m_lastWalkUpdateTick = g_clock.millis();
+
+    // iterate by index, the update unregisters creatures that finished walking
+    for (size_t i = m_walkingCreatures.size(); i-- > 0;) {
+        const auto creature = m_walkingCreatures[i];
+        creature->nextWalkUpdate();
+    }
 }
 
 void Map::removeUnawareThings()
@@ -505,29 +736,41 @@ void Map::removeUnawareThings()
     }
 
     if (!g_game.getFeature(Otc::GameKeepUnawareTiles)) {
-        // remove tiles that we are not aware anymore
-        for (int_fast8_t z = -1; ++z <= MAX_Z;) {
+        // remove tiles that we are not aware anymore; the blocks sit on a
+        // ring and each pass inspects a bounded number of them, so a step
+        // costs the same whether the session explored one screen or a whole
+        // continent - out-of-range tiles just wait a few steps for their turn
+        static constexpr size_t MAX_SWEPT_BLOCKS = 32;
+
+        const size_t sweepCount = std::min<size_t>(m_blockSweepQueue.size(), MAX_SWEPT_BLOCKS);
+        for (size_t i = 0; i < sweepCount; ++i) {
+            const auto [z, index] = m_blockSweepQueue.front();
+            m_blockSweepQueue.pop_front();
+
             auto& tileBlocks = m_tileBlocks[z];
-            for (auto it = tileBlocks.begin(); it != tileBlocks.end();) {
-                auto& block = (*it).second;
-                bool blockEmpty = true;
-                for (const auto& tile : block.getTiles()) {
-                    if (!tile) continue;
+            const auto it = tileBlocks.find(index);
+            if (it == tileBlocks.end())
+                continue;
 
-                    const auto& pos = tile->getPosition();
-                    if (isAwareOfPosition(pos)) {
-                        blockEmpty = false;
-                        continue;
-                    }
+            auto& block = it->second;
+            bool blockEmpty = true;
+            for (const auto& tile : block.getTiles()) {
+                if (!tile) continue;
 
-                    block.remove(pos);
+                const auto& pos = tile->getPosition();
+                if (isAwareOfPosition(pos)) {
+                    blockEmpty = false;
+                    continue;
                 }
 
-                if (blockEmpty)
-                    it = tileBlocks.erase(it);
-                else
-                    ++it;
+                block.remove(pos);
+                m_awareGrid.remove(pos);
             }
+
+            if (blockEmpty)
+                tileBlocks.erase(it);
+            else
+                m_blockSweepQueue.emplace_back(z, index);
         }
     }
 }
@@ -540,6 +783,7 @@ void Map::setCentralPosition(const Position& centralPosition)
     m_centralPosition = centralPosition;
 
     removeUnawareThings();
+    rebuildAwareGrid();
 
     // this fixes local player position when the local player is removed from the map,
     // the local player is removed from the map when there are too many creatures on his tile,
@@ -587,14 +831,32 @@ std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos,
         maxZRange = getLastAwareFloor() - centerPos.z;
     }
 
-    //TODO: optimize
+    const int32_t minX = std::max<int32_t>(centerPos.x - minXRange, 0);
+    const int32_t maxX = centerPos.x + maxXRange;
+    const int32_t minY = std::max<int32_t>(centerPos.y - minYRange, 0);
+    const int32_t maxY = centerPos.y + maxYRange;
+
     //TODO: delivery creatures in distance order
     for (int_fast8_t iz = -minZRange; iz <= maxZRange; ++iz) {
-        for (int_fast32_t iy = -minYRange; iy <= maxYRange; ++iy) {
-            for (int_fast32_t ix = -minXRange; ix <= maxXRange; ++ix) {
-                if (const auto& tile = getTile(centerPos.translated(ix, iy, iz))) {
-                    const auto& tileCreatures = tile->getCreatures();
-                    creatures.insert(creatures.end(), tileCreatures.rbegin(), tileCreatures.rend());
+        const int32_t z = centerPos.z + iz;
+        if (z < 0 || z > MAX_Z)
+            continue;
+
+        const auto& blocks = m_creatureBlocks[z];
+        if (blocks.empty())
+            continue;
+
+        // visit only the creature buckets whose block intersects the range
+        for (int_fast32_t by = minY / BLOCK_SIZE; by <= maxY / BLOCK_SIZE; ++by) {
+            for (int_fast32_t bx = minX / BLOCK_SIZE; bx <= maxX / BLOCK_SIZE; ++bx) {
+                const auto it = blocks.find((by * (65536 / BLOCK_SIZE)) + bx);
+                if (it == blocks.end())
+                    continue;
+
+                for (const auto& creature : it->second) {
+                    const auto& pos = creature->getPosition();
+                    if (pos.x >= minX && pos.x <= maxX && pos.y >= minY && pos.y <= maxY)
+                        creatures.emplace_back(creature);
                 }
             }
         }
@@ -603,6 +865,27 @@ std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos,
     return creatures;
 }
 
+void Map::addCreatureToBlock(const CreaturePtr& creature, const Position& pos)
+{
+    m_creatureBlocks[pos.z][getBlockIndex(pos)].emplace_back(creature);
+}
+
+void Map::removeCreatureFromBlock(const CreaturePtr& creature, const Position& pos)
+{
+    const auto it = m_creatureBlocks[pos.z].find(getBlockIndex(pos));
+    if (it == m_creatureBlocks[pos.z].end())
+        return;
+
+    auto& creatures = it->second;
+    const auto cit = std::find(creatures.begin(), creatures.end(), creature);
+    if (cit == creatures.end())
+        return;
+
+    creatures.erase(cit);
+    if (creatures.empty())
+        m_creatureBlocks[pos.z].erase(it);
+}
+
 bool Map::isLookPossible(const Position& pos)
 {
     const auto& tile = getTile(pos);
@@ -703,6 +986,20 @@ void Map::setAwareRange(const AwareRange& range)
 {
     m_awareRange = range;
     removeUnawareThings();
+    rebuildAwareGrid();
+}
+
+void Map::rebuildAwareGrid()
+{
+    m_awareGrid.reset(m_centralPosition, m_awareRange);
+    for (int_fast8_t z = -1; ++z <= MAX_Z;) {
+        for (const auto& [key, block] : m_tileBlocks[z]) {
+            for (const auto& tile : block.getTiles()) {
+                if (tile && m_awareGrid.contains(tile->getPosition()))
+                    m_awareGrid.at(tile->getPosition()) = tile;
+            }
+        }
+    }
 }
 
 void Map::resetAwareRange() { setAwareRange({ MAX_VIEWPORT_X , MAX_VIEWPORT_Y, MAX_VIEWPORT_X + 1, MAX_VIEWPORT_Y + 1 }); }
@@ -774,10 +1071,28 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
         }
     }
 
+    // repeated queries (auto-walk retries, Lua bots) hit the cache until a
+    // tile changes; stale results are dropped wholesale here rather than
+    // lingering until Map::clean()
+    if (m_pathFindCacheGeneration != m_pathFindGeneration) {
+        m_pathFindCache.clear();
+        m_pathFindCacheGeneration = m_pathFindGeneration;
+    }
+
+    const PathFindCacheKey cacheKey{ startPos, goalPos, maxComplexity, flags };
+    if (const auto it = m_pathFindCache.find(cacheKey); it != m_pathFindCache.end()) {
+        dirs = it->second.dirs;
+        result = it->second.result;
+        return ret;
+    }
+
     stdext::map<Position, SNode*, Position::Hasher> nodes;
     std::priority_queue<std::pair<SNode*, float>, std::vector<std::pair<SNode*, float>>, LessNode> searchList;
 
-    auto* currentNode = new SNode(startPos);
+    // nodes live in a pool instead of being allocated one by one
+    std::deque<SNode> nodePool;
+
+    auto* currentNode = &nodePool.emplace_back(startPos);
     currentNode->pos = startPos;
     nodes[startPos] = currentNode;
     SNode* foundNode = nullptr;
@@ -857,7 +1172,7 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
 
                 SNode* neighborNode;
                 if (!nodes.contains(neighborPos)) {
-                    neighborNode = new SNode(neighborPos);
+                    neighborNode = &nodePool.emplace_back(neighborPos);
                     nodes[neighborPos] = neighborNode;
                 } else {
                     neighborNode = nodes[neighborPos];
@@ -891,8 +1206,7 @@ std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> Map::findPath(const
         result = Otc::PathFindResultOk;
     }
 
-    for (const auto& it : nodes)
-        delete it.second;
+    m_pathFindCache[cacheKey] = { dirs, result };
 
     return ret;
 }
@@ -904,7 +1218,7 @@ void Map::resetLastCamera() const
 }
 
 PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>
-                                    & visibleNodes)
+                                    & visibleNodes, const stdext::set<uint32_t>* corridor)
 {
     auto ret = std::make_shared<PathFindResult>();
     ret->start = start;
@@ -973,6 +1287,12 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
                 if (neighbor.x < 0 || neighbor.y < 0) continue;
                 auto it = nodes.find(neighbor);
                 if (it == nodes.end()) {
+                    // confined to the corridor resolved at block granularity
+                    if (corridor && !corridor->contains(Minimap::getBlockIndex(neighbor))) {
+                        it = nodes.emplace(neighbor, nullptr).first;
+                        continue;
+                    }
+
                     const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
                     const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
                     const bool isNotWalkable = tile.hasFlag(MinimapTileNotWalkable);
@@ -1032,7 +1352,10 @@ PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal,
 void Map::findPathAsync(const Position& start, const Position& goal, const std::function<void(PathFindResult_ptr)>&
                         callback)
 {
-    const auto visibleNodes = std::make_shared<std::list<Node*>>();
+    // aware-area tiles snapshotted by value: the search may run twice
+    // (corridor-constrained, then unconstrained) and newFindPath consumes
+    // its node list
+    const auto visibleNodes = std::make_shared<std::vector<Node>>();
     for (const auto& tile : getTiles(start.z)) {
         if (tile->getPosition() == start)
             continue;
@@ -1040,14 +1363,34 @@ void Map::findPathAsync(const Position& start, const Position& goal, const std::
         const bool isNotPathable = !tile->isPathable();
         const float speed = tile->getGroundSpeed();
         if ((isNotWalkable || isNotPathable) && tile->getPosition() != goal) {
-            visibleNodes->push_back(new Node{ speed, 0, tile->getPosition(), nullptr, 0, 0 });
+            visibleNodes->push_back(Node{ speed, 0, tile->getPosition(), nullptr, 0, 0 });
         } else {
-            visibleNodes->push_back(new Node{ speed, 10000000.0f, tile->getPosition(), nullptr, 0, 0 });
+            visibleNodes->push_back(Node{ speed, 10000000.0f, tile->getPosition(), nullptr, 0, 0 });
         }
     }
 
     g_asyncDispatcher.dispatch([=] {
-        const auto ret = g_map.newFindPath(start, goal, visibleNodes);
+        const auto materializeNodes = [&] {
+            auto nodes = std::make_shared<std::list<Node*>>();
+            for (const auto& node : *visibleNodes)
+                nodes->push_back(new Node{ node });
+            return nodes;
+        };
+
+        // long hops resolve at block granularity over the minimap first,
+        // the tile search then only refines inside the corridor; when the
+        // block graph can't see a route (unexplored gaps, blocked goal)
+        // the full search runs as before
+        PathFindResult_ptr ret;
+        if (start.distance(goal) >= MMBLOCK_SIZE) {
+            stdext::set<uint32_t> corridor;
+            if (g_minimap.findBlockRoute(start, goal, corridor))
+                ret = g_map.newFindPath(start, goal, materializeNodes(), &corridor);
+        }
+
+        if (!ret || ret->status != Otc::PathFindResultOk)
+            ret = g_map.newFindPath(start, goal, materializeNodes());
+
         g_dispatcher.addEvent(std::bind(callback, ret));
     });
 }
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <framework/stdext/poolallocator.h>
 #include "animatedtext.h"
 #include "tile.h"
 
@@ -102,17 +103,19 @@ class TileBlock
 public:
     TileBlock() { m_tiles.fill(nullptr); }
 
+    // tiles come from a slab pool, walking across the map creates and
+    // destroys thousands of them via removeUnawareThings
     const TilePtr& create(const Position& pos)
     {
         auto& tile = m_tiles[getTileIndex(pos)];
-        tile = std::make_shared<Tile>(pos);
+        tile = std::allocate_shared<Tile>(stdext::pool_allocator<Tile>(), pos);
         return tile;
     }
     const TilePtr& getOrCreate(const Position& pos)
     {
         auto& tile = m_tiles[getTileIndex(pos)];
         if (!tile)
-            tile = std::make_shared<Tile>(pos);
+            tile = std::allocate_shared<Tile>(stdext::pool_allocator<Tile>(), pos);
         return tile;
     }
     const TilePtr& get(const Position& pos) { return m_tiles[getTileIndex(pos)]; }
@@ -155,8 +158,15 @@ public:
 
     void addMapView(const MapViewPtr& mapView);
     void removeMapView(const MapViewPtr& mapView);
+    const std::vector<MapViewPtr>& getMapViews() const { return m_mapViews; }
 
     void notificateTileUpdate(const Position& pos, const ThingPtr& thing, Otc::Operation operation);
+
+    // defers MapView/minimap notifications so that many tile mutations
+    // (e.g. one network message) cost a single visibility pass
+    void beginTileUpdateBatch();
+    void endTileUpdateBatch();
+
     void notificateCameraMove(const Point& offset) const;
     void notificateKeyRelease(const InputEvent& inputEvent) const;
 
@@ -165,6 +175,7 @@ public:
     void saveOtcm(const std::string& fileName);
 
     void loadOtbm(const std::string& fileName);
+    void loadOtbmAsync(const std::string& fileName, const std::function<void(bool)>& callback = nullptr);
     void saveOtbm(const std::string& fileName);
 
     // otbm attributes (description, size, etc.)
@@ -189,6 +200,11 @@ public:
     bool showZones() { return m_zoneFlags != 0; }
     bool showZone(tileflags_t zone) { return (m_zoneFlags & zone) == zone; }
 
+    // bumped whenever a tile zone flag or the shown zone set changes, so
+    // views know to rebuild their merged overlay meshes
+    uint32_t getZoneVersion() { return m_zoneVersion; }
+    void bumpZoneVersion() { ++m_zoneVersion; }
+
     void setForceShowAnimations(bool force);
     bool isShowingAnimations() { return (m_animationFlags & Animation_Show) == Animation_Show; }
     bool isForcingAnimations() { return (m_animationFlags & Animation_Force) == Animation_Force; }
@@ -228,6 +244,13 @@ public:
     const TilePtr& getOrCreateTile(const Position& pos);
     const TilePtr& getTile(const Position& pos);
     TileList getTiles(int8_t floor = -1);
+
+    // packed per-tile records for a rectangle anchored at topLeft, four
+    // values per tile (flags, top thing id, top creature id, ground speed);
+    // lets automation modules query an area in one Lua boundary crossing
+    // instead of thousands of per-tile calls
+    std::vector<uint32_t> getTilesInfo(const Position& topLeft, int width, int height);
+
     void cleanTile(const Position& pos);
 
     void beginGhostMode(float opacity);
@@ -236,8 +259,16 @@ public:
     stdext::map<Position, ItemPtr, Position::Hasher> findItemsById(uint16_t clientId, uint32_t max);
 
     CreaturePtr getCreatureById(uint32_t id);
+    size_t getCreatureCount() { return m_knownCreatures.size(); }
     void addCreature(const CreaturePtr& creature);
     void removeCreatureById(uint32_t id);
+    CreaturePtr takeRemovedCreature(uint32_t id, std::string_view name);
+
+    // walking creatures are advanced in one pass per frame instead of one
+    // scheduled event per creature, see Creature::nextWalkUpdate()
+    void registerWalkingCreature(const CreaturePtr& creature);
+    void unregisterWalkingCreature(const CreaturePtr& creature);
+    void updateWalkingCreatures();
 
     std::vector<CreaturePtr> getSpectators(const Position& centerPos, bool multiFloor)
     {
@@ -282,7 +313,8 @@ public:
 
     std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> findPath(const Position& start, const Position& goal,
                                                                           int maxComplexity, int flags = 0);
-    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>& visibleNodes);
+    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>& visibleNodes,
+                                   const stdext::set<uint32_t>* corridor = nullptr);
     void findPathAsync(const Position& start, const Position& goal,
                        const std::function<void(PathFindResult_ptr)>& callback);
 
@@ -292,7 +324,99 @@ public:
 private:
     void removeUnawareThings();
 
-    uint16_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
+    // clears the covered caches of the tiles whose cover probes walk through
+    // pos, called when an opaque thing is removed there
+    void invalidateCoveredCache(const Position& pos);
+
+    // the full index needs 22 bits; returning uint16_t used to fold distant
+    // areas onto the same block key
+    uint32_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
+
+    // dense aware-area tile grid re-centered on camera moves; hot getTile
+    // calls resolve to a bounds check plus array index, the hash blocks
+    // stay authoritative for everything out of range
+    struct AwareGrid
+    {
+        static constexpr int MARGIN = 8; // covers the perspective shift between aware floors
+
+        void reset(const Position& center, const AwareRange& range)
+        {
+            m_left = center.x - range.left - MARGIN;
+            m_top = center.y - range.top - MARGIN;
+            m_width = range.horizontal() + 2 * MARGIN;
+            m_height = range.vertical() + 2 * MARGIN;
+            m_tiles.assign(static_cast<size_t>(MAX_Z + 1) * m_width * m_height, nullptr);
+        }
+
+        void clear()
+        {
+            m_tiles.clear();
+            m_width = m_height = 0;
+        }
+
+        bool contains(const Position& pos) const
+        {
+            const int dx = pos.x - m_left, dy = pos.y - m_top;
+            return dx >= 0 && dx < m_width && dy >= 0 && dy < m_height && pos.z <= MAX_Z;
+        }
+
+        TilePtr& at(const Position& pos)
+        {
+            return m_tiles[(static_cast<size_t>(pos.z) * m_height + (pos.y - m_top)) * m_width + (pos.x - m_left)];
+        }
+
+        void remove(const Position& pos) { if (contains(pos)) at(pos) = nullptr; }
+
+        std::vector<TilePtr> m_tiles;
+        int m_left{ 0 }, m_top{ 0 };
+        int m_width{ 0 }, m_height{ 0 };
+    };
+
+    void rebuildAwareGrid();
+
+    void addCreatureToBlock(const CreaturePtr& creature, const Position& pos);
+    void removeCreatureFromBlock(const CreaturePtr& creature, const Position& pos);
+
+    struct PathFindCacheKey
+    {
+        Position start;
+        Position goal;
+        int maxComplexity;
+        int flags;
+
+        bool operator==(const PathFindCacheKey& other) const = default;
+
+        struct Hasher
+        {
+            std::size_t operator()(const PathFindCacheKey& key) const
+            {
+                std::size_t hash = Position::Hasher()(key.start);
+                stdext::hash_union(hash, Position::Hasher()(key.goal));
+                stdext::hash_combine(hash, key.maxComplexity);
+                stdext::hash_combine(hash, key.flags);
+                return hash;
+            }
+        };
+    };
+
+    struct PathFindCacheEntry
+    {
+        std::vector<Otc::Direction> dirs;
+        Otc::PathFindResult result;
+    };
+
+    // findPath results computed since the last tile change; the cache is
+    // dropped whole once any tile changes, and the full query is kept as
+    // the key so a hash collision cannot hand back someone else's path
+    stdext::map<PathFindCacheKey, PathFindCacheEntry, PathFindCacheKey::Hasher> m_pathFindCache;
+    uint32_t m_pathFindGeneration{ 0 };
+    uint32_t m_pathFindCacheGeneration{ 0 };
+
+    // pending notifications while a tile update batch is open
+    int m_tileUpdateBatchDepth{ 0 };
+    bool m_batchTileUpdated{ false };
+    stdext::set<Position, Position::Hasher> m_batchMinimapTiles;
+    stdext::set<Position, Position::Hasher> m_batchCoveredResets;
 
     std::array<std::vector<MissilePtr>, MAX_Z + 1> m_floorMissiles;
 
@@ -301,8 +425,26 @@ private:
     std::vector<MapViewPtr> m_mapViews;
 
     stdext::map<uint32_t, TileBlock> m_tileBlocks[MAX_Z + 1];
+    AwareGrid m_awareGrid;
+
+    // ring of live tile blocks, inspected a bounded number at a time by
+    // removeUnawareThings() so the sweep cost per step stays constant no
+    // matter how much map the session has explored
+    std::deque<std::pair<uint8_t, uint32_t>> m_blockSweepQueue;
     stdext::map<uint32_t, CreaturePtr> m_knownCreatures;
 
+    // recently removed monsters kept for reuse: at hunting-ground borders
+    // the same creatures cycle in and out of the aware range constantly and
+    // every reappearance would otherwise allocate a fresh one
+    std::deque<CreaturePtr> m_removedCreatures;
+
+    std::vector<CreaturePtr> m_walkingCreatures;
+    ticks_t m_lastWalkUpdateTick{ -1 };
+
+    // creatures bucketed by tile block, so spectator queries only visit the
+    // blocks intersecting the range instead of scanning every tile in it
+    stdext::map<uint32_t, std::vector<CreaturePtr>> m_creatureBlocks[MAX_Z + 1];
+
 #ifdef FRAMEWORK_EDITOR
     stdext::map<Position, std::string, Position::Hasher> m_waypoints;
     stdext::map<uint32_t, Color> m_zoneColors;
@@ -313,6 +455,7 @@ private:
 
     uint8_t m_animationFlags{ 0 };
     uint32_t m_zoneFlags{ 0 };
+    uint32_t m_zoneVersion{ 1 };
 
     float m_zoneOpacity{ 1.f };
 #endif
@@ -27,6 +27,7 @@
 #include "tile.h"
 
 #include <framework/core/application.h>
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/binarytree.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/filestream.h>
@@ -237,14 +238,274 @@ void Map::loadOtbm(const std::string& fileName)
     }
 }
 
+void Map::loadOtbmAsync(const std::string& fileName, const std::function<void(bool)>& callback)
+{
+    // the BinaryTree node stream is sequential, so one worker parses tile
+    // areas into batches while the main thread applies the previous one;
+    // at most two batches are in flight so memory stays bounded
+    g_asyncDispatcher.dispatch([this, fileName, callback] {
+        const auto& pendingBatches = std::make_shared<std::atomic_int>(0);
+
+        struct ParsedTile
+        {
+            Position pos;
+            uint32_t flags{ TILESTATE_NONE };
+            uint32_t houseId{ 0 };
+            std::vector<ItemPtr> items;
+        };
+
+        bool ok = true;
+        try {
+            if (!g_things.isOtbLoaded())
+                throw Exception("OTB isn't loaded yet to load a map.");
+
+            const FileStreamPtr fin = g_resources.openFile(fileName);
+            if (!fin)
+                throw Exception("Unable to load map '%s'", fileName);
+
+            fin->cache();
+
+            char identifier[4];
+            if (fin->read(identifier, 1, 4) < 4)
+                throw Exception("Could not read file identifier");
+
+            if (memcmp(identifier, "OTBM", 4) != 0 && memcmp(identifier, "\0\0\0\0", 4) != 0)
+                throw Exception("Invalid file identifier detected: %s", identifier);
+
+            const BinaryTreePtr root = fin->getBinaryTree();
+            if (root->getU8())
+                throw Exception("could not read root property!");
+
+            const uint32_t headerVersion = root->getU32();
+            if (headerVersion > 3)
+                throw Exception("Unknown OTBM version detected: %u.", headerVersion);
+
+            const uint16_t width = root->getU16();
+            const uint16_t height = root->getU16();
+
+            const uint32_t headerMajorItems = root->getU8();
+            if (headerMajorItems > g_things.getOtbMajorVersion()) {
+                throw Exception("This map was saved with different OTB version. read %d what it's supposed to be: %d",
+                                headerMajorItems, g_things.getOtbMajorVersion());
+            }
+
+            root->skip(3);
+            const uint32_t headerMinorItems = root->getU32();
+            if (headerMinorItems > g_things.getOtbMinorVersion()) {
+                g_logger.warning(stdext::format("This map needs an updated OTB. read %d what it's supposed to be: %d or less",
+                                 headerMinorItems, g_things.getOtbMinorVersion()));
+            }
+
+            const BinaryTreePtr node = root->getChildren()[0];
+            if (node->getU8() != OTBM_MAP_DATA)
+                throw Exception("Could not read root data node");
+
+            std::string description, spawnFile, houseFile;
+            while (node->canRead()) {
+                const uint8_t attribute = node->getU8();
+                std::string tmp = node->getString();
+                switch (attribute) {
+                    case OTBM_ATTR_DESCRIPTION:
+                        description = tmp;
+                        break;
+                    case OTBM_ATTR_SPAWN_FILE:
+                        spawnFile = fileName.substr(0, fileName.rfind('/') + 1) + tmp;
+                        break;
+                    case OTBM_ATTR_HOUSE_FILE:
+                        houseFile = fileName.substr(0, fileName.rfind('/') + 1) + tmp;
+                        break;
+                    default:
+                        throw Exception("Invalid attribute '%d'", static_cast<int>(attribute));
+                }
+            }
+
+            g_dispatcher.addEvent([this, width, height, description, spawnFile, houseFile] {
+                setWidth(width);
+                setHeight(height);
+                if (!description.empty())
+                    setDescription(description);
+                if (!spawnFile.empty())
+                    setSpawnFile(spawnFile);
+                if (!houseFile.empty())
+                    setHouseFile(houseFile);
+            });
+
+            for (const auto& nodeMapData : node->getChildren()) {
+                const uint8_t mapDataType = nodeMapData->getU8();
+                if (mapDataType == OTBM_TILE_AREA) {
+                    Position basePos;
+                    basePos.x = nodeMapData->getU16();
+                    basePos.y = nodeMapData->getU16();
+                    basePos.z = nodeMapData->getU8();
+
+                    std::vector<ParsedTile> batch;
+                    for (const auto& nodeTile : nodeMapData->getChildren()) {
+                        const uint8_t type = nodeTile->getU8();
+                        if (unlikely(type != OTBM_TILE && type != OTBM_HOUSETILE))
+                            throw Exception("invalid node tile type %d", static_cast<int>(type));
+
+                        ParsedTile& parsedTile = batch.emplace_back();
+                        parsedTile.pos = basePos + nodeTile->getPoint();
+
+                        if (type == OTBM_HOUSETILE)
+                            parsedTile.houseId = nodeTile->getU32();
+
+                        while (nodeTile->canRead()) {
+                            const uint8_t tileAttr = nodeTile->getU8();
+                            switch (tileAttr) {
+                                case OTBM_ATTR_TILE_FLAGS:
+                                {
+                                    const uint32_t _flags = nodeTile->getU32();
+                                    if ((_flags & TILESTATE_PROTECTIONZONE) == TILESTATE_PROTECTIONZONE)
+                                        parsedTile.flags |= TILESTATE_PROTECTIONZONE;
+                                    else if ((_flags & TILESTATE_OPTIONALZONE) == TILESTATE_OPTIONALZONE)
+                                        parsedTile.flags |= TILESTATE_OPTIONALZONE;
+                                    else if ((_flags & TILESTATE_HARDCOREZONE) == TILESTATE_HARDCOREZONE)
+                                        parsedTile.flags |= TILESTATE_HARDCOREZONE;
+
+                                    if ((_flags & TILESTATE_NOLOGOUT) == TILESTATE_NOLOGOUT)
+                                        parsedTile.flags |= TILESTATE_NOLOGOUT;
+
+                                    if ((_flags & TILESTATE_REFRESH) == TILESTATE_REFRESH)
+                                        parsedTile.flags |= TILESTATE_REFRESH;
+                                    break;
+                                }
+                                case OTBM_ATTR_ITEM:
+                                {
+                                    parsedTile.items.emplace_back(Item::createFromOtb(nodeTile->getU16()));
+                                    break;
+                                }
+                                default:
+                                {
+                                    throw Exception("invalid tile attribute %d at pos %s",
+                                                    static_cast<int>(tileAttr), stdext::to_string(parsedTile.pos));
+                                }
+                            }
+                        }
+
+                        for (const auto& nodeItem : nodeTile->getChildren()) {
+                            if (unlikely(nodeItem->getU8() != OTBM_ITEM))
+                                throw Exception("invalid item node");
+
+                            ItemPtr item = Item::createFromOtb(nodeItem->getU16());
+                            item->unserializeItem(nodeItem);
+
+                            if (item->isContainer()) {
+                                for (const auto& containerItem : nodeItem->getChildren()) {
+                                    if (containerItem->getU8() != OTBM_ITEM)
+                                        throw Exception("invalid container item node");
+
+                                    ItemPtr cItem = Item::createFromOtb(containerItem->getU16());
+                                    cItem->unserializeItem(containerItem);
+                                    item->addContainerItem(cItem);
+                                }
+                            }
+
+                            parsedTile.items.emplace_back(item);
+                        }
+                    }
+
+                    while (pendingBatches->load() >= 2)
+                        stdext::millisleep(1);
+
+                    ++*pendingBatches;
+                    g_dispatcher.addEvent([this, pendingBatches, batch = std::move(batch)] {
+                        for (const auto& parsedTile : batch) {
+                            HousePtr house = nullptr;
+                            if (parsedTile.houseId != 0) {
+                                const TilePtr& tile = getOrCreateTile(parsedTile.pos);
+                                if (!(house = g_houses.getHouse(parsedTile.houseId))) {
+                                    house = std::make_shared<House>(parsedTile.houseId);
+                                    g_houses.addHouse(house);
+                                }
+                                house->setTile(tile);
+                            }
+
+                            for (const auto& item : parsedTile.items) {
+                                if (house && item->isMoveable()) {
+                                    g_logger.warning(stdext::format("Moveable item found in house: %d at pos %s - escaping...", item->getId(), stdext::to_string(parsedTile.pos)));
+                                    continue;
+                                }
+                                addThing(item, parsedTile.pos);
+                            }
+
+                            if (const TilePtr& tile = getTile(parsedTile.pos)) {
+                                if (house)
+                                    tile->setFlag(TILESTATE_HOUSE);
+                                tile->setFlag(parsedTile.flags);
+                            }
+                        }
+                        --*pendingBatches;
+                    });
+                } else if (mapDataType == OTBM_TOWNS) {
+                    std::vector<TownPtr> towns;
+                    for (const auto& nodeTown : nodeMapData->getChildren()) {
+                        if (nodeTown->getU8() != OTBM_TOWN)
+                            throw Exception("invalid town node.");
+
+                        const uint32_t townId = nodeTown->getU32();
+                        const auto& townName = nodeTown->getString();
+
+                        Position townCoords;
+                        townCoords.x = nodeTown->getU16();
+                        townCoords.y = nodeTown->getU16();
+                        townCoords.z = nodeTown->getU8();
+
+                        towns.emplace_back(std::make_shared<Town>(townId, townName, townCoords));
+                    }
+
+                    g_dispatcher.addEvent([towns = std::move(towns)] {
+                        for (const auto& town : towns) {
+                            if (!g_towns.getTown(town->getId()))
+                                g_towns.addTown(town);
+                        }
+                        g_towns.sort();
+                    });
+                } else if (mapDataType == OTBM_WAYPOINTS && headerVersion > 1) {
+                    std::vector<std::pair<Position, std::string>> waypoints;
+                    for (const auto& nodeWaypoint : nodeMapData->getChildren()) {
+                        if (nodeWaypoint->getU8() != OTBM_WAYPOINT)
+                            throw Exception("invalid waypoint node.");
+
+                        std::string name = nodeWaypoint->getString();
+
+                        Position waypointPos;
+                        waypointPos.x = nodeWaypoint->getU16();
+                        waypointPos.y = nodeWaypoint->getU16();
+                        waypointPos.z = nodeWaypoint->getU8();
+
+                        if (waypointPos.isValid() && !name.empty())
+                            waypoints.emplace_back(waypointPos, name);
+                    }
+
+                    g_dispatcher.addEvent([this, waypoints = std::move(waypoints)] {
+                        for (const auto& [pos, name] : waypoints) {
+                            if (!m_waypoints.contains(pos))
+                                m_waypoints.emplace(pos, name);
+                        }
+                    });
+                } else
+                    throw Exception("Unknown map data node %d", static_cast<int>(mapDataType));
+            }
+
+            fin->close();
+        } catch (const std::exception& e) {
+            g_logger.error(stdext::format("Failed to load '%s': %s", fileName, e.what()));
+            ok = false;
+        }
+
+        if (callback)
+            g_dispatcher.addEvent([callback, ok] { callback(ok); });
+    });
+}
+
 void Map::saveOtbm(const std::string& fileName)
 {
     try {
-        const FileStreamPtr fin = g_resources.createFile(fileName);
+        const FileStreamPtr fin = g_resources.createBufferedFile(fileName);
         if (!fin)
             throw Exception("failed to open file '%s' for write", fileName);
 
-        fin->cache();
         std::string dir;
         if (fileName.find_last_of('/') == std::string::npos)
             dir = g_resources.getWorkDir();
@@ -303,70 +564,110 @@ void Map::saveOtbm(const std::string& fileName)
                 root->addU8(OTBM_ATTR_HOUSE_FILE);
                 root->addString(houseFile);
 
-                int px = -1;
-                int py = -1;
-                int pz = -1;
-                bool firstNode = true;
-
-                for (uint8_t z = 0; z <= MAX_Z; ++z) {
-                    for (const auto& it : m_tileBlocks[z]) {
-                        const TileBlock& block = it.second;
-                        for (const TilePtr& tile : block.getTiles()) {
-                            if (unlikely(!tile || tile->isEmpty()))
-                                continue;
-
-                            const Position& pos = tile->getPosition();
-                            if (unlikely(!pos.isValid()))
-                                continue;
-
-                            if (pos.x < px || pos.x >= px + 256
-                                || pos.y < py || pos.y >= py + 256
-                                || pos.z != pz) {
-                                if (!firstNode)
-                                    root->endNode(); /// OTBM_TILE_AREA
-
-                                firstNode = false;
-                                root->startNode(OTBM_TILE_AREA);
-
-                                px = pos.x & 0xFF00;
-                                py = pos.y & 0xFF00;
-                                pz = pos.z;
-                                root->addPos(px, py, pz);
-                            }
-
-                            root->startNode(tile->isHouseTile() ? OTBM_HOUSETILE : OTBM_TILE);
-                            root->addPoint(Point(pos.x, pos.y) & 0xFF);
-                            if (tile->isHouseTile())
-                                root->addU32(tile->getHouseId());
-
-                            if (tile->getFlags()) {
-                                root->addU8(OTBM_ATTR_TILE_FLAGS);
-                                root->addU32(tile->getFlags());
+                // tile areas are self-contained byte chunks in OTBM, so each
+                // batch of them can be serialized (and escaped) in parallel on
+                // the async workers and the buffers concatenated in order
+                struct TileArea
+                {
+                    uint16_t x;
+                    uint16_t y;
+                    uint8_t z;
+                    std::vector<TilePtr> tiles;
+                };
+
+                std::vector<TileArea> areas;
+                {
+                    int px = -1;
+                    int py = -1;
+                    int pz = -1;
+
+                    for (uint8_t z = 0; z <= MAX_Z; ++z) {
+                        for (const auto& it : m_tileBlocks[z]) {
+                            const TileBlock& block = it.second;
+                            for (const TilePtr& tile : block.getTiles()) {
+                                if (unlikely(!tile || tile->isEmpty()))
+                                    continue;
+
+                                const Position& pos = tile->getPosition();
+                                if (unlikely(!pos.isValid()))
+                                    continue;
+
+                                if (pos.x < px || pos.x >= px + 256
+                                    || pos.y < py || pos.y >= py + 256
+                                    || pos.z != pz) {
+                                    px = pos.x & 0xFF00;
+                                    py = pos.y & 0xFF00;
+                                    pz = pos.z;
+                                    areas.push_back({ static_cast<uint16_t>(px), static_cast<uint16_t>(py), static_cast<uint8_t>(pz), {} });
+                                }
+
+                                areas.back().tiles.emplace_back(tile);
                             }
+                        }
+                    }
+                }
 
-                            const auto& itemList = tile->getItems();
-                            const ItemPtr& ground = tile->getGround();
-                            if (ground) {
-                                // Those types are called "complex" needs other stuff to be written.
-                                // For containers, there is container items, for depot, depot it and so on.
-                                if (!ground->isContainer() && !ground->isDepot()
-                                    && !ground->isDoor() && !ground->isTeleport()) {
-                                    root->addU8(OTBM_ATTR_ITEM);
-                                    root->addU16(ground->getServerId());
-                                } else
-                                    ground->serializeItem(root);
+                static constexpr size_t AREAS_PER_TASK = 8;
+
+                std::vector<std::shared_future<std::vector<uint8_t>>> chunks;
+                for (size_t first = 0; first < areas.size(); first += AREAS_PER_TASK) {
+                    const size_t last = std::min<size_t>(areas.size(), first + AREAS_PER_TASK);
+                    std::vector<TileArea> batch(std::make_move_iterator(areas.begin() + first),
+                                                std::make_move_iterator(areas.begin() + last));
+
+                    chunks.emplace_back(g_asyncDispatcher.schedule([batch = std::move(batch)]() -> std::vector<uint8_t> {
+                        std::vector<uint8_t> buffer;
+                        const auto& out = std::make_shared<OutputBinaryTree>(buffer);
+
+                        for (const auto& area : batch) {
+                            out->startNode(OTBM_TILE_AREA);
+                            out->addPos(area.x, area.y, area.z);
+
+                            for (const TilePtr& tile : area.tiles) {
+                                const Position& pos = tile->getPosition();
+
+                                out->startNode(tile->isHouseTile() ? OTBM_HOUSETILE : OTBM_TILE);
+                                out->addPoint(Point(pos.x, pos.y) & 0xFF);
+                                if (tile->isHouseTile())
+                                    out->addU32(tile->getHouseId());
+
+                                if (tile->getFlags()) {
+                                    out->addU8(OTBM_ATTR_TILE_FLAGS);
+                                    out->addU32(tile->getFlags());
+                                }
+
+                                const auto& itemList = tile->getItems();
+                                const ItemPtr& ground = tile->getGround();
+                                if (ground) {
+                                    // Those types are called "complex" needs other stuff to be written.
+                                    // For containers, there is container items, for depot, depot it and so on.
+                                    if (!ground->isContainer() && !ground->isDepot()
+                                        && !ground->isDoor() && !ground->isTeleport()) {
+                                        out->addU8(OTBM_ATTR_ITEM);
+                                        out->addU16(ground->getServerId());
+                                    } else
+                                        ground->serializeItem(out);
+                                }
+                                for (const ItemPtr& item : itemList)
+                                    if (!item->isGround())
+                                        item->serializeItem(out);
+
+                                out->endNode(); // OTBM_TILE
                             }
-                            for (const ItemPtr& item : itemList)
-                                if (!item->isGround())
-                                    item->serializeItem(root);
 
-                            root->endNode(); // OTBM_TILE
+                            out->endNode(); // OTBM_TILE_AREA
                         }
-                    }
+
+                        return buffer;
+                    }));
                 }
 
-                if (!firstNode)
-                    root->endNode();  // OTBM_TILE_AREA
+                // the chunks are already escaped, splice them straight into
+                // the stream in submission order
+                for (auto& chunk : chunks) {
+                    const auto& buffer = chunk.get();
+                    fin->write(buffer.data(), buffer.size());
+                }
 
                 root->startNode(OTBM_TOWNS);
                 for (const TownPtr& town : g_towns.getTowns()) {
@@ -398,7 +699,7 @@ void Map::saveOtbm(const std::string& fileName)
         }
         root->endNode();
 
-        fin->flush();
+        fin->flushAsync();
         fin->close();
     } catch (const std::exception& e) {
         g_logger.error(stdext::format("Failed to save '%s': %s", fileName, e.what()));
@@ -487,8 +788,7 @@ void Map::saveOtcm(const std::string& fileName)
     try {
         stdext::timer saveTimer;
 
-        const FileStreamPtr fin = g_resources.createFile(fileName);
-        fin->cache();
+        const FileStreamPtr fin = g_resources.createBufferedFile(fileName);
 
         //TODO: compression flag with zlib
         const uint32_t flags = 0;
@@ -543,7 +843,7 @@ void Map::saveOtcm(const std::string& fileName)
         fin->addU16(invalidPos.y);
         fin->addU8(invalidPos.z);
 
-        fin->flush();
+        fin->flushAsync();
 
         fin->close();
     } catch (const stdext::exception& e) {
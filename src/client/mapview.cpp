@@ -34,6 +34,7 @@
 
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/frameprofiler.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/drawpoolmanager.h>
 #include <framework/graphics/graphics.h>
@@ -75,6 +76,9 @@ MapView::MapView() : m_pool(g_drawPool.get(DrawPoolType::MAP))
             m_shader->setUniformValue(ShaderManager::MAP_WALKOFFSET, last.x / static_cast<float>(m_rectDimension.width()), last.y / static_cast<float>(m_rectDimension.height()));
 
             g_painter->setShaderProgram(m_shader);
+        } else if (m_lightView && m_lightView->isComposited()) {
+            // fold the light multiply into this blit, see LightView::setupComposition
+            m_lightView->setupComposition(m_pool->getFrameBuffer()->getTexture());
         }
 
         g_painter->setOpacity(fadeOpacity);
@@ -98,6 +102,14 @@ MapView::~MapView()
 
 void MapView::draw()
 {
+    PROFILE_SCOPE("MapView::draw");
+
+    // advance every walking creature in one batch before drawing them
+    g_map.updateWalkingCreatures();
+
+    // feed the animation LOD policy with this frame's camera and crowd size
+    Creature::setAnimationLodReference(m_posInfo.camera, g_map.getCreatureCount());
+
     // update visible tiles cache when needed
     if (m_updateVisibleTiles)
         updateVisibleTiles();
@@ -117,7 +129,10 @@ void MapView::draw()
         return;
     }
 
-    if (m_lightView) m_lightView->draw(m_posInfo.rect, m_posInfo.srcRect);
+    if (m_lightView) {
+        m_lightView->setComposited(m_lightView->canCompose() && !m_shader);
+        m_lightView->draw(m_posInfo.rect, m_posInfo.srcRect);
+    }
 }
 
 void MapView::drawFloor()
@@ -127,7 +142,17 @@ void MapView::drawFloor()
         const auto& cameraPosition = m_posInfo.camera;
         const auto& lightView = isDrawingLights() ? m_lightView.get() : nullptr;
 
-        uint32_t flags = Otc::DrawThings;
+        // zoom-aware detail: once a tile covers only a few on-screen pixels
+        // effects, elevation offsets and outfit layers stop being readable
+        m_zoomDetailFlags = 0;
+        const int onScreenTileSize = m_visibleDimension.width() > 0 ? m_posInfo.rect.width() / m_visibleDimension.width() : SPRITE_SIZE;
+        if (onScreenTileSize <= SPRITE_SIZE / 2) {
+            m_zoomDetailFlags |= Otc::DrawLowDetail;
+            if (onScreenTileSize <= SPRITE_SIZE / 4)
+                m_zoomDetailFlags |= Otc::DrawMinimalDetail;
+        }
+
+        uint32_t flags = Otc::DrawThings | m_zoomDetailFlags;
         if (lightView) flags |= Otc::DrawLights;
         if (m_drawNames) { flags |= Otc::DrawNames; }
         if (m_drawHealthBars) { flags |= Otc::DrawBars; }
@@ -177,8 +202,15 @@ void MapView::drawFloor()
                     g_drawPool.resetOpacity();
             }
 
-            for (const auto& missile : g_map.getFloorMissiles(z))
-                missile->drawMissile(transformPositionTo2D(missile->getPosition(), cameraPosition), lightView);
+#ifdef FRAMEWORK_EDITOR
+            if (g_map.showZones())
+                drawZones(z);
+#endif
+
+            if (!(m_zoomDetailFlags & Otc::DrawMinimalDetail)) {
+                for (const auto& missile : g_map.getFloorMissiles(z))
+                    missile->drawMissile(transformPositionTo2D(missile->getPosition(), cameraPosition), lightView);
+            }
 
             if (m_shadowFloorIntensity > 0 && z == cameraPosition.z + 1) {
                 g_drawPool.setOpacity(m_shadowFloorIntensity, true);
@@ -205,6 +237,113 @@ void MapView::drawFloor()
     }
 }
 
+#ifdef FRAMEWORK_EDITOR
+void MapView::drawZones(const int floorZ)
+{
+    if (m_zoneRectsVersion != g_map.getZoneVersion()) {
+        rebuildZoneRects();
+        m_zoneRectsVersion = g_map.getZoneVersion();
+    }
+
+    const auto& rects = m_zoneRects[floorZ];
+    if (rects.empty())
+        return;
+
+    const float opacity = g_map.getZoneOpacity();
+    for (const auto& zoneRect : rects) {
+        const auto& point = transformPositionTo2D(zoneRect.pos, m_posInfo.camera);
+        auto color = g_map.getZoneColor(static_cast<tileflags_t>(zoneRect.flag));
+        color.setAlpha(opacity);
+        g_drawPool.addFilledRect(Rect(point, zoneRect.width * m_tileSize, zoneRect.height * m_tileSize), color);
+    }
+}
+
+void MapView::rebuildZoneRects()
+{
+    // one color per tile, resolved in priority order like the old
+    // per-tile overlay did
+    static constexpr tileflags_t ZONE_PRIORITY[] = {
+        TILESTATE_HOUSE, TILESTATE_PROTECTIONZONE, TILESTATE_OPTIONALZONE,
+        TILESTATE_HARDCOREZONE, TILESTATE_NOLOGOUT, TILESTATE_REFRESH
+    };
+
+    for (auto& rects : m_zoneRects)
+        rects.clear();
+
+    if (!g_map.showZones())
+        return;
+
+    for (int_fast8_t z = m_floorMin; z <= m_floorMax; ++z) {
+        // gather flagged visible cells sorted by row then column
+        std::vector<std::tuple<int, int, uint32_t>> cells; // y, x, flag
+        for (const auto& tile : m_cachedVisibleTiles[z].tiles) {
+            uint32_t flag = TILESTATE_NONE;
+            for (const tileflags_t candidate : ZONE_PRIORITY) {
+                if (g_map.showZone(candidate) && tile->hasFlag(candidate)) {
+                    flag = candidate;
+                    break;
+                }
+            }
+            if (flag == TILESTATE_NONE)
+                continue;
+
+            const auto& pos = tile->getPosition();
+            cells.emplace_back(pos.y, pos.x, flag);
+        }
+
+        if (cells.empty())
+            continue;
+
+        std::sort(cells.begin(), cells.end());
+
+        // greedy merge: horizontal runs of contiguous same-flag cells first
+        struct Strip { int x; int y; int width; uint32_t flag; };
+        std::vector<Strip> strips;
+        for (size_t i = 0; i < cells.size();) {
+            const auto& [y, x, flag] = cells[i];
+            int width = 1;
+            size_t j = i + 1;
+            while (j < cells.size()) {
+                const auto& [ny, nx, nflag] = cells[j];
+                if (ny != y || nflag != flag || nx != x + width)
+                    break;
+                ++width;
+                ++j;
+            }
+            strips.emplace_back(Strip{ x, y, width, flag });
+            i = j;
+        }
+
+        // then grow each strip downward over identical runs on later rows
+        auto& rects = m_zoneRects[z];
+        std::vector<bool> consumed(strips.size(), false);
+        for (size_t i = 0; i < strips.size(); ++i) {
+            if (consumed[i])
+                continue;
+
+            const auto& strip = strips[i];
+            int height = 1;
+            for (size_t j = i + 1; j < strips.size(); ++j) {
+                if (consumed[j])
+                    continue;
+
+                const auto& next = strips[j];
+                if (next.y > strip.y + height)
+                    break; // rows ascend, no run for this row exists
+
+                if (next.y == strip.y + height && next.x == strip.x &&
+                    next.width == strip.width && next.flag == strip.flag) {
+                    ++height;
+                    consumed[j] = true;
+                }
+            }
+
+            rects.emplace_back(ZoneRect{ Position(strip.x, strip.y, z), strip.width, height, strip.flag });
+        }
+    }
+}
+#endif
+
 void MapView::drawText()
 {
     g_drawPool.use(DrawPoolType::TEXT);
@@ -223,6 +362,10 @@ void MapView::drawText()
         staticText->drawText(p, m_posInfo.rect);
     }
 
+    // animated texts are unreadable at overview zoom levels, skip them
+    if (m_zoomDetailFlags & Otc::DrawLowDetail)
+        return;
+
     for (const auto& animatedText : g_map.getAnimatedTexts()) {
         const auto& pos = animatedText->getPosition();
 
@@ -244,14 +387,32 @@ void MapView::updateVisibleTiles()
     if (!m_posInfo.camera.isValid())
         return;
 
-    // clear current visible tiles cache
-    do {
-        m_cachedVisibleTiles[m_floorMin].clear();
-    } while (++m_floorMin <= m_floorMax);
+    const uint8_t prevFirstVisibleFloor = m_cachedFirstVisibleFloor;
+    const uint8_t prevLastVisibleFloor = m_cachedLastVisibleFloor;
+    const uint8_t prevFloorMin = m_floorMin;
+    const uint8_t prevFloorMax = m_floorMax;
+    const Position previousCameraPosition = m_lastCameraPosition;
+
+    // a one-tile camera step on the same floor only changes the viewport
+    // edges, so the cached floors can be slid instead of rebuilt; anything
+    // else (content changes, floor switches, fading) forces a full rebuild
+    bool incremental = !m_fullVisibleTilesUpdate
+        && m_floorViewMode != ALWAYS_WITH_TRANSPARENCY && !canFloorFade()
+        && previousCameraPosition.isValid()
+        && previousCameraPosition != m_posInfo.camera
+        && previousCameraPosition.z == m_posInfo.camera.z
+        && std::abs(m_posInfo.camera.x - previousCameraPosition.x) <= 1
+        && std::abs(m_posInfo.camera.y - previousCameraPosition.y) <= 1;
+
+    if (!incremental) {
+        // clear current visible tiles cache
+        do {
+            m_cachedVisibleTiles[m_floorMin].clear();
+        } while (++m_floorMin <= m_floorMax);
+    }
 
     m_lockedFirstVisibleFloor = m_floorViewMode == LOCKED ? m_posInfo.camera.z : -1;
 
-    const uint8_t prevFirstVisibleFloor = m_cachedFirstVisibleFloor;
     if (m_lastCameraPosition != m_posInfo.camera) {
         if (m_mousePosition.isValid()) {
             const Otc::Direction direction = m_lastCameraPosition.getDirectionFromPosition(m_posInfo.camera);
@@ -281,6 +442,14 @@ void MapView::updateVisibleTiles()
         cachedFirstVisibleFloor = calcFirstVisibleFloor(false);
     }
 
+    // the visible floor range changed (e.g. the camera stepped over a hole),
+    // fall back to a full rebuild
+    if (incremental && (m_cachedFirstVisibleFloor != prevFirstVisibleFloor || m_cachedLastVisibleFloor != prevLastVisibleFloor)) {
+        incremental = false;
+        for (int iz = prevFloorMin; iz <= prevFloorMax; ++iz)
+            m_cachedVisibleTiles[iz].clear();
+    }
+
     // Fading System by Kondra https://github.com/OTCv8/otclientv8
     if (!m_lastCameraPosition.isValid() || m_lastCameraPosition.z != m_posInfo.camera.z || m_lastCameraPosition.distance(m_posInfo.camera) >= 3) {
         m_fadeType = FadeType::NONE$;
@@ -306,6 +475,30 @@ void MapView::updateVisibleTiles()
 
     const bool fadeFinished = getFadeLevel(m_cachedFirstVisibleFloor) == 1.f;
 
+    if (incremental) {
+        // the cleared ranges were never touched, bring the floor range back
+        m_floorMin = prevFloorMin;
+        m_floorMax = prevFloorMax;
+
+        const int dx = m_posInfo.camera.x - previousCameraPosition.x;
+        const int dy = m_posInfo.camera.y - previousCameraPosition.y;
+        slideVisibleTiles(dx, dy);
+
+        // the framebuffer still holds this exact scene shifted by the step;
+        // let the pool blit it and confine the repaint to the exposed band
+        m_pool->scroll(Point(-dx * m_tileSize, -dy * m_tileSize));
+
+        m_updateVisibleTiles = false;
+        m_fullVisibleTilesUpdate = false;
+        return;
+    }
+
+    // another view may have walked the exact same visible set this frame
+    // (spectate and picture-in-picture setups share the camera), then its
+    // cached floors can be copied instead of re-walking the map
+    if (!canFloorFade() && m_floorViewMode != ALWAYS_WITH_TRANSPARENCY && adoptVisibleTiles())
+        return;
+
     // cache visible tiles in draw order
     // draw from last floor (the lower) to first floor (the higher)
     const uint32_t numDiagonals = m_drawDimension.width() + m_drawDimension.height() - 1;
@@ -331,7 +524,7 @@ void MapView::updateVisibleTiles()
 
                     if (fadeFinished) {
                         // skip tiles that are completely behind another tile
-                        if (tile->isCompletelyCovered(m_cachedFirstVisibleFloor, m_resetCoveredCache)) {
+                        if (tile->isCompletelyCovered(m_cachedFirstVisibleFloor)) {
                             if (m_floorViewMode != ALWAYS_WITH_TRANSPARENCY || (tilePos.z < m_posInfo.camera.z && tile->isCovered(m_cachedFirstVisibleFloor))) {
                                 addTile = false;
                             }
@@ -340,11 +533,14 @@ void MapView::updateVisibleTiles()
 
                     if (addTile) {
                         floor.tiles.emplace_back(tile);
+                        floor.tileOrder.emplace_back(tileOrderKey(ix, iy));
                         tile->onAddInMapView();
                     }
 
-                    if (isDrawingLights() && tile->canShade())
+                    if (isDrawingLights() && tile->canShade()) {
                         floor.shades.emplace_back(tile);
+                        floor.shadeOrder.emplace_back(tileOrderKey(ix, iy));
+                    }
 
                     if (addTile || !floor.shades.empty()) {
                         if (iz < m_floorMin)
@@ -358,7 +554,174 @@ void MapView::updateVisibleTiles()
     }
 
     m_updateVisibleTiles = false;
-    m_resetCoveredCache = false;
+    m_fullVisibleTilesUpdate = false;
+
+#ifdef FRAMEWORK_EDITOR
+    // the visible tile set changed, merged zone rects must follow it
+    m_zoneRectsVersion = 0;
+#endif
+}
+
+bool MapView::adoptVisibleTiles()
+{
+    for (const auto& view : g_map.getMapViews()) {
+        const auto* source = view.get();
+
+        // only an up-to-date view that walked the map with the same camera,
+        // dimension and floor range holds exactly the tile set this view
+        // would compute; fading and transparency filter per view, so those
+        // caches are never shared
+        if (source == this || source->m_updateVisibleTiles
+            || source->canFloorFade() || source->m_floorViewMode == ALWAYS_WITH_TRANSPARENCY
+            || source->m_lastCameraPosition != m_posInfo.camera
+            || source->m_drawDimension != m_drawDimension
+            || source->m_cachedFirstVisibleFloor != m_cachedFirstVisibleFloor
+            || source->m_cachedLastVisibleFloor != m_cachedLastVisibleFloor
+            || source->isDrawingLights() != isDrawingLights())
+            continue;
+
+        // the source already ran onAddInMapView on every tile this frame
+        for (int iz = source->m_floorMin; iz <= source->m_floorMax; ++iz)
+            m_cachedVisibleTiles[iz] = source->m_cachedVisibleTiles[iz];
+
+        m_floorMin = source->m_floorMin;
+        m_floorMax = source->m_floorMax;
+
+        m_updateVisibleTiles = false;
+        m_fullVisibleTilesUpdate = false;
+
+#ifdef FRAMEWORK_EDITOR
+        m_zoneRectsVersion = 0;
+#endif
+        return true;
+    }
+
+    return false;
+}
+
+void MapView::slideVisibleTiles(const int dx, const int dy)
+{
+    const int width = m_drawDimension.width();
+    const int height = m_drawDimension.height();
+    const int numDiagonals = width + height - 1;
+
+    // the diagonal scan of the full rebuild also walks a short strip of cells
+    // left of the viewport, so membership is tested against the scanned set
+    // rather than the plain viewport rectangle
+    const auto scanned = [&](const int ix, const int iy) {
+        return iy >= 0 && iy <= height && ix < width && ix + iy >= 0 && ix + iy < numDiagonals;
+    };
+
+    std::vector<TilePtr> enteringTiles;
+    std::vector<uint32_t> enteringOrder;
+
+    for (int_fast32_t iz = m_cachedLastVisibleFloor; iz >= m_cachedFirstVisibleFloor; --iz) {
+        auto& floor = m_cachedVisibleTiles[iz];
+
+        // shift the surviving entries; a uniform translation preserves the
+        // (diagonal, column) draw order, so the list stays sorted
+        size_t kept = 0;
+        for (size_t i = 0; i < floor.tiles.size(); ++i) {
+            const int ix = static_cast<int>(floor.tileOrder[i] & 0xFFFF) - 0x8000 - dx;
+            const int iy = static_cast<int>(floor.tileOrder[i] >> 16) - (ix + dx) - dy;
+            if (!scanned(ix, iy))
+                continue;
+
+            floor.tileOrder[kept] = tileOrderKey(ix, iy);
+            floor.tiles[kept] = std::move(floor.tiles[i]);
+            ++kept;
+        }
+        floor.tiles.resize(kept);
+        floor.tileOrder.resize(kept);
+
+        kept = 0;
+        for (size_t i = 0; i < floor.shades.size(); ++i) {
+            const int ix = static_cast<int>(floor.shadeOrder[i] & 0xFFFF) - 0x8000 - dx;
+            const int iy = static_cast<int>(floor.shadeOrder[i] >> 16) - (ix + dx) - dy;
+            if (!scanned(ix, iy))
+                continue;
+
+            floor.shadeOrder[kept] = tileOrderKey(ix, iy);
+            floor.shades[kept] = std::move(floor.shades[i]);
+            ++kept;
+        }
+        floor.shades.resize(kept);
+        floor.shadeOrder.resize(kept);
+
+        // evaluate only the cells that entered the viewport, in draw order
+        enteringTiles.clear();
+        enteringOrder.clear();
+        for (uint_fast32_t diagonal = 0; diagonal < static_cast<uint32_t>(numDiagonals); ++diagonal) {
+            const uint32_t advance = std::max<uint32_t >(diagonal - m_drawDimension.height(), 0);
+            for (int iy = diagonal - advance, ix = advance; iy >= 0 && ix < width; --iy, ++ix) {
+                // cells already visible before the step survived the shift above
+                if (scanned(ix + dx, iy + dy))
+                    continue;
+
+                Position tilePos = m_posInfo.camera.translated(ix - m_virtualCenterOffset.x, iy - m_virtualCenterOffset.y);
+                tilePos.coveredUp(m_posInfo.camera.z - iz);
+                if (const auto& tile = g_map.getTile(tilePos)) {
+                    // skip tiles that have nothing
+                    if (!tile->isDrawable())
+                        continue;
+
+                    // skip tiles that are completely behind another tile
+                    const bool addTile = !tile->isCompletelyCovered(m_cachedFirstVisibleFloor);
+
+                    if (addTile) {
+                        enteringTiles.emplace_back(tile);
+                        enteringOrder.emplace_back(tileOrderKey(ix, iy));
+                        tile->onAddInMapView();
+                    }
+
+                    if (isDrawingLights() && tile->canShade()) {
+                        floor.shades.emplace_back(tile);
+                        floor.shadeOrder.emplace_back(tileOrderKey(ix, iy));
+                    }
+
+                    if (addTile || !floor.shades.empty()) {
+                        if (iz < m_floorMin)
+                            m_floorMin = iz;
+                        else if (iz > m_floorMax)
+                            m_floorMax = iz;
+                    }
+                }
+            }
+        }
+
+        if (enteringTiles.empty())
+            continue;
+
+        // merge the entering cells into the surviving list, keeping draw order
+        std::vector<TilePtr> mergedTiles;
+        std::vector<uint32_t> mergedOrder;
+        mergedTiles.reserve(floor.tiles.size() + enteringTiles.size());
+        mergedOrder.reserve(mergedTiles.capacity());
+
+        size_t a = 0, b = 0;
+        while (a < floor.tiles.size() && b < enteringTiles.size()) {
+            if (floor.tileOrder[a] <= enteringOrder[b]) {
+                mergedOrder.emplace_back(floor.tileOrder[a]);
+                mergedTiles.emplace_back(std::move(floor.tiles[a]));
+                ++a;
+            } else {
+                mergedOrder.emplace_back(enteringOrder[b]);
+                mergedTiles.emplace_back(std::move(enteringTiles[b]));
+                ++b;
+            }
+        }
+        for (; a < floor.tiles.size(); ++a) {
+            mergedOrder.emplace_back(floor.tileOrder[a]);
+            mergedTiles.emplace_back(std::move(floor.tiles[a]));
+        }
+        for (; b < enteringTiles.size(); ++b) {
+            mergedOrder.emplace_back(enteringOrder[b]);
+            mergedTiles.emplace_back(std::move(enteringTiles[b]));
+        }
+
+        floor.tiles.swap(mergedTiles);
+        floor.tileOrder.swap(mergedOrder);
+    }
 }
 
 void MapView::updateRect(const Rect& rect) {
@@ -385,6 +748,11 @@ void MapView::updateGeometry(const Size& visibleDimension)
         scaleFactor /= 2;
     }
 
+    // internal render-resolution scaling; the composition stretch applied in
+    // updateRect blows the smaller framebuffer back up to the widget rect
+    if (m_renderScale < 100)
+        scaleFactor *= m_renderScale / 100.f;
+
     m_pool->setScaleFactor(scaleFactor);
 
     const uint16_t tileSize = SPRITE_SIZE * m_pool->getScaleFactor();
@@ -450,13 +818,15 @@ void MapView::updateLight()
     m_lightView->setGlobalLight(ambientLight);
 }
 
-void MapView::onTileUpdate(const Position&, const ThingPtr& thing, const Otc::Operation op)
+void MapView::onTileUpdate(const Position&, const ThingPtr&, const Otc::Operation)
 {
-    if (thing) {
-        if (thing->isOpaque() && op == Otc::OPERATION_REMOVE)
-            m_resetCoveredCache = true;
-    }
+    // stale covered caches are already invalidated per tile by
+    // Map::invalidateCoveredCache, the rebuild just re-reads them
+    requestUpdateVisibleTiles();
+}
 
+void MapView::onTileUpdateBatch()
+{
     requestUpdateVisibleTiles();
 }
 
@@ -548,7 +918,22 @@ void MapView::setAntiAliasingMode(const AntialiasingMode mode)
     m_antiAliasingMode = mode;
 
     g_drawPool.get(DrawPoolType::MAP)->getFrameBuffer()
-        ->setSmooth(mode != ANTIALIASING_DISABLED);
+        ->setSmooth(mode != ANTIALIASING_DISABLED || m_renderScale < 100);
+
+    updateGeometry(m_visibleDimension);
+}
+
+void MapView::setRenderScale(const uint8_t scalePercent)
+{
+    const uint8_t scale = std::clamp<uint8_t>(scalePercent, 50, 100);
+    if (m_renderScale == scale)
+        return;
+
+    m_renderScale = scale;
+
+    // keep bilinear sampling on while upscaling, even with antialiasing off
+    g_drawPool.get(DrawPoolType::MAP)->getFrameBuffer()
+        ->setSmooth(m_antiAliasingMode != ANTIALIASING_DISABLED || m_renderScale < 100);
 
     updateGeometry(m_visibleDimension);
 }
@@ -624,7 +1009,7 @@ void MapView::move(int32_t x, int32_t y)
     requestUpdateMapPosInfo();
 
     if (requestTilesUpdate)
-        requestUpdateVisibleTiles();
+        requestUpdateVisibleTiles(false); // smooth walk steps one tile, let the cache slide
 
     onCameraMove(m_moveOffset);
 }
@@ -731,15 +1116,22 @@ TilePtr MapView::getTopTile(Position tilePos) const
     if (m_floorViewMode == ALWAYS_WITH_TRANSPARENCY && tilePos.isInRange(m_lastCameraPosition, TRANSPARENT_FLOOR_VIEW_RANGE, TRANSPARENT_FLOOR_VIEW_RANGE))
         return g_map.getTile(tilePos);
 
+    if (tilePos.isValid() && tilePos == m_lastPickPos)
+        return m_lastPickTile;
+    m_lastPickPos = tilePos;
+
     tilePos.coveredUp(tilePos.z - m_cachedFirstVisibleFloor);
     for (uint8_t i = m_cachedFirstVisibleFloor; i <= m_floorMax; ++i) {
         const auto& tile = g_map.getTile(tilePos);
-        if (tile && tile->isClickable())
+        if (tile && tile->isClickable()) {
+            m_lastPickTile = tile;
             return tile;
+        }
 
         tilePos.coveredDown();
     }
 
+    m_lastPickTile = nullptr;
     return nullptr;
 }
 
@@ -776,6 +1168,7 @@ void MapView::setDrawLights(bool enable)
             return;
 
         m_lightView = std::make_shared<LightView>(m_drawDimension, m_tileSize);
+        m_lightView->setResolutionScale(m_lightResolutionScale);
 
         requestUpdateVisibleTiles();
     } else m_lightView = nullptr;
@@ -783,6 +1176,13 @@ void MapView::setDrawLights(bool enable)
     updateLight();
 }
 
+void MapView::setLightResolutionScale(const uint8_t scale)
+{
+    m_lightResolutionScale = scale;
+    if (m_lightView)
+        m_lightView->setResolutionScale(scale);
+}
+
 void MapView::updateViewportDirectionCache()
 {
     for (uint8_t dir = Otc::North; dir <= Otc::InvalidDirection; ++dir) {
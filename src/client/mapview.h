@@ -129,6 +129,9 @@ public:
     void setDrawLights(bool enable);
     bool isDrawingLights() const { return m_lightView && m_lightView->isDark(); }
 
+    void setLightResolutionScale(uint8_t scale);
+    uint8_t getLightResolutionScale() const { return m_lightResolutionScale; }
+
     void setLimitVisibleDimension(bool v) { m_limitVisibleDimension = v; }
     bool isLimitedVisibleDimension() const { return m_limitVisibleDimension; }
 
@@ -164,6 +167,12 @@ public:
     void setCrosshairTexture(const std::string& texturePath);
     void setAntiAliasingMode(AntialiasingMode mode);
 
+    // renders the map framebuffer at a fraction of its native resolution and
+    // lets the composition stretch fill the widget, trading sharpness for
+    // fill rate on resolution-bound machines
+    void setRenderScale(uint8_t scalePercent);
+    uint8_t getRenderScale() const { return m_renderScale; }
+
     void onMouseMove(const Position& mousePos, bool isVirtualMove = false);
     void onKeyRelease(const InputEvent& inputEvent);
 
@@ -181,6 +190,7 @@ protected:
     void onGlobalLightChange(const Light& light);
     void onFloorChange(uint8_t floor, uint8_t previousFloor);
     void onTileUpdate(const Position& pos, const ThingPtr& thing, Otc::Operation operation);
+    void onTileUpdateBatch();
     void onMapCenterChange(const Position& newPos, const Position& oldPos);
     void onCameraMove(const Point& offset);
     void onFadeInFinished();
@@ -200,7 +210,14 @@ private:
     {
         std::vector<TilePtr> shades;
         std::vector<TilePtr> tiles;
-        void clear() { shades.clear(); tiles.clear(); }
+
+        // camera-relative draw order keys kept alongside the tiles, so a
+        // one-tile camera step can slide the cached list instead of
+        // rebuilding it
+        std::vector<uint32_t> tileOrder;
+        std::vector<uint32_t> shadeOrder;
+
+        void clear() { shades.clear(); tiles.clear(); tileOrder.clear(); shadeOrder.clear(); }
     };
 
     struct Crosshair
@@ -212,8 +229,20 @@ private:
 
     void updateGeometry(const Size& visibleDimension);
     void updateVisibleTiles();
+    void slideVisibleTiles(int dx, int dy);
+    bool adoptVisibleTiles();
     void updateRect(const Rect& rect);
-    void requestUpdateVisibleTiles() { m_updateVisibleTiles = true; }
+    void requestUpdateVisibleTiles(const bool force = true)
+    {
+        m_updateVisibleTiles = true;
+        if (force)
+            m_fullVisibleTilesUpdate = true;
+
+        // tile updates and camera moves both come through here, so the
+        // hover pick cache can't outlive what it resolved against
+        m_lastPickPos = {};
+        m_lastPickTile = nullptr;
+    }
     void requestUpdateMapPosInfo() { m_posInfo.rect = {}; }
 
     uint8_t calcFirstVisibleFloor(bool checkLimitsFloorsView) const;
@@ -223,10 +252,20 @@ private:
     void updateViewportDirectionCache();
     void drawFloor();
 
+#ifdef FRAMEWORK_EDITOR
+    void drawZones(int floorZ);
+    void rebuildZoneRects();
+#endif
+
     void updateViewport(const Otc::Direction dir = Otc::InvalidDirection) { m_viewport = m_viewPortDirection[dir]; }
 
     bool canFloorFade() const { return m_floorViewMode == FADE && m_floorFading; }
 
+    // draw order key for a camera-relative cell: diagonal first, then column.
+    // the column is biased because the diagonal scan also walks a few cells
+    // left of the viewport, where ix goes negative.
+    static constexpr uint32_t tileOrderKey(const int ix, const int iy) { return (ix + iy) << 16 | (ix + 0x8000); }
+
     float getFadeLevel(uint8_t z) const
     {
         if (!canFloorFade()) return 1.f;
@@ -248,6 +287,7 @@ private:
     }
 
     int8_t m_lockedFirstVisibleFloor{ -1 };
+    uint8_t m_lightResolutionScale{ 1 };
     uint8_t m_cachedFirstVisibleFloor{ SEA_FLOOR };
     uint8_t m_cachedLastVisibleFloor{ SEA_FLOOR };
     uint8_t m_floorMin{ 0 };
@@ -256,6 +296,9 @@ private:
     uint16_t m_tileSize{ SPRITE_SIZE };
     uint16_t m_floorFading = 500;
 
+    // zoom detail tier of the current frame, see drawFloor()
+    uint32_t m_zoomDetailFlags{ 0 };
+
     float m_minimumAmbientLight{ 0 };
     float m_fadeInTime{ 0 };
     float m_fadeOutTime{ 0 };
@@ -280,7 +323,7 @@ private:
 
     bool m_limitVisibleDimension{ true };
     bool m_updateVisibleTiles{ true };
-    bool m_resetCoveredCache{ true };
+    bool m_fullVisibleTilesUpdate{ true };
     bool m_shaderSwitchDone{ true };
     bool m_drawHealthBars{ true };
     bool m_drawManaBar{ true };
@@ -297,9 +340,24 @@ private:
     FadeType m_fadeType{ FadeType::NONE$ };
 
     AntialiasingMode m_antiAliasingMode{ AntialiasingMode::ANTIALIASING_DISABLED };
+    uint8_t m_renderScale{ 100 };
 
     std::array<MapObject, MAX_Z + 1> m_cachedVisibleTiles;
 
+#ifdef FRAMEWORK_EDITOR
+    // contiguous same-zone tiles merged into a handful of translucent
+    // rectangles, rebuilt only when tile flags or the shown set change
+    struct ZoneRect
+    {
+        Position pos;
+        int width;
+        int height;
+        uint32_t flag; // tileflags_t
+    };
+    std::array<std::vector<ZoneRect>, MAX_Z + 1> m_zoneRects;
+    uint32_t m_zoneRectsVersion{ 0 };
+#endif
+
     stdext::timer m_fadingFloorTimers[MAX_Z + 1];
 
     PainterShaderProgramPtr m_shader;
@@ -315,6 +373,11 @@ private:
     TilePtr m_lastHighlightTile;
     TexturePtr m_crosshairTexture;
 
+    // last getTopTile resolution; hover queries repeat the same tile many
+    // times between tile updates
+    mutable Position m_lastPickPos;
+    mutable TilePtr m_lastPickTile;
+
     DrawConductor m_shadowConductor{ false, DrawOrder::FIFTH };
     DrawPool* m_pool;
 };
@@ -23,7 +23,9 @@
 #include "minimap.h"
 #include "tile.h"
 
+#include <queue>
 #include <zlib.h>
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/filestream.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/core/eventdispatcher.h>
@@ -34,55 +36,124 @@
 Minimap g_minimap;
 static MinimapTile nulltile;
 
+// the 8-bit minimap palette expanded to rgba once, so block rasterization
+// is a flat table lookup instead of per-pixel Color construction
+static const auto MINIMAP_PALETTE = [] {
+    std::array<uint32_t, 256> palette;
+    for (int i = 0; i < 256; ++i)
+        palette[i] = Color::from8bit(i).rgba();
+    return palette;
+}();
+
+// seen and crossable, the only tiles the block router walks through
+static bool isRoutable(const MinimapTile& tile)
+{
+    return tile.hasFlag(MinimapTileWasSeen) && !(tile.flags & (MinimapTileNotPathable | MinimapTileNotWalkable | MinimapTileEmpty));
+}
+
 void MinimapBlock::clean()
 {
     m_tiles.fill({});
     m_texture.reset();
     m_mustUpdate = false;
+    m_componentsDirty = true;
 }
 
 void MinimapBlock::update()
 {
-    if (!m_mustUpdate)
+    if (!m_mustUpdate || m_updateScheduled)
         return;
 
-    if (m_image)
-        m_image->resize(m_size);
-    else
-        m_image = std::make_shared<Image>(m_size);
-
-    bool shouldDraw = false;
-    for (uint_fast8_t x = 0; x < MMBLOCK_SIZE; ++x) {
-        for (uint_fast8_t y = 0; y < MMBLOCK_SIZE; ++y) {
-            const uint8_t c = getTile(x, y).color;
-
-            Color col = Color::alpha;
-            if (c != UINT8_MAX) {
-                col = Color::from8bit(c);
-                shouldDraw = true;
-            }
-
-            m_image->setPixel(x, y, col);
+    m_mustUpdate = false;
+    m_updateScheduled = true;
+
+    // rasterize on a worker from a snapshot of the tiles and publish the
+    // finished image back on the game thread; the draw keeps using the
+    // previous texture meanwhile, so exploring new areas never stalls the
+    // frame on pixel filling
+    g_asyncDispatcher.dispatch([self = shared_from_this(), tiles = m_tiles] {
+        const auto& image = std::make_shared<Image>(self->m_size);
+
+        // tiles and pixels share the same row-major layout, so the whole
+        // 64x64 block expands through the palette in one vectorizable pass
+        auto* pixels = reinterpret_cast<uint32_t*>(image->getPixelData());
+        bool shouldDraw = false;
+        for (uint_fast16_t i = 0; i < MMBLOCK_SIZE * MMBLOCK_SIZE; ++i) {
+            const uint8_t c = tiles[i].color;
+            shouldDraw |= c != UINT8_MAX;
+            pixels[i] = MINIMAP_PALETTE[c];
         }
-    }
 
-    if (shouldDraw)
-        if (m_texture)
-            m_texture->updateImage(m_image);
-        else
-            m_texture = std::make_shared<Texture>(m_image, true, false);
-    else
-        m_texture.reset();
-
-    m_mustUpdate = false;
+        g_dispatcher.addEvent([self, image, shouldDraw] {
+            if (shouldDraw) {
+                if (self->m_texture)
+                    self->m_texture->updateImage(image);
+                else
+                    self->m_texture = std::make_shared<Texture>(image, true, false);
+            } else
+                self->m_texture.reset();
+
+            self->m_updateScheduled = false;
+        });
+    });
 }
 
 void MinimapBlock::updateTile(int x, int y, const MinimapTile& tile)
 {
-    if (m_tiles[getTileIndex(x, y)].color != tile.color)
+    auto& current = m_tiles[getTileIndex(x, y)];
+    if (current.color != tile.color)
         m_mustUpdate = true;
+    if (current.flags != tile.flags)
+        m_componentsDirty = true;
+
+    current = tile;
+}
+
+const std::array<uint8_t, MMBLOCK_SIZE* MMBLOCK_SIZE>& MinimapBlock::getComponents()
+{
+    if (!m_componentsDirty)
+        return m_components;
+
+    m_components.fill(0);
+
+    // flood fill with the same 8-connectivity the tile search uses
+    uint8_t nextId = 0;
+    std::vector<uint16_t> stack;
+    for (uint_fast16_t seed = 0; seed < MMBLOCK_SIZE * MMBLOCK_SIZE; ++seed) {
+        if (m_components[seed] != 0 || !isRoutable(m_tiles[seed]))
+            continue;
+
+        // ids saturate at 255; merging the surplus regions only risks an
+        // optimistic corridor, which the tile refinement then rejects
+        if (nextId < UINT8_MAX)
+            ++nextId;
+
+        m_components[seed] = nextId;
+        stack.push_back(seed);
+        while (!stack.empty()) {
+            const uint16_t index = stack.back();
+            stack.pop_back();
+            const int x = index % MMBLOCK_SIZE;
+            const int y = index / MMBLOCK_SIZE;
+            for (int j = -1; j <= 1; ++j) {
+                for (int i = -1; i <= 1; ++i) {
+                    const int nx = x + i;
+                    const int ny = y + j;
+                    if (nx < 0 || ny < 0 || nx >= MMBLOCK_SIZE || ny >= MMBLOCK_SIZE)
+                        continue;
+
+                    const uint16_t neighbor = ny * MMBLOCK_SIZE + nx;
+                    if (m_components[neighbor] == 0 && isRoutable(m_tiles[neighbor])) {
+                        m_components[neighbor] = nextId;
+                        stack.push_back(neighbor);
+                    }
+                }
+            }
+        }
+    }
 
-    m_tiles[getTileIndex(x, y)] = tile;
+    m_componentsDirty = false;
+    return m_components;
 }
 
 void Minimap::init() {}
@@ -91,8 +162,11 @@ void Minimap::terminate() { clean(); }
 void Minimap::clean()
 {
     std::scoped_lock lock(m_lock);
-    for (uint_fast8_t i = 0; i <= MAX_Z; ++i)
+    for (uint_fast8_t i = 0; i <= MAX_Z; ++i) {
         m_tileBlocks[i].clear();
+        m_compressedBlocks[i].clear();
+    }
+    m_compressedData = {};
 }
 
 void Minimap::draw(const Rect& screenRect, const Position& mapCenter, float scale, const Color& color)
@@ -220,15 +294,166 @@ std::pair<MinimapBlock_ptr, MinimapTile> Minimap::threadGetTile(const Position&
     std::scoped_lock lock(m_lock);
 
     if (pos.z <= MAX_Z && hasBlock(pos)) {
-        const auto& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
-        if (block) {
-            const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
-            return std::make_pair(block, block->getTile(pos.x - offsetPos.x, pos.y - offsetPos.y));
+        auto& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+        if (!block) {
+            block = std::make_shared<MinimapBlock>();
+            inflateBlock(pos, *block);
         }
+
+        const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
+        return std::make_pair(block, block->getTile(pos.x - offsetPos.x, pos.y - offsetPos.y));
     }
     return std::make_pair(nullptr, nulltile);
 }
 
+// Resolves a long hop at block granularity: A* over (block, walkable
+// region) nodes with an edge wherever two adjacent blocks share a
+// crossable border tile. Explored blocks answer from their cached region
+// labels, so cross-map routes cost microseconds; the result is the set of
+// blocks the tile-level search is then confined to.
+bool Minimap::findBlockRoute(const Position& start, const Position& goal, stdext::set<uint32_t>& corridor)
+{
+    if (start.z != goal.z || start.z > MAX_Z)
+        return false;
+
+    std::scoped_lock lock(m_lock);
+
+    const int z = start.z;
+    const auto getRoutableBlock = [&](const Position& pos) -> MinimapBlock* {
+        if (pos.x < 0 || pos.y < 0 || pos.x >= 65536 || pos.y >= 65536 || !hasBlock(pos))
+            return nullptr;
+
+        auto& block = m_tileBlocks[z][getBlockIndex(pos)];
+        if (!block) {
+            block = std::make_shared<MinimapBlock>();
+            inflateBlock(pos, *block);
+        }
+        return block.get();
+    };
+
+    auto* startBlock = getRoutableBlock(start);
+    auto* goalBlock = getRoutableBlock(goal);
+    if (!startBlock || !goalBlock)
+        return false;
+
+    const uint8_t startComp = startBlock->getComponents()[startBlock->getTileIndex(start.x, start.y)];
+    const uint8_t goalComp = goalBlock->getComponents()[goalBlock->getTileIndex(goal.x, goal.y)];
+    if (startComp == 0 || goalComp == 0)
+        return false;
+
+    const auto makeKey = [](const uint32_t blockIndex, const uint8_t comp) { return (static_cast<uint64_t>(blockIndex) << 8) | comp; };
+    const uint64_t startKey = makeKey(getBlockIndex(start), startComp);
+    const uint64_t goalKey = makeKey(getBlockIndex(goal), goalComp);
+
+    const auto heuristic = [&](const Position& blockPos) {
+        const float dx = blockPos.x + MMBLOCK_SIZE / 2 - goal.x;
+        const float dy = blockPos.y + MMBLOCK_SIZE / 2 - goal.y;
+        return std::sqrt(dx * dx + dy * dy);
+    };
+
+    struct RouteNode
+    {
+        float cost{ 0 };
+        uint64_t prevKey{ UINT64_MAX };
+        bool closed{ false };
+    };
+    stdext::map<uint64_t, RouteNode> nodes;
+    std::priority_queue<std::pair<float, uint64_t>, std::vector<std::pair<float, uint64_t>>, std::greater<>> searchList;
+
+    nodes[startKey] = {};
+    searchList.emplace(heuristic(getIndexPosition(startKey >> 8, z)), startKey);
+
+    int limit = 8192;
+    bool found = false;
+    while (!searchList.empty() && --limit) {
+        const uint64_t key = searchList.top().second;
+        searchList.pop();
+
+        auto& node = nodes[key];
+        if (node.closed)
+            continue;
+        node.closed = true;
+
+        if (key == goalKey) {
+            found = true;
+            break;
+        }
+
+        const Position blockPos = getIndexPosition(key >> 8, z);
+        auto* block = getRoutableBlock(blockPos);
+        if (!block)
+            continue;
+
+        const uint8_t comp = key & 0xff;
+        const auto& comps = block->getComponents();
+        const float cost = node.cost + MMBLOCK_SIZE;
+
+        // the four bordering blocks, scanning the shared edge for tiles of
+        // this region facing a routable region on the other side
+        static constexpr std::array<std::pair<int, int>, 4> sides{ { {0, -1}, {0, 1}, {-1, 0}, {1, 0} } };
+        for (const auto& [dx, dy] : sides) {
+            const Position neighborPos(blockPos.x + dx * MMBLOCK_SIZE, blockPos.y + dy * MMBLOCK_SIZE, z);
+            auto* neighbor = getRoutableBlock(neighborPos);
+            if (!neighbor)
+                continue;
+
+            const auto& neighborComps = neighbor->getComponents();
+            const uint32_t neighborIndex = getBlockIndex(neighborPos);
+            std::array<bool, 256> linked{};
+            for (int i = 0; i < MMBLOCK_SIZE; ++i) {
+                const int x = dx != 0 ? (dx > 0 ? MMBLOCK_SIZE - 1 : 0) : i;
+                const int y = dy != 0 ? (dy > 0 ? MMBLOCK_SIZE - 1 : 0) : i;
+                if (comps[y * MMBLOCK_SIZE + x] != comp)
+                    continue;
+
+                const int nx = dx != 0 ? MMBLOCK_SIZE - 1 - x : i;
+                const int ny = dy != 0 ? MMBLOCK_SIZE - 1 - y : i;
+                const uint8_t other = neighborComps[ny * MMBLOCK_SIZE + nx];
+                if (other == 0 || linked[other])
+                    continue;
+                linked[other] = true;
+
+                const uint64_t neighborKey = makeKey(neighborIndex, other);
+                auto& neighborNode = nodes.try_emplace(neighborKey, RouteNode{ 1e20f, UINT64_MAX, false }).first->second;
+                if (!neighborNode.closed && cost < neighborNode.cost) {
+                    neighborNode.cost = cost;
+                    neighborNode.prevKey = key;
+                    searchList.emplace(cost + heuristic(neighborPos), neighborKey);
+                }
+            }
+        }
+    }
+
+    if (!found)
+        return false;
+
+    for (uint64_t key = goalKey; key != UINT64_MAX; key = nodes[key].prevKey)
+        corridor.insert(static_cast<uint32_t>(key >> 8));
+
+    return true;
+}
+
+// must be called with m_lock held
+void Minimap::inflateBlock(const Position& pos, MinimapBlock& block)
+{
+    auto& directory = m_compressedBlocks[pos.z];
+    const auto it = directory.find(getBlockIndex(pos));
+    if (it == directory.end())
+        return;
+
+    constexpr unsigned long blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
+    unsigned long destLen = blockSize;
+    const bool inBounds = static_cast<size_t>(it->second.offset) + it->second.size <= m_compressedData.size();
+    const int ret = inBounds ? uncompress(reinterpret_cast<uint8_t*>(&block.getTiles()), &destLen, m_compressedData.data() + it->second.offset, it->second.size) : Z_DATA_ERROR;
+    if (ret == Z_OK && destLen == blockSize) {
+        block.mustUpdate();
+        block.justSaw();
+    } else
+        g_logger.error(stdext::format("failed to inflate OTMM minimap block %s", stdext::to_string(pos)));
+
+    directory.erase(it);
+}
+
 bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, float colorFactor)
 {
     // non pathable colors
@@ -329,6 +554,7 @@ bool Minimap::loadOtmm(const std::string& fileName)
 
         switch (version) {
             case 1:
+            case 2:
             {
                 fin->getString(); // description
                 break;
@@ -339,6 +565,35 @@ bool Minimap::loadOtmm(const std::string& fileName)
 
         fin->seek(start);
 
+        if (version == 2) {
+            // block directory followed by compressed frames; only the
+            // directory is parsed now, blocks are inflated on first access
+            std::scoped_lock lock(m_lock);
+
+            const uint32_t blockCount = fin->getU32();
+            for (uint32_t i = 0; i < blockCount; ++i) {
+                Position pos;
+                pos.x = fin->getU16();
+                pos.y = fin->getU16();
+                pos.z = fin->getU8();
+
+                OtmmBlock entry;
+                entry.offset = fin->getU32();
+                entry.size = fin->getU16();
+
+                if (!pos.isValid() || pos.z >= MAX_Z + 1)
+                    throw Exception("corrupted OTMM block directory");
+
+                m_compressedBlocks[pos.z][getBlockIndex(pos)] = entry;
+            }
+
+            m_compressedData.resize(fin->size() - fin->tell());
+            fin->read(m_compressedData.data(), m_compressedData.size());
+
+            fin->close();
+            return true;
+        }
+
         constexpr uint32_t blockSize = MMBLOCK_SIZE * MMBLOCK_SIZE * sizeof(MinimapTile);
         std::vector<uint8_t> compressBuffer(compressBound(blockSize));
         std::vector<uint8_t> decompressBuffer(blockSize);
@@ -379,10 +634,8 @@ bool Minimap::loadOtmm(const std::string& fileName)
 void Minimap::saveOtmm(const std::string& fileName)
 {
     try {
-        const FileStreamPtr fin = g_resources.createFile(fileName);
-        fin->cache();
+        const FileStreamPtr fin = g_resources.createBufferedFile(fileName);
 
-        //TODO: compression flag with zlib
         constexpr uint32_t flags = 0;
 
         // header
@@ -391,8 +644,8 @@ void Minimap::saveOtmm(const std::string& fileName)
         fin->addU16(OTMM_VERSION);
         fin->addU32(flags);
 
-        // version 1 header
-        fin->addString("OTMM 1.0"); // description
+        // version 2 header
+        fin->addString("OTMM 2.0"); // description
 
         // go back and rewrite where the map data starts
         const uint32_t start = fin->tell();
@@ -404,30 +657,47 @@ void Minimap::saveOtmm(const std::string& fileName)
         constexpr uint32_t COMPRESS_LEVEL = 3;
         std::vector<uint8_t> compressBuffer(compressBound(blockSize));
 
+        std::scoped_lock lock(m_lock);
+
+        // compress every seen block up front, the directory needs the sizes
+        std::vector<std::pair<Position, std::vector<uint8_t>>> frames;
         for (uint_fast8_t z = 0; z <= MAX_Z; ++z) {
             for (const auto& [index, block] : m_tileBlocks[z]) {
                 if (!(*block).wasSeen())
                     continue;
 
-                const auto& pos = getIndexPosition(index, z);
-                fin->addU16(pos.x);
-                fin->addU16(pos.y);
-                fin->addU8(pos.z);
-
                 unsigned long len = blockSize;
                 compress2(compressBuffer.data(), &len, (uint8_t*)&(*block).getTiles(), blockSize, COMPRESS_LEVEL);
-                fin->addU16(len);
-                fin->write(compressBuffer.data(), len);
+                frames.emplace_back(getIndexPosition(index, z), std::vector<uint8_t>(compressBuffer.data(), compressBuffer.data() + len));
             }
+
+            // blocks never inflated since loading keep their original frames
+            for (const auto& [index, entry] : m_compressedBlocks[z]) {
+                if (m_tileBlocks[z].contains(index))
+                    continue;
+
+                const auto* data = m_compressedData.data() + entry.offset;
+                frames.emplace_back(getIndexPosition(index, z), std::vector<uint8_t>(data, data + entry.size));
+            }
+        }
+
+        // block directory
+        fin->addU32(frames.size());
+        uint32_t offset = 0;
+        for (const auto& [pos, data] : frames) {
+            fin->addU16(pos.x);
+            fin->addU16(pos.y);
+            fin->addU8(pos.z);
+            fin->addU32(offset);
+            fin->addU16(data.size());
+            offset += data.size();
         }
 
-        // end of file
-        const Position invalidPos;
-        fin->addU16(invalidPos.x);
-        fin->addU16(invalidPos.y);
-        fin->addU8(invalidPos.z);
+        // compressed frames
+        for (const auto& [pos, data] : frames)
+            fin->write(data.data(), data.size());
 
-        fin->flush();
+        fin->flushAsync();
 
         fin->close();
     } catch (const stdext::exception& e) {
@@ -26,7 +26,7 @@
 #include "declarations.h"
 
 constexpr uint8_t MMBLOCK_SIZE = 64;
-constexpr uint8_t OTMM_VERSION = 1;
+constexpr uint8_t OTMM_VERSION = 2;
 constexpr uint32_t OTMM_SIGNATURE = 0x4D4d544F;
 
 enum MinimapTileFlags
@@ -49,12 +49,15 @@ struct MinimapTile
     bool operator!=(const MinimapTile& other) const { return !(*this == other); }
 };
 
-class MinimapBlock
+#pragma pack(pop)
+
+class MinimapBlock : public std::enable_shared_from_this<MinimapBlock>
 {
 public:
     void clean();
     void update();
     void updateTile(int x, int y, const MinimapTile& tile);
+    const std::array<uint8_t, MMBLOCK_SIZE* MMBLOCK_SIZE>& getComponents();
     MinimapTile& getTile(int x, int y) { return m_tiles[getTileIndex(x, y)]; }
     void resetTile(int x, int y) { m_tiles[getTileIndex(x, y)] = MinimapTile(); }
     uint32_t getTileIndex(int x, int y) { return ((y % MMBLOCK_SIZE) * MMBLOCK_SIZE) + (x % MMBLOCK_SIZE); }
@@ -65,17 +68,24 @@ public:
     bool wasSeen() const { return m_wasSeen; }
 private:
     TexturePtr m_texture;
-    ImagePtr m_image;
 
     Size m_size{ MMBLOCK_SIZE, MMBLOCK_SIZE };
 
     std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE> m_tiles;
 
+    // walkable-region label per tile, 0 means blocked or unseen; two tiles
+    // sharing a non-zero label are mutually reachable inside the block,
+    // which is the only connectivity question the block router asks
+    std::array<uint8_t, MMBLOCK_SIZE* MMBLOCK_SIZE> m_components;
+    bool m_componentsDirty{ true };
+
     bool m_mustUpdate{ true };
     bool m_wasSeen{ false };
-};
 
-#pragma pack(pop)
+    // a rasterization job is in flight on a worker; the previous texture
+    // keeps being drawn until the new image is published
+    bool m_updateScheduled{ false };
+};
 
 using MinimapBlock_ptr = std::shared_ptr<MinimapBlock>;
 
@@ -96,20 +106,35 @@ public:
     const MinimapTile& getTile(const Position& pos);
     std::pair<MinimapBlock_ptr, MinimapTile> threadGetTile(const Position& pos);
 
+    bool findBlockRoute(const Position& start, const Position& goal, stdext::set<uint32_t>& corridor);
+
+    static uint32_t getBlockIndex(const Position& pos) { return ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE); }
+
     bool loadImage(const std::string& fileName, const Position& topLeft, float colorFactor);
     void saveImage(const std::string& fileName, const Rect& mapRect);
     bool loadOtmm(const std::string& fileName);
     void saveOtmm(const std::string& fileName);
 
 private:
+    // directory entry of a still-compressed v2 OTMM block, offset points
+    // into m_compressedData (see loadOtmm)
+    struct OtmmBlock
+    {
+        uint32_t offset{ 0 };
+        uint16_t size{ 0 };
+    };
+
     Rect calcMapRect(const Rect& screenRect, const Position& mapCenter, float scale) const;
-    bool hasBlock(const Position& pos) { return m_tileBlocks[pos.z].contains(getBlockIndex(pos)); }
+    void inflateBlock(const Position& pos, MinimapBlock& block);
+    bool hasBlock(const Position& pos) { return m_tileBlocks[pos.z].contains(getBlockIndex(pos)) || m_compressedBlocks[pos.z].contains(getBlockIndex(pos)); }
     MinimapBlock& getBlock(const Position& pos)
     {
         std::scoped_lock lock(m_lock);
         auto& ptr = m_tileBlocks[pos.z][getBlockIndex(pos)];
-        if (!ptr)
+        if (!ptr) {
             ptr = std::make_shared<MinimapBlock>();
+            inflateBlock(pos, *ptr);
+        }
         return *ptr;
     }
     Point getBlockOffset(const Point& pos)
@@ -126,8 +151,13 @@ private:
                         (index / (65536 / MMBLOCK_SIZE)) * MMBLOCK_SIZE, static_cast<uint8_t>(z)
         };
     }
-    uint32_t getBlockIndex(const Position& pos) { return ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE); }
     stdext::map<uint32_t, MinimapBlock_ptr> m_tileBlocks[MAX_Z + 1];
+
+    // v2 OTMM keeps the compressed file in memory and inflates each block
+    // on first access, unexplored areas never pay for decompression
+    std::vector<uint8_t> m_compressedData;
+    stdext::map<uint32_t, OtmmBlock> m_compressedBlocks[MAX_Z + 1];
+
     std::mutex m_lock;
 };
 
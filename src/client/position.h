@@ -42,40 +42,19 @@ public:
     Position(int32_t x, int32_t y, uint8_t z) : x(x), y(y), z(z) {}
     Position(const Position& position) = default;
 
+    // x/y offset per direction, in Otc::Direction order (N E S W NE SE SW NW)
+    static constexpr std::array<std::pair<int8_t, int8_t>, Otc::InvalidDirection> DIRECTION_OFFSETS{ {
+        { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 },
+        { 1, -1 }, { 1, 1 }, { -1, 1 }, { -1, -1 }
+    } };
+
     Position translatedToDirection(Otc::Direction direction) const
     {
         Position pos = *this;
-        switch (direction) {
-            case Otc::North:
-                --pos.y;
-                break;
-            case Otc::East:
-                ++pos.x;
-                break;
-            case Otc::South:
-                ++pos.y;
-                break;
-            case Otc::West:
-                --pos.x;
-                break;
-            case Otc::NorthEast:
-                ++pos.x;
-                --pos.y;
-                break;
-            case Otc::SouthEast:
-                ++pos.x;
-                ++pos.y;
-                break;
-            case Otc::SouthWest:
-                --pos.x;
-                ++pos.y;
-                break;
-            case Otc::NorthWest:
-                --pos.x;
-                --pos.y;
-                break;
-            default:
-                break;
+        if (direction < Otc::InvalidDirection) {
+            const auto& [dx, dy] = DIRECTION_OFFSETS[direction];
+            pos.x += dx;
+            pos.y += dy;
         }
         return pos;
     }
@@ -83,37 +62,10 @@ public:
     Position translatedToReverseDirection(Otc::Direction direction)  const
     {
         Position pos = *this;
-        switch (direction) {
-            case Otc::North:
-                ++pos.y;
-                break;
-            case Otc::East:
-                --pos.x;
-                break;
-            case Otc::South:
-                --pos.y;
-                break;
-            case Otc::West:
-                ++pos.x;
-                break;
-            case Otc::NorthEast:
-                --pos.x;
-                ++pos.y;
-                break;
-            case Otc::SouthEast:
-                --pos.x;
-                --pos.y;
-                break;
-            case Otc::SouthWest:
-                ++pos.x;
-                --pos.y;
-                break;
-            case Otc::NorthWest:
-                ++pos.x;
-                ++pos.y;
-                break;
-            default:
-                break;
+        if (direction < Otc::InvalidDirection) {
+            const auto& [dx, dy] = DIRECTION_OFFSETS[direction];
+            pos.x -= dx;
+            pos.y -= dy;
         }
         return pos;
     }
@@ -235,7 +187,11 @@ public:
             _pos.coveredUp(pos.z - z);
         }
 
-        return std::abs(x - _pos.x) <= xRange && std::abs(y - _pos.y) <= yRange && z == pos.z;
+        // |a - b| <= r folded into one unsigned compare per axis, combined
+        // without short-circuit branches
+        return (static_cast<uint32_t>(_pos.x - (x - xRange)) <= 2u * xRange)
+            & (static_cast<uint32_t>(_pos.y - (y - yRange)) <= 2u * yRange)
+            & (z == pos.z);
     }
 
     bool isInRange(const Position& pos, uint16_t minXRange, uint16_t maxXRange, uint16_t minYRange, uint16_t maxYRange, const bool ignoreZ = false) const
@@ -246,7 +202,8 @@ public:
             _pos.coveredUp(pos.z - z);
         }
 
-        return _pos.x >= x - minXRange && _pos.x <= x + maxXRange && _pos.y >= y - minYRange && _pos.y <= y + maxYRange;
+        return (static_cast<uint32_t>(_pos.x - (x - minXRange)) <= static_cast<uint32_t>(minXRange + maxXRange))
+            & (static_cast<uint32_t>(_pos.y - (y - minYRange)) <= static_cast<uint32_t>(minYRange + maxYRange));
     }
 
     // operator less than for stdext::map
@@ -302,6 +259,15 @@ public:
         return std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z);
     }
 
+    // packed 64-bit key with x in the low 16 bits, y next and z above, so
+    // key order matches (z, y, x); the natural key for position-keyed maps
+    uint64_t toKey() const
+    {
+        return (static_cast<uint64_t>(z) << 32)
+            | (static_cast<uint64_t>(static_cast<uint16_t>(y)) << 16)
+            | static_cast<uint16_t>(x);
+    }
+
     int32_t x{ UINT16_MAX };
     int32_t y{ UINT16_MAX };
     uint8_t z{ UINT8_MAX };
@@ -311,7 +277,9 @@ public:
     {
         std::size_t operator() (const Position& pos) const
         {
-            return (((pos.x * 8192) + pos.y) * 16) + pos.z;
+            // fibonacci multiply over the packed key spreads neighboring
+            // positions across buckets, unlike the old row-major formula
+            return static_cast<std::size_t>(pos.toKey() * 0x9E3779B97F4A7C15ull >> 16);
         }
     };
 };
@@ -22,8 +22,15 @@
 
 #include "protocolgame.h"
 #include "game.h"
+#include "framework/core/asyncdispatcher.h"
+#include "framework/core/eventdispatcher.h"
+#include "framework/core/filestream.h"
+#include "framework/core/resourcemanager.h"
 #include "framework/net/inputmessage.h"
 
+constexpr uint16_t OTRC_VERSION = 1;
+constexpr uint32_t OTRC_SIGNATURE = 0x4352544F;
+
 void ProtocolGame::login(const std::string_view accountName, const std::string_view accountPassword, const std::string_view host, uint16_t port,
                          const std::string_view characterName, const std::string_view authenticatorToken, const std::string_view sessionKey)
 {
@@ -33,6 +40,18 @@ void ProtocolGame::login(const std::string_view accountName, const std::string_v
     m_sessionKey = sessionKey;
     m_characterName = characterName;
 
+    // the RSA exponentiation freezes low end machines for a noticeable
+    // moment; without a server challenge the login block is fully known
+    // here, so build it now and encrypt it on a worker while DNS and the
+    // TCP handshake do their round trips
+    m_loginPacketFuture = {};
+    if (g_game.getFeature(Otc::GameLoginPacketEncryption) && !g_game.getFeature(Otc::GameChallengeOnLogin)) {
+        m_loginPacketFuture = g_asyncDispatcher.schedule([msg = buildLoginPacket(0, 0)] {
+            msg->encryptRsa();
+            return msg;
+        });
+    }
+
     connect(host, port);
 }
 
@@ -66,12 +85,159 @@ void ProtocolGame::onRecv(const InputMessagePtr& inputMessage)
         }
     }
 
-    parseMessage(inputMessage);
+    // queue the decoded message and start the next read right away, so a
+    // packet burst (market opening, war fight) is pulled off the wire
+    // without waiting for each parse; the queue is drained in a single
+    // dispatcher pass, keeping all state application on the game thread
+    m_pendingMessages.emplace_back(detachInputMessage());
     recv();
+
+    if (m_recordStream) {
+        // capture exactly the span parseMessage will consume, so replay
+        // skips checksum, sequencing and size handling entirely
+        const auto frame = m_pendingMessages.back()->getUnreadBuffer();
+        m_recordStream->addU32(stdext::millis() - m_recordStart);
+        m_recordStream->addU16(frame.size());
+        m_recordStream->write(frame.data(), frame.size());
+    }
+
+    if (m_pendingMessages.size() == 1) {
+        g_dispatcher.addEvent([self = static_self_cast<ProtocolGame>()] {
+            const auto messages = std::move(self->m_pendingMessages);
+            self->m_pendingMessages.clear();
+            // container slot packets arrive in bursts when bags open or
+            // items shuffle, batch them so each window refreshes once
+            g_game.beginContainerBatch();
+            for (const auto& message : messages)
+                self->parseMessage(message);
+            g_game.endContainerBatch();
+        });
+    }
 }
 
 void ProtocolGame::onError(const std::error_code& error)
 {
+    stopRecording();
     g_game.processConnectionError(error);
     disconnect();
 }
+
+bool ProtocolGame::startRecording(const std::string_view fileName)
+{
+    stopRecording();
+
+    try {
+        const FileStreamPtr fout = g_resources.createFile(fileName);
+        if (!fout)
+            throw Exception("unable to create file");
+
+        fout->addU32(OTRC_SIGNATURE);
+        fout->addU16(OTRC_VERSION);
+
+        // the stream is meaningless without the protocol that produced
+        // it, store both versions so replay can restore them
+        fout->addU16(g_game.getClientVersion());
+        fout->addU16(g_game.getProtocolVersion());
+
+        m_recordStart = stdext::millis();
+        m_recordStream = fout;
+        return true;
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("failed to start session recording '%s': %s", fileName, e.what()));
+        return false;
+    }
+}
+
+void ProtocolGame::stopRecording()
+{
+    if (!m_recordStream)
+        return;
+
+    m_recordStream->flush();
+    m_recordStream->close();
+    m_recordStream = nullptr;
+}
+
+bool ProtocolGame::playRecord(const std::string_view fileName, const bool maxSpeed)
+{
+    try {
+        const FileStreamPtr fin = g_resources.openFile(fileName);
+        if (!fin)
+            throw Exception("unable to open file");
+
+        fin->cache();
+
+        if (fin->getU32() != OTRC_SIGNATURE)
+            throw Exception("invalid OTRC file");
+
+        if (fin->getU16() != OTRC_VERSION)
+            throw Exception("unsupported OTRC version");
+
+        const uint16_t clientVersion = fin->getU16();
+        const uint16_t protocolVersion = fin->getU16();
+        g_game.setClientVersion(clientVersion);
+        g_game.setProtocolVersion(protocolVersion);
+
+        const auto frames = std::make_shared<std::vector<RecordFrame>>();
+        while (fin->tell() < fin->size()) {
+            RecordFrame& frame = frames->emplace_back();
+            frame.elapsed = fin->getU32();
+            frame.data.resize(fin->getU16());
+            fin->read(frame.data.data(), frame.data.size());
+        }
+        fin->close();
+
+        if (frames->empty())
+            throw Exception("record has no messages");
+
+        m_localPlayer = g_game.getLocalPlayer();
+
+        if (maxSpeed) {
+            // benchmark mode: apply the whole session in one dispatcher
+            // pass, measuring pure parse and state-application cost
+            g_dispatcher.addEvent([self = static_self_cast<ProtocolGame>(), frames] {
+                const auto& msg = InputMessage::create();
+                g_game.beginContainerBatch();
+                for (const auto& frame : *frames) {
+                    msg->setBuffer(frame.data);
+                    msg->setReadPos(InputMessage::MAX_HEADER_SIZE);
+                    self->parseMessage(msg);
+                }
+                g_game.endContainerBatch();
+            });
+        } else {
+            g_dispatcher.addEvent([self = static_self_cast<ProtocolGame>(), frames] {
+                self->replayFrame(frames, 0);
+            });
+        }
+
+        return true;
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("failed to replay session record '%s': %s", fileName, e.what()));
+        return false;
+    }
+}
+
+void ProtocolGame::replayFrame(const std::shared_ptr<std::vector<RecordFrame>>& frames, size_t index)
+{
+    const RecordFrame& frame = (*frames)[index];
+
+    const auto& msg = InputMessage::create();
+    msg->setBuffer(frame.data);
+    msg->setReadPos(InputMessage::MAX_HEADER_SIZE);
+
+    g_game.beginContainerBatch();
+    parseMessage(msg);
+    g_game.endContainerBatch();
+
+    if (++index >= frames->size())
+        return;
+
+    // keep the original inter-message timing, coalescing bursts that
+    // arrived inside the same millisecond into back-to-back events
+    const int delay = (*frames)[index].elapsed - frame.elapsed;
+    if (delay <= 0)
+        g_dispatcher.addEvent([self = static_self_cast<ProtocolGame>(), frames, index] { self->replayFrame(frames, index); });
+    else
+        g_dispatcher.scheduleEvent([self = static_self_cast<ProtocolGame>(), frames, index] { self->replayFrame(frames, index); }, delay);
+}
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <framework/core/declarations.h>
 #include <framework/net/protocol.h>
 #include "creature.h"
 #include "declarations.h"
@@ -34,6 +35,7 @@ public:
     void send(const OutputMessagePtr& outputMessage) override;
 
     void sendExtendedOpcode(uint8_t opcode, const std::string_view buffer);
+    OutputMessagePtr buildLoginPacket(uint32_t challengeTimestamp, uint8_t challengeRandom);
     void sendLoginPacket(uint32_t challengeTimestamp, uint8_t challengeRandom);
     void sendEnterGame();
     void sendLogout();
@@ -133,6 +135,26 @@ public:
     // otclient only
     void sendChangeMapAwareRange(int xrange, int yrange);
 
+    // per-opcode instrumentation for parseMessage
+    struct OpcodeStats
+    {
+        uint64_t calls{ 0 };
+        uint64_t elapsedMicros{ 0 };
+    };
+
+    static void setOpcodeProfiling(const bool enabled) { m_opcodeProfiling = enabled; }
+    static bool isOpcodeProfilingEnabled() { return m_opcodeProfiling; }
+    static std::vector<std::tuple<int, uint64_t, uint64_t>> getOpcodeProfile();
+    static void resetOpcodeProfile();
+
+    // session capture and offline replay; records the decrypted inbound
+    // stream as parseMessage sees it, so recordings survive protocol
+    // encryption and can drive the full parse path without a server
+    bool startRecording(const std::string_view fileName);
+    void stopRecording();
+    bool isRecording() { return m_recordStream != nullptr; }
+    bool playRecord(const std::string_view fileName, bool maxSpeed = false);
+
 protected:
     void onConnect() override;
     void onRecv(const InputMessagePtr& inputMessage) override;
@@ -311,11 +333,36 @@ public:
     Position getPosition(const InputMessagePtr& msg);
 
 private:
+    struct RecordFrame
+    {
+        uint32_t elapsed;
+        std::string data;
+    };
+
+    void replayFrame(const std::shared_ptr<std::vector<RecordFrame>>& frames, size_t index);
+
+    using OpcodeHandler = void (*)(ProtocolGame&, const InputMessagePtr&);
+
+    static std::array<OpcodeHandler, 256> buildOpcodeHandlers();
+
+    static const std::array<OpcodeHandler, 256> m_opcodeHandlers;
+    static std::array<OpcodeStats, 256> m_opcodeStats;
+    static bool m_opcodeProfiling;
+
     bool m_enableSendExtendedOpcode{ false };
     bool m_gameInitialized{ false };
     bool m_mapKnown{ false };
     bool m_firstRecv{ true };
 
+    // decoded messages waiting to be applied in the next dispatcher pass
+    std::vector<InputMessagePtr> m_pendingMessages;
+
+    // login block RSA-encrypted on a worker while the connection is made
+    std::shared_future<OutputMessagePtr> m_loginPacketFuture;
+
+    FileStreamPtr m_recordStream;
+    ticks_t m_recordStart{ 0 };
+
     std::string m_accountName;
     std::string m_accountPassword;
     std::string m_authenticatorToken;
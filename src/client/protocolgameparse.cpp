@@ -25,6 +25,7 @@
 #include "effect.h"
 #include "framework/net/inputmessage.h"
 
+#include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 #include "item.h"
 #include "localplayer.h"
@@ -36,11 +37,234 @@
 #include "tile.h"
 #include "time.h"
 
+const std::array<ProtocolGame::OpcodeHandler, 256> ProtocolGame::m_opcodeHandlers = ProtocolGame::buildOpcodeHandlers();
+std::array<ProtocolGame::OpcodeStats, 256> ProtocolGame::m_opcodeStats;
+bool ProtocolGame::m_opcodeProfiling = false;
+
+#define REGISTER_OPCODE(opcode, parser) \
+    handlers[Proto::opcode] = [](ProtocolGame& self, const InputMessagePtr& msg) { self.parser(msg); }
+
+std::array<ProtocolGame::OpcodeHandler, 256> ProtocolGame::buildOpcodeHandlers()
+{
+    std::array<OpcodeHandler, 256> handlers{};
+
+    // feature and version dependent opcodes keep their checks inside the
+    // handler, since both can still change after the table is built
+    handlers[Proto::GameServerLoginOrPendingState] = [](ProtocolGame& self, const InputMessagePtr& msg) {
+        if (g_game.getFeature(Otc::GameLoginPending))
+            self.parsePendingGame(msg);
+        else
+            self.parseLogin(msg);
+    };
+    handlers[Proto::GameServerPing] = [](ProtocolGame& self, const InputMessagePtr& msg) {
+        if (g_game.getFeature(Otc::GameClientPing))
+            self.parsePingBack(msg);
+        else
+            self.parsePing(msg);
+    };
+    handlers[Proto::GameServerPingBack] = [](ProtocolGame& self, const InputMessagePtr& msg) {
+        if (!g_game.getFeature(Otc::GameClientPing))
+            self.parsePingBack(msg);
+        else
+            self.parsePing(msg);
+    };
+    handlers[Proto::GameServerItemClasses] = [](ProtocolGame& self, const InputMessagePtr& msg) {
+        if (g_game.getClientVersion() >= 1281)
+            self.parseItemClasses(msg);
+        else
+            self.parseCreatureMark(msg);
+    };
+    handlers[Proto::GameServerRuleViolationRemove] = [](ProtocolGame& self, const InputMessagePtr& msg) {
+        if (g_game.getClientVersion() >= 1200)
+            self.parseExperienceTracker(msg);
+        else
+            self.parseRuleViolationRemove(msg);
+    };
+    handlers[Proto::GameServerMarketEnter] = [](ProtocolGame& self, const InputMessagePtr& msg) {
+        if (g_game.getClientVersion() >= 1281)
+            self.parseMarketEnter(msg);
+        else
+            self.parseMarketEnterOld(msg);
+    };
+
+    REGISTER_OPCODE(GameServerGMActions, parseGMActions);
+    REGISTER_OPCODE(GameServerUpdateNeeded, parseUpdateNeeded);
+    REGISTER_OPCODE(GameServerLoginError, parseLoginError);
+    REGISTER_OPCODE(GameServerLoginAdvice, parseLoginAdvice);
+    REGISTER_OPCODE(GameServerLoginWait, parseLoginWait);
+    REGISTER_OPCODE(GameServerSessionEnd, parseSessionEnd);
+    REGISTER_OPCODE(GameServerChallenge, parseChallenge);
+    REGISTER_OPCODE(GameServerDeath, parseDeath);
+    REGISTER_OPCODE(GameServerFloorDescription, parseFloorDescription);
+    REGISTER_OPCODE(GameServerFullMap, parseMapDescription);
+    REGISTER_OPCODE(GameServerMapTopRow, parseMapMoveNorth);
+    REGISTER_OPCODE(GameServerMapRightRow, parseMapMoveEast);
+    REGISTER_OPCODE(GameServerMapBottomRow, parseMapMoveSouth);
+    REGISTER_OPCODE(GameServerMapLeftRow, parseMapMoveWest);
+    REGISTER_OPCODE(GameServerUpdateTile, parseUpdateTile);
+    REGISTER_OPCODE(GameServerCreateOnMap, parseTileAddThing);
+    REGISTER_OPCODE(GameServerChangeOnMap, parseTileTransformThing);
+    REGISTER_OPCODE(GameServerDeleteOnMap, parseTileRemoveThing);
+    REGISTER_OPCODE(GameServerMoveCreature, parseCreatureMove);
+    REGISTER_OPCODE(GameServerOpenContainer, parseOpenContainer);
+    REGISTER_OPCODE(GameServerCloseContainer, parseCloseContainer);
+    REGISTER_OPCODE(GameServerCreateContainer, parseContainerAddItem);
+    REGISTER_OPCODE(GameServerChangeInContainer, parseContainerUpdateItem);
+    REGISTER_OPCODE(GameServerDeleteInContainer, parseContainerRemoveItem);
+    REGISTER_OPCODE(GameServerSetInventory, parseAddInventoryItem);
+    REGISTER_OPCODE(GameServerDeleteInventory, parseRemoveInventoryItem);
+    REGISTER_OPCODE(GameServerOpenNpcTrade, parseOpenNpcTrade);
+    REGISTER_OPCODE(GameServerPlayerGoods, parsePlayerGoods);
+    REGISTER_OPCODE(GameServerCloseNpcTrade, parseCloseNpcTrade);
+    REGISTER_OPCODE(GameServerOwnTrade, parseOwnTrade);
+    REGISTER_OPCODE(GameServerCounterTrade, parseCounterTrade);
+    REGISTER_OPCODE(GameServerCloseTrade, parseCloseTrade);
+    REGISTER_OPCODE(GameServerAmbient, parseWorldLight);
+    REGISTER_OPCODE(GameServerGraphicalEffect, parseMagicEffect);
+    REGISTER_OPCODE(GameServerTextEffect, parseAnimatedText);
+    REGISTER_OPCODE(GameServerMissleEffect, parseDistanceMissile);
+    REGISTER_OPCODE(GameServerTrappers, parseTrappers);
+    REGISTER_OPCODE(GameServerCreatureHealth, parseCreatureHealth);
+    REGISTER_OPCODE(GameServerCreatureLight, parseCreatureLight);
+    REGISTER_OPCODE(GameServerCreatureOutfit, parseCreatureOutfit);
+    REGISTER_OPCODE(GameServerCreatureSpeed, parseCreatureSpeed);
+    REGISTER_OPCODE(GameServerCreatureSkull, parseCreatureSkulls);
+    REGISTER_OPCODE(GameServerCreatureParty, parseCreatureShields);
+    REGISTER_OPCODE(GameServerCreatureUnpass, parseCreatureUnpass);
+    REGISTER_OPCODE(GameServerEditText, parseEditText);
+    REGISTER_OPCODE(GameServerEditList, parseEditList);
+    // PROTOCOL>=1038
+    REGISTER_OPCODE(GameServerPremiumTrigger, parsePremiumTrigger);
+    REGISTER_OPCODE(GameServerPlayerData, parsePlayerStats);
+    REGISTER_OPCODE(GameServerPlayerSkills, parsePlayerSkills);
+    REGISTER_OPCODE(GameServerPlayerState, parsePlayerState);
+    REGISTER_OPCODE(GameServerClearTarget, parsePlayerCancelAttack);
+    REGISTER_OPCODE(GameServerPlayerModes, parsePlayerModes);
+    REGISTER_OPCODE(GameServerTalk, parseTalk);
+    REGISTER_OPCODE(GameServerChannels, parseChannelList);
+    REGISTER_OPCODE(GameServerOpenChannel, parseOpenChannel);
+    REGISTER_OPCODE(GameServerOpenPrivateChannel, parseOpenPrivateChannel);
+    REGISTER_OPCODE(GameServerRuleViolationChannel, parseRuleViolationChannel);
+    REGISTER_OPCODE(GameServerRuleViolationCancel, parseRuleViolationCancel);
+    REGISTER_OPCODE(GameServerRuleViolationLock, parseRuleViolationLock);
+    REGISTER_OPCODE(GameServerOpenOwnChannel, parseOpenOwnPrivateChannel);
+    REGISTER_OPCODE(GameServerCloseChannel, parseCloseChannel);
+    REGISTER_OPCODE(GameServerTextMessage, parseTextMessage);
+    REGISTER_OPCODE(GameServerCancelWalk, parseCancelWalk);
+    REGISTER_OPCODE(GameServerWalkWait, parseWalkWait);
+    REGISTER_OPCODE(GameServerFloorChangeUp, parseFloorChangeUp);
+    REGISTER_OPCODE(GameServerFloorChangeDown, parseFloorChangeDown);
+    REGISTER_OPCODE(GameServerChooseOutfit, parseOpenOutfitWindow);
+    REGISTER_OPCODE(GameServerKillTracker, parseKillTracker);
+    REGISTER_OPCODE(GameServerVipAdd, parseVipAdd);
+    REGISTER_OPCODE(GameServerVipState, parseVipState);
+    REGISTER_OPCODE(GameServerVipLogout, parseVipLogout);
+    REGISTER_OPCODE(GameServerTutorialHint, parseTutorialHint);
+    REGISTER_OPCODE(GameServerAutomapFlag, parseAutomapFlag);
+    REGISTER_OPCODE(GameServerQuestLog, parseQuestLog);
+    REGISTER_OPCODE(GameServerQuestLine, parseQuestLine);
+    // PROTOCOL>=870
+    REGISTER_OPCODE(GameServerSpellDelay, parseSpellCooldown);
+    REGISTER_OPCODE(GameServerSpellGroupDelay, parseSpellGroupCooldown);
+    REGISTER_OPCODE(GameServerMultiUseDelay, parseMultiUseCooldown);
+    // PROTOCOL>=910
+    REGISTER_OPCODE(GameServerChannelEvent, parseChannelEvent);
+    REGISTER_OPCODE(GameServerItemInfo, parseItemInfo);
+    REGISTER_OPCODE(GameServerPlayerInventory, parsePlayerInventory);
+    // PROTOCOL>=950
+    REGISTER_OPCODE(GameServerPlayerDataBasic, parsePlayerInfo);
+    // PROTOCOL>=970
+    REGISTER_OPCODE(GameServerModalDialog, parseModalDialog);
+    // PROTOCOL>=980
+    REGISTER_OPCODE(GameServerLoginSuccess, parseLogin);
+    REGISTER_OPCODE(GameServerEnterGame, parseEnterGame);
+    REGISTER_OPCODE(GameServerPlayerHelpers, parsePlayerHelpers);
+    // PROTOCOL>=1000
+    REGISTER_OPCODE(GameServerCreatureMarks, parseCreaturesMark);
+    REGISTER_OPCODE(GameServerCreatureType, parseCreatureType);
+    // PROTOCOL>=1055
+    REGISTER_OPCODE(GameServerBlessings, parseBlessings);
+    REGISTER_OPCODE(GameServerUnjustifiedStats, parseUnjustifiedStats);
+    REGISTER_OPCODE(GameServerPvpSituations, parsePvpSituations);
+    REGISTER_OPCODE(GameServerPreset, parsePreset);
+    // PROTOCOL>=1080
+    REGISTER_OPCODE(GameServerCoinBalanceUpdating, parseCoinBalanceUpdating);
+    REGISTER_OPCODE(GameServerCoinBalance, parseCoinBalance);
+    REGISTER_OPCODE(GameServerRequestPurchaseData, parseRequestPurchaseData);
+    REGISTER_OPCODE(GameServerResourceBalance, parseResourceBalance); // 1281
+    REGISTER_OPCODE(GameServerWorldTime, parseWorldTime);
+    REGISTER_OPCODE(GameServerStoreCompletePurchase, parseCompleteStorePurchase);
+    REGISTER_OPCODE(GameServerStoreOffers, parseStoreOffers);
+    REGISTER_OPCODE(GameServerStoreTransactionHistory, parseStoreTransactionHistory);
+    REGISTER_OPCODE(GameServerStoreError, parseStoreError);
+    REGISTER_OPCODE(GameServerStore, parseStore);
+    // PROTOCOL>=1097
+    REGISTER_OPCODE(GameServerStoreButtonIndicators, parseStoreButtonIndicators);
+    REGISTER_OPCODE(GameServerSetStoreDeepLink, parseSetStoreDeepLink);
+    // otclient ONLY
+    REGISTER_OPCODE(GameServerExtendedOpcode, parseExtendedOpcode);
+    REGISTER_OPCODE(GameServerChangeMapAwareRange, parseChangeMapAwareRange);
+    // 12x
+    REGISTER_OPCODE(GameServerLootContainers, parseLootContainers);
+    REGISTER_OPCODE(GameServerSupplyStash, parseSupplyStash);
+    REGISTER_OPCODE(GameServerSpecialContainer, parseSpecialContainer);
+    REGISTER_OPCODE(GameServerPartyAnalyzer, parsePartyAnalyzer);
+    REGISTER_OPCODE(GameServerRefreshBestiaryTracker, parseBestiaryTracker);
+    REGISTER_OPCODE(GameServerTaskHuntingBasicData, parseTaskHuntingBasicData);
+    REGISTER_OPCODE(GameServerTaskHuntingData, parseTaskHuntingData);
+    REGISTER_OPCODE(GameServerSendShowDescription, parseShowDescription);
+    REGISTER_OPCODE(GameServerSendClientCheck, parseClientCheck);
+    REGISTER_OPCODE(GameServerSendGameNews, parseGameNews);
+    REGISTER_OPCODE(GameServerSendBlessDialog, parseBlessDialog);
+    REGISTER_OPCODE(GameServerSendRestingAreaState, parseRestingAreaState);
+    REGISTER_OPCODE(GameServerSendUpdateImpactTracker, parseUpdateImpactTracker);
+    REGISTER_OPCODE(GameServerSendItemsPrice, parseItemsPrice);
+    REGISTER_OPCODE(GameServerSendUpdateSupplyTracker, parseUpdateSupplyTracker);
+    REGISTER_OPCODE(GameServerSendUpdateLootTracker, parseUpdateLootTracker);
+    REGISTER_OPCODE(GameServerSendBestiaryEntryChanged, parseBestiaryEntryChanged);
+    REGISTER_OPCODE(GameServerSendDailyRewardCollectionState, parseDailyRewardCollectionState);
+    REGISTER_OPCODE(GameServerSendOpenRewardWall, parseOpenRewardWall);
+    REGISTER_OPCODE(GameServerSendDailyReward, parseDailyReward);
+    REGISTER_OPCODE(GameServerSendRewardHistory, parseRewardHistory);
+    REGISTER_OPCODE(GameServerSendPreyFreeRerolls, parsePreyFreeRerolls);
+    REGISTER_OPCODE(GameServerSendPreyTimeLeft, parsePreyTimeLeft);
+    REGISTER_OPCODE(GameServerSendPreyData, parsePreyData);
+    REGISTER_OPCODE(GameServerSendPreyRerollPrice, parsePreyRerollPrice);
+    REGISTER_OPCODE(GameServerSendImbuementWindow, parseImbuementWindow);
+    REGISTER_OPCODE(GameServerSendCloseImbuementWindow, parseCloseImbuementWindow);
+    REGISTER_OPCODE(GameServerSendError, parseError);
+    REGISTER_OPCODE(GameServerMarketDetail, parseMarketDetail);
+    REGISTER_OPCODE(GameServerMarketBrowse, parseMarketBrowse);
+
+    return handlers;
+}
+
+#undef REGISTER_OPCODE
+
+std::vector<std::tuple<int, uint64_t, uint64_t>> ProtocolGame::getOpcodeProfile()
+{
+    std::vector<std::tuple<int, uint64_t, uint64_t>> profile;
+    for (int opcode = 0; opcode < 256; ++opcode) {
+        const auto& stats = m_opcodeStats[opcode];
+        if (stats.calls > 0)
+            profile.emplace_back(opcode, stats.calls, stats.elapsedMicros);
+    }
+    return profile;
+}
+
+void ProtocolGame::resetOpcodeProfile()
+{
+    m_opcodeStats = {};
+}
+
 void ProtocolGame::parseMessage(const InputMessagePtr& msg)
 {
     int opcode = -1;
     int prevOpcode = -1;
 
+    // apply all tile mutations from this message in one MapView/minimap pass
+    g_map.beginTileUpdateBatch();
+
     try {
         while (!msg->eof()) {
             opcode = msg->getU8();
@@ -60,469 +284,28 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
             msg->setReadPos(readPos);
             // restore read pos
 
-            switch (opcode) {
-                case Proto::GameServerLoginOrPendingState:
-                    if (g_game.getFeature(Otc::GameLoginPending))
-                        parsePendingGame(msg);
-                    else
-                        parseLogin(msg);
-                    break;
-                case Proto::GameServerGMActions:
-                    parseGMActions(msg);
-                    break;
-                case Proto::GameServerUpdateNeeded:
-                    parseUpdateNeeded(msg);
-                    break;
-                case Proto::GameServerLoginError:
-                    parseLoginError(msg);
-                    break;
-                case Proto::GameServerLoginAdvice:
-                    parseLoginAdvice(msg);
-                    break;
-                case Proto::GameServerLoginWait:
-                    parseLoginWait(msg);
-                    break;
-                case Proto::GameServerSessionEnd:
-                    parseSessionEnd(msg);
-                    break;
-                case Proto::GameServerPing:
-                case Proto::GameServerPingBack:
-                    if (((opcode == Proto::GameServerPing) && (g_game.getFeature(Otc::GameClientPing))) ||
-                        ((opcode == Proto::GameServerPingBack) && !g_game.getFeature(Otc::GameClientPing)))
-                        parsePingBack(msg);
-                    else
-                        parsePing(msg);
-                    break;
-                case Proto::GameServerChallenge:
-                    parseChallenge(msg);
-                    break;
-                case Proto::GameServerDeath:
-                    parseDeath(msg);
-                    break;
-                case Proto::GameServerFloorDescription:
-                    parseFloorDescription(msg);
-                    break;
-                case Proto::GameServerFullMap:
-                    parseMapDescription(msg);
-                    break;
-                case Proto::GameServerMapTopRow:
-                    parseMapMoveNorth(msg);
-                    break;
-                case Proto::GameServerMapRightRow:
-                    parseMapMoveEast(msg);
-                    break;
-                case Proto::GameServerMapBottomRow:
-                    parseMapMoveSouth(msg);
-                    break;
-                case Proto::GameServerMapLeftRow:
-                    parseMapMoveWest(msg);
-                    break;
-                case Proto::GameServerUpdateTile:
-                    parseUpdateTile(msg);
-                    break;
-                case Proto::GameServerCreateOnMap:
-                    parseTileAddThing(msg);
-                    break;
-                case Proto::GameServerChangeOnMap:
-                    parseTileTransformThing(msg);
-                    break;
-                case Proto::GameServerDeleteOnMap:
-                    parseTileRemoveThing(msg);
-                    break;
-                case Proto::GameServerMoveCreature:
-                    parseCreatureMove(msg);
-                    break;
-                case Proto::GameServerOpenContainer:
-                    parseOpenContainer(msg);
-                    break;
-                case Proto::GameServerCloseContainer:
-                    parseCloseContainer(msg);
-                    break;
-                case Proto::GameServerCreateContainer:
-                    parseContainerAddItem(msg);
-                    break;
-                case Proto::GameServerChangeInContainer:
-                    parseContainerUpdateItem(msg);
-                    break;
-                case Proto::GameServerDeleteInContainer:
-                    parseContainerRemoveItem(msg);
-                    break;
-                case Proto::GameServerSetInventory:
-                    parseAddInventoryItem(msg);
-                    break;
-                case Proto::GameServerDeleteInventory:
-                    parseRemoveInventoryItem(msg);
-                    break;
-                case Proto::GameServerOpenNpcTrade:
-                    parseOpenNpcTrade(msg);
-                    break;
-                case Proto::GameServerPlayerGoods:
-                    parsePlayerGoods(msg);
-                    break;
-                case Proto::GameServerCloseNpcTrade:
-                    parseCloseNpcTrade(msg);
-                    break;
-                case Proto::GameServerOwnTrade:
-                    parseOwnTrade(msg);
-                    break;
-                case Proto::GameServerCounterTrade:
-                    parseCounterTrade(msg);
-                    break;
-                case Proto::GameServerCloseTrade:
-                    parseCloseTrade(msg);
-                    break;
-                case Proto::GameServerAmbient:
-                    parseWorldLight(msg);
-                    break;
-                case Proto::GameServerGraphicalEffect:
-                    parseMagicEffect(msg);
-                    break;
-                case Proto::GameServerTextEffect:
-                    parseAnimatedText(msg);
-                    break;
-                case Proto::GameServerMissleEffect:
-                    parseDistanceMissile(msg);
-                    break;
-                case Proto::GameServerItemClasses:
-                    if (g_game.getClientVersion() >= 1281)
-                        parseItemClasses(msg);
-                    else
-                        parseCreatureMark(msg);
-                    break;
-                case Proto::GameServerTrappers:
-                    parseTrappers(msg);
-                    break;
-                case Proto::GameServerCreatureHealth:
-                    parseCreatureHealth(msg);
-                    break;
-                case Proto::GameServerCreatureLight:
-                    parseCreatureLight(msg);
-                    break;
-                case Proto::GameServerCreatureOutfit:
-                    parseCreatureOutfit(msg);
-                    break;
-                case Proto::GameServerCreatureSpeed:
-                    parseCreatureSpeed(msg);
-                    break;
-                case Proto::GameServerCreatureSkull:
-                    parseCreatureSkulls(msg);
-                    break;
-                case Proto::GameServerCreatureParty:
-                    parseCreatureShields(msg);
-                    break;
-                case Proto::GameServerCreatureUnpass:
-                    parseCreatureUnpass(msg);
-                    break;
-                case Proto::GameServerEditText:
-                    parseEditText(msg);
-                    break;
-                case Proto::GameServerEditList:
-                    parseEditList(msg);
-                    break;
-                    // PROTOCOL>=1038
-                case Proto::GameServerPremiumTrigger:
-                    parsePremiumTrigger(msg);
-                    break;
-                case Proto::GameServerPlayerData:
-                    parsePlayerStats(msg);
-                    break;
-                case Proto::GameServerPlayerSkills:
-                    parsePlayerSkills(msg);
-                    break;
-                case Proto::GameServerPlayerState:
-                    parsePlayerState(msg);
-                    break;
-                case Proto::GameServerClearTarget:
-                    parsePlayerCancelAttack(msg);
-                    break;
-                case Proto::GameServerPlayerModes:
-                    parsePlayerModes(msg);
-                    break;
-                case Proto::GameServerTalk:
-                    parseTalk(msg);
-                    break;
-                case Proto::GameServerChannels:
-                    parseChannelList(msg);
-                    break;
-                case Proto::GameServerOpenChannel:
-                    parseOpenChannel(msg);
-                    break;
-                case Proto::GameServerOpenPrivateChannel:
-                    parseOpenPrivateChannel(msg);
-                    break;
-                case Proto::GameServerRuleViolationChannel:
-                    parseRuleViolationChannel(msg);
-                    break;
-                case Proto::GameServerRuleViolationRemove:
-                    if (g_game.getClientVersion() >= 1200)
-                        parseExperienceTracker(msg);
-                    else
-                        parseRuleViolationRemove(msg);
-                    break;
-                case Proto::GameServerRuleViolationCancel:
-                    parseRuleViolationCancel(msg);
-                    break;
-                case Proto::GameServerRuleViolationLock:
-                    parseRuleViolationLock(msg);
-                    break;
-                case Proto::GameServerOpenOwnChannel:
-                    parseOpenOwnPrivateChannel(msg);
-                    break;
-                case Proto::GameServerCloseChannel:
-                    parseCloseChannel(msg);
-                    break;
-                case Proto::GameServerTextMessage:
-                    parseTextMessage(msg);
-                    break;
-                case Proto::GameServerCancelWalk:
-                    parseCancelWalk(msg);
-                    break;
-                case Proto::GameServerWalkWait:
-                    parseWalkWait(msg);
-                    break;
-                case Proto::GameServerFloorChangeUp:
-                    parseFloorChangeUp(msg);
-                    break;
-                case Proto::GameServerFloorChangeDown:
-                    parseFloorChangeDown(msg);
-                    break;
-                case Proto::GameServerChooseOutfit:
-                    parseOpenOutfitWindow(msg);
-                    break;
-                case Proto::GameServerKillTracker:
-                    parseKillTracker(msg);
-                    break;
-                case Proto::GameServerVipAdd:
-                    parseVipAdd(msg);
-                    break;
-                case Proto::GameServerVipState:
-                    parseVipState(msg);
-                    break;
-                case Proto::GameServerVipLogout:
-                    parseVipLogout(msg);
-                    break;
-                case Proto::GameServerTutorialHint:
-                    parseTutorialHint(msg);
-                    break;
-                case Proto::GameServerAutomapFlag:
-                    parseAutomapFlag(msg);
-                    break;
-                case Proto::GameServerQuestLog:
-                    parseQuestLog(msg);
-                    break;
-                case Proto::GameServerQuestLine:
-                    parseQuestLine(msg);
-                    break;
-                    // PROTOCOL>=870
-                case Proto::GameServerSpellDelay:
-                    parseSpellCooldown(msg);
-                    break;
-                case Proto::GameServerSpellGroupDelay:
-                    parseSpellGroupCooldown(msg);
-                    break;
-                case Proto::GameServerMultiUseDelay:
-                    parseMultiUseCooldown(msg);
-                    break;
-                    // PROTOCOL>=910
-                case Proto::GameServerChannelEvent:
-                    parseChannelEvent(msg);
-                    break;
-                case Proto::GameServerItemInfo:
-                    parseItemInfo(msg);
-                    break;
-                case Proto::GameServerPlayerInventory:
-                    parsePlayerInventory(msg);
-                    break;
-                    // PROTOCOL>=950
-                case Proto::GameServerPlayerDataBasic:
-                    parsePlayerInfo(msg);
-                    break;
-                    // PROTOCOL>=970
-                case Proto::GameServerModalDialog:
-                    parseModalDialog(msg);
-                    break;
-                    // PROTOCOL>=980
-                case Proto::GameServerLoginSuccess:
-                    parseLogin(msg);
-                    break;
-                case Proto::GameServerEnterGame:
-                    parseEnterGame(msg);
-                    break;
-                case Proto::GameServerPlayerHelpers:
-                    parsePlayerHelpers(msg);
-                    break;
-                    // PROTOCOL>=1000
-                case Proto::GameServerCreatureMarks:
-                    parseCreaturesMark(msg);
-                    break;
-                case Proto::GameServerCreatureType:
-                    parseCreatureType(msg);
-                    break;
-                    // PROTOCOL>=1055
-                case Proto::GameServerBlessings:
-                    parseBlessings(msg);
-                    break;
-                case Proto::GameServerUnjustifiedStats:
-                    parseUnjustifiedStats(msg);
-                    break;
-                case Proto::GameServerPvpSituations:
-                    parsePvpSituations(msg);
-                    break;
-                case Proto::GameServerPreset:
-                    parsePreset(msg);
-                    break;
-                    // PROTOCOL>=1080
-                case Proto::GameServerCoinBalanceUpdating:
-                    parseCoinBalanceUpdating(msg);
-                    break;
-                case Proto::GameServerCoinBalance:
-                    parseCoinBalance(msg);
-                    break;
-                case Proto::GameServerRequestPurchaseData:
-                    parseRequestPurchaseData(msg);
-                    break;
-                case Proto::GameServerResourceBalance: // 1281
-                    parseResourceBalance(msg);
-                    break;
-                case Proto::GameServerWorldTime:
-                    parseWorldTime(msg);
-                    break;
-                case Proto::GameServerStoreCompletePurchase:
-                    parseCompleteStorePurchase(msg);
-                    break;
-                case Proto::GameServerStoreOffers:
-                    parseStoreOffers(msg);
-                    break;
-                case Proto::GameServerStoreTransactionHistory:
-                    parseStoreTransactionHistory(msg);
-                    break;
-                case Proto::GameServerStoreError:
-                    parseStoreError(msg);
-                    break;
-                case Proto::GameServerStore:
-                    parseStore(msg);
-                    break;
-                    // PROTOCOL>=1097
-                case Proto::GameServerStoreButtonIndicators:
-                    parseStoreButtonIndicators(msg);
-                    break;
-                case Proto::GameServerSetStoreDeepLink:
-                    parseSetStoreDeepLink(msg);
-                    break;
-                    // otclient ONLY
-                case Proto::GameServerExtendedOpcode:
-                    parseExtendedOpcode(msg);
-                    break;
-                case Proto::GameServerChangeMapAwareRange:
-                    parseChangeMapAwareRange(msg);
-                    break;
-                    // 12x
-                case Proto::GameServerLootContainers:
-                    parseLootContainers(msg);
-                    break;
-                case Proto::GameServerSupplyStash:
-                    parseSupplyStash(msg);
-                    break;
-                case Proto::GameServerSpecialContainer:
-                    parseSpecialContainer(msg);
-                    break;
-                case Proto::GameServerPartyAnalyzer:
-                    parsePartyAnalyzer(msg);
-                    break;
-                case Proto::GameServerRefreshBestiaryTracker:
-                    parseBestiaryTracker(msg);
-                    break;
-                case Proto::GameServerTaskHuntingBasicData:
-                    parseTaskHuntingBasicData(msg);
-                    break;
-                case Proto::GameServerTaskHuntingData:
-                    parseTaskHuntingData(msg);
-                    break;
-                case Proto::GameServerSendShowDescription:
-                    parseShowDescription(msg);
-                    break;
-                case Proto::GameServerSendClientCheck:
-                    parseClientCheck(msg);
-                    break;
-                case Proto::GameServerSendGameNews:
-                    parseGameNews(msg);
-                    break;
-                case Proto::GameServerSendBlessDialog:
-                    parseBlessDialog(msg);
-                    break;
-                case Proto::GameServerSendRestingAreaState:
-                    parseRestingAreaState(msg);
-                    break;
-                case Proto::GameServerSendUpdateImpactTracker:
-                    parseUpdateImpactTracker(msg);
-                    break;
-                case Proto::GameServerSendItemsPrice:
-                    parseItemsPrice(msg);
-                    break;
-                case Proto::GameServerSendUpdateSupplyTracker:
-                    parseUpdateSupplyTracker(msg);
-                    break;
-                case Proto::GameServerSendUpdateLootTracker:
-                    parseUpdateLootTracker(msg);
-                    break;
-                case Proto::GameServerSendBestiaryEntryChanged:
-                    parseBestiaryEntryChanged(msg);
-                    break;
-                case Proto::GameServerSendDailyRewardCollectionState:
-                    parseDailyRewardCollectionState(msg);
-                    break;
-                case Proto::GameServerSendOpenRewardWall:
-                    parseOpenRewardWall(msg);
-                    break;
-                case Proto::GameServerSendDailyReward:
-                    parseDailyReward(msg);
-                    break;
-                case Proto::GameServerSendRewardHistory:
-                    parseRewardHistory(msg);
-                    break;
-                case Proto::GameServerSendPreyFreeRerolls:
-                    parsePreyFreeRerolls(msg);
-                    break;
-                case Proto::GameServerSendPreyTimeLeft:
-                    parsePreyTimeLeft(msg);
-                    break;
-                case Proto::GameServerSendPreyData:
-                    parsePreyData(msg);
-                    break;
-                case Proto::GameServerSendPreyRerollPrice:
-                    parsePreyRerollPrice(msg);
-                    break;
-                case Proto::GameServerSendImbuementWindow:
-                    parseImbuementWindow(msg);
-                    break;
-                case Proto::GameServerSendCloseImbuementWindow:
-                    parseCloseImbuementWindow(msg);
-                    break;
-                case Proto::GameServerSendError:
-                    parseError(msg);
-                    break;
-                case Proto::GameServerMarketEnter:
-                    if (g_game.getClientVersion() >= 1281)
-                        parseMarketEnter(msg);
-                    else
-                        parseMarketEnterOld(msg);
-                    break;
-                case Proto::GameServerMarketDetail:
-                    parseMarketDetail(msg);
-                    break;
-                case Proto::GameServerMarketBrowse:
-                    parseMarketBrowse(msg);
-                    break;
-                default:
-                    throw Exception("unhandled opcode %d", opcode);
-                    break;
-            }
+            const auto& handler = m_opcodeHandlers[opcode];
+            if (!handler)
+                throw Exception("unhandled opcode %d", opcode);
+
+            auto& stats = m_opcodeStats[opcode];
+            ++stats.calls;
+
+            if (m_opcodeProfiling) {
+                const ticks_t started = g_clock.rawMicros();
+                handler(*this, msg);
+                stats.elapsedMicros += g_clock.rawMicros() - started;
+            } else
+                handler(*this, msg);
+
             prevOpcode = opcode;
         }
     } catch (const stdext::exception& e) {
         g_logger.error(stdext::format("ProtocolGame parse message exception (%d bytes unread, last opcode is %d, prev opcode is %d): %s",
                        msg->getUnreadSize(), opcode, prevOpcode, e.what()));
     }
+
+    g_map.endTileUpdateBatch();
 }
 
 void ProtocolGame::parseLogin(const InputMessagePtr& msg) const
@@ -1022,8 +805,7 @@ void ProtocolGame::parseCreatureMove(const InputMessagePtr& msg)
         return;
     }
 
-    const auto& creature = thing->static_self_cast<Creature>();
-    creature->allowAppearWalk();
+    thing->static_self<Creature>()->allowAppearWalk();
 
     g_map.addThing(thing, newPos, -1);
 }
@@ -2587,7 +2369,12 @@ CreaturePtr ProtocolGame::getCreature(const InputMessagePtr& msg, int type) cons
                     case Proto::CreatureTypeMonster:
                     case Proto::CreatureTypeSummonOwn:
                     case Proto::CreatureTypeSummonOther:
-                        creature = std::make_shared<Monster>();
+                        // the same monsters cycle in and out of the aware
+                        // range at hunting-ground borders, reuse one that
+                        // recently left instead of allocating a fresh one
+                        creature = g_map.takeRemovedCreature(id, name);
+                        if (!creature)
+                            creature = std::make_shared<Monster>();
                         break;
 
                     default:
@@ -3563,22 +3350,24 @@ void ProtocolGame::parseMarketBrowse(const InputMessagePtr& msg)
 
     std::vector<MarketOffer> offers;
     const uint32_t buyOfferCount = msg->getU32();
+    offers.reserve(buyOfferCount);
     for (uint32_t i = 0; i < buyOfferCount; i++) {
         offers.push_back(readMarketOffer(msg, Otc::MARKETACTION_BUY, var));
     }
 
     const uint32_t sellOfferCount = msg->getU32();
+    offers.reserve(offers.size() + sellOfferCount);
     for (uint32_t i = 0; i < sellOfferCount; i++) {
         offers.push_back(readMarketOffer(msg, Otc::MARKETACTION_SELL, var));
     }
     std::vector<std::vector<uint64_t>> intOffers;
     std::vector<std::string> nameOffers;
+    intOffers.reserve(offers.size());
+    nameOffers.reserve(offers.size());
 
-    for (const auto& offer : offers) {
-        std::vector<uint64_t> intOffer = { offer.action, offer.amount, offer.counter, offer.itemId, offer.price, offer.state, offer.timestamp, offer.var };
-        std::string playerName = offer.playerName;
-        intOffers.push_back(intOffer);
-        nameOffers.push_back(playerName);
+    for (auto& offer : offers) {
+        intOffers.push_back({ offer.action, offer.amount, offer.counter, offer.itemId, offer.price, offer.state, offer.timestamp, offer.var });
+        nameOffers.push_back(std::move(offer.playerName));
     }
 
     g_lua.callGlobalField("g_game", "onMarketBrowse", intOffers, nameOffers);
@@ -38,7 +38,7 @@ void ProtocolGame::send(const OutputMessagePtr& outputMessage)
 void ProtocolGame::sendExtendedOpcode(uint8_t opcode, const std::string_view buffer)
 {
     if (m_enableSendExtendedOpcode) {
-        const auto& msg = std::make_shared<OutputMessage>();
+        const auto& msg = OutputMessage::create();
         msg->addU8(Proto::ClientExtendedOpcode);
         msg->addU8(opcode);
         msg->addString(buffer);
@@ -48,9 +48,9 @@ void ProtocolGame::sendExtendedOpcode(uint8_t opcode, const std::string_view buf
     }
 }
 
-void ProtocolGame::sendLoginPacket(uint32_t challengeTimestamp, uint8_t challengeRandom)
+OutputMessagePtr ProtocolGame::buildLoginPacket(uint32_t challengeTimestamp, uint8_t challengeRandom)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
 
     msg->addU8(Proto::ClientPendingGame);
     msg->addU16(g_game.getOs());
@@ -114,9 +114,27 @@ void ProtocolGame::sendLoginPacket(uint32_t challengeTimestamp, uint8_t challeng
     assert(paddingBytes >= 0);
     msg->addPaddingBytes(paddingBytes);
 
-    // encrypt with RSA
-    if (g_game.getFeature(Otc::GameLoginPacketEncryption))
-        msg->encryptRsa();
+    return msg;
+}
+
+void ProtocolGame::sendLoginPacket(uint32_t challengeTimestamp, uint8_t challengeRandom)
+{
+    OutputMessagePtr msg;
+
+    // when no server challenge is involved, login() already built the block
+    // and scheduled the RSA exponentiation on a worker, overlapping it with
+    // the DNS and TCP round trips; by the time the connection is up the
+    // future is usually ready
+    if (m_loginPacketFuture.valid()) {
+        msg = m_loginPacketFuture.get();
+        m_loginPacketFuture = {};
+    } else {
+        msg = buildLoginPacket(challengeTimestamp, challengeRandom);
+
+        // encrypt with RSA
+        if (g_game.getFeature(Otc::GameLoginPacketEncryption))
+            msg->encryptRsa();
+    }
 
     if (g_game.getFeature(Otc::GameProtocolChecksum))
         enableChecksum();
@@ -132,14 +150,14 @@ void ProtocolGame::sendLoginPacket(uint32_t challengeTimestamp, uint8_t challeng
 
 void ProtocolGame::sendEnterGame()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientEnterGame);
     send(msg);
 }
 
 void ProtocolGame::sendLogout()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientLeaveGame);
     send(msg);
 }
@@ -149,7 +167,7 @@ void ProtocolGame::sendPing()
     if (g_game.getFeature(Otc::GameExtendedClientPing))
         sendExtendedOpcode(2, "");
     else {
-        const auto& msg = std::make_shared<OutputMessage>();
+        const auto& msg = OutputMessage::create();
         msg->addU8(Proto::ClientPing);
         Protocol::send(msg);
     }
@@ -157,14 +175,14 @@ void ProtocolGame::sendPing()
 
 void ProtocolGame::sendPingBack()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientPingBack);
     send(msg);
 }
 
 void ProtocolGame::sendAutoWalk(const std::vector<Otc::Direction>& path)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientAutoWalk);
     msg->addU8(path.size());
     for (const Otc::Direction dir : path) {
@@ -205,98 +223,98 @@ void ProtocolGame::sendAutoWalk(const std::vector<Otc::Direction>& path)
 
 void ProtocolGame::sendWalkNorth()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkNorth);
     send(msg);
 }
 
 void ProtocolGame::sendWalkEast()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkEast);
     send(msg);
 }
 
 void ProtocolGame::sendWalkSouth()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkSouth);
     send(msg);
 }
 
 void ProtocolGame::sendWalkWest()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkWest);
     send(msg);
 }
 
 void ProtocolGame::sendStop()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientStop);
     send(msg);
 }
 
 void ProtocolGame::sendWalkNorthEast()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkNorthEast);
     send(msg);
 }
 
 void ProtocolGame::sendWalkSouthEast()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkSouthEast);
     send(msg);
 }
 
 void ProtocolGame::sendWalkSouthWest()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkSouthWest);
     send(msg);
 }
 
 void ProtocolGame::sendWalkNorthWest()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientWalkNorthWest);
     send(msg);
 }
 
 void ProtocolGame::sendTurnNorth()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientTurnNorth);
     send(msg);
 }
 
 void ProtocolGame::sendTurnEast()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientTurnEast);
     send(msg);
 }
 
 void ProtocolGame::sendTurnSouth()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientTurnSouth);
     send(msg);
 }
 
 void ProtocolGame::sendTurnWest()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientTurnWest);
     send(msg);
 }
 
 void ProtocolGame::sendEquipItem(int itemId, int countOrSubType)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientEquipItem);
     msg->addU16(itemId);
     msg->addU8(countOrSubType);
@@ -305,7 +323,7 @@ void ProtocolGame::sendEquipItem(int itemId, int countOrSubType)
 
 void ProtocolGame::sendMove(const Position& fromPos, int thingId, int stackpos, const Position& toPos, int count)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientMove);
     addPosition(msg, fromPos);
     msg->addU16(thingId);
@@ -317,7 +335,7 @@ void ProtocolGame::sendMove(const Position& fromPos, int thingId, int stackpos,
 
 void ProtocolGame::sendInspectNpcTrade(int itemId, int count)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientInspectNpcTrade);
     msg->addU16(itemId);
     msg->addU8(count);
@@ -326,7 +344,7 @@ void ProtocolGame::sendInspectNpcTrade(int itemId, int count)
 
 void ProtocolGame::sendBuyItem(int itemId, int subType, int amount, bool ignoreCapacity, bool buyWithBackpack)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientBuyItem);
     msg->addU16(itemId);
     msg->addU8(subType);
@@ -341,7 +359,7 @@ void ProtocolGame::sendBuyItem(int itemId, int subType, int amount, bool ignoreC
 
 void ProtocolGame::sendSellItem(int itemId, int subType, int amount, bool ignoreEquipped)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientSellItem);
     msg->addU16(itemId);
     msg->addU8(subType);
@@ -355,14 +373,14 @@ void ProtocolGame::sendSellItem(int itemId, int subType, int amount, bool ignore
 
 void ProtocolGame::sendCloseNpcTrade()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientCloseNpcTrade);
     send(msg);
 }
 
 void ProtocolGame::sendRequestTrade(const Position& pos, int thingId, int stackpos, uint32_t creatureId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestTrade);
     addPosition(msg, pos);
     msg->addU16(thingId);
@@ -373,7 +391,7 @@ void ProtocolGame::sendRequestTrade(const Position& pos, int thingId, int stackp
 
 void ProtocolGame::sendInspectTrade(bool counterOffer, int index)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientInspectTrade);
     msg->addU8(counterOffer ? 0x01 : 0x00);
     msg->addU8(index);
@@ -382,21 +400,21 @@ void ProtocolGame::sendInspectTrade(bool counterOffer, int index)
 
 void ProtocolGame::sendAcceptTrade()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientAcceptTrade);
     send(msg);
 }
 
 void ProtocolGame::sendRejectTrade()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRejectTrade);
     send(msg);
 }
 
 void ProtocolGame::sendUseItem(const Position& position, int itemId, int stackpos, int index)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientUseItem);
     addPosition(msg, position);
     msg->addU16(itemId);
@@ -407,7 +425,7 @@ void ProtocolGame::sendUseItem(const Position& position, int itemId, int stackpo
 
 void ProtocolGame::sendUseItemWith(const Position& fromPos, int itemId, int fromStackPos, const Position& toPos, int toThingId, int toStackPos)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientUseItemWith);
     addPosition(msg, fromPos);
     msg->addU16(itemId);
@@ -420,7 +438,7 @@ void ProtocolGame::sendUseItemWith(const Position& fromPos, int itemId, int from
 
 void ProtocolGame::sendUseOnCreature(const Position& pos, int thingId, int stackpos, uint32_t creatureId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientUseOnCreature);
     addPosition(msg, pos);
     msg->addU16(thingId);
@@ -431,7 +449,7 @@ void ProtocolGame::sendUseOnCreature(const Position& pos, int thingId, int stack
 
 void ProtocolGame::sendRotateItem(const Position& pos, int thingId, int stackpos)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRotateItem);
     addPosition(msg, pos);
     msg->addU16(thingId);
@@ -441,7 +459,7 @@ void ProtocolGame::sendRotateItem(const Position& pos, int thingId, int stackpos
 
 void ProtocolGame::sendOnWrapItem(const Position& pos, int thingId, int stackpos)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientOnWrapItem);
     addPosition(msg, pos);
     msg->addU16(thingId);
@@ -451,7 +469,7 @@ void ProtocolGame::sendOnWrapItem(const Position& pos, int thingId, int stackpos
 
 void ProtocolGame::sendCloseContainer(int containerId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientCloseContainer);
     msg->addU8(containerId);
     send(msg);
@@ -459,7 +477,7 @@ void ProtocolGame::sendCloseContainer(int containerId)
 
 void ProtocolGame::sendUpContainer(int containerId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientUpContainer);
     msg->addU8(containerId);
     send(msg);
@@ -467,7 +485,7 @@ void ProtocolGame::sendUpContainer(int containerId)
 
 void ProtocolGame::sendEditText(uint32_t id, const std::string_view text)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientEditText);
     msg->addU32(id);
     msg->addString(text);
@@ -476,7 +494,7 @@ void ProtocolGame::sendEditText(uint32_t id, const std::string_view text)
 
 void ProtocolGame::sendEditList(uint32_t id, int doorId, const std::string_view text)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientEditList);
     msg->addU8(doorId);
     msg->addU32(id);
@@ -486,7 +504,7 @@ void ProtocolGame::sendEditList(uint32_t id, int doorId, const std::string_view
 
 void ProtocolGame::sendLook(const Position& position, int thingId, int stackpos)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientLook);
     addPosition(msg, position);
     msg->addU16(thingId);
@@ -496,7 +514,7 @@ void ProtocolGame::sendLook(const Position& position, int thingId, int stackpos)
 
 void ProtocolGame::sendLookCreature(uint32_t creatureId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientLookCreature);
     msg->addU32(creatureId);
     send(msg);
@@ -512,7 +530,7 @@ void ProtocolGame::sendTalk(Otc::MessageMode mode, int channelId, const std::str
         return;
     }
 
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientTalk);
     msg->addU8(Proto::translateMessageModeToServer(mode));
 
@@ -538,14 +556,14 @@ void ProtocolGame::sendTalk(Otc::MessageMode mode, int channelId, const std::str
 
 void ProtocolGame::sendRequestChannels()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestChannels);
     send(msg);
 }
 
 void ProtocolGame::sendJoinChannel(int channelId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientJoinChannel);
     msg->addU16(channelId);
     send(msg);
@@ -553,7 +571,7 @@ void ProtocolGame::sendJoinChannel(int channelId)
 
 void ProtocolGame::sendLeaveChannel(int channelId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientLeaveChannel);
     msg->addU16(channelId);
     send(msg);
@@ -561,7 +579,7 @@ void ProtocolGame::sendLeaveChannel(int channelId)
 
 void ProtocolGame::sendOpenPrivateChannel(const std::string_view receiver)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientOpenPrivateChannel);
     msg->addString(receiver);
     send(msg);
@@ -569,7 +587,7 @@ void ProtocolGame::sendOpenPrivateChannel(const std::string_view receiver)
 
 void ProtocolGame::sendOpenRuleViolation(const std::string_view reporter)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientOpenRuleViolation);
     msg->addString(reporter);
     send(msg);
@@ -577,7 +595,7 @@ void ProtocolGame::sendOpenRuleViolation(const std::string_view reporter)
 
 void ProtocolGame::sendCloseRuleViolation(const std::string_view reporter)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientCloseRuleViolation);
     msg->addString(reporter);
     send(msg);
@@ -585,21 +603,21 @@ void ProtocolGame::sendCloseRuleViolation(const std::string_view reporter)
 
 void ProtocolGame::sendCancelRuleViolation()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientCancelRuleViolation);
     send(msg);
 }
 
 void ProtocolGame::sendCloseNpcChannel()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientCloseNpcChannel);
     send(msg);
 }
 
 void ProtocolGame::sendChangeFightModes(Otc::FightModes fightMode, Otc::ChaseModes chaseMode, bool safeFight, Otc::PVPModes pvpMode)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientChangeFightModes);
     msg->addU8(fightMode);
     msg->addU8(chaseMode);
@@ -611,7 +629,7 @@ void ProtocolGame::sendChangeFightModes(Otc::FightModes fightMode, Otc::ChaseMod
 
 void ProtocolGame::sendAttack(uint32_t creatureId, uint32_t seq)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientAttack);
     msg->addU32(creatureId);
     if (g_game.getFeature(Otc::GameAttackSeq))
@@ -621,7 +639,7 @@ void ProtocolGame::sendAttack(uint32_t creatureId, uint32_t seq)
 
 void ProtocolGame::sendFollow(uint32_t creatureId, uint32_t seq)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientFollow);
     msg->addU32(creatureId);
     if (g_game.getFeature(Otc::GameAttackSeq))
@@ -631,7 +649,7 @@ void ProtocolGame::sendFollow(uint32_t creatureId, uint32_t seq)
 
 void ProtocolGame::sendInviteToParty(uint32_t creatureId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientInviteToParty);
     msg->addU32(creatureId);
     send(msg);
@@ -639,7 +657,7 @@ void ProtocolGame::sendInviteToParty(uint32_t creatureId)
 
 void ProtocolGame::sendJoinParty(uint32_t creatureId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientJoinParty);
     msg->addU32(creatureId);
     send(msg);
@@ -647,7 +665,7 @@ void ProtocolGame::sendJoinParty(uint32_t creatureId)
 
 void ProtocolGame::sendRevokeInvitation(uint32_t creatureId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRevokeInvitation);
     msg->addU32(creatureId);
     send(msg);
@@ -655,7 +673,7 @@ void ProtocolGame::sendRevokeInvitation(uint32_t creatureId)
 
 void ProtocolGame::sendPassLeadership(uint32_t creatureId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientPassLeadership);
     msg->addU32(creatureId);
     send(msg);
@@ -663,14 +681,14 @@ void ProtocolGame::sendPassLeadership(uint32_t creatureId)
 
 void ProtocolGame::sendLeaveParty()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientLeaveParty);
     send(msg);
 }
 
 void ProtocolGame::sendShareExperience(bool active)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientShareExperience);
     msg->addU8(active ? 0x01 : 0x00);
     if (g_game.getClientVersion() < 910)
@@ -680,14 +698,14 @@ void ProtocolGame::sendShareExperience(bool active)
 
 void ProtocolGame::sendOpenOwnChannel()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientOpenOwnChannel);
     send(msg);
 }
 
 void ProtocolGame::sendInviteToOwnChannel(const std::string_view name)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientInviteToOwnChannel);
     msg->addString(name);
     send(msg);
@@ -695,7 +713,7 @@ void ProtocolGame::sendInviteToOwnChannel(const std::string_view name)
 
 void ProtocolGame::sendExcludeFromOwnChannel(const std::string_view name)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientExcludeFromOwnChannel);
     msg->addString(name);
     send(msg);
@@ -703,14 +721,14 @@ void ProtocolGame::sendExcludeFromOwnChannel(const std::string_view name)
 
 void ProtocolGame::sendCancelAttackAndFollow()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientCancelAttackAndFollow);
     send(msg);
 }
 
 void ProtocolGame::sendRefreshContainer(int containerId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRefreshContainer);
     msg->addU8(containerId);
     send(msg);
@@ -718,14 +736,14 @@ void ProtocolGame::sendRefreshContainer(int containerId)
 
 void ProtocolGame::sendRequestOutfit()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestOutfit);
     send(msg);
 }
 
 void ProtocolGame::sendChangeOutfit(const Outfit& outfit)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientChangeOutfit);
 
     if (g_game.getClientVersion() >= 1281) {
@@ -766,7 +784,7 @@ void ProtocolGame::sendChangeOutfit(const Outfit& outfit)
 void ProtocolGame::sendMountStatus(bool mount)
 {
     if (g_game.getFeature(Otc::GamePlayerMounts)) {
-        const auto& msg = std::make_shared<OutputMessage>();
+        const auto& msg = OutputMessage::create();
         msg->addU8(Proto::ClientMount);
         msg->addU8(mount);
         send(msg);
@@ -777,7 +795,7 @@ void ProtocolGame::sendMountStatus(bool mount)
 
 void ProtocolGame::sendAddVip(const std::string_view name)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientAddVip);
     msg->addString(name);
     send(msg);
@@ -785,7 +803,7 @@ void ProtocolGame::sendAddVip(const std::string_view name)
 
 void ProtocolGame::sendRemoveVip(uint32_t playerId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRemoveVip);
     msg->addU32(playerId);
     send(msg);
@@ -793,7 +811,7 @@ void ProtocolGame::sendRemoveVip(uint32_t playerId)
 
 void ProtocolGame::sendEditVip(uint32_t playerId, const std::string_view description, int iconId, bool notifyLogin)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientEditVip);
     msg->addU32(playerId);
     msg->addString(description);
@@ -804,7 +822,7 @@ void ProtocolGame::sendEditVip(uint32_t playerId, const std::string_view descrip
 
 void ProtocolGame::sendBugReport(const std::string_view comment)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientBugReport);
     if (g_game.getProtocolVersion() > 1000) {
         msg->addU8(3); // category
@@ -815,7 +833,7 @@ void ProtocolGame::sendBugReport(const std::string_view comment)
 
 void ProtocolGame::sendRuleViolation(const std::string_view target, int reason, int action, const std::string_view comment, const std::string_view statement, int statementId, bool ipBanishment)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRuleViolation);
     msg->addString(target);
     msg->addU8(reason);
@@ -829,7 +847,7 @@ void ProtocolGame::sendRuleViolation(const std::string_view target, int reason,
 
 void ProtocolGame::sendDebugReport(const std::string_view a, const std::string_view b, const std::string_view c, const std::string_view d)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientDebugReport);
     msg->addString(a);
     msg->addString(b);
@@ -840,14 +858,14 @@ void ProtocolGame::sendDebugReport(const std::string_view a, const std::string_v
 
 void ProtocolGame::sendRequestQuestLog()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestQuestLog);
     send(msg);
 }
 
 void ProtocolGame::sendRequestQuestLine(int questId)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestQuestLine);
     msg->addU16(questId);
     send(msg);
@@ -855,7 +873,7 @@ void ProtocolGame::sendRequestQuestLine(int questId)
 
 void ProtocolGame::sendNewNewRuleViolation(int reason, int action, const std::string_view characterName, const std::string_view comment, const std::string_view translation)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientNewRuleViolation);
     msg->addU8(reason);
     msg->addU8(action);
@@ -867,7 +885,7 @@ void ProtocolGame::sendNewNewRuleViolation(int reason, int action, const std::st
 
 void ProtocolGame::sendRequestItemInfo(int itemId, int subType, int index)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestItemInfo);
     msg->addU8(subType);
     msg->addU16(itemId);
@@ -877,7 +895,7 @@ void ProtocolGame::sendRequestItemInfo(int itemId, int subType, int index)
 
 void ProtocolGame::sendAnswerModalDialog(uint32_t dialog, int button, int choice)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientAnswerModalDialog);
     msg->addU32(dialog);
     msg->addU8(button);
@@ -890,7 +908,7 @@ void ProtocolGame::sendBrowseField(const Position& position)
     if (!g_game.getFeature(Otc::GameBrowseField))
         return;
 
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientBrowseField);
     addPosition(msg, position);
     send(msg);
@@ -901,7 +919,7 @@ void ProtocolGame::sendSeekInContainer(int cid, int index)
     if (!g_game.getFeature(Otc::GameContainerPagination))
         return;
 
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientSeekInContainer);
     msg->addU8(cid);
     msg->addU16(index);
@@ -910,7 +928,7 @@ void ProtocolGame::sendSeekInContainer(int cid, int index)
 
 void ProtocolGame::sendBuyStoreOffer(int offerId, int productType, const std::string_view name)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientBuyStoreOffer);
     msg->addU32(offerId);
     msg->addU8(productType);
@@ -923,7 +941,7 @@ void ProtocolGame::sendBuyStoreOffer(int offerId, int productType, const std::st
 
 void ProtocolGame::sendRequestTransactionHistory(int page, int entriesPerPage)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestTransactionHistory);
     if (g_game.getClientVersion() <= 1096) {
         msg->addU16(page);
@@ -938,7 +956,7 @@ void ProtocolGame::sendRequestTransactionHistory(int page, int entriesPerPage)
 
 void ProtocolGame::sendRequestStoreOffers(const std::string_view categoryName, int serviceType)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientRequestStoreOffers);
 
     if (g_game.getFeature(Otc::GameIngameStoreServiceType)) {
@@ -951,7 +969,7 @@ void ProtocolGame::sendRequestStoreOffers(const std::string_view categoryName, i
 
 void ProtocolGame::sendOpenStore(int serviceType, const std::string_view category)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientOpenStore);
 
     if (g_game.getFeature(Otc::GameIngameStoreServiceType)) {
@@ -964,7 +982,7 @@ void ProtocolGame::sendOpenStore(int serviceType, const std::string_view categor
 
 void ProtocolGame::sendTransferCoins(const std::string_view recipient, int amount)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientTransferCoins);
     msg->addString(recipient);
     msg->addU16(amount);
@@ -973,7 +991,7 @@ void ProtocolGame::sendTransferCoins(const std::string_view recipient, int amoun
 
 void ProtocolGame::sendOpenTransactionHistory(int entriesPerPage)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientOpenTransactionHistory);
     msg->addU8(entriesPerPage);
 
@@ -985,7 +1003,7 @@ void ProtocolGame::sendChangeMapAwareRange(int xrange, int yrange)
     if (!g_game.getFeature(Otc::GameChangeMapAwareRange))
         return;
 
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientChangeMapAwareRange);
     msg->addU8(xrange);
     msg->addU8(yrange);
@@ -1001,14 +1019,14 @@ void ProtocolGame::addPosition(const OutputMessagePtr& msg, const Position& posi
 
 void ProtocolGame::sendMarketLeave()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientMarketLeave);
     send(msg);
 }
 
 void ProtocolGame::sendMarketBrowse(uint8_t browseId, uint16_t browseType)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientMarketBrowse);
     if (g_game.getClientVersion() >= 1251) {
         msg->addU8(browseId);
@@ -1023,7 +1041,7 @@ void ProtocolGame::sendMarketBrowse(uint8_t browseId, uint16_t browseType)
 
 void ProtocolGame::sendMarketCreateOffer(uint8_t type, uint16_t itemId, uint8_t itemTier, uint16_t amount, uint64_t price, uint8_t anonymous)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientMarketCreate);
     msg->addU8(type);
     msg->addU16(itemId);
@@ -1040,7 +1058,7 @@ void ProtocolGame::sendMarketCreateOffer(uint8_t type, uint16_t itemId, uint8_t
 
 void ProtocolGame::sendMarketCancelOffer(uint32_t timestamp, uint16_t counter)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientMarketCancel);
     msg->addU32(timestamp);
     msg->addU16(counter);
@@ -1049,7 +1067,7 @@ void ProtocolGame::sendMarketCancelOffer(uint32_t timestamp, uint16_t counter)
 
 void ProtocolGame::sendMarketAcceptOffer(uint32_t timestamp, uint16_t counter, uint16_t amount)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientMarketAccept);
     msg->addU32(timestamp);
     msg->addU16(counter);
@@ -1059,7 +1077,7 @@ void ProtocolGame::sendMarketAcceptOffer(uint32_t timestamp, uint16_t counter, u
 
 void ProtocolGame::sendPreyAction(uint8_t slot, uint8_t actionType, uint16_t index)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientPreyAction);
     msg->addU8(slot);
     msg->addU8(actionType);
@@ -1073,14 +1091,14 @@ void ProtocolGame::sendPreyAction(uint8_t slot, uint8_t actionType, uint16_t ind
 
 void ProtocolGame::sendPreyRequest()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientPreyRequest);
     send(msg);
 }
 
 void ProtocolGame::sendApplyImbuement(uint8_t slot, uint32_t imbuementId, bool protectionCharm)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientApplyImbuement);
     msg->addU8(slot);
     msg->addU32(imbuementId);
@@ -1090,7 +1108,7 @@ void ProtocolGame::sendApplyImbuement(uint8_t slot, uint32_t imbuementId, bool p
 
 void ProtocolGame::sendClearImbuement(uint8_t slot)
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientClearImbuement);
     msg->addU8(slot);
     send(msg);
@@ -1098,7 +1116,7 @@ void ProtocolGame::sendClearImbuement(uint8_t slot)
 
 void ProtocolGame::sendCloseImbuingWindow()
 {
-    const auto& msg = std::make_shared<OutputMessage>();
+    const auto& msg = OutputMessage::create();
     msg->addU8(Proto::ClientCloseImbuingWindow);
     send(msg);
 }
@@ -39,6 +39,7 @@ public:
         MAP_WALKOFFSET = 15,
         MAP_CENTER_COORD = 16,
         MAP_GLOBAL_COORD = 17,
+        LIGHT_UV_SCALE = 18,
     };
 
     void init();
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sharedspritecache.h"
+
+#include "framework/stdext/time.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif !defined(ANDROID)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint32_t CACHE_MAGIC = 0x43535430; // "0TSC"
+    constexpr uint32_t CACHE_VERSION = 1;
+
+    // low nibble of a slot state; the published flags sit in the high nibble
+    enum SlotState : uint8_t
+    {
+        SLOT_EMPTY = 0,
+        SLOT_WRITING = 1,
+        SLOT_READY = 2
+    };
+}
+
+struct SharedSpriteCache::Header
+{
+    std::atomic<uint32_t> magic; // written last, attachers validate against it
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    uint64_t contentHash;
+    uint8_t padding[40]; // keep the slot state array cache-line aligned
+};
+
+std::atomic<uint8_t>* SharedSpriteCache::slotStates() const
+{
+    return reinterpret_cast<std::atomic<uint8_t>*>(m_base + sizeof(Header));
+}
+
+bool SharedSpriteCache::open(const uint64_t contentHash, const uint32_t slotCount, const uint32_t slotSize)
+{
+    close();
+
+#ifdef ANDROID
+    // no named shared memory on android, and nobody multiboxes there
+    return false;
+#else
+    static_assert(sizeof(Header) == 64);
+
+    if (slotCount == 0 || slotSize == 0)
+        return false;
+
+    // short name: macOS limits shm names to 31 characters
+    m_name = stdext::format("/otc-%016llx", static_cast<unsigned long long>(contentHash));
+    m_slotCount = slotCount;
+    m_slotSize = slotSize;
+    m_dataOffset = sizeof(Header) + ((static_cast<size_t>(slotCount) + 63) & ~static_cast<size_t>(63));
+    m_totalSize = m_dataOffset + static_cast<size_t>(slotCount) * slotSize;
+
+    bool creator = false;
+
+#ifdef WIN32
+    m_handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(m_totalSize >> 32), static_cast<DWORD>(m_totalSize),
+                                  ("Local\\otc" + m_name.substr(1)).c_str());
+    if (!m_handle)
+        return false;
+
+    creator = GetLastError() != ERROR_ALREADY_EXISTS;
+    m_base = static_cast<uint8_t*>(MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, m_totalSize));
+    if (!m_base) {
+        close();
+        return false;
+    }
+#else
+    int fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        creator = true;
+        if (ftruncate(fd, m_totalSize) != 0) {
+            ::close(fd);
+            shm_unlink(m_name.c_str());
+            return false;
+        }
+    } else {
+        fd = shm_open(m_name.c_str(), O_RDWR, 0600);
+        if (fd < 0)
+            return false;
+
+        // the creator may still be between shm_open and ftruncate; mapping
+        // a not-yet-sized segment would fault on first access
+        struct stat st {};
+        for (int i = 0; i < 100 && (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(m_totalSize)); ++i)
+            stdext::millisleep(1);
+
+        if (st.st_size < static_cast<off_t>(m_totalSize)) {
+            ::close(fd);
+            return false;
+        }
+    }
+
+    m_fd = fd;
+    m_base = static_cast<uint8_t*>(mmap(nullptr, m_totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    if (m_base == MAP_FAILED) {
+        m_base = nullptr;
+        close();
+        return false;
+    }
+#endif
+
+    auto* hdr = header();
+    if (creator) {
+        // fresh pages start zeroed; publish the magic last so attachers
+        // only ever validate a fully initialized header
+        hdr->version = CACHE_VERSION;
+        hdr->slotCount = slotCount;
+        hdr->slotSize = slotSize;
+        hdr->contentHash = contentHash;
+        hdr->magic.store(CACHE_MAGIC, std::memory_order_release);
+    } else {
+        // give a racing creator a moment to finish the header
+        for (int i = 0; i < 100 && hdr->magic.load(std::memory_order_acquire) != CACHE_MAGIC; ++i)
+            stdext::millisleep(1);
+
+        if (hdr->magic.load(std::memory_order_acquire) != CACHE_MAGIC || hdr->version != CACHE_VERSION ||
+            hdr->slotCount != slotCount || hdr->slotSize != slotSize || hdr->contentHash != contentHash) {
+            g_logger.warning(stdext::format("shared sprite cache '%s' has mismatched content, decoding privately", m_name));
+            close();
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+void SharedSpriteCache::close()
+{
+#ifndef ANDROID
+    if (m_base) {
+#ifdef WIN32
+        UnmapViewOfFile(m_base);
+#else
+        munmap(m_base, m_totalSize);
+#endif
+        m_base = nullptr;
+    }
+
+#ifdef WIN32
+    if (m_handle) {
+        CloseHandle(m_handle);
+        m_handle = nullptr;
+    }
+#else
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    // the segment is deliberately not unlinked: other clients keep using
+    // it and a restarted client attaches to a warm cache; the name changes
+    // with the content hash, so stale versions simply stop being opened
+#endif
+#endif
+
+    m_totalSize = 0;
+    m_dataOffset = 0;
+    m_slotCount = 0;
+    m_slotSize = 0;
+}
+
+const uint8_t* SharedSpriteCache::get(const uint32_t slot, uint8_t* flags) const
+{
+    if (!m_base || slot >= m_slotCount)
+        return nullptr;
+
+    const uint8_t state = slotStates()[slot].load(std::memory_order_acquire);
+    if ((state & 0x0f) != SLOT_READY)
+        return nullptr;
+
+    if (flags)
+        *flags = state >> 4;
+
+    return slotData(slot);
+}
+
+const uint8_t* SharedSpriteCache::put(const uint32_t slot, const uint8_t* pixels, const uint8_t flags)
+{
+    if (!m_base || slot >= m_slotCount)
+        return nullptr;
+
+    auto& state = slotStates()[slot];
+
+    uint8_t expected = SLOT_EMPTY;
+    if (!state.compare_exchange_strong(expected, SLOT_WRITING, std::memory_order_acq_rel)) {
+        // lost the election; hand the finished slot back if it is published
+        return (expected & 0x0f) == SLOT_READY ? slotData(slot) : nullptr;
+    }
+
+    uint8_t* data = slotData(slot);
+    std::memcpy(data, pixels, m_slotSize);
+    state.store(SLOT_READY | flags << 4, std::memory_order_release);
+
+    return data;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/global.h>
+
+// cross-process cache of decoded sprite pixels for multiboxed clients: a
+// named shared-memory segment keyed by the sprite content hash, where each
+// slot has exactly one writer (elected by compare-and-swap) and every
+// client reads published slots in place, so N processes decode each sprite
+// once and keep one copy of the pixel data between them
+class SharedSpriteCache
+{
+public:
+    enum : uint8_t
+    {
+        FLAG_TRANSPARENT = 0x01
+    };
+
+    ~SharedSpriteCache() { close(); }
+
+    bool open(uint64_t contentHash, uint32_t slotCount, uint32_t slotSize);
+    void close();
+    bool isOpen() const { return m_base != nullptr; }
+
+    // pointer into the shared segment if the slot is published, else nullptr
+    const uint8_t* get(uint32_t slot, uint8_t* flags = nullptr) const;
+
+    // copies slotSize bytes into the slot if this process wins the write
+    // election; returns the published shared pixels, or nullptr while
+    // another process is still writing them
+    const uint8_t* put(uint32_t slot, const uint8_t* pixels, uint8_t flags = 0);
+
+private:
+    struct Header;
+
+    Header* header() const { return reinterpret_cast<Header*>(m_base); }
+    std::atomic<uint8_t>* slotStates() const;
+    uint8_t* slotData(uint32_t slot) const { return m_base + m_dataOffset + static_cast<size_t>(slot) * m_slotSize; }
+
+    std::string m_name;
+    uint8_t* m_base{ nullptr };
+    size_t m_totalSize{ 0 };
+    size_t m_dataOffset{ 0 };
+    uint32_t m_slotCount{ 0 };
+    uint32_t m_slotSize{ 0 };
+
+#ifdef WIN32
+    void* m_handle{ nullptr };
+#else
+    int m_fd{ -1 };
+#endif
+};
@@ -50,13 +50,37 @@ void SpriteAppearances::terminate()
     unload();
 }
 
-bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
+void SpriteAppearances::initSharedCache()
 {
-    if (sheet->data)
+    // the key must be deterministic across processes reading the same
+    // catalog, so hash what the catalog declares rather than load order
+    size_t hash = stdext::hash_int(g_game.getClientVersion());
+    for (const auto& sheet : m_sheets) {
+        stdext::hash_union(hash, stdext::hash_int(sheet->firstId));
+        stdext::hash_union(hash, stdext::hash_int(sheet->lastId));
+    }
+
+    m_sharedCache.open(hash, m_sheets.size(), BYTES_IN_SPRITE_SHEET);
+}
+
+bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet)
+{
+    if (sheet->isLoaded())
         return true;
 
     std::scoped_lock lock(sheet->m_mutex);
 
+    // another thread may have decoded it while we waited for the lock
+    if (sheet->isLoaded())
+        return true;
+
+    // another client process may have decoded it; borrow the shared pixels
+    if (const auto* shared = m_sharedCache.get(sheet->index)) {
+        sheet->data = SpriteSheet::DataPtr(const_cast<uint8_t*>(shared), [](uint8_t*) {});
+        sheet->m_loaded.store(true, std::memory_order_release);
+        return true;
+    }
+
     try {
         const auto& fin = g_resources.openFile(stdext::format("/things/%d/%s", g_game.getClientVersion(), sheet->file));
         fin->cache();
@@ -106,7 +130,7 @@ bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
             throw stdext::exception(stdext::format("failed to initialize lzma raw decoder result: %d", ret));
         }
 
-        stream.next_in = &fin->m_data.data()[fin->tell()];
+        stream.next_in = &fin->readBuffer()[fin->tell()];
         stream.next_out = decompressed.get();
         stream.avail_in = fin->size();
         stream.avail_out = LZMA_UNCOMPRESSED_SIZE;
@@ -147,8 +171,15 @@ bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
             }
         }
 
-        sheet->data = std::make_unique<uint8_t[]>(LZMA_UNCOMPRESSED_SIZE);
-        std::memcpy(sheet->data.get(), bufferStart, BYTES_IN_SPRITE_SHEET);
+        // publish into the shared cache so every process, this one
+        // included, keeps a single copy of the decoded sheet
+        if (const auto* shared = m_sharedCache.put(sheet->index, bufferStart)) {
+            sheet->data = SpriteSheet::DataPtr(const_cast<uint8_t*>(shared), [](uint8_t*) {});
+        } else {
+            sheet->data = SpriteSheet::DataPtr(new uint8_t[BYTES_IN_SPRITE_SHEET], [](uint8_t* p) { delete[] p; });
+            std::memcpy(sheet->data.get(), bufferStart, BYTES_IN_SPRITE_SHEET);
+        }
+        sheet->m_loaded.store(true, std::memory_order_release);
 
         return true;
     } catch (const std::exception& e) {
@@ -160,7 +191,8 @@ bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
 void SpriteAppearances::unload()
 {
     m_spritesCount = 0;
-    m_sheets.clear();
+    m_sheets.clear(); // sheets borrowing shared pixels go before the unmap
+    m_sharedCache.close();
 }
 
 SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(int id, bool load /* = true */)
@@ -179,12 +211,35 @@ SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(int id, bool load /* = true
 
     const auto& sheet = *sheetIt;
 
-    if (load)
+    if (load && !sheet->isLoaded()) {
         loadSpriteSheet(sheet);
 
+        // teleports touch many consecutive sheets, warm the neighbours early
+        prefetchNeighbourSheets(sheetIt - m_sheets.begin());
+    }
+
     return sheet;
 }
 
+void SpriteAppearances::prefetchNeighbourSheets(size_t index)
+{
+    static constexpr size_t PREFETCH_NEIGHBOUR_SHEETS = 2;
+
+    const size_t first = index > PREFETCH_NEIGHBOUR_SHEETS ? index - PREFETCH_NEIGHBOUR_SHEETS : 0;
+    const size_t last = std::min<size_t>(index + PREFETCH_NEIGHBOUR_SHEETS, m_sheets.size() - 1);
+
+    for (size_t i = first; i <= last; ++i) {
+        const auto& sheet = m_sheets[i];
+        if (i == index || sheet->isLoaded() || sheet->m_queued.exchange(true))
+            continue;
+
+        g_asyncDispatcher.dispatch([this, sheet] {
+            loadSpriteSheet(sheet);
+            sheet->m_queued.store(false, std::memory_order_relaxed);
+        }, AsyncDispatcher::Priority::LOW);
+    }
+}
+
 ImagePtr SpriteAppearances::getSpriteImage(int id)
 {
     try {
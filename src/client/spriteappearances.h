@@ -25,6 +25,7 @@
 #include <framework/core/declarations.h>
 #include <framework/graphics/declarations.h>
 #include <framework/luaengine/luaobject.h>
+#include "sharedspritecache.h"
 
 enum class SpriteLayout
 {
@@ -54,13 +55,24 @@ public:
         return size;
     }
 
+    bool isLoaded() const { return m_loaded.load(std::memory_order_acquire); }
+
+    // pixel data either owned by this sheet or borrowed from the shared
+    // sprite cache, distinguished only by the deleter
+    using DataPtr = std::unique_ptr<uint8_t[], void(*)(uint8_t*)>;
+
     int firstId = 0;
     int lastId = 0;
+    uint32_t index = 0; // position in the sheet list, the shared cache slot
 
     SpriteLayout spriteLayout = SpriteLayout::ONE_BY_ONE;
     std::mutex m_mutex;
-    std::unique_ptr<uint8_t[]> data;
+    DataPtr data{ nullptr, [](uint8_t* p) { delete[] p; } };
     std::string file;
+
+    // published once data is fully decoded, so readers need no lock
+    std::atomic_bool m_loaded{ false };
+    std::atomic_bool m_queued{ false };
 };
 
 //@bindsingleton g_spriteAppearances
@@ -75,19 +87,28 @@ public:
     void setSpritesCount(int count) { m_spritesCount = count; }
     int getSpritesCount() const { return m_spritesCount; }
 
-    bool loadSpriteSheet(const SpriteSheetPtr& sheet) const;
+    // opens the cross-process decoded-sheet cache, called once the sheet
+    // catalog is fully registered
+    void initSharedCache();
+
+    bool loadSpriteSheet(const SpriteSheetPtr& sheet);
     void saveSheetToFileBySprite(int id, const std::string& file);
     void saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file);
     SpriteSheetPtr getSheetBySpriteId(int id, bool load = true);
 
-    void addSpriteSheet(const SpriteSheetPtr& sheet) { m_sheets.emplace_back(sheet); }
+    void addSpriteSheet(const SpriteSheetPtr& sheet) { sheet->index = m_sheets.size(); m_sheets.emplace_back(sheet); }
 
     ImagePtr getSpriteImage(int id);
     void saveSpriteToFile(int id, const std::string& file);
 
 private:
+    void prefetchNeighbourSheets(size_t index);
+
     uint32_t m_spritesCount{ 0 };
     std::vector<SpriteSheetPtr> m_sheets;
+
+    // decoded sheets shared with other client processes on the same catalog
+    SharedSpriteCache m_sharedCache;
 };
 
 extern SpriteAppearances g_spriteAppearances;
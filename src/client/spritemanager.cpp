@@ -68,6 +68,12 @@ bool SpriteManager::loadSpr(std::string file)
         m_spritesCount = g_game.getFeature(Otc::GameSpritesU32) ? m_spritesFile->getU32() : m_spritesFile->getU16();
         m_spritesOffset = m_spritesFile->tell();
         m_loaded = true;
+
+        // multiboxed clients running the same spr share one decoded segment
+        size_t cacheHash = stdext::hash_int(m_signature);
+        stdext::hash_union(cacheHash, stdext::hash_int(m_spritesCount));
+        m_sharedCache.open(cacheHash, m_spritesCount + 1, SPRITE_DATA_SIZE);
+
         g_lua.callGlobalField("g_sprites", "onLoadSpr", file);
         return true;
     } catch (const stdext::exception& e) {
@@ -137,6 +143,11 @@ void SpriteManager::unload()
     m_spritesCount = 0;
     m_signature = 0;
     m_spritesFile = nullptr;
+    m_sharedCache.close();
+
+    std::scoped_lock l(m_cacheMutex);
+    m_spriteCacheList.clear();
+    m_spriteCacheMap.clear();
 }
 
 ImagePtr SpriteManager::getSpriteImage(int id)
@@ -145,11 +156,69 @@ ImagePtr SpriteManager::getSpriteImage(int id)
         return g_spriteAppearances.getSpriteImage(id);
     }
 
+    if (const auto& cached = getCachedSpriteImage(id))
+        return cached;
+
+    // another client process may have decoded this sprite already
+    uint8_t sharedFlags = 0;
+    if (const auto* sharedPixels = m_sharedCache.get(id, &sharedFlags)) {
+        const auto& image = std::make_shared<Image>(Size(SPRITE_SIZE), 4, const_cast<uint8_t*>(sharedPixels));
+        if (sharedFlags & SharedSpriteCache::FLAG_TRANSPARENT)
+            image->setTransparentPixel(true);
+        cacheSpriteImage(id, image);
+        return image;
+    }
+
+    ImagePtr image;
     if (g_app.isLoadingAsyncTexture())
-        return getSpriteImage(id, g_resources.openFile(m_lastFileName));
+        image = getSpriteImage(id, g_resources.openFile(m_lastFileName));
+    else {
+        std::scoped_lock l(m_mutex);
+        image = getSpriteImage(id, m_spritesFile);
+    }
+
+    if (image) {
+        m_sharedCache.put(id, image->getPixelData(), image->hasTransparentPixel() ? SharedSpriteCache::FLAG_TRANSPARENT : 0);
+        cacheSpriteImage(id, image);
+    }
 
-    std::scoped_lock l(m_mutex);
-    return getSpriteImage(id, m_spritesFile);
+    return image;
+}
+
+ImagePtr SpriteManager::getCachedSpriteImage(int id)
+{
+    std::scoped_lock l(m_cacheMutex);
+
+    const auto it = m_spriteCacheMap.find(id);
+    if (it == m_spriteCacheMap.end())
+        return nullptr;
+
+    m_spriteCacheList.splice(m_spriteCacheList.begin(), m_spriteCacheList, it->second);
+
+    // callers mutate sprite images (color masks), hand out a private copy
+    const auto& cached = it->second->second;
+    const auto& copy = std::make_shared<Image>(cached->getSize(), cached->getBpp(), cached->getPixelData());
+    copy->setTransparentPixel(cached->hasTransparentPixel());
+    return copy;
+}
+
+void SpriteManager::cacheSpriteImage(int id, const ImagePtr& image)
+{
+    const auto& copy = std::make_shared<Image>(image->getSize(), image->getBpp(), image->getPixelData());
+    copy->setTransparentPixel(image->hasTransparentPixel());
+
+    std::scoped_lock l(m_cacheMutex);
+
+    if (m_spriteCacheMap.contains(id))
+        return;
+
+    m_spriteCacheList.emplace_front(id, copy);
+    m_spriteCacheMap[id] = m_spriteCacheList.begin();
+
+    while (m_spriteCacheList.size() > SPRITE_CACHE_SIZE) {
+        m_spriteCacheMap.erase(m_spriteCacheList.back().first);
+        m_spriteCacheList.pop_back();
+    }
 }
 
 ImagePtr SpriteManager::getSpriteImage(int id, const FileStreamPtr& file) {
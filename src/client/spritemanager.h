@@ -24,6 +24,7 @@
 
 #include <framework/core/declarations.h>
 #include <framework/graphics/declarations.h>
+#include "sharedspritecache.h"
 
  //@bindsingleton g_sprites
 class SpriteManager
@@ -48,10 +49,15 @@ public:
 
 private:
     ImagePtr getSpriteImage(int id, const FileStreamPtr& file);
+    ImagePtr getCachedSpriteImage(int id);
+    void cacheSpriteImage(int id, const ImagePtr& image);
 
     enum
     {
-        SPRITE_DATA_SIZE = SPRITE_SIZE * SPRITE_SIZE * 4
+        SPRITE_DATA_SIZE = SPRITE_SIZE * SPRITE_SIZE * 4,
+
+        // ~16MB of decoded 32x32 sprites kept around to skip RLE decompression
+        SPRITE_CACHE_SIZE = 4096
     };
 
     std::string m_lastFileName;
@@ -63,6 +69,14 @@ private:
 
     FileStreamPtr m_spritesFile;
     std::mutex m_mutex;
+
+    // decoded sprites shared with other client processes running the same spr
+    SharedSpriteCache m_sharedCache;
+
+    // LRU cache of decoded sprites, most recently used at the front
+    std::list<std::pair<int, ImagePtr>> m_spriteCacheList;
+    stdext::map<int, std::list<std::pair<int, ImagePtr>>::iterator> m_spriteCacheMap;
+    std::mutex m_cacheMutex;
 };
 
 extern SpriteManager g_sprites;
@@ -24,6 +24,7 @@
 #include "game.h"
 #include "lightview.h"
 #include "map.h"
+#include "outfit.h"
 #include "spriteappearances.h"
 #include "spritemanager.h"
 
@@ -34,6 +35,7 @@
 #include <framework/graphics/drawpoolmanager.h>
 #include <framework/graphics/image.h>
 #include <framework/graphics/texture.h>
+#include <framework/graphics/texturemanager.h>
 #include <framework/otml/otml.h>
 
 const static TexturePtr m_textureNull;
@@ -350,6 +352,118 @@ void ThingType::unserializeAppearance(uint16_t clientId, ThingCategory category,
     prepareTextureLoad(sizes, total_sprites);
 }
 
+void ThingType::serializeCache(const FileStreamPtr& fin)
+{
+    fin->addU64(m_flags);
+
+    fin->addU8(m_size.width());
+    fin->addU8(m_size.height());
+    fin->addU16(m_displacement.x);
+    fin->addU16(m_displacement.y);
+
+    fin->addU8(m_light.intensity);
+    fin->addU8(m_light.color);
+
+    fin->addU8(m_elevation);
+    fin->addU8(m_minimapColor);
+    fin->addU8(m_clothSlot);
+    fin->addU8(m_lensHelp);
+    fin->addU8(m_defaultAction);
+
+    fin->addU16(m_groundSpeed);
+    fin->addU16(m_maxTextLength);
+    fin->addU16(m_upgradeClassification);
+
+    if (m_flags & ThingFlagAttrMarket) {
+        fin->addString(m_market.name);
+        fin->addU8(m_market.category);
+        fin->addU16(m_market.requiredLevel);
+        fin->addU16(m_market.restrictVocation);
+        fin->addU16(m_market.showAs);
+        fin->addU16(m_market.tradeAs);
+    }
+
+    fin->addU8(m_animationPhases);
+    fin->addU8(m_numPatternX);
+    fin->addU8(m_numPatternY);
+    fin->addU8(m_numPatternZ);
+    fin->addU8(m_layers);
+    fin->add8(m_opaque);
+
+    fin->addU8((m_animator ? 1 : 0) | (m_idleAnimator ? 2 : 0));
+    if (m_animator) {
+        fin->addU16(m_animator->getAnimationPhases());
+        m_animator->serialize(fin);
+    }
+    if (m_idleAnimator) {
+        fin->addU16(m_idleAnimator->getAnimationPhases());
+        m_idleAnimator->serialize(fin);
+    }
+
+    fin->addU16(m_spritesIndex.size());
+    for (const uint32_t spriteId : m_spritesIndex)
+        fin->addU32(spriteId);
+}
+
+void ThingType::unserializeCache(uint16_t clientId, ThingCategory category, const FileStreamPtr& fin)
+{
+    m_null = false;
+    m_id = clientId;
+    m_category = category;
+
+    m_flags = fin->getU64();
+
+    m_size.setWidth(fin->getU8());
+    m_size.setHeight(fin->getU8());
+    m_displacement.x = fin->getU16();
+    m_displacement.y = fin->getU16();
+
+    m_light.intensity = fin->getU8();
+    m_light.color = fin->getU8();
+
+    m_elevation = fin->getU8();
+    m_minimapColor = fin->getU8();
+    m_clothSlot = fin->getU8();
+    m_lensHelp = fin->getU8();
+    m_defaultAction = static_cast<PLAYER_ACTION>(fin->getU8());
+
+    m_groundSpeed = fin->getU16();
+    m_maxTextLength = fin->getU16();
+    m_upgradeClassification = fin->getU16();
+
+    if (m_flags & ThingFlagAttrMarket) {
+        m_market.name = fin->getString();
+        m_market.category = static_cast<ITEM_CATEGORY>(fin->getU8());
+        m_market.requiredLevel = fin->getU16();
+        m_market.restrictVocation = fin->getU16();
+        m_market.showAs = fin->getU16();
+        m_market.tradeAs = fin->getU16();
+    }
+
+    m_animationPhases = fin->getU8();
+    m_numPatternX = fin->getU8();
+    m_numPatternY = fin->getU8();
+    m_numPatternZ = fin->getU8();
+    m_layers = fin->getU8();
+    m_opaque = fin->get8();
+
+    const uint8_t animators = fin->getU8();
+    if (animators & 1) {
+        m_animator = new Animator;
+        m_animator->unserialize(fin->getU16(), fin);
+    }
+    if (animators & 2) {
+        m_idleAnimator = new Animator;
+        m_idleAnimator->unserialize(fin->getU16(), fin);
+    }
+
+    m_spritesIndex.resize(fin->getU16());
+    for (auto& spriteId : m_spritesIndex)
+        spriteId = fin->getU32();
+
+    m_textureData.resize(m_animationPhases);
+}
+
 void ThingType::unserialize(uint16_t clientId, ThingCategory category, const FileStreamPtr& fin)
 {
     m_null = false;
@@ -599,7 +713,7 @@ void ThingType::unserializeOtml(const OTMLNodePtr& node)
     }
 }
 
-void ThingType::draw(const Point& dest, int layer, int xPattern, int yPattern, int zPattern, int animationPhase, uint32_t flags, const Color& color, LightView* lightView, const DrawConductor& conductor)
+void ThingType::draw(const Point& dest, int layer, int xPattern, int yPattern, int zPattern, int animationPhase, uint32_t flags, const Color& color, LightView* lightView, const DrawConductor& conductor, const TexturePtr& textureOverride)
 {
     if (m_null)
         return;
@@ -607,7 +721,7 @@ void ThingType::draw(const Point& dest, int layer, int xPattern, int yPattern, i
     if (animationPhase >= m_animationPhases)
         return;
 
-    const auto& texture = getTexture(animationPhase); // texture might not exists, neither its rects.
+    const auto& texture = textureOverride ? textureOverride : getTexture(animationPhase); // texture might not exists, neither its rects.
     if (!texture)
         return;
 
@@ -617,10 +731,10 @@ void ThingType::draw(const Point& dest, int layer, int xPattern, int yPattern, i
     if (frameIndex >= textureData.pos.size())
         return;
 
-    const auto& textureOffset = textureData.pos[frameIndex].offsets;
+    const auto& textureOffset = textureData.pos[frameIndex].drawOffsets;
     const auto& textureRect = textureData.pos[frameIndex].rects;
 
-    const Rect screenRect(dest + (textureOffset - m_displacement - (m_size.toPoint() - Point(1)) * SPRITE_SIZE) * g_drawPool.getScaleFactor(), textureRect.size() * g_drawPool.getScaleFactor());
+    const Rect screenRect(dest + textureOffset * g_drawPool.getScaleFactor(), textureRect.size() * g_drawPool.getScaleFactor());
 
     if (flags & Otc::DrawThings) {
         const auto& newColor = m_opacity < 1.0f ? Color(color, m_opacity) : color;
@@ -761,6 +875,8 @@ void ThingType::loadTexture(int animationPhase)
 
                     posData.originRects = Rect(framePos, Size(m_size.width(), m_size.height()) * SPRITE_SIZE);
                     posData.offsets = posData.rects.topLeft() - framePos;
+                    // fold the per-draw placement arithmetic into the table
+                    posData.drawOffsets = posData.offsets - m_displacement - (m_size.toPoint() - Point(1)) * SPRITE_SIZE;
                 }
             }
         }
@@ -772,7 +888,13 @@ void ThingType::loadTexture(int animationPhase)
     if (m_opaque == -1)
         m_opaque = !fullImage->hasTransparentPixel();
 
-    textureData.source = std::make_shared<Texture>(fullImage, true, false);
+    // keep the sheet image of multi-layer creatures around, colorized outfit
+    // composition reads the mask layers from it
+    if (m_category == ThingCategoryCreature && m_layers > 1)
+        textureData.image = fullImage;
+
+    // sprite sheets share atlas pages so the map pool can batch draws across things
+    textureData.source = g_textures.getAtlasTexture(fullImage);
 }
 
 Size ThingType::getBestTextureDimension(int w, int h, int count)
@@ -836,6 +958,104 @@ uint32_t ThingType::getTextureIndex(int l, int x, int y, int z) const
         * m_numPatternX + x;
 }
 
+TexturePtr ThingType::getColorizedTexture(const int animationPhase, const Outfit& outfit)
+{
+    // the base texture (and its sheet image) must exist first; while it is
+    // still loading asynchronously the caller falls back to the mask passes
+    if (!getTexture(animationPhase))
+        return nullptr;
+
+    const auto& textureData = m_textureData[animationPhase];
+    if (!textureData.image)
+        return nullptr;
+
+    const uint32_t colorKey = outfit.getHead() << 24 | outfit.getBody() << 16 | outfit.getLegs() << 8 | outfit.getFeet();
+
+    auto it = m_colorizedTextures.find(colorKey);
+    if (it == m_colorizedTextures.end()) {
+        // bound the cache, dropping the least recently used color combination
+        static constexpr size_t MAX_COLORIZED_OUTFITS = 64;
+        if (m_colorizedTextures.size() >= MAX_COLORIZED_OUTFITS) {
+            auto oldest = m_colorizedTextures.begin();
+            for (auto cit = m_colorizedTextures.begin(); cit != m_colorizedTextures.end(); ++cit) {
+                if (cit->second.lastUsage.ticksElapsed() > oldest->second.lastUsage.ticksElapsed())
+                    oldest = cit;
+            }
+            m_colorizedTextures.erase(oldest);
+        }
+
+        it = m_colorizedTextures.emplace(colorKey, ColorizedTexture{}).first;
+        it->second.sources.resize(m_animationPhases);
+    }
+
+    auto& entry = it->second;
+    entry.lastUsage.restart();
+
+    auto& source = entry.sources[animationPhase];
+    if (source)
+        return source;
+
+    // copy the sheet and multiply every mask layer into the base frame it
+    // belongs to; the flat byte loop below vectorizes well
+    const auto& composedImage = std::make_shared<Image>(textureData.image->getSize());
+    composedImage->getPixels() = textureData.image->getPixels();
+    composedImage->setTransparentPixel(textureData.image->hasTransparentPixel());
+
+    // layer order matches the multiply passes: red=body, green=legs, blue=feet, yellow=head
+    const Color partColors[] = { outfit.getBodyColor(), outfit.getLegsColor(), outfit.getFeetColor(), outfit.getHeadColor() };
+
+    const int frameWidth = m_size.width() * SPRITE_SIZE;
+    const int frameHeight = m_size.height() * SPRITE_SIZE;
+    const int sheetWidth = composedImage->getWidth();
+    const int framesPerRow = sheetWidth / frameWidth;
+
+    uint8_t* pixels = composedImage->getPixelData();
+    const uint8_t* maskPixels = textureData.image->getPixelData();
+
+    for (int z = 0; z < m_numPatternZ; ++z) {
+        for (int y = 0; y < m_numPatternY; ++y) {
+            for (int x = 0; x < m_numPatternX; ++x) {
+                const uint32_t baseIndex = getTextureIndex(0, x, y, z);
+                const Point basePos(baseIndex % framesPerRow * frameWidth, baseIndex / framesPerRow * frameHeight);
+
+                for (int l = SpriteMaskRed; l <= SpriteMaskYellow; ++l) {
+                    const uint32_t maskIndex = getTextureIndex(l, x, y, z);
+                    const Point maskPos(maskIndex % framesPerRow * frameWidth, maskIndex / framesPerRow * frameHeight);
+
+                    const Color& partColor = partColors[l - SpriteMaskRed];
+                    const uint16_t r = partColor.r(), g = partColor.g(), b = partColor.b();
+
+                    for (int fy = 0; fy < frameHeight; ++fy) {
+                        uint8_t* row = pixels + (static_cast<size_t>(basePos.y + fy) * sheetWidth + basePos.x) * 4;
+                        const uint8_t* maskRow = maskPixels + (static_cast<size_t>(maskPos.y + fy) * sheetWidth + maskPos.x) * 4;
+                        for (int fx = 0; fx < frameWidth; ++fx) {
+                            if (maskRow[fx * 4 + 3] == 0)
+                                continue;
+
+                            row[fx * 4 + 0] = row[fx * 4 + 0] * r / 255;
+                            row[fx * 4 + 1] = row[fx * 4 + 1] * g / 255;
+                            row[fx * 4 + 2] = row[fx * 4 + 2] * b / 255;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    source = g_textures.getAtlasTexture(composedImage);
+    return source;
+}
+
+int ThingType::getAsyncAnimationPhase()
+{
+    const ticks_t tick = g_clock.millis();
+    if (tick != m_lastAsyncPhaseTick) {
+        m_lastAsyncPhaseTick = tick;
+        m_asyncPhase = (tick % (ITEM_TICKS_PER_FRAME * getAnimationPhases())) / ITEM_TICKS_PER_FRAME;
+    }
+    return m_asyncPhase;
+}
+
 int ThingType::getExactSize(int layer, int xPattern, int yPattern, int zPattern, int animationPhase)
 {
     if (m_null)
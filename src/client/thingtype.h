@@ -262,19 +262,24 @@ struct Light
     uint8_t color = 215;
 };
 
+class Outfit;
+
 class ThingType : public LuaObject
 {
 public:
     void unserializeAppearance(uint16_t clientId, ThingCategory category, const appearances::Appearance& appearance);
+    void unserializeCache(uint16_t clientId, ThingCategory category, const FileStreamPtr& fin);
     void unserialize(uint16_t clientId, ThingCategory category, const FileStreamPtr& fin);
     void unserializeOtml(const OTMLNodePtr& node);
 
+    void serializeCache(const FileStreamPtr& fin);
+
 #ifdef FRAMEWORK_EDITOR
     void serialize(const FileStreamPtr& fin);
     void exportImage(const std::string& fileName);
 #endif
 
-    void draw(const Point& dest, int layer, int xPattern, int yPattern, int zPattern, int animationPhase, uint32_t flags, const Color& color, LightView* lightView = nullptr, const DrawConductor& conductor = DEFAULT_DRAW_CONDUCTOR);
+    void draw(const Point& dest, int layer, int xPattern, int yPattern, int zPattern, int animationPhase, uint32_t flags, const Color& color, LightView* lightView = nullptr, const DrawConductor& conductor = DEFAULT_DRAW_CONDUCTOR, const TexturePtr& textureOverride = nullptr);
 
     uint16_t getId() { return m_id; }
     ThingCategory getCategory() { return m_category; }
@@ -290,6 +295,7 @@ public:
     int getNumPatternY() { return m_numPatternY; }
     int getNumPatternZ() { return m_numPatternZ; }
     int getAnimationPhases() { return m_animator ? m_animator->getAnimationPhases() : m_animationPhases; }
+    int getAsyncAnimationPhase();
     Animator* getAnimator() const { return m_animator; }
     Animator* getIdleAnimator() const { return m_idleAnimator; }
 
@@ -374,6 +380,7 @@ public:
     void unload() {
         m_textureData.clear();
         m_textureData.resize(m_animationPhases);
+        m_colorizedTextures.clear();
     }
 
     PLAYER_ACTION getDefaultAction() { return m_defaultAction; }
@@ -387,6 +394,10 @@ public:
     int getExactHeight();
     TexturePtr getTexture(int animationPhase);
 
+    // texture with the outfit mask layers already blended into the base
+    // frames, so a colored outfit costs one draw instead of five
+    TexturePtr getColorizedTexture(int animationPhase, const Outfit& outfit);
+
 private:
     static ThingFlagAttr thingAttrToThingFlagAttr(ThingAttr attr);
     static Size getBestTextureDimension(int w, int h, int count);
@@ -400,10 +411,22 @@ private:
             Rect rects;
             Rect originRects;
             Point offsets;
+            // offsets with displacement and size correction folded in, so
+            // draw() only scales and translates when placing the frame
+            Point drawOffsets;
         };
 
         TexturePtr source;
         std::vector<Pos> pos;
+        // sheet image kept for multi-layer creatures so colorized outfit
+        // textures can be composed without decoding the sprites again
+        ImagePtr image;
+    };
+
+    struct ColorizedTexture
+    {
+        std::vector<TexturePtr> sources; // one per animation phase
+        Timer lastUsage;
     };
 
     void prepareTextureLoad(const std::vector<Size>& sizes, const std::vector<int>& total_sprites);
@@ -424,6 +447,15 @@ private:
 
     uint8_t m_animationPhases{ 0 };
     uint8_t m_realSize{ 0 };
+
+    // clock-driven phase shared by every async item of this type, refreshed
+    // at most once per millisecond instead of once per item draw
+    ticks_t m_lastAsyncPhaseTick{ -1 };
+    int m_asyncPhase{ 0 };
+
+    // composed outfit textures keyed by the outfit part colors
+    stdext::map<uint32_t, ColorizedTexture> m_colorizedTextures;
+
     uint8_t m_numPatternX{ 0 };
     uint8_t m_numPatternY{ 0 };
     uint8_t m_numPatternZ{ 0 };
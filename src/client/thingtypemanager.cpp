@@ -31,8 +31,10 @@
 #include <framework/xml/tinyxml.h>
 #endif
 
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/binarytree.h>
+#include <framework/graphics/texturemanager.h>
 #include <framework/core/filestream.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/otml/otml.h>
@@ -42,6 +44,7 @@
 
 #include "protobuf/appearances.pb.h"
 
+#include <google/protobuf/arena.h>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
@@ -49,6 +52,10 @@ using namespace otclient::protobuf;
 
 ThingTypeManager g_things;
 
+// bump whenever the serializeCache() layout changes
+static constexpr uint32_t APPEARANCES_CACHE_SIGNATURE = 0x43485431; // 'THC1'
+static constexpr uint16_t APPEARANCES_CACHE_VERSION = 1;
+
 void ThingTypeManager::init()
 {
     m_nullThingType = std::make_shared<ThingType>();
@@ -72,10 +79,14 @@ void ThingTypeManager::init()
 
             const auto& category = m_thingTypes[m_gc.category];
 
+            // under VRAM pressure drop sprite textures much sooner, they are
+            // recomposed from the sprite sheets on demand
+            const uint16_t idleTime = g_textures.isOverBudget() ? IDLE_TIME / 6 : IDLE_TIME;
+
             const size_t limit = std::min<size_t>(m_gc.index + AMOUNT_PER_CHECK, category.size());
             while (m_gc.index < limit) {
                 auto& thing = category[m_gc.index];
-                if (thing->hasTexture() && thing->getLastTimeUsage().ticksElapsed() > IDLE_TIME) {
+                if (thing->hasTexture() && thing->getLastTimeUsage().ticksElapsed() > idleTime) {
                     thing->unload();
                 }
                 ++m_gc.index;
@@ -94,6 +105,7 @@ void ThingTypeManager::terminate()
     for (auto& m_thingType : m_thingTypes)
         m_thingType.clear();
 
+    m_attrIndex.clear();
     m_nullThingType = nullptr;
 
     if (m_gc.event) {
@@ -104,6 +116,9 @@ void ThingTypeManager::terminate()
 #ifdef FRAMEWORK_EDITOR
     m_itemTypes.clear();
     m_reverseItemTypes.clear();
+    m_itemNameIndex.clear();
+    m_itemNameList.clear();
+    m_itemNameIndexDirty = true;
     m_nullItemType = nullptr;
 #endif
 }
@@ -113,6 +128,7 @@ bool ThingTypeManager::loadDat(std::string file)
     m_datLoaded = false;
     m_datSignature = 0;
     m_contentRevision = 0;
+    m_attrIndex.clear();
     try {
         file = g_resources.guessFilePath(file, "dat");
 
@@ -179,6 +195,7 @@ bool ThingTypeManager::loadOtml(std::string file)
                 type->unserializeOtml(node2);
             }
         }
+        m_attrIndex.clear(); // patched types may have gained or lost attrs
         return true;
     } catch (const std::exception& e) {
         g_logger.error(stdext::format("Failed to read dat otml '%s': %s'", file, e.what()));
@@ -188,6 +205,7 @@ bool ThingTypeManager::loadOtml(std::string file)
 
 bool ThingTypeManager::loadAppearances(const std::string& file)
 {
+    m_attrIndex.clear();
     try {
         int spritesCount = 0;
         std::string appearancesFile;
@@ -206,15 +224,54 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
 
         g_spriteAppearances.setSpritesCount(spritesCount + 1);
 
+        // the shared sprite cache only depends on the catalog, so it opens
+        // on a worker while the appearances file is read and checksummed;
+        // workers must not throw, errors come back as a message
+        const auto sharedCacheFuture = g_asyncDispatcher.schedule([]() -> std::string {
+            try {
+                g_spriteAppearances.initSharedCache();
+                return {};
+            } catch (const std::exception& e) {
+                return e.what();
+            }
+        });
+
         // load appearances.dat
         std::stringstream fin;
         g_resources.readFileStream(g_resources.resolvePath(stdext::format("/things/%d/%s", g_game.getClientVersion(), appearancesFile)), fin);
 
-        auto appearancesLib = appearances::Appearances();
-        if (!appearancesLib.ParseFromIstream(&fin)) {
+        // a checksum over the raw file is much cheaper than the protobuf decode,
+        // so a valid cache skips the decode and the ThingType rebuild entirely
+        const auto& appearancesBuffer = fin.str();
+        const uint32_t checksum = stdext::adler32(reinterpret_cast<const uint8_t*>(appearancesBuffer.data()), appearancesBuffer.size());
+        const auto& cacheFile = stdext::format("/appearances%d.cache", g_game.getClientVersion());
+
+        const bool cacheLoaded = loadAppearancesCache(cacheFile, checksum);
+
+        if (const auto& error = sharedCacheFuture.get(); !error.empty())
+            throw stdext::exception(error);
+
+        if (cacheLoaded) {
+            m_datLoaded = true;
+            return true;
+        }
+
+        // millions of small sub-messages come out of the decode; an arena
+        // sized from the file turns them into bump allocations and frees
+        // them all at once when parsing falls out of scope
+        google::protobuf::ArenaOptions arenaOptions;
+        arenaOptions.start_block_size = appearancesBuffer.size();
+        google::protobuf::Arena arena(arenaOptions);
+
+        auto* appearancesLibPtr = google::protobuf::Arena::CreateMessage<appearances::Appearances>(&arena);
+        if (!appearancesLibPtr->ParseFromIstream(&fin)) {
             throw stdext::exception("Couldn't parse appearances lib.");
         }
+        const auto& appearancesLib = *appearancesLibPtr;
 
+        // each category writes its own vector and only reads the immutable
+        // catalog sheets, so the four ThingType rebuilds run in parallel
+        std::vector<std::shared_future<std::string>> categoryFutures;
         for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
             const google::protobuf::RepeatedPtrField<appearances::Appearance>* appearances = nullptr;
 
@@ -232,13 +289,33 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
             things.clear();
             things.resize(lastAppearance.id() + 1, m_nullThingType);
 
-            for (const auto& appearance : *appearances) {
-                const auto& type = std::make_shared<ThingType>();
-                const uint16_t id = appearance.id();
-                type->unserializeAppearance(id, static_cast<ThingCategory>(category), appearance);
-                m_thingTypes[category][id] = type;
-            }
+            categoryFutures.emplace_back(g_asyncDispatcher.schedule([this, category, appearances]() -> std::string {
+                try {
+                    for (const auto& appearance : *appearances) {
+                        const auto& type = std::make_shared<ThingType>();
+                        const uint16_t id = appearance.id();
+                        type->unserializeAppearance(id, static_cast<ThingCategory>(category), appearance);
+                        m_thingTypes[category][id] = type;
+                    }
+                    return {};
+                } catch (const std::exception& e) {
+                    return e.what();
+                }
+            }));
         }
+
+        // every rebuild must finish before any error can be rethrown, the
+        // workers reference messages owned by the arena scoped to this call
+        std::string firstError;
+        for (const auto& future : categoryFutures) {
+            if (const auto& error = future.get(); !error.empty() && firstError.empty())
+                firstError = error;
+        }
+        if (!firstError.empty())
+            throw stdext::exception(firstError);
+
+        saveAppearancesCache(cacheFile, checksum);
+
         m_datLoaded = true;
         return true;
     } catch (const std::exception& e) {
@@ -247,6 +324,92 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
     }
 }
 
+bool ThingTypeManager::loadAppearancesCache(const std::string& file, uint32_t checksum)
+{
+    try {
+        if (!g_resources.fileExists(file))
+            return false;
+
+        const auto& fin = g_resources.openFile(file);
+        fin->cache();
+
+        if (fin->getU32() != APPEARANCES_CACHE_SIGNATURE || fin->getU16() != APPEARANCES_CACHE_VERSION)
+            return false;
+
+        // a stale cache (appearances file replaced) is simply rebuilt
+        if (fin->getU32() != checksum)
+            return false;
+
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            // the checksum above only ties the cache to its source file, the
+            // body itself may still be truncated by a crash mid-save, so
+            // every file-supplied index is validated before use
+            const uint32_t size = fin->getU32();
+            const uint32_t count = fin->getU32();
+            if (size > UINT16_MAX + 1 || count > size)
+                throw Exception("corrupt thing count in category %d", category);
+
+            auto& things = m_thingTypes[category];
+            things.clear();
+            things.resize(size, m_nullThingType);
+
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint16_t id = fin->getU16();
+                if (id >= size)
+                    throw Exception("corrupt thing id %d in category %d", id, category);
+
+                const auto& type = std::make_shared<ThingType>();
+                type->unserializeCache(id, static_cast<ThingCategory>(category), fin);
+                things[id] = type;
+            }
+        }
+
+        return true;
+    } catch (const std::exception& e) {
+        g_logger.warning(stdext::format("Discarding appearances cache '%s': %s", file, e.what()));
+        return false;
+    }
+}
+
+void ThingTypeManager::saveAppearancesCache(const std::string& file, uint32_t checksum)
+{
+    try {
+        // written buffered and renamed into place, a crash mid-save must not
+        // leave a partial cache behind
+        const auto& fin = g_resources.createBufferedFile(file);
+        if (!fin)
+            throw Exception("failed to open file '%s' for write", file);
+
+        fin->addU32(APPEARANCES_CACHE_SIGNATURE);
+        fin->addU16(APPEARANCES_CACHE_VERSION);
+        fin->addU32(checksum);
+
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            const auto& things = m_thingTypes[category];
+            fin->addU32(things.size());
+
+            uint32_t count = 0;
+            for (const auto& type : things) {
+                if (!type->isNull())
+                    ++count;
+            }
+            fin->addU32(count);
+
+            for (const auto& type : things) {
+                if (type->isNull())
+                    continue;
+                fin->addU16(type->getId());
+                type->serializeCache(fin);
+            }
+        }
+
+        fin->flush();
+        fin->close();
+    } catch (const std::exception& e) {
+        g_logger.warning(stdext::format("Failed to save appearances cache '%s': %s", file, e.what()));
+    }
+}
+
 const ThingTypeList& ThingTypeManager::getThingTypes(ThingCategory category)
 {
     if (category < ThingLastCategory)
@@ -266,11 +429,16 @@ const ThingTypePtr& ThingTypeManager::getThingType(uint16_t id, ThingCategory ca
 
 ThingTypeList ThingTypeManager::findThingTypeByAttr(ThingAttr attr, ThingCategory category)
 {
+    const uint16_t key = (category << 8) | attr;
+    if (const auto it = m_attrIndex.find(key); it != m_attrIndex.end())
+        return it->second;
+
     ThingTypeList ret;
     for (const auto& type : m_thingTypes[category])
         if (type->hasAttr(attr))
             ret.emplace_back(type);
-    return ret;
+
+    return m_attrIndex.emplace(key, std::move(ret)).first->second;
 }
 
 #ifdef FRAMEWORK_EDITOR
@@ -335,6 +503,21 @@ void ThingTypeManager::addItemType(const ItemTypePtr& itemType)
     if (unlikely(id >= m_itemTypes.size()))
         m_itemTypes.resize(id + 1, m_nullItemType);
     m_itemTypes[id] = itemType;
+    m_itemNameIndexDirty = true;
+}
+
+void ThingTypeManager::rebuildItemNameIndex()
+{
+    m_itemNameIndex.clear();
+    m_itemNameList.clear();
+    m_itemNameList.reserve(m_itemTypes.size());
+    for (const auto& it : m_itemTypes) {
+        if (it == m_nullItemType || it->getName().empty())
+            continue;
+        m_itemNameIndex[it->getName()].emplace_back(it);
+        m_itemNameList.emplace_back(it->getName(), it);
+    }
+    m_itemNameIndexDirty = false;
 }
 
 const ItemTypePtr& ThingTypeManager::findItemTypeByClientId(uint16_t id)
@@ -349,27 +532,32 @@ const ItemTypePtr& ThingTypeManager::findItemTypeByClientId(uint16_t id)
 
 const ItemTypePtr& ThingTypeManager::findItemTypeByName(const std::string& name)
 {
-    for (const ItemTypePtr& it : m_itemTypes)
-        if (it->getName() == name)
-            return it;
-    return m_nullItemType;
+    if (m_itemNameIndexDirty)
+        rebuildItemNameIndex();
+
+    const auto it = m_itemNameIndex.find(name);
+    return it != m_itemNameIndex.end() ? it->second.front() : m_nullItemType;
 }
 
 ItemTypeList ThingTypeManager::findItemTypesByName(const std::string& name)
 {
-    ItemTypeList ret;
-    for (const ItemTypePtr& it : m_itemTypes)
-        if (it->getName() == name)
-            ret.emplace_back(it);
-    return ret;
+    if (m_itemNameIndexDirty)
+        rebuildItemNameIndex();
+
+    const auto it = m_itemNameIndex.find(name);
+    return it != m_itemNameIndex.end() ? it->second : ItemTypeList{};
 }
 
 ItemTypeList ThingTypeManager::findItemTypesByString(const std::string& name)
 {
+    if (m_itemNameIndexDirty)
+        rebuildItemNameIndex();
+
+    // substring search walks the flat name list, not every item type
     ItemTypeList ret;
-    for (const ItemTypePtr& it : m_itemTypes)
-        if (it->getName().find(name) != std::string::npos)
-            ret.emplace_back(it);
+    for (const auto& [itemName, itemType] : m_itemNameList)
+        if (itemName.find(name) != std::string::npos)
+            ret.emplace_back(itemType);
     return ret;
 }
 
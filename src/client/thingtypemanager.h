@@ -77,6 +77,13 @@ public:
     bool isValidDatId(uint16_t id, ThingCategory category) const { return id >= 1 && id < m_thingTypes[category].size(); }
 
 private:
+    bool loadAppearancesCache(const std::string& file, uint32_t checksum);
+    void saveAppearancesCache(const std::string& file, uint32_t checksum);
+
+#ifdef FRAMEWORK_EDITOR
+    void rebuildItemNameIndex();
+#endif
+
     struct GarbageCollection
     {
         uint8_t category{ ThingLastCategory };
@@ -95,10 +102,20 @@ private:
 
     GarbageCollection m_gc;
 
+    // attr lookups resolved once per (category, attr) and cached until the
+    // dat/appearances are reloaded
+    stdext::map<uint16_t, ThingTypeList> m_attrIndex;
+
 #ifdef FRAMEWORK_EDITOR
     ItemTypePtr m_nullItemType;
     ItemTypeList m_reverseItemTypes;
     ItemTypeList m_itemTypes;
+
+    // name lookups go through lazy secondary indexes instead of scanning
+    // every item type; rebuilt on the first query after addItemType
+    stdext::map<std::string, ItemTypeList> m_itemNameIndex;
+    std::vector<std::pair<std::string, ItemTypePtr>> m_itemNameList;
+    bool m_itemNameIndexDirty{ true };
     uint32_t m_otbMinorVersion{ 0 };
     uint32_t m_otbMajorVersion{ 0 };
     bool m_xmlLoaded{ false };
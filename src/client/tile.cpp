@@ -22,6 +22,7 @@
 
 #include "tile.h"
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/memorytracker.h>
 #include <framework/core/graphicalapplication.h>
 #include <framework/graphics/drawpoolmanager.h>
 #include "effect.h"
@@ -31,7 +32,17 @@
 #include "map.h"
 #include "protocolgame.h"
 
-Tile::Tile(const Position& position) : m_position(position) {}
+// tiles churn by the thousands while walking, attribute them so a
+// ballooning client can be blamed on the map without a heap dump; the
+// function-local static dodges the init order against g_memory
+static MemoryTracker::Counter& tileMemory()
+{
+    static auto* const counter = g_memory.counter("map-tiles");
+    return *counter;
+}
+
+Tile::Tile(const Position& position) : m_position(position) { tileMemory().add(sizeof(Tile)); }
+Tile::~Tile() { tileMemory().remove(sizeof(Tile)); }
 
 void Tile::drawThing(const ThingPtr& thing, const Point& dest, int flags, LightView* lightView)
 {
@@ -41,7 +52,8 @@ void Tile::drawThing(const ThingPtr& thing, const Point& dest, int flags, LightV
 
     thing->draw(dest, flags, lightView);
 
-    if (thing->isItem()) {
+    // elevation offsets are sub-pixel at overview zoom, keep the stack flat
+    if (thing->isItem() && !(flags & Otc::DrawMinimalDetail)) {
         m_drawElevation += thing->getElevation();
         if (m_drawElevation > MAX_ELEVATION)
             m_drawElevation = MAX_ELEVATION;
@@ -85,11 +97,11 @@ void Tile::drawCreature(const Point& dest, const MapPosInfo& mapRect, int flags,
 
     if (hasCreature()) {
         for (const auto& thing : m_things) {
-            if (!thing->isCreature() || thing->static_self_cast<Creature>()->isWalking()) continue;
+            if (!thing->isCreature() || thing->static_self<Creature>()->isWalking()) continue;
 
             const Point& cDest = dest - m_drawElevation * g_drawPool.getScaleFactor();
             drawThing(thing, cDest, flags, lightView);
-            thing->static_self_cast<Creature>()->drawInformation(mapRect, cDest, isCovered, flags);
+            thing->static_self<Creature>()->drawInformation(mapRect, cDest, isCovered, flags);
         }
     }
 
@@ -108,7 +120,7 @@ void Tile::drawTop(const Point& dest, int flags, bool forceDraw, LightView* ligh
     if (!forceDraw && !m_drawTopAndCreature)
         return;
 
-    if (hasEffect()) {
+    if (hasEffect() && !(flags & Otc::DrawLowDetail)) {
         int offsetX = 0,
             offsetY = 0;
 
@@ -140,10 +152,39 @@ void Tile::clean()
     m_thingTypeFlag = 0;
 
 #ifdef FRAMEWORK_EDITOR
-    m_flags = 0;
+    setFlags(0);
 #endif
 }
 
+#ifdef FRAMEWORK_EDITOR
+void Tile::remFlag(const uint32_t flag)
+{
+    if ((m_flags & flag) == 0)
+        return;
+
+    m_flags &= ~flag;
+    g_map.bumpZoneVersion();
+}
+
+void Tile::setFlag(const uint32_t flag)
+{
+    if ((m_flags & flag) == flag)
+        return;
+
+    m_flags |= flag;
+    g_map.bumpZoneVersion();
+}
+
+void Tile::setFlags(const uint32_t flags)
+{
+    if (m_flags == flags)
+        return;
+
+    m_flags = flags;
+    g_map.bumpZoneVersion();
+}
+#endif
+
 void Tile::addWalkingCreature(const CreaturePtr& creature)
 {
     m_walkingCreatures.emplace_back(creature);
@@ -230,6 +271,7 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
         stackPos = size;
 
     m_things.insert(m_things.begin() + stackPos, thing);
+    invalidateStackCaches();
 
     // get the elevation status before analyze the new item.
     const bool hasElev = hasElevation();
@@ -275,6 +317,7 @@ bool Tile::removeThing(const ThingPtr thing)
         return false;
 
     m_things.erase(it);
+    invalidateStackCaches();
 
     recalculateThingFlag();
     if (thing->hasElevation())
@@ -368,47 +411,79 @@ uint8_t Tile::getMinimapColorByte()
     if (m_minimapColor != 0)
         return m_minimapColor;
 
+    // resolved lazily and cached until the thing stack changes; 0 never
+    // names a valid resolved color, so it doubles as the dirty mark
+    if (m_minimapColorCache != 0)
+        return m_minimapColorCache;
+
+    uint8_t color = 255;
     for (auto it = m_things.rbegin(); it != m_things.rend(); ++it) {
         const auto& thing = *it;
         if (thing->isCreature() || thing->isCommon())
             continue;
 
         const uint8_t c = thing->getMinimapColor();
-        if (c != 0) return c;
+        if (c != 0) {
+            color = c;
+            break;
+        }
     }
 
-    return 255;
+    m_minimapColorCache = color;
+    return color;
 }
 
 ThingPtr Tile::getTopLookThing()
 {
-    if (isEmpty())
-        return nullptr;
+    if (m_topLookThingCached)
+        return m_topLookThingCache;
 
-    for (const auto& thing : m_things) {
-        if (!thing->isIgnoreLook() && (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop()))
-            return thing;
+    ThingPtr topThing;
+    if (!isEmpty()) {
+        topThing = m_things[0];
+        for (const auto& thing : m_things) {
+            if (!thing->isIgnoreLook() && (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop())) {
+                topThing = thing;
+                break;
+            }
+        }
     }
 
-    return m_things[0];
+    m_topLookThingCache = topThing;
+    m_topLookThingCached = true;
+    return topThing;
 }
 
 ThingPtr Tile::getTopUseThing()
 {
-    if (isEmpty())
-        return nullptr;
+    if (m_topUseThingCached)
+        return m_topUseThingCache;
 
-    for (const auto& thing : m_things) {
-        if (thing->isForceUse() || (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop() && !thing->isCreature() && !thing->isSplash()))
-            return thing;
-    }
+    ThingPtr topThing;
+    if (!isEmpty()) {
+        topThing = m_things[0];
+        bool found = false;
+        for (const auto& thing : m_things) {
+            if (thing->isForceUse() || (!thing->isGround() && !thing->isGroundBorder() && !thing->isOnBottom() && !thing->isOnTop() && !thing->isCreature() && !thing->isSplash())) {
+                topThing = thing;
+                found = true;
+                break;
+            }
+        }
 
-    for (const auto& thing : m_things) {
-        if (!thing->isGround() && !thing->isGroundBorder() && !thing->isCreature() && !thing->isSplash())
-            return thing;
+        if (!found) {
+            for (const auto& thing : m_things) {
+                if (!thing->isGround() && !thing->isGroundBorder() && !thing->isCreature() && !thing->isSplash()) {
+                    topThing = thing;
+                    break;
+                }
+            }
+        }
     }
 
-    return m_things[0];
+    m_topUseThingCache = topThing;
+    m_topUseThingCached = true;
+    return topThing;
 }
 
 CreaturePtr Tile::getTopCreature(const bool checkAround)
@@ -510,7 +585,7 @@ bool Tile::isWalkable(bool ignoreCreatures)
         for (const auto& thing : m_things) {
             if (!thing->isCreature()) continue;
 
-            const auto& creature = thing->static_self_cast<Creature>();
+            auto* creature = thing->static_self<Creature>();
             if (!creature->isPassable() && creature->canBeSeen())
                 return false;
         }
@@ -519,14 +594,10 @@ bool Tile::isWalkable(bool ignoreCreatures)
     return true;
 }
 
-bool Tile::isCompletelyCovered(uint8_t firstFloor, bool resetCache)
+bool Tile::isCompletelyCovered(uint8_t firstFloor)
 {
     if (m_position.z == 0 || m_position.z == firstFloor) return false;
 
-    if (resetCache) {
-        m_isCompletelyCovered = m_isCovered = 0;
-    }
-
     if (hasCreature() || !m_walkingCreatures.empty() || hasLight())
         return false;
 
@@ -614,7 +685,7 @@ void Tile::onAddInMapView()
 bool Tile::hasBlockingCreature() const
 {
     for (const auto& thing : m_things)
-        if (thing->isCreature() && !thing->static_self_cast<Creature>()->isPassable() && !thing->isLocalPlayer())
+        if (thing->isCreature() && !thing->static_self<Creature>()->isPassable() && !thing->isLocalPlayer())
             return true;
     return false;
 }
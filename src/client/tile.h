@@ -23,6 +23,7 @@
 #pragma once
 
 #include <framework/luaengine/luaobject.h>
+#include <framework/stdext/smallvector.h>
 #include "declarations.h"
 #include "effect.h"
 #include "item.h"
@@ -89,6 +90,7 @@ class Tile : public LuaObject
 {
 public:
     Tile(const Position& position);
+    ~Tile() override;
 
     void onAddInMapView();
     void draw(const Point& dest, const MapPosInfo& mapRect, int flags, bool isCovered, LightView* lightView = nullptr);
@@ -114,9 +116,9 @@ public:
 
     int getDrawElevation() { return m_drawElevation; }
     const Position& getPosition() { return m_position; }
-    const std::vector<CreaturePtr>& getWalkingCreatures() { return m_walkingCreatures; }
-    const std::vector<ThingPtr>& getThings() { return m_things; }
-    const std::vector<EffectPtr>& getEffects() { return m_effects; }
+    const stdext::small_vector<CreaturePtr, 2>& getWalkingCreatures() { return m_walkingCreatures; }
+    const stdext::small_vector<ThingPtr, 4>& getThings() { return m_things; }
+    const stdext::small_vector<EffectPtr, 2>& getEffects() { return m_effects; }
     std::vector<CreaturePtr> getCreatures();
 
     std::vector<ItemPtr> getItems();
@@ -138,7 +140,8 @@ public:
     bool hasCreature() { return m_thingTypeFlag & TileThingType::HAS_CREATURE; }
     bool isTopGround() { return getGround() && getGround()->isTopGround(); }
     bool isCovered(int8_t firstFloor);
-    bool isCompletelyCovered(uint8_t firstFloor, bool resetCache);
+    bool isCompletelyCovered(uint8_t firstFloor);
+    void resetCoveredCache() { m_isCompletelyCovered = m_isCovered = 0; }
 
     bool hasBlockingCreature() const;
 
@@ -177,9 +180,9 @@ public:
 #ifdef FRAMEWORK_EDITOR
     void overwriteMinimapColor(uint8_t color) { m_minimapColor = color; }
 
-    void remFlag(uint32_t flag) { m_flags &= ~flag; }
-    void setFlag(uint32_t flag) { m_flags |= flag; }
-    void setFlags(uint32_t flags) { m_flags = flags; }
+    void remFlag(uint32_t flag);
+    void setFlag(uint32_t flag);
+    void setFlags(uint32_t flags);
     bool hasFlag(uint32_t flag) { return (m_flags & flag) == flag; }
     uint32_t getFlags() { return m_flags; }
 
@@ -211,11 +214,23 @@ private:
     bool checkForDetachableThing();
     bool hasThingWithElevation() const { return hasElevation() && m_thingTypeFlag & TileThingType::HAS_THING_WITH_ELEVATION; }
 
+    // every cache derived from the thing stack resets here, called
+    // whenever m_things gains or loses an entry
+    void invalidateStackCaches()
+    {
+        m_minimapColorCache = 0;
+        m_topLookThingCache = nullptr;
+        m_topUseThingCache = nullptr;
+        m_topLookThingCached = false;
+        m_topUseThingCached = false;
+    }
+
     Position m_position;
     Point m_lastDrawDest;
 
     uint8_t m_drawElevation{ 0 };
     uint8_t m_minimapColor{ 0 };
+    uint8_t m_minimapColorCache{ 0 };
     uint8_t m_elevation{ 0 };
 
     uint32_t m_isCompletelyCovered{ 0 };
@@ -227,11 +242,20 @@ private:
     uint32_t m_flags{ 0 };
 #endif
 
-    std::vector<CreaturePtr> m_walkingCreatures;
-    std::vector<ThingPtr> m_things;
-    std::vector<EffectPtr> m_effects;
+    // inline storage sized for the common case, most tiles hold a ground
+    // and a couple of items and never touch the heap
+    stdext::small_vector<CreaturePtr, 2> m_walkingCreatures;
+    stdext::small_vector<ThingPtr, 4> m_things;
+    stdext::small_vector<EffectPtr, 2> m_effects;
     std::vector<TilePtr> m_tilesRedraw;
 
+    // mouse hover resolves the same stack over and over; both depend only
+    // on m_things and the static flags of its entries
+    ThingPtr m_topLookThingCache;
+    ThingPtr m_topUseThingCache;
+    bool m_topLookThingCached{ false };
+    bool m_topUseThingCached{ false };
+
     uint16_t m_highlightThingId{ 0 };
 
     TileSelectType m_selectType{ TileSelectType::NONE };
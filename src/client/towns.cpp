@@ -40,15 +40,23 @@ TownManager::TownManager()
 
 void TownManager::addTown(const TownPtr& town)
 {
-    if (findTown(town->getId()) == m_towns.end())
-        m_towns.emplace_back(town);
+    if (findTown(town->getId()) != m_towns.end())
+        return;
+
+    m_towns.emplace_back(town);
+    if (town->getPos().isValid())
+        m_templeIndex[town->getPos()] = town;
 }
 
 void TownManager::removeTown(uint32_t townId)
 {
     const auto it = findTown(townId);
-    if (it != m_towns.end())
-        m_towns.erase(it);
+    if (it == m_towns.end())
+        return;
+
+    if ((*it)->getPos().isValid())
+        m_templeIndex.erase((*it)->getPos());
+    m_towns.erase(it);
 }
 
 const TownPtr& TownManager::getTown(uint32_t townId)
@@ -69,6 +77,14 @@ const TownPtr& TownManager::getTownByName(const std::string_view name)
     return m_nullTown;
 }
 
+const TownPtr& TownManager::getTownByPos(const Position& pos)
+{
+    const auto it = m_templeIndex.find(pos);
+    if (it != m_templeIndex.end())
+        return it->second;
+    return m_nullTown;
+}
+
 TownList::iterator TownManager::findTown(uint32_t townId)
 {
     return std::find_if(m_towns.begin(), m_towns.end(),
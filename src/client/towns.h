@@ -56,15 +56,19 @@ public:
     void removeTown(uint32_t townId);
     const TownPtr& getTown(uint32_t townId);
     const TownPtr& getTownByName(const std::string_view name);
+    const TownPtr& getTownByPos(const Position& pos);
 
     void sort();
     TownList getTowns() { return m_towns; }
-    void clear() { m_towns.clear(); m_nullTown = nullptr; }
+    void clear() { m_towns.clear(); m_templeIndex.clear(); m_nullTown = nullptr; }
 
 private:
     TownList m_towns;
     TownPtr m_nullTown;
 
+    // temple-position hash kept in sync by addTown/removeTown
+    stdext::map<Position, TownPtr, Position::Hasher> m_templeIndex;
+
 protected:
     TownList::iterator findTown(uint32_t townId);
 };
@@ -21,8 +21,44 @@
  */
 
 #include "uiitem.h"
+#include <framework/graphics/coordsbuffer.h>
+#include <framework/graphics/drawpoolmanager.h>
 #include <framework/graphics/fontmanager.h>
 
+namespace {
+    // stack count labels repeat the same few strings on every visible slot,
+    // so their glyph quads are tessellated once per count and shared by all
+    // item widgets; higher counts are rare and shape through the font path
+    constexpr int MAX_CACHED_COUNT = 100;
+
+    struct CachedCount
+    {
+        CoordsBufferPtr coords;
+        Size size;
+    };
+
+    BitmapFontPtr g_countCacheFont;
+    std::array<CachedCount, MAX_CACHED_COUNT> g_countCache;
+
+    const CachedCount& getCachedCount(const BitmapFontPtr& font, const int count)
+    {
+        if (g_countCacheFont != font) {
+            g_countCacheFont = font;
+            for (auto& cached : g_countCache)
+                cached.coords = nullptr;
+        }
+
+        auto& cached = g_countCache[count - 1];
+        if (!cached.coords) {
+            cached.coords = std::make_shared<CoordsBuffer>();
+            const auto& text = std::to_string(count);
+            const auto& glyphsPositions = font->calculateGlyphsPositions(text, Fw::AlignTopLeft, &cached.size);
+            font->fillTextCoords(cached.coords, text, cached.size, Fw::AlignTopLeft, Rect(0, 0, cached.size), glyphsPositions);
+        }
+        return cached;
+    }
+}
+
 UIItem::UIItem() { setDraggable(true); }
 
 void UIItem::drawSelf(DrawPoolType drawPane)
@@ -49,8 +85,17 @@ void UIItem::drawSelf(DrawPoolType drawPane)
         if (m_font && (m_alwaysShowCount || m_item->isStackable() || m_item->isChargeable()) && m_item->getCountOrSubType() > 1) {
             static const Color STACK_COLOR(231, 231, 231);
 
-            const auto& count = std::to_string(m_item->getCountOrSubType());
-            m_font->drawText(count, Rect(m_rect.topLeft(), m_rect.bottomRight() - Point(3, 0)), STACK_COLOR, Fw::AlignBottomRight);
+            const int count = m_item->getCountOrSubType();
+            const Rect textRect(m_rect.topLeft(), m_rect.bottomRight() - Point(3, 0));
+            if (count <= MAX_CACHED_COUNT) {
+                const auto& cached = getCachedCount(m_font, count);
+                // bottom-right alignment is resolved here so the cached quads
+                // can stay anchored at the origin regardless of the slot rect
+                const Point dest = textRect.topLeft() + Point(textRect.width() - cached.size.width(), textRect.height() - cached.size.height());
+                static constexpr DrawConductor AGROUP_CONDUCTOR{ .agroup = true };
+                g_drawPool.addTexturedCoordsBuffer(m_font->getTexture(), cached.coords, STACK_COLOR, dest, AGROUP_CONDUCTOR);
+            } else
+                m_font->drawText(std::to_string(count), textRect, STACK_COLOR, Fw::AlignBottomRight);
         }
 
 #ifdef FRAMEWORK_EDITOR
@@ -48,6 +48,7 @@ public:
     void setDrawNames(bool enable) { m_mapView->setDrawNames(enable); }
     void setDrawHealthBars(bool enable) { m_mapView->setDrawHealthBars(enable); }
     void setDrawLights(bool enable) { m_mapView->setDrawLights(enable); }
+    void setLightResolutionScale(const uint8_t scale) { m_mapView->setLightResolutionScale(scale); }
     void setLimitVisibleDimension(bool enable) { m_mapView->setLimitVisibleDimension(enable); updateVisibleDimension(); }
     void setDrawManaBar(bool enable) { m_mapView->setDrawManaBar(enable); }
     void setKeepAspectRatio(bool enable);
@@ -92,6 +93,8 @@ public:
     void setCrosshairTexture(const std::string& texturePath) { m_mapView->setCrosshairTexture(texturePath); }
     void setDrawHighlightTarget(const bool enable) { m_mapView->setDrawHighlightTarget(enable); }
     void setAntiAliasingMode(const MapView::AntialiasingMode mode) { m_mapView->setAntiAliasingMode(mode); }
+    void setRenderScale(const uint8_t scalePercent) { m_mapView->setRenderScale(scalePercent); }
+    uint8_t getRenderScale() { return m_mapView->getRenderScale(); }
     void setFloorFading(const uint16_t v) { m_mapView->setFloorFading(v); }
 
 protected:
@@ -59,6 +59,7 @@ void UIMapAnchorLayout::addPositionAnchor(const UIWidgetPtr& anchoredWidget, Fw:
     anchorGroup->addAnchor(anchor);
 
     // layout must be updated because a new anchor got in
+    invalidateSortedGroups();
     update();
 }
 
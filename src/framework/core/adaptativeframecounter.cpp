@@ -23,18 +23,55 @@
 #include "adaptativeframecounter.h"
 #include <client/game.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/frameprofiler.h>
 #include <framework/platform/platformwindow.h>
 
 void AdaptativeFrameCounter::update()
 {
+    const uint64_t frameEnd = stdext::micros();
+
+    // EWMA of the frame cost, used to decide whether pacing is worthwhile
+    // and exported so the fps overlay can show work time next to frame time
+    const uint64_t frameCost = frameEnd - m_frameStart;
+    m_frameCost = m_frameCost == 0 ? frameCost : (m_frameCost * 7 + frameCost) / 8;
+
     // FPS 60 for foreground rendering alone
     const uint8_t maxFps = g_game.isOnline() ? m_maxFps : 60u;
     if (maxFps > 0) {
-        const int32_t sleepPeriod = (getMaxPeriod(maxFps) - 1000) - m_timer.elapsed_micros();
-        if (sleepPeriod > 0) stdext::microsleep(sleepPeriod);
-    }
+        const uint64_t period = getMaxPeriod(maxFps);
+
+        if (m_nextFrameAt == 0)
+            m_nextFrameAt = frameEnd;
+
+        // pacing against an absolute deadline keeps the cadence fixed
+        // instead of accumulating one sleep quantum of drift per frame;
+        // when frames already cost more than the period there is nothing
+        // to pace and sleeping would only add latency
+        if (m_frameCost < period && frameEnd < m_nextFrameAt) {
+            PROFILE_SCOPE("AdaptativeFrameCounter::pacing");
+
+            // coarse sleep up to the last millisecond, then spin for the
+            // rest: sleep_for alone wakes 1-2ms late on windows (even with
+            // timeBeginPeriod(1)) and the jitter shows as judder at fixed
+            // refresh
+            constexpr uint64_t SPIN_MARGIN = 1000;
+            if (m_nextFrameAt - frameEnd > SPIN_MARGIN)
+                stdext::microsleep(m_nextFrameAt - frameEnd - SPIN_MARGIN);
+
+            while (stdext::micros() < m_nextFrameAt);
+        }
+
+        m_nextFrameAt += period;
+
+        // far behind schedule (window drag, loading screen), resync the
+        // deadline instead of bursting frames to catch up
+        const uint64_t now = stdext::micros();
+        if (m_nextFrameAt < now)
+            m_nextFrameAt = now + period;
+    } else
+        m_nextFrameAt = 0;
 
-    m_timer.restart();
+    m_frameStart = stdext::micros();
 
     ++m_fpsCount;
 
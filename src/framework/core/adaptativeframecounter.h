@@ -32,12 +32,16 @@ class AdaptativeFrameCounter
 public:
     AdaptativeFrameCounter() : m_interval(stdext::millis()) { }
 
-    void init() { m_timer.restart(); }
+    void init() { m_frameStart = stdext::micros(); }
     void update();
 
     uint16_t getFps() const { return m_fps; }
     uint8_t getMaxFps() const { return m_maxFps; }
 
+    // smoothed cost of the work part of a frame in microseconds, without
+    // the pacing wait
+    uint64_t getFrameCost() const { return m_frameCost; }
+
     void setMaxFps(const uint16_t max) { m_maxFps = max; }
 
 private:
@@ -50,5 +54,7 @@ private:
 
     uint32_t m_interval{};
 
-    stdext::timer m_timer;
+    uint64_t m_frameStart{ 0 };
+    uint64_t m_frameCost{ 0 };
+    uint64_t m_nextFrameAt{ 0 };
 };
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "assetbundle.h"
+#include "mappedfile.h"
+
+#include <framework/core/logger.h>
+
+#include <algorithm>
+#include <fstream>
+#include <zlib.h>
+
+AssetBundle::AssetBundle(MappedFilePtr mapped) : m_mapped(std::move(mapped))
+{
+    if (!m_mapped || m_mapped->size() < sizeof(Header))
+        return;
+
+    const auto* header = reinterpret_cast<const Header*>(m_mapped->data());
+    if (header->magic != MAGIC || header->version != VERSION)
+        return;
+
+    if (header->indexOffset + static_cast<uint64_t>(header->entryCount) * sizeof(Entry) > m_mapped->size()) {
+        g_logger.error("corrupt asset bundle: index past end of file");
+        return;
+    }
+
+    m_entries = reinterpret_cast<const Entry*>(m_mapped->data() + header->indexOffset);
+    m_entryCount = header->entryCount;
+    m_names = reinterpret_cast<const char*>(m_entries + m_entryCount);
+    m_namesSize = m_mapped->size() - (header->indexOffset + static_cast<uint64_t>(m_entryCount) * sizeof(Entry));
+}
+
+uint64_t AssetBundle::hashPath(const std::string_view path)
+{
+    // FNV-1a; the directory is sorted by this hash and binary searched
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char c : path) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::string_view AssetBundle::pathOf(const Entry& entry) const
+{
+    if (entry.pathOffset + entry.pathLength > m_namesSize)
+        return {};
+    return { m_names + entry.pathOffset, entry.pathLength };
+}
+
+const AssetBundle::Entry* AssetBundle::find(const std::string_view path) const
+{
+    if (m_entryCount == 0)
+        return nullptr;
+
+    const uint64_t hash = hashPath(path);
+    const auto* end = m_entries + m_entryCount;
+    auto* it = std::lower_bound(m_entries, end, hash,
+                                [](const Entry& entry, uint64_t h) { return entry.pathHash < h; });
+
+    // hash collisions land adjacent in the sorted directory, the exact
+    // path compare picks the right one
+    for (; it != end && it->pathHash == hash; ++it) {
+        if (pathOf(*it) == path)
+            return it;
+    }
+    return nullptr;
+}
+
+std::string_view AssetBundle::view(const Entry& entry) const
+{
+    if (entry.compressedSize != entry.rawSize)
+        return {};
+    if (entry.dataOffset + entry.rawSize > m_mapped->size())
+        return {};
+    return { reinterpret_cast<const char*>(m_mapped->data() + entry.dataOffset), entry.rawSize };
+}
+
+std::string AssetBundle::read(const Entry& entry) const
+{
+    if (entry.dataOffset + entry.compressedSize > m_mapped->size()) {
+        g_logger.error("corrupt asset bundle: entry data past end of file");
+        return {};
+    }
+
+    const auto* data = m_mapped->data() + entry.dataOffset;
+    if (entry.compressedSize == entry.rawSize)
+        return { reinterpret_cast<const char*>(data), entry.rawSize };
+
+    std::string out(entry.rawSize, 0);
+    uLongf outSize = entry.rawSize;
+    if (uncompress(reinterpret_cast<Bytef*>(out.data()), &outSize, data, entry.compressedSize) != Z_OK || outSize != entry.rawSize) {
+        g_logger.error(stdext::format("corrupt asset bundle: failed to inflate '%s'", std::string(pathOf(entry))));
+        return {};
+    }
+    return out;
+}
+
+bool AssetBundle::build(const std::string& bundleFile, const std::vector<std::pair<std::string, std::string>>& files)
+{
+    std::ofstream out(bundleFile, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    Header header{ MAGIC, VERSION, static_cast<uint32_t>(files.size()), 0, 0 };
+    out.seekp(sizeof(Header));
+
+    std::vector<Entry> entries;
+    entries.reserve(files.size());
+
+    std::string names;
+    std::string compressed;
+    uint64_t offset = sizeof(Header);
+    for (const auto& [path, contents] : files) {
+        Entry entry{};
+        entry.pathHash = hashPath(path);
+        entry.dataOffset = offset;
+        entry.rawSize = contents.size();
+        entry.pathOffset = names.size();
+        entry.pathLength = path.size();
+        names += path;
+
+        // keep the blob raw when deflate does not actually shrink it
+        uLongf bound = compressBound(contents.size());
+        compressed.resize(bound);
+        if (!contents.empty()
+            && compress2(reinterpret_cast<Bytef*>(compressed.data()), &bound,
+                         reinterpret_cast<const Bytef*>(contents.data()), contents.size(), Z_DEFAULT_COMPRESSION) == Z_OK
+            && bound < contents.size()) {
+            entry.compressedSize = bound;
+            out.write(compressed.data(), bound);
+        } else {
+            entry.compressedSize = contents.size();
+            out.write(contents.data(), contents.size());
+        }
+
+        offset += entry.compressedSize;
+        entries.emplace_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.pathHash < b.pathHash; });
+
+    // the directory is read in place from the mapping, keep it aligned
+    while (offset % alignof(Entry) != 0) {
+        out.put(0);
+        ++offset;
+    }
+
+    header.indexOffset = offset;
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+    out.write(names.data(), names.size());
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    return out.good();
+}
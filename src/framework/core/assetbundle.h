@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+// single-file asset bundle: a blob section followed by a hash-sorted
+// directory, zlib-compressed per entry and served straight from one file
+// mapping. Replaces the tens of thousands of per-file open/stat calls a
+// plain data directory costs on cold start with a single open.
+//
+// layout (little-endian, index 8-byte aligned):
+//   header | entry blobs | entries[entryCount] sorted by pathHash | names
+class AssetBundle
+{
+public:
+    static constexpr uint32_t MAGIC = 0x4241544F; // 'OTAB'
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t indexOffset;
+    };
+
+    struct Entry
+    {
+        uint64_t pathHash;
+        uint64_t dataOffset;
+        uint32_t compressedSize;
+        uint32_t rawSize; // == compressedSize when the blob is stored raw
+        uint32_t pathOffset; // into the name table after the entries
+        uint32_t pathLength;
+    };
+
+    explicit AssetBundle(MappedFilePtr mapped);
+
+    bool isOpen() const { return m_entryCount > 0; }
+    uint32_t getEntryCount() const { return m_entryCount; }
+
+    const Entry* find(std::string_view path) const;
+
+    // inflates compressed entries onto the heap, raw ones are just copied
+    std::string read(const Entry& entry) const;
+    // zero-copy view into the mapping; empty for compressed entries
+    std::string_view view(const Entry& entry) const;
+
+    static uint64_t hashPath(std::string_view path);
+    static bool build(const std::string& bundleFile, const std::vector<std::pair<std::string, std::string>>& files);
+
+private:
+    std::string_view pathOf(const Entry& entry) const;
+
+    MappedFilePtr m_mapped;
+    const Entry* m_entries{ nullptr };
+    uint32_t m_entryCount{ 0 };
+    const char* m_names{ nullptr };
+    size_t m_namesSize{ 0 };
+};
@@ -27,24 +27,28 @@
 
 AsyncDispatcher g_asyncDispatcher;
 
+static thread_local size_t t_workerIndex = SIZE_MAX;
+
 void AsyncDispatcher::init()
 {
     // -2 = Main Thread and Map Thread
-    int_fast8_t threads = std::clamp<int_fast8_t>(std::thread::hardware_concurrency() - 2, 1, ASYNC_DISPATCHER_MAX_THREAD);
-    for (; --threads >= 0;)
-        spawn_thread();
+    const int_fast8_t threads = std::clamp<int_fast8_t>(std::thread::hardware_concurrency() - 2, 1, ASYNC_DISPATCHER_MAX_THREAD);
+
+    // populate the whole vector before any thread starts: exec_loop and
+    // push() index into m_workers concurrently, so it must never
+    // reallocate while a worker is live
+    for (int_fast8_t i = 0; i < threads; ++i)
+        m_workers.emplace_back(std::make_unique<Worker>());
+
+    m_running = true;
+    for (size_t index = 0; index < m_workers.size(); ++index)
+        m_workers[index]->thread = std::thread([this, index] { exec_loop(index); });
 }
 
 void AsyncDispatcher::terminate()
 {
     stop();
-    m_tasks.clear();
-}
-
-void AsyncDispatcher::spawn_thread()
-{
-    m_running = true;
-    m_threads.emplace_back([this] { exec_loop(); });
+    m_workers.clear();
 }
 
 void AsyncDispatcher::stop()
@@ -53,26 +57,92 @@ void AsyncDispatcher::stop()
     m_running = false;
     m_condition.notify_all();
     m_mutex.unlock();
-    for (std::thread& thread : m_threads)
-        thread.join();
-    m_threads.clear();
+    for (const auto& worker : m_workers)
+        worker->thread.join();
+    for (const auto& worker : m_workers)
+        for (auto& queue : worker->queues)
+            queue.clear();
+    m_pendingTasks = 0;
 };
 
-void AsyncDispatcher::exec_loop()
+void AsyncDispatcher::push(std::function<void()> task, Priority priority)
 {
-    std::unique_lock lock(m_mutex);
+    // with no live pool (before init() or after stop()) there is nobody to
+    // drain the queues: run inline so the task still executes and any
+    // schedule() future becomes ready instead of blocking forever
+    if (!m_running || m_workers.empty()) {
+        task();
+        return;
+    }
+
+    // workers keep their own tasks local, external threads distribute round-robin
+    const size_t index = t_workerIndex < m_workers.size() ? t_workerIndex :
+        m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+    auto& worker = *m_workers[index];
+    {
+        std::scoped_lock lock(worker.mutex);
+        worker.queues[static_cast<size_t>(priority)].emplace_back(std::move(task));
+    }
+
+    m_pendingTasks.fetch_add(1, std::memory_order_release);
+
+    // briefly take the sleep mutex so a worker between its wait check and
+    // the actual wait cannot miss this notification
+    { std::scoped_lock lock(m_mutex); }
+    m_condition.notify_one();
+}
+
+bool AsyncDispatcher::pop(size_t self, std::function<void()>& task)
+{
+    // own queues first, highest priority wins
+    {
+        auto& worker = *m_workers[self];
+        std::scoped_lock lock(worker.mutex);
+        for (auto& queue : worker.queues) {
+            if (!queue.empty()) {
+                task = std::move(queue.back());
+                queue.pop_back();
+                return true;
+            }
+        }
+    }
+
+    // steal from the front of a sibling's queue
+    for (size_t i = 1; i < m_workers.size(); ++i) {
+        auto& victim = *m_workers[(self + i) % m_workers.size()];
+        std::scoped_lock lock(victim.mutex);
+        for (auto& queue : victim.queues) {
+            if (!queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void AsyncDispatcher::exec_loop(size_t index)
+{
+    t_workerIndex = index;
+
     while (true) {
-        while (m_tasks.empty() && m_running)
-            m_condition.wait(lock);
+        std::function<void()> task;
+        if (pop(index, task)) {
+            m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            continue;
+        }
 
+        std::unique_lock lock(m_mutex);
+        if (!m_running)
+            return;
+        m_condition.wait(lock, [this] {
+            return m_pendingTasks.load(std::memory_order_acquire) > 0 || !m_running;
+        });
         if (!m_running)
             return;
-
-        std::function<void()> task = m_tasks.front();
-        m_tasks.pop_front();
-
-        lock.unlock();
-        task();
-        lock.lock();
     }
 }
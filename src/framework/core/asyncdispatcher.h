@@ -22,44 +22,65 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <future>
-#include <list>
+#include <memory>
+#include <vector>
 
 class AsyncDispatcher
 {
 public:
+    enum class Priority : uint8_t
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+        COUNT
+    };
+
     void init();
     void terminate();
 
-    void spawn_thread();
     void stop();
 
     template<class F>
-    std::shared_future<std::invoke_result_t<F>> schedule(const F& task)
+    std::shared_future<std::invoke_result_t<F>> schedule(const F& task, Priority priority = Priority::NORMAL)
     {
-        std::scoped_lock lock(m_mutex);
         const auto& prom = std::make_shared<std::promise<std::invoke_result_t<F>>>();
-        m_tasks.push_back([=] { prom->set_value(task()); });
-        m_condition.notify_all();
+        push([=] { prom->set_value(task()); }, priority);
         return std::shared_future<std::invoke_result_t<F>>(prom->get_future());
     }
 
-    void dispatch(const std::function<void()>& f)
-    {
-        std::scoped_lock lock(m_mutex);
-        m_tasks.push_back(f);
-        m_condition.notify_all();
-    }
+    void dispatch(const std::function<void()>& f, Priority priority = Priority::NORMAL) { push(f, priority); }
+
+    // tasks pushed while the pool is not running execute inline on the
+    // calling thread; callers that would rather not pay that cost up front
+    // (e.g. shutdown saves) can check this and reorganize their work
+    bool isRunning() const { return m_running; }
 
 protected:
-    void exec_loop();
+    void exec_loop(size_t index);
 
 private:
-    std::list<std::function<void()>> m_tasks;
-    std::list<std::thread> m_threads;
+    // per-worker queues: the owning worker pushes and pops at the back,
+    // thieves steal from the front, so contention only happens on steals
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> queues[static_cast<size_t>(Priority::COUNT)];
+        std::thread thread;
+    };
+
+    void push(std::function<void()> task, Priority priority);
+    bool pop(size_t self, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
     std::mutex m_mutex;
     std::condition_variable m_condition;
-    bool m_running{ false };
+    std::atomic_bool m_running{ false };
+    std::atomic_uint32_t m_nextWorker{ 0 };
+    std::atomic_int32_t m_pendingTasks{ 0 };
 };
 
 extern AsyncDispatcher g_asyncDispatcher;
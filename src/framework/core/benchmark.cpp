@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "benchmark.h"
+#include "resourcemanager.h"
+
+#include "clock.h"
+
+Benchmark g_benchmark;
+
+namespace
+{
+    uint64_t percentile(const std::vector<uint64_t>& sorted, const double p)
+    {
+        if (sorted.empty())
+            return 0;
+        const auto index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+}
+
+void Benchmark::start(const std::string& name)
+{
+    std::scoped_lock lock(m_mutex);
+    m_name = name;
+    m_startMicros = stdext::micros();
+    m_stopMicros = 0;
+    m_frameTimes.clear();
+    m_drawCalls.clear();
+
+    // a minute at 60fps without regrowing
+    m_frameTimes.reserve(4096);
+    m_drawCalls.reserve(4096);
+
+    m_running.store(true, std::memory_order_relaxed);
+}
+
+void Benchmark::stop()
+{
+    if (!isRunning())
+        return;
+
+    m_running.store(false, std::memory_order_relaxed);
+
+    std::scoped_lock lock(m_mutex);
+    m_stopMicros = stdext::micros();
+}
+
+uint32_t Benchmark::getFrameCount()
+{
+    std::scoped_lock lock(m_mutex);
+    return static_cast<uint32_t>(m_frameTimes.size());
+}
+
+void Benchmark::onFrame(const uint64_t frameDurationMicros, const uint32_t drawCalls)
+{
+    if (!isRunning())
+        return;
+
+    std::scoped_lock lock(m_mutex);
+    m_frameTimes.emplace_back(frameDurationMicros);
+    m_drawCalls.emplace_back(drawCalls);
+}
+
+bool Benchmark::exportResults(const std::string& fileName)
+{
+    std::scoped_lock lock(m_mutex);
+
+    if (m_frameTimes.empty())
+        return false;
+
+    const uint64_t durationMicros = (m_stopMicros > 0 ? m_stopMicros : stdext::micros()) - m_startMicros;
+
+    auto sortedTimes = m_frameTimes;
+    std::sort(sortedTimes.begin(), sortedTimes.end());
+
+    uint64_t totalTime = 0;
+    for (const uint64_t time : sortedTimes)
+        totalTime += time;
+
+    uint64_t totalDrawCalls = 0;
+    uint32_t maxDrawCalls = 0;
+    for (const uint32_t calls : m_drawCalls) {
+        totalDrawCalls += calls;
+        maxDrawCalls = std::max<uint32_t>(maxDrawCalls, calls);
+    }
+
+    const auto frames = sortedTimes.size();
+    const auto toMs = [](const uint64_t micros) { return micros / 1000.0; };
+
+    // the 1% low is the conventional stutter number: the average fps over
+    // the slowest percent of frames
+    uint64_t onePercentTotal = 0;
+    const size_t onePercentCount = std::max<size_t>(frames / 100, 1);
+    for (size_t i = frames - onePercentCount; i < frames; ++i)
+        onePercentTotal += sortedTimes[i];
+
+    std::string json = "{";
+    json += stdext::format("\"name\":\"%s\",", m_name);
+    json += stdext::format("\"date\":\"%s\",", stdext::date_time_string());
+    json += stdext::format("\"durationSeconds\":%.3f,", durationMicros / 1000000.0);
+    json += stdext::format("\"frames\":%llu,", static_cast<unsigned long long>(frames));
+    json += stdext::format("\"fps\":{\"avg\":%.2f,\"onePercentLow\":%.2f},",
+                           frames * 1000000.0 / durationMicros,
+                           onePercentCount * 1000000.0 / onePercentTotal);
+    json += stdext::format("\"frameTimeMs\":{\"min\":%.3f,\"avg\":%.3f,\"p50\":%.3f,\"p75\":%.3f,\"p90\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"max\":%.3f},",
+                           toMs(sortedTimes.front()),
+                           toMs(totalTime / frames),
+                           toMs(percentile(sortedTimes, 0.50)),
+                           toMs(percentile(sortedTimes, 0.75)),
+                           toMs(percentile(sortedTimes, 0.90)),
+                           toMs(percentile(sortedTimes, 0.95)),
+                           toMs(percentile(sortedTimes, 0.99)),
+                           toMs(sortedTimes.back()));
+    json += stdext::format("\"drawCalls\":{\"avg\":%.1f,\"max\":%u}",
+                           static_cast<double>(totalDrawCalls) / frames, maxDrawCalls);
+    json += "}";
+
+    return g_resources.writeFileContents(fileName, json);
+}
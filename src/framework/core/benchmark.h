@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/global.h>
+
+class Benchmark;
+extern Benchmark g_benchmark;
+
+// records per-frame statistics over a run and exports them as json, so
+// builds, drivers and setting presets produce comparable numbers; the
+// scene itself (map, camera path, synthetic load) is scripted from lua
+// @bindsingleton g_benchmark
+class Benchmark
+{
+public:
+    void start(const std::string& name);
+    void stop();
+    bool isRunning() { return m_running.load(std::memory_order_relaxed); }
+
+    uint32_t getFrameCount();
+
+    // writes the collected run (frame-time percentiles, draw calls) as json
+    bool exportResults(const std::string& fileName);
+
+    // called by the run loop once per rendered frame
+    void onFrame(uint64_t frameDurationMicros, uint32_t drawCalls);
+
+private:
+    std::atomic<bool> m_running{ false };
+
+    std::mutex m_mutex;
+    std::string m_name;
+    uint64_t m_startMicros{ 0 };
+    uint64_t m_stopMicros{ 0 };
+    std::vector<uint64_t> m_frameTimes; // microseconds
+    std::vector<uint32_t> m_drawCalls;
+};
@@ -24,129 +24,216 @@
 #include "filestream.h"
 
 BinaryTree::BinaryTree(const FileStreamPtr& fin) :
-    m_fin(fin), m_pos(0xFFFFFFFF)
+    m_fin(fin)
 {
+    // node parsing needs random access, make sure the whole file is in
+    // memory (no-op for already cached or memory-mapped streams)
+    fin->cache();
+
+    m_raw = fin->readBuffer();
+    m_rawSize = fin->readSize();
     m_startPos = fin->tell();
+    m_rawPos = m_startPos;
 }
 
-void BinaryTree::skipNodes()
+uint32_t BinaryTree::skipBlock(uint32_t pos) const
 {
-    while (true) {
-        const uint8_t byte = m_fin->getU8();
-        switch (byte) {
-            case static_cast<uint8_t>(Node::START): skipNodes(); break;
-            case static_cast<uint8_t>(Node::END): return;
-            case static_cast<uint8_t>(Node::ESCAPE_CHAR): m_fin->getU8(); break;
-            default: break;
+    // pos points at a child's start marker, returns the position right
+    // after its matching end marker
+    int depth = 0;
+    while (pos < m_rawSize) {
+        const uint8_t byte = m_raw[pos++];
+        if (byte == static_cast<uint8_t>(Node::ESCAPE_CHAR))
+            ++pos;
+        else if (byte == static_cast<uint8_t>(Node::START))
+            ++depth;
+        else if (byte == static_cast<uint8_t>(Node::END) && --depth == 0)
+            return pos;
+    }
+    throw Exception("BinaryTree: node has no end");
+}
+
+bool BinaryTree::nextByte(uint8_t& byte)
+{
+    // yields the next payload byte, skipping over child blocks and
+    // decoding escape markers; false once the node's end is reached
+    while (m_rawPos < m_rawSize) {
+        byte = m_raw[m_rawPos];
+        if (byte == static_cast<uint8_t>(Node::END))
+            return false;
+
+        if (byte == static_cast<uint8_t>(Node::START)) {
+            m_rawPos = skipBlock(m_rawPos);
+            continue;
         }
+
+        ++m_rawPos;
+        if (byte == static_cast<uint8_t>(Node::ESCAPE_CHAR)) {
+            if (m_rawPos >= m_rawSize)
+                throw Exception("BinaryTree: unexpected end of file");
+            byte = m_raw[m_rawPos++];
+        }
+
+        ++m_pos;
+        return true;
     }
+    throw Exception("BinaryTree: node has no end");
 }
 
-void BinaryTree::unserialize()
+bool BinaryTree::plainRun(uint32_t len) const
 {
-    if (m_pos != 0xFFFFFFFF)
-        return;
-    m_pos = 0;
+    // true when the next len raw bytes carry no markers and can be read
+    // straight out of the file region
+    if (m_rawPos + len > m_rawSize)
+        return false;
 
-    m_fin->seek(m_startPos);
-    while (true) {
-        uint8_t byte = m_fin->getU8();
-        switch (byte) {
-            case static_cast<uint8_t>(Node::START): skipNodes(); break;
-            case static_cast<uint8_t>(Node::END): return;
-            case static_cast<uint8_t>(Node::ESCAPE_CHAR): m_buffer.add(m_fin->getU8()); break;
-            default: m_buffer.add(byte); break;
+    for (uint32_t i = 0; i < len; ++i) {
+        if (m_raw[m_rawPos + i] >= static_cast<uint8_t>(Node::ESCAPE_CHAR))
+            return false;
+    }
+    return true;
+}
+
+bool BinaryTree::canRead()
+{
+    while (m_rawPos < m_rawSize) {
+        const uint8_t byte = m_raw[m_rawPos];
+        if (byte == static_cast<uint8_t>(Node::END))
+            return false;
+
+        if (byte == static_cast<uint8_t>(Node::START)) {
+            m_rawPos = skipBlock(m_rawPos);
+            continue;
         }
+
+        return true;
     }
+    return false;
+}
+
+uint32_t BinaryTree::size()
+{
+    if (m_size != 0xFFFFFFFF)
+        return m_size;
+
+    // one pass over the raw span, nothing is materialized
+    const uint32_t oldRawPos = m_rawPos;
+    const uint32_t oldPos = m_pos;
+
+    m_rawPos = m_startPos;
+    m_pos = 0;
+
+    uint8_t byte;
+    while (nextByte(byte));
+    m_size = m_pos;
+
+    m_rawPos = oldRawPos;
+    m_pos = oldPos;
+    return m_size;
 }
 
 BinaryTreeVec BinaryTree::getChildren()
 {
     BinaryTreeVec children;
-    m_fin->seek(m_startPos);
-    while (true) {
-        const uint8_t byte = m_fin->getU8();
+    uint32_t pos = m_startPos;
+    while (pos < m_rawSize) {
+        const uint8_t byte = m_raw[pos];
         switch (byte) {
             case static_cast<uint8_t>(Node::START):
-            {
-                const auto& node = std::make_shared<BinaryTree>(m_fin);
-                children.emplace_back(node);
-                node->skipNodes();
+                m_fin->seek(pos + 1);
+                children.emplace_back(std::make_shared<BinaryTree>(m_fin));
+                pos = skipBlock(pos);
                 break;
-            }
 
             case static_cast<uint8_t>(Node::END): return children;
-            case static_cast<uint8_t>(Node::ESCAPE_CHAR): m_fin->getU8(); break;
-            default: break;
+            case static_cast<uint8_t>(Node::ESCAPE_CHAR): pos += 2; break;
+            default: ++pos; break;
         }
     }
+    throw Exception("BinaryTree: node has no end");
 }
 
 void BinaryTree::seek(uint32_t pos)
 {
-    unserialize();
-    if (pos > m_buffer.size())
-        throw Exception("BinaryTree: seek failed");
-    m_pos = pos;
+    if (pos < m_pos) {
+        m_rawPos = m_startPos;
+        m_pos = 0;
+    }
+    skip(pos - m_pos);
 }
 
 void BinaryTree::skip(uint32_t len)
 {
-    unserialize();
-    seek(tell() + len);
+    while (len-- > 0)
+        getU8();
 }
 
 uint8_t BinaryTree::getU8()
 {
-    unserialize();
-    if (m_pos + 1 > m_buffer.size())
+    uint8_t v;
+    if (!nextByte(v))
         throw Exception("BinaryTree: getU8 failed");
-    const uint8_t v = m_buffer[m_pos];
-    m_pos += 1;
     return v;
 }
 
 uint16_t BinaryTree::getU16()
 {
-    unserialize();
-    if (m_pos + 2 > m_buffer.size())
-        throw Exception("BinaryTree: getU16 failed");
-    const uint16_t v = stdext::readULE16(&m_buffer[m_pos]);
-    m_pos += 2;
+    if (plainRun(2)) {
+        const uint16_t v = stdext::readULE16(m_raw + m_rawPos);
+        m_rawPos += 2;
+        m_pos += 2;
+        return v;
+    }
+
+    uint16_t v = getU8();
+    v |= getU8() << 8;
     return v;
 }
 
 uint32_t BinaryTree::getU32()
 {
-    unserialize();
-    if (m_pos + 4 > m_buffer.size())
-        throw Exception("BinaryTree: getU32 failed");
-    const uint32_t v = stdext::readULE32(&m_buffer[m_pos]);
-    m_pos += 4;
+    if (plainRun(4)) {
+        const uint32_t v = stdext::readULE32(m_raw + m_rawPos);
+        m_rawPos += 4;
+        m_pos += 4;
+        return v;
+    }
+
+    uint32_t v = getU16();
+    v |= getU16() << 16;
     return v;
 }
 
 uint64_t BinaryTree::getU64()
 {
-    unserialize();
-    if (m_pos + 8 > m_buffer.size())
-        throw Exception("BinaryTree: getU64 failed");
-    const uint64_t v = stdext::readULE64(&m_buffer[m_pos]);
-    m_pos += 8;
+    if (plainRun(8)) {
+        const uint64_t v = stdext::readULE64(m_raw + m_rawPos);
+        m_rawPos += 8;
+        m_pos += 8;
+        return v;
+    }
+
+    uint64_t v = getU32();
+    v |= static_cast<uint64_t>(getU32()) << 32;
     return v;
 }
 
 std::string BinaryTree::getString(uint16_t len)
 {
-    unserialize();
     if (len == 0)
         len = getU16();
 
-    if (m_pos + len > m_buffer.size())
-        throw Exception("BinaryTree: getString failed: string length exceeded buffer size.");
+    if (plainRun(len)) {
+        std::string ret(reinterpret_cast<const char*>(m_raw + m_rawPos), len);
+        m_rawPos += len;
+        m_pos += len;
+        return ret;
+    }
 
-    std::string ret((char*)&m_buffer[m_pos], len);
-    m_pos += len;
+    std::string ret;
+    ret.reserve(len);
+    while (len-- > 0)
+        ret.push_back(getU8());
     return ret;
 }
 
@@ -163,6 +250,16 @@ OutputBinaryTree::OutputBinaryTree(FileStreamPtr fin) : m_fin(std::move(fin))
     startNode(0);
 }
 
+OutputBinaryTree::OutputBinaryTree(std::vector<uint8_t>& buffer) : m_buffer(&buffer) {}
+
+void OutputBinaryTree::put(const uint8_t v) const
+{
+    if (m_buffer)
+        m_buffer->push_back(v);
+    else
+        m_fin->addU8(v);
+}
+
 void OutputBinaryTree::addU8(uint8_t v)
 {
     write(&v, 1);
@@ -206,13 +303,13 @@ void OutputBinaryTree::addPoint(const Point& point)
 
 void OutputBinaryTree::startNode(uint8_t node)
 {
-    m_fin->addU8(static_cast<uint8_t>(BinaryTree::Node::START));
+    put(static_cast<uint8_t>(BinaryTree::Node::START));
     write(&node, 1);
 }
 
 void OutputBinaryTree::endNode() const
 {
-    m_fin->addU8(static_cast<uint8_t>(BinaryTree::Node::END));
+    put(static_cast<uint8_t>(BinaryTree::Node::END));
 }
 
 void OutputBinaryTree::write(const uint8_t* data, size_t size) const
@@ -220,9 +317,9 @@ void OutputBinaryTree::write(const uint8_t* data, size_t size) const
     for (size_t i = 0; i < size; ++i) {
         if (const auto v = static_cast<BinaryTree::Node>(data[i]);
             v == BinaryTree::Node::START || v == BinaryTree::Node::END || v == BinaryTree::Node::ESCAPE_CHAR) {
-            m_fin->addU8(static_cast<uint8_t>(BinaryTree::Node::ESCAPE_CHAR));
+            put(static_cast<uint8_t>(BinaryTree::Node::ESCAPE_CHAR));
         }
 
-        m_fin->addU8(data[i]);
+        put(data[i]);
     }
 }
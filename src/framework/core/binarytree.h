@@ -22,7 +22,6 @@
 
 #pragma once
 
-#include <framework/util/databuffer.h>
 #include "declarations.h"
 
 class BinaryTree
@@ -40,7 +39,7 @@ public:
     void seek(uint32_t pos);
     void skip(uint32_t len);
     uint32_t tell() const { return m_pos; }
-    uint32_t size() { unserialize(); return m_buffer.size(); }
+    uint32_t size();
 
     uint8_t getU8();
     uint16_t getU16();
@@ -50,16 +49,24 @@ public:
     Point getPoint();
 
     BinaryTreeVec getChildren();
-    bool canRead() { unserialize(); return m_pos < m_buffer.size(); }
+    bool canRead();
 
 private:
-    void unserialize();
-    void skipNodes();
+    bool nextByte(uint8_t& byte);
+    bool plainRun(uint32_t len) const;
+    uint32_t skipBlock(uint32_t pos) const;
 
     FileStreamPtr m_fin;
-    DataBuffer<uint8_t> m_buffer;
-    uint32_t m_pos;
-    uint32_t m_startPos;
+
+    // cursor view over the stream's cached or memory-mapped bytes, escapes
+    // are decoded on the fly instead of copying every payload into a
+    // per-node buffer
+    const uint8_t* m_raw{ nullptr };
+    uint32_t m_rawSize{ 0 };
+    uint32_t m_rawPos{ 0 };
+    uint32_t m_startPos{ 0 };
+    uint32_t m_pos{ 0 };
+    uint32_t m_size{ 0xFFFFFFFF };
 };
 
 class OutputBinaryTree
@@ -67,6 +74,11 @@ class OutputBinaryTree
 public:
     OutputBinaryTree(FileStreamPtr fin);
 
+    // serializes into a memory buffer instead of a stream; lets worker
+    // threads build pre-escaped subtree chunks that are later concatenated
+    // into the file, so no implicit root node is opened
+    OutputBinaryTree(std::vector<uint8_t>& buffer);
+
     void addU8(uint8_t v);
     void addU16(uint16_t v);
     void addU32(uint32_t v);
@@ -79,7 +91,9 @@ public:
 
 private:
     FileStreamPtr m_fin;
+    std::vector<uint8_t>* m_buffer{ nullptr };
 
 protected:
+    void put(uint8_t v) const;
     void write(const uint8_t* data, size_t size) const;
 };
@@ -25,6 +25,10 @@
 #include "declarations.h"
 
  // @bindsingleton g_clock
+ // micros/millis/seconds are frame coherent: they return the timestamp
+ // cached by the last update(), which every dispatcher poll runs once,
+ // so hot paths (timers, animations, walk updates) share one clock read
+ // per cycle instead of issuing their own
 class Clock
 {
 public:
@@ -34,6 +38,11 @@ public:
     ticks_t millis() { return m_currentMillis; }
     float seconds() { return m_currentSeconds; }
 
+    // reads the clock directly, only for measurements that need sub-frame
+    // precision (profiling, budgeted loops)
+    ticks_t rawMicros() const { return stdext::micros(); }
+    ticks_t rawMillis() const { return stdext::millis(); }
+
 private:
     std::atomic<ticks_t> m_currentMicros{ 0 };
     std::atomic<ticks_t> m_currentMillis{ 0 };
@@ -21,10 +21,18 @@
  */
 
 #include "config.h"
+#include "asyncdispatcher.h"
+#include "eventdispatcher.h"
 #include "resourcemanager.h"
 
 #include <framework/otml/otml.h>
 
+namespace
+{
+    // settles an options slider before anything touches the disk
+    constexpr int FLUSH_DELAY = 250;
+}
+
 Config::Config()
 {
     m_confsDoc = OTMLDocument::create();
@@ -52,6 +60,12 @@ bool Config::load(const std::string& file)
 bool Config::unload()
 {
     if (isLoaded()) {
+        if (m_dirty)
+            flush();
+        if (m_flushEvent) {
+            m_flushEvent->cancel();
+            m_flushEvent = nullptr;
+        }
         m_confsDoc = nullptr;
         m_fileName = "";
         return true;
@@ -63,7 +77,57 @@ bool Config::save()
 {
     if (m_fileName.length() == 0)
         return false;
-    return m_confsDoc->save(m_fileName);
+
+    // nothing changed since the last write, don't touch the disk
+    if (!m_dirty)
+        return true;
+
+    scheduleFlush();
+    return true;
+}
+
+bool Config::flush()
+{
+    if (m_fileName.length() == 0)
+        return false;
+
+    if (m_flushEvent) {
+        m_flushEvent->cancel();
+        m_flushEvent = nullptr;
+    }
+
+    m_dirty = false;
+
+    // serialize on the caller, hand the disk write to a worker with the
+    // tmp-write + rename commit so saving at logout never blocks the UI;
+    // during shutdown the dispatcher is gone and the write runs inline
+    if (!g_asyncDispatcher.isRunning())
+        return m_confsDoc->save(m_fileName);
+
+    g_asyncDispatcher.dispatch([fileName = m_fileName, data = m_confsDoc->emit()] {
+        if (!g_resources.writeFileAtomically(fileName, data))
+            g_logger.error(stdext::format("failed to save configuration file '%s'", fileName));
+    }, AsyncDispatcher::Priority::LOW);
+    return true;
+}
+
+void Config::scheduleFlush()
+{
+    if (m_flushEvent)
+        return;
+
+    m_flushEvent = g_dispatcher.scheduleEvent([self = asConfig()] {
+        self->m_flushEvent = nullptr;
+        if (!self->m_dirty || !self->isLoaded())
+            return;
+        self->m_dirty = false;
+
+        // serialize on the game thread, where the document is mutated,
+        // and hand only the file write to a worker
+        g_asyncDispatcher.dispatch([fileName = self->m_fileName, data = self->m_confsDoc->emit()] {
+            g_resources.writeFileAtomically(fileName, data);
+        });
+    }, FLUSH_DELAY);
 }
 
 void Config::clear() const
@@ -78,12 +142,20 @@ void Config::setValue(const std::string& key, const std::string& value)
         return;
     }
 
+    // unchanged values don't dirty the document
+    if (const auto& current = m_confsDoc->get(key); current && current->value() == value)
+        return;
+
     const auto& child = OTMLNode::create(key, value);
     m_confsDoc->addChild(child);
+    m_dirty = true;
 }
 
 void Config::setList(const std::string& key, const std::vector<std::string>& list)
 {
+    if (getList(key) == list)
+        return;
+
     remove(key);
 
     if (list.empty())
@@ -93,6 +165,7 @@ void Config::setList(const std::string& key, const std::vector<std::string>& lis
     for (const std::string& value : list)
         child->writeIn(value);
     m_confsDoc->addChild(child);
+    m_dirty = true;
 }
 
 bool Config::exists(const std::string& key)
@@ -120,8 +193,10 @@ std::vector<std::string> Config::getList(const std::string& key)
 void Config::remove(const std::string& key)
 {
     const auto& child = m_confsDoc->get(key);
-    if (child)
+    if (child) {
         m_confsDoc->removeChild(child);
+        m_dirty = true;
+    }
 }
 
 void Config::setNode(const std::string& key, const OTMLNodePtr& node)
@@ -136,6 +211,9 @@ void Config::mergeNode(const std::string& key, const OTMLNodePtr& node)
     clone->setTag(key);
     clone->setUnique(true);
     m_confsDoc->addChild(clone);
+
+    // nodes are not worth diffing, assume they changed
+    m_dirty = true;
 }
 
 OTMLNodePtr Config::getNode(const std::string& key)
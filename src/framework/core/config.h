@@ -36,6 +36,7 @@ public:
     bool load(const std::string& file);
     bool unload();
     bool save();
+    bool flush();
     void clear() const;
 
     void setValue(const std::string& key, const std::string& value);
@@ -57,6 +58,13 @@ public:
     ConfigPtr asConfig() { return static_self_cast<Config>(); }
 
 private:
+    void scheduleFlush();
+
     std::string m_fileName;
     OTMLDocumentPtr m_confsDoc;
+
+    // save() only schedules a write when some value actually changed, and
+    // bursts of changes (options slider) collapse into one deferred flush
+    ScheduledEventPtr m_flushEvent;
+    bool m_dirty{ false };
 };
@@ -29,8 +29,8 @@ void ConfigManager::init() { m_settings = std::make_shared<Config>(); }
 void ConfigManager::terminate()
 {
     if (m_settings) {
-        // ensure settings are saved
-        m_settings->save();
+        // ensure settings are saved, even with a flush still pending
+        m_settings->flush();
 
         m_settings->unload();
         m_settings = nullptr;
@@ -78,7 +78,7 @@ ConfigPtr ConfigManager::create(const std::string& file)
         config = std::make_shared<Config>();
 
         config->load(file);
-        config->save();
+        config->flush(); // materialize the file right away
 
         m_configs.emplace_back(config);
     }
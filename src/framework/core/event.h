@@ -23,12 +23,13 @@
 #pragma once
 
 #include <framework/luaengine/luaobject.h>
+#include <framework/stdext/smallfunction.h>
 
  // @bindclass
 class Event : public LuaObject
 {
 public:
-    Event(std::function<void()> callback);
+    Event(stdext::small_function<void()> callback);
     ~Event() override;
 
     virtual void execute();
@@ -38,7 +39,7 @@ public:
     bool isExecuted() { return m_executed; }
 
 protected:
-    std::function<void()> m_callback;
+    stdext::small_function<void()> m_callback;
     bool m_canceled;
     bool m_executed;
 };
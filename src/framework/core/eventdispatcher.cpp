@@ -23,6 +23,7 @@
 #include "eventdispatcher.h"
 
 #include <framework/core/clock.h>
+#include <framework/core/frameprofiler.h>
 #include <framework/core/graphicalapplication.h>
 #include "timer.h"
 
@@ -31,39 +32,50 @@ std::thread::id g_mainThreadId = std::this_thread::get_id();
 
 void EventDispatcher::shutdown()
 {
-    while (!m_eventList.empty())
+    while (!m_eventList.empty() || !m_crossEvents.empty())
         poll();
 
-    while (!m_scheduledEventList.empty()) {
-        m_scheduledEventList.top()->cancel();
-        m_scheduledEventList.pop();
-    }
+    for (const auto& scheduledEvent : m_scheduledEvents.takeAll())
+        scheduledEvent->cancel();
 
     m_disabled = true;
 }
 
 void EventDispatcher::poll()
 {
+    PROFILE_SCOPE("EventDispatcher::poll");
+
+    m_ownerThreadId.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
     {
         std::scoped_lock l(m_mutex);
-        for (int count = 0, max = m_scheduledEventList.size(); count < max && !m_scheduledEventList.empty(); ++count) {
-            const auto scheduledEvent = m_scheduledEventList.top();
-            if (scheduledEvent->remainingTicks() > 0)
-                break;
+        m_scheduledEvents.poll(m_expiredEvents);
 
-            m_scheduledEventList.pop();
+        // iterate by index, executing an event may recursively poll and
+        // append to (or drain) this same vector
+        for (size_t i = 0; i < m_expiredEvents.size(); ++i) {
+            const auto scheduledEvent = m_expiredEvents[i];
             scheduledEvent->execute();
 
             if (scheduledEvent->nextCycle())
-                m_scheduledEventList.push(scheduledEvent);
+                m_scheduledEvents.add(scheduledEvent);
         }
+        m_expiredEvents.clear();
     }
 
-    const bool isMainDispatcher = &g_mainDispatcher == this;
-    std::unique_lock ul(m_mutex);
+    // take everything posted by other threads since the last cycle
+    m_crossEvents.drain([this](std::pair<EventPtr, bool>&& entry) {
+        if (entry.second)
+            m_eventList.emplace_front(std::move(entry.first));
+        else
+            m_eventList.emplace_back(std::move(entry.first));
+    });
 
     // execute events list until all events are out, this is needed because some events can schedule new events that would
     // change the UIWidgets layout, in this case we must execute these new events before we continue rendering,
+    const ticks_t pollStart = m_pollBudgetMicros > 0 ? stdext::micros() : 0;
+    bool outOfBudget = false;
+
     m_pollEventsSize = m_eventList.size();
     int_fast32_t loops = 0;
     while (m_pollEventsSize > 0) {
@@ -79,17 +91,34 @@ void EventDispatcher::poll()
         for (int_fast32_t i = -1; ++i < static_cast<int_fast32_t>(m_pollEventsSize);) {
             const auto event = m_eventList.front();
             m_eventList.pop_front();
-            if (isMainDispatcher) ul.unlock();
             event->execute();
-            if (isMainDispatcher) ul.lock();
+
+            // probing the clock per event would outweigh small callbacks,
+            // so the budget is checked in batches of 16
+            if (m_pollBudgetMicros > 0 && (i & 0xf) == 0xf && stdext::micros() - pollStart >= m_pollBudgetMicros) {
+                outOfBudget = true;
+                break;
+            }
         }
+        if (outOfBudget)
+            break;
+
         m_pollEventsSize = m_eventList.size();
 
         ++loops;
     }
+
+    // whatever is left stays at the front of the list and runs before
+    // anything posted later, so a burst amortizes over the next cycles
+    // instead of freezing this one
+    m_carriedEvents = m_eventList.size();
+    if (m_carriedEvents > 0)
+        ++m_starvedPolls;
+    else
+        m_starvedPolls = 0;
 }
 
-ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& callback, int delay)
+ScheduledEventPtr EventDispatcher::scheduleEvent(stdext::small_function<void()> callback, int delay)
 {
     if (m_disabled)
         return std::make_shared<ScheduledEvent>(nullptr, delay, 1);
@@ -97,12 +126,12 @@ ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& ca
     std::scoped_lock<std::recursive_mutex> lock(m_mutex);
 
     assert(delay >= 0);
-    const auto& scheduledEvent = std::make_shared<ScheduledEvent>(callback, delay, 1);
-    m_scheduledEventList.emplace(scheduledEvent);
+    const auto& scheduledEvent = std::make_shared<ScheduledEvent>(std::move(callback), delay, 1);
+    m_scheduledEvents.add(scheduledEvent);
     return scheduledEvent;
 }
 
-ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callback, int delay)
+ScheduledEventPtr EventDispatcher::cycleEvent(stdext::small_function<void()> callback, int delay)
 {
     if (m_disabled)
         return std::make_shared<ScheduledEvent>(nullptr, delay, 0);
@@ -110,12 +139,12 @@ ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callb
     std::scoped_lock<std::recursive_mutex> lock(m_mutex);
 
     assert(delay > 0);
-    const auto& scheduledEvent = std::make_shared<ScheduledEvent>(callback, delay, 0);
-    m_scheduledEventList.emplace(scheduledEvent);
+    const auto& scheduledEvent = std::make_shared<ScheduledEvent>(std::move(callback), delay, 0);
+    m_scheduledEvents.add(scheduledEvent);
     return scheduledEvent;
 }
 
-EventPtr EventDispatcher::addEvent(const std::function<void()>& callback, bool pushFront)
+EventPtr EventDispatcher::addEvent(stdext::small_function<void()> callback, bool pushFront)
 {
     if (m_disabled)
         return std::make_shared<Event>(nullptr);
@@ -125,15 +154,20 @@ EventPtr EventDispatcher::addEvent(const std::function<void()>& callback, bool p
         return std::make_shared<Event>(nullptr);
     }
 
-    std::scoped_lock<std::recursive_mutex> lock(m_mutex);
-
-    const auto& event = std::make_shared<Event>(callback);
-    // front pushing is a way to execute an event before others
-    if (pushFront) {
-        m_eventList.emplace_front(event);
-        // the poll event list only grows when pushing into front
-        ++m_pollEventsSize;
+    const auto& event = std::make_shared<Event>(std::move(callback));
+
+    // events posted from the polling thread go straight into the list, other
+    // threads never touch it and use the lock-free queue instead
+    if (m_ownerThreadId.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+        // front pushing is a way to execute an event before others
+        if (pushFront) {
+            m_eventList.emplace_front(event);
+            // the poll event list only grows when pushing into front
+            ++m_pollEventsSize;
+        } else
+            m_eventList.emplace_back(event);
     } else
-        m_eventList.emplace_back(event);
+        m_crossEvents.push(std::make_pair(event, pushFront));
+
     return event;
 }
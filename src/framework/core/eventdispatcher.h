@@ -24,10 +24,12 @@
 
 #include "clock.h"
 #include "scheduledevent.h"
+#include "timerwheel.h"
 
-#include <queue>
 #include <thread>
 
+#include "../stdext/mpscqueue.h"
+
  // @bindsingleton g_dispatcher
 class EventDispatcher
 {
@@ -35,17 +37,37 @@ public:
     void shutdown();
     void poll();
 
-    EventPtr addEvent(const std::function<void()>& callback, bool pushFront = false);
-    ScheduledEventPtr scheduleEvent(const std::function<void()>& callback, int delay);
-    ScheduledEventPtr cycleEvent(const std::function<void()>& callback, int delay);
+    // optional per-poll budget in microseconds; 0 keeps the historical
+    // drain-everything behavior. Events over budget stay at the front of
+    // the list, so carried-over work runs before anything posted later.
+    void setPollBudget(int64_t budgetMicros) { m_pollBudgetMicros = budgetMicros; }
+    int64_t getPollBudget() const { return m_pollBudgetMicros; }
+
+    // starvation metrics: events carried into the next poll and for how
+    // many consecutive polls the queue never fully drained
+    size_t getCarriedEvents() const { return m_carriedEvents; }
+    uint32_t getStarvedPolls() const { return m_starvedPolls; }
+
+    EventPtr addEvent(stdext::small_function<void()> callback, bool pushFront = false);
+    ScheduledEventPtr scheduleEvent(stdext::small_function<void()> callback, int delay);
+    ScheduledEventPtr cycleEvent(stdext::small_function<void()> callback, int delay);
 
 private:
     size_t m_pollEventsSize{};
     bool m_disabled{ false };
 
+    int64_t m_pollBudgetMicros{ 0 };
+    size_t m_carriedEvents{ 0 };
+    uint32_t m_starvedPolls{ 0 };
+
+    // m_mutex only guards the scheduled event wheel; m_eventList is touched
+    // exclusively by the polling thread, other threads post through m_crossEvents.
     std::recursive_mutex m_mutex;
     std::deque<EventPtr> m_eventList;
-    std::priority_queue<ScheduledEventPtr, std::deque<ScheduledEventPtr>, ScheduledEvent::Compare> m_scheduledEventList;
+    stdext::mpsc_queue<std::pair<EventPtr, bool>> m_crossEvents;
+    std::atomic<std::thread::id> m_ownerThreadId;
+    TimerWheel m_scheduledEvents;
+    std::vector<ScheduledEventPtr> m_expiredEvents;
 };
 
 extern EventDispatcher g_dispatcher, g_textDispatcher, g_mainDispatcher;
@@ -22,6 +22,7 @@
 
 #include "filestream.h"
 #include <framework/core/application.h>
+#include <framework/core/asyncdispatcher.h>
 #include "binarytree.h"
 
 #include <physfs.h>
@@ -45,6 +46,23 @@ FileStream::FileStream(std::string name, const std::string_view buffer) :
     memcpy(&m_data[0], &buffer[0], buffer.length());
 }
 
+FileStream::FileStream(std::string name, MappedFilePtr mapped) :
+    m_name(std::move(name)),
+    m_fileHandle(nullptr),
+    m_pos(0),
+    m_writeable(false),
+    m_caching(true),
+    m_mapped(std::move(mapped))
+{}
+
+FileStream::FileStream(std::string name) :
+    m_name(std::move(name)),
+    m_fileHandle(nullptr),
+    m_pos(0),
+    m_writeable(true),
+    m_caching(true)
+{}
+
 FileStream::~FileStream()
 {
 #ifndef NDEBUG
@@ -59,6 +77,7 @@ void FileStream::cache()
     m_caching = true;
 
     if (!m_writeable) {
+        // mapped streams already give random access over the whole file
         if (!m_fileHandle)
             return;
 
@@ -82,6 +101,7 @@ void FileStream::close()
         m_fileHandle = nullptr;
     }
 
+    m_mapped = nullptr;
     m_data.clear();
     m_pos = 0;
 }
@@ -105,6 +125,35 @@ void FileStream::flush()
     }
 }
 
+void FileStream::flushAsync()
+{
+    if (!m_writeable)
+        throwError("filestream is not writeable");
+
+    // streams bound to a physfs handle keep the synchronous path
+    if (m_fileHandle || !m_caching) {
+        flush();
+        return;
+    }
+
+    // hand the coalesced buffer to a worker; the bytes land in a .tmp
+    // sibling and are renamed over the target only once fully on disk, so
+    // a crash mid-save never truncates the previous file
+    const auto& data = std::make_shared<std::vector<uint8_t>>(m_data.data(), m_data.data() + m_data.size());
+    const auto save = [name = m_name, data] {
+        if (!g_resources.writeFileBufferAtomically(name, data->data(), data->size()))
+            g_logger.error(stdext::format("failed to save '%s'", name));
+    };
+
+    if (g_asyncDispatcher.isRunning())
+        g_asyncDispatcher.dispatch(save, AsyncDispatcher::Priority::LOW);
+    else
+        save();
+
+    m_data.clear();
+    m_pos = 0;
+}
+
 int FileStream::read(void* buffer, uint32_t size, uint32_t nmemb)
 {
     if (!m_caching) {
@@ -116,11 +165,11 @@ int FileStream::read(void* buffer, uint32_t size, uint32_t nmemb)
     int writePos = 0;
     auto* const outBuffer = static_cast<uint8_t*>(buffer);
     for (uint32_t i = 0; i < nmemb; ++i) {
-        if (m_pos + size > m_data.size())
+        if (m_pos + size > readSize())
             return i;
 
         for (uint32_t j = 0; j < size; ++j)
-            outBuffer[writePos++] = m_data[m_pos++];
+            outBuffer[writePos++] = readBuffer()[m_pos++];
     }
     return nmemb;
 }
@@ -143,7 +192,7 @@ void FileStream::seek(uint32_t pos)
         if (!PHYSFS_seek(m_fileHandle, pos))
             throwError("seek failed", true);
     } else {
-        if (pos > m_data.size())
+        if (pos > readSize())
             throwError("seek failed");
         m_pos = pos;
     }
@@ -158,7 +207,7 @@ uint32_t FileStream::size() const
 {
     if (!m_caching)
         return PHYSFS_fileLength(m_fileHandle);
-    return m_data.size();
+    return readSize();
 }
 
 uint32_t FileStream::tell() const
@@ -172,7 +221,7 @@ bool FileStream::eof() const
 {
     if (!m_caching)
         return PHYSFS_eof(m_fileHandle);
-    return m_pos >= m_data.size();
+    return m_pos >= readSize();
 }
 
 uint8_t FileStream::getU8()
@@ -182,10 +231,10 @@ uint8_t FileStream::getU8()
         if (PHYSFS_readBytes(m_fileHandle, &v, 1) != 1)
             throwError("read failed", true);
     } else {
-        if (m_pos + 1 > m_data.size())
+        if (m_pos + 1 > readSize())
             throwError("read failed");
 
-        v = m_data[m_pos];
+        v = readBuffer()[m_pos];
         m_pos += 1;
     }
     return v;
@@ -198,10 +247,10 @@ uint16_t FileStream::getU16()
         if (PHYSFS_readULE16(m_fileHandle, &v) == 0)
             throwError("read failed", true);
     } else {
-        if (m_pos + 2 > m_data.size())
+        if (m_pos + 2 > readSize())
             throwError("read failed");
 
-        v = stdext::readULE16(&m_data[m_pos]);
+        v = stdext::readULE16(&readBuffer()[m_pos]);
         m_pos += 2;
     }
     return v;
@@ -214,10 +263,10 @@ uint32_t FileStream::getU32()
         if (PHYSFS_readULE32(m_fileHandle, &v) == 0)
             throwError("read failed", true);
     } else {
-        if (m_pos + 4 > m_data.size())
+        if (m_pos + 4 > readSize())
             throwError("read failed");
 
-        v = stdext::readULE32(&m_data[m_pos]);
+        v = stdext::readULE32(&readBuffer()[m_pos]);
         m_pos += 4;
     }
     return v;
@@ -230,9 +279,9 @@ uint64_t FileStream::getU64()
         if (PHYSFS_readULE64(m_fileHandle, (PHYSFS_uint64*)&v) == 0)
             throwError("read failed", true);
     } else {
-        if (m_pos + 8 > m_data.size())
+        if (m_pos + 8 > readSize())
             throwError("read failed");
-        v = stdext::readULE64(&m_data[m_pos]);
+        v = stdext::readULE64(&readBuffer()[m_pos]);
         m_pos += 8;
     }
     return v;
@@ -245,10 +294,10 @@ int8_t FileStream::get8()
         if (PHYSFS_readBytes(m_fileHandle, &v, 1) != 1)
             throwError("read failed", true);
     } else {
-        if (m_pos + 1 > m_data.size())
+        if (m_pos + 1 > readSize())
             throwError("read failed");
 
-        v = m_data[m_pos];
+        v = readBuffer()[m_pos];
         m_pos += 1;
     }
     return v;
@@ -261,10 +310,10 @@ int16_t FileStream::get16()
         if (PHYSFS_readSLE16(m_fileHandle, &v) == 0)
             throwError("read failed", true);
     } else {
-        if (m_pos + 2 > m_data.size())
+        if (m_pos + 2 > readSize())
             throwError("read failed");
 
-        v = stdext::readSLE16(&m_data[m_pos]);
+        v = stdext::readSLE16(&readBuffer()[m_pos]);
         m_pos += 2;
     }
     return v;
@@ -277,10 +326,10 @@ int32_t FileStream::get32()
         if (PHYSFS_readSLE32(m_fileHandle, &v) == 0)
             throwError("read failed", true);
     } else {
-        if (m_pos + 4 > m_data.size())
+        if (m_pos + 4 > readSize())
             throwError("read failed");
 
-        v = stdext::readSLE32(&m_data[m_pos]);
+        v = stdext::readSLE32(&readBuffer()[m_pos]);
         m_pos += 4;
     }
     return v;
@@ -293,9 +342,9 @@ int64_t FileStream::get64()
         if (PHYSFS_readSLE64(m_fileHandle, (PHYSFS_sint64*)&v) == 0)
             throwError("read failed", true);
     } else {
-        if (m_pos + 8 > m_data.size())
+        if (m_pos + 8 > readSize())
             throwError("read failed");
-        v = stdext::readSLE64(&m_data[m_pos]);
+        v = stdext::readSLE64(&readBuffer()[m_pos]);
         m_pos += 8;
     }
     return v;
@@ -312,12 +361,12 @@ std::string FileStream::getString()
             else
                 str = { buffer, len };
         } else {
-            if (m_pos + len > m_data.size()) {
+            if (m_pos + len > readSize()) {
                 throwError("[FileStream::getString] - Read failed");
                 return {};
             }
 
-            str = { (char*)&m_data[m_pos], len };
+            str = { (char*)&readBuffer()[m_pos], len };
             m_pos += len;
         }
     } else if (len != 0)
@@ -441,6 +490,8 @@ void FileStream::add64(int64_t v)
 void FileStream::addString(const std::string_view v)
 {
     addU16(v.length());
+    if (m_caching)
+        m_data.reserve(m_pos + v.length());
     write(v.data(), v.length());
 }
 
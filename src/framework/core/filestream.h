@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <framework/core/mappedfile.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/luaengine/luaobject.h>
 #include <framework/util/databuffer.h>
@@ -36,11 +37,14 @@ class FileStream
 public:
     FileStream(std::string name, PHYSFS_File* fileHandle, bool writeable);
     FileStream(std::string name, const std::string_view buffer);
+    FileStream(std::string name, MappedFilePtr mapped);
+    explicit FileStream(std::string name); // buffered write, see flushAsync()
     ~FileStream();
 
     void cache();
     void close();
     void flush();
+    void flushAsync();
     void write(const void* buffer, uint32_t count);
     int read(void* buffer, uint32_t size, uint32_t nmemb = 1);
     void seek(uint32_t pos);
@@ -77,6 +81,11 @@ public:
 
     DataBuffer<uint8_t> m_data;
 
+    // cached reads go through these so a memory-mapped stream serves the
+    // OS-paged bytes directly instead of a heap copy
+    const uint8_t* readBuffer() const { return m_mapped ? m_mapped->data() : m_data.data(); }
+    uint32_t readSize() const { return m_mapped ? m_mapped->size() : m_data.size(); }
+
 private:
     void throwError(const std::string_view message, bool physfsError = false) const;
 
@@ -85,4 +94,5 @@ private:
     uint32_t m_pos;
     bool m_writeable;
     bool m_caching;
+    MappedFilePtr m_mapped;
 };
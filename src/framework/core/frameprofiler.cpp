@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "frameprofiler.h"
+#include "resourcemanager.h"
+
+#include "clock.h"
+
+FrameProfiler g_profiler;
+
+void FrameProfiler::setEnabled(const bool enable)
+{
+    if (enable == isEnabled())
+        return;
+
+    std::scoped_lock lock(m_mutex);
+    for (const auto& buffer : m_threadBuffers) {
+        buffer->depth = 0;
+        buffer->completed.clear();
+    }
+    m_gpuSamples.clear();
+    m_frames.clear();
+    m_frameStart = g_clock.rawMicros();
+    m_enabled.store(enable, std::memory_order_relaxed);
+}
+
+thread_local FrameProfiler::ThreadBuffer* FrameProfiler::t_threadBuffer = nullptr;
+
+FrameProfiler::ThreadBuffer* FrameProfiler::getThreadBuffer()
+{
+    if (!t_threadBuffer) {
+        std::scoped_lock lock(m_mutex);
+        m_threadBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+        t_threadBuffer = m_threadBuffers.back().get();
+        t_threadBuffer->id = m_threadBuffers.size() - 1;
+    }
+
+    return t_threadBuffer;
+}
+
+void FrameProfiler::beginZone(const char* name)
+{
+    if (!isEnabled())
+        return;
+
+    auto* buffer = getThreadBuffer();
+    if (buffer->depth >= MAX_ZONE_DEPTH) {
+        ++buffer->depth;
+        return;
+    }
+
+    buffer->stack[buffer->depth] = { name, static_cast<uint64_t>(g_clock.rawMicros()) };
+    ++buffer->depth;
+}
+
+void FrameProfiler::endZone()
+{
+    if (!isEnabled())
+        return;
+
+    auto* buffer = getThreadBuffer();
+    if (buffer->depth == 0)
+        return; // profiler was enabled inside this zone
+
+    --buffer->depth;
+    if (buffer->depth >= MAX_ZONE_DEPTH)
+        return;
+
+    const auto& open = buffer->stack[buffer->depth];
+
+    std::scoped_lock lock(m_mutex);
+    buffer->completed.emplace_back(Zone{ open.name, buffer->id, buffer->depth, open.start, g_clock.rawMicros() - open.start });
+}
+
+void FrameProfiler::addGpuSample(const char* name, const uint64_t nanos)
+{
+    if (!isEnabled())
+        return;
+
+    std::scoped_lock lock(m_mutex);
+    m_gpuSamples.emplace_back(GpuSample{ name, nanos });
+}
+
+void FrameProfiler::onFrame()
+{
+    if (!isEnabled())
+        return;
+
+    const uint64_t now = g_clock.rawMicros();
+
+    std::scoped_lock lock(m_mutex);
+
+    Frame frame;
+    frame.index = m_frameIndex++;
+    frame.start = m_frameStart;
+    frame.duration = now - m_frameStart;
+    frame.gpuSamples = std::move(m_gpuSamples);
+    m_gpuSamples.clear();
+
+    for (const auto& buffer : m_threadBuffers) {
+        frame.zones.insert(frame.zones.end(), buffer->completed.begin(), buffer->completed.end());
+        buffer->completed.clear();
+    }
+
+    m_frames.emplace_back(std::move(frame));
+    while (m_frames.size() > FRAME_HISTORY)
+        m_frames.pop_front();
+
+    m_frameStart = now;
+}
+
+int FrameProfiler::snapshotOpenZones(const char** names, const int max) const
+{
+    // called from the hitch watchdog's sampling signal, so no locking and
+    // no allocation; the names are string literals and stay valid forever
+    const auto* buffer = t_threadBuffer;
+    if (!buffer)
+        return 0;
+
+    const int depth = std::min<int>(std::min<int>(buffer->depth, MAX_ZONE_DEPTH), max);
+    for (int i = 0; i < depth; ++i)
+        names[i] = buffer->stack[i].name;
+
+    return depth;
+}
+
+uint32_t FrameProfiler::getFrameCount()
+{
+    std::scoped_lock lock(m_mutex);
+    return m_frames.size();
+}
+
+std::vector<uint64_t> FrameProfiler::getFrameTimes()
+{
+    std::scoped_lock lock(m_mutex);
+
+    std::vector<uint64_t> times;
+    times.reserve(m_frames.size());
+    for (const auto& frame : m_frames)
+        times.emplace_back(frame.duration);
+
+    return times;
+}
+
+std::vector<std::tuple<std::string, int, uint64_t, uint64_t>> FrameProfiler::getLastFrameZones()
+{
+    std::scoped_lock lock(m_mutex);
+
+    std::vector<std::tuple<std::string, int, uint64_t, uint64_t>> zones;
+    if (m_frames.empty())
+        return zones;
+
+    const auto& frame = m_frames.back();
+    zones.reserve(frame.zones.size());
+    for (const auto& zone : frame.zones)
+        zones.emplace_back(zone.name, zone.depth, zone.start - frame.start, zone.duration);
+
+    return zones;
+}
+
+std::vector<std::tuple<std::string, uint64_t>> FrameProfiler::getLastFrameGpuTimes()
+{
+    std::scoped_lock lock(m_mutex);
+
+    std::vector<std::tuple<std::string, uint64_t>> times;
+    if (m_frames.empty())
+        return times;
+
+    const auto& frame = m_frames.back();
+    times.reserve(frame.gpuSamples.size());
+    for (const auto& sample : frame.gpuSamples)
+        times.emplace_back(sample.name, sample.nanos);
+
+    return times;
+}
+
+bool FrameProfiler::dumpTrace(const std::string& fileName)
+{
+    std::deque<Frame> frames;
+    {
+        std::scoped_lock lock(m_mutex);
+        frames = m_frames;
+    }
+
+    if (frames.empty())
+        return false;
+
+    // chrome://tracing format; one slice per zone, gpu samples on their own
+    // row at the start of the frame they were collected in
+    std::string trace = "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& frame : frames) {
+        trace += stdext::format("%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%llu,\"dur\":%llu}",
+                                first ? "" : ",", static_cast<unsigned long long>(frame.start), static_cast<unsigned long long>(frame.duration));
+        first = false;
+
+        for (const auto& zone : frame.zones) {
+            trace += stdext::format(",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%llu,\"dur\":%llu}",
+                                    zone.name, zone.threadId + 1, static_cast<unsigned long long>(zone.start), static_cast<unsigned long long>(zone.duration));
+        }
+
+        for (const auto& sample : frame.gpuSamples) {
+            trace += stdext::format(",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":\"gpu\",\"ts\":%llu,\"dur\":%llu}",
+                                    sample.name, static_cast<unsigned long long>(frame.start), static_cast<unsigned long long>(sample.nanos / 1000));
+        }
+    }
+    trace += "]}";
+
+    return g_resources.writeFileContents(fileName, trace);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/global.h>
+
+class FrameProfiler;
+extern FrameProfiler g_profiler;
+
+// hierarchical frame profiler; scoped CPU zones from any thread plus GPU
+// times reported per draw pool, aggregated into a ring of recent frames
+// @bindsingleton g_profiler
+class FrameProfiler
+{
+public:
+    enum
+    {
+        FRAME_HISTORY = 120,
+        MAX_ZONE_DEPTH = 16
+    };
+
+    struct Zone
+    {
+        const char* name;
+        uint16_t threadId;
+        uint8_t depth;
+        uint64_t start; // microseconds, same epoch as stdext::micros()
+        uint64_t duration;
+    };
+
+    struct GpuSample
+    {
+        const char* name;
+        uint64_t nanos;
+    };
+
+    struct Frame
+    {
+        uint64_t index;
+        uint64_t start;
+        uint64_t duration;
+        std::vector<Zone> zones;
+        std::vector<GpuSample> gpuSamples;
+    };
+
+    void setEnabled(bool enable);
+    bool isEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+    // zone names must be string literals, only the pointer is stored
+    void beginZone(const char* name);
+    void endZone();
+
+    // reported by the render thread once the GL timer query result lands
+    void addGpuSample(const char* name, uint64_t nanos);
+
+    // closes the current frame, called once per rendered frame
+    void onFrame();
+
+    // async-signal-safe snapshot of the calling thread's open zone names,
+    // outermost first; returns how many entries were written
+    int snapshotOpenZones(const char** names, int max) const;
+
+    uint32_t getFrameCount();
+    std::vector<uint64_t> getFrameTimes();
+    std::vector<std::tuple<std::string, int, uint64_t, uint64_t>> getLastFrameZones();
+    std::vector<std::tuple<std::string, uint64_t>> getLastFrameGpuTimes();
+
+    // writes the frame ring as a chrome://tracing compatible json file
+    bool dumpTrace(const std::string& fileName);
+
+    class Scope
+    {
+    public:
+        Scope(const char* name) { g_profiler.beginZone(name); }
+        ~Scope() { g_profiler.endZone(); }
+    };
+
+private:
+    struct OpenZone
+    {
+        const char* name;
+        uint64_t start;
+    };
+
+    struct ThreadBuffer
+    {
+        uint16_t id;
+        uint8_t depth{ 0 };
+        std::array<OpenZone, MAX_ZONE_DEPTH> stack;
+        std::vector<Zone> completed;
+    };
+
+    ThreadBuffer* getThreadBuffer();
+
+    static thread_local ThreadBuffer* t_threadBuffer;
+
+    std::atomic<bool> m_enabled{ false };
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+    std::vector<GpuSample> m_gpuSamples;
+    std::deque<Frame> m_frames;
+    uint64_t m_frameIndex{ 0 };
+    uint64_t m_frameStart{ 0 };
+};
+
+#define PROFILE_SCOPE_CONCAT2(a, b) a ## b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) const FrameProfiler::Scope PROFILE_SCOPE_CONCAT(__profileZone, __LINE__){ name }
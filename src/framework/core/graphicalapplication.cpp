@@ -25,14 +25,19 @@
 #include <client/game.h>
 #include <client/map.h>
 #include <framework/core/asyncdispatcher.h>
+#include <framework/core/benchmark.h>
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/frameprofiler.h>
+#include <framework/core/hitchwatchdog.h>
 #include <framework/graphics/drawpool.h>
 #include <framework/graphics/drawpoolmanager.h>
 #include <framework/graphics/graphics.h>
+#include <framework/graphics/painter.h>
 #include <framework/graphics/particlemanager.h>
 #include <framework/graphics/texturemanager.h>
 #include <framework/input/mouse.h>
+#include <framework/luaengine/luainterface.h>
 #include <framework/platform/platformwindow.h>
 #include <framework/ui/uimanager.h>
 #include <framework/ui/uiwidget.h>
@@ -42,39 +47,77 @@
 #include <framework/sound/soundmanager.h>
 #endif
 
+#include <framework/graphics/image.h>
+
 GraphicalApplication g_app;
 
+namespace {
+#ifndef OPENGL_ES
+    // captures in flight: the readback was issued into a pack buffer and
+    // the map happens on a later frame, once the DMA transfer is done
+    struct ScreenCapture
+    {
+        GLuint pbo{ 0 };
+        Size size;
+        std::string fileName;
+    };
+    std::deque<ScreenCapture> inflightCaptures;
+#endif
+
+    void saveCaptureAsync(const ImagePtr& image, const std::string& fileName)
+    {
+        g_asyncDispatcher.dispatch([image, fileName] {
+            try {
+                image->flipVertically(); // gl reads rows bottom-up
+                image->savePNG(fileName);
+            } catch (const std::exception& e) {
+                g_logger.error(stdext::format("failed to save screenshot '%s': %s", fileName, e.what()));
+            }
+        }, AsyncDispatcher::Priority::LOW);
+    }
+}
+
 void GraphicalApplication::init(std::vector<std::string>& args)
 {
+    // everything graphics-side initializes lazily on the draw path, so
+    // skipping the window, the GL context and the draw pools is enough for
+    // a fleet of logic-only instances; textures stay as decoded images and
+    // are never uploaded because nothing ever draws
+    m_headless = std::find(args.begin(), args.end(), "--headless") != args.end();
+
     Application::init(args);
 
-    // setup platform window
-    g_window.init();
-    g_window.hide();
+    if (!m_headless) {
+        // setup platform window
+        g_window.init();
+        g_window.hide();
 
-    g_window.setOnResize([this](auto&& PH1) {
-        if (!m_running) resize(PH1);
-        else g_dispatcher.addEvent([&, PH1] { resize(PH1); });
-    });
+        g_window.setOnResize([this](auto&& PH1) {
+            if (!m_running) resize(PH1);
+            else g_dispatcher.addEvent([&, PH1] { resize(PH1); });
+        });
 
-    g_window.setOnInputEvent([this](auto&& PH1) {
-        if (!m_running) inputEvent(PH1);
-        else g_dispatcher.addEvent([&, PH1]() { inputEvent(PH1); });
-    });
+        g_window.setOnInputEvent([this](auto&& PH1) {
+            if (!m_running) inputEvent(PH1);
+            else g_dispatcher.addEvent([&, PH1]() { inputEvent(PH1); });
+        });
 
-    g_window.setOnClose([this] { g_dispatcher.addEvent([&]() { close(); }); });
+        g_window.setOnClose([this] { g_dispatcher.addEvent([&]() { close(); }); });
 
-    g_mouse.init();
+        g_mouse.init();
+    }
 
     // initialize ui
     g_ui.init();
 
-    // initialize graphics
-    g_graphics.init();
-    g_drawPool.init(SPRITE_SIZE);
+    if (!m_headless) {
+        // initialize graphics
+        g_graphics.init();
+        g_drawPool.init(SPRITE_SIZE);
 
-    // fire first resize event
-    resize(g_window.getSize());
+        // fire first resize event
+        resize(g_window.getSize());
+    }
 
 #ifdef FRAMEWORK_SOUND
     // initialize sound
@@ -87,7 +130,8 @@ void GraphicalApplication::init(std::vector<std::string>& args)
 void GraphicalApplication::deinit()
 {
     // hide the window because there is no render anymore
-    g_window.hide();
+    if (!m_headless)
+        g_window.hide();
 
     Application::deinit();
 }
@@ -110,10 +154,12 @@ void GraphicalApplication::terminate()
 
     g_mouse.terminate();
 
-    // terminate graphics
-    g_drawPool.terminate();
-    g_graphics.terminate();
-    g_window.terminate();
+    if (!m_headless) {
+        // terminate graphics
+        g_drawPool.terminate();
+        g_graphics.terminate();
+        g_window.terminate();
+    }
 
     m_terminated = true;
 }
@@ -124,6 +170,28 @@ void GraphicalApplication::run()
     mainPoll();
     poll();
 
+    if (m_headless) {
+        g_lua.callGlobalField("g_app", "onRun");
+
+        m_running = true;
+        while (!m_stopping) {
+            g_hitchWatchdog.onFrame();
+
+            mainPoll();
+            poll();
+
+            // the game is event driven; a short sleep keeps dispatcher and
+            // network latency low while idling at a few percent of one core
+            stdext::millisleep(10);
+        }
+
+        g_hitchWatchdog.terminate();
+
+        m_stopping = false;
+        m_running = false;
+        return;
+    }
+
     // show window
     g_window.show();
 
@@ -164,6 +232,10 @@ void GraphicalApplication::run()
                 {
                     std::scoped_lock l(map->getMutex());
                     mapWidget->drawSelf(DrawPoolType::MAP);
+
+                    // triangulate the recorded floor segments on the worker
+                    // threads before the render thread picks the pool up
+                    map->buildCoordsBuffers();
                 }
             } else mapWidget = nullptr;
 
@@ -196,7 +268,12 @@ void GraphicalApplication::run()
     });
 
     m_running = true;
+    uint64_t frameStartMicros = stdext::micros();
     while (!m_stopping) {
+        // heartbeat before anything else so a stall anywhere in the
+        // iteration, polling included, counts towards the hitch threshold
+        g_hitchWatchdog.onFrame();
+
         mainPoll();
 
         if (!g_window.isVisible()) {
@@ -206,11 +283,24 @@ void GraphicalApplication::run()
 
         g_drawPool.draw();
 
+        // capture requests read the finished back buffer before it swaps
+        pollScreenCaptures();
+
         // update screen pixels
         g_window.swapBuffers();
         m_frameCounter.update();
+        g_profiler.onFrame();
+
+        // the counter is drained every frame so a starting benchmark
+        // never sees calls accumulated before it began
+        const uint32_t drawCalls = g_painter->popDrawCallCount();
+        const uint64_t frameEndMicros = stdext::micros();
+        g_benchmark.onFrame(frameEndMicros - frameStartMicros, drawCalls);
+        frameStartMicros = frameEndMicros;
     }
 
+    g_hitchWatchdog.terminate();
+
     t1.join();
     t2.join();
     t3.join();
@@ -222,6 +312,20 @@ void GraphicalApplication::run()
 void GraphicalApplication::poll()
 {
     Application::poll();
+
+    // compute every layout invalidated by the polled events in one go
+    g_ui.flushLayoutUpdates();
+
+    // advance all widget tweens in one batch instead of per-effect timers
+    g_ui.updateTweens();
+
+    // spread lua gc work across frames with a slice of the frame period,
+    // instead of letting full collections spike inside whatever event
+    // happens to trigger them
+    const uint8_t maxFps = m_frameCounter.getMaxFps();
+    const int framePeriod = 1000000 / (maxFps > 0 ? maxFps : 60);
+    g_lua.stepCollectGarbage(std::clamp(framePeriod / 10, 500, 2000));
+
     g_particles.poll();
 
 #ifdef FRAMEWORK_SOUND
@@ -231,12 +335,19 @@ void GraphicalApplication::poll()
 
 void GraphicalApplication::mainPoll()
 {
+    PROFILE_SCOPE("GraphicalApplication::mainPoll");
+
     g_clock.update();
 
-    // poll window input events
-    g_window.poll();
-    g_textures.poll();
+    if (!m_headless) {
+        // poll window input events
+        g_window.poll();
+        g_textures.poll();
+    }
     g_mainDispatcher.poll();
+
+    g_ui.flushLayoutUpdates();
+    g_ui.flushMouseMove();
 }
 
 void GraphicalApplication::close()
@@ -267,7 +378,73 @@ void GraphicalApplication::inputEvent(const InputEvent& event)
     m_onInputEvent = false;
 }
 
-void GraphicalApplication::repaint() { g_drawPool.get(DrawPoolType::FOREGROUND)->repaint(); }
+void GraphicalApplication::takeScreenshot(const std::string& fileName)
+{
+    if (m_headless) {
+        g_logger.warning("takeScreenshot: there is no framebuffer to capture in headless mode");
+        return;
+    }
+
+    std::scoped_lock l(m_screenCaptureMutex);
+    m_screenCaptureRequests.emplace_back(fileName);
+}
+
+void GraphicalApplication::pollScreenCaptures()
+{
+#ifndef OPENGL_ES
+    // captures issued on earlier frames have finished their transfer by
+    // now, mapping them is just a memcpy
+    while (!inflightCaptures.empty()) {
+        auto& capture = inflightCaptures.front();
+        const size_t bytes = static_cast<size_t>(capture.size.area()) * 4;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo);
+        if (auto* mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT))) {
+            const auto& image = std::make_shared<Image>(capture.size, 4, mapped);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            saveCaptureAsync(image, capture.fileName);
+        }
+        glDeleteBuffers(1, &capture.pbo);
+        inflightCaptures.pop_front();
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+    std::vector<std::string> requests;
+    {
+        std::scoped_lock l(m_screenCaptureMutex);
+        requests.swap(m_screenCaptureRequests);
+    }
+    if (requests.empty())
+        return;
+
+    const auto& size = g_graphics.getViewportSize();
+    for (auto& fileName : requests) {
+#ifndef OPENGL_ES
+        ScreenCapture capture{ 0, size, std::move(fileName) };
+        glGenBuffers(1, &capture.pbo);
+        if (capture.pbo != 0) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size.area()) * 4, nullptr, GL_STREAM_READ);
+            glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            inflightCaptures.emplace_back(std::move(capture));
+            continue;
+        }
+        fileName = std::move(capture.fileName);
+#endif
+        // no pack buffers: the readback stalls, but the encode still
+        // happens off the render thread
+        const auto& image = std::make_shared<Image>(size);
+        glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, image->getPixelData());
+        saveCaptureAsync(image, fileName);
+    }
+
+#ifndef OPENGL_ES
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
+void GraphicalApplication::repaint() { if (!m_headless) g_drawPool.get(DrawPoolType::FOREGROUND)->repaint(); }
 bool GraphicalApplication::canDrawTexts() const { return m_drawText && (!g_map.getStaticTexts().empty() || !g_map.getAnimatedTexts().empty()); }
 
 bool GraphicalApplication::isLoadingAsyncTexture() { return m_loadingAsyncTexture || g_game.isUsingProtobuf(); }
@@ -75,14 +75,27 @@ public:
 #endif
     }
 
+    // started with --headless: no window, no GL context, no draw pools and
+    // no render threads; lua, modules, network and map logic run as usual
+    bool isHeadless() { return m_headless; }
+
     void repaint();
 
+    // queues an asynchronous screen capture: the finished frame is read
+    // back through a pixel-pack buffer, mapped a frame later and encoded
+    // to png on a worker, so the render thread never waits on it
+    void takeScreenshot(const std::string& fileName);
+
 protected:
     void resize(const Size& size);
     void inputEvent(const InputEvent& event);
 
 private:
     bool canDrawTexts() const;
+    void pollScreenCaptures();
+
+    std::mutex m_screenCaptureMutex;
+    std::vector<std::string> m_screenCaptureRequests;
 
     bool m_onInputEvent{ false };
     bool m_optimize{ true };
@@ -90,6 +103,7 @@ private:
     bool m_drawEffectOnTop{ false };
     bool m_drawText{ true };
     bool m_loadingAsyncTexture{ false };
+    bool m_headless{ false };
 
     AdaptativeFrameCounter m_frameCounter;
 };
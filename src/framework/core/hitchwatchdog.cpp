@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "hitchwatchdog.h"
+#include "frameprofiler.h"
+
+#include "framework/stdext/time.h"
+
+#if !defined(WIN32) && defined(CRASH_HANDLER)
+#include <csignal>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+HitchWatchdog g_hitchWatchdog;
+
+#if !defined(WIN32) && defined(CRASH_HANDLER)
+namespace {
+    constexpr int HITCH_BACKTRACE_DEPTH = 64;
+
+    pthread_t g_sampledThread;
+    bool g_sampledThreadKnown = false;
+
+    void* g_sampledFrames[HITCH_BACKTRACE_DEPTH];
+    const char* g_sampledZones[FrameProfiler::MAX_ZONE_DEPTH];
+    int g_sampledZoneCount = 0;
+
+    // -1 while idle; the signal handler publishes the captured depth here
+    std::atomic<int> g_sampledFrameCount{ -1 };
+
+    void hitchSignalHandler(int)
+    {
+        // async-signal context: fixed buffers only, no allocation or locks
+        g_sampledZoneCount = g_profiler.snapshotOpenZones(g_sampledZones, FrameProfiler::MAX_ZONE_DEPTH);
+        g_sampledFrameCount.store(backtrace(g_sampledFrames, HITCH_BACKTRACE_DEPTH), std::memory_order_release);
+    }
+}
+#endif
+
+void HitchWatchdog::setEnabled(const bool enable)
+{
+    if (enable == isEnabled())
+        return;
+
+    if (!enable) {
+        stop();
+        return;
+    }
+
+#if !defined(WIN32) && defined(CRASH_HANDLER)
+    struct sigaction sa;
+    sa.sa_handler = &hitchSignalHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &sa, nullptr);
+#endif
+
+    m_lastBeat.store(0, std::memory_order_relaxed);
+    m_stopping = false;
+    m_enabled.store(true, std::memory_order_relaxed);
+    m_thread = std::thread([this] { run(); });
+}
+
+void HitchWatchdog::stop()
+{
+    if (!isEnabled())
+        return;
+
+    m_enabled.store(false, std::memory_order_relaxed);
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+
+#if !defined(WIN32) && defined(CRASH_HANDLER)
+    signal(SIGUSR2, SIG_DFL);
+#endif
+}
+
+void HitchWatchdog::onFrame()
+{
+    if (!isEnabled())
+        return;
+
+#if !defined(WIN32) && defined(CRASH_HANDLER)
+    if (!g_sampledThreadKnown) {
+        g_sampledThread = pthread_self();
+        g_sampledThreadKnown = true;
+    }
+#endif
+
+    // g_clock only advances when the main thread polls, so the watchdog
+    // compares raw ticks instead
+    m_lastBeat.store(stdext::micros(), std::memory_order_release);
+}
+
+void HitchWatchdog::run()
+{
+    uint64_t reportedBeat = 0;
+
+    std::unique_lock lock(m_mutex);
+    while (!m_stopping) {
+        const uint16_t thresholdMs = getThreshold();
+        m_condition.wait_for(lock, std::chrono::milliseconds(std::max<int>(thresholdMs / 4, 10)));
+        if (m_stopping)
+            break;
+
+        const auto beat = m_lastBeat.load(std::memory_order_acquire);
+        if (beat == 0 || beat == reportedBeat)
+            continue; // no heartbeat yet, or this stall is already logged
+
+        const uint64_t now = stdext::micros();
+        if (now - beat < thresholdMs * 1000ull)
+            continue;
+
+        reportedBeat = beat;
+        report(now - beat);
+    }
+}
+
+void HitchWatchdog::report(const uint64_t stalledMicros)
+{
+    std::stringstream ss;
+    ss << stdext::format("== frame hitch, main thread stalled for %llu ms (threshold %u ms)\n",
+                         static_cast<unsigned long long>(stalledMicros / 1000), getThreshold());
+    ss << stdext::format("   date: %s\n", stdext::date_time_string());
+
+#if !defined(WIN32) && defined(CRASH_HANDLER)
+    g_sampledFrameCount.store(-1, std::memory_order_release);
+    if (g_sampledThreadKnown && pthread_kill(g_sampledThread, SIGUSR2) == 0) {
+        // the handler fills the buffers on the stalled thread itself
+        int numLevels = -1;
+        for (int i = 0; i < 100 && (numLevels = g_sampledFrameCount.load(std::memory_order_acquire)) < 0; ++i)
+            stdext::millisleep(1);
+
+        if (g_sampledZoneCount > 0) {
+            ss << "   profiler zones: ";
+            for (int i = 0; i < g_sampledZoneCount; ++i)
+                ss << (i == 0 ? "" : " > ") << g_sampledZones[i];
+            ss << "\n";
+        }
+
+        if (numLevels > 0) {
+            ss << "   backtrace:\n";
+            char** tracebackBuffer = backtrace_symbols(g_sampledFrames, numLevels);
+            if (tracebackBuffer) {
+                // the first frames belong to the signal trampoline
+                for (int i = 2; i < numLevels; ++i) {
+                    std::string line = tracebackBuffer[i];
+                    if (line.find("__libc_start_main") != std::string::npos)
+                        break;
+                    const std::size_t demanglePos = line.find("(_Z");
+                    if (demanglePos != std::string::npos) {
+                        const int len = std::min(line.find_first_of('+', demanglePos + 1), line.find_first_of(')', demanglePos + 1)) - (demanglePos + 1);
+                        const std::string funcName = line.substr(demanglePos + 1, len);
+                        line.replace(demanglePos + 1, len, stdext::demangle_name(funcName.c_str()));
+                    }
+                    ss << "    " << i - 1 << ": " << line << "\n";
+                }
+                free(tracebackBuffer);
+            }
+        } else
+            ss << "   backtrace: sample did not complete\n";
+    }
+#else
+    ss << "   backtrace: unavailable on this platform\n";
+#endif
+
+    g_logger.warning(ss.str());
+
+    const std::string fileName = "hitch_report.log";
+    std::ofstream fout(fileName, std::ios::out | std::ios::app);
+    if (fout.is_open() && fout.good())
+        fout << ss.str() << "\n";
+    else
+        g_logger.error(stdext::format("Failed to append hitch report to %s", fileName));
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/global.h>
+
+#include <condition_variable>
+#include <thread>
+
+class HitchWatchdog;
+extern HitchWatchdog g_hitchWatchdog;
+
+// samples the main thread whenever a frame stays over the threshold and
+// appends the symbolized stack plus the open profiler zone path to
+// hitch_report.log, turning "the client froze for a second" reports into
+// actionable data; idle cost is one atomic store per frame
+// @bindsingleton g_hitchWatchdog
+class HitchWatchdog
+{
+public:
+    void setEnabled(bool enable);
+    bool isEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+    void setThreshold(uint16_t ms) { m_thresholdMs.store(std::max<uint16_t>(ms, 50), std::memory_order_relaxed); }
+    uint16_t getThreshold() { return m_thresholdMs.load(std::memory_order_relaxed); }
+
+    // heartbeat, called once per main loop iteration
+    void onFrame();
+
+    void terminate() { stop(); }
+
+private:
+    void run();
+    void stop();
+    void report(uint64_t stalledMicros);
+
+    std::atomic<bool> m_enabled{ false };
+    std::atomic<uint16_t> m_thresholdMs{ 250 };
+    std::atomic<uint64_t> m_lastBeat{ 0 }; // stdext::micros of the last heartbeat
+
+    bool m_stopping{ false };
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+};
@@ -46,10 +46,19 @@ namespace
 #endif
 }
 
-void Logger::log(Fw::LogLevel level, const std::string_view message)
+Logger::~Logger()
 {
+    stopThread();
+
+    // whatever is still queued goes to the sinks, but the dispatcher is
+    // gone by now so the lua callback must not be scheduled anymore
     std::scoped_lock lock(m_mutex);
+    m_onLog = nullptr;
+    drainQueue();
+}
 
+void Logger::log(Fw::LogLevel level, const std::string_view message)
+{
 #ifdef NDEBUG
     if (level == Fw::LogDebug || level == Fw::LogFine)
         return;
@@ -61,7 +70,109 @@ void Logger::log(Fw::LogLevel level, const std::string_view message)
     if (s_ignoreLogs)
         return;
 
-    std::string outmsg{ std::string{s_logPrefixes[level]} + message.data() };
+    if (level == Fw::LogFatal) {
+        // fatal aborts the process, so everything pending and the message
+        // itself are written synchronously before the error dialog shows up
+        stopThread();
+
+        std::scoped_lock lock(m_mutex);
+        drainQueue();
+        writeMessage(level, message);
+
+        g_window.displayFatalError(message);
+        s_ignoreLogs = true;
+
+        // NOTE: Threads must finish before the process can exit.
+        g_asyncDispatcher.terminate();
+
+        exit(-1);
+    }
+
+    std::call_once(m_threadStarted, [this] { startThread(); });
+
+    // hot threads only pay for the enqueue; formatting and file i/o happen
+    // on the consumer thread. when a burst outruns the consumer the message
+    // is dropped and accounted for instead of blocking the producer.
+    if (!enqueue(level, std::string{ message })) {
+        m_droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_condition.notify_one();
+}
+
+void Logger::startThread()
+{
+    for (std::size_t i = 0; i < ASYNC_QUEUE_SIZE; ++i)
+        m_queue[i].sequence.store(i, std::memory_order_relaxed);
+
+    m_running = true;
+    m_thread = std::thread([this] {
+        std::unique_lock lock(m_mutex);
+        while (m_running) {
+            drainQueue();
+
+            if (const auto dropped = m_droppedMessages.exchange(0, std::memory_order_relaxed); dropped > 0)
+                writeMessage(Fw::LogWarning, stdext::format("logger queue overflowed, %d messages dropped", dropped));
+
+            // the timeout covers notifications that slip between the
+            // producer's notify and this wait
+            m_condition.wait_for(lock, std::chrono::milliseconds(250), [this] { return !m_running || hasPending(); });
+        }
+        drainQueue();
+    });
+}
+
+void Logger::stopThread()
+{
+    m_running = false;
+    m_condition.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+bool Logger::enqueue(Fw::LogLevel level, std::string&& message)
+{
+    auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        auto& slot = m_queue[pos & (ASYNC_QUEUE_SIZE - 1)];
+        const auto seq = slot.sequence.load(std::memory_order_acquire);
+        const auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (dif == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.level = level;
+                slot.message = std::move(message);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (dif < 0) {
+            return false; // full
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Logger::hasPending()
+{
+    const auto& slot = m_queue[m_dequeuePos & (ASYNC_QUEUE_SIZE - 1)];
+    return slot.sequence.load(std::memory_order_acquire) == m_dequeuePos + 1;
+}
+
+void Logger::drainQueue()
+{
+    while (hasPending()) {
+        auto& slot = m_queue[m_dequeuePos & (ASYNC_QUEUE_SIZE - 1)];
+        writeMessage(slot.level, slot.message);
+        slot.message.clear();
+        slot.sequence.store(m_dequeuePos + ASYNC_QUEUE_SIZE, std::memory_order_release);
+        ++m_dequeuePos;
+    }
+}
+
+void Logger::writeMessage(Fw::LogLevel level, const std::string_view message)
+{
+    std::string outmsg{ std::string{s_logPrefixes[level]} + std::string{message} };
 
 #ifdef ANDROID
     __android_log_print(ANDROID_LOG_INFO, "OTClientMobile", "%s", outmsg.c_str());
@@ -86,22 +197,10 @@ void Logger::log(Fw::LogLevel level, const std::string_view message)
                 m_onLog(level, outmsg, now);
         });
     }
-
-    if (level == Fw::LogFatal) {
-        g_window.displayFatalError(message);
-        s_ignoreLogs = true;
-
-        // NOTE: Threads must finish before the process can exit.
-        g_asyncDispatcher.terminate();
-
-        exit(-1);
-    }
 }
 
 void Logger::logFunc(Fw::LogLevel level, const std::string_view message, const std::string_view prettyFunction)
 {
-    std::scoped_lock lock(m_mutex);
-
     auto fncName = prettyFunction.substr(0, prettyFunction.find_first_of('('));
     if (fncName.find_last_of(' ') != std::string::npos)
         fncName = fncName.substr(fncName.find_last_of(' ') + 1);
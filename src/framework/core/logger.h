@@ -24,8 +24,12 @@
 
 #include "../global.h"
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <mutex>
+#include <thread>
 
 struct LogMessage
 {
@@ -40,12 +44,25 @@ class Logger
 {
     enum
     {
-        MAX_LOG_HISTORY = 1000
+        MAX_LOG_HISTORY = 1000,
+        ASYNC_QUEUE_SIZE = 4096 // must be a power of two
+    };
+
+    // slot of the multi-producer single-consumer ring buffer; the sequence
+    // number tells producers whether the slot is free and the consumer
+    // whether it holds a message (Vyukov bounded queue)
+    struct AsyncEntry
+    {
+        std::atomic<std::size_t> sequence{ 0 };
+        Fw::LogLevel level{ Fw::LogDebug };
+        std::string message;
     };
 
     using OnLogCallback = std::function<void(Fw::LogLevel, const std::string_view, int64_t)>;
 
 public:
+    ~Logger();
+
     void log(Fw::LogLevel level, const std::string_view message);
     void logFunc(Fw::LogLevel level, const std::string_view message, const std::string_view prettyFunction);
 
@@ -63,11 +80,27 @@ public:
     Fw::LogLevel getLevel() { return m_level; }
 
 private:
+    void startThread();
+    void stopThread();
+    bool enqueue(Fw::LogLevel level, std::string&& message);
+    bool hasPending();
+    void drainQueue();
+    void writeMessage(Fw::LogLevel level, const std::string_view message);
+
     std::deque<LogMessage> m_logMessages;
     OnLogCallback m_onLog;
     std::ofstream m_outFile;
-    std::recursive_mutex m_mutex;
+    std::mutex m_mutex;
     Fw::LogLevel m_level{ Fw::LogDebug };
+
+    std::array<AsyncEntry, ASYNC_QUEUE_SIZE> m_queue;
+    std::atomic<std::size_t> m_enqueuePos{ 0 };
+    std::size_t m_dequeuePos{ 0 }; // consumer thread only
+    std::atomic<uint32_t> m_droppedMessages{ 0 };
+    std::atomic_bool m_running{ false };
+    std::once_flag m_threadStarted;
+    std::condition_variable m_condition;
+    std::thread m_thread;
 };
 
 extern Logger g_logger;
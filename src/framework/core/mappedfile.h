@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+// read-only file mapped into the address space; the bytes are paged in by
+// the OS on demand and are never copied onto the heap
+class MappedFile
+{
+public:
+    ~MappedFile();
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::string_view view() const { return { reinterpret_cast<const char*>(m_data), m_size }; }
+
+private:
+    // returns nullptr when the file can't be mapped (missing, empty or not
+    // a regular file), so callers can fall back to a buffered read
+    static MappedFilePtr map(const std::string& path);
+
+    const uint8_t* m_data{ nullptr };
+    size_t m_size{ 0 };
+
+#ifdef WIN32
+    void* m_fileHandle{ nullptr };
+    void* m_mappingHandle{ nullptr };
+#endif
+
+    friend class ResourceManager;
+};
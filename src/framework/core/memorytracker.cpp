@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "memorytracker.h"
+
+MemoryTracker g_memory;
+
+MemoryTracker::Counter* MemoryTracker::counter(const char* name)
+{
+    std::scoped_lock lock(m_mutex);
+
+    for (const auto& counter : m_counters) {
+        if (strcmp(counter->name, name) == 0)
+            return counter.get();
+    }
+
+    auto& counter = m_counters.emplace_back(std::make_unique<Counter>());
+    counter->name = name;
+    return counter.get();
+}
+
+void MemoryTracker::registerGauge(const char* name, std::function<uint64_t()> poll)
+{
+    std::scoped_lock lock(m_mutex);
+    m_gauges.emplace_back(Gauge{ name, std::move(poll) });
+}
+
+std::vector<std::tuple<std::string, uint64_t, uint64_t, uint64_t>> MemoryTracker::getCounters()
+{
+    std::scoped_lock lock(m_mutex);
+
+    std::vector<std::tuple<std::string, uint64_t, uint64_t, uint64_t>> ret;
+    ret.reserve(m_counters.size() + m_gauges.size());
+
+    for (const auto& counter : m_counters) {
+        // a racy add/remove pair may briefly show negative, clamp instead
+        // of confusing the reader with a huge unsigned value
+        const auto bytes = std::max<int64_t>(0, counter->bytes.load(std::memory_order_relaxed));
+        const auto count = std::max<int64_t>(0, counter->count.load(std::memory_order_relaxed));
+        ret.emplace_back(counter->name, bytes, count, counter->peakBytes.load(std::memory_order_relaxed));
+    }
+
+    for (auto& gauge : m_gauges) {
+        const uint64_t bytes = gauge.poll();
+        gauge.peak = std::max(gauge.peak, bytes);
+        ret.emplace_back(gauge.name, bytes, 0, gauge.peak);
+    }
+
+    return ret;
+}
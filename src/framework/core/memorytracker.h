@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/global.h>
+
+class MemoryTracker;
+extern MemoryTracker g_memory;
+
+// per-subsystem memory attribution; subsystems either own a Counter they
+// add/remove exact bytes on as allocations happen, or register a gauge
+// polled at query time when they already account their own usage
+// @bindsingleton g_memory
+class MemoryTracker
+{
+public:
+    struct Counter
+    {
+        const char* name;
+        std::atomic<int64_t> bytes{ 0 };
+        std::atomic<int64_t> count{ 0 };
+        std::atomic<int64_t> peakBytes{ 0 };
+
+        void add(const int64_t size)
+        {
+            count.fetch_add(1, std::memory_order_relaxed);
+            const int64_t now = bytes.fetch_add(size, std::memory_order_relaxed) + size;
+            int64_t peak = peakBytes.load(std::memory_order_relaxed);
+            while (now > peak && !peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed));
+        }
+
+        void remove(const int64_t size)
+        {
+            count.fetch_sub(1, std::memory_order_relaxed);
+            bytes.fetch_sub(size, std::memory_order_relaxed);
+        }
+    };
+
+    // names must be string literals, only the pointer is stored; the
+    // returned counter lives for the whole process so call sites may keep
+    // it in a static
+    Counter* counter(const char* name);
+
+    // for subsystems that already track their usage; polled on query from
+    // the main thread
+    void registerGauge(const char* name, std::function<uint64_t()> poll);
+
+    // (name, bytes, live count, peak bytes); gauges report a zero count
+    // and their peak only advances when queried
+    std::vector<std::tuple<std::string, uint64_t, uint64_t, uint64_t>> getCounters();
+
+private:
+    struct Gauge
+    {
+        const char* name;
+        std::function<uint64_t()> poll;
+        uint64_t peak{ 0 };
+    };
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Counter>> m_counters;
+    std::vector<Gauge> m_gauges;
+};
@@ -21,6 +21,7 @@
  */
 
 #include "module.h"
+#include "asyncdispatcher.h"
 #include "modulemanager.h"
 #include "resourcemanager.h"
 
@@ -62,9 +63,20 @@ bool Module::load()
         if (m_sandboxed)
             g_lua.setGlobalEnvironment(m_sandboxEnv);
 
-        for (const std::string& script : m_scripts) {
-            g_lua.loadScript(script);
-            g_lua.safeCall(0, 0);
+        if (m_scriptsPrefetch.valid()) {
+            for (const auto& script : m_scriptsPrefetch.get()) {
+                if (script.source.empty())
+                    g_lua.loadScript(script.file); // re-read, reporting the error
+                else
+                    g_lua.loadBuffer(script.buffer, script.source);
+                g_lua.safeCall(0, 0);
+            }
+            m_scriptsPrefetch = {};
+        } else {
+            for (const std::string& script : m_scripts) {
+                g_lua.loadScript(script);
+                g_lua.safeCall(0, 0);
+            }
         }
 
         const auto& onLoadBuffer = std::get<0>(m_onLoadFunc);
@@ -154,6 +166,29 @@ bool Module::reload()
     return load();
 }
 
+void Module::prefetchScripts()
+{
+    if (m_loaded || !m_enabled || m_scripts.empty() || m_scriptsPrefetch.valid())
+        return;
+
+    m_scriptsPrefetch = g_asyncDispatcher.schedule([scripts = m_scripts] {
+        std::vector<PrefetchedScript> result;
+        result.reserve(scripts.size());
+        for (const auto& script : scripts) {
+            auto& entry = result.emplace_back();
+            entry.file = script;
+            try {
+                const auto& filePath = g_resources.guessFilePath(script, "lua");
+                entry.buffer = g_resources.readFileContents(filePath);
+                entry.source = "@" + filePath;
+            } catch (const stdext::exception&) {
+                // load() falls back to the normal path, which reports the error
+            }
+        }
+        return result;
+    });
+}
+
 bool Module::isDependent() const
 {
     for (const ModulePtr& module : g_modules.getModules()) {
@@ -24,6 +24,8 @@
 
 #include "declarations.h"
 
+#include <future>
+
 #include <framework/luaengine/luaobject.h>
 #include <framework/otml/declarations.h>
 
@@ -61,9 +63,17 @@ public:
 
 protected:
     void discover(const OTMLNodePtr& moduleNode);
+    void prefetchScripts();
     friend class ModuleManager;
 
 private:
+    struct PrefetchedScript
+    {
+        std::string file;    // script path as listed in the .otmod
+        std::string source;  // "@" + resolved path, empty when the read failed
+        std::string buffer;
+    };
+
     bool m_enabled{ true };
     bool m_loaded{ false };
     bool m_autoLoad{ false };
@@ -83,6 +93,9 @@ private:
     std::function<void()> m_unloadCallback;
     std::list<std::string> m_dependencies;
     std::list<std::string> m_scripts;
+    // script contents read ahead on the async dispatcher, so load() only
+    // compiles and executes (see ModuleManager::autoLoadModules)
+    std::shared_future<std::vector<PrefetchedScript>> m_scriptsPrefetch;
     std::list<std::string> m_loadLaterModules;
     std::list<Platform::Device> m_supportedDevices;
 };
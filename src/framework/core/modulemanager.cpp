@@ -21,6 +21,7 @@
  */
 
 #include "modulemanager.h"
+#include "asyncdispatcher.h"
 #include "resourcemanager.h"
 
 #include <framework/core/application.h>
@@ -39,15 +40,31 @@ void ModuleManager::discoverModules()
     // remove modules that are not loaded
     m_autoLoadModules.clear();
 
+    // parse every .otmod in parallel; module registration stays sequential
+    // because it touches the lua state
+    std::vector<std::shared_future<OTMLDocumentPtr>> parsedModules;
     const auto& moduleDirs = g_resources.listDirectoryFiles("/");
     for (const auto& moduleDir : moduleDirs) {
         const auto& moduleFiles = g_resources.listDirectoryFiles("/" + moduleDir);
         for (const auto& moduleFile : moduleFiles) {
             if (g_resources.isFileType(moduleFile, "otmod")) {
-                if (const auto& module = discoverModule("/" + moduleDir + "/" + moduleFile)) {
-                    if (module->isAutoLoad())
-                        m_autoLoadModules.emplace(module->getAutoLoadPriority(), module);
-                }
+                parsedModules.emplace_back(g_asyncDispatcher.schedule([moduleFile = "/" + moduleDir + "/" + moduleFile]() -> OTMLDocumentPtr {
+                    try {
+                        return OTMLDocument::parse(moduleFile);
+                    } catch (const stdext::exception& e) {
+                        g_logger.error(stdext::format("Unable to discover module from file '%s': %s", moduleFile, e.what()));
+                        return nullptr;
+                    }
+                }));
+            }
+        }
+    }
+
+    for (const auto& parsedModule : parsedModules) {
+        if (const auto& doc = parsedModule.get()) {
+            if (const auto& module = discoverModule(doc)) {
+                if (module->isAutoLoad())
+                    m_autoLoadModules.emplace(module->getAutoLoadPriority(), module);
             }
         }
     }
@@ -55,6 +72,15 @@ void ModuleManager::discoverModules()
 
 void ModuleManager::autoLoadModules(int maxPriority)
 {
+    // queue the script reads of every module we are about to load, the
+    // ordered load loop below then mostly just compiles and executes
+    for (const auto& [priority, module] : m_autoLoadModules) {
+        if (priority > maxPriority)
+            break;
+
+        module->prefetchScripts();
+    }
+
     for (const auto& [priority, module] : m_autoLoadModules) {
         if (priority > maxPriority)
             break;
@@ -64,10 +90,19 @@ void ModuleManager::autoLoadModules(int maxPriority)
 }
 
 ModulePtr ModuleManager::discoverModule(const std::string& moduleFile)
+{
+    try {
+        return discoverModule(OTMLDocument::parse(moduleFile));
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("Unable to discover module from file '%s': %s", moduleFile, e.what()));
+        return nullptr;
+    }
+}
+
+ModulePtr ModuleManager::discoverModule(const OTMLDocumentPtr& doc)
 {
     ModulePtr module;
     try {
-        const auto& doc = OTMLDocument::parse(moduleFile);
         const auto& moduleNode = doc->at("Module");
         const auto& name = moduleNode->valueAt("name");
 
@@ -82,7 +117,7 @@ ModulePtr ModuleManager::discoverModule(const std::string& moduleFile)
         if (push)
             m_modules.emplace_back(module);
     } catch (const stdext::exception& e) {
-        g_logger.error(stdext::format("Unable to discover module from file '%s': %s", moduleFile, e.what()));
+        g_logger.error(stdext::format("Unable to discover module from file '%s': %s", doc->source(), e.what()));
     }
     return module;
 }
@@ -120,6 +155,53 @@ void ModuleManager::reloadModules()
         module->load();
 }
 
+bool ModuleManager::reloadModule(const std::string_view moduleName)
+{
+    const auto& module = getModule(moduleName);
+    if (!module) {
+        g_logger.error(stdext::format("Unable to reload module '%s': module not found", moduleName));
+        return false;
+    }
+
+    if (!module->isLoaded())
+        return module->load();
+
+    if (!module->isReloadable()) {
+        g_logger.error(stdext::format("Unable to reload module '%s': module is not reloadable", moduleName));
+        return false;
+    }
+
+    // collect the module and every loaded module that depends on it; the
+    // walk keeps m_modules order (most recently loaded first), so dependents
+    // are torn down before what they depend on, while every other module
+    // keeps its widgets and lua state untouched
+    std::deque<ModulePtr> reloadList;
+    for (const ModulePtr& m : m_modules) {
+        if (!m->isLoaded() || (m != module && !m->hasDependency(moduleName, true)))
+            continue;
+
+        if (!m->isReloadable()) {
+            g_logger.error(stdext::format("Unable to reload module '%s': '%s' depends on it and is not reloadable", moduleName, m->getName()));
+            return false;
+        }
+
+        reloadList.emplace_back(m);
+    }
+
+    for (const ModulePtr& m : reloadList)
+        m->unload();
+
+    // loading goes back in dependency order; scripts that did not change
+    // come straight from the compiled-bytecode cache, confining the reload
+    // cost to the edited files
+    bool ok = true;
+    for (auto it = reloadList.rbegin(); it != reloadList.rend(); ++it) {
+        if (!(*it)->load())
+            ok = false;
+    }
+    return ok;
+}
+
 ModulePtr ModuleManager::getModule(const std::string_view moduleName)
 {
     for (const ModulePtr& module : m_modules)
@@ -33,9 +33,11 @@ public:
     void discoverModules();
     void autoLoadModules(int maxPriority);
     ModulePtr discoverModule(const std::string& moduleFile);
+    ModulePtr discoverModule(const OTMLDocumentPtr& doc);
     void ensureModuleLoaded(const std::string_view moduleName);
     void unloadModules();
     void reloadModules();
+    bool reloadModule(const std::string_view moduleName);
 
     ModulePtr getModule(const std::string_view moduleName);
     std::deque<ModulePtr> getModules() { return m_modules; }
@@ -24,8 +24,13 @@
 
 #include "resourcemanager.h"
 #include "filestream.h"
+#include "mappedfile.h"
 
 #include <framework/core/application.h>
+#include <framework/core/eventdispatcher.h>
+#include <framework/graphics/apngloader.h>
+#include <framework/graphics/image.h>
+#include <framework/graphics/texturemanager.h>
 #include <framework/luaengine/luainterface.h>
 #include <framework/platform/platform.h>
 #include <framework/net/protocolhttp.h>
@@ -42,9 +47,54 @@ void ResourceManager::init(const char* argv0)
 
 void ResourceManager::terminate()
 {
+    m_assetBundle.reset();
+    m_mappedFiles.clear();
     PHYSFS_deinit();
 }
 
+bool ResourceManager::mountAssetBundle(const std::string& bundleFile)
+{
+    // the bundle lives on the real filesystem; try the path as given and
+    // relative to the work dir
+    auto mapped = MappedFile::map(bundleFile);
+    if (!mapped && !m_workDir.empty())
+        mapped = MappedFile::map(m_workDir + bundleFile);
+    if (!mapped)
+        return false;
+
+    auto bundle = std::make_unique<AssetBundle>(std::move(mapped));
+    if (!bundle->isOpen()) {
+        g_logger.error(stdext::format("'%s' is not a valid asset bundle", bundleFile));
+        return false;
+    }
+
+    g_logger.debug(stdext::format("Mounted asset bundle '%s' with %d entries", bundleFile, bundle->getEntryCount()));
+    m_assetBundle = std::move(bundle);
+    return true;
+}
+
+bool ResourceManager::buildAssetBundle(const std::string& bundleFile)
+{
+    std::vector<std::pair<std::string, std::string>> files;
+    for (const auto& path : listDirectoryFiles("/", true, false, true)) {
+        if (directoryExists(path) || path.find("/downloads") != std::string::npos)
+            continue;
+        try {
+            files.emplace_back(path, readFileContents(path));
+        } catch (const std::exception& e) {
+            g_logger.warning(stdext::format("skipping '%s' while bundling: %s", path, e.what()));
+        }
+    }
+
+    if (!AssetBundle::build(bundleFile, files)) {
+        g_logger.error(stdext::format("Unable to write asset bundle '%s'", bundleFile));
+        return false;
+    }
+
+    g_logger.info(stdext::format("Packed %d files into '%s'", files.size(), bundleFile));
+    return true;
+}
+
 bool ResourceManager::discoverWorkDir(const std::string& existentFile)
 {
     // search for modules directory
@@ -68,6 +118,11 @@ bool ResourceManager::discoverWorkDir(const std::string& existentFile)
         PHYSFS_unmount(dir.c_str());
     }
 
+    // a packed bundle next to the work dir is preferred over the loose
+    // data files it was built from
+    if (found)
+        mountAssetBundle("data.otab");
+
     return found;
 }
 
@@ -164,6 +219,9 @@ bool ResourceManager::fileExists(const std::string& fileName)
     if (fileName.find("/downloads") != std::string::npos)
         return g_http.getFile(fileName.substr(10)) != nullptr;
 
+    if (m_assetBundle && m_assetBundle->find(resolvePath(fileName)))
+        return true;
+
     return (PHYSFS_exists(resolvePath(fileName).c_str()) && !directoryExists(fileName));
 }
 
@@ -202,6 +260,12 @@ std::string ResourceManager::readFileContents(const std::string& fileName)
             return std::string(dfile->response.begin(), dfile->response.end());
     }
 
+    // the bundle stores final contents, so no decryption pass is needed
+    if (m_assetBundle) {
+        if (const auto* entry = m_assetBundle->find(fullPath))
+            return m_assetBundle->read(*entry);
+    }
+
     PHYSFS_File* file = PHYSFS_openRead(fullPath.c_str());
     if (!file)
         throw Exception("unable to open file '%s': %s", fullPath, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
@@ -218,6 +282,104 @@ std::string ResourceManager::readFileContents(const std::string& fileName)
     return buffer;
 }
 
+MappedFilePtr ResourceManager::mapFile(const std::string& fileName)
+{
+#if ENABLE_ENCRYPTION == 1
+    // contents on disk are encrypted and must go through decrypt()
+    return nullptr;
+#else
+    const std::string fullPath = resolvePath(fileName);
+    if (fullPath.find("/downloads") != std::string::npos)
+        return nullptr;
+
+    // files inside package archives report the archive as their real dir,
+    // only files living in a plain directory can be mapped
+    const char* realDir = PHYSFS_getRealDir(fullPath.c_str());
+    if (!realDir)
+        return nullptr;
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(realDir, ec))
+        return nullptr;
+
+    return MappedFile::map(std::string(realDir) + fullPath);
+#endif
+}
+
+std::string_view ResourceManager::readFileView(const std::string& fileName)
+{
+    const std::string fullPath = resolvePath(fileName);
+
+    // keep the mapping alive in the manager so the handed out view stays
+    // valid; mappings only reserve address space, the OS pages them lazily
+    if (const auto it = m_mappedFiles.find(fullPath); it != m_mappedFiles.end())
+        return it->second->view();
+
+    // raw bundle entries are views into the bundle mapping already
+    if (m_assetBundle) {
+        if (const auto* entry = m_assetBundle->find(fullPath)) {
+            if (const auto& view = m_assetBundle->view(*entry); !view.empty())
+                return view;
+        }
+    }
+
+    if (const auto& mapped = mapFile(fileName)) {
+        m_mappedFiles.emplace(fullPath, mapped);
+        return mapped->view();
+    }
+
+    return {};
+}
+
+std::shared_future<void> ResourceManager::prefetch(const std::vector<std::string>& paths, const AsyncDispatcher::Priority priority)
+{
+    struct PrefetchState
+    {
+        std::promise<void> done;
+        std::atomic_int pending{ 0 };
+    };
+
+    const auto& state = std::make_shared<PrefetchState>();
+    state->pending = paths.size();
+
+    auto future = state->done.get_future().share();
+    if (paths.empty()) {
+        state->done.set_value();
+        return future;
+    }
+
+    for (const auto& path : paths) {
+        g_asyncDispatcher.dispatch([this, path, state] {
+            try {
+                if (path.ends_with(".png")) {
+                    // decode here so the first real use only uploads; animated
+                    // textures keep decoding in getTexture, their frames don't
+                    // fit the static cache
+                    std::stringstream fin;
+                    readFileStream(path, fin);
+                    if (apng_data apng; load_apng(fin, &apng) == 0) {
+                        if (apng.num_frames == 1) {
+                            const auto& image = std::make_shared<Image>(Size(apng.width, apng.height), apng.bpp, apng.pdata);
+                            g_dispatcher.addEvent([path, image] { g_textures.preload(path, image); });
+                        }
+                        free_apng(&apng);
+                    }
+                } else {
+                    // just pull the bytes through the OS cache
+                    readFileContents(path);
+                }
+            } catch (const std::exception& e) {
+                g_logger.error(stdext::format("Failed to prefetch '%s': %s", path, e.what()));
+            }
+
+            if (--state->pending == 0)
+                state->done.set_value();
+        }, priority);
+    }
+
+    return future;
+}
+
 bool ResourceManager::writeFileBuffer(const std::string& fileName, const uint8_t* data, uint32_t size)
 {
     PHYSFS_file* file = PHYSFS_openWrite(fileName.c_str());
@@ -231,6 +393,40 @@ bool ResourceManager::writeFileBuffer(const std::string& fileName, const uint8_t
     return true;
 }
 
+bool ResourceManager::writeFileAtomically(const std::string& fileName, const std::string& data)
+{
+    const auto& tmpName = fileName + ".tmp";
+    if (!writeFileContents(tmpName, data))
+        return false;
+
+    // physfs writes always land in the write directory, rename inside it
+    std::error_code ec;
+    std::filesystem::rename(m_writeDir + tmpName, m_writeDir + fileName, ec);
+    if (ec) {
+        // fall back to a plain write rather than losing the data
+        PHYSFS_delete(tmpName.c_str());
+        return writeFileContents(fileName, data);
+    }
+    return true;
+}
+
+bool ResourceManager::writeFileBufferAtomically(const std::string& fileName, const uint8_t* data, uint32_t size)
+{
+    const auto& tmpName = fileName + ".tmp";
+    if (!writeFileBuffer(tmpName, data, size))
+        return false;
+
+    // physfs writes always land in the write directory, rename inside it
+    std::error_code ec;
+    std::filesystem::rename(m_writeDir + tmpName, m_writeDir + fileName, ec);
+    if (ec) {
+        // fall back to a plain write rather than losing the data
+        PHYSFS_delete(tmpName.c_str());
+        return writeFileBuffer(fileName, data, size);
+    }
+    return true;
+}
+
 bool ResourceManager::writeFileStream(const std::string& fileName, std::iostream& in)
 {
     const std::streampos oldPos = in.tellg();
@@ -257,6 +453,16 @@ FileStreamPtr ResourceManager::openFile(const std::string& fileName)
 {
     const std::string fullPath = resolvePath(fileName);
 
+    if (m_assetBundle) {
+        if (const auto* entry = m_assetBundle->find(fullPath))
+            return std::make_shared<FileStream>(fullPath, m_assetBundle->read(*entry));
+    }
+
+    // files on the real filesystem are served straight from an OS mapping,
+    // skipping the PHYSFS read copy entirely
+    if (const auto& mapped = mapFile(fileName))
+        return std::make_shared<FileStream>(fullPath, mapped);
+
     PHYSFS_File* file = PHYSFS_openRead(fullPath.c_str());
     if (!file)
         throw Exception("unable to open file '%s': %s", fullPath, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
@@ -279,6 +485,13 @@ FileStreamPtr ResourceManager::createFile(const std::string& fileName) const
     return { std::make_shared<FileStream>(fileName, file, true) };
 }
 
+FileStreamPtr ResourceManager::createBufferedFile(const std::string& fileName) const
+{
+    // all writes coalesce in memory and only touch the disk on
+    // FileStream::flushAsync(), which commits atomically off the main thread
+    return { std::make_shared<FileStream>(fileName) };
+}
+
 bool ResourceManager::deleteFile(const std::string& fileName)
 {
     return PHYSFS_delete(resolvePath(fileName).c_str()) != 0;
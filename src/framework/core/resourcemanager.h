@@ -23,8 +23,12 @@
 #pragma once
 
 #include <filesystem>
+#include "assetbundle.h"
+#include "asyncdispatcher.h"
 #include "declarations.h"
 
+#include "../stdext/storage.h"
+
  // @bindsingleton g_resources
 class ResourceManager
 {
@@ -42,6 +46,14 @@ public:
     bool removeSearchPath(const std::string& path);
     void searchAndAddPackages(const std::string& packagesDir, const std::string& packageExt);
 
+    // packed asset bundle: when mounted, lookups and reads are served from
+    // its single mapped file before falling back to the PHYSFS search path
+    bool mountAssetBundle(const std::string& bundleFile);
+    void unmountAssetBundle() { m_assetBundle.reset(); }
+    // packs everything reachable on the current search path into a bundle
+    // on the real filesystem
+    bool buildAssetBundle(const std::string& bundleFile);
+
     bool fileExists(const std::string& fileName);
     bool directoryExists(const std::string& directoryName);
 
@@ -49,15 +61,34 @@ public:
     void readFileStream(const std::string& fileName, std::iostream& out);
     std::string readFileContents(const std::string& fileName);
     // @dontbind
+    // zero-copy view of a file living directly on the real filesystem; the
+    // mapping stays alive in the manager, empty view when not mappable
+    std::string_view readFileView(const std::string& fileName);
+    // @dontbind
+    MappedFilePtr mapFile(const std::string& fileName);
+    // @dontbind
+    // queues background reads of the given paths on the async dispatcher
+    // workers; static png files are also decoded and handed to the texture
+    // manager, so their first real use only uploads. the returned future
+    // completes once every path has been warmed.
+    std::shared_future<void> prefetch(const std::vector<std::string>& paths, AsyncDispatcher::Priority priority = AsyncDispatcher::Priority::LOW);
+    // @dontbind
     bool writeFileBuffer(const std::string& fileName, const uint8_t* data, uint32_t size);
     bool writeFileContents(const std::string& fileName, const std::string& data);
     // @dontbind
+    // writes to a temporary sibling and renames it over the target, so a
+    // crash mid-write can never leave a truncated file behind
+    bool writeFileAtomically(const std::string& fileName, const std::string& data);
+    // @dontbind
+    bool writeFileBufferAtomically(const std::string& fileName, const uint8_t* data, uint32_t size);
+    // @dontbind
     bool writeFileStream(const std::string& fileName, std::iostream& in);
 
     // String_view Support
     FileStreamPtr openFile(const std::string& fileName);
     FileStreamPtr appendFile(const std::string& fileName) const;
     FileStreamPtr createFile(const std::string& fileName) const;
+    FileStreamPtr createBufferedFile(const std::string& fileName) const;
     bool deleteFile(const std::string& fileName);
 
     bool makeDir(const std::string& directory);
@@ -90,6 +121,8 @@ private:
     std::string m_workDir;
     std::string m_writeDir;
     std::deque<std::string> m_searchPaths;
+    stdext::map<std::string, MappedFilePtr> m_mappedFiles;
+    std::unique_ptr<AssetBundle> m_assetBundle;
 };
 
 extern ResourceManager g_resources;
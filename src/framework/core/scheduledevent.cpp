@@ -22,7 +22,7 @@
 
 #include "scheduledevent.h"
 
-ScheduledEvent::ScheduledEvent(const std::function<void()>& callback, int delay, int maxCycles) : Event(callback),
+ScheduledEvent::ScheduledEvent(stdext::small_function<void()> callback, int delay, int maxCycles) : Event(std::move(callback)),
 m_ticks(g_clock.millis() + delay), m_delay(delay), m_maxCycles(maxCycles) {}
 
 void ScheduledEvent::execute()
@@ -29,7 +29,7 @@
 class ScheduledEvent : public Event
 {
 public:
-    ScheduledEvent(const std::function<void()>& callback, int delay, int maxCycles);
+    ScheduledEvent(stdext::small_function<void()> callback, int delay, int maxCycles);
     void execute() override;
     void postpone() { m_ticks = g_clock.millis() + m_delay; }
     bool nextCycle();
@@ -40,14 +40,6 @@ public:
     int cyclesExecuted() { return m_cyclesExecuted; }
     int maxCycles() { return m_maxCycles; }
 
-    struct Compare
-    {
-        bool operator() (const ScheduledEventPtr& a, const ScheduledEventPtr& b) const
-        {
-            return b->ticks() < a->ticks();
-        }
-    };
-
 private:
     ticks_t m_ticks;
     int m_delay;
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "timerwheel.h"
+
+void TimerWheel::add(const ScheduledEventPtr& event)
+{
+    if (m_currentTick < 0)
+        m_currentTick = g_clock.millis();
+
+    insert(event, event->ticks());
+}
+
+void TimerWheel::insert(const ScheduledEventPtr& event, ticks_t ticks)
+{
+    ticks_t diff = ticks - m_currentTick;
+    if (diff < 1) {
+        // already due, fire on the next advanced millisecond
+        ticks = m_currentTick + 1;
+        diff = 1;
+    }
+
+    constexpr ticks_t maxSpan = static_cast<ticks_t>(1) << (WHEEL_BITS * WHEEL_LEVELS);
+    if (diff >= maxSpan) {
+        // too far ahead for the wheel span; park it in the furthest slot of
+        // the top level, it will cascade closer on every rotation
+        ticks = m_currentTick + maxSpan - 1;
+        diff = maxSpan - 1;
+    }
+
+    int level = 0;
+    while (diff >= static_cast<ticks_t>(WHEEL_SIZE) << (WHEEL_BITS * level))
+        ++level;
+
+    const int slot = (ticks >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    m_slots[level][slot].emplace_back(event);
+    ++m_size;
+}
+
+void TimerWheel::cascade(const int level, const int slot)
+{
+    auto& events = m_slots[level][slot];
+    if (events.empty())
+        return;
+
+    const auto pending = std::move(events);
+    events.clear();
+    m_size -= pending.size();
+
+    // reinsert by the remaining time, dropping each event a level closer to
+    // (or into) the expiry wheel; an event due exactly at this wrap boundary
+    // goes straight into the slot poll() is about to drain
+    for (const auto& event : pending) {
+        const ticks_t ticks = event->ticks();
+        if (ticks <= m_currentTick) {
+            m_slots[0][m_currentTick & WHEEL_MASK].emplace_back(event);
+            ++m_size;
+        } else
+            insert(event, ticks);
+    }
+}
+
+void TimerWheel::poll(std::vector<ScheduledEventPtr>& expired)
+{
+    const ticks_t now = g_clock.millis();
+    if (m_currentTick < 0 || m_size == 0) {
+        m_currentTick = now;
+        return;
+    }
+
+    while (m_currentTick < now) {
+        ++m_currentTick;
+
+        const int slot = m_currentTick & WHEEL_MASK;
+        if (slot == 0) {
+            // a full rotation completed, pull the next slot of each upper
+            // level down until one of them did not wrap as well
+            for (int level = 1; level < WHEEL_LEVELS; ++level) {
+                const int upperSlot = (m_currentTick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+                cascade(level, upperSlot);
+                if (upperSlot != 0)
+                    break;
+            }
+        }
+
+        auto& events = m_slots[0][slot];
+        if (events.empty())
+            continue;
+
+        m_size -= events.size();
+        expired.insert(expired.end(), std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()));
+        events.clear();
+    }
+}
+
+std::vector<ScheduledEventPtr> TimerWheel::takeAll()
+{
+    std::vector<ScheduledEventPtr> pending;
+    pending.reserve(m_size);
+
+    for (auto& level : m_slots) {
+        for (auto& events : level) {
+            pending.insert(pending.end(), std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()));
+            events.clear();
+        }
+    }
+
+    m_size = 0;
+    return pending;
+}
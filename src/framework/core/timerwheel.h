@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "scheduledevent.h"
+
+// hierarchical timer wheel with millisecond slots; insertion is O(1) and
+// advancing only touches the slots whose deadline actually passed, unlike a
+// priority queue which sifts on every insert and pop
+class TimerWheel
+{
+public:
+    enum
+    {
+        WHEEL_BITS = 6,
+        WHEEL_SIZE = 1 << WHEEL_BITS, // 64 slots per level
+        WHEEL_MASK = WHEEL_SIZE - 1,
+        WHEEL_LEVELS = 4 // 64^4 ms, about 4.6 hours before a timer cascades twice
+    };
+
+    void add(const ScheduledEventPtr& event);
+
+    // advances the wheel up to the current clock, appending every expired
+    // event to the output in deadline order
+    void poll(std::vector<ScheduledEventPtr>& expired);
+
+    // removes every pending event, used on shutdown to cancel them
+    std::vector<ScheduledEventPtr> takeAll();
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+private:
+    void insert(const ScheduledEventPtr& event, ticks_t ticks);
+    void cascade(int level, int slot);
+
+    std::vector<ScheduledEventPtr> m_slots[WHEEL_LEVELS][WHEEL_SIZE];
+    ticks_t m_currentTick{ -1 };
+    size_t m_size{ 0 };
+};
@@ -23,9 +23,11 @@
 #ifdef ANDROID
 
 #include "unzipper.h"
+#include "asyncdispatcher.h"
 #include "logger.h"
 #include "resourcemanager.h"
 #include <filesystem>
+#include <thread>
 #include <ioapi.h>
 #include <ioapi_mem.h>
 #include <unzip.h>
@@ -34,20 +36,82 @@ const int MAX_FILENAME = 512;
 const int READ_SIZE = 8192;
 const char dir_delimiter = '/';
 
+namespace {
+
+struct ZipEntry
+{
+    unz_file_pos pos;
+    std::string name;
+};
+
+// minizip handles are not thread safe, so every worker opens its own unzFile
+// over the same shared archive buffer (ioapi_mem never takes ownership of it)
+unzFile openZipBuffer(const char* fileBuffer, uint fileLength, ourmemory_t& unzmem)
+{
+    zlib_filefunc_def filefunc32 = { nullptr };
+    unzmem.size = fileLength;
+    unzmem.base = const_cast<char*>(fileBuffer);
+    fill_memory_filefunc(&filefunc32, &unzmem);
+    return unzOpen2(nullptr, &filefunc32);
+}
+
+// inflates the given entries, streaming each one straight to its destination
+// file in READ_SIZE chunks; returns an empty string on success or the first
+// error, fatals are left to the calling thread
+std::string extractEntries(const char* fileBuffer, uint fileLength, const std::string& destinationPath, const std::vector<ZipEntry>& entries)
+{
+    ourmemory_t unzmem = { nullptr };
+    unzFile zipfile = openZipBuffer(fileBuffer, fileLength, unzmem);
+    if (zipfile == nullptr)
+        return "could not open archive";
+
+    char read_buffer[READ_SIZE];
+    for (const auto& entry : entries) {
+        unz_file_pos pos = entry.pos;
+        if (unzGoToFilePos(zipfile, &pos) != UNZ_OK || unzOpenCurrentFile(zipfile) != UNZ_OK) {
+            unzClose(zipfile);
+            return "could not open file " + entry.name;
+        }
+
+        FILE* out = fopen((destinationPath + entry.name).c_str(), "wb");
+        if (out == nullptr) {
+            unzCloseCurrentFile(zipfile);
+            unzClose(zipfile);
+            return "could not open destination file " + entry.name;
+        }
+
+        int error;
+        do {
+            error = unzReadCurrentFile(zipfile, read_buffer, READ_SIZE);
+            if (error > 0)
+                fwrite(read_buffer, error, 1, out);
+        } while (error > 0);
+
+        fclose(out);
+        unzCloseCurrentFile(zipfile);
+
+        if (error < 0) {
+            unzClose(zipfile);
+            return "could not read file " + entry.name;
+        }
+    }
+
+    unzClose(zipfile);
+    return {};
+}
+
+}
+
 void unzipper::extract(const char* fileBuffer, uint fileLength, std::string& destinationPath) {
     const std::filesystem::path destinationFolder { destinationPath };
     if (!std::filesystem::exists(destinationFolder)) {
         std::filesystem::create_directory(destinationFolder);
     }
 
-    zlib_filefunc_def filefunc32 = { nullptr };
-    ourmemory_t unzmem = {nullptr};
-
-    unzmem.size = fileLength;
-    unzmem.base = (char *)malloc(unzmem.size);
-    memcpy(unzmem.base, fileBuffer, unzmem.size);
-    fill_memory_filefunc(&filefunc32, &unzmem);
-    unzFile zipfile = unzOpen2(nullptr, &filefunc32);
+    ourmemory_t unzmem = { nullptr };
+    unzFile zipfile = openZipBuffer(fileBuffer, fileLength, unzmem);
+    if (zipfile == nullptr)
+        g_logger.fatal("could not open archive");
 
     // Get info about the zip file
     unz_global_info global_info;
@@ -57,11 +121,11 @@ void unzipper::extract(const char* fileBuffer, uint fileLength, std::string& des
         g_logger.fatal("could not read file global info");
     }
 
-    uint readSize = 8192;
-    // Buffer to hold data read from the zip file.
-    char read_buffer[ readSize ];
+    // First pass only walks the central directory: directories are created
+    // right away, file entries are collected to be handed out to the workers.
+    std::vector<ZipEntry> files;
+    files.reserve(global_info.number_entry);
 
-    // Loop to extract all files
     u_long i;
     for ( i = 0; i < global_info.number_entry; ++i )
     {
@@ -87,46 +151,12 @@ void unzipper::extract(const char* fileBuffer, uint fileLength, std::string& des
         }
         else
         {
-            // Entry is a file, so extract it.
-            if ( unzOpenCurrentFile( zipfile ) != UNZ_OK )
-            {
-                unzClose( zipfile );
-                g_logger.fatal("could not open file");
-            }
-
-            // Open a file to write out the data.
-            std::string destFilePath = destinationPath + filename;
-            FILE *out = fopen(destFilePath.c_str(), "wb");
-            if ( out == nullptr )
-            {
-                unzCloseCurrentFile( zipfile );
-                unzClose( zipfile );
-                g_logger.fatal("could not open destination file");
-            }
-
-            int error = UNZ_OK;
-            do
-            {
-                error = unzReadCurrentFile( zipfile, read_buffer, READ_SIZE );
-                if (error < 0)
-                {
-                    unzCloseCurrentFile( zipfile );
-                    unzClose(zipfile);
-                    g_logger.fatal( &"error: " [ error] );
-                }
-
-                // Write data to file.
-                if (error > 0)
-                {
-                    fwrite(read_buffer, error, 1, out);
-                }
-            } while (error > 0);
-
-            fclose(out);
+            ZipEntry entry;
+            entry.name = filename;
+            unzGetFilePos(zipfile, &entry.pos);
+            files.emplace_back(std::move(entry));
         }
 
-        unzCloseCurrentFile( zipfile );
-
         // Go the the next entry listed in the zip file.
         if ( ( i+1 ) < global_info.number_entry )
         {
@@ -139,6 +169,31 @@ void unzipper::extract(const char* fileBuffer, uint fileLength, std::string& des
     }
 
     unzClose(zipfile);
+
+    if (files.empty())
+        return;
+
+    // Decompress independent entries across the async workers, round-robin so
+    // every worker walks its share of the archive mostly forward and writes
+    // each destination file sequentially.
+    const size_t groupCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), files.size()));
+    std::vector<std::vector<ZipEntry>> groups(groupCount);
+    for (size_t f = 0; f < files.size(); ++f)
+        groups[f % groupCount].emplace_back(std::move(files[f]));
+
+    std::vector<std::shared_future<std::string>> results;
+    results.reserve(groupCount);
+    for (auto& group : groups) {
+        results.emplace_back(g_asyncDispatcher.schedule([&, entries = std::move(group)] {
+            return extractEntries(fileBuffer, fileLength, destinationPath, entries);
+        }));
+    }
+
+    for (const auto& result : results) {
+        const auto& error = result.get();
+        if (!error.empty())
+            g_logger.fatal(error);
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -30,6 +30,10 @@
 
 const static int64_t EP_TIME = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 
+// how often the game thread re-publishes its snapshot and the presence
+// thread re-sends it; discord rate-limits presence updates anyway
+constexpr static int UPDATE_INTERVAL = 30000;
+
 Discord g_discord;
 
 void Discord::init()
@@ -37,25 +41,83 @@ void Discord::init()
     DiscordEventHandlers Handle;
     memset(&Handle, 0, sizeof(Handle));
     Discord_Initialize(RPC_API_KEY, &Handle, 1, NULL);
-    update();
+
+    // the presence state machine runs on its own thread, so a slow
+    // discord socket can never stretch a frame; the game thread only
+    // publishes a small snapshot of the state it shows
+    m_running = true;
+    m_thread = std::thread([this] { run(); });
+
+    publish();
+    g_dispatcher.cycleEvent([this] { publish(); }, UPDATE_INTERVAL);
+}
+
+void Discord::terminate()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_condition.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+
+    Discord_Shutdown();
+}
+
+void Discord::publish()
+{
+    PresenceState state;
+    state.online = g_game.isOnline();
+    if (state.online) {
+        state.characterName = g_game.getCharacterName();
+        state.worldName = g_game.getWorldName();
+        if (const auto& player = g_game.getLocalPlayer())
+            state.level = player->getLevel();
+    }
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_state = std::move(state);
+        m_dirty = true;
+    }
+    m_condition.notify_one();
+}
+
+void Discord::run()
+{
+    while (m_running) {
+        PresenceState state;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait_for(lock, std::chrono::milliseconds(UPDATE_INTERVAL), [this] { return !m_running || m_dirty; });
+            if (!m_running)
+                break;
+            m_dirty = false;
+            state = m_state;
+        }
+
+        updatePresence(state);
+        Discord_RunCallbacks();
+    }
 }
 
-void Discord::update()
+void Discord::updatePresence(const PresenceState& state)
 {
     std::string info;
-    if (g_game.isOnline()) {
+    if (state.online) {
 #if SHOW_CHARACTER_NAME_RPC == 1
-        info = "Name: " + g_game.getCharacterName();
+        info = "Name: " + state.characterName;
 #endif
 
 #if SHOW_CHARACTER_LEVEL_RPC == 1
-        const auto& level = std::to_string(g_game.getLocalPlayer()->getLevel());
+        const auto& level = std::to_string(state.level);
         info += info.empty() ? "Level: " + level : "[" + level + "]";
 #endif
 
 #if SHOW_CHARACTER_WORLD_RPC == 1
         if (!info.empty()) info += "\n";
-        info += "World: " + g_game.getWorldName();
+        info += "World: " + state.worldName;
 #endif
     } else {
         info = std::string{ OFFLINE_RPC_TEXT };
@@ -73,7 +135,6 @@ void Discord::update()
     discordPresence.largeImageKey = RPC_LARGE_IMAGE;
     discordPresence.largeImageText = RPC_LARGE_TEXT;
     Discord_UpdatePresence(&discordPresence);
-    g_dispatcher.scheduleEvent([this] { update(); }, 30000);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -29,15 +29,40 @@
 #include <discord_register.h>
 #include <discord_rpc.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 class Discord
 {
 public:
     void init();
+    void terminate();
 
 private:
-    void update();
+    // snapshot of the presence-relevant game state, copied on the game
+    // thread and consumed on the presence thread
+    struct PresenceState
+    {
+        std::string characterName;
+        std::string worldName;
+        uint16_t level{ 0 };
+        bool online{ false };
+    };
+
+    void publish();
+    void run();
+    void updatePresence(const PresenceState& state);
+
+    PresenceState m_state;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+    std::atomic_bool m_running{ false };
+    bool m_dirty{ false };
 };
 
 extern Discord g_discord;
 
-#endif
\ No newline at end of file
+#endif
@@ -24,13 +24,20 @@
  */
 
 #include "apngloader.h"
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
 #include <zlib.h>
 
+#include <framework/core/asyncdispatcher.h>
+
 #if defined(_MSC_VER) && _MSC_VER >= 1300
 #define swap16(data) _byteswap_ushort(data)
 #define swap32(data) _byteswap_ulong(data)
@@ -343,11 +350,16 @@ void compose4(uint8_t* dst, uint32_t dstbytes, uint8_t* src, uint32_t srcbytes,
         uint8_t* dp = dst;
 
         if (bop == PNG_BLEND_OP_SOURCE) {
-            for (i = 0; i < w; i++) {
-                g = *sp; sp += step;
-                a = *sp; sp += step;
-                *dp++ = g;
-                *dp++ = a;
+            if (step == 1) {
+                /* 8 bit gray+alpha rows already match the output layout */
+                memcpy(dp, sp, w * 2);
+            } else {
+                for (i = 0; i < w; i++) {
+                    g = *sp; sp += step;
+                    a = *sp; sp += step;
+                    *dp++ = g;
+                    *dp++ = a;
+                }
             }
         } else /* PNG_BLEND_OP_OVER */
         {
@@ -391,12 +403,18 @@ void compose6(uint8_t* dst, uint32_t dstbytes, uint8_t* src, uint32_t srcbytes,
         auto* dp = (uint32_t*)dst;
 
         if (bop == PNG_BLEND_OP_SOURCE) {
-            for (i = 0; i < w; i++) {
-                b = *sp; sp += step;
-                g = *sp; sp += step;
-                r = *sp; sp += step;
-                a = *sp; sp += step;
-                *dp++ = (a << 24) + (r << 16) + (g << 8) + b;
+            if (step == 1) {
+                /* 8 bit RGBA rows already match the little endian output
+                   layout, so the common case is one straight row copy */
+                memcpy(dp, sp, w * 4);
+            } else {
+                for (i = 0; i < w; i++) {
+                    b = *sp; sp += step;
+                    g = *sp; sp += step;
+                    r = *sp; sp += step;
+                    a = *sp; sp += step;
+                    *dp++ = (a << 24) + (r << 16) + (g << 8) + b;
+                }
             }
         } else /* PNG_BLEND_OP_OVER */
         {
@@ -431,6 +449,53 @@ void compose6(uint8_t* dst, uint32_t dstbytes, uint8_t* src, uint32_t srcbytes,
     }
 }
 
+/* one frame captured during chunk parsing; every frame carries its own zlib
+   stream, so inflating and unfiltering it is independent of the other frames */
+struct apng_frame_task
+{
+    std::vector<uint8_t> zdata;
+    std::vector<uint8_t> raw; /* unfiltered rows, (rowbytes + 1) * h bytes */
+    uint32_t w, h, x, y;
+    uint32_t rowbytes;
+    uint8_t dop, bop;
+    uint8_t dispose; /* frames finished by an fcTL run their dispose op, the IEND frame does not */
+};
+
+struct apng_decode_state
+{
+    std::vector<apng_frame_task> frames;
+    uint8_t bpp{ 0 };
+    std::atomic_uint32_t next{ 0 };
+    std::atomic_uint32_t done{ 0 };
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+void unpack_frame(apng_frame_task& frame, uint8_t bpp)
+{
+    z_stream zstream;
+    zstream.zalloc = nullptr;
+    zstream.zfree = nullptr;
+    zstream.opaque = nullptr;
+    inflateInit(&zstream);
+    frame.raw.resize((frame.rowbytes + 1) * frame.h);
+    unpack(zstream, frame.raw.data(), frame.raw.size(), frame.zdata.data(), frame.zdata.size(), frame.h, frame.rowbytes, bpp);
+    inflateEnd(&zstream);
+}
+
+void decode_frames(const std::shared_ptr<apng_decode_state>& state)
+{
+    const uint32_t count = state->frames.size();
+    uint32_t n;
+    while ((n = state->next.fetch_add(1)) < count) {
+        unpack_frame(state->frames[n], state->bpp);
+        if (state->done.fetch_add(1) + 1 == count) {
+            std::scoped_lock l(state->mutex);
+            state->condition.notify_all();
+        }
+    }
+}
+
 int load_apng(std::stringstream& file, apng_data* apng)
 {
     uint32_t    i, j;
@@ -444,7 +509,7 @@ int load_apng(std::stringstream& file, apng_data* apng)
     uint8_t   c, dop = PNG_DISPOSE_OP_NONE, bop;
     uint8_t   channels, depth, pixeldepth, bpp;
     uint8_t   coltype, compr, filter, interl;
-    z_stream        zstream;
+    const auto& state = std::make_shared<apng_decode_state>();
     memset(apng, 0, sizeof(apng_data));
 
     for (i = 0; i < 256; i++) {
@@ -454,11 +519,6 @@ int load_apng(std::stringstream& file, apng_data* apng)
         trns[i] = 255;
     }
 
-    zstream.zalloc = nullptr;
-    zstream.zfree = nullptr;
-    zstream.opaque = nullptr;
-    inflateInit(&zstream);
-
     frames = 1;
     first_frame = 0;
     cur_frame = 0;
@@ -473,7 +533,6 @@ int load_apng(std::stringstream& file, apng_data* apng)
     uint8_t sig[8];
     uint8_t* pOut1;
     uint8_t* pOut2;
-    uint8_t* pTemp;
     uint8_t* pData;
     uint8_t* pImg1;
     uint8_t* pImg2;
@@ -527,7 +586,6 @@ int load_apng(std::stringstream& file, apng_data* apng)
 
             pOut1 = static_cast<uint8_t*>(malloc(outimg1));
             pOut2 = static_cast<uint8_t*>(malloc(outimg2));
-            pTemp = static_cast<uint8_t*>(malloc(imagesize));
             pData = static_cast<uint8_t*>(malloc(zbuf_size));
             pImg1 = pOut1;
             pImg2 = pOut2;
@@ -605,48 +663,17 @@ int load_apng(std::stringstream& file, apng_data* apng)
                     if (zsize == 0)
                         first_frame = 1;
                     else {
-                        if (dop == PNG_DISPOSE_OP_PREVIOUS) {
-                            if (coltype != 6)
-                                memcpy(pImg1 + outimg1, pImg1, outimg1);
-                            if (coltype != 4)
-                                memcpy(pImg2 + outimg2, pImg2, outimg2);
-                        }
-
-                        pDst1 = pImg1 + y0 * outrow1 + x0 * channels;
-                        pDst2 = pImg2 + y0 * outrow2 + x0 * 4;
-                        unpack(zstream, pTemp, imagesize, pData, zsize, h0, rowbytes, bpp);
-                        switch (coltype) {
-                            case 0: compose0(pDst1, outrow1, pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                            case 2: compose2(pDst1, outrow1, pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                            case 3: compose3(pDst1, outrow1, pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                            case 4: compose4(pDst1, outrow1, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                            case 6: compose6(pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                        }
+                        apng_frame_task& frame = state->frames.emplace_back();
+                        frame.zdata.assign(pData, pData + zsize);
+                        frame.w = w0;
+                        frame.h = h0;
+                        frame.x = x0;
+                        frame.y = y0;
+                        frame.rowbytes = rowbytes;
+                        frame.dop = dop;
+                        frame.bop = bop;
+                        frame.dispose = 1;
                         zsize = 0;
-
-                        if (dop != PNG_DISPOSE_OP_PREVIOUS) {
-                            if (coltype != 6)
-                                memcpy(pImg1 + outimg1, pImg1, outimg1);
-                            if (coltype != 4)
-                                memcpy(pImg2 + outimg2, pImg2, outimg2);
-
-                            if (dop == PNG_DISPOSE_OP_BACKGROUND) {
-                                pDst1 += outimg1;
-                                pDst2 += outimg2;
-
-                                for (j = 0; j < h0; j++) {
-                                    switch (coltype) {
-                                        case 0:  memset(pDst2, 0, w0 * 4); if (hasTRNS) memset(pDst1, trns[1], w0); else keep_original = 0; break;
-                                        case 2:  memset(pDst2, 0, w0 * 4); if (hasTRNS) for (i = 0; i < w0; i++) { pDst1[i * 3] = trns[1]; pDst1[i * 3 + 1] = trns[3]; pDst1[i * 3 + 2] = trns[5]; } else keep_original = 0; break;
-                                        case 3:  memset(pDst2, 0, w0 * 4); if (trns_idx >= 0) memset(pDst1, trns_idx, w0); else keep_original = 0; break;
-                                        case 4:  memset(pDst1, 0, w0 * 2); break;
-                                        case 6:  memset(pDst2, 0, w0 * 4); break;
-                                    }
-                                    pDst1 += outrow1;
-                                    pDst2 += outrow2;
-                                }
-                            }
-                        }
                     }
 
                     /*seq = */read32(file);
@@ -675,8 +702,6 @@ int load_apng(std::stringstream& file, apng_data* apng)
 
                     rowbytes = ROWBYTES(pixeldepth, w0);
                     cur_frame++;
-                    pImg1 += outimg1;
-                    pImg2 += outimg2;
                 } else if (chunk == 0x49444154) /* IDAT */
                 {
                     file.read((char*)(pData + zsize), len);
@@ -691,16 +716,16 @@ int load_apng(std::stringstream& file, apng_data* apng)
                     /*crc = */read32(file);
                 } else if (chunk == 0x49454E44) /* IEND */
                 {
-                    pDst1 = pImg1 + y0 * outrow1 + x0 * channels;
-                    pDst2 = pImg2 + y0 * outrow2 + x0 * 4;
-                    unpack(zstream, pTemp, imagesize, pData, zsize, h0, rowbytes, bpp);
-                    switch (coltype) {
-                        case 0: compose0(pDst1, outrow1, pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                        case 2: compose2(pDst1, outrow1, pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                        case 3: compose3(pDst1, outrow1, pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                        case 4: compose4(pDst1, outrow1, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                        case 6: compose6(pDst2, outrow2, pTemp, rowbytes + 1, w0, h0, bop, depth); break;
-                    }
+                    apng_frame_task& frame = state->frames.emplace_back();
+                    frame.zdata.assign(pData, pData + zsize);
+                    frame.w = w0;
+                    frame.h = h0;
+                    frame.x = x0;
+                    frame.y = y0;
+                    frame.rowbytes = rowbytes;
+                    frame.dop = dop;
+                    frame.bop = bop;
+                    frame.dispose = 0;
                     break;
                 } else {
                     c = static_cast<uint8_t>(chunk >> 24);
@@ -718,6 +743,89 @@ int load_apng(std::stringstream& file, apng_data* apng)
             }
             /* apng decoding - end */
 
+            /*
+                * Every frame carries an independent zlib stream, so inflating and
+                * unfiltering scales across the dispatcher workers. Composing stays
+                * sequential below, because each frame blends into the canvas left
+                * behind by the previous one.
+                */
+            state->bpp = bpp;
+            if (state->frames.size() > 1) {
+                for (i = 1; i < state->frames.size(); i++)
+                    g_asyncDispatcher.dispatch([state] { decode_frames(state); }, AsyncDispatcher::Priority::HIGH);
+
+                /* the loading thread claims frames too, so decoding never stalls on a busy pool */
+                decode_frames(state);
+
+                std::unique_lock lock(state->mutex);
+                state->condition.wait(lock, [&] { return state->done == state->frames.size(); });
+            } else if (!state->frames.empty())
+                unpack_frame(state->frames.front(), bpp);
+
+            pImg1 = pOut1;
+            pImg2 = pOut2;
+            if (first_frame) {
+                /* the first fcTL preceded any image data, output slot 0 stays empty */
+                pImg1 += outimg1;
+                pImg2 += outimg2;
+            }
+
+            for (auto& frame : state->frames) {
+                w0 = frame.w;
+                h0 = frame.h;
+                x0 = frame.x;
+                y0 = frame.y;
+                dop = frame.dop;
+                bop = frame.bop;
+                uint8_t* pRaw = frame.raw.data();
+
+                if (frame.dispose && dop == PNG_DISPOSE_OP_PREVIOUS) {
+                    if (coltype != 6)
+                        memcpy(pImg1 + outimg1, pImg1, outimg1);
+                    if (coltype != 4)
+                        memcpy(pImg2 + outimg2, pImg2, outimg2);
+                }
+
+                pDst1 = pImg1 + y0 * outrow1 + x0 * channels;
+                pDst2 = pImg2 + y0 * outrow2 + x0 * 4;
+                switch (coltype) {
+                    case 0: compose0(pDst1, outrow1, pDst2, outrow2, pRaw, frame.rowbytes + 1, w0, h0, bop, depth); break;
+                    case 2: compose2(pDst1, outrow1, pDst2, outrow2, pRaw, frame.rowbytes + 1, w0, h0, bop, depth); break;
+                    case 3: compose3(pDst1, outrow1, pDst2, outrow2, pRaw, frame.rowbytes + 1, w0, h0, bop, depth); break;
+                    case 4: compose4(pDst1, outrow1, pRaw, frame.rowbytes + 1, w0, h0, bop, depth); break;
+                    case 6: compose6(pDst2, outrow2, pRaw, frame.rowbytes + 1, w0, h0, bop, depth); break;
+                }
+
+                if (frame.dispose) {
+                    if (dop != PNG_DISPOSE_OP_PREVIOUS) {
+                        if (coltype != 6)
+                            memcpy(pImg1 + outimg1, pImg1, outimg1);
+                        if (coltype != 4)
+                            memcpy(pImg2 + outimg2, pImg2, outimg2);
+
+                        if (dop == PNG_DISPOSE_OP_BACKGROUND) {
+                            pDst1 += outimg1;
+                            pDst2 += outimg2;
+
+                            for (j = 0; j < h0; j++) {
+                                switch (coltype) {
+                                    case 0:  memset(pDst2, 0, w0 * 4); if (hasTRNS) memset(pDst1, trns[1], w0); else keep_original = 0; break;
+                                    case 2:  memset(pDst2, 0, w0 * 4); if (hasTRNS) for (i = 0; i < w0; i++) { pDst1[i * 3] = trns[1]; pDst1[i * 3 + 1] = trns[3]; pDst1[i * 3 + 2] = trns[5]; } else keep_original = 0; break;
+                                    case 3:  memset(pDst2, 0, w0 * 4); if (trns_idx >= 0) memset(pDst1, trns_idx, w0); else keep_original = 0; break;
+                                    case 4:  memset(pDst1, 0, w0 * 2); break;
+                                    case 6:  memset(pDst2, 0, w0 * 4); break;
+                                }
+                                pDst1 += outrow1;
+                                pDst2 += outrow2;
+                            }
+                        }
+                    }
+
+                    pImg1 += outimg1;
+                    pImg2 += outimg2;
+                }
+            }
+
             if (coltype == 0) {
                 switch (depth) {
                     case 4: trns[1] *= 0x11; break;
@@ -726,8 +834,6 @@ int load_apng(std::stringstream& file, apng_data* apng)
                 }
             }
 
-            inflateEnd(&zstream);
-
             apng->bpp = channels;
             apng->coltype = coltype;
             apng->last_frame = cur_frame;
@@ -743,8 +849,6 @@ int load_apng(std::stringstream& file, apng_data* apng)
 
             if (pData)
                 free(pData);
-            if (pTemp)
-                free(pTemp);
             if (pOut1)
                 free(pOut1);
         } else
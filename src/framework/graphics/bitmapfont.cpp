@@ -21,10 +21,12 @@
  */
 
 #include "bitmapfont.h"
+#include "fontmanager.h"
 #include "graphics.h"
 #include "image.h"
 #include "texturemanager.h"
 
+#include <framework/core/resourcemanager.h>
 #include <framework/otml/otml.h>
 
 #include "drawpoolmanager.h"
@@ -32,6 +34,150 @@
 static std::vector<Point> s_glyphsPositions(1);
 static std::vector<int> s_lineWidths(1);
 
+namespace {
+    constexpr uint32_t SDF_BLOB_MAGIC = 0x31464453; // "SDF1"
+    constexpr const char* SDF_BLOB_DIR = "/.sdfcache";
+
+    struct SdfBlobHeader
+    {
+        uint32_t magic;
+        int32_t width;
+        int32_t height;
+    };
+
+    std::string sdfBlobPath(const size_t hash)
+    {
+        return stdext::format("%s/%016llx.bin", SDF_BLOB_DIR, static_cast<unsigned long long>(hash));
+    }
+
+    // two-pass 3-4 chamfer distance propagation over one glyph cell, values
+    // are in thirds of a pixel
+    void chamferDistance(std::vector<int>& dist, const int w, const int h)
+    {
+        constexpr int ORTHO = 3, DIAG = 4;
+
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                int& v = dist[y * w + x];
+                if (x > 0) v = std::min<int>(v, dist[y * w + x - 1] + ORTHO);
+                if (y > 0) {
+                    v = std::min<int>(v, dist[(y - 1) * w + x] + ORTHO);
+                    if (x > 0) v = std::min<int>(v, dist[(y - 1) * w + x - 1] + DIAG);
+                    if (x < w - 1) v = std::min<int>(v, dist[(y - 1) * w + x + 1] + DIAG);
+                }
+            }
+        }
+
+        for (int y = h - 1; y >= 0; --y) {
+            for (int x = w - 1; x >= 0; --x) {
+                int& v = dist[y * w + x];
+                if (x < w - 1) v = std::min<int>(v, dist[y * w + x + 1] + ORTHO);
+                if (y < h - 1) {
+                    v = std::min<int>(v, dist[(y + 1) * w + x] + ORTHO);
+                    if (x < w - 1) v = std::min<int>(v, dist[(y + 1) * w + x + 1] + DIAG);
+                    if (x > 0) v = std::min<int>(v, dist[(y + 1) * w + x - 1] + DIAG);
+                }
+            }
+        }
+    }
+
+    // signed distance per pixel encoded into a byte, 128 sitting on the glyph
+    // outline; each cell of the sheet is transformed on its own so
+    // neighbouring glyphs never bleed into each other's distance range
+    std::vector<uint8_t> buildSdfPixels(const ImagePtr& image, const Size& glyphSize)
+    {
+        const int sheetWidth = image->getWidth();
+        const int sheetHeight = image->getHeight();
+        const auto& pixels = image->getPixels();
+
+        std::vector<uint8_t> sdf(static_cast<size_t>(sheetWidth) * sheetHeight, 0);
+
+        constexpr int FAR_AWAY = 1 << 20;
+        std::vector<int> distToInside, distToOutside;
+
+        for (int cellY = 0; cellY < sheetHeight; cellY += glyphSize.height()) {
+            for (int cellX = 0; cellX < sheetWidth; cellX += glyphSize.width()) {
+                const int w = std::min<int>(glyphSize.width(), sheetWidth - cellX);
+                const int h = std::min<int>(glyphSize.height(), sheetHeight - cellY);
+
+                distToInside.assign(static_cast<size_t>(w) * h, FAR_AWAY);
+                distToOutside.assign(static_cast<size_t>(w) * h, FAR_AWAY);
+
+                bool hasInk = false;
+                for (int y = 0; y < h; ++y) {
+                    for (int x = 0; x < w; ++x) {
+                        const uint8_t alpha = pixels[(static_cast<size_t>(cellY + y) * sheetWidth + (cellX + x)) * 4 + 3];
+                        if (alpha >= 128) {
+                            distToInside[y * w + x] = 0;
+                            hasInk = true;
+                        } else
+                            distToOutside[y * w + x] = 0;
+                    }
+                }
+
+                // empty cells keep the fully-outside encoding
+                if (!hasInk)
+                    continue;
+
+                chamferDistance(distToInside, w, h);
+                chamferDistance(distToOutside, w, h);
+
+                for (int y = 0; y < h; ++y) {
+                    for (int x = 0; x < w; ++x) {
+                        // positive inside the glyph, negative outside
+                        const float d = (distToOutside[y * w + x] - distToInside[y * w + x]) / 3.f;
+                        const float encoded = 127.5f + (d / BitmapFont::SDF_SPREAD) * 127.5f;
+                        sdf[static_cast<size_t>(cellY + y) * sheetWidth + (cellX + x)] =
+                            static_cast<uint8_t>(std::clamp<float>(encoded, 0.f, 255.f));
+                    }
+                }
+            }
+        }
+
+        return sdf;
+    }
+
+    bool loadCachedSdfPixels(const size_t hash, const Size& sheetSize, std::vector<uint8_t>& sdfPixels)
+    {
+        try {
+            const auto& path = sdfBlobPath(hash);
+            if (!g_resources.fileExists(path))
+                return false;
+
+            const auto& data = g_resources.readFileContents(path);
+            if (data.size() != sizeof(SdfBlobHeader) + static_cast<size_t>(sheetSize.area()))
+                return false;
+
+            SdfBlobHeader header;
+            memcpy(&header, data.data(), sizeof(header));
+            if (header.magic != SDF_BLOB_MAGIC || header.width != sheetSize.width() || header.height != sheetSize.height())
+                return false;
+
+            sdfPixels.assign(data.begin() + sizeof(SdfBlobHeader), data.end());
+            return true;
+        } catch (const stdext::exception&) {
+            // a broken cache entry only costs one rebuild of the sheet
+            return false;
+        }
+    }
+
+    void storeSdfPixels(const size_t hash, const Size& sheetSize, const std::vector<uint8_t>& sdfPixels)
+    {
+        try {
+            g_resources.makeDir(SDF_BLOB_DIR);
+
+            std::vector<uint8_t> data(sizeof(SdfBlobHeader) + sdfPixels.size());
+            const SdfBlobHeader header{ SDF_BLOB_MAGIC, sheetSize.width(), sheetSize.height() };
+            memcpy(data.data(), &header, sizeof(header));
+            std::copy(sdfPixels.begin(), sdfPixels.end(), data.begin() + sizeof(SdfBlobHeader));
+
+            g_resources.writeFileBuffer(sdfBlobPath(hash), data.data(), data.size());
+        } catch (const stdext::exception&) {
+            // a failed write only costs the next run a rebuild
+        }
+    }
+}
+
 void BitmapFont::load(const OTMLNodePtr& fontNode)
 {
     const auto& textureNode = fontNode->at("texture");
@@ -44,19 +190,41 @@ void BitmapFont::load(const OTMLNodePtr& fontNode)
     m_firstGlyph = fontNode->valueAt("first-glyph", 32);
     m_glyphSpacing = fontNode->valueAt("spacing", Size(0));
 
-    // load font texture
-    m_texture = g_textures.getTexture(textureFile);
-    if (!m_texture)
-        return;
-    m_texture->create();
-
-    const Size textureSize = m_texture->getSize();
+    // load the glyph sheet and pack it into the shared glyph atlas, so the
+    // coords buffers cached by CachedText and UIWidget all reference the same
+    // texture page and text from different fonts batches into one draw
+    Point atlasOffset;
+    Size textureSize;
+    if (const auto& image = Image::load(textureFile)) {
+        m_atlasHandle = g_fonts.getGlyphAtlas().add(image);
+        if (m_atlasHandle->isAtlasRegion()) {
+            atlasOffset = m_atlasHandle->getAtlasOffset();
+            m_texture = m_atlasHandle->getAtlasPage();
+        } else
+            m_texture = m_atlasHandle;
+        m_texture->setSmooth(true);
+        textureSize = image->getSize();
+
+        if (const auto& node = fontNode->get("fixed-glyph-width")) {
+            for (int glyph = m_firstGlyph; glyph < 256; ++glyph)
+                m_glyphsSize[glyph] = Size(node->value<int>(), m_glyphHeight);
+        } else {
+            calculateGlyphsWidthsAutomatically(image, glyphSize);
+        }
 
-    if (const auto& node = fontNode->get("fixed-glyph-width")) {
-        for (int glyph = m_firstGlyph; glyph < 256; ++glyph)
-            m_glyphsSize[glyph] = Size(node->value<int>(), m_glyphHeight);
+        loadSdfTexture(image, glyphSize, atlasOffset);
     } else {
-        calculateGlyphsWidthsAutomatically(Image::load(textureFile), glyphSize);
+        // glyph sheets that Image cannot decode keep their own texture
+        m_texture = g_textures.getTexture(textureFile);
+        if (!m_texture)
+            return;
+        m_texture->create();
+        textureSize = m_texture->getSize();
+
+        if (const auto& node = fontNode->get("fixed-glyph-width")) {
+            for (int glyph = m_firstGlyph; glyph < 256; ++glyph)
+                m_glyphsSize[glyph] = Size(node->value<int>(), m_glyphHeight);
+        }
     }
 
     // 32 and 160 are spaces (&nbsp;)
@@ -77,16 +245,54 @@ void BitmapFont::load(const OTMLNodePtr& fontNode)
     }
     */
 
-    // calculate glyphs texture coords
+    // calculate glyphs texture coords; the atlas offset is baked right into
+    // them because cached coords buffers are uploaded as-is on later frames
     const int numHorizontalGlyphs = textureSize.width() / glyphSize.width();
     for (int glyph = m_firstGlyph; glyph < 256; ++glyph) {
-        m_glyphsTextureCoords[glyph].setRect(((glyph - m_firstGlyph) % numHorizontalGlyphs) * glyphSize.width(),
-                                             ((glyph - m_firstGlyph) / numHorizontalGlyphs) * glyphSize.height(),
+        m_glyphsTextureCoords[glyph].setRect(atlasOffset.x + ((glyph - m_firstGlyph) % numHorizontalGlyphs) * glyphSize.width(),
+                                             atlasOffset.y + ((glyph - m_firstGlyph) / numHorizontalGlyphs) * glyphSize.height(),
                                              m_glyphsSize[glyph].width(),
                                              m_glyphHeight);
     }
 }
 
+void BitmapFont::loadSdfTexture(const ImagePtr& image, const Size& glyphSize, const Point& atlasOffset)
+{
+    const auto& sheetSize = image->getSize();
+
+    // the distance transform runs once per sheet ever, afterwards the sdf
+    // pixels come straight from disk keyed by the sheet content
+    const size_t hash = std::hash<std::string_view>{}(
+        std::string_view(reinterpret_cast<const char*>(image->getPixelData()), image->getPixels().size()));
+
+    std::vector<uint8_t> sdfPixels;
+    if (!loadCachedSdfPixels(hash, sheetSize, sdfPixels)) {
+        sdfPixels = buildSdfPixels(image, glyphSize);
+        storeSdfPixels(hash, sheetSize, sdfPixels);
+    }
+
+    // white glyphs with the distance in the alpha channel, so the sdf shader
+    // modulates u_Color exactly like the regular textured path
+    const auto& sdfImage = std::make_shared<Image>(sheetSize);
+    uint8_t* pixels = sdfImage->getPixelData();
+    for (size_t i = 0; i < sdfPixels.size(); ++i) {
+        pixels[i * 4 + 0] = pixels[i * 4 + 1] = pixels[i * 4 + 2] = 0xff;
+        pixels[i * 4 + 3] = sdfPixels[i];
+    }
+
+    // the sdf sheet shares the glyph atlas, so scaled text from every font
+    // and size samples the same page and batches just like unscaled text
+    m_sdfAtlasHandle = g_fonts.getGlyphAtlas().add(sdfImage);
+    if (m_sdfAtlasHandle->isAtlasRegion()) {
+        m_sdfCoordsOffset = m_sdfAtlasHandle->getAtlasOffset() - atlasOffset;
+        m_sdfTexture = m_sdfAtlasHandle->getAtlasPage();
+    } else {
+        m_sdfCoordsOffset = -atlasOffset;
+        m_sdfTexture = m_sdfAtlasHandle;
+    }
+    m_sdfTexture->setSmooth(true);
+}
+
 void BitmapFont::drawText(const std::string_view text, const Point& startPos, const Color& color)
 {
     const Size boxSize = g_painter->getResolution() - startPos.toSize();
@@ -180,7 +386,7 @@ std::vector<std::pair<Rect, Rect>> BitmapFont::getDrawTextCoords(const std::stri
 
 void BitmapFont::fillTextCoords(const CoordsBufferPtr& coords, const std::string_view text,
                                 const Size& textBoxSize, Fw::AlignmentFlag align, const Rect& screenCoords,
-                                const std::vector<Point>& glyphsPositions) const
+                                const std::vector<Point>& glyphsPositions, const float scale) const
 {
     coords->clear();
 
@@ -188,6 +394,9 @@ void BitmapFont::fillTextCoords(const CoordsBufferPtr& coords, const std::string
     if (!screenCoords.isValid() || !m_texture)
         return;
 
+    // scaled text samples the distance-field sheet when the font has one
+    const bool sdf = scale != 1.f && m_sdfTexture != nullptr;
+
     const int textLenght = text.length();
 
     for (int i = 0; i < textLenght; ++i) {
@@ -198,7 +407,9 @@ void BitmapFont::fillTextCoords(const CoordsBufferPtr& coords, const std::string
             continue;
 
         // calculate initial glyph rect and texture coords
-        Rect glyphScreenCoords(glyphsPositions[i], m_glyphsSize[glyph]);
+        Rect glyphScreenCoords = scale != 1.f
+            ? Rect(glyphsPositions[i] * scale, m_glyphsSize[glyph] * scale)
+            : Rect(glyphsPositions[i], m_glyphsSize[glyph]);
         Rect glyphTextureCoords = m_glyphsTextureCoords[glyph];
 
         // first translate to align position
@@ -222,13 +433,14 @@ void BitmapFont::fillTextCoords(const CoordsBufferPtr& coords, const std::string
         if (glyphScreenCoords.bottom() < 0 || glyphScreenCoords.right() < 0)
             continue;
 
-        // bound glyph topLeft to 0,0 if needed
+        // bound glyph topLeft to 0,0 if needed, one screen pixel spans
+        // 1/scale texels
         if (glyphScreenCoords.top() < 0) {
-            glyphTextureCoords.setTop(glyphTextureCoords.top() - glyphScreenCoords.top());
+            glyphTextureCoords.setTop(glyphTextureCoords.top() - static_cast<int>(glyphScreenCoords.top() / scale));
             glyphScreenCoords.setTop(0);
         }
         if (glyphScreenCoords.left() < 0) {
-            glyphTextureCoords.setLeft(glyphTextureCoords.left() - glyphScreenCoords.left());
+            glyphTextureCoords.setLeft(glyphTextureCoords.left() - static_cast<int>(glyphScreenCoords.left() / scale));
             glyphScreenCoords.setLeft(0);
         }
 
@@ -241,15 +453,17 @@ void BitmapFont::fillTextCoords(const CoordsBufferPtr& coords, const std::string
 
         // bound glyph bottomRight to screenCoords bottomRight
         if (glyphScreenCoords.bottom() > screenCoords.bottom()) {
-            glyphTextureCoords.setBottom(glyphTextureCoords.bottom() + (screenCoords.bottom() - glyphScreenCoords.bottom()));
+            glyphTextureCoords.setBottom(glyphTextureCoords.bottom() + static_cast<int>((screenCoords.bottom() - glyphScreenCoords.bottom()) / scale));
             glyphScreenCoords.setBottom(screenCoords.bottom());
         }
         if (glyphScreenCoords.right() > screenCoords.right()) {
-            glyphTextureCoords.setRight(glyphTextureCoords.right() + (screenCoords.right() - glyphScreenCoords.right()));
+            glyphTextureCoords.setRight(glyphTextureCoords.right() + static_cast<int>((screenCoords.right() - glyphScreenCoords.right()) / scale));
             glyphScreenCoords.setRight(screenCoords.right());
         }
 
         // add glyph
+        if (sdf)
+            glyphTextureCoords.translate(m_sdfCoordsOffset);
         coords->addRect(glyphScreenCoords, glyphTextureCoords);
     }
 }
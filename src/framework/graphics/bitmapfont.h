@@ -31,6 +31,10 @@
 class BitmapFont
 {
 public:
+    // pixels of distance range encoded on each side of a glyph outline in
+    // the signed-distance-field sheet
+    static constexpr int SDF_SPREAD = 4;
+
     BitmapFont(std::string_view name) : m_name(name) {}
 
     /// Load font from otml node
@@ -48,9 +52,13 @@ public:
                                                          const Rect& screenCoords,
                                                          const std::vector<Point>& glyphsPositions) const;
 
+    /// Fill coords with the text quads; when scale is not 1 the glyph rects
+    /// grow around screenCoords' top left and the texture coords point at the
+    /// signed-distance-field sheet, textBoxSize must come pre-scaled
     void fillTextCoords(const CoordsBufferPtr& coords, const std::string_view text,
                         const Size& textBoxSize, Fw::AlignmentFlag align,
-                        const Rect& screenCoords, const std::vector<Point>& glyphsPositions) const;
+                        const Rect& screenCoords, const std::vector<Point>& glyphsPositions,
+                        float scale = 1.f) const;
 
     /// Calculate glyphs positions to use on render, also calculates textBoxSize if wanted
     const std::vector<Point>& calculateGlyphsPositions(const std::string_view text,
@@ -67,6 +75,16 @@ public:
     const Rect* getGlyphsTextureCoords() { return m_glyphsTextureCoords; }
     const Size* getGlyphsSize() { return m_glyphsSize; }
     const TexturePtr& getTexture() { return m_texture; }
+
+    // distance-field build of the glyph sheet, rendered through the painter's
+    // sdf shader when text is drawn scaled; null for glyph sheets that could
+    // not be decoded
+    const TexturePtr& getSdfTexture() { return m_sdfTexture; }
+
+    // smoothstep half-width around the 0.5 distance threshold that keeps the
+    // glyph outline transition about one screen pixel wide at the given scale
+    static float getSdfSmoothing(const float scale) { return std::min(0.49f, 1.f / (4.f * SDF_SPREAD * scale)); }
+
     int getYOffset() const { return m_yOffset; }
     Size getGlyphSpacing() { return m_glyphSpacing; }
 
@@ -79,7 +97,16 @@ private:
     int m_firstGlyph{ 0 };
     int m_yOffset{ 0 };
     Size m_glyphSpacing;
+    /// Builds the signed-distance-field sheet and packs it into the glyph atlas
+    void loadSdfTexture(const ImagePtr& image, const Size& glyphSize, const Point& atlasOffset);
+
     TexturePtr m_texture;
+    TexturePtr m_atlasHandle; // keeps the glyph atlas region alive
+
+    TexturePtr m_sdfTexture;
+    TexturePtr m_sdfAtlasHandle;
+    Point m_sdfCoordsOffset; // from a glyph's texture coords to its sdf coords
+
     Rect m_glyphsTextureCoords[256];
     Size m_glyphsSize[256];
 };
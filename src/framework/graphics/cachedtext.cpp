@@ -32,12 +32,17 @@ void CachedText::draw(const Rect& rect, const Color& color)
     if (!m_font)
         return;
 
-    if (m_textScreenCoords != rect) {
-        m_textScreenCoords = rect;
-        m_font->fillTextCoords(m_coordsBuffer, m_text, m_textSize, m_align, rect, m_glyphsPositions);
+    // glyphs are tessellated once at the origin, moving text (animated
+    // numbers, scrolling messages) only re-offsets the cached vertices
+    if (m_textScreenCoords.size() != rect.size()) {
+        m_textScreenCoords = Rect(0, 0, rect.size());
+        m_font->fillTextCoords(m_coordsBuffer, m_text, m_textSize, m_align, m_textScreenCoords, m_glyphsPositions);
     }
 
-    g_drawPool.addTexturedCoordsBuffer(m_font->getTexture(), m_coordsBuffer, color);
+    // grouped so every text sharing the same font texture and color
+    // collapses into a single draw
+    static constexpr DrawConductor AGROUP_CONDUCTOR{ .agroup = true };
+    g_drawPool.addTexturedCoordsBuffer(m_font->getTexture(), m_coordsBuffer, color, rect.topLeft(), AGROUP_CONDUCTOR);
 }
 
 void CachedText::update()
@@ -44,7 +44,6 @@ public:
 private:
     void update();
 
-    std::vector<std::pair<Rect, Rect>> m_TextureCoords;
     std::vector<Point> m_glyphsPositions;
 
     std::string m_text;
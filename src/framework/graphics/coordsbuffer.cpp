@@ -23,6 +23,34 @@
 #include "coordsbuffer.h"
 #include "graphics.h"
 
+#include <framework/core/application.h>
+
+CoordsBuffer::~CoordsBuffer()
+{
+#ifndef NDEBUG
+    assert(!g_app.isTerminated());
+#endif
+    if (m_vao && g_graphics.ok())
+        glDeleteVertexArrays(1, &m_vao);
+}
+
+bool CoordsBuffer::isVaoSupported()
+{
+#ifdef OPENGL_ES
+    return true; // core since GLES3
+#else
+    static const bool supported = GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object;
+    return supported;
+#endif
+}
+
+uint32_t CoordsBuffer::vao()
+{
+    if (!m_vao)
+        glGenVertexArrays(1, &m_vao);
+    return m_vao;
+}
+
 void CoordsBuffer::addBoudingRect(const Rect& dest, int innerLineWidth)
 {
     const int left = dest.left();
@@ -61,8 +89,7 @@ void CoordsBuffer::addRepeatedRects(const Rect& dest, const Rect& src)
             }
 
             partialDest.translate(dest.topLeft());
-            m_vertexArray.addRect(partialDest);
-            m_textureCoordArray.addRect(partialSrc);
+            addRect(partialDest, partialSrc);
         }
     }
 }
@@ -27,58 +27,101 @@
 class CoordsBuffer
 {
 public:
+    ~CoordsBuffer();
 
     void clear()
     {
         m_textureCoordArray.clear();
         m_vertexArray.clear();
+        m_triangles = false;
     }
 
     void addTriangle(const Point& a, const Point& b, const Point& c)
     {
+        convertToTriangles();
         m_vertexArray.addTriangle(a, b, c);
     }
     void addRect(const Rect& dest)
     {
-        m_vertexArray.addRect(dest);
+        if (m_triangles)
+            m_vertexArray.addRect(dest);
+        else
+            m_vertexArray.addQuad(dest);
     }
     void addRect(const Rect& dest, const Rect& src)
     {
-        m_vertexArray.addRect(dest);
-        if (src.isValid())
-            m_textureCoordArray.addRect(src);
+        if (m_triangles) {
+            m_vertexArray.addRect(dest);
+            if (src.isValid())
+                m_textureCoordArray.addRect(src);
+        } else {
+            m_vertexArray.addQuad(dest);
+            if (src.isValid())
+                m_textureCoordArray.addQuad(src);
+        }
     }
 
     void addRect(const RectF& dest, const RectF& src)
     {
-        m_vertexArray.addRect(dest);
-        m_textureCoordArray.addRect(src);
+        if (m_triangles) {
+            m_vertexArray.addRect(dest);
+            m_textureCoordArray.addRect(src);
+        } else {
+            m_vertexArray.addQuad(dest);
+            m_textureCoordArray.addQuad(src);
+        }
     }
 
     void addQuad(const Rect& dest, const Rect& src)
     {
-        m_vertexArray.addQuad(dest);
-        m_textureCoordArray.addQuad(src);
+        if (m_triangles) {
+            m_vertexArray.addRect(dest);
+            m_textureCoordArray.addRect(src);
+        } else {
+            m_vertexArray.addQuad(dest);
+            m_textureCoordArray.addQuad(src);
+        }
     }
     void addUpsideDownQuad(const Rect& dest, const Rect& src)
     {
-        m_vertexArray.addUpsideDownQuad(dest);
-        m_textureCoordArray.addQuad(src);
+        if (m_triangles) {
+            m_vertexArray.addUpsideDownRect(dest);
+            m_textureCoordArray.addRect(src);
+        } else {
+            m_vertexArray.addUpsideDownQuad(dest);
+            m_textureCoordArray.addQuad(src);
+        }
     }
 
     void addUpsideDownRect(const Rect& dest, const Rect& src)
     {
-        m_vertexArray.addUpsideDownRect(dest);
-        m_textureCoordArray.addRect(src);
+        if (m_triangles) {
+            m_vertexArray.addUpsideDownRect(dest);
+            m_textureCoordArray.addRect(src);
+        } else {
+            m_vertexArray.addUpsideDownQuad(dest);
+            m_textureCoordArray.addQuad(src);
+        }
     }
 
     void addBoudingRect(const Rect& dest, int innerLineWidth);
     void addRepeatedRects(const Rect& dest, const Rect& src);
 
-    void append(const CoordsBuffer* buffer)
+    void append(const CoordsBuffer* buffer) { append(buffer, {}); }
+
+    // appends with the vertices shifted by offset, texture coords are kept
+    void append(const CoordsBuffer* buffer, const Point& offset)
     {
-        m_vertexArray.append(&buffer->m_vertexArray);
-        m_textureCoordArray.append(&buffer->m_textureCoordArray);
+        if (buffer->m_triangles)
+            convertToTriangles();
+
+        if (m_triangles && !buffer->m_triangles) {
+            m_vertexArray.appendQuadsAsTriangles(&buffer->m_vertexArray, offset);
+            m_textureCoordArray.appendQuadsAsTriangles(&buffer->m_textureCoordArray, {});
+        } else {
+            m_vertexArray.append(&buffer->m_vertexArray, offset);
+            m_textureCoordArray.append(&buffer->m_textureCoordArray);
+        }
     }
 
     const float* getVertexArray() const { return m_vertexArray.vertices(); }
@@ -86,17 +129,67 @@ public:
     int getVertexCount() const { return m_vertexArray.vertexCount(); }
     int getTextureCoordCount() const { return m_textureCoordArray.vertexCount(); }
 
+    // > 0 while the buffer holds only 4-vertex quads, which the painter
+    // then draws indexed through the shared static quad index buffer
+    int getQuadCount() const { return m_triangles ? 0 : m_vertexArray.size() / 8; }
+
+    size_t getMemoryUsage() const { return m_vertexArray.capacityBytes() + m_textureCoordArray.capacityBytes(); }
+
     void cache();
 
+    void fenceHardwareCaches() const
+    {
+        m_vertexArray.fenceHardwareCache();
+        m_textureCoordArray.fenceHardwareCache();
+    }
+
     bool isCached() const { return m_vertexArray.isCached() || m_textureCoordArray.isCached(); }
     void enableCache() { m_canCache = true; }
 
     HardwareBuffer* getHardwareVertexCache() const { return m_vertexArray.getHardwareCache(); }
     HardwareBuffer* getHardwareTextureCoordCache() const { return m_textureCoordArray.getHardwareCache(); }
 
+    // a cached buffer keeps its attribute setup in a vertex array object the
+    // painter binds instead of respecifying both pointers on every draw; the
+    // capture is keyed on the hardware cache generations so a write() that
+    // moved the backing storage forces a recapture
+    static bool isVaoSupported();
+    uint32_t vao();
+    bool vaoMatches(const uint32_t vertexGen, const uint32_t texCoordGen, const bool textured) const
+    {
+        return m_vaoCaptured && m_vaoVertexGen == vertexGen && m_vaoTexCoordGen == texCoordGen && m_vaoTextured == textured;
+    }
+    void captureVao(const uint32_t vertexGen, const uint32_t texCoordGen, const bool textured)
+    {
+        m_vaoVertexGen = vertexGen;
+        m_vaoTexCoordGen = texCoordGen;
+        m_vaoTextured = textured;
+        m_vaoCaptured = true;
+    }
+    void invalidateVao() { m_vaoCaptured = false; }
+
 private:
+    // quads and free-form triangles cannot share the indexed draw path;
+    // the rare buffer that mixes them is expanded to triangles once and
+    // keeps emitting triangles from then on
+    void convertToTriangles()
+    {
+        if (m_triangles)
+            return;
+        m_triangles = true;
+        m_vertexArray.expandQuadsToTriangles();
+        m_textureCoordArray.expandQuadsToTriangles();
+    }
+
     VertexArray m_vertexArray;
     VertexArray m_textureCoordArray;
 
+    uint32_t m_vao{ 0 };
+    uint32_t m_vaoVertexGen{ 0 };
+    uint32_t m_vaoTexCoordGen{ 0 };
+    bool m_vaoTextured{ false };
+    bool m_vaoCaptured{ false };
+
     bool m_canCache{ false };
+    bool m_triangles{ false };
 };
@@ -38,7 +38,7 @@ class FrameBufferManager;
 class Shader;
 class ShaderProgram;
 class PainterShaderProgram;
-class Particle;
+class Particles;
 class ParticleType;
 class ParticleEmitter;
 class ParticleAffector;
@@ -59,7 +59,6 @@ using FrameBufferPtr = std::shared_ptr<FrameBuffer>;
 using ShaderPtr = std::shared_ptr<Shader>;
 using ShaderProgramPtr = std::shared_ptr<ShaderProgram>;
 using PainterShaderProgramPtr = std::shared_ptr<PainterShaderProgram>;
-using ParticlePtr = std::shared_ptr<Particle>;
 using ParticleTypePtr = std::shared_ptr<ParticleType>;
 using ParticleEmitterPtr = std::shared_ptr<ParticleEmitter>;
 using ParticleAffectorPtr = std::shared_ptr<ParticleAffector>;
@@ -22,12 +22,18 @@
 
 #include "drawpool.h"
 #include "framebuffermanager.h"
+#include <framework/core/asyncdispatcher.h>
 
 static constexpr uint16_t
 FPS10 = 1000 / 10,
 FPS20 = 1000 / 20,
 FPS60 = 1000 / 60;
 
+// cap for the idle refresh backoff, see canRepaint()
+static constexpr uint16_t
+IDLE_BACKOFF_MAX = 4,
+IDLE_REFRESH_DELAY_MAX = 1000;
+
 DrawPool* DrawPool::create(const DrawPoolType type)
 {
     DrawPool* pool = new DrawPool;
@@ -55,9 +61,18 @@ DrawPool* DrawPool::create(const DrawPoolType type)
 }
 
 void DrawPool::add(const Color& color, const TexturePtr& texture, DrawPool::DrawMethod& method,
-                   DrawMode drawMode, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer)
+                   DrawMode drawMode, const DrawConductor& conductor, const CoordsBufferPtr& coordsBuffer,
+                   const Point& coordsOffset)
 {
-    auto state = getState(method, texture, color);
+    // atlas sub-rect handles are drawn through their page, so consecutive
+    // draws from the same page share a single state and get batched.
+    TexturePtr tex = texture;
+    if (tex && tex->isAtlasRegion()) {
+        method.src.translate(tex->getAtlasOffset());
+        tex = tex->getAtlasPage();
+    }
+
+    auto state = getState(method, tex, color);
 
     uint8_t order = conductor.order;
     if (m_type == DrawPoolType::FOREGROUND)
@@ -71,14 +86,14 @@ void DrawPool::add(const Color& color, const TexturePtr& texture, DrawPool::Draw
         const auto it = m_objectsByhash.find(state.hash);
 
         const bool bufferFound = it != m_objectsByhash.end();
-        const auto& coords = bufferFound ? it->second.coords : std::make_shared<CoordsBuffer>();
+        const auto& coords = bufferFound ? it->second.coords : getTemporaryCoordsBuffer();
 
         if (!bufferFound) {
             m_objectsByhash.emplace(state.hash, list.emplace_back(state, coords));
         }
 
         if (coordsBuffer)
-            coords->append(coordsBuffer.get());
+            coords->append(coordsBuffer.get(), coordsOffset);
         else
             addCoords(coords.get(), method, DrawMode::TRIANGLES);
 
@@ -92,7 +107,7 @@ void DrawPool::add(const Color& color, const TexturePtr& texture, DrawPool::Draw
             if (!prevObj.coords)
                 prevObj.addMethod(method);
             else if (coordsBuffer)
-                prevObj.coords->append(coordsBuffer.get());
+                prevObj.coords->append(coordsBuffer.get(), coordsOffset);
             else
                 addCoords(prevObj.coords.get(), method, DrawMode::TRIANGLES);
 
@@ -101,12 +116,26 @@ void DrawPool::add(const Color& color, const TexturePtr& texture, DrawPool::Draw
     }
 
     if (coordsBuffer) {
-        list.emplace_back(state, std::make_shared<CoordsBuffer>())
-            .coords->append(coordsBuffer.get());
+        list.emplace_back(state, getTemporaryCoordsBuffer())
+            .coords->append(coordsBuffer.get(), coordsOffset);
     } else
         list.emplace_back(drawMode, state, method);
 }
 
+const CoordsBufferPtr& DrawPool::getTemporaryCoordsBuffer()
+{
+    // frame-scoped arena: buffers are handed out in order and all reclaimed
+    // together on resetState(), so crowded frames stop hitting the heap
+    if (m_coordsBufferIndex < m_coordsBufferCache.size()) {
+        const auto& coords = m_coordsBufferCache[m_coordsBufferIndex++];
+        coords->clear();
+        return coords;
+    }
+
+    ++m_coordsBufferIndex;
+    return m_coordsBufferCache.emplace_back(std::make_shared<CoordsBuffer>());
+}
+
 void DrawPool::addCoords(CoordsBuffer* buffer, const DrawMethod& method, DrawMode drawMode)
 {
     if (method.type == DrawMethodType::BOUNDING_RECT) {
@@ -137,25 +166,30 @@ DrawPool::PoolState DrawPool::getState(const DrawPool::DrawMethod& method, const
        std::move(m_state.action), std::move(const_cast<Color&>(color)), texture
     };
 
-    { // State Hash
-        if (state.blendEquation != BlendEquation::ADD)
-            stdext::hash_combine(state.hash, state.blendEquation);
-
-        if (state.clipRect.isValid())
-            stdext::hash_union(state.hash, state.clipRect.hash());
-
-        if (state.compositionMode != CompositionMode::NORMAL)
-            stdext::hash_combine(state.hash, state.compositionMode);
-
-        if (state.opacity < 1.f)
-            stdext::hash_combine(state.hash, state.opacity);
-
-        if (state.shaderProgram)
-            stdext::hash_combine(state.hash, state.shaderProgram->getProgramId());
-
-        if (state.transformMatrix != DEFAULT_MATRIX3)
-            stdext::hash_union(state.hash, state.transformMatrix.hash());
+    { // State Hash: the slow-moving fields are packed into one key hashed in
+      // a single pass, and since consecutive commands almost always repeat
+      // them the key is first compared against the previous command's and the
+      // hash only recomputed when it changed
+        BaseStateKey key;
+        memset(&key, 0, sizeof(key)); // padding is compared too
+        key.transform = state.transformMatrix.hash();
+        if (state.clipRect.isValid()) {
+            key.clip[0] = state.clipRect.left();
+            key.clip[1] = state.clipRect.top();
+            key.clip[2] = state.clipRect.right();
+            key.clip[3] = state.clipRect.bottom();
+        }
+        key.opacity = state.opacity;
+        key.shader = state.shaderProgram ? state.shaderProgram->getProgramId() : 0;
+        key.composition = static_cast<uint8_t>(state.compositionMode);
+        key.blend = static_cast<uint8_t>(state.blendEquation);
+
+        if (memcmp(&key, &m_stateKey, sizeof(key)) != 0) {
+            m_stateKeyHash = stdext::hash_bytes(&key, sizeof(key));
+            memcpy(&m_stateKey, &key, sizeof(key));
+        }
 
+        state.hash = m_stateKeyHash;
         if (state.color != Color::white)
             stdext::hash_union(state.hash, state.color.hash());
 
@@ -166,20 +200,24 @@ DrawPool::PoolState DrawPool::getState(const DrawPool::DrawMethod& method, const
             stdext::hash_union(m_status.second, state.hash);
     }
 
-    if (m_updateHash) { // Method Hash
+    if (m_updateHash) { // Method Hash: dest/src and a/b/c are contiguous in
+                        // DrawMethod, so each shape hashes as one buffer
         size_t methodhash = 0;
         if (method.type == DrawPool::DrawMethodType::TRIANGLE) {
-            if (!method.a.isNull()) stdext::hash_union(methodhash, method.a.hash());
-            if (!method.b.isNull()) stdext::hash_union(methodhash, method.b.hash());
-            if (!method.c.isNull()) stdext::hash_union(methodhash, method.c.hash());
+            methodhash = stdext::hash_bytes(&method.a, sizeof(method.a) * 3);
         } else if (method.type == DrawPool::DrawMethodType::BOUNDING_RECT) {
-            if (method.intValue) stdext::hash_combine(methodhash, method.intValue);
+            if (method.intValue) methodhash = stdext::hash_int(method.intValue);
         } else {
-            if (method.dest.isValid()) stdext::hash_union(methodhash, method.dest.hash());
-            if (method.src.isValid()) stdext::hash_union(methodhash, method.src.hash());
+            methodhash = stdext::hash_bytes(&method.dest, sizeof(method.dest) * 2);
         }
 
         stdext::hash_union(m_status.second, methodhash);
+
+        if (!m_regionStatus.empty()) {
+            size_t objectHash = state.hash;
+            stdext::hash_union(objectHash, methodhash);
+            updateRegionStatus(method, state, objectHash);
+        }
     }
 
     if (m_onlyOnceStateFlag > 0) { // Only Once State
@@ -234,7 +272,9 @@ void DrawPool::setShaderProgram(const PainterShaderProgramPtr& shaderProgram, bo
         return;
 
     if (shaderProgram) {
-        if (!g_painter->isReplaceColorShader(shaderProgram.get()))
+        // built-in shaders have no time-driven uniforms, only user shaders
+        // need the timed repaint that keeps their animations running
+        if (!g_painter->isReplaceColorShader(shaderProgram.get()) && !g_painter->isTextSdfShader(shaderProgram.get()))
             m_shaderRefreshDelay = FPS20;
 
         m_state.shaderProgram = shaderProgram.get();
@@ -255,31 +295,272 @@ void DrawPool::resetState()
     }
 
     m_objectsByhash.clear();
+    m_coordsBufferIndex = 0;
+    ++m_frameId;
     m_state = {};
     m_depthLevel = 0;
     m_status.second = 0;
+    m_globalStatus.second = 0;
     m_shaderRefreshDelay = 0;
+
+    if (m_framebuffer && m_framebuffer->isValid()) {
+        const auto& size = m_framebuffer->getSize();
+        // one spare row and column of buckets keeps every cell overlapping
+        // the framebuffer in a distinct bucket while the grid anchor slides
+        // over unaligned scroll offsets, see scroll()
+        const uint16_t regionsX = (size.width() + REGION_SIZE - 1) / REGION_SIZE + 1;
+        const uint16_t regionsY = (size.height() + REGION_SIZE - 1) / REGION_SIZE + 1;
+        if (regionsX != m_regionsX || regionsY != m_regionsY) {
+            // the grid no longer maps to the old content, force a full repaint
+            m_regionsX = regionsX;
+            m_regionsY = regionsY;
+            m_regionStatus.assign(static_cast<size_t>(regionsX) * regionsY, {});
+            repaint();
+        } else {
+            for (auto& region : m_regionStatus)
+                region.second = 0;
+        }
+    }
+}
+
+void DrawPool::updateRegionStatus(const DrawMethod& method, const PoolState& state, size_t objectHash)
+{
+    // triangles, transformed draws and raw coords buffers have no usable
+    // screen rect, any change in them taints the whole framebuffer
+    if (method.type == DrawMethodType::TRIANGLE || !method.dest.isValid() || state.transformMatrix != DEFAULT_MATRIX3) {
+        stdext::hash_union(m_globalStatus.second, objectHash);
+        return;
+    }
+
+    // the grid is anchored to the scroll origin; re-hashing the dest in
+    // anchored space keeps a draw's cell hash stable while its framebuffer
+    // position slides under a camera step
+    if (m_regionOrigin != Point() && method.type != DrawMethodType::BOUNDING_RECT) {
+        const Rect anchored[2]{ method.dest.translated(m_regionOrigin), method.src };
+        objectHash = state.hash;
+        stdext::hash_union(objectHash, stdext::hash_bytes(&anchored[0], sizeof(anchored)));
+    }
+
+    const int left = toCell(method.dest.left() + m_regionOrigin.x);
+    const int top = toCell(method.dest.top() + m_regionOrigin.y);
+    const int right = toCell(method.dest.right() + m_regionOrigin.x);
+    const int bottom = toCell(method.dest.bottom() + m_regionOrigin.y);
+
+    for (int y = top; y <= bottom; ++y) {
+        const int by = wrapCell(y, m_regionsY) * m_regionsX;
+        for (int x = left; x <= right; ++x)
+            stdext::hash_union(m_regionStatus[by + wrapCell(x, m_regionsX)].second, objectHash);
+    }
+}
+
+void DrawPool::updateDirtyRegion()
+{
+    m_dirtyRegion = {}; // invalid rect means repainting the whole framebuffer
+
+    // refresh delay driven repaints (shader animations) and changes in
+    // draws that couldn't be localized must redraw everything
+    const bool fullRepaint = m_regionStatus.empty() || m_status.first == m_status.second ||
+        m_globalStatus.first != m_globalStatus.second;
+
+    m_globalStatus.first = m_globalStatus.second;
+
+    if (m_regionStatus.empty())
+        return;
+
+    // cells are anchored to the scroll origin, so walk the ones currently
+    // overlapping the framebuffer and translate them back to screen space
+    const auto& size = m_framebuffer->getSize();
+    const int firstCellX = toCell(m_regionOrigin.x);
+    const int firstCellY = toCell(m_regionOrigin.y);
+    const int lastCellX = toCell(m_regionOrigin.x + size.width() - 1);
+    const int lastCellY = toCell(m_regionOrigin.y + size.height() - 1);
+
+    Rect dirty;
+    bool allDirty = true;
+    for (int y = firstCellY; y <= lastCellY; ++y) {
+        const int by = wrapCell(y, m_regionsY) * m_regionsX;
+        for (int x = firstCellX; x <= lastCellX; ++x) {
+            const auto& region = m_regionStatus[by + wrapCell(x, m_regionsX)];
+            if (region.first != region.second) {
+                const Rect cellRect(x * REGION_SIZE - m_regionOrigin.x, y * REGION_SIZE - m_regionOrigin.y, REGION_SIZE, REGION_SIZE);
+                dirty = dirty.isValid() ? dirty.united(cellRect) : cellRect;
+            } else
+                allDirty = false;
+        }
+    }
+
+    // buckets whose cells scrolled off screen must sync too or they would
+    // come back dirty when a new cell takes them over
+    for (auto& region : m_regionStatus)
+        region.first = region.second;
+
+    if (!fullRepaint && !allDirty && dirty.isValid())
+        m_dirtyRegion = dirty;
+}
+
+void DrawPool::scroll(const Point& offset)
+{
+    if (offset == Point())
+        return;
+
+    // the blit request for the render side, and the new grid anchor: dests
+    // hashed from now on are translated so a tile keeps its cell hash while
+    // its framebuffer position slides with the camera
+    m_scrollOffset += offset;
+    m_regionOrigin -= offset;
 }
 
 bool DrawPool::canRepaint(const bool autoUpdateStatus)
 {
+    const bool hashChanged = m_status.first != m_status.second;
+
+    // adaptive refresh: every timed re-recording that hashes identical to the
+    // previous frame doubles the refresh delay (up to IDLE_REFRESH_DELAY_MAX),
+    // and any real change snaps it back, so idle clients decay towards
+    // event-driven repaints while clock-animated content (particles, shader
+    // uniforms) keeps the full rate by changing the hash every recording
+    if (autoUpdateStatus && m_updateHash && m_refreshDelay > 0) {
+        if (hashChanged)
+            m_idleBackoff = 0;
+        else if (m_shaderRefreshDelay == 0 && m_idleBackoff < IDLE_BACKOFF_MAX)
+            ++m_idleBackoff;
+    }
+
     uint16_t refreshDelay = m_refreshDelay;
-    if (m_shaderRefreshDelay > 0 && (m_refreshDelay == 0 || m_shaderRefreshDelay < m_refreshDelay))
+    if (m_idleBackoff > 0)
+        refreshDelay = static_cast<uint16_t>(std::min<int>(m_refreshDelay << m_idleBackoff, IDLE_REFRESH_DELAY_MAX));
+    if (m_shaderRefreshDelay > 0 && (refreshDelay == 0 || m_shaderRefreshDelay < refreshDelay))
         refreshDelay = m_shaderRefreshDelay;
 
-    const bool canRepaint = (m_status.first != m_status.second) || (refreshDelay > 0 && m_refreshTimer.ticksElapsed() >= refreshDelay);
+    const bool timedRepaint = refreshDelay > 0 && m_refreshTimer.ticksElapsed() >= refreshDelay;
+
+    // a timed wake alone still triggers the re-recording (that is how changes
+    // that bypass repaint() get discovered), but once the recorded content
+    // hashes the same as what the framebuffer already holds only a shader
+    // animation justifies submitting it again
+    const bool canRepaint = hashChanged || (timedRepaint && !(autoUpdateStatus && m_updateHash && m_shaderRefreshDelay == 0));
 
     if (canRepaint) {
         if (static_cast<bool>(m_refreshDelay) != autoUpdateStatus)
             m_refreshTimer.restart();
 
-        if (autoUpdateStatus)
+        if (autoUpdateStatus) {
+            updateDirtyRegion();
             m_status.first = m_status.second;
+        }
     }
 
     return canRepaint;
 }
 
+void DrawPool::takeSnapshot()
+{
+    m_snapshot.enabled = m_enabled;
+    if (!m_enabled)
+        return;
+
+    if (m_framebuffer && m_framebufferPrepare) {
+        m_framebufferPrepare = false;
+        m_framebuffer->prepare(m_framebufferDest, m_framebufferSrc, m_framebufferClear);
+    }
+
+    // nothing was recorded since the last take, keep drawing the previous
+    // snapshot; this also keeps the last frame on screen while a slow event
+    // loop iteration delays the next recording
+    if (m_frameId == m_snapshot.frameId)
+        return;
+
+    m_snapshot.frameId = m_frameId;
+    m_snapshot.repaint = !m_framebuffer || canRepaint(true);
+    if (m_framebuffer && !m_snapshot.repaint)
+        return;
+
+    m_snapshot.dirtyRegion = m_dirtyRegion;
+    m_snapshot.scrollOffset = m_scrollOffset;
+    m_scrollOffset = {};
+    m_snapshot.depthLevel = m_depthLevel;
+
+    // the recorded objects move to the render side together with the arena
+    // generation backing their coords; the generation of the snapshot just
+    // replaced is already drawn, so it goes back for the next recording
+    for (int_fast8_t i = -1; ++i <= MAX_DRAW_DEPTH;) {
+        for (int_fast8_t j = -1; ++j < static_cast<uint8_t>(DrawOrder::LAST);)
+            m_snapshot.objects[i][j].swap(m_objects[i][j]);
+    }
+    m_coordsBufferCache.swap(m_snapshot.coordsCache);
+    m_coordsBufferIndex = 0;
+    m_snapshot.sorted = false;
+}
+
+void DrawPool::sortSnapshot()
+{
+    if (m_snapshot.sorted)
+        return;
+    m_snapshot.sorted = true;
+
+    // the foreground, text and creature information buckets encode stacking
+    // order between overlapping draws, only the map (which already merges
+    // equal-state draws out of order when crowded) and the light pool
+    // (additive, order independent) tolerate reordering
+    if (m_type != DrawPoolType::MAP && m_type != DrawPoolType::LIGHT)
+        return;
+
+    for (int_fast8_t i = -1; ++i <= m_snapshot.depthLevel;) {
+        for (auto& order : m_snapshot.objects[i]) {
+            if (order.size() < 2)
+                continue;
+
+            // actions can bind framebuffers or mutate raw gl state, so they
+            // act as barriers and only the runs between them are sorted
+            auto first = order.begin();
+            while (first != order.end()) {
+                if (first->action) {
+                    ++first;
+                    continue;
+                }
+
+                auto last = first;
+                while (last != order.end() && !last->action)
+                    ++last;
+
+                std::stable_sort(first, last, [](const DrawObject& a, const DrawObject& b) {
+                    if (a.state.shaderProgram != b.state.shaderProgram)
+                        return a.state.shaderProgram < b.state.shaderProgram;
+                    if (a.state.texture != b.state.texture)
+                        return a.state.texture < b.state.texture;
+                    return a.state.hash < b.state.hash;
+                });
+
+                // equal-state draws are adjacent now, collapse each run into
+                // a single command the same way add() merges consecutive ones
+                for (auto it = first; it != last; ++it) {
+                    auto next = it + 1;
+                    while (next != last && next->state.hash == it->state.hash) {
+                        if (it->coords && next->coords && it->drawMode == DrawMode::TRIANGLES && next->drawMode == DrawMode::TRIANGLES) {
+                            it->coords->append(next->coords.get());
+                            next->coords = nullptr;
+                        } else if (!it->coords && !next->coords) {
+                            for (auto& method : next->methods)
+                                it->addMethod(method);
+                            next->methods.clear();
+                        } else
+                            break;
+
+                        ++next;
+                    }
+                    it = next - 1;
+                }
+
+                first = last;
+            }
+
+            std::erase_if(order, [](const DrawObject& obj) {
+                return !obj.action && !obj.coords && obj.methods.empty();
+            });
+        }
+    }
+}
+
 void DrawPool::scale(float x, float y)
 {
     const Matrix3 scaleMatrix = {
@@ -333,6 +614,59 @@ void DrawPool::popTransformMatrix()
     m_transformMatrixStack.pop_back();
 }
 
+void DrawPool::buildCoordsBuffers()
+{
+    // nothing will be repainted, keep the buffers from the previous frame
+    if (!canRepaint(false))
+        return;
+
+    // recording is single threaded, but triangulating the queued methods is
+    // independent per object; the arena buffers are handed out serially here
+    // and filled in parallel by the async dispatcher workers. the segments
+    // (one per depth level, i.e. one per floor on the MAP pool) stay
+    // concatenated in m_objects exactly as they were recorded.
+    static constexpr size_t BATCH_SIZE = 128;
+
+    std::atomic_int pending{ 0 };
+    std::vector<DrawObject*> batch;
+    batch.reserve(BATCH_SIZE);
+
+    const auto& dispatchBatch = [&] {
+        ++pending;
+        g_asyncDispatcher.dispatch([objects = batch, &pending] {
+            for (auto* obj : objects) {
+                for (const auto& method : obj->methods)
+                    addCoords(obj->coords.get(), method, obj->drawMode);
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        }, AsyncDispatcher::Priority::HIGH);
+        batch.clear();
+    };
+
+    for (int_fast8_t depth = -1; ++depth <= m_depthLevel;) {
+        for (auto& order : m_objects[depth]) {
+            for (auto& obj : order) {
+                if (obj.coords || obj.action || obj.methods.empty())
+                    continue;
+
+                obj.coords = getTemporaryCoordsBuffer();
+                batch.emplace_back(&obj);
+
+                if (batch.size() == BATCH_SIZE)
+                    dispatchBatch();
+            }
+        }
+    }
+
+    if (!batch.empty())
+        dispatchBatch();
+
+    // the tasks are tiny, just spin for the stragglers while still holding
+    // the pool mutex so the render thread only ever sees finished buffers
+    while (pending.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+}
+
 void DrawPool::optimize(int size) {
     if (m_type != DrawPoolType::MAP)
         return;
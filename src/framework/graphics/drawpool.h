@@ -79,8 +79,19 @@ public:
     bool canRepaint() { return canRepaint(false); }
     void repaint() { m_status.first = 1; }
 
+    // declares that the content recorded from now on is the previous frame
+    // shifted by offset (a camera step); the render side blits the old
+    // framebuffer at that offset and the region grid re-anchors so only the
+    // exposed band and real changes come out dirty
+    void scroll(const Point& offset);
+
     void optimize(int size);
 
+    // triangulates every queued method into its own coords buffer using the
+    // async dispatcher workers; must be called between the end of recording
+    // and the release of the pool mutex
+    void buildCoordsBuffers();
+
     void setScaleFactor(float scale) { m_scaleFactor = scale; }
     inline float getScaleFactor() const { return m_scaleFactor; }
 
@@ -159,6 +170,8 @@ private:
     static DrawPool* create(const DrawPoolType type);
     static void addCoords(CoordsBuffer* buffer, const DrawPool::DrawMethod& method, DrawMode drawMode);
 
+    const CoordsBufferPtr& getTemporaryCoordsBuffer();
+
     enum STATE_TYPE : uint32_t
     {
         STATE_OPACITY = 1 << 0,
@@ -170,13 +183,21 @@ private:
 
     void add(const Color& color, const TexturePtr& texture, DrawPool::DrawMethod& method,
              DrawMode drawMode = DrawMode::TRIANGLES, const DrawConductor& conductor = DEFAULT_DRAW_CONDUCTOR,
-             const CoordsBufferPtr& coordsBuffer = nullptr);
+             const CoordsBufferPtr& coordsBuffer = nullptr, const Point& coordsOffset = {});
 
     void resetState();
     inline void setFPS(uint16_t fps) { m_refreshDelay = fps; }
 
     PoolState getState(const DrawPool::DrawMethod& method, const TexturePtr& texture, const Color& color);
 
+    void updateRegionStatus(const DrawMethod& method, const PoolState& state, size_t objectHash);
+    void updateDirtyRegion();
+
+    // floor division/modulo mapping screen coords (possibly negative once
+    // translated by the scroll origin) onto the wrapped region grid
+    static int toCell(const int v) { return v >= 0 ? v / REGION_SIZE : -((REGION_SIZE - 1 - v) / REGION_SIZE); }
+    static int wrapCell(const int v, const int n) { const int m = v % n; return m < 0 ? m + n : m; }
+
     float getOpacity() const { return m_state.opacity; }
     Rect getClipRect() { return m_state.clipRect; }
 
@@ -217,6 +238,15 @@ private:
 
     bool canRepaint(bool autoUpdateStatus);
 
+    // moves the recorded frame into m_snapshot; called by the render thread
+    // under the pool mutex so GL submission can then run without it
+    void takeSnapshot();
+
+    // reorders each snapshot bucket by (shader, texture, state) and merges
+    // the equal-state draws that become adjacent; only applied to pools
+    // whose buckets don't encode stacking order
+    void sortSnapshot();
+
     bool m_enabled{ true };
     bool m_updateHash{ true };
     bool m_alwaysGroupDrawings{ false };
@@ -224,25 +254,85 @@ private:
     uint8_t m_depthLevel{ 0 };
 
     uint16_t m_refreshDelay{ 0 }, m_shaderRefreshDelay{ 0 };
+    uint8_t m_idleBackoff{ 0 }; // doublings applied to m_refreshDelay while the content hash is stable
     uint32_t m_onlyOnceStateFlag{ 0 };
 
     PoolState m_state, m_oldState;
 
+    // packed key over the slow-moving part of the state (everything except
+    // color, texture and the draw method); consecutive commands almost always
+    // repeat it, so its hash is only recomputed when the key bytes change
+    struct BaseStateKey
+    {
+        size_t transform{ 0 };
+        int clip[4]{ 0, 0, 0, 0 };
+        float opacity{ 0.f };
+        uint32_t shader{ 0 };
+        uint8_t composition{ 0 };
+        uint8_t blend{ 0 };
+    };
+    BaseStateKey m_stateKey;
+    size_t m_stateKeyHash{ 0 };
+
     DrawPoolType m_type{ DrawPoolType::UNKNOW };
 
     Timer m_refreshTimer;
 
     std::pair<size_t, size_t> m_status{ 1, 0 };
 
+    size_t m_frameId{ 0 }; // bumped on every recording pass, see takeSnapshot()
+
+    // per-cell draw state hashes (REGION_SIZE pixel cells over the framebuffer),
+    // used to scissor the repaint to the cells that actually changed
+    static constexpr uint16_t REGION_SIZE = 256;
+    std::vector<std::pair<size_t, size_t>> m_regionStatus;
+    std::pair<size_t, size_t> m_globalStatus{ 0, 0 }; // draws that can't be localized
+    uint16_t m_regionsX{ 0 }, m_regionsY{ 0 };
+    Rect m_dirtyRegion;
+
+    // accumulated scroll pending for the next snapshot and the world anchor
+    // the region grid hashes against, see scroll()
+    Point m_scrollOffset;
+    Point m_regionOrigin;
+
     std::vector<Matrix3> m_transformMatrixStack;
     std::vector<DrawObject> m_objects[MAX_DRAW_DEPTH + 1][static_cast<uint8_t>(DrawOrder::LAST)];
 
     stdext::map<size_t, DrawObject> m_objectsByhash;
 
+    // frame-scoped coords buffer arena, reclaimed as a whole on resetState()
+    std::vector<CoordsBufferPtr> m_coordsBufferCache;
+    size_t m_coordsBufferIndex{ 0 };
+
     float m_scaleFactor{ 1.f };
 
+    // render-side copy of the last recorded frame, taken under the pool
+    // mutex with a few vector moves so the recording threads are never
+    // blocked behind the GL submission; the arena generation backing the
+    // objects' coords travels with them and is handed back on the next take
+    struct FrameSnapshot
+    {
+        std::vector<DrawObject> objects[MAX_DRAW_DEPTH + 1][static_cast<uint8_t>(DrawOrder::LAST)];
+        std::vector<CoordsBufferPtr> coordsCache;
+        Rect dirtyRegion;
+        Point scrollOffset;
+        size_t frameId{ 0 };
+        uint8_t depthLevel{ 0 };
+        bool repaint{ false };
+        bool enabled{ false };
+        bool sorted{ false };
+    };
+    FrameSnapshot m_snapshot;
+
     FrameBufferPtr m_framebuffer;
 
+    // framebuffer dest/src requested by use(); the framebuffer is drawn
+    // outside the mutex now, so it is only ever touched by the render
+    // thread and the request is applied at snapshot time
+    Rect m_framebufferDest, m_framebufferSrc;
+    Color m_framebufferClear{ Color::alpha };
+    bool m_framebufferPrepare{ false };
+
     std::function<void()> m_beforeDraw;
     std::function<void()> m_afterDraw;
 
@@ -23,10 +23,16 @@
 #include "drawpoolmanager.h"
 #include "declarations.h"
 #include "painter.h"
+#include <framework/core/frameprofiler.h>
+#include <framework/core/memorytracker.h>
 #include <framework/graphics/framebuffermanager.h>
 
 thread_local static uint8_t CURRENT_POOL;
 
+#ifndef OPENGL_ES
+static constexpr const char* POOL_NAMES[] = { "map", "creature_information", "light", "text", "foreground", "unknow" };
+#endif
+
 DrawPoolManager g_drawPool;
 
 void DrawPoolManager::init(uint16_t spriteSize)
@@ -38,6 +44,26 @@ void DrawPoolManager::init(uint16_t spriteSize)
     for (int8_t i = -1; ++i <= static_cast<uint8_t>(DrawPoolType::UNKNOW);) {
         m_pools[i] = DrawPool::create(static_cast<DrawPoolType>(i));
     }
+
+    g_memory.registerGauge("draw-pools", [this] { return getMemoryUsage(); });
+}
+
+// the bulk of pool memory sits in the coords buffer arenas; sum their
+// capacities under each pool's mutex since recording may be in flight
+size_t DrawPoolManager::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto& pool : m_pools) {
+        if (!pool)
+            continue;
+
+        std::scoped_lock lock(pool->m_mutex);
+        for (const auto& coords : pool->m_coordsBufferCache)
+            bytes += coords->getMemoryUsage();
+        for (const auto& coords : pool->m_snapshot.coordsCache)
+            bytes += coords->getMemoryUsage();
+    }
+    return bytes;
 }
 
 void DrawPoolManager::terminate() const
@@ -46,6 +72,15 @@ void DrawPoolManager::terminate() const
     for (int_fast8_t i = -1; ++i <= static_cast<uint8_t>(DrawPoolType::UNKNOW);) {
         delete m_pools[i];
     }
+
+#ifndef OPENGL_ES
+    for (const auto& queries : m_gpuQueries) {
+        for (const auto query : queries) {
+            if (query != 0)
+                glDeleteQueries(1, &query);
+        }
+    }
+#endif
 }
 
 DrawPool* DrawPoolManager::getCurrentPool() const { return m_pools[CURRENT_POOL]; }
@@ -53,52 +88,94 @@ void DrawPoolManager::select(DrawPoolType type) { CURRENT_POOL = static_cast<uin
 
 void DrawPoolManager::draw()
 {
+    PROFILE_SCOPE("DrawPoolManager::draw");
+
+    m_gpuQueryParity ^= 1;
+
     if (m_size != g_graphics.getViewportSize()) {
         m_size = g_graphics.getViewportSize();
         m_transformMatrix = g_painter->getTransformMatrix(m_size);
         g_painter->setResolution(m_size, m_transformMatrix);
     }
 
-    const auto& map = get(DrawPoolType::MAP); {
+    // snapshot each pool's recorded frame under its mutex, then submit the
+    // GL work from the snapshots so the recording threads only ever wait
+    // for a few vector moves, never for the GPU
+    const auto& map = get(DrawPoolType::MAP);
+    const auto& creatureInfo = get(DrawPoolType::CREATURE_INFORMATION);
+    const auto& light = get(DrawPoolType::LIGHT);
+    {
         std::scoped_lock l(map->m_mutex);
-        if (drawPool(map)) {
-            drawPool(get(DrawPoolType::CREATURE_INFORMATION));
-            drawPool(get(DrawPoolType::LIGHT));
-        }
+        map->takeSnapshot();
+        creatureInfo->takeSnapshot();
+        light->takeSnapshot();
     }
 
     const auto& text = get(DrawPoolType::TEXT); {
         std::scoped_lock l(text->m_mutex);
-        drawPool(text);
+        text->takeSnapshot();
     }
 
     const auto& foreground = get(DrawPoolType::FOREGROUND); {
         std::scoped_lock l(foreground->m_mutex);
-        drawPool(foreground);
+        foreground->takeSnapshot();
+    }
+
+    if (drawPool(map)) {
+        drawPool(creatureInfo);
+        drawPool(light);
     }
+
+    drawPool(text);
+    drawPool(foreground);
 }
 
 bool DrawPoolManager::drawPool(const auto& pool) {
-    if (!pool->isEnabled())
+    if (!pool->m_snapshot.enabled)
         return false;
 
+    beginGpuTimer(pool->getType());
+    const bool drawn = drawPoolObjects(pool);
+    endGpuTimer(pool->getType());
+    return drawn;
+}
+
+bool DrawPoolManager::drawPoolObjects(const auto& pool) {
+    auto& snapshot = pool->m_snapshot;
+
+    // framebuffer binds and the previous pool leave the painter in an
+    // arbitrary state, start each pool with the cache invalidated
+    m_lastStateHash = 0;
+
     if (!pool->hasFrameBuffer()) {
-        for (const auto& obj : pool->m_objects[0][DrawOrder::FIRST]) {
+        pool->sortSnapshot();
+        for (const auto& obj : snapshot.objects[0][DrawOrder::FIRST]) {
             drawObject(obj);
         }
+        flushDrawBatch();
         return true;
     }
 
     if (!pool->m_framebuffer->canDraw())
         return false;
 
-    if (pool->canRepaint(true)) {
-        pool->m_framebuffer->bind();
-        for (int_fast8_t i = -1; ++i <= pool->m_depthLevel;) {
-            for (const auto& order : pool->m_objects[i])
+    if (snapshot.repaint) {
+        snapshot.repaint = false;
+        pool->sortSnapshot();
+
+        // when only a few region cells changed, the repaint (and the clear on
+        // bind) is scissored to their union and the rest of the framebuffer
+        // keeps the previous frame's content; a scroll offset additionally
+        // blits that content shifted, but is pointless on a full repaint
+        pool->m_framebuffer->bind(snapshot.dirtyRegion,
+                                  snapshot.dirtyRegion.isValid() ? snapshot.scrollOffset : Point());
+        snapshot.scrollOffset = {};
+        for (int_fast8_t i = -1; ++i <= snapshot.depthLevel;) {
+            for (const auto& order : snapshot.objects[i])
                 for (const auto& obj : order)
                     drawObject(obj);
         }
+        flushDrawBatch();
 
         pool->m_framebuffer->release();
     }
@@ -112,28 +189,91 @@ bool DrawPoolManager::drawPool(const auto& pool) {
     return true;
 }
 
+void DrawPoolManager::beginGpuTimer(const DrawPoolType type)
+{
+#ifndef OPENGL_ES
+    if (!g_profiler.isEnabled())
+        return;
+
+    const auto index = static_cast<uint8_t>(type);
+    auto& query = m_gpuQueries[index][m_gpuQueryParity];
+    if (query == 0)
+        glGenQueries(1, &query);
+    else if (m_gpuQueryPending[index][m_gpuQueryParity]) {
+        // collect the result armed a parity cycle ago before reusing the query
+        GLuint available = 0;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return; // skip this pool for a frame rather than stalling
+
+        GLuint64 nanos = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanos);
+        g_profiler.addGpuSample(POOL_NAMES[index], nanos);
+        m_gpuQueryPending[index][m_gpuQueryParity] = false;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    m_gpuTimerActive = true;
+#endif
+}
+
+void DrawPoolManager::endGpuTimer(const DrawPoolType type)
+{
+#ifndef OPENGL_ES
+    if (!m_gpuTimerActive)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_gpuQueryPending[static_cast<uint8_t>(type)][m_gpuQueryParity] = true;
+    m_gpuTimerActive = false;
+#endif
+}
+
 void DrawPoolManager::drawObject(const DrawPool::DrawObject& obj)
 {
     if (obj.action) {
+        flushDrawBatch();
         obj.action();
+        m_lastStateHash = 0; // actions may touch the painter behind our back
         return;
     }
 
-    auto& coords = !obj.coords ? m_coordsBuffer : *obj.coords;
-    if (!obj.coords) {
-        coords.clear();
-        for (const auto& method : obj.methods)
-            DrawPool::addCoords(&coords, method, obj.drawMode);
+    // the pool precomputed a hash over the whole state block; when it matches
+    // the previously executed one the painter is already set up and the
+    // per-field re-apply (and its GL calls) can be skipped entirely
+    if (obj.state.action || obj.state.hash == 0 || obj.state.hash != m_lastStateHash) {
+        flushDrawBatch();
+        obj.state.execute();
+        m_lastStateHash = obj.state.action ? 0 : obj.state.hash;
+    }
+
+    // externally cached buffers keep their own upload, but stay in order
+    if (obj.coords) {
+        flushDrawBatch();
+        g_painter->drawCoords(*obj.coords, obj.drawMode);
+        return;
     }
 
-    obj.state.execute();
-    g_painter->drawCoords(coords, obj.drawMode);
+    // a whole sorted same-state run accumulates here and is submitted in a
+    // single draw on the next state change, see flushDrawBatch()
+    for (const auto& method : obj.methods)
+        DrawPool::addCoords(&m_coordsBuffer, method, DrawMode::TRIANGLES);
+}
+
+void DrawPoolManager::flushDrawBatch()
+{
+    if (m_coordsBuffer.getVertexCount() == 0)
+        return;
+
+    g_painter->drawCoords(m_coordsBuffer);
+    m_coordsBuffer.clear();
 }
 
-void DrawPoolManager::addTexturedCoordsBuffer(const TexturePtr& texture, const CoordsBufferPtr& coords, const Color& color) const
+void DrawPoolManager::addTexturedCoordsBuffer(const TexturePtr& texture, const CoordsBufferPtr& coords, const Color& color,
+                                              const Point& coordsOffset, const DrawConductor& condutor) const
 {
     DrawPool::DrawMethod method;
-    getCurrentPool()->add(color, texture, method, DrawMode::TRIANGLE_STRIP, DEFAULT_DRAW_CONDUCTOR, coords);
+    getCurrentPool()->add(color, texture, method, DrawMode::TRIANGLE_STRIP, condutor, coords, coordsOffset);
 }
 
 void DrawPoolManager::addTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src, const Color& color, const DrawConductor& condutor) const
@@ -208,24 +348,35 @@ void DrawPoolManager::addAction(const std::function<void()>& action) const
     getCurrentPool()->m_objects[0][DrawOrder::FIRST].emplace_back(action);
 }
 
-void DrawPoolManager::bindFrameBuffer(const Size& size) const
+void DrawPoolManager::bindFrameBuffer(const Size& size, const FrameBufferPtr& frame) const
 {
     getCurrentPool()->m_oldState = std::move(getCurrentPool()->m_state);
     getCurrentPool()->m_state = {};
 
-    g_drawPool.addAction([size, drawState = getCurrentPool()->m_state] {
+    g_drawPool.addAction([size, frame, drawState = getCurrentPool()->m_state] {
         drawState.execute();
-        const auto& frame = g_framebuffers.getTemporaryFrameBuffer();
-        frame->resize(size);
-        frame->bind();
+        const auto& buffer = frame ? frame : g_framebuffers.acquireTemporaryFrameBuffer(size);
+        if (frame)
+            frame->resize(size);
+        buffer->bind();
     });
 }
-void DrawPoolManager::releaseFrameBuffer(const Rect& dest) const
+void DrawPoolManager::releaseFrameBuffer(const Rect& dest, const FrameBufferPtr& frame) const
 {
     getCurrentPool()->m_state = std::move(getCurrentPool()->m_oldState);
-    g_drawPool.addAction([dest, drawState = getCurrentPool()->m_state] {
-        const auto& frame = g_framebuffers.getTemporaryFrameBuffer();
-        frame->release();
+    g_drawPool.addAction([dest, frame, drawState = getCurrentPool()->m_state] {
+        const auto& buffer = frame ? frame : g_framebuffers.getTemporaryFrameBuffer();
+        buffer->release();
+        drawState.execute();
+        buffer->draw(dest);
+        if (!frame)
+            g_framebuffers.releaseTemporaryFrameBuffer();
+    });
+}
+
+void DrawPoolManager::drawFrameBuffer(const FrameBufferPtr& frame, const Rect& dest) const
+{
+    g_drawPool.addAction([dest, frame, drawState = getCurrentPool()->m_state] {
         drawState.execute();
         frame->draw(dest);
     });
@@ -241,7 +392,12 @@ void DrawPoolManager::use(const DrawPoolType type, const Rect& dest, const Rect&
     currentPoll->resetState();
 
     if (currentPoll->hasFrameBuffer()) {
-        currentPoll->m_framebuffer->prepare(dest, src, colorClear);
+        // the framebuffer belongs to the render thread now, the requested
+        // dest/src is applied when the next snapshot is taken
+        currentPoll->m_framebufferDest = dest;
+        currentPoll->m_framebufferSrc = src;
+        currentPoll->m_framebufferClear = colorClear;
+        currentPoll->m_framebufferPrepare = true;
 
         // when the selected pool is MAP, reset the creature information state.
         if (type == DrawPoolType::MAP) {
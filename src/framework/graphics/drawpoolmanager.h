@@ -46,7 +46,8 @@ public:
     { addTexturedRect(dest, texture, Rect(Point(), texture->getSize()), color); }
 
     void addTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src, const Color& color = Color::white, const DrawConductor& condutor = DEFAULT_DRAW_CONDUCTOR) const;
-    void addTexturedCoordsBuffer(const TexturePtr& texture, const CoordsBufferPtr& coords, const Color& color = Color::white) const;
+    void addTexturedCoordsBuffer(const TexturePtr& texture, const CoordsBufferPtr& coords, const Color& color = Color::white,
+                                 const Point& coordsOffset = {}, const DrawConductor& condutor = DEFAULT_DRAW_CONDUCTOR) const;
     void addUpsideDownTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src, const Color& color = Color::white) const;
     void addTexturedRepeatedRect(const Rect& dest, const TexturePtr& texture, const Rect& src, const Color& color = Color::white) const;
     void addFilledRect(const Rect& dest, const Color& color = Color::white, const DrawConductor& condutor = DEFAULT_DRAW_CONDUCTOR) const;
@@ -54,8 +55,11 @@ public:
     void addBoundingRect(const Rect& dest, const Color& color = Color::white, uint16_t innerLineWidth = 1) const;
     void addAction(const std::function<void()>& action) const;
 
-    void bindFrameBuffer(const Size& size) const;
-    void releaseFrameBuffer(const Rect& dest) const;
+    // when no frame is given a pooled temporary is acquired for the
+    // bind/release pair; a caller-owned frame keeps its content across frames
+    void bindFrameBuffer(const Size& size, const FrameBufferPtr& frame = nullptr) const;
+    void releaseFrameBuffer(const Rect& dest, const FrameBufferPtr& frame = nullptr) const;
+    void drawFrameBuffer(const FrameBufferPtr& frame, const Rect& dest) const;
 
     void setOpacity(const float opacity, bool onlyOnce = false) const { getCurrentPool()->setOpacity(opacity, onlyOnce); }
     void setClipRect(const Rect& clipRect, bool onlyOnce = false) const { getCurrentPool()->setClipRect(clipRect, onlyOnce); }
@@ -90,6 +94,8 @@ public:
 
     DrawPoolType getCurrentType() const { return getCurrentPool()->m_type; }
 
+    size_t getMemoryUsage() const;
+
 private:
     DrawPool* getCurrentPool() const;
 
@@ -98,11 +104,31 @@ private:
     void terminate() const;
     void drawObject(const DrawPool::DrawObject& obj);
 
+    // submits the batch of same-state objects accumulated in m_coordsBuffer
+    // as one draw; quads go indexed through the shared quad index buffer, so
+    // an entire sorted run costs a single glDrawElements on GL and GLES alike
+    void flushDrawBatch();
+
     bool drawPool(const auto& pool);
+    bool drawPoolObjects(const auto& pool);
+
+    void beginGpuTimer(DrawPoolType type);
+    void endGpuTimer(DrawPoolType type);
 
     CoordsBuffer m_coordsBuffer;
     std::array<DrawPool*, static_cast<uint8_t>(DrawPoolType::UNKNOW) + 1> m_pools{};
 
+    // hash of the last executed PoolState; consecutive objects sharing it skip
+    // the whole state re-apply, zero means the painter state is unknown
+    size_t m_lastStateHash{ 0 };
+
+    // double buffered GL_TIME_ELAPSED queries per pool, results are read one
+    // parity cycle later so the pipeline is never stalled
+    std::array<std::array<uint32_t, 2>, static_cast<uint8_t>(DrawPoolType::UNKNOW) + 1> m_gpuQueries{};
+    std::array<std::array<bool, 2>, static_cast<uint8_t>(DrawPoolType::UNKNOW) + 1> m_gpuQueryPending{};
+    uint8_t m_gpuQueryParity{ 0 };
+    bool m_gpuTimerActive{ false };
+
     Size m_size;
     Matrix3 m_transformMatrix;
 
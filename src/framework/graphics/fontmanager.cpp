@@ -34,12 +34,14 @@ void FontManager::terminate()
 {
     m_fonts.clear();
     m_defaultFont = nullptr;
+    m_glyphAtlas.clear();
 }
 
 void FontManager::clearFonts()
 {
     m_fonts.clear();
     m_defaultFont = std::make_shared<BitmapFont>("emptyfont");
+    m_glyphAtlas.clear();
 }
 
 bool FontManager::importFont(const std::string& file)
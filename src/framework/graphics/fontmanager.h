@@ -23,6 +23,7 @@
 #pragma once
 
 #include "bitmapfont.h"
+#include "textureatlas.h"
 
  //@bindsingleton g_fonts
 class FontManager
@@ -41,9 +42,14 @@ public:
 
     void setDefaultFont(const std::string_view fontName) { m_defaultFont = getFont(fontName); }
 
+    // atlas shared by every font glyph sheet, so text drawn with different
+    // fonts still merges into a single textured batch
+    TextureAtlas& getGlyphAtlas() { return m_glyphAtlas; }
+
 private:
     std::vector<BitmapFontPtr> m_fonts;
     BitmapFontPtr m_defaultFont;
+    TextureAtlas m_glyphAtlas;
 };
 
 extern FontManager g_fonts;
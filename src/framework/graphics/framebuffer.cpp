@@ -31,52 +31,66 @@
 
 uint32_t FrameBuffer::boundFbo = 0;
 
-FrameBuffer::FrameBuffer()
-{
-    glGenFramebuffers(1, &m_fbo);
-    if (!m_fbo)
-        g_logger.fatal("Unable to create framebuffer object");
-}
-
 FrameBuffer::~FrameBuffer()
 {
 #ifndef NDEBUG
     assert(!g_app.isTerminated());
 #endif
-    if (g_graphics.ok() && m_fbo != 0)
-        glDeleteFramebuffers(1, &m_fbo);
+    if (g_graphics.ok() && m_fbo != 0) {
+        // widgets may drop their cached framebuffer from any thread, defer
+        // the deletion like Texture does
+        g_mainDispatcher.addEvent([fbo = m_fbo]() {
+            glDeleteFramebuffers(1, &fbo);
+        });
+    }
 }
 
 bool FrameBuffer::resize(const Size& size)
 {
     assert(size.isValid());
 
-    if (m_texture && m_texture->getSize() == size)
+    if (m_size == size)
         return false;
 
-    m_texture = std::make_shared<Texture>(size);
-    m_texture->setSmooth(m_smooth);
-    m_texture->setUpsideDown(true);
+    m_size = size;
     m_textureMatrix = g_painter->getTransformMatrix(size);
 
     m_screenCoordsBuffer.clear();
     m_screenCoordsBuffer.addRect(Rect{ 0, 0, size });
 
-    internalBind();
+    // the attachment is recreated lazily on the next bind, so a burst of
+    // resizes (window dragging) only ever allocates the final size
+    m_textureUpdate = true;
+
+    return true;
+}
+
+void FrameBuffer::updateTexture()
+{
+    if (!m_textureUpdate || !m_size.isValid())
+        return;
+
+    m_textureUpdate = false;
+
+    m_texture = std::make_shared<Texture>(m_size);
+    m_texture->setSmooth(m_smooth);
+    m_texture->setUpsideDown(true);
+
+    // size or filtering changed, the spare scroll attachment is recreated
+    // to match on its next use
+    m_scrollTexture = nullptr;
+
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture->getId(), 0);
 
     const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE)
         g_logger.fatal("Unable to setup framebuffer object");
-
-    internalRelease();
-
-    return true;
 }
 
-void FrameBuffer::bind()
+void FrameBuffer::bind(const Rect& clipBound, const Point& scrollOffset)
 {
     internalBind();
+    updateTexture();
 
     if (m_isScene) {
         g_painter->resetState();
@@ -88,6 +102,16 @@ void FrameBuffer::bind()
     g_painter->setResolution(getSize(), m_textureMatrix);
     g_painter->setAlphaWriting(m_useAlphaWriting);
 
+    // a camera step shifted the scene: reuse the previous frame blitted at
+    // the new offset, the scissored repaint below fills what it exposed
+    if (scrollOffset != Point())
+        internalScroll(scrollOffset);
+
+    // scissor a partial repaint (including the clear below) to the caller's
+    // dirty region, content outside it is kept from the previous frame
+    m_oldClipBound = g_painter->getClipBound();
+    g_painter->setClipBound(clipBound);
+
     if (m_colorClear != Color::alpha) {
         g_painter->setTexture(nullptr);
         g_painter->setColor(m_colorClear);
@@ -101,6 +125,7 @@ void FrameBuffer::release() const
 {
     internalRelease();
     g_painter->setResolution(m_oldSize, m_oldTextureMatrix);
+    g_painter->setClipBound(m_oldClipBound);
 }
 
 void FrameBuffer::draw()
@@ -113,8 +138,39 @@ void FrameBuffer::draw()
     if (m_disableBlend) glEnable(GL_BLEND);
 }
 
+void FrameBuffer::internalScroll(const Point& offset)
+{
+    if (!m_scrollTexture || m_scrollTexture->getSize() != m_size) {
+        m_scrollTexture = std::make_shared<Texture>(m_size);
+        m_scrollTexture->setSmooth(m_smooth);
+        m_scrollTexture->setUpsideDown(true);
+    }
+
+    // sampling the attachment being rendered is undefined, so the shifted
+    // copy lands on a spare texture that then takes over as the attachment
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_scrollTexture->getId(), 0);
+
+    g_painter->setCompositionMode(CompositionMode::REPLACE);
+    g_painter->setColor(Color::white);
+    g_painter->setTexture(m_texture.get());
+    m_scrollCoordsBuffer.clear();
+    m_scrollCoordsBuffer.addQuad(Rect(offset, m_size), Rect(0, 0, m_size));
+    g_painter->drawCoords(m_scrollCoordsBuffer, DrawMode::TRIANGLE_STRIP);
+    g_painter->resetCompositionMode();
+
+    std::swap(m_texture, m_scrollTexture);
+}
+
 void FrameBuffer::internalBind()
 {
+    // the fbo is created on first bind so FrameBuffer objects can be
+    // constructed from threads without a GL context
+    if (m_fbo == 0) {
+        glGenFramebuffers(1, &m_fbo);
+        if (!m_fbo)
+            g_logger.fatal("Unable to create framebuffer object");
+    }
+
     assert(boundFbo != m_fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
     m_prevBoundFbo = boundFbo;
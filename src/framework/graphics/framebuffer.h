@@ -29,21 +29,20 @@
 class FrameBuffer
 {
 public:
-    FrameBuffer();
     ~FrameBuffer();
 
     void release() const;
-    void bind();
+    void bind(const Rect& clipBound = {}, const Point& scrollOffset = {});
     void draw();
     void draw(const Rect& dest) { prepare(dest, Rect(0, 0, getSize())); draw(); }
 
-    void setSmooth(bool enabled) { m_smooth = enabled; m_texture = nullptr; }
+    void setSmooth(bool enabled) { m_smooth = enabled; m_textureUpdate = true; }
 
     bool resize(const Size& size);
-    bool isValid() const { return m_texture != nullptr; }
+    bool isValid() const { return m_size.isValid(); }
     bool canDraw() const { return m_coordsBuffer.getVertexCount() > 0; }
     TexturePtr getTexture() const { return m_texture; }
-    Size getSize() const { return m_texture->getSize(); }
+    Size getSize() const { return m_size; }
 
     void setCompositionMode(const CompositionMode mode) { m_compositeMode = mode; }
     void disableBlend() { m_disableBlend = true; }
@@ -60,12 +59,16 @@ private:
 
     void internalBind();
     void internalRelease() const;
+    void internalScroll(const Point& offset);
+    void updateTexture();
     void prepare(const Rect& dest, const Rect& src, const Color& colorClear = Color::alpha);
 
+    Size m_size;
     Size m_oldSize;
 
     Matrix3 m_textureMatrix, m_oldTextureMatrix;
     TexturePtr m_texture;
+    TexturePtr m_scrollTexture; // spare attachment for internalScroll()
 
     uint32_t m_fbo{ 0 };
     uint32_t m_prevBoundFbo{ 0 };
@@ -76,10 +79,13 @@ private:
     bool m_useAlphaWriting{ true };
     bool m_disableBlend{ false };
     bool m_isScene{ false };
+    bool m_textureUpdate{ false };
 
     Rect m_dest;
     Rect m_src;
+    Rect m_oldClipBound;
 
     CoordsBuffer m_coordsBuffer;
     CoordsBuffer m_screenCoordsBuffer;
+    CoordsBuffer m_scrollCoordsBuffer;
 };
@@ -26,8 +26,44 @@ FrameBufferManager g_framebuffers;
 
 void FrameBufferManager::init()
 {
-    m_temporaryFramebuffer = std::make_shared<FrameBuffer>();
-    m_temporaryFramebuffer->setSmooth(true);
+    m_pool.reserve(MAX_POOL_SIZE);
 }
 
-void FrameBufferManager::terminate() { m_temporaryFramebuffer = nullptr; }
+void FrameBufferManager::terminate()
+{
+    m_pool.clear();
+    m_acquired.clear();
+}
+
+const FrameBufferPtr& FrameBufferManager::acquireTemporaryFrameBuffer(const Size& size)
+{
+    // prefer an exact size match, its attachment can be reused as is;
+    // otherwise any free buffer works, its attachment is recreated lazily
+    // on the next bind
+    auto it = std::find_if(m_pool.begin(), m_pool.end(), [&](const FrameBufferPtr& frame) { return frame->getSize() == size; });
+    if (it == m_pool.end() && !m_pool.empty())
+        it = m_pool.end() - 1;
+
+    FrameBufferPtr frame;
+    if (it != m_pool.end()) {
+        frame = std::move(*it);
+        m_pool.erase(it);
+    } else {
+        frame = std::make_shared<FrameBuffer>();
+        frame->setSmooth(true);
+    }
+
+    frame->resize(size);
+    return m_acquired.emplace_back(std::move(frame));
+}
+
+void FrameBufferManager::releaseTemporaryFrameBuffer()
+{
+    assert(!m_acquired.empty());
+
+    auto frame = std::move(m_acquired.back());
+    m_acquired.pop_back();
+
+    if (m_pool.size() < MAX_POOL_SIZE)
+        m_pool.emplace_back(std::move(frame));
+}
@@ -26,14 +26,26 @@
 
 class FrameBufferManager
 {
+    enum
+    {
+        // free temporaries kept around for reuse
+        MAX_POOL_SIZE = 8
+    };
+
 public:
     void init();
     void terminate();
 
-    const FrameBufferPtr& getTemporaryFrameBuffer() { return m_temporaryFramebuffer; }
+    // acquires a pooled framebuffer sized for the caller; paired with
+    // releaseTemporaryFrameBuffer(), acquisitions may nest
+    const FrameBufferPtr& acquireTemporaryFrameBuffer(const Size& size);
+    void releaseTemporaryFrameBuffer();
+
+    const FrameBufferPtr& getTemporaryFrameBuffer() const { return m_acquired.back(); }
 
 protected:
-    FrameBufferPtr m_temporaryFramebuffer;
+    std::vector<FrameBufferPtr> m_pool;     // free, ready for reuse
+    std::vector<FrameBufferPtr> m_acquired; // in use, stack ordered
 };
 
 extern FrameBufferManager g_framebuffers;
@@ -52,6 +52,11 @@ void Graphics::init()
     if (err != GLEW_OK)
         g_logger.fatal(stdext::format("Unable to init GLEW: %s", glewGetErrorString(err)));
 
+    // let drivers that support it compile shaders on their own worker
+    // threads, so shaders compiled mid-game hitch less on cache misses
+    if (GLEW_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+
     // overwrite framebuffer API if needed
     if (GLEW_EXT_framebuffer_object && !GLEW_ARB_framebuffer_object) {
         glGenFramebuffers = glGenFramebuffersEXT;
@@ -38,6 +38,128 @@ HardwareBuffer::~HardwareBuffer()
 #ifndef NDEBUG
     assert(!g_app.isTerminated());
 #endif
-    if (g_graphics.ok())
+    if (g_graphics.ok()) {
+        destroyRing();
         glDeleteBuffers(1, &m_id);
+    }
+}
+
+bool HardwareBuffer::isPersistentMapSupported()
+{
+#ifndef OPENGL_ES
+    static const bool supported = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool HardwareBuffer::isPersistent() const
+{
+#ifndef OPENGL_ES
+    return m_persistentData != nullptr;
+#else
+    return false;
+#endif
+}
+
+const float* HardwareBuffer::streamOffset() const
+{
+#ifndef OPENGL_ES
+    if (m_persistentData)
+        return reinterpret_cast<const float*>(static_cast<intptr_t>(m_regionSize) * m_regionIndex);
+#endif
+    return nullptr;
+}
+
+void HardwareBuffer::write(const void* data, int count, UsagePattern usage)
+{
+    ++m_generation;
+
+#ifndef OPENGL_ES
+    if (usage == UsagePattern::DYNAMIC_DRAW && isPersistentMapSupported()) {
+        if (!m_persistentData || count > m_regionSize)
+            setupRing(count);
+
+        if (m_persistentData) {
+            m_regionIndex = (m_regionIndex + 1) % RING_REGIONS;
+
+            // wait until the GPU has consumed the draw that last used this region
+            if (auto& sync = m_fences[m_regionIndex]) {
+                while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+                glDeleteSync(sync);
+                sync = nullptr;
+            }
+
+            memcpy(m_persistentData + static_cast<size_t>(m_regionSize) * m_regionIndex, data, count);
+            return;
+        }
+    }
+#endif
+
+    glBufferData(static_cast<GLenum>(m_type), count, data, static_cast<GLenum>(usage));
+}
+
+void HardwareBuffer::fence()
+{
+#ifndef OPENGL_ES
+    if (!m_persistentData)
+        return;
+
+    if (m_fences[m_regionIndex])
+        glDeleteSync(m_fences[m_regionIndex]);
+    m_fences[m_regionIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+}
+
+void HardwareBuffer::setupRing(int count)
+{
+#ifndef OPENGL_ES
+    destroyRing();
+
+    // round up so the ring does not have to be rebuilt on every small growth
+    int regionSize = 4096;
+    while (regionSize < count)
+        regionSize <<= 1;
+
+    // buffer storage is immutable, growing requires a fresh buffer object
+    glDeleteBuffers(1, &m_id);
+    glGenBuffers(1, &m_id);
+    bind();
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(static_cast<GLenum>(m_type), static_cast<GLsizeiptr>(regionSize) * RING_REGIONS, nullptr, flags);
+    m_persistentData = static_cast<uint8_t*>(glMapBufferRange(static_cast<GLenum>(m_type), 0,
+                                             static_cast<GLsizeiptr>(regionSize) * RING_REGIONS, flags));
+    if (!m_persistentData) {
+        // fall back to a mutable buffer fed by plain glBufferData
+        glDeleteBuffers(1, &m_id);
+        glGenBuffers(1, &m_id);
+        bind();
+        m_regionSize = 0;
+        return;
+    }
+
+    m_regionSize = regionSize;
+    m_regionIndex = 0;
+#endif
+}
+
+void HardwareBuffer::destroyRing()
+{
+#ifndef OPENGL_ES
+    for (auto& sync : m_fences) {
+        if (sync) {
+            glDeleteSync(sync);
+            sync = nullptr;
+        }
+    }
+
+    if (m_persistentData) {
+        bind();
+        glUnmapBuffer(static_cast<GLenum>(m_type));
+        m_persistentData = nullptr;
+        m_regionSize = 0;
+    }
+#endif
 }
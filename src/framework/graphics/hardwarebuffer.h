@@ -40,14 +40,46 @@ public:
         DYNAMIC_DRAW = GL_DYNAMIC_DRAW
     };
 
+    // number of in-flight regions of the persistent-mapped ring
+    static constexpr int RING_REGIONS = 3;
+
     HardwareBuffer(Type type);
     ~HardwareBuffer();
 
     void bind() const { glBindBuffer(static_cast<GLenum>(m_type), m_id); }
     static void unbind(Type type) { glBindBuffer(static_cast<GLenum>(type), 0); }
-    void write(void const* data, int count, UsagePattern usage) const { glBufferData(static_cast<GLenum>(m_type), count, data, static_cast<GLenum>(usage)); }
+
+    // DYNAMIC_DRAW writes stream through a persistent-mapped triple-buffered
+    // ring when the driver supports it, turning the upload into a memcpy
+    // instead of a glBufferData respecification that can stall on the driver.
+    void write(const void* data, int count, UsagePattern usage);
+
+    // attribute pointer offset of the region written by the last write()
+    const float* streamOffset() const;
+
+    // bumped on every write(), lets VAO captures detect that the backing
+    // storage moved (ring region advance or buffer respecification)
+    uint32_t generation() const { return m_generation; }
+
+    // must be called after the draw that consumed the current region
+    void fence();
+
+    bool isPersistent() const;
+
+    static bool isPersistentMapSupported();
 
 private:
+    void setupRing(int count);
+    void destroyRing();
+
     Type m_type;
     uint32_t m_id;
+    uint32_t m_generation{ 0 };
+
+#ifndef OPENGL_ES
+    uint8_t* m_persistentData{ nullptr };
+    int m_regionSize{ 0 };
+    int m_regionIndex{ 0 };
+    GLsync m_fences[RING_REGIONS]{};
+#endif
 };
@@ -28,6 +28,16 @@
 
 #include "framework/stdext/math.h"
 
+namespace
+{
+    // rgba bytes as they sit in the pixel buffer, read as one
+    // little-endian 32bit word
+    uint32_t packPixel(const Color& color)
+    {
+        return color.r() | color.g() << 8 | color.b() << 16 | static_cast<uint32_t>(color.a()) << 24;
+    }
+}
+
 Image::Image(const Size& size, int bpp, uint8_t* pixels) : m_size(size), m_bpp(bpp)
 {
     m_pixels.resize(size.area() * bpp, 0);
@@ -85,40 +95,28 @@ void Image::overwriteMask(const Color& maskedColor, const Color& insideColor, co
 {
     assert(m_bpp == 4);
 
-    for (int p = 0; p < getPixelCount(); ++p) {
-        uint8_t& r = m_pixels[p * 4 + 0];
-        uint8_t& g = m_pixels[p * 4 + 1];
-        uint8_t& b = m_pixels[p * 4 + 2];
-        uint8_t& a = m_pixels[p * 4 + 3];
-
-        Color pixelColor(r, g, b, a);
-        Color writeColor = (pixelColor == maskedColor) ? insideColor : outsideColor;
+    // whole-pixel compare and select, vectorizes to packed compare + blend
+    const uint32_t masked = packPixel(maskedColor);
+    const uint32_t inside = packPixel(insideColor);
+    const uint32_t outside = packPixel(outsideColor);
 
-        r = writeColor.r();
-        g = writeColor.g();
-        b = writeColor.b();
-        a = writeColor.a();
-    }
+    auto* pixels = reinterpret_cast<uint32_t*>(m_pixels.data());
+    const int count = getPixelCount();
+    for (int p = 0; p < count; ++p)
+        pixels[p] = pixels[p] == masked ? inside : outside;
 }
 
 void Image::overwrite(const Color& color)
 {
     assert(m_bpp == 4);
 
-    for (int p = 0; p < getPixelCount(); ++p) {
-        uint8_t& r = m_pixels[p * 4 + 0];
-        uint8_t& g = m_pixels[p * 4 + 1];
-        uint8_t& b = m_pixels[p * 4 + 2];
-        uint8_t& a = m_pixels[p * 4 + 3];
+    const uint32_t transparent = packPixel(Color::alpha);
+    const uint32_t write = packPixel(color);
 
-        Color pixelColor(r, g, b, a);
-        Color writeColor = (pixelColor == Color::alpha) ? Color::alpha : color;
-
-        r = writeColor.r();
-        g = writeColor.g();
-        b = writeColor.b();
-        a = writeColor.a();
-    }
+    auto* pixels = reinterpret_cast<uint32_t*>(m_pixels.data());
+    const int count = getPixelCount();
+    for (int p = 0; p < count; ++p)
+        pixels[p] = pixels[p] == transparent ? transparent : write;
 }
 
 void Image::blit(const Point& dest, const ImagePtr& other)
@@ -128,18 +126,23 @@ void Image::blit(const Point& dest, const ImagePtr& other)
     if (!other)
         return;
 
-    const uint8_t* otherPixels = other->getPixelData();
-    for (int p = 0; p < other->getPixelCount(); ++p) {
-        const int x = p % other->getWidth();
-        const int y = p / other->getWidth();
-        const int pos = ((dest.y + y) * m_size.width() + (dest.x + x)) * 4;
-
-        if (otherPixels[p * 4 + 3] != 0) {
-            m_pixels[pos + 0] = otherPixels[p * 4 + 0];
-            m_pixels[pos + 1] = otherPixels[p * 4 + 1];
-            m_pixels[pos + 2] = otherPixels[p * 4 + 2];
-            m_pixels[pos + 3] = otherPixels[p * 4 + 3];
+    // row-based 32bit walk: the alpha test and the copy become straight
+    // word ops the compiler can vectorize, and the per-pixel divisions of
+    // the old position math are gone; this runs for every sprite composed
+    // during sheet decode
+    const int ow = other->getWidth();
+    const int oh = other->getHeight();
+    const auto* src = reinterpret_cast<const uint32_t*>(other->getPixelData());
+    auto* dst = reinterpret_cast<uint32_t*>(m_pixels.data()) + dest.y * m_size.width() + dest.x;
+
+    for (int y = 0; y < oh; ++y) {
+        for (int x = 0; x < ow; ++x) {
+            const uint32_t pixel = src[x];
+            if (pixel & 0xFF000000u)
+                dst[x] = pixel;
         }
+        src += ow;
+        dst += m_size.width();
     }
 }
 
@@ -150,17 +153,14 @@ void Image::paste(const ImagePtr& other)
     if (!other)
         return;
 
-    const uint8_t* otherPixels = other->getPixelData();
-    for (int p = 0; p < other->getPixelCount(); ++p) {
-        const int x = p % other->getWidth();
-        const int y = p / other->getWidth();
-        const int pos = (y * m_size.width() + x) * 4;
+    // unconditional copy, one memcpy per row
+    const int ow = other->getWidth();
+    const int oh = other->getHeight();
+    const uint8_t* src = other->getPixelData();
+    uint8_t* dst = m_pixels.data();
 
-        m_pixels[pos + 0] = otherPixels[p * 4 + 0];
-        m_pixels[pos + 1] = otherPixels[p * 4 + 1];
-        m_pixels[pos + 2] = otherPixels[p * 4 + 2];
-        m_pixels[pos + 3] = otherPixels[p * 4 + 3];
-    }
+    for (int y = 0; y < oh; ++y)
+        memcpy(dst + static_cast<size_t>(y) * m_size.width() * 4, src + static_cast<size_t>(y) * ow * 4, static_cast<size_t>(ow) * 4);
 }
 
 bool Image::nextMipmap()
@@ -56,8 +56,30 @@ Painter::Painter()
     m_drawReplaceColorProgram->addShaderFromSourceCode(ShaderType::FRAGMENT, std::string{ glslMainFragmentShader } + glslReplaceColorFragmentShader.data());
     m_drawReplaceColorProgram->link();
 
+    m_drawTextSdfProgram = std::make_shared<PainterShaderProgram>();
+    assert(m_drawTextSdfProgram);
+    m_drawTextSdfProgram->addShaderFromSourceCode(ShaderType::VERTEX, std::string{ glslMainWithTexCoordsVertexShader } + glslPositionOnlyVertexShader.data());
+    m_drawTextSdfProgram->addShaderFromSourceCode(ShaderType::FRAGMENT, std::string{ glslMainFragmentShader } + glslTextSdfFragmentShader.data());
+    m_drawTextSdfProgram->link();
+
     PainterShaderProgram::release();
 
+    // pre-build the quad index pattern (lt, rt, lb) + (lb, rt, rb) once
+    {
+        std::vector<uint16_t> indices(MAX_INDEXED_QUADS * 6);
+        for (int q = 0; q < MAX_INDEXED_QUADS; ++q) {
+            const auto base = static_cast<uint16_t>(q * 4);
+            uint16_t* i = indices.data() + static_cast<size_t>(q) * 6;
+            i[0] = base; i[1] = base + 1; i[2] = base + 2;
+            i[3] = base + 2; i[4] = base + 1; i[5] = base + 3;
+        }
+
+        m_quadIndexBuffer = new HardwareBuffer(HardwareBuffer::Type::INDEX_BUFFER);
+        m_quadIndexBuffer->bind();
+        m_quadIndexBuffer->write(indices.data(), indices.size() * sizeof(uint16_t), HardwareBuffer::UsagePattern::STATIC_DRAW);
+        HardwareBuffer::unbind(HardwareBuffer::Type::INDEX_BUFFER);
+    }
+
     refreshState();
 
     // vertex and texture coord attributes are always enabled
@@ -91,37 +113,103 @@ void Painter::drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode)
 
     coordsBuffer.cache(); // Try to cache
 
-    // only set texture coords arrays when needed
-    {
-        if (textured) {
-            m_drawProgram->setTextureMatrix(m_textureMatrix);
-            m_drawProgram->bindMultiTextures();
+    if (textured) {
+        m_drawProgram->setTextureMatrix(m_textureMatrix);
+        m_drawProgram->bindMultiTextures();
+    }
+
+    const auto* vertexHardwareBuffer = coordsBuffer.getHardwareVertexCache();
+    const auto* texCoordHardwareBuffer = coordsBuffer.getHardwareTextureCoordCache();
 
+    // fully hardware-cached buffers keep their attribute setup in a VAO,
+    // so the steady-state draw is a bind instead of respecifying both
+    // pointers and having the driver revalidate them on every call
+    const bool useVao = vertexHardwareBuffer && (!textured || texCoordHardwareBuffer) && CoordsBuffer::isVaoSupported();
+
+    // points both attribute arrays at the given quad, rebinding the backing
+    // buffer first because glVertexAttribPointer captures the binding
+    const auto setAttributePointers = [&](const int quadOffset) {
+        const int floatOffset = quadOffset * 8; // 4 vertices of 2 floats per quad
+
+        if (textured) {
             const auto* hardwareBuffer = coordsBuffer.getHardwareTextureCoordCache();
             if (hardwareBuffer)
                 hardwareBuffer->bind();
 
-            m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR, hardwareBuffer ? nullptr : coordsBuffer.getTextureCoordArray(), 2);
-        } else
-            PainterShaderProgram::disableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
-    }
+            m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR,
+                (hardwareBuffer ? hardwareBuffer->streamOffset() : coordsBuffer.getTextureCoordArray()) + floatOffset, 2);
+        }
 
-    // set vertex array
-    {
         const auto* hardwareBuffer = coordsBuffer.getHardwareVertexCache();
         if (hardwareBuffer)
             hardwareBuffer->bind();
 
-        m_drawProgram->setAttributeArray(PainterShaderProgram::VERTEX_ATTR, hardwareBuffer ? nullptr : coordsBuffer.getVertexArray(), 2);
+        m_drawProgram->setAttributeArray(PainterShaderProgram::VERTEX_ATTR,
+            (hardwareBuffer ? hardwareBuffer->streamOffset() : coordsBuffer.getVertexArray()) + floatOffset, 2);
+
+        if (coordsBuffer.isCached())
+            HardwareBuffer::unbind(HardwareBuffer::Type::VERTEX_BUFFER);
+    };
+
+    if (useVao) {
+        glBindVertexArray(coordsBuffer.vao());
+
+        const uint32_t vertexGen = vertexHardwareBuffer->generation();
+        const uint32_t texCoordGen = textured ? texCoordHardwareBuffer->generation() : 0;
+        if (!coordsBuffer.vaoMatches(vertexGen, texCoordGen, textured)) {
+            // enables and pointers are VAO state, capture them once
+            PainterShaderProgram::enableAttributeArray(PainterShaderProgram::VERTEX_ATTR);
+            if (textured)
+                PainterShaderProgram::enableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
+            else
+                PainterShaderProgram::disableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
+            setAttributePointers(0);
+            m_quadIndexBuffer->bind(); // the element binding is captured too
+            coordsBuffer.captureVao(vertexGen, texCoordGen, textured);
+        }
+    } else {
+        if (!textured)
+            PainterShaderProgram::disableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
+        setAttributePointers(0);
     }
 
-    if (coordsBuffer.isCached())
-        HardwareBuffer::unbind(HardwareBuffer::Type::VERTEX_BUFFER);
+    if (const int quadCount = coordsBuffer.getQuadCount()) {
+        // 4 vertices per quad through the shared static index buffer,
+        // a third fewer vertices generated, uploaded and shaded
+        if (!useVao)
+            m_quadIndexBuffer->bind();
+
+        int drawn = std::min<int>(quadCount, MAX_INDEXED_QUADS);
+        glDrawElements(GL_TRIANGLES, drawn * 6, GL_UNSIGNED_SHORT, nullptr);
+        ++m_drawCallCount;
+
+        while (drawn < quadCount) {
+            const int batch = std::min<int>(quadCount - drawn, MAX_INDEXED_QUADS);
+            setAttributePointers(drawn);
+            glDrawElements(GL_TRIANGLES, batch * 6, GL_UNSIGNED_SHORT, nullptr);
+            ++m_drawCallCount;
+            drawn += batch;
+            // the extra batches moved the captured pointers off quad zero
+            if (useVao)
+                coordsBuffer.invalidateVao();
+        }
+
+        if (!useVao)
+            HardwareBuffer::unbind(HardwareBuffer::Type::INDEX_BUFFER);
+    } else {
+        // free-form triangle buffers keep the array draw path
+        glDrawArrays(static_cast<GLenum>(drawMode), 0, vertexCount);
+        ++m_drawCallCount;
+    }
+
+    if (useVao)
+        glBindVertexArray(0);
 
-    // draw the element in coords buffers
-    glDrawArrays(static_cast<GLenum>(drawMode), 0, vertexCount);
+    // protect the ring regions just consumed from being overwritten next frame
+    if (coordsBuffer.isCached())
+        coordsBuffer.fenceHardwareCaches();
 
-    if (!textured)
+    if (!textured && !useVao)
         PainterShaderProgram::enableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
 }
 
@@ -188,6 +276,15 @@ void Painter::setClipRect(const Rect& clipRect)
     updateGlClipRect();
 }
 
+void Painter::setClipBound(const Rect& clipBound)
+{
+    if (m_clipBound == clipBound)
+        return;
+
+    m_clipBound = clipBound;
+    updateGlClipRect();
+}
+
 void Painter::setTexture(Texture* texture)
 {
     if (m_texture == texture)
@@ -269,13 +366,22 @@ void Painter::updateGlCompositionMode() const
 
 void Painter::updateGlClipRect() const
 {
-    if (m_clipRect.isValid()) {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(m_clipRect.left(), m_resolution.height() - m_clipRect.bottom() - 1, m_clipRect.width(), m_clipRect.height());
-    } else {
+    if (!m_clipRect.isValid() && !m_clipBound.isValid()) {
         glScissor(0, 0, m_resolution.width(), m_resolution.height());
         glDisable(GL_SCISSOR_TEST);
+        return;
     }
+
+    // the clip bound restricts every clip rect set while it is active
+    auto clipRect = m_clipRect.isValid() ? m_clipRect : Rect(0, 0, m_resolution);
+    if (m_clipBound.isValid())
+        clipRect = clipRect.intersection(m_clipBound);
+
+    glEnable(GL_SCISSOR_TEST);
+    if (clipRect.isValid())
+        glScissor(clipRect.left(), m_resolution.height() - clipRect.bottom() - 1, clipRect.width(), clipRect.height());
+    else
+        glScissor(0, 0, 0, 0); // empty intersection, scissor everything out
 }
 void Painter::updateGlTexture() const { if (m_glTextureId != 0) glBindTexture(GL_TEXTURE_2D, m_glTextureId); }
 void Painter::updateGlBlendEquation() const { glBlendEquation(static_cast<GLenum>(m_blendEquation)); }
@@ -56,12 +56,17 @@ class Painter
 {
 public:
     Painter();
+    ~Painter() { delete m_quadIndexBuffer; }
 
     void clear(const Color& color);
     void clearRect(const Color& color, const Rect& rect);
 
     void drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode = DrawMode::TRIANGLES);
 
+    // per-frame draw call accounting, consumed by g_benchmark on the
+    // render thread right after the frame is drawn
+    uint32_t popDrawCallCount() { const uint32_t count = m_drawCallCount; m_drawCallCount = 0; return count; }
+
     float getOpacity() const { return m_opacity; }
     bool getAlphaWriting() const { return m_alphaWriting; }
 
@@ -72,16 +77,19 @@ public:
 
     Color getColor() const { return m_color; }
     Rect getClipRect() const { return m_clipRect; }
+    Rect getClipBound() const { return m_clipBound; }
     Size getResolution() const { return m_resolution; }
     BlendEquation getBlendEquation() const { return m_blendEquation; }
     CompositionMode getCompositionMode() const { return m_compositionMode; }
     PainterShaderProgram* getShaderProgram() const { return m_shaderProgram; }
     PainterShaderProgramPtr getReplaceColorShader() const { return m_drawReplaceColorProgram; }
+    PainterShaderProgramPtr getTextSdfShader() const { return m_drawTextSdfProgram; }
 
     void setColor(const Color& color) { m_color = color; }
     void setTexture(Texture* texture);
     void setOpacity(float opacity) { m_opacity = opacity; }
     void setClipRect(const Rect& clipRect);
+    void setClipBound(const Rect& clipBound);
     void setResolution(const Size& resolution, const Matrix3& projectionMatrix = DEFAULT_MATRIX3);
     void setDrawProgram(PainterShaderProgram* drawProgram) { m_drawProgram = drawProgram; }
     void setAlphaWriting(bool enable);
@@ -99,12 +107,14 @@ public:
     void resetTexture() { setTexture(nullptr); }
     void resetAlphaWriting() { setAlphaWriting(false); }
     void resetClipRect() { setClipRect({}); }
+    void resetClipBound() { setClipBound({}); }
     void resetOpacity() { setOpacity(1.f); }
     void resetCompositionMode() { setCompositionMode(CompositionMode::NORMAL); }
     void resetColor() { setColor(Color::white); }
     void resetShaderProgram() { setShaderProgram(nullptr); }
     void resetTransformMatrix() { setTransformMatrix(DEFAULT_MATRIX3); }
     bool isReplaceColorShader(const PainterShaderProgram* shader) const { return m_drawReplaceColorProgram.get() == shader; }
+    bool isTextSdfShader(const PainterShaderProgram* shader) const { return m_drawTextSdfProgram.get() == shader; }
 
 protected:
     void refreshState() const;
@@ -123,6 +133,7 @@ protected:
     Texture* m_texture{ nullptr };
     bool m_alphaWriting{ false };
     uint32_t m_glTextureId{ 0 };
+    uint32_t m_drawCallCount{ 0 };
 
     float m_opacity{ 1.f };
 
@@ -132,6 +143,10 @@ protected:
     Size m_resolution;
     Rect m_clipRect;
 
+    // while valid, restricts every clip rect at the glScissor level; set by
+    // FrameBuffer::bind for partial repaints and survives resetState()
+    Rect m_clipBound;
+
     friend class FrameBuffer;
     friend class DrawPoolManager;
     friend class DrawPool;
@@ -140,6 +155,13 @@ protected:
     PainterShaderProgramPtr m_drawTexturedProgram;
     PainterShaderProgramPtr m_drawSolidColorProgram;
     PainterShaderProgramPtr m_drawReplaceColorProgram;
+    PainterShaderProgramPtr m_drawTextSdfProgram;
+
+    // every quad shares the same two-triangle index pattern, so one static
+    // element buffer serves the indexed draws of all pools; 16-bit indices
+    // address 4 * MAX_INDEXED_QUADS vertices, bigger batches draw in chunks
+    static constexpr int MAX_INDEXED_QUADS = 16383;
+    HardwareBuffer* m_quadIndexBuffer{ nullptr };
 };
 
 extern Painter* g_painter;
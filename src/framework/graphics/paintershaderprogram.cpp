@@ -156,6 +156,17 @@ void PainterShaderProgram::addMultiTexture(const std::string& file)
     m_multiTextures.emplace_back(texture);
 }
 
+void PainterShaderProgram::addMultiTexture(const TexturePtr& texture)
+{
+    if (m_multiTextures.size() > 3)
+        g_logger.error("cannot add more multi textures to shader, the max is 3");
+
+    if (!texture)
+        return;
+
+    m_multiTextures.emplace_back(texture);
+}
+
 void PainterShaderProgram::bindMultiTextures() const
 {
     if (m_multiTextures.empty())
@@ -62,6 +62,8 @@ public:
     void updateTime();
 
     void addMultiTexture(const std::string& file);
+    void addMultiTexture(const TexturePtr& texture);
+    void clearMultiTextures() { m_multiTextures.clear(); }
     void bindMultiTextures() const;
 
 private:
@@ -22,70 +22,128 @@
 
 #include "particle.h"
 #include "drawpoolmanager.h"
+#include "particleaffector.h"
+#include "particletype.h"
 
-void Particle::render() const
+void Particles::add(const Point& position, const PointF& velocity, const PointF& acceleration,
+                    float duration, const ParticleTypePtr& type)
 {
-    if (!m_texture) {
-        g_drawPool.addFilledRect(m_rect, m_color);
-        return;
-    }
+    m_positions.emplace_back(position.x, position.y);
+    m_velocities.emplace_back(velocity);
+    m_accelerations.emplace_back(acceleration);
+    m_elapsedTimes.emplace_back(0.f);
+    m_durations.emplace_back(duration);
+    m_ignorePhysicsAfter.emplace_back(type->pIgnorePhysicsAfter);
+    m_colors.emplace_back(type->pColors[0]);
+    m_colorStages.emplace_back(0);
+    m_rects.emplace_back();
+    m_types.emplace_back(type);
+}
 
-    g_drawPool.setCompositionMode(m_compositionMode, true);
-    g_drawPool.addTexturedRect(m_rect, m_texture, m_color);
+void Particles::applyAffector(const ParticleAffector& affector, float elapsedTime)
+{
+    const size_t count = size();
+    for (size_t i = 0; i < count; ++i)
+        affector.updateParticle(m_positions[i], m_velocities[i], elapsedTime);
 }
 
-void Particle::update(float elapsedTime)
+void Particles::removeFinished()
 {
-    // check if finished
-    if (m_duration >= 0 && m_elapsedTime >= m_duration) {
-        m_finished = true;
-        return;
+    const size_t count = size();
+    size_t j = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (m_durations[i] >= 0 && m_elapsedTimes[i] >= m_durations[i])
+            continue;
+
+        if (i != j) {
+            m_positions[j] = m_positions[i];
+            m_velocities[j] = m_velocities[i];
+            m_accelerations[j] = m_accelerations[i];
+            m_elapsedTimes[j] = m_elapsedTimes[i];
+            m_durations[j] = m_durations[i];
+            m_ignorePhysicsAfter[j] = m_ignorePhysicsAfter[i];
+            m_colors[j] = m_colors[i];
+            m_colorStages[j] = m_colorStages[i];
+            m_rects[j] = m_rects[i];
+            m_types[j] = m_types[i];
+        }
+        ++j;
     }
 
-    updateColor();
-    updateSize();
-    updatePosition(elapsedTime);
+    if (j == count)
+        return;
 
-    m_elapsedTime += elapsedTime;
+    m_positions.resize(j);
+    m_velocities.resize(j);
+    m_accelerations.resize(j);
+    m_elapsedTimes.resize(j);
+    m_durations.resize(j);
+    m_ignorePhysicsAfter.resize(j);
+    m_colors.resize(j);
+    m_colorStages.resize(j);
+    m_rects.resize(j);
+    m_types.resize(j);
 }
 
-void Particle::updatePosition(float elapsedTime)
+void Particles::update(const float elapsedTime)
 {
-    if (m_ignorePhysicsAfter < 0 || m_elapsedTime < m_ignorePhysicsAfter) {
-        // update position
-        PointF delta = m_velocity * elapsedTime;
-        delta.y *= -1; // painter orientate Y axis in the inverse direction
+    removeFinished();
 
-        const auto& position = m_position + delta;
+    const size_t count = size();
 
-        if (m_position != position) {
-            m_position += delta;
-        }
+    // physics pass
+    for (size_t i = 0; i < count; ++i) {
+        if (m_ignorePhysicsAfter[i] >= 0 && m_elapsedTimes[i] >= m_ignorePhysicsAfter[i])
+            continue;
 
-        // update acceleration
-        m_velocity += m_acceleration * elapsedTime;
+        // painter orientates the Y axis in the inverse direction
+        m_positions[i].x += m_velocities[i].x * elapsedTime;
+        m_positions[i].y -= m_velocities[i].y * elapsedTime;
+        m_velocities[i] += m_accelerations[i] * elapsedTime;
     }
 
-    m_rect.move(static_cast<int>(m_position.x) - m_size.width() / 2, static_cast<int>(m_position.y) - m_size.height() / 2);
-}
+    // color pass, walks each particle along its type gradient
+    for (size_t i = 0; i < count; ++i) {
+        const auto* type = m_types[i].get();
+        const auto& colors = type->pColors;
+        const auto& stops = type->pColorsStops;
+        const float life = m_elapsedTimes[i] / m_durations[i];
 
-void Particle::updateSize()
-{
-    m_size = m_startSize + (m_finalSize - m_startSize) / m_duration * m_elapsedTime;
-    m_rect.resize(m_size);
+        uint32_t& stage = m_colorStages[i];
+        if (stage + 1 < colors.size()) {
+            if (life < stops[stage + 1]) {
+                const float range = stops[stage + 1] - stops[stage];
+                const float factor = (life - stops[stage]) / range;
+                m_colors[i] = colors[stage] * (1.f - factor) + colors[stage + 1] * factor;
+            } else
+                ++stage;
+        } else
+            m_colors[i] = colors[stage];
+    }
+
+    // size/rect pass
+    for (size_t i = 0; i < count; ++i) {
+        const auto* type = m_types[i].get();
+        const Size size = type->pStartSize + (type->pFinalSize - type->pStartSize) / m_durations[i] * m_elapsedTimes[i];
+        m_rects[i] = Rect(Point(static_cast<int>(m_positions[i].x) - size.width() / 2,
+                                static_cast<int>(m_positions[i].y) - size.height() / 2), size);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        m_elapsedTimes[i] += elapsedTime;
 }
 
-void Particle::updateColor()
+void Particles::render() const
 {
-    const float currentLife = m_elapsedTime / m_duration;
-    if (currentLife < m_colorsStops[1]) {
-        const float range = m_colorsStops[1] - m_colorsStops[0];
-        const float factor = (currentLife - m_colorsStops[0]) / range;
-        m_color = m_colors[0] * (1.0f - factor) + m_colors[1] * factor;
-    } else if (m_colors.size() > 1) {
-        m_colors.erase(m_colors.begin());
-        m_colorsStops.erase(m_colorsStops.begin());
-    } else if (m_color != m_colors[0]) {
-        m_color = m_colors[0];
+    const size_t count = size();
+    for (size_t i = 0; i < count; ++i) {
+        const auto* type = m_types[i].get();
+        if (!type->pTexture) {
+            g_drawPool.addFilledRect(m_rects[i], m_colors[i]);
+            continue;
+        }
+
+        g_drawPool.setCompositionMode(type->pCompositionMode, true);
+        g_drawPool.addTexturedRect(m_rects[i], type->pTexture, m_colors[i]);
     }
 }
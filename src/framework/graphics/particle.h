@@ -23,49 +23,37 @@
 #pragma once
 
 #include "declarations.h"
-#include "painter.h"
 
-class Particle
+// Structure-of-arrays particle storage: every hot field lives in its own
+// contiguous array, so the per-frame passes in update() run as branch-light
+// loops over flat memory instead of chasing a list of heap particles.
+class Particles
 {
 public:
-    Particle(const Point& pos, const Size& startSize, const Size& finalSize, const PointF& velocity,
-                       const PointF& acceleration, float duration, float ignorePhysicsAfter, const std::vector<Color>& colors,
-                       const std::vector<float>& colorsStops, CompositionMode compositionMode, const TexturePtr& texture) :
-        m_colors(colors), m_colorsStops(colorsStops), m_texture(texture), m_position(PointF(pos.x, pos.y)),
-        m_velocity(velocity), m_acceleration(acceleration), m_startSize(startSize), m_finalSize(finalSize),
-        m_compositionMode(compositionMode), m_duration(duration), m_ignorePhysicsAfter(ignorePhysicsAfter)
-    {}
+    void add(const Point& position, const PointF& velocity, const PointF& acceleration,
+             float duration, const ParticleTypePtr& type);
 
-    void render() const;
+    void applyAffector(const ParticleAffector& affector, float elapsedTime);
     void update(float elapsedTime);
+    void render() const;
 
-    bool hasFinished() const { return m_finished; }
-
-    PointF getPosition() { return m_position; }
-    PointF getVelocity() { return m_velocity; }
-
-    void setPosition(const PointF& position) { m_position = position; }
-    void setVelocity(const PointF& velocity) { m_velocity = velocity; }
+    bool empty() const { return m_positions.empty(); }
+    size_t size() const { return m_positions.size(); }
 
 private:
-    void updateColor();
-    void updatePosition(float elapsedTime);
-    void updateSize();
-
-    Color m_color;
+    void removeFinished();
+
+    // hot state, one entry per particle
+    std::vector<PointF> m_positions;
+    std::vector<PointF> m_velocities;
+    std::vector<PointF> m_accelerations;
+    std::vector<float> m_elapsedTimes;
+    std::vector<float> m_durations;
+    std::vector<float> m_ignorePhysicsAfter;
     std::vector<Color> m_colors;
-    std::vector<float> m_colorsStops;
-    TexturePtr m_texture;
-    PointF m_position;
-    PointF m_velocity;
-    PointF m_acceleration;
-    Size m_size;
-    Size m_startSize;
-    Size m_finalSize;
-    Rect m_rect;
-    CompositionMode m_compositionMode;
-    float m_duration;
-    float m_ignorePhysicsAfter;
-    float m_elapsedTime{ 0 };
-    bool m_finished{ false };
+    std::vector<uint32_t> m_colorStages;
+    std::vector<Rect> m_rects;
+
+    // cold state, shared with the emitter type (gradient, sizes, texture)
+    std::vector<ParticleTypePtr> m_types;
 };
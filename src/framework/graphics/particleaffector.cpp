@@ -21,7 +21,6 @@
  */
 
 #include "particleaffector.h"
-#include "particle.h"
 
 void ParticleAffector::update(float elapsedTime)
 {
@@ -77,14 +76,9 @@ void GravityAffector::load(const OTMLNodePtr& node)
     }
 }
 
-void GravityAffector::updateParticle(const ParticlePtr& particle, float elapsedTime) const
+void GravityAffector::updateParticle(PointF&, PointF& velocity, float elapsedTime) const
 {
-    if (!m_active)
-        return;
-
-    PointF velocity = particle->getVelocity();
     velocity += PointF(m_gravity * elapsedTime * std::cos(m_angle), m_gravity * elapsedTime * std::sin(m_angle));
-    particle->setVelocity(velocity);
 }
 
 void AttractionAffector::load(const OTMLNodePtr& node)
@@ -107,17 +101,13 @@ void AttractionAffector::load(const OTMLNodePtr& node)
     }
 }
 
-void AttractionAffector::updateParticle(const ParticlePtr& particle, float elapsedTime) const
+void AttractionAffector::updateParticle(PointF& position, PointF& velocity, float elapsedTime) const
 {
-    if (!m_active)
-        return;
-
-    const auto& pPosition = particle->getPosition();
-    const auto& d = PointF(m_position.x - pPosition.x, pPosition.y - m_position.y);
+    const auto& d = PointF(m_position.x - position.x, position.y - m_position.y);
     if (d.length() == 0)
         return;
 
     const auto& direction = m_repelish ? PointF(-1, -1) : PointF(1, 1);
-    const auto& pVelocity = particle->getVelocity() + (d / d.length() * m_acceleration * elapsedTime) * direction;
-    particle->setVelocity(pVelocity - pVelocity * m_reduction / 100.f * elapsedTime);
+    const auto& pVelocity = velocity + (d / d.length() * m_acceleration * elapsedTime) * direction;
+    velocity = pVelocity - pVelocity * m_reduction / 100.f * elapsedTime;
 }
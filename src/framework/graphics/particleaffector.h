@@ -32,9 +32,10 @@ public:
 
     void update(float elapsedTime);
     virtual void load(const OTMLNodePtr& node);
-    virtual void updateParticle(const ParticlePtr&, float) const = 0;
+    virtual void updateParticle(PointF& position, PointF& velocity, float elapsedTime) const = 0;
 
     bool hasFinished() const { return m_finished; }
+    bool isActive() const { return m_active; }
 
 protected:
     bool m_finished{ false };
@@ -48,7 +49,7 @@ class GravityAffector : public ParticleAffector
 {
 public:
     void load(const OTMLNodePtr& node) override;
-    void updateParticle(const ParticlePtr& particle, float elapsedTime) const override;
+    void updateParticle(PointF& position, PointF& velocity, float elapsedTime) const override;
 
 private:
     float m_angle{ 0 };
@@ -59,7 +60,7 @@ class AttractionAffector : public ParticleAffector
 {
 public:
     void load(const OTMLNodePtr& node) override;
-    void updateParticle(const ParticlePtr& particle, float elapsedTime) const override;
+    void updateParticle(PointF& position, PointF& velocity, float elapsedTime) const override;
 
 private:
     Point m_position;
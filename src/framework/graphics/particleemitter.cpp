@@ -21,7 +21,6 @@
  */
 
 #include "particleemitter.h"
-#include "particle.h"
 #include "particlemanager.h"
 #include "particlesystem.h"
 
@@ -85,11 +84,7 @@ void ParticleEmitter::update(float elapsedTime, const ParticleSystemPtr& system)
             const float pAccelerationAngle = stdext::random_range(type->pMinAccelerationAngle, type->pMaxAccelerationAngle);
             const PointF pAcceleration(pAccelerationAbs * std::cos(pAccelerationAngle), pAccelerationAbs * std::sin(pAccelerationAngle));
 
-            system->addParticle(std::make_shared<Particle>(pPosition, type->pStartSize, type->pFinalSize,
-                                pVelocity, pAcceleration,
-                                pDuration, type->pIgnorePhysicsAfter,
-                                type->pColors, type->pColorsStops,
-                                type->pCompositionMode, type->pTexture));
+            system->addParticle(pPosition, pVelocity, pAcceleration, pDuration, m_particleType);
         }
     }
 
@@ -23,7 +23,6 @@
 #include "particlesystem.h"
 #include <framework/core/clock.h>
 #include <framework/core/graphicalapplication.h>
-#include "particle.h"
 #include "particleaffector.h"
 
 ParticleSystem::ParticleSystem() :m_lastUpdateTime(g_clock.seconds()) {}
@@ -51,14 +50,14 @@ void ParticleSystem::load(const OTMLNodePtr& node)
     }
 }
 
-void ParticleSystem::addParticle(const ParticlePtr& particle) { m_particles.emplace_back(particle); }
-
-void ParticleSystem::render() const
+void ParticleSystem::addParticle(const Point& position, const PointF& velocity, const PointF& acceleration,
+                                 float duration, const ParticleTypePtr& type)
 {
-    for (const auto& particle : m_particles)
-        particle->render();
+    m_particles.add(position, velocity, acceleration, duration, type);
 }
 
+void ParticleSystem::render() const { m_particles.render(); }
+
 void ParticleSystem::update()
 {
     static constexpr float delay = 0.0166; // 60 updates/s
@@ -100,20 +99,14 @@ void ParticleSystem::update()
             }
         }
 
-        // update particles
-        for (auto it = m_particles.begin(); it != m_particles.end();) {
-            const ParticlePtr& particle = *it;
-            if (particle->hasFinished()) {
-                it = m_particles.erase(it);
-            } else {
-                // pass particles through affectors
-                for (const auto& particleAffector : m_affectors)
-                    particleAffector->updateParticle(particle, delay);
-
-                particle->update(delay);
-                ++it;
-            }
+        // pass every particle through the active affectors, then run the
+        // batched field passes over the whole array at once
+        for (const auto& particleAffector : m_affectors) {
+            if (particleAffector->isActive())
+                m_particles.applyAffector(*particleAffector, delay);
         }
+
+        m_particles.update(delay);
     }
 
     g_app.repaint();
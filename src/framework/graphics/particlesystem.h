@@ -23,6 +23,7 @@
 #pragma once
 
 #include "declarations.h"
+#include "particle.h"
 #include "particleemitter.h"
 
 class ParticleSystem : public std::enable_shared_from_this<ParticleSystem>
@@ -32,7 +33,8 @@ public:
 
     void load(const OTMLNodePtr& node);
 
-    void addParticle(const ParticlePtr& particle);
+    void addParticle(const Point& position, const PointF& velocity, const PointF& acceleration,
+                     float duration, const ParticleTypePtr& type);
 
     void render() const;
     void update();
@@ -42,7 +44,7 @@ public:
 private:
     bool m_finished{ false };
     float m_lastUpdateTime;
-    std::list<ParticlePtr> m_particles;
+    Particles m_particles;
     std::list<ParticleEmitterPtr> m_emitters;
     std::list<ParticleAffectorPtr> m_affectors;
 };
@@ -74,4 +74,5 @@ protected:
     float pIgnorePhysicsAfter{ -1 };
 
     friend class ParticleEmitter;
+    friend class Particles;
 };
@@ -78,4 +78,15 @@ static constexpr std::string_view glslMainVertexShader = "\n\
         if(texture2D(u_Tex0, v_TexCoord).a > 0.01)\n\
             return u_Color;\n\
         return vec4(0,0,0,0);\n\
+    }\n",
+
+    glslTextSdfFragmentShader = "\n\
+    varying mediump vec2 v_TexCoord;\n\
+    uniform lowp vec4 u_Color;\n\
+    uniform highp float u_Smoothing;\n\
+    uniform sampler2D u_Tex0;\n\
+    lowp vec4 calculatePixel() {\n\
+        highp float dist = texture2D(u_Tex0, v_TexCoord).a;\n\
+        lowp float alpha = smoothstep(0.5 - u_Smoothing, 0.5 + u_Smoothing, dist);\n\
+        return vec4(u_Color.rgb, u_Color.a * alpha);\n\
     }\n";
@@ -24,9 +24,34 @@
 #include "graphics.h"
 
 #include <framework/core/application.h>
+#include <framework/core/resourcemanager.h>
 
 uint32_t ShaderProgram::m_currentProgram = 0;
 
+namespace {
+#ifndef OPENGL_ES
+    bool isProgramBinarySupported()
+    {
+        static const bool supported = (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) && [] {
+            int formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            return formats > 0;
+        }();
+        return supported;
+    }
+
+    uint32_t getDriverHash()
+    {
+        // program binaries are only valid for the exact driver that wrote them
+        static const uint32_t hash = [] {
+            const auto& id = g_graphics.getVendor() + g_graphics.getRenderer() + g_graphics.getVersion();
+            return stdext::adler32(reinterpret_cast<const uint8_t*>(id.data()), id.size());
+        }();
+        return hash;
+    }
+#endif
+}
+
 ShaderProgram::ShaderProgram() :m_programId(glCreateProgram())
 {
     m_uniformLocations.fill(-1);
@@ -47,27 +72,30 @@ bool ShaderProgram::addShader(const ShaderPtr& shader)
 {
     glAttachShader(m_programId, shader->getShaderId());
     m_linked = false;
+    // externally compiled shaders are not covered by the source hash
+    m_cacheable = false;
     m_shaders.emplace_back(shader);
     return true;
 }
 
 bool ShaderProgram::addShaderFromSourceCode(ShaderType shaderType, const std::string_view sourceCode)
 {
-    const auto& shader = std::make_shared<Shader>(shaderType);
-    if (shader->compileSourceCode(sourceCode))
-        return addShader(shader);
-
-    g_logger.error(stdext::format("failed to compile shader: %s", shader->log()));
-    return false;
+    // compilation is deferred to link(), where a cached program binary can
+    // make it unnecessary altogether
+    m_sourceHash = m_sourceHash * 31 + stdext::adler32(reinterpret_cast<const uint8_t*>(sourceCode.data()), sourceCode.size()) + static_cast<uint32_t>(shaderType);
+    m_pendingShaders.emplace_back(PendingShader{ shaderType, std::string{ sourceCode } });
+    m_linked = false;
+    return true;
 }
 
 bool ShaderProgram::addShaderFromSourceFile(ShaderType shaderType, const std::string_view sourceFile)
 {
-    const auto& shader = std::make_shared<Shader>(shaderType);
-    if (shader->compileSourceFile(sourceFile))
-        return addShader(shader);
-
-    g_logger.error(stdext::format("failed to compile shader: %s", shader->log()));
+    try {
+        const auto& sourceCode = g_resources.readFileContents(sourceFile.data());
+        return addShaderFromSourceCode(shaderType, sourceCode);
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("unable to load shader source form file '%s': %s", sourceFile, e.what()));
+    }
     return false;
 }
 
@@ -80,6 +108,7 @@ void ShaderProgram::removeShader(const ShaderPtr& shader)
     glDetachShader(m_programId, shader->getShaderId());
     m_shaders.erase(it);
     m_linked = false;
+    m_cacheable = false;
 }
 
 void ShaderProgram::removeAllShaders()
@@ -93,6 +122,27 @@ bool ShaderProgram::link()
     if (m_linked)
         return true;
 
+    // a relink can move every uniform, the cached names must resolve again
+    m_namedUniformLocations.clear();
+
+#ifndef OPENGL_ES
+    std::string cachePath;
+    if (m_cacheable && !m_pendingShaders.empty() && isProgramBinarySupported() && !g_resources.getWriteDir().empty()) {
+        // binaries are keyed by driver and sources, so driver updates and
+        // shader edits both fall back to a regular compile
+        cachePath = stdext::format("/.shadercache/%x_%x.glpb", getDriverHash(), m_sourceHash);
+        if (g_resources.fileExists(cachePath) && loadBinary(cachePath)) {
+            m_pendingShaders.clear();
+            m_linked = true;
+            return true;
+        }
+        glProgramParameteri(m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+
+    if (!compilePendingShaders())
+        return false;
+
     glLinkProgram(m_programId);
 
     int value = GL_FALSE;
@@ -101,10 +151,69 @@ bool ShaderProgram::link()
 
     if (!m_linked)
         g_logger.traceWarning(log());
+#ifndef OPENGL_ES
+    else if (!cachePath.empty())
+        saveBinary(cachePath);
+#endif
 
     return m_linked;
 }
 
+bool ShaderProgram::compilePendingShaders()
+{
+    for (const auto& pending : m_pendingShaders) {
+        const auto& shader = std::make_shared<Shader>(pending.type);
+        if (!shader->compileSourceCode(pending.source)) {
+            g_logger.error(stdext::format("failed to compile shader: %s", shader->log()));
+            return false;
+        }
+        glAttachShader(m_programId, shader->getShaderId());
+        m_shaders.emplace_back(shader);
+    }
+    m_pendingShaders.clear();
+    return true;
+}
+
+#ifndef OPENGL_ES
+bool ShaderProgram::loadBinary(const std::string& cachePath)
+{
+    try {
+        const auto& data = g_resources.readFileContents(cachePath);
+        if (data.size() <= sizeof(GLenum))
+            return false;
+
+        GLenum format;
+        memcpy(&format, data.data(), sizeof(format));
+        glProgramBinary(m_programId, format, data.data() + sizeof(format), data.size() - sizeof(format));
+
+        int value = GL_FALSE;
+        glGetProgramiv(m_programId, GL_LINK_STATUS, &value);
+        return value != GL_FALSE;
+    } catch (const stdext::exception&) {
+        return false;
+    }
+}
+
+void ShaderProgram::saveBinary(const std::string& cachePath) const
+{
+    int length = 0;
+    glGetProgramiv(m_programId, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> data(sizeof(GLenum) + length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(m_programId, length, &written, &format, data.data() + sizeof(format));
+    if (written <= 0)
+        return;
+
+    memcpy(data.data(), &format, sizeof(format));
+    g_resources.makeDir("/.shadercache");
+    g_resources.writeFileBuffer(cachePath, reinterpret_cast<const uint8_t*>(data.data()), sizeof(format) + written);
+}
+#endif
+
 bool ShaderProgram::bind()
 {
     if (m_currentProgram == m_programId)
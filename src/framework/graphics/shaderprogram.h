@@ -90,21 +90,21 @@ public:
     void setUniformValue(int location, const Matrix3& mat) const
     { glUniformMatrix3fv(m_uniformLocations[location], 1, GL_FALSE, mat.data()); }
     void setUniformValue(const char* name, const Color& color) const
-    { glUniform4f(glGetUniformLocation(m_programId, name), color.rF(), color.gF(), color.bF(), color.aF()); }
+    { glUniform4f(uniformLocation(name), color.rF(), color.gF(), color.bF(), color.aF()); }
     void setUniformValue(const char* name, int value) const
-    { glUniform1i(glGetUniformLocation(m_programId, name), value); }
+    { glUniform1i(uniformLocation(name), value); }
     void setUniformValue(const char* name, float value) const
-    { glUniform1f(glGetUniformLocation(m_programId, name), value); }
+    { glUniform1f(uniformLocation(name), value); }
     void setUniformValue(const char* name, float x, float y) const
-    { glUniform2f(glGetUniformLocation(m_programId, name), x, y); }
+    { glUniform2f(uniformLocation(name), x, y); }
     void setUniformValue(const char* name, float x, float y, float z) const
-    { glUniform3f(glGetUniformLocation(m_programId, name), x, y, z); }
+    { glUniform3f(uniformLocation(name), x, y, z); }
     void setUniformValue(const char* name, float x, float y, float z, float w) const
-    { glUniform4f(glGetUniformLocation(m_programId, name), x, y, z, w); }
+    { glUniform4f(uniformLocation(name), x, y, z, w); }
     void setUniformValue(const char* name, const Matrix2& mat) const
-    { glUniformMatrix2fv(glGetUniformLocation(m_programId, name), 1, GL_FALSE, mat.data()); }
+    { glUniformMatrix2fv(uniformLocation(name), 1, GL_FALSE, mat.data()); }
     void setUniformValue(const char* name, const Matrix3& mat) const
-    { glUniformMatrix3fv(glGetUniformLocation(m_programId, name), 1, GL_FALSE, mat.data()); }
+    { glUniformMatrix3fv(uniformLocation(name), 1, GL_FALSE, mat.data()); }
     // TODO: Point, PointF, Color, Size, SizeF ?
 
     bool isLinked() const { return m_linked; }
@@ -112,9 +112,38 @@ public:
     ShaderList getShaders() { return m_shaders; }
 
 private:
+    // resolving a uniform by name is a driver-side lookup; custom shaders
+    // set their uniforms by name every frame, so the locations are cached
+    int uniformLocation(const char* name) const
+    {
+        const auto it = m_namedUniformLocations.find(name);
+        if (it != m_namedUniformLocations.end())
+            return it->second;
+
+        const int location = glGetUniformLocation(m_programId, name);
+        m_namedUniformLocations.emplace(name, location);
+        return location;
+    }
+
+    // shader sources are kept until link(), where a cached program binary
+    // can make compiling them unnecessary altogether
+    struct PendingShader
+    {
+        ShaderType type;
+        std::string source;
+    };
+
+    bool compilePendingShaders();
+    bool loadBinary(const std::string& cachePath);
+    void saveBinary(const std::string& cachePath) const;
+
     bool m_linked{ false };
+    bool m_cacheable{ true };
     uint32_t m_programId;
+    uint32_t m_sourceHash{ 0 };
     static uint32_t m_currentProgram;
     ShaderList m_shaders;
+    std::vector<PendingShader> m_pendingShaders;
     std::array<int, MAX_UNIFORM_LOCATIONS> m_uniformLocations{ };
+    mutable stdext::map<std::string, int> m_namedUniformLocations;
 };
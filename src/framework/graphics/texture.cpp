@@ -26,14 +26,179 @@
 #include "image.h"
 
 #include <framework/core/application.h>
+#include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/resourcemanager.h>
 #include "framework/stdext/math.h"
 
  // UINT16_MAX = just to avoid conflicts with GL generated ID.
 static std::atomic_uint32_t UID(UINT16_MAX);
 
-Texture::Texture() : m_uniqueId(++UID) { generateHash(); }
-Texture::Texture(const Size& size) : m_uniqueId(++UID)
+std::atomic_uint64_t Texture::s_vramUsage(0);
+
+namespace
+{
+#ifndef OPENGL_ES
+    // small ring of pixel-unpack buffers recycled through fences; big
+    // uploads stream through DMA out of the buffer instead of stalling the
+    // render thread inside the driver's synchronous copy
+    constexpr size_t STREAM_MIN_SIZE = 64 * 1024;
+    constexpr size_t MAX_STREAM_BUFFERS = 4;
+
+    struct PixelStreamBuffer
+    {
+        GLuint id{ 0 };
+        GLsync fence{ nullptr };
+    };
+
+    std::vector<PixelStreamBuffer> streamBuffers;
+    PixelStreamBuffer* activeStreamBuffer = nullptr;
+
+    bool isStreamUploadSupported()
+    {
+        static const bool supported = GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object;
+        return supported;
+    }
+
+    PixelStreamBuffer* acquireStreamBuffer()
+    {
+        for (auto& buffer : streamBuffers) {
+            if (buffer.fence) {
+                if (glClientWaitSync(buffer.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+                    continue; // previous upload still in flight
+                glDeleteSync(buffer.fence);
+                buffer.fence = nullptr;
+            }
+            return &buffer;
+        }
+
+        if (streamBuffers.size() < MAX_STREAM_BUFFERS) {
+            auto& buffer = streamBuffers.emplace_back();
+            glGenBuffers(1, &buffer.id);
+            if (buffer.id != 0)
+                return &buffer;
+            streamBuffers.pop_back();
+        }
+
+        return nullptr;
+    }
+
+    // driver-encoded GL_COMPRESSED_RGBA cuts vram and sampling bandwidth
+    // to roughly a quarter, but the encode itself is slow and would run
+    // again on every launch; cache the blob the driver produced on disk,
+    // keyed by pixel content, and upload it pre-compressed from then on
+    constexpr uint32_t COMPRESSED_BLOB_MAGIC = 0x31435443; // "CTC1"
+    constexpr const char* COMPRESSED_BLOB_DIR = "/compressed_textures";
+
+    struct CompressedBlobHeader
+    {
+        uint32_t magic;
+        uint32_t internalFormat;
+        int32_t width;
+        int32_t height;
+        uint32_t dataSize;
+    };
+
+    std::string compressedBlobPath(const size_t hash)
+    {
+        return stdext::format("%s/%016llx.bin", COMPRESSED_BLOB_DIR, static_cast<unsigned long long>(hash));
+    }
+
+    bool uploadCachedCompressedPixels(const size_t hash, const Size& size)
+    {
+        try {
+            const auto& path = compressedBlobPath(hash);
+            if (!g_resources.fileExists(path))
+                return false;
+
+            const auto& contents = g_resources.readFileContents(path);
+            if (contents.size() < sizeof(CompressedBlobHeader))
+                return false;
+
+            CompressedBlobHeader header;
+            memcpy(&header, contents.data(), sizeof(header));
+            if (header.magic != COMPRESSED_BLOB_MAGIC || header.width != size.width() ||
+                header.height != size.height() || contents.size() != sizeof(header) + header.dataSize)
+                return false;
+
+            glGetError(); // clear stale errors, the upload result is checked below
+            glCompressedTexImage2D(GL_TEXTURE_2D, 0, header.internalFormat, header.width, header.height, 0,
+                                   header.dataSize, contents.data() + sizeof(header));
+            return glGetError() == GL_NO_ERROR;
+        } catch (const std::exception&) {
+            return false; // a broken cache entry only costs one driver re-encode
+        }
+    }
+
+    void storeCompressedPixels(const size_t hash, const Size& size)
+    {
+        GLint isCompressed = GL_FALSE;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &isCompressed);
+        if (isCompressed == GL_FALSE)
+            return; // the driver fell back to an uncompressed format
+
+        GLint internalFormat = 0, dataSize = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &dataSize);
+        if (dataSize <= 0 || static_cast<int64_t>(dataSize) >= static_cast<int64_t>(size.area()) * 4)
+            return;
+
+        std::vector<uint8_t> blob(sizeof(CompressedBlobHeader) + dataSize);
+        const CompressedBlobHeader header{ COMPRESSED_BLOB_MAGIC, static_cast<uint32_t>(internalFormat),
+                                           size.width(), size.height(), static_cast<uint32_t>(dataSize) };
+        memcpy(blob.data(), &header, sizeof(header));
+        glGetCompressedTexImage(GL_TEXTURE_2D, 0, blob.data() + sizeof(header));
+
+        g_resources.makeDir(COMPRESSED_BLOB_DIR);
+        g_resources.writeFileBuffer(compressedBlobPath(hash), blob.data(), blob.size());
+    }
+#endif
+}
+
+bool Texture::beginPixelStream(const uint8_t* pixels, const size_t size)
+{
+#ifdef OPENGL_ES
+    return false;
+#else
+    if (!pixels || size < STREAM_MIN_SIZE || !isStreamUploadSupported())
+        return false;
+
+    auto* buffer = acquireStreamBuffer();
+    if (!buffer)
+        return false; // every buffer still busy, fall back to the direct upload
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->id);
+    // orphan any previous storage so the map never waits on the GPU
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    auto* map = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!map) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    memcpy(map, pixels, size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    activeStreamBuffer = buffer;
+    return true;
+#endif
+}
+
+void Texture::endPixelStream()
+{
+#ifndef OPENGL_ES
+    if (!activeStreamBuffer)
+        return;
+
+    // signals once the transfer consumed the buffer, so it can be reused
+    activeStreamBuffer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    activeStreamBuffer = nullptr;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
+}
+
+Texture::Texture() : m_uniqueId(++UID), m_lastDrawTime(g_clock.millis()) { generateHash(); }
+Texture::Texture(const Size& size) : m_uniqueId(++UID), m_lastDrawTime(g_clock.millis())
 {
     generateHash();
     if (!setupSize(size))
@@ -46,7 +211,7 @@ Texture::Texture(const Size& size) : m_uniqueId(++UID)
     setupFilters();
 }
 
-Texture::Texture(const ImagePtr& image, bool buildMipmaps, bool compress) : m_uniqueId(++UID)
+Texture::Texture(const ImagePtr& image, bool buildMipmaps, bool compress) : m_uniqueId(++UID), m_lastDrawTime(g_clock.millis())
 {
     generateHash();
 
@@ -66,6 +231,8 @@ Texture::~Texture()
             glDeleteTextures(1, &id);
         });
     }
+
+    s_vramUsage.fetch_sub(m_vramSize, std::memory_order_relaxed);
 }
 
 Texture* Texture::create()
@@ -76,11 +243,22 @@ Texture* Texture::create()
         m_image = nullptr;
     }
 
+    // create() sits on the draw execution path, stamping it here is what
+    // lets the texture manager tell apart textures recent frames touched
+    m_lastDrawTime = g_clock.millis();
+
     return this;
 }
 
 void Texture::updateImage(const ImagePtr& image) { m_image = image; setupSize(image->getSize()); }
 
+void Texture::setAtlasRegion(const TexturePtr& page, const Rect& region)
+{
+    m_atlasPage = page;
+    m_atlasRegion = region;
+    m_size = region.size();
+}
+
 void Texture::updatePixels(uint8_t* pixels, int level, int channels, bool compress) {
     bind();
     setupPixels(level, m_size, pixels, channels, compress);
@@ -164,6 +342,12 @@ void Texture::createTexture()
     assert(m_id != 0);
 
     generateHash();
+
+    uint32_t bytes = static_cast<uint32_t>(m_size.area()) * 4;
+    if (getProp(Prop::buildMipmaps) || getProp(Prop::hasMipMaps))
+        bytes += bytes / 3;
+    s_vramUsage.fetch_add(static_cast<int64_t>(bytes) - m_vramSize, std::memory_order_relaxed);
+    m_vramSize = bytes;
 }
 
 bool Texture::setupSize(const Size& size)
@@ -276,7 +460,27 @@ void Texture::setupPixels(int level, const Size& size, uint8_t* pixels, int chan
 #else
     if (compress)
         internalFormat = GL_COMPRESSED_RGBA;
+
+    if (compress && level == 0 && channels == 4 && pixels) {
+        const size_t hash = std::hash<std::string_view>{}(
+            std::string_view(reinterpret_cast<const char*>(pixels), static_cast<size_t>(size.area()) * 4));
+
+        if (uploadCachedCompressedPixels(hash, size))
+            return;
+
+        glTexImage2D(GL_TEXTURE_2D, level, internalFormat, size.width(), size.height(), 0, format, GL_UNSIGNED_BYTE, pixels);
+        storeCompressedPixels(hash, size);
+        return;
+    }
 #endif
 
+    // sprite sheets and outfit composites arrive mid-game; stage them in a
+    // pixel-unpack buffer so the transfer overlaps with rendering
+    if (!compress && beginPixelStream(pixels, static_cast<size_t>(size.area()) * channels)) {
+        glTexImage2D(GL_TEXTURE_2D, level, internalFormat, size.width(), size.height(), 0, format, GL_UNSIGNED_BYTE, nullptr);
+        endPixelStream();
+        return;
+    }
+
     glTexImage2D(GL_TEXTURE_2D, level, internalFormat, size.width(), size.height(), 0, format, GL_UNSIGNED_BYTE, pixels);
 }
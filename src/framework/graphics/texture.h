@@ -48,13 +48,32 @@ public:
     const Matrix3& getTransformMatrix() const { return m_transformMatrix; }
 
     ticks_t getTime() const { return m_time; }
+    ticks_t getLastDrawTime() const { return m_lastDrawTime; }
     uint32_t getId() const { return m_id; }
     uint32_t getUniqueId() const { return m_uniqueId; }
     size_t hash() const { return m_hash; }
 
+    // bytes this texture is accounted for in the global VRAM counter
+    uint32_t getVRAMSize() const { return m_vramSize; }
+
+    // estimated bytes held by all live textures in GPU memory
+    static uint64_t getVRAMUsage() { return s_vramUsage.load(std::memory_order_relaxed); }
+
     int getWidth() const { return m_size.width(); }
     int getHeight() const { return m_size.height(); }
 
+    void setAtlasRegion(const TexturePtr& page, const Rect& region);
+    bool isAtlasRegion() const { return m_atlasPage != nullptr; }
+    const TexturePtr& getAtlasPage() const { return m_atlasPage; }
+    Point getAtlasOffset() const { return m_atlasRegion.topLeft(); }
+
+    // stages pixel data into a fenced pixel-unpack buffer; when it returns
+    // true the following glTexImage2D/glTexSubImage2D must pass a null
+    // pointer and be closed with endPixelStream(), when false the caller
+    // uploads directly
+    static bool beginPixelStream(const uint8_t* pixels, size_t size);
+    static void endPixelStream();
+
     bool isEmpty() const { return m_id == 0; }
     bool hasRepeat() const { return getProp(Prop::repeat); }
     bool hasMipmaps() const { return getProp(Prop::hasMipMaps); }
@@ -74,14 +93,23 @@ protected:
 
     uint32_t m_id{ 0 };
     ticks_t m_time{ 0 };
+    ticks_t m_lastDrawTime{ 0 };
     size_t m_hash{ 0 };
 
+    // level 0 estimate plus a third for mipmap chains, settled on destruction
+    uint32_t m_vramSize{ 0 };
+    static std::atomic_uint64_t s_vramUsage;
+
     Size m_size;
 
     Matrix3 m_transformMatrix = DEFAULT_MATRIX3;
 
     ImagePtr m_image;
 
+    // when set, this texture is only a sub-rect view into an atlas page
+    TexturePtr m_atlasPage;
+    Rect m_atlasRegion;
+
     enum Prop : uint16_t
     {
         hasMipMaps = 1 << 0,
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "textureatlas.h"
+#include "graphics.h"
+#include "image.h"
+#include "painter.h"
+
+static constexpr int MAX_PAGE_SIZE = 4096;
+
+static uint32_t regionKey(const Size& size) { return size.width() << 16 | size.height(); }
+
+TexturePtr TextureAtlas::add(const ImagePtr& image)
+{
+    if (!image)
+        return nullptr;
+
+    // without a live GL context the upload cannot happen here, keep the old path
+    if (!g_graphics.ok())
+        return std::make_shared<Texture>(image, true, false);
+
+    std::scoped_lock l(m_mutex);
+
+    if (m_pageSize == 0)
+        m_pageSize = std::min<int>(MAX_PAGE_SIZE, g_graphics.getMaxTextureSize());
+
+    const auto& size = image->getSize();
+
+    // images too large to share a page keep their own texture
+    if (size.width() > m_pageSize / 2 || size.height() > m_pageSize / 2)
+        return std::make_shared<Texture>(image, true, false);
+
+    Page* page = nullptr;
+    Point pos;
+    if (!allocate(size, page, pos))
+        return std::make_shared<Texture>(image, true, false);
+
+    glBindTexture(GL_TEXTURE_2D, page->texture->getId());
+    if (Texture::beginPixelStream(image->getPixelData(), static_cast<size_t>(size.area()) * 4)) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, pos.x, pos.y, size.width(), size.height(),
+                        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        Texture::endPixelStream();
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, pos.x, pos.y, size.width(), size.height(),
+                        GL_RGBA, GL_UNSIGNED_BYTE, image->getPixelData());
+    }
+    g_painter->resetTexture();
+
+    const size_t pageIndex = page - m_pages.data();
+    const Rect region(pos, size);
+
+    const auto& handle = TexturePtr(new Texture, [this, pageIndex, region, generation = m_generation](Texture* texture) {
+        free(region, pageIndex, generation);
+        delete texture;
+    });
+    handle->setAtlasRegion(page->texture, region);
+    return handle;
+}
+
+bool TextureAtlas::allocate(const Size& size, Page*& page, Point& pos)
+{
+    // reuse a region of the same size released by a dead handle
+    if (const auto it = m_freeRegions.find(regionKey(size)); it != m_freeRegions.end() && !it->second.empty()) {
+        const auto& [pageIndex, regionPos] = it->second.back();
+        page = &m_pages[pageIndex];
+        pos = regionPos;
+        it->second.pop_back();
+        return true;
+    }
+
+    for (auto& p : m_pages) {
+        if (p.shelfX + size.width() > m_pageSize) {
+            // current shelf is full, try to open a new one
+            if (p.shelfY + p.shelfHeight + size.height() > m_pageSize)
+                continue;
+            p.shelfY += p.shelfHeight;
+            p.shelfX = 0;
+            p.shelfHeight = 0;
+        } else if (p.shelfY + size.height() > m_pageSize)
+            continue;
+
+        page = &p;
+        pos = { p.shelfX, p.shelfY };
+        p.shelfX += size.width();
+        p.shelfHeight = std::max<int>(p.shelfHeight, size.height());
+        return true;
+    }
+
+    auto& p = m_pages.emplace_back();
+    p.texture = std::make_shared<Texture>(Size(m_pageSize, m_pageSize));
+    if (p.texture->isEmpty()) {
+        m_pages.pop_back();
+        return false;
+    }
+
+    page = &p;
+    pos = { 0, 0 };
+    p.shelfX = size.width();
+    p.shelfHeight = size.height();
+    return true;
+}
+
+void TextureAtlas::free(const Rect& region, size_t pageIndex, uint32_t generation)
+{
+    std::scoped_lock l(m_mutex);
+    if (generation != m_generation)
+        return;
+
+    m_freeRegions[regionKey(region.size())].emplace_back(pageIndex, region.topLeft());
+}
+
+void TextureAtlas::clear()
+{
+    std::scoped_lock l(m_mutex);
+    m_pages.clear();
+    m_freeRegions.clear();
+    ++m_generation;
+}
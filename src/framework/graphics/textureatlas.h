@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+#include "texture.h"
+
+ // Packs many small images (sprite sheets) into a few large texture pages,
+ // so that DrawPool can merge draws that would otherwise switch textures.
+class TextureAtlas
+{
+public:
+    // returns a texture handle whose draws are redirected to an atlas page,
+    // or a standalone texture when the image does not fit in a page.
+    TexturePtr add(const ImagePtr& image);
+
+    void clear();
+
+    size_t getPageCount() const { return m_pages.size(); }
+
+private:
+    struct Page
+    {
+        TexturePtr texture;
+        int shelfX{ 0 };
+        int shelfY{ 0 };
+        int shelfHeight{ 0 };
+    };
+
+    bool allocate(const Size& size, Page*& page, Point& pos);
+    void free(const Rect& region, size_t pageIndex, uint32_t generation);
+
+    std::vector<Page> m_pages;
+
+    // regions returned by dead handles, reusable for images of the same size
+    stdext::map<uint32_t, std::vector<std::pair<size_t, Point>>> m_freeRegions;
+
+    int m_pageSize{ 0 };
+    uint32_t m_generation{ 0 };
+
+    std::mutex m_mutex;
+};
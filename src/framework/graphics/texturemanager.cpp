@@ -27,6 +27,7 @@
 
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/memorytracker.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/apngloader.h>
 
@@ -36,7 +37,13 @@
 
 TextureManager g_textures;
 
-void TextureManager::init() { m_emptyTexture = std::make_shared<Texture>(); }
+void TextureManager::init()
+{
+    m_emptyTexture = std::make_shared<Texture>();
+
+    // textures already account their VRAM exactly, just expose it
+    g_memory.registerGauge("textures", [] { return Texture::getVRAMUsage(); });
+}
 
 void TextureManager::terminate()
 {
@@ -45,7 +52,11 @@ void TextureManager::terminate()
         m_liveReloadEvent = nullptr;
     }
     m_textures.clear();
+    m_atlasTextures.clear();
+    m_uiTextures.clear();
     m_animatedTextures.clear();
+    m_spriteAtlas.clear();
+    m_uiAtlas.clear();
     m_emptyTexture = nullptr;
 }
 
@@ -58,9 +69,71 @@ void TextureManager::poll()
         return;
     lastUpdate = now;
 
+    // draws stamp the last draw time, so anything no recent frame touched
+    // pauses for free and resumes from its current frame when drawn again
+    constexpr ticks_t ANIMATE_IDLE_TIME = 100;
+
     std::scoped_lock l(m_mutex);
-    for (const auto& animatedTexture : m_animatedTextures)
+    for (const auto& animatedTexture : m_animatedTextures) {
+        if (now - animatedTexture->getLastDrawTime() > ANIMATE_IDLE_TIME)
+            continue;
         animatedTexture->update();
+    }
+
+    if (m_vramBudget > 0 && now - m_lastEvictionCheck >= 2000) {
+        m_lastEvictionCheck = now;
+        if (Texture::getVRAMUsage() > m_vramBudget)
+            evictLeastRecentlyDrawn();
+    }
+}
+
+void TextureManager::evictLeastRecentlyDrawn()
+{
+    // keep anything drawn within the last few seconds even when over
+    // budget, eviction targets textures recent frames no longer touch
+    constexpr ticks_t MIN_IDLE_TIME = 10 * 1000;
+
+    const ticks_t now = g_clock.millis();
+
+    // the same texture may be indexed under more than one spelling, a
+    // texture is only evictable when the cache holds every reference to it
+    stdext::map<uint32_t, long> cacheRefs;
+    for (const auto& [fileName, tex] : m_textures)
+        ++cacheRefs[tex->getUniqueId()];
+
+    std::vector<std::tuple<ticks_t, uint32_t, uint32_t>> candidates; // lastDraw, uniqueId, bytes
+    for (const auto& [fileName, tex] : m_textures) {
+        if (tex.use_count() > cacheRefs[tex->getUniqueId()])
+            continue;
+        if (now - tex->getLastDrawTime() < MIN_IDLE_TIME)
+            continue;
+        // negating the count both marks this texture as collected and makes
+        // the use_count test above reject its other spellings
+        cacheRefs[tex->getUniqueId()] = -cacheRefs[tex->getUniqueId()];
+        candidates.emplace_back(tex->getLastDrawTime(), tex->getUniqueId(), tex->getVRAMSize());
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    uint64_t toFree = Texture::getVRAMUsage() - m_vramBudget;
+    stdext::map<uint32_t, bool> evict;
+    for (const auto& [lastDraw, uniqueId, bytes] : candidates) {
+        evict.emplace(uniqueId, true);
+        ++m_evictedCount;
+        if (bytes >= toFree)
+            break;
+        toFree -= bytes;
+    }
+
+    if (evict.empty())
+        return;
+
+    for (auto it = m_textures.begin(); it != m_textures.end();) {
+        if (evict.contains(it->second->getUniqueId()))
+            it = m_textures.erase(it);
+        else
+            ++it;
+    }
 }
 
 void TextureManager::clearCache()
@@ -68,6 +141,10 @@ void TextureManager::clearCache()
     std::scoped_lock l(m_mutex);
     m_animatedTextures.clear();
     m_textures.clear();
+    m_atlasTextures.clear();
+    m_uiTextures.clear();
+    m_spriteAtlas.clear();
+    m_uiAtlas.clear();
 }
 
 void TextureManager::liveReload()
@@ -90,6 +167,85 @@ void TextureManager::liveReload()
     }, 1000);
 }
 
+void TextureManager::preload(const std::string& fileName, const ImagePtr& image)
+{
+    if (!image)
+        return;
+
+    const auto& filePath = g_resources.resolvePath(fileName);
+    if (m_textures.contains(filePath))
+        return;
+
+    const auto& texture = std::make_shared<Texture>(image, false, false);
+    texture->setTime(stdext::time());
+    texture->setSmooth(true);
+    m_textures[filePath] = texture;
+
+    // getTexture callers usually omit the extension, index that spelling too
+    if (filePath.ends_with(".png"))
+        m_textures.emplace(filePath.substr(0, filePath.size() - 4), texture);
+}
+
+TexturePtr TextureManager::getAtlasTexture(const std::string& fileName)
+{
+    const auto& filePath = g_resources.resolvePath(fileName);
+
+    const auto it = m_atlasTextures.find(filePath);
+    if (it != m_atlasTextures.end())
+        return it->second;
+
+    TexturePtr texture;
+    if (const auto& image = Image::load(filePath))
+        texture = m_spriteAtlas.add(image);
+    else
+        texture = m_emptyTexture;
+
+    m_atlasTextures[filePath] = texture;
+    return texture;
+}
+
+TexturePtr TextureManager::getUiAtlasTexture(const std::string& fileName)
+{
+    const auto& filePath = g_resources.resolvePath(fileName);
+
+    const auto it = m_uiTextures.find(filePath);
+    if (it != m_uiTextures.end())
+        return it->second;
+
+#ifdef FRAMEWORK_NET
+    // downloaded images keep the virtual directory handling of getTexture
+    if (filePath.substr(0, 11) == "/downloads/")
+        return getTexture(fileName);
+#endif
+
+    TexturePtr texture;
+    try {
+        const auto& filePathEx = g_resources.guessFilePath(filePath, "png");
+        std::stringstream fin;
+        g_resources.readFileStream(filePathEx, fin);
+
+        apng_data apng;
+        if (load_apng(fin, &apng) == 0) {
+            if (apng.num_frames > 1) {
+                // animated images cannot live in a shared page
+                free_apng(&apng);
+                return getTexture(fileName);
+            }
+            const auto& image = std::make_shared<Image>(Size(apng.width, apng.height), apng.bpp, apng.pdata);
+            free_apng(&apng);
+            texture = m_uiAtlas.add(image);
+        }
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("Unable to load texture '%s': %s", fileName, e.what()));
+    }
+
+    if (!texture)
+        texture = m_emptyTexture;
+
+    m_uiTextures[filePath] = texture;
+    return texture;
+}
+
 TexturePtr TextureManager::getTexture(const std::string& fileName)
 {
     TexturePtr texture;
@@ -161,7 +317,11 @@ TexturePtr TextureManager::loadTexture(std::stringstream& file)
             texture = m_animatedTextures.emplace_back(animatedTexture);
         } else {
             const auto& image = std::make_shared<Image>(imageSize, apng.bpp, apng.pdata);
-            texture = std::make_shared<Texture>(image, false, false);
+            // big ui art (backgrounds, splash screens) dominates vram while
+            // sprites live in atlas pages; upload the big ones compressed
+            constexpr int COMPRESS_MIN_AREA = 512 * 512;
+            const bool compress = apng.bpp == 4 && imageSize.area() >= COMPRESS_MIN_AREA;
+            texture = std::make_shared<Texture>(image, false, compress);
         }
         free_apng(&apng);
     }
@@ -24,6 +24,7 @@
 
 #include <framework/core/declarations.h>
 #include "texture.h"
+#include "textureatlas.h"
 
 class TextureManager
 {
@@ -36,17 +37,46 @@ public:
     void liveReload();
 
     void preload(const std::string& fileName) { getTexture(fileName); }
+    void preload(const std::string& fileName, const ImagePtr& image);
     TexturePtr getTexture(const std::string& fileName);
+    TexturePtr getAtlasTexture(const ImagePtr& image) { return m_spriteAtlas.add(image); }
+
+    // like getTexture, but small images come back as atlas page handles, so
+    // draws of different files sharing a page batch into one command
+    TexturePtr getAtlasTexture(const std::string& fileName);
+
+    // UI counterpart of getAtlasTexture: module PNGs (borders, icons,
+    // buttons) pack into their own pages so the FOREGROUND pool cycles
+    // through a few binds instead of hundreds of tiny textures; animated
+    // images fall back to the regular path
+    TexturePtr getUiAtlasTexture(const std::string& fileName);
     const TexturePtr& getEmptyTexture() { return m_emptyTexture; }
 
+    // VRAM budget in megabytes, 0 disables eviction; when live textures
+    // exceed it, the least recently drawn cached ones are dropped and
+    // reload from disk on the next getTexture
+    void setVRAMBudget(uint32_t megabytes) { m_vramBudget = static_cast<uint64_t>(megabytes) * 1024 * 1024; }
+    uint64_t getVRAMUsage() { return Texture::getVRAMUsage(); }
+    bool isOverBudget() const { return m_vramBudget > 0 && Texture::getVRAMUsage() > m_vramBudget; }
+    uint32_t getEvictedCount() { return m_evictedCount; }
+
 private:
     TexturePtr loadTexture(std::stringstream& file);
+    void evictLeastRecentlyDrawn();
 
     stdext::map<std::string, TexturePtr> m_textures;
+    stdext::map<std::string, TexturePtr> m_atlasTextures;
+    stdext::map<std::string, TexturePtr> m_uiTextures;
+    TextureAtlas m_spriteAtlas;
+    TextureAtlas m_uiAtlas;
     std::vector<AnimatedTexturePtr> m_animatedTextures;
     TexturePtr m_emptyTexture;
     ScheduledEventPtr m_liveReloadEvent;
     std::mutex m_mutex;
+
+    uint64_t m_vramBudget{ 0 };
+    uint32_t m_evictedCount{ 0 };
+    ticks_t m_lastEvictionCheck{ 0 };
 };
 
 extern TextureManager g_textures;
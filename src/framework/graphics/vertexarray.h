@@ -46,9 +46,10 @@ public:
 
     void addTriangle(const Point& a, const Point& b, const Point& c)
     {
-        addVertex(a.x, a.y);
-        addVertex(b.x, b.y);
-        addVertex(c.x, c.y);
+        float* v = prepare(6);
+        v[0] = a.x; v[1] = a.y;
+        v[2] = b.x; v[3] = b.y;
+        v[4] = c.x; v[5] = c.y;
     }
 
     void addRect(const Rect& rect)
@@ -58,27 +59,29 @@ public:
         const float bottom = rect.bottom() + 1;
         const float left = rect.left();
 
-        addVertex(left, top);
-        addVertex(right, top);
-        addVertex(left, bottom);
-        addVertex(left, bottom);
-        addVertex(right, top);
-        addVertex(right, bottom);
+        float* v = prepare(12);
+        v[0] = left; v[1] = top;
+        v[2] = right; v[3] = top;
+        v[4] = left; v[5] = bottom;
+        v[6] = left; v[7] = bottom;
+        v[8] = right; v[9] = top;
+        v[10] = right; v[11] = bottom;
     }
 
     void addRect(const RectF& rect)
     {
-        float top = rect.top();
-        float right = rect.right() + 1.f;
-        float bottom = rect.bottom() + 1.f;
-        float left = rect.left();
+        const float top = rect.top();
+        const float right = rect.right() + 1.f;
+        const float bottom = rect.bottom() + 1.f;
+        const float left = rect.left();
 
-        addVertex(left, top);
-        addVertex(right, top);
-        addVertex(left, bottom);
-        addVertex(left, bottom);
-        addVertex(right, top);
-        addVertex(right, bottom);
+        float* v = prepare(12);
+        v[0] = left; v[1] = top;
+        v[2] = right; v[3] = top;
+        v[4] = left; v[5] = bottom;
+        v[6] = left; v[7] = bottom;
+        v[8] = right; v[9] = top;
+        v[10] = right; v[11] = bottom;
     }
 
     void addQuad(const Rect& rect)
@@ -88,10 +91,25 @@ public:
         const float bottom = rect.bottom() + 1;
         const float left = rect.left();
 
-        addVertex(left, top);
-        addVertex(right, top);
-        addVertex(left, bottom);
-        addVertex(right, bottom);
+        float* v = prepare(8);
+        v[0] = left; v[1] = top;
+        v[2] = right; v[3] = top;
+        v[4] = left; v[5] = bottom;
+        v[6] = right; v[7] = bottom;
+    }
+
+    void addQuad(const RectF& rect)
+    {
+        const float top = rect.top();
+        const float right = rect.right() + 1.f;
+        const float bottom = rect.bottom() + 1.f;
+        const float left = rect.left();
+
+        float* v = prepare(8);
+        v[0] = left; v[1] = top;
+        v[2] = right; v[3] = top;
+        v[4] = left; v[5] = bottom;
+        v[6] = right; v[7] = bottom;
     }
 
     void addUpsideDownQuad(const Rect& rect)
@@ -101,10 +119,11 @@ public:
         const float bottom = rect.bottom() + 1;
         const float left = rect.left();
 
-        addVertex(left, bottom);
-        addVertex(right, bottom);
-        addVertex(left, top);
-        addVertex(right, top);
+        float* v = prepare(8);
+        v[0] = left; v[1] = bottom;
+        v[2] = right; v[3] = bottom;
+        v[4] = left; v[5] = top;
+        v[6] = right; v[7] = top;
     }
 
     void addUpsideDownRect(const Rect& rect)
@@ -114,12 +133,55 @@ public:
         const float bottom = rect.bottom() + 1;
         const float left = rect.left();
 
-        addVertex(left, bottom);
-        addVertex(right, bottom);
-        addVertex(left, bottom);
-        addVertex(left, top);
-        addVertex(right, bottom);
-        addVertex(right, top);
+        float* v = prepare(12);
+        v[0] = left; v[1] = bottom;
+        v[2] = right; v[3] = bottom;
+        v[4] = left; v[5] = bottom;
+        v[6] = left; v[7] = top;
+        v[8] = right; v[9] = bottom;
+        v[10] = right; v[11] = top;
+    }
+
+    // rewrites a buffer of 4-vertex quads (lt, rt, lb, rb) into the
+    // 6-vertex triangle layout addRect emits, for buffers that must mix
+    // quads with free-form triangles
+    void expandQuadsToTriangles()
+    {
+        const size_t quadCount = m_buffer.size() / 8;
+        if (quadCount == 0)
+            return;
+
+        m_buffer.resize(quadCount * 12);
+        float* data = m_buffer.data();
+        for (size_t q = quadCount; q-- > 0;) {
+            float v[8];
+            memcpy(v, data + q * 8, sizeof(v));
+
+            float* out = data + q * 12;
+            out[0] = v[0]; out[1] = v[1]; // lt
+            out[2] = v[2]; out[3] = v[3]; // rt
+            out[4] = v[4]; out[5] = v[5]; // lb
+            out[6] = v[4]; out[7] = v[5]; // lb
+            out[8] = v[2]; out[9] = v[3]; // rt
+            out[10] = v[6]; out[11] = v[7]; // rb
+        }
+    }
+
+    // appends a 4-vertex quad buffer expanded into triangles
+    void appendQuadsAsTriangles(const VertexArray* buffer, const Point& offset)
+    {
+        const size_t quadCount = buffer->m_buffer.size() / 8;
+        const float* src = buffer->m_buffer.data();
+        float* out = prepare(quadCount * 12);
+        for (size_t q = 0; q < quadCount; ++q, src += 8, out += 12) {
+            const float x = offset.x, y = offset.y;
+            out[0] = src[0] + x; out[1] = src[1] + y;
+            out[2] = src[2] + x; out[3] = src[3] + y;
+            out[4] = src[4] + x; out[5] = src[5] + y;
+            out[6] = src[4] + x; out[7] = src[5] + y;
+            out[8] = src[2] + x; out[9] = src[3] + y;
+            out[10] = src[6] + x; out[11] = src[7] + y;
+        }
     }
 
     void append(const VertexArray* buffer)
@@ -127,6 +189,21 @@ public:
         m_buffer.insert(m_buffer.end(), buffer->m_buffer.begin(), buffer->m_buffer.end());
     }
 
+    void append(const VertexArray* buffer, const Point& offset)
+    {
+        if (offset.isNull()) {
+            append(buffer);
+            return;
+        }
+
+        const size_t start = m_buffer.size();
+        m_buffer.insert(m_buffer.end(), buffer->m_buffer.begin(), buffer->m_buffer.end());
+        for (size_t i = start; i < m_buffer.size(); i += 2) {
+            m_buffer[i] += offset.x;
+            m_buffer[i + 1] += offset.y;
+        }
+    }
+
     void clear()
     {
         m_buffer.clear();
@@ -136,6 +213,7 @@ public:
     const float* vertices() const { return m_buffer.data(); }
     int vertexCount() const { return m_buffer.size() / 2; }
     int size() const { return m_buffer.size(); }
+    size_t capacityBytes() const { return m_buffer.capacity() * sizeof(float); }
 
     // cache
     void cache()
@@ -151,10 +229,26 @@ public:
         m_cached = true;
     }
 
+    void fenceHardwareCache() const
+    {
+        if (m_hardwareBuffer)
+            m_hardwareBuffer->fence();
+    }
+
     bool isCached() const { return m_cached; }
     HardwareBuffer* getHardwareCache() const { return m_hardwareBuffer; }
 
 private:
+    // grows the buffer once and returns the write cursor, so each emitter
+    // pays a single bounds check instead of one per component and the
+    // component stores stay contiguous for the compiler to vectorize
+    float* prepare(const size_t count)
+    {
+        const size_t pos = m_buffer.size();
+        m_buffer.resize(pos + count);
+        return m_buffer.data() + pos;
+    }
+
     bool m_cached{ false };
     std::vector<float> m_buffer;
     HardwareBuffer* m_hardwareBuffer = nullptr;
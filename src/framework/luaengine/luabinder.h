@@ -153,47 +153,34 @@ namespace luabinder
         return bind_lambda_fun<F>::call(f);
     }
 
-    /// Convert to C++ functions pointers to std::function then bind
+    /// Bind C++ function pointers directly, without a std::function layer
     template<typename Ret, typename... Args>
     LuaCppFunction bind_fun(Ret(*f)(Args...))
     {
-        return bind_fun(std::function<Ret(Args...)>(f));
+        using Tuple = std::tuple<typename stdext::remove_const_ref<Args>::type...>;
+        return bind_fun_specializer<typename stdext::remove_const_ref<Ret>::type,
+            decltype(f),
+            Tuple>(f);
     }
 
-    /// Create member function lambdas
+    /// Create member function lambdas; the raw lambda is returned instead
+    /// of a std::function so the call inside the bound LuaCppFunction stays
+    /// statically dispatched
     template<typename Ret, typename C, typename... Args>
-    std::function<Ret(const std::shared_ptr<C>&, const Args&...)> make_mem_func(Ret(C::* f)(Args...))
+    auto make_mem_func(Ret(C::* f)(Args...))
     {
-        auto mf = std::mem_fn(f);
-        return [=](const std::shared_ptr<C>& obj, const Args&... args) mutable -> Ret {
+        return [f](const std::shared_ptr<C>& obj, const Args&... args) -> Ret {
             if (!obj)
                 throw LuaException("failed to call a member function because the passed object is nil");
-            return mf(obj.get(), args...);
-        };
-    }
-    template<typename C, typename... Args>
-    std::function<void(const std::shared_ptr<C>&, const Args&...)> make_mem_func(void (C::* f)(Args...))
-    {
-        auto mf = std::mem_fn(f);
-        return [=](const std::shared_ptr<C>& obj, const Args&... args) mutable {
-            if (!obj)
-                throw LuaException("failed to call a member function because the passed object is nil");
-            mf(obj.get(), args...);
+            return (obj.get()->*f)(args...);
         };
     }
 
     /// Create member function lambdas for singleton classes
     template<typename Ret, typename C, typename... Args>
-    std::function<Ret(const Args&...)> make_mem_func_singleton(Ret(C::* f)(Args...), C* instance)
+    auto make_mem_func_singleton(Ret(C::* f)(Args...), C* instance)
     {
-        auto mf = std::mem_fn(f);
-        return [=](Args... args) mutable -> Ret { return mf(instance, args...); };
-    }
-    template<typename C, typename... Args>
-    std::function<void(const Args&...)> make_mem_func_singleton(void (C::* f)(Args...), C* instance)
-    {
-        auto mf = std::mem_fn(f);
-        return [=](Args... args) mutable { mf(instance, args...); };
+        return [f, instance](const Args&... args) -> Ret { return (instance->*f)(args...); };
     }
 
     /// Bind member functions
@@ -23,6 +23,10 @@
 #include "luainterface.h"
 #include "luaobject.h"
 
+#include <framework/core/clock.h>
+#include <framework/core/filestream.h>
+#include <framework/core/frameprofiler.h>
+#include <framework/core/memorytracker.h>
 #include <framework/core/resourcemanager.h>
 
 LuaInterface g_lua;
@@ -31,6 +35,16 @@ void LuaInterface::init()
 {
     createLuaState();
 
+    // the frame loop drives the collector in small budgeted steps; the
+    // automatic pace stays only as a distant safety net in case the
+    // stepping ever falls behind
+    lua_gc(L, LUA_GCSETPAUSE, 1000);
+
+    // LuaJIT owns its allocator, so the GC count is the source of truth
+    g_memory.registerGauge("lua", [this] {
+        return static_cast<uint64_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+    });
+
     // store global environment reference
     pushThread();
     getEnv();
@@ -53,6 +67,9 @@ void LuaInterface::init()
 
 void LuaInterface::terminate()
 {
+    // the interned references die with the state
+    m_internedStrings.clear();
+
     // close lua state, it will release all objects
     closeLuaState();
     assert(m_totalFuncRefs == 0);
@@ -116,6 +133,8 @@ void LuaInterface::registerClass(const std::string_view className, const std::st
         newTable();
         getGlobal(baseClass);
         setField("__index");
+        pushCppFunction(&LuaInterface::luaObjectClassSetEvent);
+        setField("__newindex");
         setMetatable();
         pop();
 
@@ -126,6 +145,15 @@ void LuaInterface::registerClass(const std::string_view className, const std::st
         setField("__index");
         setMetatable();
         pop();
+    } else {
+        // the root class has nothing to redirect, but still tracks the
+        // fields stored on it for the handler-presence filter
+        pushValue(klass);
+        newTable();
+        pushCppFunction(&LuaInterface::luaObjectClassSetEvent);
+        setField("__newindex");
+        setMetatable();
+        pop();
     }
 
     // pops klass, klass_mt, klass_fieldmethods
@@ -159,6 +187,8 @@ void LuaInterface::registerClassMemberField(const std::string_view className,
     if (getFunction) {
         pushCppFunction(getFunction);
         setField(stdext::format("get_%s", field));
+        // a get fieldmethod satisfies lookups for the bare name
+        LuaObject::markClassLuaField(field);
     }
 
     if (setFunction) {
@@ -218,6 +248,15 @@ int LuaInterface::luaObjectGetEvent(LuaInterface* lua)
     return 1;
 }
 
+int LuaInterface::luaObjectClassSetEvent(LuaInterface* lua)
+{
+    // stack: klass, key, value
+    LuaObject::markClassLuaField(lua->toString(-2));
+    lua->rawSet(-3);
+    lua->pop(); // pops the class table
+    return 0;
+}
+
 int LuaInterface::luaObjectSetEvent(LuaInterface* lua)
 {
     // stack: obj, key, value
@@ -304,6 +343,12 @@ void LuaInterface::runBuffer(const std::string_view buffer, const std::string_vi
     safeCall(0, 0);
 }
 
+static int luaBytecodeWriter(lua_State*, const void* data, size_t size, void* out)
+{
+    static_cast<std::string*>(out)->append(static_cast<const char*>(data), size);
+    return 0;
+}
+
 void LuaInterface::loadScript(const std::string& fileName)
 {
     // resolve file full path
@@ -313,9 +358,45 @@ void LuaInterface::loadScript(const std::string& fileName)
 
     filePath = g_resources.guessFilePath(filePath, "lua");
 
-    const auto& buffer = g_resources.readFileContents(filePath);
+    // scripts on the real filesystem load from an OS mapping, skipping the copy
+    std::string_view buffer = g_resources.readFileView(filePath);
+    std::string contents;
+    if (buffer.empty()) {
+        contents = g_resources.readFileContents(filePath);
+        buffer = contents;
+    }
+
     const auto& source = "@" + filePath;
+
+#if ENABLE_ENCRYPTION == 1
+    // caching would write decrypted bytecode into the user dir
+    loadBuffer(buffer, source);
+#else
+    // compiled chunks are cached in the user write dir keyed by the source
+    // contents, so scripts that did not change between starts skip the parser
+    const auto& cachePath = stdext::format("/.luacache/%x_%x.luac",
+                                           stdext::adler32(reinterpret_cast<const uint8_t*>(filePath.data()), filePath.size()),
+                                           stdext::adler32(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size()));
+    if (g_resources.fileExists(cachePath)) {
+        try {
+            loadBuffer(g_resources.readFileContents(cachePath), source);
+            return;
+        } catch (const LuaException&) {
+            // bytecode from another lua build, fall through and recompile
+        }
+    }
+
     loadBuffer(buffer, source);
+
+    // scripts running before the user write dir is set up just compile
+    if (!g_resources.getWriteDir().empty()) {
+        std::string bytecode;
+        if (lua_dump(L, luaBytecodeWriter, &bytecode) == 0 && !bytecode.empty()) {
+            g_resources.makeDir("/.luacache");
+            g_resources.writeFileBuffer(cachePath, reinterpret_cast<const uint8_t*>(bytecode.data()), bytecode.size());
+        }
+    }
+#endif
 }
 
 void LuaInterface::loadFunction(const std::string_view buffer, const std::string_view source)
@@ -415,6 +496,9 @@ std::string LuaInterface::getCurrentSourcePath(int level)
 
 int LuaInterface::safeCall(int numArgs, int numRets)
 {
+    // lua cost shows up as its own zone inside the frame timeline
+    const FrameProfiler::Scope profilerZone("lua");
+
     assert(hasIndex(-numArgs - 1));
 
     // saves the current stack size for calculating the number of results later
@@ -729,7 +813,16 @@ void LuaInterface::createLuaState()
     // load lua standard libraries
     luaL_openlibs(L);
 
-#ifndef LUAJIT_VERSION
+#ifdef LUAJIT_VERSION
+    // luajit ships ffi as a preloaded module; expose it as a global so
+    // modules running inside sandbox environments can reach it too
+    lua_getglobal(L, "require");
+    lua_pushstring(L, "ffi");
+    if (lua_pcall(L, 1, 1, 0) == 0)
+        lua_setglobal(L, "ffi");
+    else
+        lua_pop(L, 1);
+#else
     // load Bit lib for bitwise operations
     registerTable(L, "Bit");
     registerMethod(L, "Bit", "bnot", LuaInterface::luaBitNot);
@@ -777,6 +870,109 @@ void LuaInterface::closeLuaState()
     }
 }
 
+void LuaInterface::startProfiling(int instructionInterval)
+{
+    if (m_profiling)
+        return;
+
+    if (instructionInterval <= 0)
+        instructionInterval = 1000;
+
+    // a count hook keeps the overhead proportional to executed
+    // instructions, so idle modules cost nothing; hooks also pin luajit to
+    // the interpreter, which is what makes the samples representative of
+    // bytecode cost instead of whatever traces happened to compile
+    lua_sethook(L, &LuaInterface::profileHook, LUA_MASKCOUNT, instructionInterval);
+    m_profiling = true;
+}
+
+void LuaInterface::stopProfiling()
+{
+    if (!m_profiling)
+        return;
+
+    lua_sethook(L, nullptr, 0, 0);
+    m_profiling = false;
+}
+
+void LuaInterface::resetProfiling()
+{
+    m_profileModuleSamples.clear();
+    m_profileStackSamples.clear();
+}
+
+void LuaInterface::profileHook(lua_State* L, lua_Debug* /*ar*/)
+{
+    // walk the running stack innermost first, each frame becomes source:line
+    std::array<std::string, 16> frames;
+    std::string module;
+    int depth = 0;
+    lua_Debug info;
+    while (depth < static_cast<int>(frames.size()) && lua_getstack(L, depth, &info)) {
+        lua_getinfo(L, "Sl", &info);
+        frames[depth] = stdext::format("%s:%d", info.short_src, info.currentline);
+
+        if (depth == 0) {
+            // module directories are mounted at the filesystem root, so the
+            // first path segment of the innermost source names the module
+            std::string_view path = info.short_src;
+            if (!path.empty() && path[0] == '/')
+                path.remove_prefix(1);
+            module = path.substr(0, path.find('/'));
+        }
+
+        ++depth;
+    }
+
+    if (depth == 0)
+        return;
+
+    // folded stacks are outermost first, the format flamegraph tools expect
+    std::string folded;
+    for (int i = depth - 1; i >= 0; --i) {
+        if (!folded.empty())
+            folded += ';';
+        folded += frames[i];
+    }
+
+    ++g_lua.m_profileModuleSamples[module];
+    ++g_lua.m_profileStackSamples[folded];
+}
+
+std::vector<std::tuple<std::string, uint64_t>> LuaInterface::getProfilingTop()
+{
+    std::vector<std::tuple<std::string, uint64_t>> top;
+    top.reserve(m_profileModuleSamples.size());
+    for (const auto& [module, samples] : m_profileModuleSamples)
+        top.emplace_back(module, samples);
+
+    std::sort(top.begin(), top.end(), [](const auto& a, const auto& b) {
+        return std::get<1>(a) > std::get<1>(b);
+    });
+    return top;
+}
+
+bool LuaInterface::dumpProfilingFlameGraph(const std::string& fileName)
+{
+    try {
+        const FileStreamPtr fout = g_resources.createFile(fileName);
+        if (!fout)
+            throw Exception("unable to create file");
+
+        for (const auto& [stack, samples] : m_profileStackSamples) {
+            const auto& line = stdext::format("%s %llu\n", stack, static_cast<unsigned long long>(samples));
+            fout->write(line.data(), line.size());
+        }
+
+        fout->flush();
+        fout->close();
+        return true;
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("failed to dump lua profile to '%s': %s", fileName, e.what()));
+        return false;
+    }
+}
+
 void LuaInterface::collectGarbage() const
 {
     // prevents recursive collects
@@ -793,6 +989,21 @@ void LuaInterface::collectGarbage() const
     }
 }
 
+void LuaInterface::stepCollectGarbage(const int budgetMicros) const
+{
+    if (!L)
+        return;
+
+    PROFILE_SCOPE("LuaInterface::stepCollectGarbage");
+
+    const ticks_t start = g_clock.rawMicros();
+    do {
+        // finishing a cycle is enough work for one frame
+        if (lua_gc(L, LUA_GCSTEP, 10) == 1)
+            break;
+    } while (g_clock.rawMicros() - start < budgetMicros);
+}
+
 void LuaInterface::loadBuffer(const std::string_view buffer, const std::string_view source)
 {
     // loads lua buffer
@@ -947,7 +1158,12 @@ void LuaInterface::getField(const std::string_view key, int index)
 {
     assert(hasIndex(index));
     assert(isUserdata(index) || isTable(index));
-    lua_getfield(L, index, key.data());
+
+    // field names are constant strings pushed millions of times per
+    // session, going through the interned registry skips re-hashing them
+    // in the VM on every lookup
+    pushInternedString(key);
+    lua_gettable(L, index < 0 ? index - 1 : index);
 }
 
 void LuaInterface::setField(const std::string_view key, int index)
@@ -1163,6 +1379,28 @@ void LuaInterface::pushString(const std::string_view v)
     checkStack();
 }
 
+void LuaInterface::pushInternedString(const std::string_view v)
+{
+    const auto it = m_internedStrings.find(v.data());
+    if (it != m_internedStrings.end()) {
+        if (it->second.text == v) {
+            getRef(it->second.ref);
+            return;
+        }
+
+        // the address was reused by a different string, don't trust it
+        pushString(v);
+        return;
+    }
+
+    pushString(v);
+
+    if (m_internedStrings.size() < MAX_INTERNED_STRINGS) {
+        pushValue();
+        m_internedStrings.emplace(v.data(), InternedString{ std::string{ v }, ref() });
+    }
+}
+
 void LuaInterface::pushLightUserdata(void* p)
 {
     lua_pushlightuserdata(L, p);
@@ -147,6 +147,9 @@ private:
     static int luaObjectGetEvent(LuaInterface* lua);
     /// Metamethod that is called when setting a field of the object by using the keyword '='
     static int luaObjectSetEvent(LuaInterface* lua);
+    /// Metamethod that records fields assigned on registered class tables
+    /// (e.g. 'function UIItem:onHoverChange()'), see LuaObject::markClassLuaField
+    static int luaObjectClassSetEvent(LuaInterface* lua);
     /// Metamethod that will check equality of objects by using the keyword '=='
     static int luaObjectEqualEvent(LuaInterface* lua);
     /// Metamethod that is called every two lua garbage collections
@@ -223,6 +226,19 @@ public:
 
     bool isInCppCallback() const { return m_cppCallbackDepth != 0; }
 
+    /// Sampling profiler: a count hook fires every N interpreted
+    /// instructions and folds the running Lua stack into sample counts,
+    /// attributed to the module owning the innermost source file
+    void startProfiling(int instructionInterval);
+    void stopProfiling();
+    bool isProfiling() { return m_profiling; }
+    void resetProfiling();
+
+    /// Per-module sample counts, most expensive first
+    std::vector<std::tuple<std::string, uint64_t>> getProfilingTop();
+    /// Folded stacks ("outer;inner count" per line) written for flamegraph tooling
+    bool dumpProfilingFlameGraph(const std::string& fileName);
+
 private:
     /// Load scripts requested by lua 'require'
     static int luaScriptLoader(lua_State* L);
@@ -257,6 +273,9 @@ public:
     void closeLuaState();
 
     void collectGarbage() const;
+    // runs incremental collection steps until the microsecond budget is
+    // spent or the collector finishes its cycle; driven by the frame loop
+    void stepCollectGarbage(int budgetMicros) const;
 
     void loadBuffer(const std::string_view buffer, const std::string_view source);
 
@@ -326,6 +345,10 @@ public:
     void pushNumber(double v);
     void pushBoolean(bool v);
     void pushString(const std::string_view v);
+    // like pushString but through the interned registry; meant for hot
+    // constant strings (event names, style names, widget ids) so the VM
+    // does not re-hash the same bytes on every crossing
+    void pushInternedString(std::string_view v);
     void pushLightUserdata(void* p);
     void pushThread();
     void pushValue(int index = -1);
@@ -373,6 +396,26 @@ public:
     T polymorphicPop() { T v = castValue<T>(); pop(1); return v; }
 
 private:
+    // interned-string registry: entries keep a precreated lua reference
+    // keyed by the string's address (stable for the literals that dominate
+    // field lookups) and are verified against their bytes on every hit, so
+    // address reuse can never push the wrong string
+    struct InternedString
+    {
+        std::string text;
+        int ref;
+    };
+
+    static constexpr size_t MAX_INTERNED_STRINGS = 512;
+
+    stdext::map<const void*, InternedString> m_internedStrings;
+
+    static void profileHook(lua_State* L, lua_Debug* ar);
+
+    bool m_profiling{ false };
+    stdext::map<std::string, uint64_t> m_profileModuleSamples;
+    stdext::map<std::string, uint64_t> m_profileStackSamples;
+
     lua_State* L{ nullptr };
     int m_weakTableRef{ 0 };
     int m_cppCallbackDepth{ 0 };
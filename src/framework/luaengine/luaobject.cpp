@@ -27,9 +27,40 @@
 #include <framework/core/application.h>
 
 LuaObject::LuaObject() :
-    m_fieldsTableRef(-1)
+    m_fieldsTableRef(-1),
+    m_fieldsBloom(0)
 {}
 
+// hashes of every field name ever assigned on a registered class table;
+// exact, unlike the per-object bloom, since class tables are few and mostly
+// written once at module load (all lua runs on the main thread)
+static stdext::set<size_t> g_classFieldHashes;
+
+uint64_t LuaObject::fieldBloomBits(const size_t hash)
+{
+    // two bits per name keep accidental matches between the handful of
+    // fields an object really stores negligible; false positives only cost
+    // the old slow path
+    return (UINT64_C(1) << (hash & 63)) | (UINT64_C(1) << ((hash >> 6) & 63));
+}
+
+uint64_t LuaObject::fieldBloomBits(const std::string_view field)
+{
+    return fieldBloomBits(stdext::hash_bytes(field.data(), field.size()));
+}
+
+void LuaObject::markClassLuaField(const std::string_view field)
+{
+    g_classFieldHashes.emplace(stdext::hash_bytes(field.data(), field.size()));
+}
+
+bool LuaObject::mayHaveLuaHandler(const std::string_view field) const
+{
+    const size_t h = stdext::hash_bytes(field.data(), field.size());
+    const uint64_t bits = fieldBloomBits(h);
+    return (m_fieldsBloom & bits) == bits || g_classFieldHashes.contains(h);
+}
+
 LuaObject::~LuaObject()
 {
 #ifndef NDEBUG
@@ -41,7 +72,7 @@ LuaObject::~LuaObject()
 bool LuaObject::hasLuaField(const std::string_view field) const
 {
     bool ret = false;
-    if (m_fieldsTableRef != -1) {
+    if (m_fieldsTableRef != -1 && mayHaveLuaField(field)) {
         g_lua.getRef(m_fieldsTableRef);
         g_lua.getField(field); // push the field value
         ret = !g_lua.isNil();
@@ -55,6 +86,7 @@ void LuaObject::releaseLuaFieldsTable()
     if (m_fieldsTableRef != -1) {
         g_lua.unref(m_fieldsTableRef);
         m_fieldsTableRef = -1;
+        m_fieldsBloom = 0;
     }
 }
 
@@ -72,6 +104,9 @@ void LuaObject::luaSetField(const std::string_view key)
         m_fieldsTableRef = g_lua.ref(); // save a reference for it
     }
 
+    // clears (nil writes) stay marked, they just fall back to the lookup
+    m_fieldsBloom |= fieldBloomBits(key);
+
     g_lua.getRef(m_fieldsTableRef); // push the table
     g_lua.insert(-2); // move the value to the top
     g_lua.setField(key); // set the field
@@ -80,7 +115,7 @@ void LuaObject::luaSetField(const std::string_view key)
 
 void LuaObject::luaGetField(const std::string_view key) const
 {
-    if (m_fieldsTableRef != -1) {
+    if (m_fieldsTableRef != -1 && mayHaveLuaField(key)) {
         g_lua.getRef(m_fieldsTableRef); // push the obj's fields table
         g_lua.getField(key); // push the field value
         g_lua.remove(-2); // remove the table
@@ -62,6 +62,11 @@ public:
     /// Release fields table reference
     void releaseLuaFieldsTable();
 
+    /// Records a field name assigned on a registered class table, so event
+    /// dispatch keeps seeing handlers shared through the class (e.g.
+    /// 'function UIItem:onHoverChange()'), see mayHaveLuaHandler()
+    static void markClassLuaField(std::string_view field);
+
     /// Sets a field from this lua object, the value must be on the stack
     void luaSetField(const std::string_view key);
 
@@ -84,10 +89,33 @@ public:
     template<typename T>
     std::shared_ptr<T> dynamic_self_cast() { return std::dynamic_pointer_cast<T>(shared_from_this()); }
 
+    // non-owning counterpart of static_self_cast for hot paths where the
+    // caller already holds a reference; skips the atomic refcount
+    // round-trip of materializing a temporary shared_ptr
+    template<typename T>
+    T* static_self() { return static_cast<T*>(this); }
+
     void operator=(const LuaObject&) const {}
 
 private:
+    // every field write funnels through luaSetField, so this bloom filter
+    // knows which names can possibly be stored; lookups for anything else
+    // (the common case for tiles, things and unset widget callbacks) push
+    // nil without ever touching the lua registry
+    static uint64_t fieldBloomBits(size_t hash);
+    static uint64_t fieldBloomBits(std::string_view field);
+    bool mayHaveLuaField(const std::string_view field) const
+    {
+        const uint64_t bits = fieldBloomBits(field);
+        return (m_fieldsBloom & bits) == bits;
+    }
+
+    // stronger variant for event dispatch: also consults the names ever
+    // stored on registered class tables, where modules keep shared handlers
+    bool mayHaveLuaHandler(std::string_view field) const;
+
     int m_fieldsTableRef;
+    uint64_t m_fieldsBloom;
 };
 
 template<typename F>
@@ -158,6 +186,12 @@ connect(const LuaObjectPtr& obj, const std::string_view field, const Lambda& f,
 template<typename... T>
 int LuaObject::luaCallLuaField(const std::string_view field, const T&... args)
 {
+    // most event kinds never get a handler connected; bail out before the
+    // object push and the __index round-trip when neither this object nor
+    // any registered class table ever stored the field
+    if (!mayHaveLuaHandler(field))
+        return 0;
+
     // we need to gracefully catch a cast exception here in case
     // this is called from a constructor, this does not need to 
     // blow up, we can just debug log it and exit.
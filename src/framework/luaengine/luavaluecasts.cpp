@@ -22,6 +22,7 @@
 
 #include "luavaluecasts.h"
 #include <framework/otml/otmlnode.h>
+#include <nlohmann/json.hpp>
 #include "luainterface.h"
 
  // bool
@@ -270,7 +271,12 @@ void push_otml_subnode_luavalue(const OTMLNodePtr& node)
         else
             g_lua.pushString(value);
     } else if (node->hasChildren()) {
-        g_lua.newTable();
+        int nrec = 0;
+        for (const auto& cnode : node->children()) {
+            if (cnode->isUnique())
+                ++nrec;
+        }
+        g_lua.createTable(node->size() - nrec, nrec);
         bool pushedChild = false;
         int currentIndex = 1;
         for (const auto& cnode : node->children()) {
@@ -297,7 +303,12 @@ void push_otml_subnode_luavalue(const OTMLNodePtr& node)
 int push_luavalue(const OTMLNodePtr& node)
 {
     if (node) {
-        g_lua.newTable();
+        int nrec = 0;
+        for (const auto& cnode : node->children()) {
+            if (cnode->isUnique() && !cnode->tag().empty())
+                ++nrec;
+        }
+        g_lua.createTable(node->size() - nrec, nrec);
         int currentIndex = 1;
         for (const auto& cnode : node->children()) {
             push_otml_subnode_luavalue(cnode);
@@ -352,6 +363,56 @@ bool luavalue_cast(int index, OTMLNodePtr& node)
     return false;
 }
 
+// json
+int push_luavalue(const nlohmann::json& json)
+{
+    switch (json.type()) {
+        case nlohmann::json::value_t::object:
+            g_lua.createTable(0, static_cast<int>(json.size()));
+            for (const auto& [key, value] : json.items()) {
+                push_luavalue(value);
+                g_lua.setField(key);
+            }
+            break;
+        case nlohmann::json::value_t::array: {
+            g_lua.createTable(static_cast<int>(json.size()), 0);
+            int i = 1;
+            for (const auto& value : json) {
+                push_luavalue(value);
+                g_lua.rawSeti(i++);
+            }
+            break;
+        }
+        case nlohmann::json::value_t::string:
+            g_lua.pushString(json.get_ref<const std::string&>());
+            break;
+        case nlohmann::json::value_t::boolean:
+            g_lua.pushBoolean(json.get<bool>());
+            break;
+        case nlohmann::json::value_t::number_integer:
+            push_luavalue(json.get<int64_t>());
+            break;
+        case nlohmann::json::value_t::number_unsigned:
+            push_luavalue(json.get<uint64_t>());
+            break;
+        case nlohmann::json::value_t::number_float:
+            g_lua.pushNumber(json.get<double>());
+            break;
+        default:
+            g_lua.pushNil();
+            break;
+    }
+    return 1;
+}
+
+int push_luavalue(const std::shared_ptr<nlohmann::json>& json)
+{
+    if (json)
+        return push_luavalue(*json);
+    g_lua.pushNil();
+    return 1;
+}
+
 // object ptr
 bool luavalue_cast(int index, LuaObjectPtr& obj)
 {
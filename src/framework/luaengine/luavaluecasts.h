@@ -26,6 +26,9 @@
 
 #include <framework/otml/declarations.h>
 #include <framework/platform/platform.h>
+#include <framework/stdext/smallfunction.h>
+#include <framework/stdext/smallvector.h>
+#include <nlohmann/json_fwd.hpp>
 #include "declarations.h"
 
 template<typename T>
@@ -87,7 +90,15 @@ inline bool luavalue_cast(int index, uint32_t& v)
     const bool r = luavalue_cast(index, d); v = d; return r;
 }
 // int64
-inline int push_luavalue(int64_t v) { push_luavalue(static_cast<double>(v)); return 1; }
+// lua numbers are doubles on both backends (luajit included), integers
+// past 2^53 would silently round, catch it instead of corrupting values
+inline int push_luavalue(int64_t v)
+{
+    if (v > (1ll << 53) || v < -(1ll << 53))
+        g_logger.traceWarning(stdext::format("pushing 64-bit value %s to lua loses precision", std::to_string(v)));
+    push_luavalue(static_cast<double>(v));
+    return 1;
+}
 inline bool luavalue_cast(int index, int64_t& v)
 {
     double d;
@@ -105,7 +116,13 @@ inline bool luavalue_cast(int index, ulong& v)
 #endif
 
 // uint64
-inline int push_luavalue(uint64_t v) { push_luavalue(static_cast<double>(v)); return 1; }
+inline int push_luavalue(uint64_t v)
+{
+    if (v > (1ull << 53))
+        g_logger.traceWarning(stdext::format("pushing 64-bit value %s to lua loses precision", std::to_string(v)));
+    push_luavalue(static_cast<double>(v));
+    return 1;
+}
 inline bool luavalue_cast(int index, uint64_t& v)
 {
     double d;
@@ -144,6 +161,10 @@ bool luavalue_cast(int index, Platform::Device& device);
 int push_luavalue(const OTMLNodePtr& node);
 bool luavalue_cast(int index, OTMLNodePtr& node);
 
+// json, built as plain lua tables (see HttpBuffer::getJson)
+int push_luavalue(const nlohmann::json& json);
+int push_luavalue(const std::shared_ptr<nlohmann::json>& json);
+
 // enum
 template<class T>
 std::enable_if_t<std::is_enum_v<T>, int>
@@ -175,6 +196,10 @@ template<typename Ret, typename... Args>
 std::enable_if_t<!std::is_void_v<Ret>, bool>
 luavalue_cast(int index, std::function<Ret(Args...)>& func);
 
+// stdext::small_function
+template<std::size_t Capacity, typename... Args>
+bool luavalue_cast(int index, stdext::small_function<void(Args...), Capacity>& func);
+
 // list
 template<typename T>
 int push_luavalue(const std::list<T>& list);
@@ -196,6 +221,13 @@ int push_luavalue(const std::deque<T>& vec);
 template<typename T>
 bool luavalue_cast(int index, std::deque<T>& vec);
 
+// small_vector
+template<typename T, std::size_t N>
+int push_luavalue(const stdext::small_vector<T, N>& vec);
+
+template<typename T, std::size_t N>
+bool luavalue_cast(int index, stdext::small_vector<T, N>& vec);
+
 // map
 template<class K, class V, class H>
 int push_luavalue(const stdext::map<K, V, H>& map);
@@ -301,6 +333,22 @@ bool luavalue_cast(int index, std::function<void(Args...)>& func)
     return false;
 }
 
+template<std::size_t Capacity, typename... Args>
+bool luavalue_cast(int index, stdext::small_function<void(Args...), Capacity>& func)
+{
+    // the weak-ref trampoline above only captures an int, so wrapping it
+    // keeps the whole thing in the inline storage
+    std::function<void(Args...)> f;
+    if (!luavalue_cast(index, f))
+        return false;
+
+    if (f)
+        func = std::move(f);
+    else
+        func = nullptr;
+    return true;
+}
+
 template<typename Ret, typename... Args>
 std::enable_if_t<!std::is_void_v<Ret>, bool>
 luavalue_cast(int index, std::function<Ret(Args...)>& func)
@@ -423,10 +471,39 @@ bool luavalue_cast(int index, std::deque<T>& vec)
     return false;
 }
 
+template<typename T, std::size_t N>
+int push_luavalue(const stdext::small_vector<T, N>& vec)
+{
+    g_lua.createTable(vec.size(), 0);
+    int i = 1;
+    for (const T& v : vec) {
+        push_internal_luavalue(v);
+        g_lua.rawSeti(i);
+        ++i;
+    }
+    return 1;
+}
+
+template<typename T, std::size_t N>
+bool luavalue_cast(int index, stdext::small_vector<T, N>& vec)
+{
+    if (g_lua.isTable(index)) {
+        g_lua.pushNil();
+        while (g_lua.next(index < 0 ? index - 1 : index)) {
+            T value;
+            if (luavalue_cast(-1, value))
+                vec.push_back(value);
+            g_lua.pop();
+        }
+        return true;
+    }
+    return false;
+}
+
 template<class K, class V, class H>
 int push_luavalue(const stdext::map<K, V, H>& map)
 {
-    g_lua.newTable();
+    g_lua.createTable(0, map.size());
     for (const auto& [key, value] : map) {
         push_internal_luavalue(key);
         push_internal_luavalue(value);
@@ -474,7 +551,7 @@ struct push_tuple_internal_luavalue<0>
 template<typename... Args>
 int push_internal_luavalue(const std::tuple<Args...>& tuple)
 {
-    g_lua.newTable();
+    g_lua.createTable(sizeof...(Args), 0);
     push_tuple_internal_luavalue<sizeof...(Args)>::call(tuple);
     return 1;
 }
@@ -24,6 +24,10 @@
 #include <framework/core/config.h>
 #include <framework/core/configmanager.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/benchmark.h>
+#include <framework/core/frameprofiler.h>
+#include <framework/core/memorytracker.h>
+#include <framework/core/hitchwatchdog.h>
 #include <framework/core/module.h>
 #include <framework/core/modulemanager.h>
 #include <framework/core/resourcemanager.h>
@@ -127,6 +131,44 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_clock", "millis", &Clock::millis, &g_clock);
     g_lua.bindSingletonFunction("g_clock", "seconds", &Clock::seconds, &g_clock);
 
+    // FrameProfiler
+    g_lua.registerSingletonClass("g_profiler");
+    g_lua.bindSingletonFunction("g_profiler", "setEnabled", &FrameProfiler::setEnabled, &g_profiler);
+    g_lua.bindSingletonFunction("g_profiler", "isEnabled", &FrameProfiler::isEnabled, &g_profiler);
+    g_lua.bindSingletonFunction("g_profiler", "getFrameCount", &FrameProfiler::getFrameCount, &g_profiler);
+    g_lua.bindSingletonFunction("g_profiler", "getFrameTimes", &FrameProfiler::getFrameTimes, &g_profiler);
+    g_lua.bindSingletonFunction("g_profiler", "getLastFrameZones", &FrameProfiler::getLastFrameZones, &g_profiler);
+    g_lua.bindSingletonFunction("g_profiler", "getLastFrameGpuTimes", &FrameProfiler::getLastFrameGpuTimes, &g_profiler);
+    g_lua.bindSingletonFunction("g_profiler", "dumpTrace", &FrameProfiler::dumpTrace, &g_profiler);
+
+    // Benchmark
+    g_lua.registerSingletonClass("g_benchmark");
+    g_lua.bindSingletonFunction("g_benchmark", "start", &Benchmark::start, &g_benchmark);
+    g_lua.bindSingletonFunction("g_benchmark", "stop", &Benchmark::stop, &g_benchmark);
+    g_lua.bindSingletonFunction("g_benchmark", "isRunning", &Benchmark::isRunning, &g_benchmark);
+    g_lua.bindSingletonFunction("g_benchmark", "getFrameCount", &Benchmark::getFrameCount, &g_benchmark);
+    g_lua.bindSingletonFunction("g_benchmark", "exportResults", &Benchmark::exportResults, &g_benchmark);
+
+    // sampling lua profiler with per-module attribution
+    g_lua.registerSingletonClass("g_lua");
+    g_lua.bindSingletonFunction("g_lua", "startProfiling", &LuaInterface::startProfiling, &g_lua);
+    g_lua.bindSingletonFunction("g_lua", "stopProfiling", &LuaInterface::stopProfiling, &g_lua);
+    g_lua.bindSingletonFunction("g_lua", "isProfiling", &LuaInterface::isProfiling, &g_lua);
+    g_lua.bindSingletonFunction("g_lua", "resetProfiling", &LuaInterface::resetProfiling, &g_lua);
+    g_lua.bindSingletonFunction("g_lua", "getProfilingTop", &LuaInterface::getProfilingTop, &g_lua);
+    g_lua.bindSingletonFunction("g_lua", "dumpProfilingFlameGraph", &LuaInterface::dumpProfilingFlameGraph, &g_lua);
+
+    // MemoryTracker
+    g_lua.registerSingletonClass("g_memory");
+    g_lua.bindSingletonFunction("g_memory", "getCounters", &MemoryTracker::getCounters, &g_memory);
+
+    // HitchWatchdog
+    g_lua.registerSingletonClass("g_hitchWatchdog");
+    g_lua.bindSingletonFunction("g_hitchWatchdog", "setEnabled", &HitchWatchdog::setEnabled, &g_hitchWatchdog);
+    g_lua.bindSingletonFunction("g_hitchWatchdog", "isEnabled", &HitchWatchdog::isEnabled, &g_hitchWatchdog);
+    g_lua.bindSingletonFunction("g_hitchWatchdog", "setThreshold", &HitchWatchdog::setThreshold, &g_hitchWatchdog);
+    g_lua.bindSingletonFunction("g_hitchWatchdog", "getThreshold", &HitchWatchdog::getThreshold, &g_hitchWatchdog);
+
     // ConfigManager
     g_lua.registerSingletonClass("g_configs");
     g_lua.bindSingletonFunction("g_configs", "getSettings", &ConfigManager::getSettings, &g_configs);
@@ -154,22 +196,38 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_http", "setUserAgent", &Http::setUserAgent, &g_http);
     g_lua.bindSingletonFunction("g_http", "setEnableTimeOutOnReadWrite", &Http::setEnableTimeOutOnReadWrite, &g_http);
     g_lua.bindSingletonFunction("g_http", "addCustomHeader", &Http::addCustomHeader, &g_http);
+    g_lua.bindSingletonFunction("g_http", "setCachePolicy", &Http::setCachePolicy, &g_http);
+    g_lua.bindSingletonFunction("g_http", "getCachePolicy", &Http::getCachePolicy, &g_http);
+    g_lua.bindSingletonFunction("g_http", "clearCache", &Http::clearCache, &g_http);
+    g_lua.bindSingletonFunction("g_http", "prewarm", &Http::prewarm, &g_http);
     g_lua.bindSingletonFunction("g_http", "get", &Http::get, &g_http);
     g_lua.bindSingletonFunction("g_http", "post", &Http::post, &g_http);
     g_lua.bindSingletonFunction("g_http", "download", &Http::download, &g_http);
+    g_lua.bindSingletonFunction("g_http", "sync", &Http::sync, &g_http);
     g_lua.bindSingletonFunction("g_http", "ws", &Http::ws, &g_http);
     g_lua.bindSingletonFunction("g_http", "wsSend", &Http::wsSend, &g_http);
     g_lua.bindSingletonFunction("g_http", "wsClose", &Http::wsClose, &g_http);
     g_lua.bindSingletonFunction("g_http", "cancel", &Http::cancel, &g_http);
 
+    g_lua.registerClass<HttpBuffer>();
+    g_lua.bindClassMemberFunction<HttpBuffer>("getLength", &HttpBuffer::getLength);
+    g_lua.bindClassMemberFunction<HttpBuffer>("getData", &HttpBuffer::getData);
+    g_lua.bindClassMemberFunction<HttpBuffer>("slice", &HttpBuffer::slice);
+    g_lua.bindClassMemberFunction<HttpBuffer>("checksum", &HttpBuffer::checksum);
+    g_lua.bindClassMemberFunction<HttpBuffer>("save", &HttpBuffer::save);
+    g_lua.bindClassMemberFunction<HttpBuffer>("hasJson", &HttpBuffer::hasJson);
+    g_lua.bindClassMemberFunction<HttpBuffer>("getJson", &HttpBuffer::getJson);
+    g_lua.bindClassMemberFunction<HttpBuffer>("getJsonError", &HttpBuffer::getJsonError);
+
     // ModuleManager
     g_lua.registerSingletonClass("g_modules");
     g_lua.bindSingletonFunction("g_modules", "discoverModules", &ModuleManager::discoverModules, &g_modules);
     g_lua.bindSingletonFunction("g_modules", "autoLoadModules", &ModuleManager::autoLoadModules, &g_modules);
-    g_lua.bindSingletonFunction("g_modules", "discoverModule", &ModuleManager::discoverModule, &g_modules);
+    g_lua.bindSingletonFunction("g_modules", "discoverModule", static_cast<ModulePtr(ModuleManager::*)(const std::string&)>(&ModuleManager::discoverModule), &g_modules);
     g_lua.bindSingletonFunction("g_modules", "ensureModuleLoaded", &ModuleManager::ensureModuleLoaded, &g_modules);
     g_lua.bindSingletonFunction("g_modules", "unloadModules", &ModuleManager::unloadModules, &g_modules);
     g_lua.bindSingletonFunction("g_modules", "reloadModules", &ModuleManager::reloadModules, &g_modules);
+    g_lua.bindSingletonFunction("g_modules", "reloadModule", &ModuleManager::reloadModule, &g_modules);
     g_lua.bindSingletonFunction("g_modules", "getModule", &ModuleManager::getModule, &g_modules);
     g_lua.bindSingletonFunction("g_modules", "getModules", &ModuleManager::getModules, &g_modules);
 
@@ -178,6 +236,10 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_dispatcher", "addEvent", &EventDispatcher::addEvent, &g_dispatcher);
     g_lua.bindSingletonFunction("g_dispatcher", "scheduleEvent", &EventDispatcher::scheduleEvent, &g_dispatcher);
     g_lua.bindSingletonFunction("g_dispatcher", "cycleEvent", &EventDispatcher::cycleEvent, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "setPollBudget", &EventDispatcher::setPollBudget, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getPollBudget", &EventDispatcher::getPollBudget, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getCarriedEvents", &EventDispatcher::getCarriedEvents, &g_dispatcher);
+    g_lua.bindSingletonFunction("g_dispatcher", "getStarvedPolls", &EventDispatcher::getStarvedPolls, &g_dispatcher);
 
     // ResourceManager
     g_lua.registerSingletonClass("g_resources");
@@ -185,6 +247,9 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_resources", "setupUserWriteDir", &ResourceManager::setupUserWriteDir, &g_resources);
     g_lua.bindSingletonFunction("g_resources", "setWriteDir", &ResourceManager::setWriteDir, &g_resources);
     g_lua.bindSingletonFunction("g_resources", "searchAndAddPackages", &ResourceManager::searchAndAddPackages, &g_resources);
+    g_lua.bindSingletonFunction("g_resources", "mountAssetBundle", &ResourceManager::mountAssetBundle, &g_resources);
+    g_lua.bindSingletonFunction("g_resources", "unmountAssetBundle", &ResourceManager::unmountAssetBundle, &g_resources);
+    g_lua.bindSingletonFunction("g_resources", "buildAssetBundle", &ResourceManager::buildAssetBundle, &g_resources);
     g_lua.bindSingletonFunction("g_resources", "removeSearchPath", &ResourceManager::removeSearchPath, &g_resources);
     g_lua.bindSingletonFunction("g_resources", "fileExists", &ResourceManager::fileExists, &g_resources);
     g_lua.bindSingletonFunction("g_resources", "directoryExists", &ResourceManager::directoryExists, &g_resources);
@@ -208,6 +273,7 @@ void Application::registerLuaFunctions()
     // Config
     g_lua.registerClass<Config>();
     g_lua.bindClassMemberFunction<Config>("save", &Config::save);
+    g_lua.bindClassMemberFunction<Config>("flush", &Config::flush);
     g_lua.bindClassMemberFunction<Config>("setValue", &Config::setValue);
     g_lua.bindClassMemberFunction<Config>("setList", &Config::setList);
     g_lua.bindClassMemberFunction<Config>("getValue", &Config::getValue);
@@ -269,6 +335,8 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_app", "setDrawTexts", &GraphicalApplication::setDrawTexts, &g_app);
     g_lua.bindSingletonFunction("g_app", "setLoadingAsyncTexture", &GraphicalApplication::setLoadingAsyncTexture, &g_app);
     g_lua.bindSingletonFunction("g_app", "isEncrypted", &GraphicalApplication::isEncrypted, &g_app);
+    g_lua.bindSingletonFunction("g_app", "isHeadless", &GraphicalApplication::isHeadless, &g_app);
+    g_lua.bindSingletonFunction("g_app", "takeScreenshot", &GraphicalApplication::takeScreenshot, &g_app);
 
     // PlatformWindow
     g_lua.registerSingletonClass("g_window");
@@ -331,6 +399,9 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_textures", "preload", &TextureManager::preload, &g_textures);
     g_lua.bindSingletonFunction("g_textures", "clearCache", &TextureManager::clearCache, &g_textures);
     g_lua.bindSingletonFunction("g_textures", "liveReload", &TextureManager::liveReload, &g_textures);
+    g_lua.bindSingletonFunction("g_textures", "setVRAMBudget", &TextureManager::setVRAMBudget, &g_textures);
+    g_lua.bindSingletonFunction("g_textures", "getVRAMUsage", &TextureManager::getVRAMUsage, &g_textures);
+    g_lua.bindSingletonFunction("g_textures", "getEvictedCount", &TextureManager::getEvictedCount, &g_textures);
 
     // UI
     g_lua.registerSingletonClass("g_ui");
@@ -397,6 +468,7 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIWidget>("bindRectToParent", &UIWidget::bindRectToParent);
     g_lua.bindClassMemberFunction<UIWidget>("destroy", &UIWidget::destroy);
     g_lua.bindClassMemberFunction<UIWidget>("destroyChildren", &UIWidget::destroyChildren);
+    g_lua.bindClassMemberFunction<UIWidget>("tween", &UIWidget::tween);
     g_lua.bindClassMemberFunction<UIWidget>("setId", &UIWidget::setId);
     g_lua.bindClassMemberFunction<UIWidget>("setParent", &UIWidget::setParent);
     g_lua.bindClassMemberFunction<UIWidget>("setLayout", &UIWidget::setLayout);
@@ -412,6 +484,7 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIWidget>("setDraggable", &UIWidget::setDraggable);
     g_lua.bindClassMemberFunction<UIWidget>("setFixedSize", &UIWidget::setFixedSize);
     g_lua.bindClassMemberFunction<UIWidget>("setClipping", &UIWidget::setClipping);
+    g_lua.bindClassMemberFunction<UIWidget>("setCachedRendering", &UIWidget::setCachedRendering);
     g_lua.bindClassMemberFunction<UIWidget>("setLastFocusReason", &UIWidget::setLastFocusReason);
     g_lua.bindClassMemberFunction<UIWidget>("setAutoFocusPolicy", &UIWidget::setAutoFocusPolicy);
     g_lua.bindClassMemberFunction<UIWidget>("setAutoRepeatDelay", &UIWidget::setAutoRepeatDelay);
@@ -467,6 +540,7 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIWidget>("isDraggable", &UIWidget::isDraggable);
     g_lua.bindClassMemberFunction<UIWidget>("isFixedSize", &UIWidget::isFixedSize);
     g_lua.bindClassMemberFunction<UIWidget>("isClipping", &UIWidget::isClipping);
+    g_lua.bindClassMemberFunction<UIWidget>("isCachedRendering", &UIWidget::isCachedRendering);
     g_lua.bindClassMemberFunction<UIWidget>("isDestroyed", &UIWidget::isDestroyed);
     g_lua.bindClassMemberFunction<UIWidget>("isTextWrap", &UIWidget::isTextWrap);
     g_lua.bindClassMemberFunction<UIWidget>("hasChildren", &UIWidget::hasChildren);
@@ -644,11 +718,13 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIWidget>("setTextVerticalAutoResize", &UIWidget::setTextVerticalAutoResize);
     g_lua.bindClassMemberFunction<UIWidget>("setTextHorizontalAutoResize", &UIWidget::setTextHorizontalAutoResize);
     g_lua.bindClassMemberFunction<UIWidget>("setFont", &UIWidget::setFont);
+    g_lua.bindClassMemberFunction<UIWidget>("setFontScale", &UIWidget::setFontScale);
     g_lua.bindClassMemberFunction<UIWidget>("getText", &UIWidget::getText);
     g_lua.bindClassMemberFunction<UIWidget>("getDrawText", &UIWidget::getDrawText);
     g_lua.bindClassMemberFunction<UIWidget>("getTextAlign", &UIWidget::getTextAlign);
     g_lua.bindClassMemberFunction<UIWidget>("getTextOffset", &UIWidget::getTextOffset);
     g_lua.bindClassMemberFunction<UIWidget>("getFont", &UIWidget::getFont);
+    g_lua.bindClassMemberFunction<UIWidget>("getFontScale", &UIWidget::getFontScale);
     g_lua.bindClassMemberFunction<UIWidget>("getTextSize", &UIWidget::getTextSize);
 
     // UILayout
@@ -700,6 +776,10 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIGridLayout>("getNumLines", &UIGridLayout::getNumLines);
     g_lua.bindClassMemberFunction<UIGridLayout>("getCellSize", &UIGridLayout::getCellSize);
     g_lua.bindClassMemberFunction<UIGridLayout>("getCellSpacing", &UIGridLayout::getCellSpacing);
+    g_lua.bindClassMemberFunction<UIGridLayout>("setVirtualized", &UIGridLayout::setVirtualized);
+    g_lua.bindClassMemberFunction<UIGridLayout>("isVirtualized", &UIGridLayout::isVirtualized);
+    g_lua.bindClassMemberFunction<UIGridLayout>("getFirstVisibleIndex", &UIGridLayout::getFirstVisibleIndex);
+    g_lua.bindClassMemberFunction<UIGridLayout>("getLastVisibleIndex", &UIGridLayout::getLastVisibleIndex);
     g_lua.bindClassMemberFunction<UIGridLayout>("isUIGridLayout", &UIGridLayout::isUIGridLayout);
 
     // UIAnchorLayout
@@ -759,6 +839,36 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UITextEdit>("isShiftNavigation", &UITextEdit::isShiftNavigation);
     g_lua.bindClassMemberFunction<UITextEdit>("isMultiline", &UITextEdit::isMultiline);
 
+    // UITween
+    g_lua.registerClass<UITween>();
+    g_lua.bindClassMemberFunction<UITween>("fadeTo", &UITween::fadeTo);
+    g_lua.bindClassMemberFunction<UITween>("moveTo", &UITween::moveTo);
+    g_lua.bindClassMemberFunction<UITween>("colorTo", &UITween::colorTo);
+    g_lua.bindClassMemberFunction<UITween>("setDuration", &UITween::setDuration);
+    g_lua.bindClassMemberFunction<UITween>("setDelay", &UITween::setDelay);
+    g_lua.bindClassMemberFunction<UITween>("setEasing", &UITween::setEasing);
+    g_lua.bindClassMemberFunction<UITween>("setRepeat", &UITween::setRepeat);
+    g_lua.bindClassMemberFunction<UITween>("start", &UITween::start);
+    g_lua.bindClassMemberFunction<UITween>("stop", &UITween::stop);
+    g_lua.bindClassMemberFunction<UITween>("isRunning", &UITween::isRunning);
+    g_lua.bindClassMemberFunction<UITween>("getWidget", &UITween::getWidget);
+
+    // UIConsoleBuffer
+    g_lua.registerClass<UIConsoleBuffer, UIWidget>();
+    g_lua.bindClassStaticFunction<UIConsoleBuffer>("create", [] { return std::make_shared<UIConsoleBuffer>(); });
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("addLine", &UIConsoleBuffer::addLine);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("clearLines", &UIConsoleBuffer::clearLines);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("setMaxLines", &UIConsoleBuffer::setMaxLines);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("setScrollOffset", &UIConsoleBuffer::setScrollOffset);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("scroll", &UIConsoleBuffer::scroll);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("getMaxLines", &UIConsoleBuffer::getMaxLines);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("getScrollOffset", &UIConsoleBuffer::getScrollOffset);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("getLineCount", &UIConsoleBuffer::getLineCount);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("getLine", &UIConsoleBuffer::getLine);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("getTotalRowCount", &UIConsoleBuffer::getTotalRowCount);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("getVisibleRowCount", &UIConsoleBuffer::getVisibleRowCount);
+    g_lua.bindClassMemberFunction<UIConsoleBuffer>("getMaxScrollOffset", &UIConsoleBuffer::getMaxScrollOffset);
+
     // Shader
     g_lua.registerClass<ShaderProgram>();
     g_lua.registerClass<PainterShaderProgram>();
@@ -785,6 +895,7 @@ void Application::registerLuaFunctions()
 
     // Connection
     g_lua.registerClass<Connection>();
+    g_lua.bindClassStaticFunction<Connection>("warmup", &Connection::warmup);
     g_lua.bindClassMemberFunction<Connection>("getIp", &Connection::getIp);
 
     // Protocol
@@ -807,7 +918,7 @@ void Application::registerLuaFunctions()
 
     // InputMessage
     g_lua.registerClass<InputMessage>();
-    g_lua.bindClassStaticFunction<InputMessage>("create", [] { return std::make_shared<InputMessage>(); });
+    g_lua.bindClassStaticFunction<InputMessage>("create", [] { return InputMessage::create(); });
     g_lua.bindClassMemberFunction<InputMessage>("setBuffer", &InputMessage::setBuffer);
     g_lua.bindClassMemberFunction<InputMessage>("getBuffer", &InputMessage::getBuffer);
     g_lua.bindClassMemberFunction<InputMessage>("skipBytes", &InputMessage::skipBytes);
@@ -828,7 +939,7 @@ void Application::registerLuaFunctions()
 
     // OutputMessage
     g_lua.registerClass<OutputMessage>();
-    g_lua.bindClassStaticFunction<OutputMessage>("create", [] { return std::make_shared<OutputMessage>(); });
+    g_lua.bindClassStaticFunction<OutputMessage>("create", [] { return OutputMessage::create(); });
     g_lua.bindClassMemberFunction<OutputMessage>("setBuffer", &OutputMessage::setBuffer);
     g_lua.bindClassMemberFunction<OutputMessage>("getBuffer", &OutputMessage::getBuffer);
     g_lua.bindClassMemberFunction<OutputMessage>("reset", &OutputMessage::reset);
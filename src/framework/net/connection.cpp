@@ -26,15 +26,18 @@
 
 #include <utility>
 #include <asio/read.hpp>
-#include <asio/read_until.hpp>
 
 asio::io_service g_ioService;
-std::list<std::shared_ptr<asio::streambuf>> Connection::m_outputStreams;
+std::list<Connection::OutputBufferPtr> Connection::m_outputBuffers;
+bool Connection::m_corked = false;
+std::vector<ConnectionPtr> Connection::m_corkedConnections;
+stdext::map<std::string, Connection::CachedEndpoints> Connection::m_dnsCache;
 
 Connection::Connection() :
     m_readTimer(g_ioService),
     m_writeTimer(g_ioService),
     m_delayedWriteTimer(g_ioService),
+    m_raceTimer(g_ioService),
     m_resolver(g_ioService),
     m_socket(g_ioService)
 {}
@@ -49,15 +52,44 @@ Connection::~Connection()
 
 void Connection::poll()
 {
+    // cork writes issued from inside the cycle, so a burst of replies
+    // leaves through a single buffer per connection
+    m_corked = true;
+
     // reset must always be called prior to poll
     g_ioService.reset();
     g_ioService.poll();
+
+    m_corked = false;
+    for (const auto& connection : m_corkedConnections) {
+        if (connection->m_connected && connection->m_outputBuffer)
+            connection->internal_write();
+    }
+    m_corkedConnections.clear();
 }
 
 void Connection::terminate()
 {
     g_ioService.stop();
-    m_outputStreams.clear();
+    m_corkedConnections.clear();
+    m_outputBuffers.clear();
+    m_dnsCache.clear();
+}
+
+void Connection::warmup(const std::string_view host, uint16_t port)
+{
+    const auto cacheKey = stdext::format("%s:%d", host, port);
+    const auto it = m_dnsCache.find(cacheKey);
+    if (it != m_dnsCache.end() && stdext::millis() - it->second.resolvedAt < DNS_CACHE_TTL)
+        return;
+
+    // the resolver must outlive the async operation, the handler keeps it alive
+    const auto resolver = std::make_shared<asio::ip::tcp::resolver>(g_ioService);
+    const asio::ip::tcp::resolver::query query(host.data(), stdext::unsafe_cast<std::string>(port));
+    resolver->async_resolve(query, [resolver, cacheKey](const std::error_code& error, const asio::ip::tcp::resolver::iterator& endpointIterator) {
+        if (!error)
+            m_dnsCache[cacheKey] = { interleaveEndpoints(endpointIterator), stdext::millis() };
+    });
 }
 
 void Connection::close()
@@ -66,7 +98,7 @@ void Connection::close()
         return;
 
     // flush send data before disconnecting on clean connections
-    if (m_connected && !m_error && m_outputStream)
+    if (m_connected && !m_error && m_outputBuffer)
         internal_write();
 
     m_connecting = false;
@@ -79,6 +111,16 @@ void Connection::close()
     m_readTimer.cancel();
     m_writeTimer.cancel();
     m_delayedWriteTimer.cancel();
+    m_raceTimer.cancel();
+
+    for (const auto& socket : m_racingSockets) {
+        if (socket->is_open()) {
+            std::error_code ec;
+            socket->close(ec);
+        }
+    }
+    m_racingSockets.clear();
+    m_endpoints.clear();
 
     if (m_socket.is_open()) {
         std::error_code ec;
@@ -94,11 +136,25 @@ void Connection::connect(const std::string_view host, uint16_t port, const std::
     m_error.clear();
     m_connectCallback = connectCallback;
 
-    const asio::ip::tcp::resolver::query query(host.data(), stdext::unsafe_cast<std::string>(port));
-    m_resolver.async_resolve(query, [capture0 = asConnection()](auto&& PH1, auto&& PH2) {
-        capture0->onResolve(std::forward<decltype(PH1)>(PH1),
-                            std::forward<decltype(PH2)>(PH2));
-    });
+    // discard any leftover from a previous connection
+    m_inputFill = 0;
+    m_untilToken.clear();
+    m_endpoints.clear();
+    m_nextEndpoint = 0;
+    m_racingSockets.clear();
+
+    m_dnsCacheKey = stdext::format("%s:%d", host, port);
+    const auto it = m_dnsCache.find(m_dnsCacheKey);
+    if (it != m_dnsCache.end() && stdext::millis() - it->second.resolvedAt < DNS_CACHE_TTL) {
+        m_endpoints = it->second.endpoints;
+        startNextEndpoint();
+    } else {
+        const asio::ip::tcp::resolver::query query(host.data(), stdext::unsafe_cast<std::string>(port));
+        m_resolver.async_resolve(query, [capture0 = asConnection()](auto&& PH1, auto&& PH2) {
+            capture0->onResolve(std::forward<decltype(PH1)>(PH1),
+                                std::forward<decltype(PH2)>(PH2));
+        });
+    }
 
     m_readTimer.cancel();
     m_readTimer.expires_from_now(asio::chrono::seconds(static_cast<uint32_t>(READ_TIMEOUT)));
@@ -107,17 +163,98 @@ void Connection::connect(const std::string_view host, uint16_t port, const std::
     });
 }
 
-void Connection::internal_connect(const asio::ip::basic_resolver<asio::ip::tcp>::iterator& endpointIterator)
+std::vector<asio::ip::tcp::endpoint> Connection::interleaveEndpoints(const asio::ip::tcp::resolver::iterator& endpointIterator)
 {
-    m_socket.async_connect(*endpointIterator, [capture0 = asConnection()](auto&& PH1) {
-        capture0->onConnect(std::forward<decltype(PH1)>(PH1));
-    });
+    std::vector<asio::ip::tcp::endpoint> v6;
+    std::vector<asio::ip::tcp::endpoint> v4;
+    for (auto it = endpointIterator; it != asio::ip::tcp::resolver::iterator{}; ++it) {
+        if (it->endpoint().address().is_v6())
+            v6.emplace_back(it->endpoint());
+        else
+            v4.emplace_back(it->endpoint());
+    }
 
-    m_readTimer.cancel();
-    m_readTimer.expires_from_now(asio::chrono::seconds(static_cast<uint32_t>(READ_TIMEOUT)));
-    m_readTimer.async_wait([capture0 = asConnection()](auto&& PH1) {
-        capture0->onTimeout(std::forward<decltype(PH1)>(PH1));
+    // alternate families starting with v6, so a broken path on one family
+    // only costs a stagger delay instead of a full timeout
+    std::vector<asio::ip::tcp::endpoint> endpoints;
+    endpoints.reserve(v6.size() + v4.size());
+    for (size_t i = 0; i < std::max(v6.size(), v4.size()); ++i) {
+        if (i < v6.size())
+            endpoints.emplace_back(v6[i]);
+        if (i < v4.size())
+            endpoints.emplace_back(v4[i]);
+    }
+    return endpoints;
+}
+
+void Connection::startNextEndpoint()
+{
+    if (m_nextEndpoint >= m_endpoints.size())
+        return;
+
+    const auto& endpoint = m_endpoints[m_nextEndpoint++];
+    const auto socket = std::make_shared<asio::ip::tcp::socket>(g_ioService);
+    m_racingSockets.emplace_back(socket);
+    socket->async_connect(endpoint, [capture0 = asConnection(), socket](auto&& PH1) {
+        capture0->onAttemptConnect(socket, std::forward<decltype(PH1)>(PH1));
     });
+
+    // give the attempt a head start, then bring the next endpoint into the race
+    if (m_nextEndpoint < m_endpoints.size()) {
+        m_raceTimer.cancel();
+        m_raceTimer.expires_from_now(asio::chrono::milliseconds(static_cast<uint32_t>(RACE_STAGGER_DELAY)));
+        m_raceTimer.async_wait([capture0 = asConnection()](auto&& PH1) {
+            capture0->onRaceStagger(std::forward<decltype(PH1)>(PH1));
+        });
+    }
+}
+
+void Connection::onRaceStagger(const std::error_code& error)
+{
+    if (error == asio::error::operation_aborted)
+        return;
+
+    if (m_connecting && !m_connected)
+        startNextEndpoint();
+}
+
+void Connection::onAttemptConnect(const std::shared_ptr<asio::ip::tcp::socket>& socket, const std::error_code& error)
+{
+    if (error == asio::error::operation_aborted)
+        return;
+
+    // a sibling attempt already won or the connection was closed meanwhile
+    if (m_connected || !m_connecting)
+        return;
+
+    if (!error) {
+        m_raceTimer.cancel();
+        m_socket = std::move(*socket);
+
+        for (const auto& loser : m_racingSockets) {
+            if (loser != socket && loser->is_open()) {
+                std::error_code ec;
+                loser->close(ec);
+            }
+        }
+        m_racingSockets.clear();
+        m_endpoints.clear();
+
+        onConnect(error);
+        return;
+    }
+
+    std::erase(m_racingSockets, socket);
+
+    // while other attempts are still in flight this failure costs nothing;
+    // once the race is empty either start the next endpoint or give up
+    if (m_racingSockets.empty()) {
+        if (m_nextEndpoint < m_endpoints.size()) {
+            m_raceTimer.cancel();
+            startNextEndpoint();
+        } else
+            handleError(error);
+    }
 }
 
 void Connection::write(uint8_t* buffer, size_t size)
@@ -126,23 +263,29 @@ void Connection::write(uint8_t* buffer, size_t size)
         return;
 
     // we can't send the data right away, otherwise we could create tcp congestion
-    if (!m_outputStream) {
-        if (!m_outputStreams.empty()) {
-            m_outputStream = m_outputStreams.front();
-            m_outputStreams.pop_front();
-        } else
-            m_outputStream = std::make_shared<asio::streambuf>();
-
-        m_delayedWriteTimer.cancel();
-        m_delayedWriteTimer.expires_from_now(asio::chrono::milliseconds(0));
-        m_delayedWriteTimer.async_wait([capture0 = asConnection()](auto&& PH1) {
-            capture0->onCanWrite(std::forward<decltype(PH1)>(PH1));
-        });
+    if (!m_outputBuffer) {
+        if (!m_outputBuffers.empty()) {
+            m_outputBuffer = m_outputBuffers.front();
+            m_outputBuffers.pop_front();
+        } else {
+            m_outputBuffer = std::make_shared<std::vector<uint8_t>>();
+            m_outputBuffer->reserve(SEND_BUFFER_SIZE);
+        }
+
+        if (m_corked) {
+            // flushed once at the end of the current poll cycle; a zero
+            // delay timer would fire mid-cycle and split the burst
+            m_corkedConnections.emplace_back(asConnection());
+        } else {
+            m_delayedWriteTimer.cancel();
+            m_delayedWriteTimer.expires_from_now(asio::chrono::milliseconds(0));
+            m_delayedWriteTimer.async_wait([capture0 = asConnection()](auto&& PH1) {
+                capture0->onCanWrite(std::forward<decltype(PH1)>(PH1));
+            });
+        }
     }
 
-    std::ostream os(m_outputStream.get());
-    os.write((const char*)buffer, size);
-    os.flush();
+    m_outputBuffer->insert(m_outputBuffer->end(), buffer, buffer + size);
 }
 
 void Connection::internal_write()
@@ -150,13 +293,16 @@ void Connection::internal_write()
     if (!m_connected)
         return;
 
-    std::shared_ptr<asio::streambuf> outputStream = m_outputStream;
-    m_outputStream = nullptr;
+    OutputBufferPtr outputBuffer = m_outputBuffer;
+    m_outputBuffer = nullptr;
+
+    m_sentBytes += outputBuffer->size();
+    ++m_sentFlushes;
 
     async_write(m_socket,
-                *outputStream,
-                [capture0 = asConnection(), outputStream](auto&& PH1, auto&& PH2) {
-        capture0->onWrite(std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2), outputStream);
+                asio::buffer(outputBuffer->data(), outputBuffer->size()),
+                [capture0 = asConnection(), outputBuffer](auto&& PH1, auto&& PH2) {
+        capture0->onWrite(std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2), outputBuffer);
     });
 
     m_writeTimer.cancel();
@@ -172,9 +318,15 @@ void Connection::read(uint16_t bytes, const RecvCallback& callback)
         return;
 
     m_recvCallback = callback;
+    m_untilToken.clear();
+
+    if (bytes > RECV_BUFFER_SIZE - m_inputFill) {
+        handleError(asio::error::no_buffer_space);
+        return;
+    }
 
     async_read(m_socket,
-               m_inputStream.prepare(bytes),
+               asio::buffer(m_inputBuffer.data() + m_inputFill, bytes),
                [capture0 = asConnection()](auto&& PH1, auto&& PH2) {
         capture0->onRecv(std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2));
     });
@@ -192,19 +344,10 @@ void Connection::read_until(const std::string_view what, const RecvCallback& cal
         return;
 
     m_recvCallback = callback;
+    m_untilToken = what;
 
-    async_read_until(m_socket,
-                     m_inputStream,
-                     what,
-                     [capture0 = asConnection()](auto&& PH1, auto&& PH2) {
-        capture0->onRecv(std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2));
-    });
-
-    m_readTimer.cancel();
-    m_readTimer.expires_from_now(asio::chrono::seconds(static_cast<uint32_t>(READ_TIMEOUT)));
-    m_readTimer.async_wait([capture0 = asConnection()](auto&& PH1) {
-        capture0->onTimeout(std::forward<decltype(PH1)>(PH1));
-    });
+    // the token may already be buffered from a previous read
+    onRecv(std::error_code(), 0);
 }
 
 void Connection::read_some(const RecvCallback& callback)
@@ -213,8 +356,14 @@ void Connection::read_some(const RecvCallback& callback)
         return;
 
     m_recvCallback = callback;
+    m_untilToken.clear();
 
-    m_socket.async_read_some(m_inputStream.prepare(RECV_BUFFER_SIZE),
+    internal_read_some();
+}
+
+void Connection::internal_read_some()
+{
+    m_socket.async_read_some(asio::buffer(m_inputBuffer.data() + m_inputFill, RECV_BUFFER_SIZE - m_inputFill),
                              [capture0 = asConnection()](auto&& PH1, auto&& PH2) {
         capture0->onRecv(std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2));
     });
@@ -234,9 +383,11 @@ void Connection::onResolve(const std::error_code& error, const asio::ip::basic_r
     if (error == asio::error::operation_aborted)
         return;
 
-    if (!error)
-        internal_connect(endpointIterator);
-    else
+    if (!error) {
+        m_endpoints = interleaveEndpoints(endpointIterator);
+        m_dnsCache[m_dnsCacheKey] = { m_endpoints, stdext::millis() };
+        startNextEndpoint();
+    } else
         handleError(error);
 }
 
@@ -274,17 +425,17 @@ void Connection::onCanWrite(const std::error_code& error)
         internal_write();
 }
 
-void Connection::onWrite(const std::error_code& error, size_t, const std::shared_ptr<asio::streambuf>&
-                         outputStream)
+void Connection::onWrite(const std::error_code& error, size_t, const OutputBufferPtr& outputBuffer)
 {
     m_writeTimer.cancel();
 
     if (error == asio::error::operation_aborted)
         return;
 
-    // free output stream and store for using it again later
-    outputStream->consume(outputStream->size());
-    m_outputStreams.emplace_back(outputStream);
+    // clearing keeps the capacity, so the pooled buffer is reused without
+    // allocating again
+    outputBuffer->clear();
+    m_outputBuffers.emplace_back(outputBuffer);
 
     if (m_connected && error)
         handleError(error);
@@ -298,18 +449,42 @@ void Connection::onRecv(const std::error_code& error, size_t recvSize)
     if (error == asio::error::operation_aborted)
         return;
 
+    if (!error) {
+        m_inputFill += recvSize;
+        m_receivedBytes += recvSize;
+    }
+
+    size_t deliverSize = recvSize;
+    if (!error && !m_untilToken.empty()) {
+        const std::string_view buffered(reinterpret_cast<const char*>(m_inputBuffer.data()), m_inputFill);
+        const auto pos = buffered.find(m_untilToken);
+        if (pos == std::string::npos) {
+            // keep reading until the token arrives or the buffer fills up
+            if (m_inputFill < RECV_BUFFER_SIZE) {
+                internal_read_some();
+                return;
+            }
+            handleError(asio::error::no_buffer_space);
+            return;
+        }
+        deliverSize = pos + m_untilToken.size();
+        m_untilToken.clear();
+    }
+
     if (m_connected) {
         if (!error) {
-            if (m_recvCallback) {
-                const auto* header = asio::buffer_cast<const char*>(m_inputStream.data());
-                m_recvCallback((uint8_t*)header, recvSize);
-            }
+            if (m_recvCallback)
+                m_recvCallback(m_inputBuffer.data(), deliverSize);
         } else
             handleError(error);
     }
 
-    if (!error)
-        m_inputStream.consume(recvSize);
+    if (!error) {
+        // drop the delivered front bytes, keeping whatever was read past them
+        m_inputFill -= deliverSize;
+        if (m_inputFill > 0)
+            memmove(m_inputBuffer.data(), m_inputBuffer.data() + deliverSize, m_inputFill);
+    }
 }
 
 void Connection::onTimeout(const std::error_code& error)
@@ -317,6 +492,7 @@ void Connection::onTimeout(const std::error_code& error)
     if (error == asio::error::operation_aborted)
         return;
 
+    ++m_timeouts;
     handleError(asio::error::timed_out);
 }
 
@@ -325,6 +501,11 @@ void Connection::handleError(const std::error_code& error)
     if (error == asio::error::operation_aborted)
         return;
 
+    // a failed connect often means the cached address went stale (wifi
+    // roam, server failover), force a fresh resolve on the next attempt
+    if (m_connecting && !m_dnsCacheKey.empty())
+        m_dnsCache.erase(m_dnsCacheKey);
+
     m_error = error;
     if (m_errorCallback)
         m_errorCallback(error);
@@ -22,8 +22,6 @@
 
 #pragma once
 
-#include <asio/streambuf.hpp>
-
 #include <framework/luaengine/luaobject.h>
 #include "declarations.h"
 
@@ -31,13 +29,16 @@ class Connection : public LuaObject
 {
     using ErrorCallback = std::function<void(const std::error_code&)>;
     using RecvCallback = std::function<void(uint8_t*, uint16_t)>;
+    using OutputBufferPtr = std::shared_ptr<std::vector<uint8_t>>;
 
     enum
     {
         READ_TIMEOUT = 30,
         WRITE_TIMEOUT = 30,
         SEND_BUFFER_SIZE = 65536,
-        RECV_BUFFER_SIZE = 65536
+        RECV_BUFFER_SIZE = 65536,
+        DNS_CACHE_TTL = 60000,
+        RACE_STAGGER_DELAY = 250
     };
 
 public:
@@ -47,6 +48,10 @@ public:
     static void poll();
     static void terminate();
 
+    /// Resolves and caches the host ahead of time (e.g. while the enter
+    /// game window is open), so a later connect skips the DNS round trip
+    static void warmup(const std::string_view host, uint16_t port);
+
     void connect(const std::string_view host, uint16_t port, const std::function<void()>& connectCallback);
     void close();
 
@@ -58,6 +63,10 @@ public:
     void setErrorCallback(const ErrorCallback& errorCallback) { m_errorCallback = errorCallback; }
 
     int getIp();
+    uint64_t getSentBytes() const { return m_sentBytes; }
+    uint64_t getReceivedBytes() const { return m_receivedBytes; }
+    uint32_t getSentFlushes() const { return m_sentFlushes; }
+    uint32_t getTimeouts() const { return m_timeouts; }
     std::error_code getError() const { return m_error; }
     bool isConnecting() const { return m_connecting; }
     bool isConnected() const { return m_connected; }
@@ -66,13 +75,17 @@ public:
     ConnectionPtr asConnection() { return static_self_cast<Connection>(); }
 
 protected:
-    void internal_connect(const asio::ip::basic_resolver<asio::ip::tcp>::iterator& endpointIterator);
+    static std::vector<asio::ip::tcp::endpoint> interleaveEndpoints(const asio::ip::tcp::resolver::iterator& endpointIterator);
+
+    void startNextEndpoint();
     void internal_write();
+    void internal_read_some();
     void onResolve(const std::error_code& error, const asio::ip::tcp::resolver::iterator& endpointIterator);
+    void onAttemptConnect(const std::shared_ptr<asio::ip::tcp::socket>& socket, const std::error_code& error);
+    void onRaceStagger(const std::error_code& error);
     void onConnect(const std::error_code& error);
     void onCanWrite(const std::error_code& error);
-    void onWrite(const std::error_code& error, size_t writeSize, const std::shared_ptr<asio::streambuf>&
-                 outputStream);
+    void onWrite(const std::error_code& error, size_t writeSize, const OutputBufferPtr& outputBuffer);
     void onRecv(const std::error_code& error, size_t recvSize);
     void onTimeout(const std::error_code& error);
     void handleError(const std::error_code& error);
@@ -84,12 +97,50 @@ protected:
     asio::basic_waitable_timer<std::chrono::high_resolution_clock> m_readTimer;
     asio::basic_waitable_timer<std::chrono::high_resolution_clock> m_writeTimer;
     asio::basic_waitable_timer<std::chrono::high_resolution_clock> m_delayedWriteTimer;
+    asio::basic_waitable_timer<std::chrono::high_resolution_clock> m_raceTimer;
     asio::ip::tcp::resolver m_resolver;
     asio::ip::tcp::socket m_socket;
 
-    static std::list<std::shared_ptr<asio::streambuf>> m_outputStreams;
-    std::shared_ptr<asio::streambuf> m_outputStream;
-    asio::streambuf m_inputStream;
+    // resolver results interleaved v6/v4 and raced happy-eyeballs style:
+    // each endpoint gets its own socket, started a short stagger apart,
+    // and the first one to connect wins
+    std::vector<asio::ip::tcp::endpoint> m_endpoints;
+    size_t m_nextEndpoint{ 0 };
+    std::vector<std::shared_ptr<asio::ip::tcp::socket>> m_racingSockets;
+
+    // resolved endpoints cached per host:port, so reconnects after a
+    // hiccup skip DNS; entries expire and are dropped on connect failure
+    struct CachedEndpoints
+    {
+        std::vector<asio::ip::tcp::endpoint> endpoints;
+        ticks_t resolvedAt;
+    };
+    static stdext::map<std::string, CachedEndpoints> m_dnsCache;
+    std::string m_dnsCacheKey;
+
+    // write buffers keep their capacity when pooled, so the steady packet
+    // flow of gameplay reuses the same allocations over and over
+    static std::list<OutputBufferPtr> m_outputBuffers;
+    OutputBufferPtr m_outputBuffer;
+
+    // while poll() runs, writes issued by handlers (e.g. protocol code
+    // replying to a received packet) are corked and flushed once per cycle
+    // instead of scheduling one async_write each
+    static bool m_corked;
+    static std::vector<ConnectionPtr> m_corkedConnections;
+
+    // fixed receive buffer; m_inputFill counts the buffered bytes that were
+    // not yet delivered to the recv callback
+    std::array<uint8_t, RECV_BUFFER_SIZE> m_inputBuffer;
+    size_t m_inputFill{ 0 };
+    std::string m_untilToken;
+
+    // traffic counters for diagnostics, exposed to Lua through g_game
+    uint64_t m_sentBytes{ 0 };
+    uint64_t m_receivedBytes{ 0 };
+    uint32_t m_sentFlushes{ 0 };
+    uint32_t m_timeouts{ 0 };
+
     bool m_connected{ false };
     bool m_connecting{ false };
     std::error_code m_error;
@@ -23,6 +23,49 @@
 #include "inputmessage.h"
 #include <framework/util/crypt.h>
 
+namespace
+{
+    // message buffers are 64K each; a small freelist keeps the steady-state
+    // connection from allocating one per packet
+    constexpr size_t POOL_MAXSIZE = 32;
+
+    std::mutex g_poolMutex;
+    std::vector<std::unique_ptr<InputMessage>> g_pool;
+}
+
+InputMessagePtr InputMessage::create()
+{
+    std::unique_ptr<InputMessage> message;
+    {
+        std::scoped_lock lock(g_poolMutex);
+        if (!g_pool.empty()) {
+            message = std::move(g_pool.back());
+            g_pool.pop_back();
+        }
+    }
+
+    if (!message)
+        message = std::make_unique<InputMessage>();
+
+    message->reset();
+    return { message.release(), [](InputMessage* m) { recycle(m); } };
+}
+
+void InputMessage::recycle(InputMessage* message)
+{
+    // drop lua fields as the destructor would, the buffer itself is reused
+    message->releaseLuaFieldsTable();
+
+    {
+        std::scoped_lock lock(g_poolMutex);
+        if (g_pool.size() < POOL_MAXSIZE) {
+            g_pool.emplace_back(message);
+            return;
+        }
+    }
+    delete message;
+}
+
 void InputMessage::reset()
 {
     m_messageSize = 0;
@@ -35,8 +35,12 @@ public:
         MAX_HEADER_SIZE = 8
     };
 
+    // draws from a freelist pool; the message returns to it once released
+    static InputMessagePtr create();
+
     void setBuffer(const std::string_view buffer);
     std::string_view getBuffer() { return std::string_view{ (char*)m_buffer + m_headerPos, m_messageSize }; }
+    std::string_view getUnreadBuffer() { return std::string_view{ (char*)m_buffer + m_readPos, static_cast<size_t>(getUnreadSize()) }; }
 
     void skipBytes(uint16_t bytes) { m_readPos += bytes; }
     void setReadPos(uint16_t readPos) { m_readPos = readPos; }
@@ -92,6 +96,8 @@ protected:
     friend class Protocol;
 
 private:
+    static void recycle(InputMessage* message);
+
     bool canRead(int bytes) const;
     void checkRead(int bytes);
     void checkWrite(int bytes);
@@ -36,6 +36,9 @@ public:
         MAX_HEADER_SIZE = 8
     };
 
+    // draws from a freelist pool; the message returns to it once released
+    static OutputMessagePtr create();
+
     void reset();
 
     void setBuffer(const std::string_view buffer);
@@ -68,6 +71,8 @@ protected:
     friend class Protocol;
 
 private:
+    static void recycle(OutputMessage* message);
+
     bool canWrite(int bytes) const;
     void checkWrite(int bytes);
 
@@ -25,7 +25,15 @@
 #include <framework/core/application.h>
 #include "connection.h"
 
-Protocol::Protocol() :m_inputMessage(std::make_shared<InputMessage>()) {
+#if defined(__x86_64__) || defined(_M_X64) || ((defined(__i386__) || defined(_M_IX86)) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define XTEA_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define XTEA_NEON
+#include <arm_neon.h>
+#endif
+
+Protocol::Protocol() :m_inputMessage(InputMessage::create()) {
     inflateInit2(&m_zstream, -15);
 }
 
@@ -96,6 +104,13 @@ void Protocol::recv()
     });
 }
 
+InputMessagePtr Protocol::detachInputMessage()
+{
+    auto message = m_inputMessage;
+    m_inputMessage = InputMessage::create();
+    return message;
+}
+
 void Protocol::internalRecvHeader(uint8_t* buffer, uint16_t size)
 {
     // read message size
@@ -138,9 +153,11 @@ void Protocol::internalRecvData(uint8_t* buffer, uint16_t size)
     if (decompress) {
         static uint8_t zbuffer[InputMessage::BUFFER_MAXSIZE];
 
+        const uint32_t wireSize = m_inputMessage->getUnreadSize();
+
         m_zstream.next_in = m_inputMessage->getDataBuffer();
         m_zstream.next_out = zbuffer;
-        m_zstream.avail_in = m_inputMessage->getUnreadSize();
+        m_zstream.avail_in = wireSize;
         m_zstream.avail_out = InputMessage::BUFFER_MAXSIZE;
 
         int32_t ret = inflate(&m_zstream, Z_FINISH);
@@ -158,6 +175,10 @@ void Protocol::internalRecvData(uint8_t* buffer, uint16_t size)
 
         m_inputMessage->fillBuffer(zbuffer, totalSize);
         m_inputMessage->setMessageSize(m_inputMessage->getHeaderSize() + totalSize);
+
+        ++m_compressedMessages;
+        m_compressedBytes += wireSize;
+        m_inflatedBytes += totalSize;
     }
 
     onRecv(m_inputMessage);
@@ -174,24 +195,170 @@ namespace
 {
     constexpr uint32_t delta = 0x9E3779B9;
 
-    template<typename Round>
-    void apply_rounds(uint8_t* data, size_t length, Round round)
+    // the round constants depend only on the key, so they are derived once
+    // per message and shared by the vector and scalar paths
+    struct XteaRounds
+    {
+        uint32_t first[32];
+        uint32_t second[32];
+    };
+
+    XteaRounds xteaEncryptRounds(const std::array<uint32_t, 4>& key)
+    {
+        XteaRounds rounds;
+        for (uint32_t i = 0, sum = 0, next_sum = sum + delta; i < 32; ++i, sum = next_sum, next_sum += delta) {
+            rounds.first[i] = sum + key[sum & 3];
+            rounds.second[i] = next_sum + key[(next_sum >> 11) & 3];
+        }
+        return rounds;
+    }
+
+    XteaRounds xteaDecryptRounds(const std::array<uint32_t, 4>& key)
+    {
+        XteaRounds rounds;
+        for (uint32_t i = 0, sum = delta << 5, next_sum = sum - delta; i < 32; ++i, sum = next_sum, next_sum -= delta) {
+            rounds.first[i] = sum + key[(sum >> 11) & 3];
+            rounds.second[i] = next_sum + key[next_sum & 3];
+        }
+        return rounds;
+    }
+
+    void xteaEncryptBlock(uint8_t* data, const XteaRounds& rounds)
+    {
+        uint32_t left = data[0] | data[1] << 8u | data[2] << 16u | data[3] << 24u,
+            right = data[4] | data[5] << 8u | data[6] << 16u | data[7] << 24u;
+
+        for (int i = 0; i < 32; ++i) {
+            left += ((right << 4 ^ right >> 5) + right) ^ rounds.first[i];
+            right += ((left << 4 ^ left >> 5) + left) ^ rounds.second[i];
+        }
+
+        data[0] = static_cast<uint8_t>(left);
+        data[1] = static_cast<uint8_t>(left >> 8u);
+        data[2] = static_cast<uint8_t>(left >> 16u);
+        data[3] = static_cast<uint8_t>(left >> 24u);
+        data[4] = static_cast<uint8_t>(right);
+        data[5] = static_cast<uint8_t>(right >> 8u);
+        data[6] = static_cast<uint8_t>(right >> 16u);
+        data[7] = static_cast<uint8_t>(right >> 24u);
+    }
+
+    void xteaDecryptBlock(uint8_t* data, const XteaRounds& rounds)
     {
-        for (auto j = 0u; j < length; j += 8) {
-            uint32_t left = data[j + 0] | data[j + 1] << 8u | data[j + 2] << 16u | data[j + 3] << 24u,
-                right = data[j + 4] | data[j + 5] << 8u | data[j + 6] << 16u | data[j + 7] << 24u;
-
-            round(left, right);
-
-            data[j] = static_cast<uint8_t>(left);
-            data[j + 1] = static_cast<uint8_t>(left >> 8u);
-            data[j + 2] = static_cast<uint8_t>(left >> 16u);
-            data[j + 3] = static_cast<uint8_t>(left >> 24u);
-            data[j + 4] = static_cast<uint8_t>(right);
-            data[j + 5] = static_cast<uint8_t>(right >> 8u);
-            data[j + 6] = static_cast<uint8_t>(right >> 16u);
-            data[j + 7] = static_cast<uint8_t>(right >> 24u);
+        uint32_t left = data[0] | data[1] << 8u | data[2] << 16u | data[3] << 24u,
+            right = data[4] | data[5] << 8u | data[6] << 16u | data[7] << 24u;
+
+        for (int i = 0; i < 32; ++i) {
+            right -= ((left << 4 ^ left >> 5) + left) ^ rounds.first[i];
+            left -= ((right << 4 ^ right >> 5) + right) ^ rounds.second[i];
         }
+
+        data[0] = static_cast<uint8_t>(left);
+        data[1] = static_cast<uint8_t>(left >> 8u);
+        data[2] = static_cast<uint8_t>(left >> 16u);
+        data[3] = static_cast<uint8_t>(left >> 24u);
+        data[4] = static_cast<uint8_t>(right);
+        data[5] = static_cast<uint8_t>(right >> 8u);
+        data[6] = static_cast<uint8_t>(right >> 16u);
+        data[7] = static_cast<uint8_t>(right >> 24u);
+    }
+
+#ifdef XTEA_SSE2
+    // four independent blocks per iteration: lefts and rights are
+    // de-interleaved into one vector each and kept in registers for all rounds
+    void xteaEncryptBlocks4(uint8_t* data, const XteaRounds& rounds)
+    {
+        const __m128i b0 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i b1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i left = _mm_unpacklo_epi64(b0, b1);
+        __m128i right = _mm_unpackhi_epi64(b0, b1);
+
+        for (int i = 0; i < 32; ++i) {
+            __m128i mix = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(right, 4), _mm_srli_epi32(right, 5)), right);
+            left = _mm_add_epi32(left, _mm_xor_si128(mix, _mm_set1_epi32(rounds.first[i])));
+            mix = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(left, 4), _mm_srli_epi32(left, 5)), left);
+            right = _mm_add_epi32(right, _mm_xor_si128(mix, _mm_set1_epi32(rounds.second[i])));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_unpacklo_epi32(left, right));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), _mm_unpackhi_epi32(left, right));
+    }
+
+    void xteaDecryptBlocks4(uint8_t* data, const XteaRounds& rounds)
+    {
+        const __m128i b0 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i b1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i left = _mm_unpacklo_epi64(b0, b1);
+        __m128i right = _mm_unpackhi_epi64(b0, b1);
+
+        for (int i = 0; i < 32; ++i) {
+            __m128i mix = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(left, 4), _mm_srli_epi32(left, 5)), left);
+            right = _mm_sub_epi32(right, _mm_xor_si128(mix, _mm_set1_epi32(rounds.first[i])));
+            mix = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(right, 4), _mm_srli_epi32(right, 5)), right);
+            left = _mm_sub_epi32(left, _mm_xor_si128(mix, _mm_set1_epi32(rounds.second[i])));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_unpacklo_epi32(left, right));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), _mm_unpackhi_epi32(left, right));
+    }
+#elif defined(XTEA_NEON)
+    void xteaEncryptBlocks4(uint8_t* data, const XteaRounds& rounds)
+    {
+        const uint32x4_t b0 = vreinterpretq_u32_u8(vld1q_u8(data));
+        const uint32x4_t b1 = vreinterpretq_u32_u8(vld1q_u8(data + 16));
+        uint32x4x2_t blocks = vuzpq_u32(b0, b1);
+
+        for (int i = 0; i < 32; ++i) {
+            uint32x4_t mix = vaddq_u32(veorq_u32(vshlq_n_u32(blocks.val[1], 4), vshrq_n_u32(blocks.val[1], 5)), blocks.val[1]);
+            blocks.val[0] = vaddq_u32(blocks.val[0], veorq_u32(mix, vdupq_n_u32(rounds.first[i])));
+            mix = vaddq_u32(veorq_u32(vshlq_n_u32(blocks.val[0], 4), vshrq_n_u32(blocks.val[0], 5)), blocks.val[0]);
+            blocks.val[1] = vaddq_u32(blocks.val[1], veorq_u32(mix, vdupq_n_u32(rounds.second[i])));
+        }
+
+        const uint32x4x2_t out = vzipq_u32(blocks.val[0], blocks.val[1]);
+        vst1q_u8(data, vreinterpretq_u8_u32(out.val[0]));
+        vst1q_u8(data + 16, vreinterpretq_u8_u32(out.val[1]));
+    }
+
+    void xteaDecryptBlocks4(uint8_t* data, const XteaRounds& rounds)
+    {
+        const uint32x4_t b0 = vreinterpretq_u32_u8(vld1q_u8(data));
+        const uint32x4_t b1 = vreinterpretq_u32_u8(vld1q_u8(data + 16));
+        uint32x4x2_t blocks = vuzpq_u32(b0, b1);
+
+        for (int i = 0; i < 32; ++i) {
+            uint32x4_t mix = vaddq_u32(veorq_u32(vshlq_n_u32(blocks.val[0], 4), vshrq_n_u32(blocks.val[0], 5)), blocks.val[0]);
+            blocks.val[1] = vsubq_u32(blocks.val[1], veorq_u32(mix, vdupq_n_u32(rounds.first[i])));
+            mix = vaddq_u32(veorq_u32(vshlq_n_u32(blocks.val[1], 4), vshrq_n_u32(blocks.val[1], 5)), blocks.val[1]);
+            blocks.val[0] = vsubq_u32(blocks.val[0], veorq_u32(mix, vdupq_n_u32(rounds.second[i])));
+        }
+
+        const uint32x4x2_t out = vzipq_u32(blocks.val[0], blocks.val[1]);
+        vst1q_u8(data, vreinterpretq_u8_u32(out.val[0]));
+        vst1q_u8(data + 16, vreinterpretq_u8_u32(out.val[1]));
+    }
+#endif
+
+    void xteaEncryptRange(uint8_t* data, size_t length, const XteaRounds& rounds)
+    {
+        size_t j = 0;
+#if defined(XTEA_SSE2) || defined(XTEA_NEON)
+        for (; j + 32 <= length; j += 32)
+            xteaEncryptBlocks4(data + j, rounds);
+#endif
+        for (; j < length; j += 8)
+            xteaEncryptBlock(data + j, rounds);
+    }
+
+    void xteaDecryptRange(uint8_t* data, size_t length, const XteaRounds& rounds)
+    {
+        size_t j = 0;
+#if defined(XTEA_SSE2) || defined(XTEA_NEON)
+        for (; j + 32 <= length; j += 32)
+            xteaDecryptBlocks4(data + j, rounds);
+#endif
+        for (; j < length; j += 8)
+            xteaDecryptBlock(data + j, rounds);
     }
 }
 
@@ -203,12 +370,7 @@ bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage) const
         return false;
     }
 
-    for (uint32_t i = 0, sum = delta << 5, next_sum = sum - delta; i < 32; ++i, sum = next_sum, next_sum -= delta) {
-        apply_rounds(inputMessage->getReadBuffer(), encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            right -= ((left << 4 ^ left >> 5) + left) ^ (sum + m_xteaKey[(sum >> 11) & 3]);
-            left -= ((right << 4 ^ right >> 5) + right) ^ (next_sum + m_xteaKey[next_sum & 3]);
-        });
-    }
+    xteaDecryptRange(inputMessage->getReadBuffer(), encryptedSize, xteaDecryptRounds(m_xteaKey));
 
     const uint16_t decryptedSize = inputMessage->getU16() + 2;
     const int sizeDelta = decryptedSize - encryptedSize;
@@ -233,12 +395,7 @@ void Protocol::xteaEncrypt(const OutputMessagePtr& outputMessage) const
         encryptedSize += n;
     }
 
-    for (uint32_t i = 0, sum = 0, next_sum = sum + delta; i < 32; ++i, sum = next_sum, next_sum += delta) {
-        apply_rounds(outputMessage->getDataBuffer() - 2, encryptedSize, [&](uint32_t& left, uint32_t& right) {
-            left += ((right << 4 ^ right >> 5) + right) ^ (sum + m_xteaKey[sum & 3]);
-            right += ((left << 4 ^ left >> 5) + left) ^ (next_sum + m_xteaKey[(next_sum >> 11) & 3]);
-        });
-    }
+    xteaEncryptRange(outputMessage->getDataBuffer() - 2, encryptedSize, xteaEncryptRounds(m_xteaKey));
 }
 
 void Protocol::onConnect() { callLuaField("onConnect"); }
@@ -58,6 +58,12 @@ public:
     virtual void send(const OutputMessagePtr& outputMessage);
     virtual void recv();
 
+    // negotiated stream compression diagnostics (sequenced packets carry
+    // deflated payloads); wire vs inflated bytes give the achieved ratio
+    uint32_t getCompressedMessages() const { return m_compressedMessages; }
+    uint64_t getCompressedBytes() const { return m_compressedBytes; }
+    uint64_t getInflatedBytes() const { return m_inflatedBytes; }
+
     ProtocolPtr asProtocol() { return static_self_cast<Protocol>(); }
 
 protected:
@@ -65,6 +71,11 @@ protected:
     virtual void onRecv(const InputMessagePtr& inputMessage);
     virtual void onError(const std::error_code& err);
 
+    // hands the current decoded message to the caller and installs a fresh
+    // pooled one, so the next read can start while the caller still holds
+    // the message for later parsing
+    InputMessagePtr detachInputMessage();
+
     std::array<uint32_t, 4> m_xteaKey{};
     uint32_t m_packetNumber{ 0 };
 
@@ -82,5 +93,9 @@ private:
     ConnectionPtr m_connection;
     InputMessagePtr m_inputMessage;
 
+    uint32_t m_compressedMessages{ 0 };
+    uint64_t m_compressedBytes{ 0 };
+    uint64_t m_inflatedBytes{ 0 };
+
     z_stream m_zstream{};
 };
@@ -20,14 +20,148 @@
  * THE SOFTWARE.
  */
 
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/resourcemanager.h>
 
 #include <utility>
 
+#include <nlohmann/json.hpp>
+
 #include "protocolhttp.h"
 
 Http g_http;
 
+namespace
+{
+    // bodies above this size reach Lua only through the HttpBuffer handle,
+    // the inline string argument comes empty
+    constexpr size_t LUA_INLINE_BODY_LIMIT = 1024 * 1024;
+    // revalidatable bodies and their validators live here in the write dir
+    constexpr std::string_view HTTP_CACHE_DIR = "/http_cache";
+
+    uint32_t crc32Of(const std::string& data)
+    {
+        return crc32(crc32(0L, Z_NULL, 0), (const unsigned char*)data.data(), data.size());
+    }
+
+    bool isJsonContentType(const std::string& contentType)
+    {
+        return contentType.find("application/json") != std::string::npos ||
+               contentType.find("+json") != std::string::npos;
+    }
+
+    // store and leaderboard payloads reach several megabytes; parsing here
+    // on the network thread leaves the main thread only the table build
+    // (see HttpBuffer::getJson)
+    void parseJsonBody(const HttpResult_ptr& result)
+    {
+        if (!result->error.empty() || result->response.empty() || !isJsonContentType(result->contentType))
+            return;
+
+        auto parsed = nlohmann::json::parse(result->response, nullptr, false);
+        if (parsed.is_discarded())
+            result->jsonError = stdext::format("malformed json response from %s", result->url);
+        else
+            result->json = std::make_shared<nlohmann::json>(std::move(parsed));
+    }
+
+    // last negotiated TLS session per host; handing it to SSL_set_session
+    // lets the next connect resume with an abbreviated handshake (session
+    // id or ticket) instead of the full 2-RTT exchange. Only ever touched
+    // from the http thread, so no locking is needed.
+    stdext::map<std::string, std::shared_ptr<SSL_SESSION>> g_tlsSessions;
+
+    void rememberTlsSession(const std::string& host, SSL* ssl)
+    {
+        if (SSL_SESSION* session = SSL_get1_session(ssl))
+            g_tlsSessions[host] = std::shared_ptr<SSL_SESSION>(session, SSL_SESSION_free);
+    }
+
+    void resumeTlsSession(const std::string& host, SSL* ssl)
+    {
+        const auto it = g_tlsSessions.find(host);
+        if (it != g_tlsSessions.end())
+            SSL_set_session(ssl, it->second.get());
+    }
+    // collapses a Transfer-Encoding: chunked body into plain bytes
+    bool dechunkBody(std::string& body)
+    {
+        std::string plain;
+        plain.reserve(body.size());
+        size_t pos = 0;
+        while (pos < body.size()) {
+            const size_t lineEnd = body.find("\r\n", pos);
+            if (lineEnd == std::string::npos)
+                return false;
+            const size_t chunkSize = std::strtoul(body.c_str() + pos, nullptr, 16);
+            if (chunkSize == 0)
+                break;
+            pos = lineEnd + 2;
+            if (pos + chunkSize + 2 > body.size())
+                return false;
+            plain.append(body, pos, chunkSize);
+            pos += chunkSize + 2; // skip the chunk's trailing \r\n
+        }
+        body = std::move(plain);
+        return true;
+    }
+
+    // inflates gzip or zlib encoded bodies in place
+    bool inflateBody(std::string& body)
+    {
+        z_stream zs{};
+        if (inflateInit2(&zs, 15 + 32) != Z_OK) // +32 auto-detects the gzip/zlib wrapper
+            return false;
+
+        std::string plain;
+        plain.resize(std::max<size_t>(body.size() * 4, 16384));
+        zs.next_in = (Bytef*)body.data();
+        zs.avail_in = body.size();
+
+        int ret;
+        size_t written = 0;
+        do {
+            if (written == plain.size())
+                plain.resize(plain.size() * 2);
+            zs.next_out = (Bytef*)plain.data() + written;
+            zs.avail_out = plain.size() - written;
+            ret = inflate(&zs, Z_NO_FLUSH);
+            written = plain.size() - zs.avail_out;
+        } while (ret == Z_OK);
+        inflateEnd(&zs);
+
+        if (ret != Z_STREAM_END)
+            return false;
+
+        plain.resize(written);
+        body = std::move(plain);
+        return true;
+    }
+}
+
+std::string HttpBuffer::slice(size_t offset, size_t length)
+{
+    const auto& body = m_result->response;
+    if (offset >= body.size())
+        return {};
+    return body.substr(offset, length);
+}
+
+uint32_t HttpBuffer::checksum()
+{
+    const auto& body = m_result->response;
+    return crc32(crc32(0L, Z_NULL, 0), (const unsigned char*)body.data(), body.size());
+}
+
+bool HttpBuffer::save(const std::string& path)
+{
+    // the body goes straight from the session buffer to disk, never
+    // materializing on the Lua side
+    const auto& body = m_result->response;
+    return g_resources.writeFileBuffer(path, (const uint8_t*)body.data(), body.size());
+}
+
 void Http::init()
 {
     m_working = true;
@@ -45,6 +179,10 @@ void Http::terminate()
     for (const auto& op : m_operations) {
         if (const auto& session = op.second->session.lock())
             session->close();
+        if (const auto& download = op.second->download.lock())
+            download->close();
+        if (const auto& sync = op.second->sync.lock())
+            sync->close();
     }
     m_guard.reset();
     if (!m_thread.joinable()) {
@@ -54,6 +192,105 @@ void Http::terminate()
     m_thread.join();
 }
 
+Http::CacheEntry Http::loadCacheEntry(const std::string& url) const
+{
+    CacheEntry entry;
+    const auto metaPath = stdext::format("%s/%08x.meta", HTTP_CACHE_DIR, crc32Of(url));
+    if (!g_resources.fileExists(metaPath))
+        return entry;
+
+    try {
+        std::istringstream meta(g_resources.readFileContents(metaPath));
+        std::string cachedUrl, bodyName;
+        std::getline(meta, cachedUrl);
+        std::getline(meta, entry.etag);
+        std::getline(meta, entry.lastModified);
+        std::getline(meta, bodyName);
+
+        // a crc collision between urls would revalidate the wrong body
+        if (cachedUrl != url || bodyName.empty())
+            return entry;
+
+        const auto bodyPath = stdext::format("%s/%s.bin", HTTP_CACHE_DIR, bodyName);
+        if (!g_resources.fileExists(bodyPath))
+            return entry;
+
+        entry.body = g_resources.readFileContents(bodyPath);
+
+        // the body file is named after its own checksum, a mismatch means
+        // a truncated or stale write
+        if (stdext::format("%08x", crc32Of(entry.body)) != bodyName) {
+            entry.body.clear();
+            return entry;
+        }
+
+        entry.valid = !entry.etag.empty() || !entry.lastModified.empty();
+    } catch (const std::exception& e) {
+        g_logger.warning(stdext::format("http cache entry for %s is unreadable: %s", url, e.what()));
+    }
+    return entry;
+}
+
+void Http::storeCacheEntry(const HttpResult_ptr& result) const
+{
+    // without validators the next request would transfer everything anyway
+    if (result->etag.empty() && result->lastModified.empty())
+        return;
+
+    g_resources.makeDir(std::string(HTTP_CACHE_DIR));
+
+    // bodies are content-addressed: identical payloads behind different
+    // urls share one file on disk
+    const uint32_t bodyCrc = crc32Of(result->response);
+    const auto bodyPath = stdext::format("%s/%08x.bin", HTTP_CACHE_DIR, bodyCrc);
+    if (!g_resources.fileExists(bodyPath) &&
+        !g_resources.writeFileBuffer(bodyPath, (const uint8_t*)result->response.data(), result->response.size()))
+        return;
+
+    const auto meta = stdext::format("%s\n%s\n%s\n%08x", result->url, result->etag, result->lastModified, bodyCrc);
+    g_resources.writeFileContents(stdext::format("%s/%08x.meta", HTTP_CACHE_DIR, crc32Of(result->url)), meta);
+}
+
+void Http::clearCache()
+{
+    for (const auto& file : g_resources.listDirectoryFiles(std::string(HTTP_CACHE_DIR), true, false, false))
+        g_resources.deleteFile(file);
+}
+
+void Http::prewarm(const std::string& url)
+{
+    asio::post(m_ios, [this, url] {
+        const auto uri = parseURI(url);
+        asio::ip::tcp::resolver resolver(m_ios);
+        const asio::ip::tcp::resolver::query query_resolver(uri.domain, uri.port);
+
+        std::error_code ec;
+        const auto endpoints = resolver.resolve(query_resolver, ec);
+        if (ec)
+            return;
+
+        if (uri.port == "443") {
+            asio::ssl::context context(asio::ssl::context::tlsv12_client);
+            asio::ssl::stream<asio::ip::tcp::socket> ssl(m_ios, context);
+            asio::connect(ssl.lowest_layer(), endpoints, ec);
+            if (ec)
+                return;
+            SSL_set_tlsext_host_name(ssl.native_handle(), uri.domain.c_str());
+            ssl.handshake(asio::ssl::stream_base::client, ec);
+            // the throwaway handshake leaves a resumable session behind
+            // for the first real request against this host
+            if (!ec)
+                rememberTlsSession(uri.domain, ssl.native_handle());
+            ssl.lowest_layer().close(ec);
+        } else {
+            // plain http: connecting is enough to warm DNS and the route
+            asio::ip::tcp::socket socket(m_ios);
+            asio::connect(socket, endpoints, ec);
+            socket.close(ec);
+        }
+    });
+}
+
 int Http::get(const std::string& url, int timeout)
 {
     if (!timeout) // lua is not working with default values
@@ -65,15 +302,40 @@ int Http::get(const std::string& url, int timeout)
         result->url = url;
         result->operationId = operationId;
         m_operations[operationId] = result;
-        const auto& session = std::make_shared<HttpSession>(m_ios, url, m_userAgent, m_enable_time_out_on_read_write, m_custom_header, timeout,
-                                                     false, result, [&](HttpResult_ptr result) {
+
+        auto header = m_custom_header;
+        auto cached = std::make_shared<CacheEntry>();
+        if (m_cachePolicy == CachePolicy::REVALIDATE) {
+            *cached = loadCacheEntry(url);
+            if (cached->valid) {
+                if (!cached->etag.empty())
+                    header["If-None-Match: "] = cached->etag;
+                if (!cached->lastModified.empty())
+                    header["If-Modified-Since: "] = cached->lastModified;
+            }
+        }
+
+        const auto& session = std::make_shared<HttpSession>(m_ios, url, m_userAgent, m_enable_time_out_on_read_write, header, timeout,
+                                                     false, result, [&, cached](HttpResult_ptr result) {
             bool finished = result->finished;
+            if (finished && result->error.empty()) {
+                if (result->status == 304 && cached->valid) // unchanged on the server, serve the local copy
+                    result->response = cached->body;
+                else if (m_cachePolicy == CachePolicy::REVALIDATE && result->status == 200)
+                    storeCacheEntry(result);
+            }
+            if (finished)
+                parseJsonBody(result);
             g_dispatcher.addEvent([result, finished] {
                 if (!finished) {
                     g_lua.callGlobalField("g_http", "onGetProgress", result->operationId, result->url, result->progress);
                     return;
                 }
-                g_lua.callGlobalField("g_http", "onGet", result->operationId, result->url, result->error, result->response);
+                const auto& buffer = std::make_shared<HttpBuffer>(result);
+                if (result->response.size() > LUA_INLINE_BODY_LIMIT)
+                    g_lua.callGlobalField("g_http", "onGet", result->operationId, result->url, result->error, std::string(), buffer);
+                else
+                    g_lua.callGlobalField("g_http", "onGet", result->operationId, result->url, result->error, result->response, buffer);
             });
             if (finished) {
                 m_operations.erase(operationId);
@@ -105,12 +367,18 @@ int Http::post(const std::string& url, const std::string& data, int timeout, boo
         const auto& session = std::make_shared<HttpSession>(m_ios, url, m_userAgent, m_enable_time_out_on_read_write, m_custom_header, timeout,
                                                      isJson, result, [&](HttpResult_ptr result) {
             bool finished = result->finished;
+            if (finished)
+                parseJsonBody(result);
             g_dispatcher.addEvent([result, finished] {
                 if (!finished) {
                     g_lua.callGlobalField("g_http", "onPostProgress", result->operationId, result->url, result->progress);
                     return;
                 }
-                g_lua.callGlobalField("g_http", "onPost", result->operationId, result->url, result->error, result->response);
+                const auto& buffer = std::make_shared<HttpBuffer>(result);
+                if (result->response.size() > LUA_INLINE_BODY_LIMIT)
+                    g_lua.callGlobalField("g_http", "onPost", result->operationId, result->url, result->error, std::string(), buffer);
+                else
+                    g_lua.callGlobalField("g_http", "onPost", result->operationId, result->url, result->error, result->response, buffer);
             });
             if (finished) {
                 m_operations.erase(operationId);
@@ -133,8 +401,13 @@ int Http::download(const std::string& url, const std::string& path, int timeout)
         result->url = url;
         result->operationId = operationId;
         m_operations[operationId] = result;
-        const auto& session = std::make_shared<HttpSession>(m_ios, url, m_userAgent, m_enable_time_out_on_read_write, m_custom_header, timeout,
-                                                     false, result, [&, path](HttpResult_ptr result) {
+
+        auto cached = std::make_shared<CacheEntry>();
+        if (m_cachePolicy == CachePolicy::REVALIDATE)
+            *cached = loadCacheEntry(url);
+
+        const auto& download = std::make_shared<HttpChunkedDownload>(m_ios, url, m_userAgent, m_enable_time_out_on_read_write, m_custom_header, timeout,
+                                                     result, [&, path, cached](HttpResult_ptr result) {
             if (!result->finished) {
                 g_dispatcher.addEvent([result] {
                     g_lua.callGlobalField("g_http", "onDownloadProgress", result->operationId, result->url, result->progress, result->speed);
@@ -142,6 +415,13 @@ int Http::download(const std::string& url, const std::string& path, int timeout)
                 return;
             }
 
+            if (result->error.empty()) {
+                if (result->status == 304 && cached->valid) // revalidated, the body comes from disk
+                    result->response = cached->body;
+                else if (m_cachePolicy == CachePolicy::REVALIDATE)
+                    storeCacheEntry(result);
+            }
+
             const uint32_t  crc = crc32(0L, Z_NULL, 0);
             uint32_t checksum = crc32(crc, (const unsigned char*)result->response.c_str(), result->response.size());
 
@@ -152,13 +432,61 @@ int Http::download(const std::string& url, const std::string& path, int timeout)
                     else
                         m_downloads[path] = result;
                 }
-                g_lua.callGlobalField("g_http", "onDownload", result->operationId, result->url, result->error, path, checksum);
+                g_lua.callGlobalField("g_http", "onDownload", result->operationId, result->url, result->error, path, checksum, std::make_shared<HttpBuffer>(result));
             });
 
             m_operations.erase(operationId);
         });
-        result->session = session;
-        session->start();
+        result->download = download;
+        if (cached->valid)
+            download->setCacheValidators(cached->etag, cached->lastModified);
+        download->start();
+    });
+
+    return operationId;
+}
+
+int Http::sync(const std::string& manifestUrl, const stdext::map<std::string, std::string>& localChecksums, int timeout)
+{
+    if (!timeout) // lua is not working with default values
+        timeout = 5;
+
+    int operationId = m_operationId++;
+    asio::post(m_ios, [&, manifestUrl, localChecksums, timeout, operationId] {
+        auto result = std::make_shared<HttpResult>();
+        result->url = manifestUrl;
+        result->operationId = operationId;
+        m_operations[operationId] = result;
+        const auto& sync = std::make_shared<HttpManifestSync>(m_ios, manifestUrl, m_userAgent, m_enable_time_out_on_read_write, m_custom_header, timeout,
+                                                              localChecksums, result, [&, operationId](HttpResult_ptr result) {
+            if (!result->finished) {
+                g_dispatcher.addEvent([result] {
+                    g_lua.callGlobalField("g_http", "onSyncProgress", result->operationId, result->url, result->progress, result->speed);
+                });
+                return;
+            }
+
+            // verified bodies land in the downloads map, so the existing
+            // file write-out path works unchanged
+            std::vector<std::string> updatedFiles;
+            stdext::map<std::string, HttpResult_ptr> files;
+            if (const auto& sync = result->sync.lock()) {
+                updatedFiles = sync->updatedFiles();
+                files = sync->files();
+            }
+
+            g_dispatcher.addEvent([this, result, updatedFiles, files] {
+                if (result->error.empty()) {
+                    for (const auto& [path, fileResult] : files)
+                        m_downloads[path] = fileResult;
+                }
+                g_lua.callGlobalField("g_http", "onSync", result->operationId, result->url, result->error, updatedFiles);
+            });
+
+            m_operations.erase(operationId);
+        });
+        result->sync = sync;
+        sync->start();
     });
 
     return operationId;
@@ -231,6 +559,10 @@ bool Http::cancel(int id)
         const auto& session = it->second->session.lock();
         if (session)
             session->close();
+        if (const auto& download = it->second->download.lock())
+            download->close();
+        if (const auto& sync = it->second->sync.lock())
+            sync->close();
     });
     return true;
 }
@@ -245,6 +577,10 @@ void HttpSession::start()
         m_request.append("Host: " + instance_uri.domain + "\r\n");
         m_request.append("User-Agent: " + m_agent + "\r\n");
         m_request.append("Accept: */*\r\n");
+        if (m_rangeSize > 0)
+            m_request.append("Range: bytes=" + std::to_string(m_rangeStart) + "-" + std::to_string(m_rangeStart + m_rangeSize - 1) + "\r\n");
+        else // ranged chunks must stay identity encoded to be reassembled
+            m_request.append("Accept-Encoding: gzip, deflate\r\n");
         for (const auto& ch : m_custom_header) {
             m_request.append(ch.first + ch.second + "\r\n");
         }
@@ -254,6 +590,7 @@ void HttpSession::start()
         m_request.append("Host: " + instance_uri.domain + "\r\n");
         m_request.append("User-Agent: " + m_agent + "\r\n");
         m_request.append("Accept: */*\r\n");
+        m_request.append("Accept-Encoding: gzip, deflate\r\n");
         for (const auto& ch : m_custom_header) {
             m_request.append(ch.first + ch.second + "\r\n");
         }
@@ -331,12 +668,15 @@ void HttpSession::on_connect(const std::error_code& ec)
             return;
         }
 
+        resumeTlsSession(instance_uri.domain, m_ssl.native_handle());
+
         m_ssl.async_handshake(asio::ssl::stream_base::client,
                               [sft = shared_from_this()](const std::error_code& ec) {
             if (ec) {
                 sft->onError("HttpSession unable to handshake " + sft->m_url + ": " + ec.message());
                 return;
             }
+            rememberTlsSession(sft->instance_uri.domain, sft->m_ssl.native_handle());
             sft->on_write();
         });
     } else {
@@ -383,13 +723,7 @@ void HttpSession::on_request_sent(const std::error_code& ec, size_t /*bytes_tran
                 asio::buffers_begin(m_response.data()) + size);
             m_response.consume(size);
 
-            const size_t pos = header.find("Content-Length: ");
-            if (pos != std::string::npos) {
-                const size_t len = std::strtoul(
-                    header.c_str() + pos + sizeof("Content-Length: ") - 1,
-                    nullptr, 10);
-                m_result->size = len - m_response.size();
-            }
+            parseResponseHeader(header);
 
             asio::async_read(m_ssl, m_response,
                              asio::transfer_at_least(1),
@@ -411,13 +745,7 @@ void HttpSession::on_request_sent(const std::error_code& ec, size_t /*bytes_tran
                 asio::buffers_begin(m_response.data()) + size);
             m_response.consume(size);
 
-            const size_t pos = header.find("Content-Length: ");
-            if (pos != std::string::npos) {
-                const size_t len = std::strtoul(
-                    header.c_str() + pos + sizeof("Content-Length: ") - 1,
-                    nullptr, 10);
-                m_result->size = len - m_response.size();
-            }
+            parseResponseHeader(header);
 
             asio::async_read(m_socket, m_response,
                              asio::transfer_at_least(1),
@@ -433,12 +761,68 @@ void HttpSession::on_request_sent(const std::error_code& ec, size_t /*bytes_tran
     m_timer.async_wait([sft = shared_from_this()](const std::error_code& ec) {sft->onTimeout(ec); });
 }
 
+void HttpSession::parseResponseHeader(const std::string& header)
+{
+    if (const size_t statusPos = header.find(' '); statusPos != std::string::npos)
+        m_result->status = atoi(header.c_str() + statusPos + 1);
+
+    size_t pos = header.find("Content-Length: ");
+    if (pos != std::string::npos) {
+        const size_t len = std::strtoul(
+            header.c_str() + pos + sizeof("Content-Length: ") - 1,
+            nullptr, 10);
+        m_result->size = len - m_response.size();
+    }
+
+    pos = header.find("Content-Range: bytes ");
+    if (pos != std::string::npos) {
+        if (const size_t totalPos = header.find('/', pos); totalPos != std::string::npos)
+            m_result->totalSize = std::strtoull(header.c_str() + totalPos + 1, nullptr, 10);
+    }
+
+    pos = header.find("ETag: ");
+    if (pos != std::string::npos) {
+        const size_t valueStart = pos + sizeof("ETag: ") - 1;
+        m_result->etag = header.substr(valueStart, header.find("\r\n", valueStart) - valueStart);
+    }
+
+    pos = header.find("Last-Modified: ");
+    if (pos != std::string::npos) {
+        const size_t valueStart = pos + sizeof("Last-Modified: ") - 1;
+        m_result->lastModified = header.substr(valueStart, header.find("\r\n", valueStart) - valueStart);
+    }
+
+    pos = header.find("Content-Type: ");
+    if (pos != std::string::npos) {
+        const size_t valueStart = pos + sizeof("Content-Type: ") - 1;
+        m_result->contentType = header.substr(valueStart, header.find("\r\n", valueStart) - valueStart);
+    }
+
+    pos = header.find("Transfer-Encoding: ");
+    if (pos != std::string::npos)
+        m_chunkedBody = header.compare(pos + sizeof("Transfer-Encoding: ") - 1, 7, "chunked") == 0;
+
+    pos = header.find("Content-Encoding: ");
+    if (pos != std::string::npos) {
+        const std::string_view encoding(header.c_str() + pos + sizeof("Content-Encoding: ") - 1);
+        m_compressedBody = encoding.starts_with("gzip") || encoding.starts_with("deflate");
+    }
+}
+
 void HttpSession::on_read(const std::error_code& ec, size_t bytes_transferred)
 {
     auto on_done_read = [&]() {
         m_timer.cancel();
         const auto& data = m_response.data();
         m_result->response.append(asio::buffers_begin(data), asio::buffers_end(data));
+        if (m_chunkedBody && !dechunkBody(m_result->response)) {
+            onError("HttpSession invalid chunked body " + m_url);
+            return;
+        }
+        if (m_compressedBody && !inflateBody(m_result->response)) {
+            onError("HttpSession unable to decompress " + m_url);
+            return;
+        }
         m_result->finished = true;
         m_callback(m_result);
     };
@@ -536,6 +920,300 @@ void HttpSession::onError(const std::string& ec, const std::string& /*details*/)
     m_callback(m_result);
 }
 
+void HttpChunkedDownload::start()
+{
+    m_startMillis = stdext::millis();
+
+    // the probe doubles as the download of the first chunk; its status and
+    // Content-Range tell whether the server honors ranged requests
+    auto probeResult = std::make_shared<HttpResult>();
+    probeResult->url = m_url;
+    probeResult->operationId = m_result->operationId;
+
+    // only the probe is conditional: chunk requests follow a 206 answer,
+    // at which point the resource is known to have changed
+    auto probeHeader = m_custom_header;
+    if (!m_etag.empty())
+        probeHeader["If-None-Match: "] = m_etag;
+    if (!m_lastModified.empty())
+        probeHeader["If-Modified-Since: "] = m_lastModified;
+
+    const auto& session = std::make_shared<HttpSession>(m_service, m_url, m_agent, m_enable_time_out_on_read_write,
+                                                        probeHeader, m_timeout, false, probeResult,
+                                                        [sft = shared_from_this()](const HttpResult_ptr& res) {
+        if (!res->finished) {
+            sft->m_result->progress = res->progress;
+            sft->m_result->speed = res->speed;
+            sft->m_callback(sft->m_result);
+            return;
+        }
+        sft->onProbeDone(res);
+    });
+    session->setRange(0, CHUNK_SIZE);
+    m_sessions.emplace_back(session);
+    session->start();
+}
+
+void HttpChunkedDownload::onProbeDone(const HttpResult_ptr& probeResult)
+{
+    if (m_finished)
+        return;
+
+    if (!probeResult->error.empty()) {
+        finish(probeResult->error);
+        return;
+    }
+
+    m_result->status = probeResult->status;
+    m_result->etag = probeResult->etag;
+    m_result->lastModified = probeResult->lastModified;
+
+    if (probeResult->status == 304) { // not modified, the caller owns a current copy
+        finish("");
+        return;
+    }
+
+    // servers that ignore Range answer 200 with the whole file already in
+    // the probe body; files smaller than one chunk are complete too
+    if (probeResult->status != 206 || probeResult->totalSize <= probeResult->response.size()) {
+        m_result->response = std::move(probeResult->response);
+        finish("");
+        return;
+    }
+
+    m_totalSize = probeResult->totalSize;
+    m_result->size = m_totalSize;
+    m_result->response.resize(m_totalSize);
+    m_doneBytes = probeResult->response.size();
+    m_nextOffset = m_doneBytes;
+    m_result->response.replace(0, m_doneBytes, probeResult->response);
+    startNextChunks();
+}
+
+void HttpChunkedDownload::startNextChunks()
+{
+    while (m_activeChunks < static_cast<int>(MAX_PARALLEL_CHUNKS) && m_nextOffset < m_totalSize && !m_finished) {
+        const size_t offset = m_nextOffset;
+        const size_t size = std::min<size_t>(CHUNK_SIZE, m_totalSize - offset);
+        m_nextOffset += size;
+
+        auto chunkResult = std::make_shared<HttpResult>();
+        chunkResult->url = m_url;
+        chunkResult->operationId = m_result->operationId;
+        const auto& session = std::make_shared<HttpSession>(m_service, m_url, m_agent, m_enable_time_out_on_read_write,
+                                                            m_custom_header, m_timeout, false, chunkResult,
+                                                            [sft = shared_from_this(), offset](const HttpResult_ptr& res) {
+            if (res->finished)
+                sft->onChunkDone(res, offset);
+        });
+        session->setRange(offset, size);
+        ++m_activeChunks;
+        m_sessions.emplace_back(session);
+        session->start();
+    }
+}
+
+void HttpChunkedDownload::onChunkDone(const HttpResult_ptr& chunkResult, size_t offset)
+{
+    if (m_finished)
+        return;
+
+    --m_activeChunks;
+
+    if (!chunkResult->error.empty()) {
+        finish(chunkResult->error);
+        return;
+    }
+
+    // each chunk lands directly in its slice of the final body
+    const size_t size = std::min<size_t>(chunkResult->response.size(), m_totalSize - offset);
+    m_result->response.replace(offset, size, chunkResult->response, 0, size);
+    m_doneBytes += size;
+
+    reportProgress();
+    startNextChunks();
+
+    if (m_activeChunks == 0 && m_nextOffset >= m_totalSize)
+        finish("");
+}
+
+void HttpChunkedDownload::reportProgress()
+{
+    m_result->progress = m_totalSize > 0 ? (m_doneBytes * 100) / m_totalSize : 0;
+    m_result->speed = m_doneBytes / std::max<ticks_t>(1, stdext::millis() - m_startMillis);
+    m_callback(m_result);
+}
+
+void HttpChunkedDownload::finish(const std::string& error)
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    if (!error.empty()) {
+        m_result->error = error;
+        for (const auto& session : m_sessions)
+            session->close();
+    }
+
+    m_sessions.clear();
+    m_result->finished = true;
+    m_callback(m_result);
+}
+
+void HttpManifestSync::start()
+{
+    m_startMillis = stdext::millis();
+
+    auto manifestResult = std::make_shared<HttpResult>();
+    manifestResult->url = m_url;
+    manifestResult->operationId = m_result->operationId;
+    const auto& session = std::make_shared<HttpSession>(m_service, m_url, m_agent, m_enable_time_out_on_read_write,
+                                                        m_custom_header, m_timeout, false, manifestResult,
+                                                        [sft = shared_from_this()](const HttpResult_ptr& res) {
+        if (res->finished)
+            sft->onManifestDone(res);
+    });
+    m_sessions.emplace_back(session);
+    session->start();
+}
+
+void HttpManifestSync::onManifestDone(const HttpResult_ptr& manifestResult)
+{
+    if (m_finished)
+        return;
+
+    if (!manifestResult->error.empty()) {
+        finish(manifestResult->error);
+        return;
+    }
+
+    // one line per file: "<crc32 hex> <path>"; entries whose hash already
+    // matches the local copy never touch the network
+    std::istringstream manifest(manifestResult->response);
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        const size_t sep = line.find(' ');
+        const size_t pathStart = sep == std::string::npos ? std::string::npos : line.find_first_not_of(' ', sep);
+        if (pathStart == std::string::npos) {
+            finish(stdext::format("invalid manifest line '%s' from %s", line, m_url));
+            return;
+        }
+
+        const uint32_t checksum = std::strtoul(line.c_str(), nullptr, 16);
+        std::string path = line.substr(pathStart);
+
+        const auto it = m_localChecksums.find(path);
+        if (it != m_localChecksums.end() && std::strtoul(it->second.c_str(), nullptr, 16) == checksum)
+            continue;
+
+        m_missingEntries.emplace_back(ManifestEntry{ std::move(path), checksum });
+    }
+
+    m_sessions.clear();
+
+    if (m_missingEntries.empty()) {
+        finish("");
+        return;
+    }
+
+    startNextFiles();
+}
+
+void HttpManifestSync::startNextFiles()
+{
+    // files resolve against the manifest's directory
+    const std::string baseUrl = m_url.substr(0, m_url.find_last_of('/') + 1);
+
+    while (m_activeFiles < static_cast<int>(MAX_PARALLEL_FILES) && m_nextEntry < m_missingEntries.size() && !m_finished) {
+        const size_t index = m_nextEntry++;
+
+        auto fileResult = std::make_shared<HttpResult>();
+        fileResult->url = baseUrl + m_missingEntries[index].path;
+        fileResult->operationId = m_result->operationId;
+        const auto& session = std::make_shared<HttpSession>(m_service, fileResult->url, m_agent, m_enable_time_out_on_read_write,
+                                                            m_custom_header, m_timeout, false, fileResult,
+                                                            [sft = shared_from_this(), index](const HttpResult_ptr& res) {
+            if (res->finished)
+                sft->onFileDone(res, index);
+        });
+        ++m_activeFiles;
+        m_sessions.emplace_back(session);
+        session->start();
+    }
+}
+
+void HttpManifestSync::onFileDone(const HttpResult_ptr& fileResult, size_t index)
+{
+    if (m_finished)
+        return;
+
+    if (!fileResult->error.empty()) {
+        finish(fileResult->error);
+        return;
+    }
+
+    // hashing happens on a worker so big files don't stall the transfers,
+    // the verdict is posted back onto the http thread
+    g_asyncDispatcher.dispatch([sft = shared_from_this(), fileResult, index] {
+        const uint32_t crc = crc32(0L, Z_NULL, 0);
+        const uint32_t checksum = crc32(crc, (const unsigned char*)fileResult->response.c_str(), fileResult->response.size());
+        asio::post(sft->m_service, [sft, fileResult, index, checksum] {
+            sft->onFileVerified(fileResult, index, checksum);
+        });
+    });
+}
+
+void HttpManifestSync::onFileVerified(const HttpResult_ptr& fileResult, size_t index, const uint32_t checksum)
+{
+    if (m_finished)
+        return;
+
+    --m_activeFiles;
+
+    const auto& entry = m_missingEntries[index];
+    if (checksum != entry.checksum) {
+        finish(stdext::format("checksum mismatch for %s", entry.path));
+        return;
+    }
+
+    m_doneBytes += fileResult->response.size();
+    ++m_doneFiles;
+    m_files[entry.path] = fileResult;
+    m_updatedFiles.emplace_back(entry.path);
+
+    m_result->progress = (m_doneFiles * 100) / m_missingEntries.size();
+    m_result->speed = m_doneBytes / std::max<ticks_t>(1, stdext::millis() - m_startMillis);
+    m_callback(m_result);
+
+    startNextFiles();
+
+    if (m_activeFiles == 0 && m_nextEntry >= m_missingEntries.size())
+        finish("");
+}
+
+void HttpManifestSync::finish(const std::string& error)
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    if (!error.empty()) {
+        m_result->error = error;
+        for (const auto& session : m_sessions)
+            session->close();
+    }
+
+    m_sessions.clear();
+    m_result->finished = true;
+    m_callback(m_result);
+}
+
 void WebsocketSession::start()
 {
     instance_uri = parseURI(m_url);
@@ -547,6 +1225,7 @@ void WebsocketSession::start()
     m_request.append("Connection: Upgrade\r\n");
     m_request.append("Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n");
     m_request.append("Sec-WebSocket-Version: 13\r\n");
+    m_request.append("Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n");
     m_request.append("\r\n");
 
     m_resolver.async_resolve(
@@ -605,12 +1284,14 @@ void WebsocketSession::on_connect(const std::error_code& ec)
     }
 
     if (instance_uri.port == "443") {
+        resumeTlsSession(instance_uri.domain, m_ssl.native_handle());
         std::error_code _ec;
         m_ssl.handshake(asio::ssl::stream_base::client, _ec);
         if (_ec) {
             onError("WebsocketSession unable to handshake " + m_url + ": " + _ec.message());
             return;
         }
+        rememberTlsSession(instance_uri.domain, m_ssl.native_handle());
         asio::async_write(
             m_ssl, asio::buffer(m_request),
             [sft = shared_from_this()](
@@ -651,6 +1332,8 @@ void WebsocketSession::on_request_sent(const std::error_code& ec, size_t /*bytes
                 asio::buffers_begin(m_response.data()) + size);
             m_response.consume(size);
 
+            parseHandshakeExtensions(header);
+
             //TODO: Local variable 'websocket_accept' is only assigned but never accessed
             /*size_t pos = header.find("Sec-WebSocket-Accept: ");
             std::string websocket_accept;
@@ -678,6 +1361,8 @@ void WebsocketSession::on_request_sent(const std::error_code& ec, size_t /*bytes
                 asio::buffers_begin(m_response.data()) + size);
             m_response.consume(size);
 
+            parseHandshakeExtensions(header);
+
             //TODO: Local variable 'websocket_accept' is only assigned but never accessed
             /*size_t pos = header.find("Sec-WebSocket-Accept: ");
             std::string websocket_accept;
@@ -699,6 +1384,8 @@ void WebsocketSession::on_request_sent(const std::error_code& ec, size_t /*bytes
 
 void WebsocketSession::on_write(const std::error_code& ec, size_t /*bytes_transferred*/)
 {
+    m_writing = false;
+
     if (ec) {
         onError("WebsocketSession unable to on_write " + m_url + ": " + ec.message());
         return;
@@ -711,19 +1398,33 @@ void WebsocketSession::on_write(const std::error_code& ec, size_t /*bytes_transf
         m_timer.cancel();
     }
 
-    if (!m_sendQueue.empty()) {
+    // whatever queued while this write was in flight goes out as one batch
+    if (!m_sendQueue.empty())
+        flushSendQueue();
+}
+
+void WebsocketSession::flushSendQueue()
+{
+    // concatenate every queued frame into one buffer, so a burst of small
+    // messages costs a single write instead of one syscall per frame;
+    // clearing keeps the capacity for the next batch
+    m_writeBuffer.clear();
+    while (!m_sendQueue.empty()) {
+        m_writeBuffer.append(m_sendQueue.front());
         m_sendQueue.pop();
     }
 
+    m_writing = true;
     if (instance_uri.port == "443") {
-        if (!m_sendQueue.empty())
-            asio::async_write(m_ssl, asio::buffer(m_sendQueue.front()), [sft = shared_from_this()](const std::error_code& ec, size_t bytes) {
+        asio::async_write(
+            m_ssl, asio::buffer(m_writeBuffer),
+            [sft = shared_from_this()](
+            const std::error_code& ec, size_t bytes) {
             sft->on_write(ec, bytes);
         });
     } else {
-        if (!m_sendQueue.empty())
-            asio::async_write(
-            m_socket, asio::buffer(m_sendQueue.front()),
+        asio::async_write(
+            m_socket, asio::buffer(m_writeBuffer),
             [sft = shared_from_this()](
             const std::error_code& ec, size_t bytes) {
             sft->on_write(ec, bytes);
@@ -731,6 +1432,75 @@ void WebsocketSession::on_write(const std::error_code& ec, size_t /*bytes_transf
     }
 }
 
+void WebsocketSession::parseHandshakeExtensions(const std::string& header)
+{
+    // the server echoes the extension back only when it accepts the offer
+    const auto pos = header.find("permessage-deflate");
+    if (pos == std::string::npos)
+        return;
+
+    m_deflateStream = {};
+    if (deflateInit2(&m_deflateStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return;
+
+    m_inflateStream = {};
+    if (inflateInit2(&m_inflateStream, -15) != Z_OK) {
+        deflateEnd(&m_deflateStream);
+        return;
+    }
+
+    // the server may forbid us from carrying the window across messages
+    m_deflateNoContextTakeover = header.find("client_no_context_takeover", pos) != std::string::npos;
+    m_deflateEnabled = true;
+}
+
+std::string WebsocketSession::deflatePayload(const std::string& payload)
+{
+    std::string out;
+    char chunk[4096];
+
+    m_deflateStream.next_in = (Bytef*)payload.data();
+    m_deflateStream.avail_in = payload.size();
+    do {
+        m_deflateStream.next_out = (Bytef*)chunk;
+        m_deflateStream.avail_out = sizeof(chunk);
+        deflate(&m_deflateStream, Z_SYNC_FLUSH);
+        out.append(chunk, sizeof(chunk) - m_deflateStream.avail_out);
+    } while (m_deflateStream.avail_out == 0);
+
+    // a sync flush always ends with an empty stored block (00 00 ff ff),
+    // the wire format omits it
+    if (out.size() >= 4)
+        out.resize(out.size() - 4);
+
+    if (m_deflateNoContextTakeover)
+        deflateReset(&m_deflateStream);
+
+    return out;
+}
+
+std::string WebsocketSession::inflatePayload(const std::string& payload)
+{
+    std::string out;
+    char chunk[4096];
+
+    // re-append the stored block stripped by the sender
+    std::string data = payload;
+    data.append("\x00\x00\xff\xff", 4);
+
+    m_inflateStream.next_in = (Bytef*)data.data();
+    m_inflateStream.avail_in = data.size();
+    do {
+        m_inflateStream.next_out = (Bytef*)chunk;
+        m_inflateStream.avail_out = sizeof(chunk);
+        if (inflate(&m_inflateStream, Z_SYNC_FLUSH) != Z_OK)
+            break;
+        out.append(chunk, sizeof(chunk) - m_inflateStream.avail_out);
+    } while (m_inflateStream.avail_out == 0);
+
+    return out;
+}
+
 void WebsocketSession::on_read(const std::error_code& ec, size_t bytes_transferred)
 {
     if (ec && ec != asio::error::eof) {
@@ -748,22 +1518,38 @@ void WebsocketSession::on_read(const std::error_code& ec, size_t bytes_transferr
         const auto& data = m_response.data();
         std::string response = { asio::buffers_begin(data), asio::buffers_end(data) };
         const uint8_t fin_code = response.at(0);
-        // size_t length = (response.at(1) & 127);
-        response.erase(0, 1);
+        const uint8_t opcode = fin_code & 0x0f;
 
         //  close connection
-        if (fin_code == 0x88) {
+        if (opcode == 0x8) {
             close();
             // to ping
-        } else if (fin_code == 0x89) {
-            send("", fin_code + 1);
+        } else if (opcode == 0x9) {
+            send("", 0x8A);
             // to pong
-        } else if (fin_code == 0x8A) {
-            //  fragmented message
-        } else if (fin_code == 0x80) {
-            m_callback(WebsocketCallbackType::MESSAGE, response);
-        } else {
-            m_callback(WebsocketCallbackType::MESSAGE, response);
+        } else if (opcode == 0xA) {
+            //  pong, nothing to deliver
+        } else if (response.size() >= 2) {
+            // strip the frame header so the callback sees only the payload
+            size_t headerSize = 2;
+            size_t length = response.at(1) & 127;
+            if (length == 126 && response.size() >= 4) {
+                length = static_cast<uint8_t>(response.at(2)) << 8 | static_cast<uint8_t>(response.at(3));
+                headerSize = 4;
+            } else if (length == 127 && response.size() >= 10) {
+                length = 0;
+                for (int i = 0; i < 8; ++i)
+                    length = length << 8 | static_cast<uint8_t>(response.at(2 + i));
+                headerSize = 10;
+            }
+
+            std::string payload = response.substr(headerSize, length);
+
+            // RSV1 marks a permessage-deflate compressed payload
+            if (m_deflateEnabled && (fin_code & 0x40))
+                payload = inflatePayload(payload);
+
+            m_callback(WebsocketCallbackType::MESSAGE, payload);
         }
 
         m_response.consume(bytes_transferred);
@@ -815,14 +1601,25 @@ void WebsocketSession::onTimeout(const std::error_code& ec)
 
 void WebsocketSession::send(const std::string& data, uint8_t ws_opcode)
 {
-    std::vector<uint8_t> ws_frame;
     std::array<unsigned char, 4> mask;
     std::uniform_int_distribution<unsigned short> dist(0, 255);
     std::random_device rd;
     for (auto c = 0; c < 4; c++)
         mask[c] = static_cast<unsigned char>(dist(rd));
 
-    const size_t length = data.size();
+    // data frames travel deflated once the extension was negotiated,
+    // control frames (ping/pong/close) always go out as-is
+    const bool compressed = m_deflateEnabled && ws_opcode == 0 && !data.empty();
+    std::string deflated;
+    if (compressed)
+        deflated = deflatePayload(data);
+    const std::string& payload = compressed ? deflated : data;
+
+    const size_t length = payload.size();
+
+    // built in place over a reused buffer, clearing keeps the capacity
+    auto& ws_frame = m_frameBuffer;
+    ws_frame.clear();
 
     if (ws_opcode == 0) {
         /*
@@ -830,8 +1627,10 @@ void WebsocketSession::send(const std::string& data, uint8_t ws_opcode)
             1... .... = Fin: True
             .000 .... = Reserved: 0x0
             .... 0001 = Opcode: Text (1)
+
+            RSV1 (0x40) set on top marks a permessage-deflate payload
         */
-        ws_frame.push_back(0x81);
+        ws_frame.push_back(compressed ? 0xC1 : 0x81);
 
         /*
             0x82 in binary format is 1000 0010
@@ -915,28 +1714,13 @@ void WebsocketSession::send(const std::string& data, uint8_t ws_opcode)
 
     // the payload use a mask with xor
     for (size_t c = 0; c < length; c++)
-        ws_frame.push_back(data.at(c) ^ mask[c % 4]);
+        ws_frame.push_back(payload.at(c) ^ mask[c % 4]);
 
     m_sendQueue.emplace(ws_frame.begin(), ws_frame.end());
 
-    if (m_sendQueue.size() > 1)
-        return;
-
-    if (instance_uri.port == "443") {
-        asio::async_write(
-            m_ssl, asio::buffer(m_sendQueue.front()),
-            [sft = shared_from_this()](
-            const std::error_code& ec, size_t bytes) {
-            sft->on_write(ec, bytes);
-        });
-    } else {
-        asio::async_write(
-            m_socket, asio::buffer(m_sendQueue.front()),
-            [sft = shared_from_this()](
-            const std::error_code& ec, size_t bytes) {
-            sft->on_write(ec, bytes);
-        });
-    }
+    // a write already in flight picks the queue up on completion
+    if (!m_writing)
+        flushSendQueue();
 }
 
 void WebsocketSession::close()
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <framework/global.h>
+#include <framework/luaengine/luaobject.h>
 #include <framework/stdext/uri.h>
 
 #include <queue>
@@ -30,11 +31,15 @@
 #include <asio.hpp>
 #include <asio/ssl.hpp>
 
+#include <nlohmann/json_fwd.hpp>
+
 #include <random>
 #include <zlib.h>
 
  //  result
 class HttpSession;
+class HttpChunkedDownload;
+class HttpManifestSync;
 
 struct HttpResult
 {
@@ -42,6 +47,7 @@ struct HttpResult
     int operationId = 0;
     int status = 0;
     int size = 0;
+    size_t totalSize = 0; // full resource size reported by Content-Range
     int progress = 0; // from 0 to 100
     int speed = 0;
     int redirects = 0; // redirect
@@ -51,12 +57,46 @@ struct HttpResult
     std::string postData;
     std::string response;
     std::string error;
+    std::string etag; // response validators, drive the on-disk cache
+    std::string lastModified;
+    std::string contentType;
+    std::shared_ptr<nlohmann::json> json; // json bodies parsed on the network thread
+    std::string jsonError;
     std::weak_ptr<HttpSession> session;
+    std::weak_ptr<HttpChunkedDownload> download;
+    std::weak_ptr<HttpManifestSync> sync;
 };
 
 using HttpResult_ptr = std::shared_ptr<HttpResult>;
 using HttpResult_cb = std::function<void(HttpResult_ptr)>;
 
+// zero-copy handle over a finished operation's body: Lua gets length,
+// slices, checksum and save-to-file against the buffer the session
+// already owns, instead of the whole body crossing the Lua stack
+// @bindclass
+class HttpBuffer : public LuaObject
+{
+public:
+    HttpBuffer(HttpResult_ptr result) : m_result(std::move(result)) {}
+
+    size_t getLength() { return m_result->response.size(); }
+    std::string getData() { return m_result->response; }
+    std::string slice(size_t offset, size_t length);
+    uint32_t checksum();
+    bool save(const std::string& path);
+
+    // json bodies are parsed on the network thread, the main thread only
+    // builds the lua tables from the ready DOM
+    bool hasJson() { return m_result->json != nullptr; }
+    std::shared_ptr<nlohmann::json> getJson() { return m_result->json; }
+    std::string getJsonError() { return m_result->jsonError; }
+
+private:
+    HttpResult_ptr m_result;
+};
+
+using HttpBufferPtr = std::shared_ptr<HttpBuffer>;
+
 //  session
 
 class HttpSession : public std::enable_shared_from_this<HttpSession>
@@ -87,6 +127,9 @@ public:
     void cancel() const { onError("canceled"); }
     void close();
 
+    // restricts the request to a byte range of the resource
+    void setRange(size_t offset, size_t size) { m_rangeStart = offset; m_rangeSize = size; }
+
 private:
     asio::io_service& m_service;
     std::string m_url;
@@ -111,6 +154,13 @@ private:
     int sum_bytes_speed_response = 0;
     ticks_t m_last_progress_update = stdext::millis();
 
+    size_t m_rangeStart = 0;
+    size_t m_rangeSize = 0; // 0 = whole resource
+    bool m_chunkedBody = false;
+    bool m_compressedBody = false;
+
+    void parseResponseHeader(const std::string& header);
+
     void on_resolve(const std::error_code& ec, asio::ip::tcp::resolver::iterator iterator);
     void on_connect(const std::error_code& ec);
 
@@ -123,6 +173,141 @@ private:
     void onError(const std::string& ec, const std::string& details = "") const;
 };
 
+// fetches one file through several ranged connections writing into a shared
+// body; the first request probes whether the server honors Range, servers
+// without range support just deliver the whole file on that probe stream
+class HttpChunkedDownload : public std::enable_shared_from_this<HttpChunkedDownload>
+{
+public:
+    HttpChunkedDownload(asio::io_service& service, std::string url, std::string agent,
+                        const bool& enable_time_out_on_read_write,
+                        const stdext::map<std::string, std::string>& custom_header,
+                        int timeout, const HttpResult_ptr& result, HttpResult_cb callback) :
+        m_service(service),
+        m_url(std::move(url)),
+        m_agent(std::move(agent)),
+        m_enable_time_out_on_read_write(enable_time_out_on_read_write),
+        m_custom_header(custom_header),
+        m_timeout(timeout),
+        m_result(result),
+        m_callback(std::move(callback))
+    {
+        assert(m_callback != nullptr);
+        assert(m_result != nullptr);
+    };
+
+    void start();
+    void close() { finish("canceled"); }
+
+    // makes the probe request conditional; a 304 answer means the cached
+    // copy is still current and the download finishes without a body
+    void setCacheValidators(const std::string& etag, const std::string& lastModified) { m_etag = etag; m_lastModified = lastModified; }
+
+private:
+    enum : size_t
+    {
+        CHUNK_SIZE = 4 * 1024 * 1024,
+        MAX_PARALLEL_CHUNKS = 4
+    };
+
+    void onProbeDone(const HttpResult_ptr& probeResult);
+    void startNextChunks();
+    void onChunkDone(const HttpResult_ptr& chunkResult, size_t offset);
+    void reportProgress();
+    void finish(const std::string& error);
+
+    asio::io_service& m_service;
+    std::string m_url;
+    std::string m_agent;
+    bool m_enable_time_out_on_read_write;
+    stdext::map<std::string, std::string> m_custom_header;
+    int m_timeout;
+    HttpResult_ptr m_result;
+    HttpResult_cb m_callback;
+
+    size_t m_totalSize = 0;
+    size_t m_nextOffset = 0;
+    size_t m_doneBytes = 0;
+    int m_activeChunks = 0;
+    bool m_finished = false;
+    ticks_t m_startMillis = 0;
+    std::vector<std::shared_ptr<HttpSession>> m_sessions;
+    std::string m_etag;
+    std::string m_lastModified;
+};
+
+// synchronizes a file set against a server manifest: one request fetches
+// "<crc32 hex> <path>" lines, entries whose hash differs from the local one
+// stream over several parallel connections and are hash-verified on worker
+// threads before being published, instead of ping-ponging one file at a time
+class HttpManifestSync : public std::enable_shared_from_this<HttpManifestSync>
+{
+public:
+    HttpManifestSync(asio::io_service& service, std::string manifestUrl, std::string agent,
+                     const bool& enable_time_out_on_read_write,
+                     const stdext::map<std::string, std::string>& custom_header,
+                     int timeout, stdext::map<std::string, std::string> localChecksums,
+                     const HttpResult_ptr& result, HttpResult_cb callback) :
+        m_service(service),
+        m_url(std::move(manifestUrl)),
+        m_agent(std::move(agent)),
+        m_enable_time_out_on_read_write(enable_time_out_on_read_write),
+        m_custom_header(custom_header),
+        m_timeout(timeout),
+        m_localChecksums(std::move(localChecksums)),
+        m_result(result),
+        m_callback(std::move(callback))
+    {
+        assert(m_callback != nullptr);
+        assert(m_result != nullptr);
+    };
+
+    void start();
+    void close() { finish("canceled"); }
+
+    const std::vector<std::string>& updatedFiles() const { return m_updatedFiles; }
+    const stdext::map<std::string, HttpResult_ptr>& files() const { return m_files; }
+
+private:
+    enum : size_t
+    {
+        MAX_PARALLEL_FILES = 4
+    };
+
+    struct ManifestEntry
+    {
+        std::string path;
+        uint32_t checksum;
+    };
+
+    void onManifestDone(const HttpResult_ptr& manifestResult);
+    void startNextFiles();
+    void onFileDone(const HttpResult_ptr& fileResult, size_t index);
+    void onFileVerified(const HttpResult_ptr& fileResult, size_t index, uint32_t checksum);
+    void finish(const std::string& error);
+
+    asio::io_service& m_service;
+    std::string m_url;
+    std::string m_agent;
+    bool m_enable_time_out_on_read_write;
+    stdext::map<std::string, std::string> m_custom_header;
+    int m_timeout;
+    stdext::map<std::string, std::string> m_localChecksums;
+    HttpResult_ptr m_result;
+    HttpResult_cb m_callback;
+
+    std::vector<ManifestEntry> m_missingEntries;
+    size_t m_nextEntry = 0;
+    size_t m_doneFiles = 0;
+    size_t m_doneBytes = 0;
+    int m_activeFiles = 0;
+    bool m_finished = false;
+    ticks_t m_startMillis = 0;
+    std::vector<std::shared_ptr<HttpSession>> m_sessions;
+    std::vector<std::string> m_updatedFiles;
+    stdext::map<std::string, HttpResult_ptr> m_files;
+};
+
 //  web socket
 enum class WebsocketCallbackType { OPEN, MESSAGE, ERROR_, CLOSE };
 using WebsocketSession_cb = std::function<void(WebsocketCallbackType, const std::string& message)>;
@@ -148,6 +333,14 @@ public:
         assert(m_result != nullptr);
     };
 
+    ~WebsocketSession()
+    {
+        if (m_deflateEnabled) {
+            deflateEnd(&m_deflateStream);
+            inflateEnd(&m_inflateStream);
+        }
+    }
+
     void start();
     void send(const std::string& data, uint8_t ws_opcode = 0);
     void close();
@@ -171,9 +364,27 @@ private:
 
     std::queue<std::string> m_sendQueue;
 
+    // frames are built into a reused buffer and flushed as one write per
+    // cycle: whatever queued while a write was in flight leaves together
+    std::vector<uint8_t> m_frameBuffer;
+    std::string m_writeBuffer;
+    bool m_writing{ false };
+
+    // permessage-deflate with context takeover; both streams keep their
+    // window across messages so repeated JSON keys cost almost nothing
+    bool m_deflateEnabled{ false };
+    bool m_deflateNoContextTakeover{ false };
+    z_stream m_deflateStream{};
+    z_stream m_inflateStream{};
+
     std::string m_request;
     asio::streambuf m_response;
 
+    void parseHandshakeExtensions(const std::string& header);
+    std::string deflatePayload(const std::string& payload);
+    std::string inflatePayload(const std::string& payload);
+    void flushSendQueue();
+
     void on_resolve(const std::error_code& ec, asio::ip::tcp::resolver::iterator iterator);
     void on_connect(const std::error_code& ec);
     void on_request_sent(const std::error_code& ec, size_t bytes_transferred);
@@ -194,9 +405,16 @@ public:
     void init();
     void terminate();
 
+    // speculatively connects and TLS-handshakes to the url's host (e.g.
+    // the last-used login endpoint at app start), so the first real
+    // request finds the DNS answer cached and resumes the TLS session
+    // instead of paying the full handshake round trips
+    void prewarm(const std::string& url);
+
     int get(const std::string& url, int timeout = 5);
     int post(const std::string& url, const std::string& data, int timeout = 5, bool isJson = false);
     int download(const std::string& url, const std::string& path, int timeout = 5);
+    int sync(const std::string& manifestUrl, const stdext::map<std::string, std::string>& localChecksums, int timeout = 5);
     int ws(const std::string& url, int timeout = 5);
     bool wsSend(int operationId, const std::string& message);
     bool wsClose(int operationId);
@@ -222,7 +440,28 @@ public:
 
     void setEnableTimeOutOnReadWrite(bool enable_time_out_on_read_write) { m_enable_time_out_on_read_write = enable_time_out_on_read_write; }
 
+    // "revalidate" keeps get/download bodies on disk and refetches them
+    // through conditional requests, so unchanged resources cost a 304
+    // instead of a full transfer; "none" (the default) never touches disk
+    void setCachePolicy(const std::string& policy) { m_cachePolicy = policy == "revalidate" ? CachePolicy::REVALIDATE : CachePolicy::NONE; }
+    std::string getCachePolicy() { return m_cachePolicy == CachePolicy::REVALIDATE ? "revalidate" : "none"; }
+    void clearCache();
+
 private:
+    enum class CachePolicy { NONE, REVALIDATE };
+
+    // one revalidatable resource as stored on disk
+    struct CacheEntry
+    {
+        bool valid = false;
+        std::string etag;
+        std::string lastModified;
+        std::string body;
+    };
+
+    CacheEntry loadCacheEntry(const std::string& url) const;
+    void storeCacheEntry(const HttpResult_ptr& result) const;
+
     bool m_working = false;
     bool m_enable_time_out_on_read_write = false;
     int m_operationId = 1;
@@ -234,6 +473,7 @@ private:
     stdext::map<std::string, HttpResult_ptr> m_downloads;
     std::string m_userAgent = "Mozilla/5.0";
     stdext::map<std::string, std::string> m_custom_header;
+    CachePolicy m_cachePolicy = CachePolicy::NONE;
 };
 
 extern Http g_http;
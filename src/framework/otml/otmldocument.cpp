@@ -33,14 +33,144 @@ OTMLDocumentPtr OTMLDocument::create()
     return doc;
 }
 
+namespace
+{
+    // bump whenever the serialized node layout changes
+    constexpr std::string_view OTMB_MAGIC = "OTMB";
+    constexpr char OTMB_VERSION = 1;
+
+    // lets the parser read straight from a mapped buffer without copying
+    // it into a stringstream first
+    struct MemoryStreamBuffer : std::streambuf
+    {
+        MemoryStreamBuffer(const char* data, const std::size_t size)
+        {
+            auto* begin = const_cast<char*>(data);
+            setg(begin, begin, begin + size);
+        }
+    };
+}
+
 OTMLDocumentPtr OTMLDocument::parse(const std::string& fileName)
 {
-    std::stringstream fin;
     const auto& source = g_resources.resolvePath(fileName);
+
+#if ENABLE_ENCRYPTION != 1
+    // ui layouts, styles and module manifests are parsed on every window
+    // open and every start; keep a compiled binary copy in the write dir,
+    // keyed by the source contents so edits invalidate it naturally
+    if ((source.ends_with(".otui") || source.ends_with(".otmod")) && !g_resources.getWriteDir().empty()) {
+        std::string_view buffer = g_resources.readFileView(source);
+        std::string contents;
+        if (buffer.empty()) {
+            contents = g_resources.readFileContents(source);
+            buffer = contents;
+        }
+
+        const auto& cachePath = stdext::format("/.otmlcache/%x_%x.otmlb",
+                                               stdext::adler32(reinterpret_cast<const uint8_t*>(source.data()), source.size()),
+                                               stdext::adler32(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size()));
+        if (g_resources.fileExists(cachePath)) {
+            if (const auto& doc = loadBinary(cachePath, source))
+                return doc;
+        }
+
+        MemoryStreamBuffer streamBuffer(buffer.data(), buffer.size());
+        std::istream in(&streamBuffer);
+        const auto& doc = parse(in, source);
+
+        std::string binary{ OTMB_MAGIC };
+        binary.push_back(OTMB_VERSION);
+        serializeNode(doc, binary);
+        g_resources.makeDir("/.otmlcache");
+        g_resources.writeFileBuffer(cachePath, reinterpret_cast<const uint8_t*>(binary.data()), binary.size());
+
+        return doc;
+    }
+#endif
+
+    std::stringstream fin;
     g_resources.readFileStream(source, fin);
     return parse(fin, source);
 }
 
+OTMLDocumentPtr OTMLDocument::loadBinary(const std::string& cachePath, const std::string_view source)
+{
+    try {
+        const auto& data = g_resources.readFileContents(cachePath);
+        if (data.size() < OTMB_MAGIC.size() + 1 || !data.starts_with(OTMB_MAGIC) || data[OTMB_MAGIC.size()] != OTMB_VERSION)
+            return nullptr;
+
+        const auto& doc(OTMLDocumentPtr(new OTMLDocument));
+        std::size_t pos = OTMB_MAGIC.size() + 1;
+        if (!deserializeNode(doc, data, pos) || pos != data.size())
+            return nullptr;
+
+        doc->setSource(source);
+        return doc;
+    } catch (const stdext::exception&) {
+        return nullptr;
+    }
+}
+
+void OTMLDocument::serializeNode(const OTMLNodePtr& node, std::string& out)
+{
+    const auto writeString = [&out](const std::string& str) {
+        const uint32_t length = str.size();
+        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.append(str);
+    };
+
+    writeString(node->m_tag);
+    writeString(node->m_value);
+    writeString(node->m_source);
+    out.push_back(static_cast<char>((node->m_unique ? 1 : 0) | (node->m_null ? 2 : 0)));
+
+    const uint32_t count = node->m_children.size();
+    out.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& child : node->m_children)
+        serializeNode(child, out);
+}
+
+bool OTMLDocument::deserializeNode(const OTMLNodePtr& node, const std::string_view in, std::size_t& pos)
+{
+    const auto readString = [&](std::string& str) {
+        uint32_t length;
+        if (pos + sizeof(length) > in.size())
+            return false;
+        memcpy(&length, in.data() + pos, sizeof(length));
+        pos += sizeof(length);
+
+        if (pos + length > in.size())
+            return false;
+        str.assign(in.data() + pos, length);
+        pos += length;
+        return true;
+    };
+
+    if (!readString(node->m_tag) || !readString(node->m_value) || !readString(node->m_source))
+        return false;
+
+    if (pos + 1 + sizeof(uint32_t) > in.size())
+        return false;
+
+    const auto flags = static_cast<uint8_t>(in[pos++]);
+    node->m_unique = (flags & 1) != 0;
+    node->m_null = (flags & 2) != 0;
+
+    uint32_t count;
+    memcpy(&count, in.data() + pos, sizeof(count));
+    pos += sizeof(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto& child = std::make_shared<OTMLNode>();
+        if (!deserializeNode(child, in, pos))
+            return false;
+        node->m_children.emplace_back(child);
+    }
+    return true;
+}
+
 OTMLDocumentPtr OTMLDocument::parse(std::istream& in, const std::string_view source)
 {
     const auto& doc(OTMLDocumentPtr(new OTMLDocument));
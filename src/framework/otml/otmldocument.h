@@ -46,4 +46,8 @@ public:
 
 private:
     OTMLDocument() = default;
+
+    static OTMLDocumentPtr loadBinary(const std::string& cachePath, std::string_view source);
+    static void serializeNode(const OTMLNodePtr& node, std::string& out);
+    static bool deserializeNode(const OTMLNodePtr& node, std::string_view in, std::size_t& pos);
 };
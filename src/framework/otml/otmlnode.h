@@ -91,6 +91,10 @@ public:
     OTMLNodePtr asOTMLNode() { return this->shared_from_this(); }
 
 protected:
+    // the document serializes and rebuilds nodes directly from its binary
+    // cache, bypassing the unique-tag merging in addChild
+    friend class OTMLDocument;
+
     OTMLNodeList m_children;
     std::string m_tag;
     std::string m_value;
@@ -49,9 +49,7 @@ std::string OTMLParser::getNextLine()
 
 int OTMLParser::getLineDepth(const std::string_view line, bool multilining) const
 {
-    auto _line = std::string{ line };
-    stdext::trim(_line); // fix for lines without content.
-    if (_line.empty())
+    if (stdext::trim_view(line).empty()) // fix for lines without content.
         return 0;
 
     // count number of spaces at the line beginning
@@ -86,14 +84,14 @@ void OTMLParser::parseLine(std::string line)
         return;
 
     // remove line sides spaces
-    stdext::trim(line);
+    const auto trimmedLine = stdext::trim_view(line);
 
     // skip empty lines
-    if (line.empty())
+    if (trimmedLine.empty())
         return;
 
     // skip comments
-    if (line.starts_with("//"))
+    if (trimmedLine.starts_with("//"))
         return;
 
     // a depth above, change current parent to the previous added node
@@ -112,32 +110,31 @@ void OTMLParser::parseLine(std::string line)
 
     // alright, new depth is set, the line is not empty and it isn't a comment
     // then it must be a node, so we parse it
-    parseNode(line);
+    parseNode(trimmedLine);
 }
 
 void OTMLParser::parseNode(const std::string_view data)
 {
-    std::string tag;
-    std::string value;
+    std::string_view tagView;
+    std::string_view valueView;
     const std::size_t dotsPos = data.find_first_of(':');
     const int nodeLine = currentLine;
 
     // node that has no tag and may have a value
     if (!data.empty() && data[0] == '-') {
-        value = data.substr(1);
-        stdext::trim(value);
+        valueView = data.substr(1);
         // node that has tag and possible a value
     } else if (dotsPos != std::string::npos) {
-        tag = data.substr(0, dotsPos);
+        tagView = data.substr(0, dotsPos);
         if (data.size() > dotsPos + 1)
-            value = data.substr(dotsPos + 1);
+            valueView = data.substr(dotsPos + 1);
         // node that has only a tag
     } else {
-        tag = data;
+        tagView = data;
     }
 
-    stdext::trim(tag);
-    stdext::trim(value);
+    std::string tag{ stdext::trim_view(tagView) };
+    std::string value{ stdext::trim_view(valueView) };
 
     // process multitine values
     if (value == "|" || value == "|-" || value == "|+") {
@@ -154,8 +151,7 @@ void OTMLParser::parseNode(const std::string_view data)
                 // it has contents below the current depth
             } else {
                 // if not empty, its a node
-                stdext::trim(line);
-                if (!line.empty()) {
+                if (!stdext::trim_view(line).empty()) {
                     // rewind and break
                     in.seekg(lastPos, std::ios::beg);
                     --currentLine;
@@ -195,12 +191,11 @@ void OTMLParser::parseNode(const std::string_view data)
         node->setNull(true);
     else {
         if (value.starts_with("[") && value.ends_with("]")) {
-            const auto& tmp = value.substr(1, value.length() - 2);
-            const std::vector tokens = stdext::split(tmp, ",");
-            for (std::string v : tokens) {
-                stdext::trim(v);
-                node->writeIn(v);
-            }
+            const std::string_view tmp{ value.data() + 1, value.length() - 2 };
+            stdext::split_string_views tokens;
+            stdext::split_view(tmp, tokens, ",");
+            for (const auto& token : tokens)
+                node->writeIn(std::string{ stdext::trim_view(token) });
         } else
             node->setValue(value);
     }
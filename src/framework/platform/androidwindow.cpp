@@ -27,8 +27,28 @@
 #include <game-activity/native_app_glue/android_native_app_glue.h>
 #include <framework/core/eventdispatcher.h>
 
+#include <cstring>
+#include <ctime>
+
 AndroidWindow& g_androidWindow = (AndroidWindow&) g_window;
 
+namespace {
+    // sanity bounds when measuring the display refresh period from
+    // choreographer timestamps; real panels run between 30Hz and 120Hz
+    constexpr int64_t MIN_VSYNC_INTERVAL = 8000000;
+    constexpr int64_t MAX_VSYNC_INTERVAL = 34000000;
+    // sustained overruns (usually thermal throttling) before dropping to
+    // half-rate pacing, and sustained headroom before going back up
+    constexpr int SLOW_FRAMES_TO_HALVE = 8;
+    constexpr int FAST_FRAMES_TO_RESTORE = 120;
+
+    int64_t monotonicNanos() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+}
+
 AndroidWindow::AndroidWindow() {
     m_minimumSize = Size(600, 480);
     m_size = Size(600, 480);
@@ -188,6 +208,7 @@ void AndroidWindow::terminate() {
 }
 
 void AndroidWindow::poll() {
+    waitFrame();
     handleNativeEvents();
 
     while( !m_events.empty() ) {
@@ -280,8 +301,113 @@ void AndroidWindow::processFingerMotion() {
         m_onInputEvent(m_inputEvent);
 }
 
+void AndroidWindow::internalInitFramePacing() {
+#if __ANDROID_API__ >= 24
+    const char* extensions = eglQueryString(m_eglDisplay, EGL_EXTENSIONS);
+    if (extensions && strstr(extensions, "EGL_ANDROID_presentation_time"))
+        m_eglPresentationTime = (PFNEGLPRESENTATIONTIMEANDROIDPROC)
+            eglGetProcAddress("eglPresentationTimeANDROID");
+
+    if (m_choreographer == nullptr) {
+        m_choreographer = AChoreographer_getInstance();
+        if (m_choreographer == nullptr) {
+            g_logger.warning("Choreographer unavailable, falling back to free-running swaps");
+            return;
+        }
+    }
+
+    if (!m_frameCallbackPosted) {
+        m_frameCallbackPosted = true;
+        scheduleNextFrame();
+    }
+#endif
+}
+
+void AndroidWindow::scheduleNextFrame() {
+#if __ANDROID_API__ >= 29
+    AChoreographer_postFrameCallback64(m_choreographer, [](int64_t frameTimeNanos, void* data) {
+        ((AndroidWindow*) data)->onVsync(frameTimeNanos);
+    }, this);
+#elif __ANDROID_API__ >= 24
+    AChoreographer_postFrameCallback(m_choreographer, [](long frameTimeNanos, void* data) {
+        ((AndroidWindow*) data)->onVsync(frameTimeNanos);
+    }, this);
+#endif
+}
+
+void AndroidWindow::onVsync(int64_t frameTimeNanos) {
+    if (m_vsyncTime > 0) {
+        const int64_t interval = frameTimeNanos - m_vsyncTime;
+        // ignore wild deltas after pauses and refresh rate switches
+        if (interval > MIN_VSYNC_INTERVAL && interval < MAX_VSYNC_INTERVAL)
+            m_vsyncInterval = interval;
+    }
+    m_vsyncTime = frameTimeNanos;
+    ++m_pendingVsyncs;
+
+    // while hidden the callback chain is dropped and restarted by the
+    // next APP_CMD_INIT_WINDOW
+    if (m_visible)
+        scheduleNextFrame();
+    else
+        m_frameCallbackPosted = false;
+}
+
+void AndroidWindow::waitFrame() {
+    if (!m_frameCallbackPosted || !m_visible)
+        return;
+
+    // block on the looper until the choreographer delivers enough vsyncs
+    // for the current pacing divisor; input sources are processed meanwhile
+    while (m_pendingVsyncs < m_swapDivisor) {
+        int events;
+        struct android_poll_source* source;
+        if (ALooper_pollAll(-1, NULL, &events, (void **) &source) >= 0) {
+            if (source != NULL)
+                source->process(m_app, source);
+            if (m_app->destroyRequested)
+                return;
+        }
+    }
+    m_pendingVsyncs = 0;
+    m_frameStartTime = monotonicNanos();
+}
+
+void AndroidWindow::updatePacing(int64_t renderTimeNanos) {
+    if (m_swapDivisor == 1) {
+        if (renderTimeNanos > m_vsyncInterval) {
+            if (++m_slowFrames >= SLOW_FRAMES_TO_HALVE) {
+                // a stable half-rate cadence looks better than juddering
+                // between hitting and missing the full-rate deadline
+                m_swapDivisor = 2;
+                m_slowFrames = 0;
+                m_fastFrames = 0;
+            }
+        } else {
+            m_slowFrames = 0;
+        }
+    } else if (renderTimeNanos < m_vsyncInterval / 2) {
+        if (++m_fastFrames >= FAST_FRAMES_TO_RESTORE) {
+            m_swapDivisor = 1;
+            m_fastFrames = 0;
+        }
+    } else {
+        m_fastFrames = 0;
+    }
+}
+
 void AndroidWindow::swapBuffers() {
+    if (m_frameCallbackPosted && m_eglPresentationTime) {
+        // aim at the vsync matching our pacing so the compositor latches a
+        // steady cadence instead of whichever deadline we happen to hit
+        m_eglPresentationTime(m_eglDisplay, m_eglSurface,
+                              m_vsyncTime + m_swapDivisor * m_vsyncInterval);
+    }
+
     eglSwapBuffers(m_eglDisplay, m_eglSurface);
+
+    if (m_frameCallbackPosted && m_frameStartTime > 0)
+        updatePacing(monotonicNanos() - m_frameStartTime);
 }
 
 void AndroidWindow::setVerticalSync(bool enable) {
@@ -407,6 +533,7 @@ void AndroidWindow::handleCmd(int32_t cmd) {
                     internalInitGL();
                 }
                 m_visible = true;
+                internalInitFramePacing();
             } else {
                 m_visible = false;
             }
@@ -29,9 +29,14 @@
 #include <android/native_window_jni.h>
 #include <jni.h>
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 #include <queue>
 #include <game-activity/native_app_glue/android_native_app_glue.h>
 
+#if __ANDROID_API__ >= 24
+#include <android/choreographer.h>
+#endif
+
 class AndroidWindow : public PlatformWindow
 {
     enum KeyCode {
@@ -97,6 +102,12 @@ class AndroidWindow : public PlatformWindow
 
     void handleNativeEvents();
     void handleCmd(int32_t cmd);
+
+    void internalInitFramePacing();
+    void scheduleNextFrame();
+    void onVsync(int64_t frameTimeNanos);
+    void waitFrame();
+    void updatePacing(int64_t renderTimeNanos);
 public:
     AndroidWindow();
     ~AndroidWindow();
@@ -144,6 +155,19 @@ private:
 
     std::queue<NativeEvent> m_events;
     NativeEvent m_currentEvent;
+
+#if __ANDROID_API__ >= 24
+    AChoreographer* m_choreographer{ nullptr };
+#endif
+    PFNEGLPRESENTATIONTIMEANDROIDPROC m_eglPresentationTime{ nullptr };
+    bool m_frameCallbackPosted{ false };
+    int64_t m_vsyncTime{ 0 };
+    int64_t m_vsyncInterval{ 16666667 }; // assume 60Hz until measured
+    int64_t m_frameStartTime{ 0 };
+    int m_swapDivisor{ 1 }; // 1 = every vsync, 2 = half-rate pacing
+    int m_pendingVsyncs{ 0 };
+    int m_slowFrames{ 0 };
+    int m_fastFrames{ 0 };
 };
 
 extern "C" {
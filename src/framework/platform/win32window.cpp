@@ -212,6 +212,29 @@ void WIN32Window::init()
     internalCreateWindow();
     internalCreateGLContext();
     internalRestoreGLContext();
+    internalInitDwm();
+}
+
+void WIN32Window::internalInitDwm()
+{
+    // windowed swaps always go through the DWM compositor; syncing on
+    // DwmFlush instead of the driver swap interval lets SwapBuffers return
+    // immediately and drops the extra blit-model queue frame of latency
+    const HMODULE dwmapi = LoadLibraryA("dwmapi.dll");
+    if (!dwmapi)
+        return;
+
+    m_dwmFlush = (HRESULT(WINAPI*)())GetProcAddress(dwmapi, "DwmFlush");
+    m_dwmIsCompositionEnabled = (HRESULT(WINAPI*)(BOOL*))GetProcAddress(dwmapi, "DwmIsCompositionEnabled");
+}
+
+bool WIN32Window::useCompositorSync() const
+{
+    if (m_fullscreen || !m_dwmFlush || !m_dwmIsCompositionEnabled)
+        return false;
+
+    BOOL composited = FALSE;
+    return SUCCEEDED(m_dwmIsCompositionEnabled(&composited)) && composited;
 }
 
 void WIN32Window::terminate()
@@ -504,6 +527,16 @@ void WIN32Window::poll()
     fireKeysPress();
     MSG msg;
     while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+        // high polling rate mice flood the queue with motion messages;
+        // collapse the consecutive run to its final position, the resulting
+        // delta telescopes to the same sum the per-message dispatches would
+        // have produced
+        if (msg.message == WM_MOUSEMOVE) {
+            MSG nextMsg;
+            while (PeekMessage(&nextMsg, nullptr, WM_MOUSEMOVE, WM_MOUSEMOVE, PM_REMOVE))
+                msg = nextMsg;
+        }
+
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
@@ -824,6 +857,8 @@ void WIN32Window::swapBuffers()
     eglSwapBuffers(m_eglDisplay, m_eglSurface);
 #else
     SwapBuffers(m_deviceContext);
+    if (m_vsync && useCompositorSync())
+        m_dwmFlush();
 #endif
 }
 
@@ -926,6 +961,8 @@ void WIN32Window::setFullscreen(bool fullscreen)
             SetWindowPlacement(m_window, &wpPrev);
             SetWindowPos(m_window, HWND_NOTOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_FRAMECHANGED);
         }
+
+        updateSwapInterval();
     });
 }
 
@@ -933,19 +970,26 @@ void WIN32Window::setVerticalSync(bool enable)
 {
     g_mainDispatcher.addEvent([&, enable] {
         m_vsync = enable;
+        updateSwapInterval();
+    });
+}
+
+void WIN32Window::updateSwapInterval()
+{
 #ifdef OPENGL_ES
-        eglSwapInterval(m_eglDisplay, enable);
+    eglSwapInterval(m_eglDisplay, m_vsync);
 #else
-        if (!isExtensionSupported("WGL_EXT_swap_control"))
-            return;
+    if (!isExtensionSupported("WGL_EXT_swap_control"))
+        return;
 
-        const auto wglSwapInterval = (BOOL(WINAPI*)(int))getExtensionProcAddress("wglSwapIntervalEXT");
-        if (!wglSwapInterval)
-            return;
+    const auto wglSwapInterval = (BOOL(WINAPI*)(int))getExtensionProcAddress("wglSwapIntervalEXT");
+    if (!wglSwapInterval)
+        return;
 
-        wglSwapInterval(enable);
+    // in windowed mode vsync is enforced by the compositor sync in
+    // swapBuffers, so the driver swap queue must not add its own frame
+    wglSwapInterval(m_vsync && !useCompositorSync() ? 1 : 0);
 #endif
-    });
 }
 
 void WIN32Window::setIcon(const std::string& file)
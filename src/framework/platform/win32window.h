@@ -42,6 +42,10 @@ class WIN32Window : public PlatformWindow
     void* getExtensionProcAddress(const char* ext);
     bool isExtensionSupported(const char* ext);
 
+    void internalInitDwm();
+    void updateSwapInterval();
+    bool useCompositorSync() const;
+
     LRESULT windowProc(HWND hWnd, uint32_t uMsg, WPARAM wParam, LPARAM lParam);
     friend struct WindowProcProxy;
 
@@ -102,4 +106,8 @@ private:
 #else
     HGLRC m_wglContext;
 #endif
+
+    // compositor sync entry points, resolved from dwmapi.dll at runtime
+    HRESULT(WINAPI* m_dwmFlush)(){ nullptr };
+    HRESULT(WINAPI* m_dwmIsCompositionEnabled)(BOOL*){ nullptr };
 };
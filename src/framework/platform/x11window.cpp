@@ -822,6 +822,17 @@ void X11Window::poll()
             }
 
             case MotionNotify: {
+                // high polling rate mice flood the queue with motion events;
+                // collapse the consecutive run to its final position, the
+                // resulting delta telescopes to the same sum the per-event
+                // dispatches would have produced
+                while (XPending(m_display)) {
+                    XPeekEvent(m_display, &peekEvent);
+                    if (peekEvent.type != MotionNotify)
+                        break;
+                    XNextEvent(m_display, &event);
+                }
+
                 m_inputEvent.reset();
                 m_inputEvent.type = Fw::MouseMoveInputEvent;
                 Point newMousePos(event.xbutton.x, event.xbutton.y);
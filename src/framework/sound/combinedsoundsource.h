@@ -49,6 +49,7 @@ public:
 
 protected:
     void update() override;
+    bool canVirtualize() override { return false; }
 
 private:
     std::vector<SoundSourcePtr> m_sources;
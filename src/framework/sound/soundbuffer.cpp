@@ -55,7 +55,12 @@ bool SoundBuffer::fillBuffer(const SoundFilePtr& soundFile)
 
 bool SoundBuffer::fillBuffer(ALenum sampleFormat, const DataBuffer<char>& data, int size, int rate) const
 {
-    alBufferData(m_bufferId, sampleFormat, &data[0], size, rate);
+    return fillBuffer(sampleFormat, &data[0], size, rate);
+}
+
+bool SoundBuffer::fillBuffer(ALenum sampleFormat, const char* data, int size, int rate) const
+{
+    alBufferData(m_bufferId, sampleFormat, data, size, rate);
     const ALenum err = alGetError();
     if (err != AL_NO_ERROR) {
         g_logger.error(stdext::format("unable to fill audio buffer data: %s", alGetString(err)));
@@ -34,6 +34,7 @@ public:
 
     bool fillBuffer(const SoundFilePtr& soundFile);
     bool fillBuffer(ALenum sampleFormat, const DataBuffer<char>& data, int size, int rate) const;
+    bool fillBuffer(ALenum sampleFormat, const char* data, int size, int rate) const;
 
     uint32_t getBufferId() const { return m_bufferId; }
 
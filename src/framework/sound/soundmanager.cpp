@@ -30,12 +30,21 @@
 #include <framework/core/asyncdispatcher.h>
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/core/filestream.h>
 #include <framework/core/resourcemanager.h>
 
 SoundManager g_sounds;
 
+namespace {
+    constexpr uint32_t BANK_SIGNATURE = 0x4253544F; // 'OTSB'
+    constexpr uint16_t BANK_VERSION = 1;
+    const std::string BANK_FILE = "/sound_effects.bank";
+}
+
 void SoundManager::init()
 {
+    loadSampleBank();
+
 #ifdef ANDROID
     // The alcOpenDevice call needs to be executed on Android main thread
     g_androidManager.attachToAppMainThread();
@@ -59,6 +68,8 @@ void SoundManager::init()
 
 void SoundManager::terminate()
 {
+    saveSampleBank();
+
     ensureContext();
 
     for (auto& streamFile : m_streamFiles) {
@@ -70,6 +81,14 @@ void SoundManager::terminate()
     m_sources.clear();
     m_buffers.clear();
     m_channels.clear();
+    m_pcmLoading.clear();
+
+    {
+        std::scoped_lock l(m_pcmMutex);
+        m_decodedPcm.clear();
+    }
+
+    SoundSource::clearPool();
 
     m_audioEnabled = false;
 
@@ -115,6 +134,32 @@ void SoundManager::poll()
         }
     }
 
+    // turn worker-decoded effects into cached shared buffers
+    std::vector<std::pair<std::string, PcmData>> decoded;
+    {
+        std::scoped_lock l(m_pcmMutex);
+        decoded.swap(m_decodedPcm);
+    }
+    for (const auto& [filename, pcm] : decoded) {
+        const auto& buffer = std::make_shared<SoundBuffer>();
+        if (!buffer->fillBuffer(pcm.format, pcm.samples.data(), pcm.samples.size(), pcm.rate))
+            continue;
+        m_buffers[filename] = buffer;
+
+        // remember the decode in the sample bank so future sessions skip it
+        const auto hashIt = m_fileHashes.find(filename);
+        if (hashIt != m_fileHashes.end() && !m_bankIndex.contains(hashIt->second)) {
+            BankEntry entry;
+            entry.format = pcm.format;
+            entry.rate = pcm.rate;
+            entry.offset = m_bankData.size();
+            entry.size = pcm.samples.size();
+            m_bankData.append(pcm.samples.data(), pcm.samples.size());
+            m_bankIndex[hashIt->second] = entry;
+            m_bankDirty = true;
+        }
+    }
+
     for (auto it = m_sources.begin(); it != m_sources.end();) {
         const auto& source = *it;
 
@@ -126,6 +171,8 @@ void SoundManager::poll()
             ++it;
     }
 
+    updateVirtualization();
+
     for (const auto& it : m_channels) {
         it.second->update();
     }
@@ -135,6 +182,38 @@ void SoundManager::poll()
     }
 }
 
+void SoundManager::updateVirtualization()
+{
+    // rank active effects by audibility and keep only the loudest on
+    // hardware voices; everything else plays virtually, advancing in
+    // wall-clock time so it can be promoted back on a later pass
+    size_t reserved = 0; // voices held by sources that cannot virtualize
+    std::vector<SoundSource*> candidates;
+    candidates.reserve(m_sources.size());
+    for (const auto& source : m_sources) {
+        if (source->canVirtualize())
+            candidates.emplace_back(source.get());
+        else
+            ++reserved;
+    }
+
+    const size_t slots = MAX_ACTIVE_SOURCES > reserved ? MAX_ACTIVE_SOURCES - reserved : 0;
+    if (candidates.size() > slots) {
+        std::sort(candidates.begin(), candidates.end(), [](const SoundSource* a, const SoundSource* b) {
+            if (a->getGain() != b->getGain())
+                return a->getGain() > b->getGain();
+            return a->m_playStartTicks > b->m_playStartTicks; // prefer newer effects on ties
+        });
+    }
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (i < slots)
+            candidates[i]->unvirtualize();
+        else
+            candidates[i]->virtualize();
+    }
+}
+
 void SoundManager::setAudioEnabled(bool enable)
 {
     if (m_audioEnabled == enable)
@@ -234,6 +313,19 @@ SoundSourcePtr SoundManager::createSoundSource(const std::string& filename)
             source = std::make_shared<SoundSource>();
             source->setBuffer(it->second);
         } else {
+            // short effects get decoded once on a worker and cached, so
+            // replaying them later costs neither allocation nor decoding
+            cacheEffect(filename);
+
+            // a sample bank hit fills the shared buffer synchronously, so
+            // even the first play skips the streaming path entirely
+            const auto cached = m_buffers.find(filename);
+            if (cached != m_buffers.end()) {
+                source = std::make_shared<SoundSource>();
+                source->setBuffer(cached->second);
+                return source;
+            }
+
 #if defined __linux && !defined OPENGL_ES
             // due to OpenAL implementation bug, stereo buffers are always downmixed to mono on linux systems
             // this is hack to work around the issue
@@ -292,6 +384,127 @@ SoundSourcePtr SoundManager::createSoundSource(const std::string& filename)
     return source;
 }
 
+void SoundManager::cacheEffect(const std::string& filename)
+{
+    if (!m_pcmLoading.emplace(filename).second)
+        return;
+
+    // sample bank hit: this effect was decoded in a past session, so the
+    // cached pcm goes straight into a shared AL buffer with no ogg decode
+    try {
+        const auto& contents = g_resources.readFileContents(filename);
+        const uint32_t hash = stdext::adler32((const uint8_t*)contents.data(), contents.size());
+        m_fileHashes[filename] = hash;
+
+        const auto it = m_bankIndex.find(hash);
+        if (it != m_bankIndex.end()) {
+            const auto& entry = it->second;
+            const auto& buffer = std::make_shared<SoundBuffer>();
+            if (buffer->fillBuffer(entry.format, m_bankData.data() + entry.offset, static_cast<int>(entry.size), entry.rate)) {
+                m_buffers[filename] = buffer;
+                return;
+            }
+        }
+    } catch (const stdext::exception&) {
+        // unreadable files fail the decode below with a proper error
+    }
+
+    g_asyncDispatcher.dispatch([this, filename] {
+        try {
+            // the streaming source owns its own file handle, so the cache
+            // decode opens the file again
+            const auto& soundFile = SoundFile::loadSoundFile(filename);
+            if (!soundFile || soundFile->getSize() > MAX_CACHE_SIZE || soundFile->getSampleFormat() == AL_UNDETERMINED)
+                return;
+
+            PcmData pcm;
+            pcm.format = soundFile->getSampleFormat();
+            pcm.rate = soundFile->getRate();
+            pcm.samples.resize(soundFile->getSize());
+            const int read = soundFile->read(pcm.samples.data(), pcm.samples.size());
+            if (read <= 0)
+                return;
+            pcm.samples.resize(read);
+
+            std::scoped_lock l(m_pcmMutex);
+            m_decodedPcm.emplace_back(filename, std::move(pcm));
+        } catch (std::exception& e) {
+            g_logger.error(e.what());
+        }
+    }, AsyncDispatcher::Priority::LOW);
+}
+
+void SoundManager::loadSampleBank()
+{
+    try {
+        if (!g_resources.fileExists(BANK_FILE))
+            return;
+
+        m_bankData = g_resources.readFileContents(BANK_FILE);
+        const size_t size = m_bankData.size();
+
+        const auto readU32 = [this](const size_t at) {
+            uint32_t v;
+            memcpy(&v, m_bankData.data() + at, 4);
+            return v;
+        };
+
+        uint16_t version = 0;
+        if (size >= 6)
+            memcpy(&version, m_bankData.data() + 4, 2);
+
+        if (size < 6 || readU32(0) != BANK_SIGNATURE || version != BANK_VERSION) {
+            m_bankData.clear();
+            return;
+        }
+
+        size_t pos = 6;
+        while (pos + 16 <= size) {
+            const uint32_t hash = readU32(pos);
+            const uint32_t format = readU32(pos + 4);
+            const uint32_t rate = readU32(pos + 8);
+            const uint32_t length = readU32(pos + 12);
+            pos += 16;
+            if (pos + length > size)
+                break; // truncated bank, keep what parsed so far
+            m_bankIndex[hash] = { static_cast<ALenum>(format), static_cast<int>(rate), pos, length };
+            pos += length;
+        }
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("failed to load sound sample bank: %s", e.what()));
+        m_bankIndex.clear();
+        m_bankData.clear();
+    }
+}
+
+void SoundManager::saveSampleBank()
+{
+    if (!m_bankDirty)
+        return;
+
+    try {
+        const FileStreamPtr fin = g_resources.createFile(BANK_FILE);
+        fin->cache();
+
+        fin->addU32(BANK_SIGNATURE);
+        fin->addU16(BANK_VERSION);
+
+        for (const auto& [hash, entry] : m_bankIndex) {
+            fin->addU32(hash);
+            fin->addU32(entry.format);
+            fin->addU32(entry.rate);
+            fin->addU32(entry.size);
+            fin->write(m_bankData.data() + entry.offset, entry.size);
+        }
+
+        fin->flush();
+        fin->close();
+        m_bankDirty = false;
+    } catch (const stdext::exception& e) {
+        g_logger.error(stdext::format("failed to save sound sample bank: %s", e.what()));
+    }
+}
+
 std::string SoundManager::resolveSoundFile(const std::string& file)
 {
     std::string _file = g_resources.guessFilePath(file, "ogg");
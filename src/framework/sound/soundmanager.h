@@ -32,7 +32,10 @@ class SoundManager
     enum
     {
         MAX_CACHE_SIZE = 100000,
-        POLL_DELAY = 100
+        POLL_DELAY = 100,
+        // effects ranked below the top-N by audibility play virtually
+        // instead of occupying a hardware voice
+        MAX_ACTIVE_SOURCES = 24
     };
 public:
     void init();
@@ -53,7 +56,30 @@ public:
     void ensureContext() const;
 
 private:
+    // a short effect fully decoded on a worker, waiting to become a
+    // cached shared buffer
+    struct PcmData
+    {
+        ALenum format{ AL_UNDETERMINED };
+        int rate{ 0 };
+        std::vector<char> samples;
+    };
+
+    // persistent cross-session cache of decoded effect pcm, keyed by the
+    // content hash of the source file so renamed or changed files re-decode
+    struct BankEntry
+    {
+        ALenum format{ AL_UNDETERMINED };
+        int rate{ 0 };
+        size_t offset{ 0 };
+        size_t size{ 0 };
+    };
+
     SoundSourcePtr createSoundSource(const std::string& filename);
+    void cacheEffect(const std::string& filename);
+    void updateVirtualization();
+    void loadSampleBank();
+    void saveSampleBank();
 
     ALCdevice* m_device{};
     ALCcontext* m_context{};
@@ -62,8 +88,17 @@ private:
     stdext::map<std::string, SoundBufferPtr> m_buffers;
     stdext::map<int, SoundChannelPtr> m_channels;
 
+    stdext::set<std::string> m_pcmLoading;
+    std::mutex m_pcmMutex;
+    std::vector<std::pair<std::string, PcmData>> m_decodedPcm; // filled by workers
+
     std::vector<SoundSourcePtr> m_sources;
     bool m_audioEnabled{ true };
+
+    stdext::map<uint32_t, BankEntry> m_bankIndex;
+    stdext::map<std::string, uint32_t> m_fileHashes;
+    std::string m_bankData; // backing store the bank entries point into
+    bool m_bankDirty{ false };
 };
 
 extern SoundManager g_sounds;
@@ -23,32 +23,82 @@
 #include "soundsource.h"
 #include "soundbuffer.h"
 
-#include "framework/stdext/time.h"
+#include "framework/core/clock.h"
+
+namespace
+{
+    // generating and deleting AL sources per effect is expensive on some
+    // implementations; released ids are parked here for reuse
+    constexpr size_t MAX_POOLED_SOURCES = 32;
+    std::vector<uint32_t> g_sourcePool;
+    std::mutex g_sourcePoolMutex;
+}
 
 SoundSource::SoundSource()
 {
-    alGenSources(1, &m_sourceId);
-    assert(alGetError() == AL_NO_ERROR);
+    {
+        std::scoped_lock l(g_sourcePoolMutex);
+        if (!g_sourcePool.empty()) {
+            m_sourceId = g_sourcePool.back();
+            g_sourcePool.pop_back();
+        }
+    }
+
+    if (m_sourceId == 0) {
+        alGenSources(1, &m_sourceId);
+        assert(alGetError() == AL_NO_ERROR);
+    }
+
     SoundSource::setReferenceDistance(128);
 }
 
 SoundSource::~SoundSource()
 {
-    if (m_sourceId != 0) {
-        stop();
-        alDeleteSources(1, &m_sourceId);
-        assert(alGetError() == AL_NO_ERROR);
+    if (m_sourceId == 0)
+        return;
+
+    stop();
+
+    // restore the defaults the next user of a pooled id expects
+    alSourcei(m_sourceId, AL_LOOPING, AL_FALSE);
+    alSourcei(m_sourceId, AL_SOURCE_RELATIVE, AL_FALSE);
+    alSourcef(m_sourceId, AL_GAIN, 1.f);
+    alSourcef(m_sourceId, AL_PITCH, 1.f);
+    alSource3f(m_sourceId, AL_POSITION, 0.f, 0.f, 0.f);
+    alSource3f(m_sourceId, AL_VELOCITY, 0.f, 0.f, 0.f);
+
+    {
+        std::scoped_lock l(g_sourcePoolMutex);
+        if (g_sourcePool.size() < MAX_POOLED_SOURCES) {
+            g_sourcePool.emplace_back(m_sourceId);
+            return;
+        }
     }
+
+    alDeleteSources(1, &m_sourceId);
+    assert(alGetError() == AL_NO_ERROR);
+}
+
+void SoundSource::clearPool()
+{
+    std::scoped_lock l(g_sourcePoolMutex);
+    for (const uint32_t sourceId : g_sourcePool)
+        alDeleteSources(1, &sourceId);
+    g_sourcePool.clear();
 }
 
 void SoundSource::play()
 {
+    if (m_playStartTicks == 0)
+        m_playStartTicks = g_clock.millis();
     alSourcePlay(m_sourceId);
     assert(alGetError() == AL_NO_ERROR);
 }
 
 void SoundSource::stop()
 {
+    m_virtual = false;
+    m_playStartTicks = 0;
     alSourceStop(m_sourceId);
     assert(alGetError() == AL_NO_ERROR);
     if (m_buffer) {
@@ -60,11 +110,68 @@ void SoundSource::stop()
 
 bool SoundSource::isBuffering()
 {
+    // virtual sources advance in wall-clock time while off hardware
+    if (m_virtual)
+        return m_looping || (g_clock.millis() - m_playStartTicks) / 1000.f < getDuration();
+
     int state = AL_PLAYING;
     alGetSourcei(m_sourceId, AL_SOURCE_STATE, &state);
     return state != AL_STOPPED;
 }
 
+void SoundSource::virtualize()
+{
+    if (m_virtual)
+        return;
+    m_virtual = true;
+
+    // halt mixing but keep the buffer attached; wall-clock bookkeeping
+    // keeps running so a later promotion resumes at the right offset
+    alSourceStop(m_sourceId);
+    assert(alGetError() == AL_NO_ERROR);
+}
+
+void SoundSource::unvirtualize()
+{
+    if (!m_virtual)
+        return;
+    m_virtual = false;
+
+    const float duration = getDuration();
+    if (duration <= 0.f)
+        return;
+
+    float offset = (g_clock.millis() - m_playStartTicks) / 1000.f;
+    if (m_looping)
+        offset = std::fmod(offset, duration);
+    else if (offset >= duration)
+        return; // finished while virtual; the next poll drops it
+
+    alSourcef(m_sourceId, AL_SEC_OFFSET, offset);
+    alSourcePlay(m_sourceId);
+    assert(alGetError() == AL_NO_ERROR);
+}
+
+float SoundSource::getDuration()
+{
+    if (!m_buffer)
+        return 0.f;
+
+    int sizeInBytes = 0;
+    int channels = 0;
+    int bits = 0;
+    int frequency = 0;
+    alGetBufferi(m_buffer->getBufferId(), AL_SIZE, &sizeInBytes);
+    alGetBufferi(m_buffer->getBufferId(), AL_CHANNELS, &channels);
+    alGetBufferi(m_buffer->getBufferId(), AL_BITS, &bits);
+    alGetBufferi(m_buffer->getBufferId(), AL_FREQUENCY, &frequency);
+    if (channels <= 0 || bits <= 0 || frequency <= 0)
+        return 0.f;
+
+    const int samples = sizeInBytes * 8 / (channels * bits);
+    return static_cast<float>(samples) / frequency;
+}
+
 void SoundSource::setBuffer(const SoundBufferPtr& buffer)
 {
     alSourcei(m_sourceId, AL_BUFFER, buffer->getBufferId());
@@ -74,6 +181,7 @@ void SoundSource::setBuffer(const SoundBufferPtr& buffer)
 
 void SoundSource::setLooping(bool looping)
 {
+    m_looping = looping;
     alSourcei(m_sourceId, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
 }
 
@@ -110,7 +218,7 @@ void SoundSource::setVelocity(const Point& velocity)
 
 void SoundSource::setFading(FadeState state, float fadeTime)
 {
-    const float now = stdext::millis() / 1000.0f;
+    const float now = g_clock.seconds();
     if (m_fadeState != NoFading) {
         const float elapsed = now - m_fadeStartTime;
         float add;
@@ -132,7 +240,7 @@ void SoundSource::setFading(FadeState state, float fadeTime)
 
 void SoundSource::update()
 {
-    const float now = stdext::millis() / 1000.0f;
+    const float now = g_clock.seconds();
     if (m_fadeState == FadingOn) {
         const float elapsed = now - m_fadeStartTime;
         if (elapsed >= m_fadeTime) {
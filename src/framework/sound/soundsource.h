@@ -36,6 +36,9 @@ public:
     SoundSource();
     ~SoundSource() override;
 
+    // frees every pooled AL source id; must run before the context dies
+    static void clearPool();
+
     virtual void play();
     virtual void stop();
 
@@ -61,6 +64,16 @@ protected:
     void setChannel(uint8_t channel) { m_channel = channel; }
 
     virtual void update();
+
+    // voice virtualization: a source evicted from a hardware voice stops
+    // mixing but keeps advancing in wall-clock time, so it can be promoted
+    // back mid-sound when it ranks loud enough again
+    virtual bool canVirtualize() { return m_buffer != nullptr; }
+    bool isVirtual() const { return m_virtual; }
+    void virtualize();
+    void unvirtualize();
+    float getDuration();
+
     friend class SoundManager;
     friend class CombinedSoundSource;
 
@@ -71,6 +84,10 @@ protected:
 
     FadeState m_fadeState{ NoFading };
 
+    bool m_virtual{ false };
+    bool m_looping{ false };
+    ticks_t m_playStartTicks{ 0 };
+
     uint32_t m_sourceId{ 0 };
     uint8_t m_channel{ 0 };
 
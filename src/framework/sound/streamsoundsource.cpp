@@ -24,7 +24,7 @@
 #include "soundbuffer.h"
 #include "soundfile.h"
 
-#include <framework/util/databuffer.h>
+#include <framework/core/asyncdispatcher.h>
 
 StreamSoundSource::StreamSoundSource()
 {
@@ -41,6 +41,10 @@ StreamSoundSource::~StreamSoundSource()
 void StreamSoundSource::setSoundFile(const SoundFilePtr& soundFile)
 {
     m_soundFile = soundFile;
+
+    // start prefetching decoded chunks right away
+    scheduleDecode();
+
     if (m_waitingFile) {
         m_waitingFile = false;
         play();
@@ -57,7 +61,10 @@ void StreamSoundSource::play()
     }
 
     if (m_eof) {
-        m_soundFile->reset();
+        // the file is rewound by the decode worker, which owns it
+        std::scoped_lock l(m_chunkMutex);
+        m_chunks.clear();
+        m_resetRequested = true;
         m_eof = false;
     }
 
@@ -119,7 +126,9 @@ void StreamSoundSource::update()
         if (!m_looping && m_eof) {
             stop();
         } else if (processed == 0) {
-            g_logger.traceError("audio buffer underrun");
+            // a pending decode is just latency, not a real underrun
+            if (!m_decodeScheduled)
+                g_logger.traceError("audio buffer underrun");
             play();
         } else if (m_looping) {
             play();
@@ -132,42 +141,30 @@ bool StreamSoundSource::fillBufferAndQueue(uint32_t buffer)
     if (m_waitingFile)
         return false;
 
-    // fill buffer
-    static DataBuffer<char> bufferData(2 * STREAM_FRAGMENT_SIZE);
-    ALenum format = m_soundFile->getSampleFormat();
-
-    int maxRead = STREAM_FRAGMENT_SIZE;
-    if (m_downMix != NoDownMix)
-        maxRead *= 2;
+    PcmChunk chunk;
+    bool gotChunk = false;
+    size_t remaining = 0;
+    {
+        std::scoped_lock l(m_chunkMutex);
+        if (!m_chunks.empty()) {
+            chunk = std::move(m_chunks.front());
+            m_chunks.pop_front();
+            gotChunk = true;
+            remaining = m_chunks.size();
+        }
+    }
 
-    int bytesRead = 0;
-    do {
-        bytesRead += m_soundFile->read(&bufferData[bytesRead], maxRead - bytesRead);
+    if (!gotChunk) {
+        // nothing decoded yet, ask the worker for more
+        scheduleDecode();
+        return false;
+    }
 
-        // end of sound file
-        if (bytesRead < maxRead) {
-            if (m_looping)
-                m_soundFile->reset();
-            else {
-                m_eof = true;
-                break;
-            }
-        }
-    } while (bytesRead < maxRead);
-
-    if (bytesRead > 0) {
-        if (m_downMix != NoDownMix) {
-            if (format == AL_FORMAT_STEREO16) {
-                assert(bytesRead % 2 == 0);
-                bytesRead /= 2;
-                auto* const data = (uint16_t*)bufferData.data();
-                for (int i = 0; i < bytesRead / 2; ++i)
-                    data[i] = data[2 * i + (m_downMix == DownMixLeft ? 0 : 1)];
-                format = AL_FORMAT_MONO16;
-            }
-        }
+    if (chunk.last)
+        m_eof = true;
 
-        alBufferData(buffer, format, &bufferData[0], bytesRead, m_soundFile->getRate());
+    if (!chunk.data.empty()) {
+        alBufferData(buffer, chunk.format, chunk.data.data(), chunk.data.size(), chunk.rate);
         ALenum err = alGetError();
         if (err != AL_NO_ERROR)
             g_logger.error(stdext::format("unable to refill audio buffer for '%s': %s", m_soundFile->getName(), alGetString(err)));
@@ -178,8 +175,91 @@ bool StreamSoundSource::fillBufferAndQueue(uint32_t buffer)
             g_logger.error(stdext::format("unable to queue audio buffer for '%s': %s", m_soundFile->getName(), alGetString(err)));
     }
 
+    if (!m_eof && remaining < STREAM_FRAGMENTS)
+        scheduleDecode();
+
     // return false if there aren't more buffers to fill
-    return (bytesRead >= STREAM_FRAGMENT_SIZE && !m_eof);
+    return !m_eof && static_cast<int>(chunk.data.size()) >= STREAM_FRAGMENT_SIZE;
+}
+
+void StreamSoundSource::scheduleDecode()
+{
+    if (!m_soundFile || m_decodeScheduled.exchange(true))
+        return;
+
+    g_asyncDispatcher.dispatch([self = static_self_cast<StreamSoundSource>()] {
+        self->decodeChunks();
+    }, AsyncDispatcher::Priority::HIGH);
+}
+
+void StreamSoundSource::decodeChunks()
+{
+    const auto& soundFile = m_soundFile;
+
+    {
+        std::scoped_lock l(m_chunkMutex);
+        if (m_resetRequested) {
+            m_resetRequested = false;
+            soundFile->reset();
+        }
+    }
+
+    int maxRead = STREAM_FRAGMENT_SIZE;
+    if (m_downMix != NoDownMix)
+        maxRead *= 2;
+
+    const bool looping = m_looping;
+
+    while (true) {
+        {
+            std::scoped_lock l(m_chunkMutex);
+            if (m_chunks.size() >= PREFETCH_CHUNKS)
+                break;
+        }
+
+        PcmChunk chunk;
+        chunk.data.resize(maxRead);
+        chunk.format = soundFile->getSampleFormat();
+        chunk.rate = soundFile->getRate();
+
+        int bytesRead = 0;
+        do {
+            bytesRead += soundFile->read(chunk.data.data() + bytesRead, maxRead - bytesRead);
+
+            // end of sound file
+            if (bytesRead < maxRead) {
+                if (looping)
+                    soundFile->reset();
+                else {
+                    chunk.last = true;
+                    break;
+                }
+            }
+        } while (bytesRead < maxRead);
+
+        chunk.data.resize(std::max(bytesRead, 0));
+
+        if (m_downMix != NoDownMix && chunk.format == AL_FORMAT_STEREO16) {
+            assert(chunk.data.size() % 2 == 0);
+            auto* const data = (uint16_t*)chunk.data.data();
+            const int samples = chunk.data.size() / 4;
+            for (int i = 0; i < samples; ++i)
+                data[i] = data[2 * i + (m_downMix == DownMixLeft ? 0 : 1)];
+            chunk.data.resize(chunk.data.size() / 2);
+            chunk.format = AL_FORMAT_MONO16;
+        }
+
+        const bool last = chunk.last;
+        {
+            std::scoped_lock l(m_chunkMutex);
+            m_chunks.emplace_back(std::move(chunk));
+        }
+
+        if (last)
+            break;
+    }
+
+    m_decodeScheduled = false;
 }
 
 void StreamSoundSource::downMix(DownMix downMix)
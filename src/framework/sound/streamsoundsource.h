@@ -30,7 +30,18 @@ class StreamSoundSource : public SoundSource
     {
         STREAM_BUFFER_SIZE = 1024 * 400,
         STREAM_FRAGMENTS = 4,
-        STREAM_FRAGMENT_SIZE = STREAM_BUFFER_SIZE / STREAM_FRAGMENTS
+        STREAM_FRAGMENT_SIZE = STREAM_BUFFER_SIZE / STREAM_FRAGMENTS,
+        PREFETCH_CHUNKS = STREAM_FRAGMENTS * 2
+    };
+
+    // one decoded (and already downmixed) fragment of PCM data, produced
+    // on a worker thread and consumed by the poll loop
+    struct PcmChunk
+    {
+        std::vector<char> data;
+        ALenum format{ AL_UNDETERMINED };
+        int rate{ 0 };
+        bool last{ false };
     };
 
 public:
@@ -50,10 +61,16 @@ public:
 
     void update() override;
 
+protected:
+    // streams cannot resume from an arbitrary wall-clock offset
+    bool canVirtualize() override { return false; }
+
 private:
     void queueBuffers();
     void unqueueBuffers() const;
     bool fillBufferAndQueue(uint32_t buffer);
+    void scheduleDecode();
+    void decodeChunks();
 
     SoundFilePtr m_soundFile;
     std::array<SoundBufferPtr, STREAM_FRAGMENTS> m_buffers;
@@ -62,4 +79,9 @@ private:
     bool m_playing{ false };
     bool m_eof{ false };
     bool m_waitingFile{ false };
+
+    std::mutex m_chunkMutex;
+    std::deque<PcmChunk> m_chunks;
+    bool m_resetRequested{ false }; // guarded by m_chunkMutex
+    std::atomic_bool m_decodeScheduled{ false };
 };
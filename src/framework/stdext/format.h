@@ -96,8 +96,16 @@ namespace stdext
     template<typename... Args>
     std::string format(const std::string_view format, const Args&... args)
     {
-        int n = snprintf(NULL, 0, format.data(), args...);
+        // nearly every message fits in the stack buffer, so the common case
+        // formats in a single pass and only allocates the returned string
+        char stack[256];
+        int n = snprintf(stack, sizeof(stack), format.data(), args...);
         assert(n != -1);
+
+        if (n < static_cast<int>(sizeof(stack)))
+            return { stack, static_cast<size_t>(n) };
+
+        // truncated, snprintf returned the required length
         std::string buffer(n + 1, '\0');
         n = snprintf(&buffer[0], buffer.size(), format.data(), args...);
         assert(n != -1);
@@ -38,6 +38,28 @@ namespace stdext
         return static_cast<size_t>(x);
     }
 
+    // wyhash-style multiply-mix over a small buffer, 8 bytes per round;
+    // meant for packed key structs that would otherwise chain hash_union
+    // once per field
+    inline size_t hash_bytes(const void* data, size_t len) noexcept
+    {
+        const auto* p = static_cast<const uint8_t*>(data);
+        uint64_t h = UINT64_C(0xa0761d6478bd642f) ^ len;
+        while (len >= 8) {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            h = hash_int(h ^ v) * UINT64_C(0xe7037ed1a0b428db);
+            p += 8;
+            len -= 8;
+        }
+        if (len > 0) {
+            uint64_t v = 0;
+            std::memcpy(&v, p, len);
+            h = hash_int(h ^ v) * UINT64_C(0xe7037ed1a0b428db);
+        }
+        return hash_int(h);
+    }
+
     // Boost Lib
     inline void hash_union(size_t& seed, const size_t h)
     {
@@ -24,14 +24,162 @@
 #include <cmath>
 #include <random>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ADLER32_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ADLER32_NEON
+#include <arm_neon.h>
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(disable:4267) // '?' : conversion from 'A' to 'B', possible loss of data
 #endif
 
+namespace
+{
+    constexpr uint32_t ADLER32_BASE = 65521;
+
+    // 16-byte blocks are accumulated in 32-bit vector lanes; the window is
+    // kept small enough that no lane can overflow before the modulo
+    constexpr size_t ADLER32_WINDOW = 2048;
+
+#ifdef ADLER32_X86
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((target("ssse3")))
+#endif
+    uint32_t adler32_ssse3(const uint8_t* buffer, size_t size)
+    {
+        uint32_t a = 1, b = 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i taps = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+        const __m128i ones = _mm_set1_epi16(1);
+
+        while (size >= 16) {
+            const size_t n = (size < ADLER32_WINDOW ? size : ADLER32_WINDOW) & ~static_cast<size_t>(15);
+            size -= n;
+
+            // b grows by n times the a it started the window with
+            b += a * n;
+
+            __m128i vs1 = zero; // plain byte sums
+            __m128i vs2 = zero; // position-weighted sums within each block
+            __m128i vs3 = zero; // vs1 prefix sums, one per block
+            for (size_t i = 0; i < n; i += 16) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+                vs3 = _mm_add_epi32(vs3, vs1);
+                vs1 = _mm_add_epi32(vs1, _mm_sad_epu8(bytes, zero));
+                vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_maddubs_epi16(bytes, taps), ones));
+            }
+            buffer += n;
+
+            alignas(16) uint32_t lanes[12];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 0), vs1);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 4), vs2);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 8), vs3);
+
+            a += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            b += (lanes[8] + lanes[9] + lanes[10] + lanes[11]) * 16
+                + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+
+            a %= ADLER32_BASE;
+            b %= ADLER32_BASE;
+        }
+
+        while (size-- > 0) {
+            a += *buffer++;
+            b += a;
+        }
+        a %= ADLER32_BASE;
+        b %= ADLER32_BASE;
+
+        return (b << 16) | a;
+    }
+
+    bool adler32HasSSSE3()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_cpu_supports("ssse3");
+#else
+        int regs[4];
+        __cpuid(regs, 1);
+        return (regs[2] & (1 << 9)) != 0;
+#endif
+    }
+#endif
+
+#ifdef ADLER32_NEON
+    uint32_t adler32_hsum(const uint32x4_t v)
+    {
+        uint32x2_t t = vadd_u32(vget_low_u32(v), vget_high_u32(v));
+        t = vpadd_u32(t, t);
+        return vget_lane_u32(t, 0);
+    }
+
+    uint32_t adler32_neon(const uint8_t* buffer, size_t size)
+    {
+        uint32_t a = 1, b = 0;
+
+        static const uint8_t tapsData[16] = { 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+        const uint8x8_t tapsLo = vld1_u8(tapsData);
+        const uint8x8_t tapsHi = vld1_u8(tapsData + 8);
+
+        while (size >= 16) {
+            const size_t n = (size < ADLER32_WINDOW ? size : ADLER32_WINDOW) & ~static_cast<size_t>(15);
+            size -= n;
+
+            b += a * n;
+
+            uint32x4_t vs1 = vdupq_n_u32(0);
+            uint32x4_t vs2 = vdupq_n_u32(0);
+            uint32x4_t vs3 = vdupq_n_u32(0);
+            for (size_t i = 0; i < n; i += 16) {
+                const uint8x16_t bytes = vld1q_u8(buffer + i);
+                vs3 = vaddq_u32(vs3, vs1);
+                vs1 = vpadalq_u16(vs1, vpaddlq_u8(bytes));
+
+                uint16x8_t dot = vmull_u8(vget_low_u8(bytes), tapsLo);
+                dot = vmlal_u8(dot, vget_high_u8(bytes), tapsHi);
+                vs2 = vpadalq_u16(vs2, dot);
+            }
+            buffer += n;
+
+            a += adler32_hsum(vs1);
+            b += adler32_hsum(vs3) * 16 + adler32_hsum(vs2);
+
+            a %= ADLER32_BASE;
+            b %= ADLER32_BASE;
+        }
+
+        while (size-- > 0) {
+            a += *buffer++;
+            b += a;
+        }
+        a %= ADLER32_BASE;
+        b %= ADLER32_BASE;
+
+        return (b << 16) | a;
+    }
+#endif
+}
+
 namespace stdext
 {
     uint32_t adler32(const uint8_t* buffer, size_t size)
     {
+#if defined(ADLER32_X86)
+        static const bool hasSSSE3 = adler32HasSSSE3();
+        if (hasSSSE3 && size >= 64)
+            return adler32_ssse3(buffer, size);
+#elif defined(ADLER32_NEON)
+        if (size >= 64)
+            return adler32_neon(buffer, size);
+#endif
+
         size_t a = 1, b = 0;
         while (size > 0) {
             size_t tlen = size > 5552 ? 5552 : size;
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace stdext
+{
+    // lock-free multi-producer single-consumer queue; producers push with a
+    // single CAS, the consumer takes the whole chain with one exchange and
+    // reverses it to preserve FIFO order.
+    template<typename T>
+    class mpsc_queue
+    {
+    public:
+        ~mpsc_queue()
+        {
+            auto* node = m_head.load(std::memory_order_relaxed);
+            while (node) {
+                auto* next = node->next;
+                delete node;
+                node = next;
+            }
+        }
+
+        void push(T&& value)
+        {
+            auto* node = new Node{ std::move(value), m_head.load(std::memory_order_relaxed) };
+            while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // single consumer only
+        template<typename F>
+        void drain(const F& func)
+        {
+            auto* node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+            Node* prev = nullptr;
+            while (node) {
+                auto* next = node->next;
+                node->next = prev;
+                prev = node;
+                node = next;
+            }
+
+            while (prev) {
+                func(std::move(prev->value));
+                auto* next = prev->next;
+                delete prev;
+                prev = next;
+            }
+        }
+
+        bool empty() const { return m_head.load(std::memory_order_acquire) == nullptr; }
+
+    private:
+        struct Node
+        {
+            T value;
+            Node* next;
+        };
+
+        std::atomic<Node*> m_head{ nullptr };
+    };
+}
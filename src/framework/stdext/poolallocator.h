@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace stdext
+{
+    // slab pool of fixed-size nodes with a free list; slabs are kept for
+    // reuse so churny allocations stop hitting the global allocator
+    template<std::size_t NODE_SIZE, std::size_t NODE_ALIGN, std::size_t NODES_PER_SLAB = 256>
+    class memory_pool
+    {
+    public:
+        ~memory_pool()
+        {
+            for (auto* slab : m_slabs)
+                ::operator delete(slab, std::align_val_t{ NODE_ALIGN });
+        }
+
+        void* allocate()
+        {
+            std::scoped_lock l(m_mutex);
+
+            if (!m_freeList) {
+                auto* slab = static_cast<std::byte*>(::operator new(NODE_SIZE * NODES_PER_SLAB, std::align_val_t{ NODE_ALIGN }));
+                m_slabs.emplace_back(slab);
+                for (std::size_t i = 0; i < NODES_PER_SLAB; ++i) {
+                    auto* node = reinterpret_cast<FreeNode*>(slab + i * NODE_SIZE);
+                    node->next = m_freeList;
+                    m_freeList = node;
+                }
+            }
+
+            auto* node = m_freeList;
+            m_freeList = node->next;
+            return node;
+        }
+
+        void deallocate(void* p)
+        {
+            std::scoped_lock l(m_mutex);
+
+            auto* node = static_cast<FreeNode*>(p);
+            node->next = m_freeList;
+            m_freeList = node;
+        }
+
+    private:
+        struct FreeNode { FreeNode* next; };
+
+        FreeNode* m_freeList{ nullptr };
+        std::vector<std::byte*> m_slabs;
+        std::mutex m_mutex;
+    };
+
+    // std allocator over a per-type memory_pool, meant for allocate_shared
+    // so the object and its control block land in the same slab node
+    template<typename T>
+    class pool_allocator
+    {
+    public:
+        using value_type = T;
+
+        pool_allocator() = default;
+        template<typename U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n != 1)
+                return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignof(T) }));
+            return static_cast<T*>(pool().allocate());
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (n != 1) {
+                ::operator delete(p, std::align_val_t{ alignof(T) });
+                return;
+            }
+            pool().deallocate(p);
+        }
+
+        template<typename U>
+        bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+
+    private:
+        static auto& pool()
+        {
+            static constexpr std::size_t nodeSize = sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T);
+            static constexpr std::size_t nodeAlign = alignof(T) < alignof(void*) ? alignof(void*) : alignof(T);
+            static memory_pool<nodeSize, nodeAlign> instance;
+            return instance;
+        }
+    };
+}
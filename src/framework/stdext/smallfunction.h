@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace stdext
+{
+    // callable wrapper with inline storage: captures up to Capacity bytes
+    // live inside the object itself and never touch the heap; only callables
+    // larger than that spill into a single heap block, like small_vector
+    template<typename Signature, std::size_t Capacity = 64>
+    class small_function;
+
+    template<typename Ret, typename... Args, std::size_t Capacity>
+    class small_function<Ret(Args...), Capacity>
+    {
+    public:
+        small_function() = default;
+        small_function(std::nullptr_t) {}
+
+        template<typename F, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, small_function> &&
+            std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>>>
+        small_function(F&& f) { assign(std::forward<F>(f)); }
+
+        small_function(const small_function& other) { copyFrom(other); }
+        small_function(small_function&& other) noexcept { moveFrom(std::move(other)); }
+
+        ~small_function() { reset(); }
+
+        small_function& operator=(const small_function& other)
+        {
+            if (this != &other) {
+                reset();
+                copyFrom(other);
+            }
+            return *this;
+        }
+
+        small_function& operator=(small_function&& other) noexcept
+        {
+            if (this != &other) {
+                reset();
+                moveFrom(std::move(other));
+            }
+            return *this;
+        }
+
+        small_function& operator=(std::nullptr_t)
+        {
+            reset();
+            return *this;
+        }
+
+        template<typename F, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, small_function> &&
+            std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>>>
+        small_function& operator=(F&& f)
+        {
+            reset();
+            assign(std::forward<F>(f));
+            return *this;
+        }
+
+        Ret operator()(Args... args) const
+        {
+            return m_ops->invoke(const_cast<std::byte*>(m_storage), std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const { return m_ops != nullptr; }
+
+        void reset()
+        {
+            if (m_ops) {
+                m_ops->destroy(m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+    private:
+        struct Ops
+        {
+            Ret(*invoke)(void*, Args&&...);
+            void (*copy)(void* dst, const void* src);
+            void (*relocate)(void* dst, void* src);
+            void (*destroy)(void*);
+        };
+
+        template<typename F>
+        void assign(F&& f)
+        {
+            using Fn = std::decay_t<F>;
+            if constexpr (sizeof(Fn) <= Capacity && alignof(Fn) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Fn>) {
+                ::new (static_cast<void*>(m_storage)) Fn(std::forward<F>(f));
+                static constexpr Ops ops{
+                    [](void* s, Args&&... args) -> Ret { return (*static_cast<Fn*>(s))(std::forward<Args>(args)...); },
+                    [](void* dst, const void* src) { ::new (dst) Fn(*static_cast<const Fn*>(src)); },
+                    [](void* dst, void* src) { auto* f = static_cast<Fn*>(src); ::new (dst) Fn(std::move(*f)); f->~Fn(); },
+                    [](void* s) { static_cast<Fn*>(s)->~Fn(); }
+                };
+                m_ops = &ops;
+            } else {
+                ::new (static_cast<void*>(m_storage)) Fn* (new Fn(std::forward<F>(f)));
+                static constexpr Ops ops{
+                    [](void* s, Args&&... args) -> Ret { return (**static_cast<Fn**>(s))(std::forward<Args>(args)...); },
+                    [](void* dst, const void* src) { ::new (dst) Fn* (new Fn(**static_cast<Fn* const*>(src))); },
+                    [](void* dst, void* src) { ::new (dst) Fn* (*static_cast<Fn**>(src)); },
+                    [](void* s) { delete* static_cast<Fn**>(s); }
+                };
+                m_ops = &ops;
+            }
+        }
+
+        void copyFrom(const small_function& other)
+        {
+            if (other.m_ops) {
+                other.m_ops->copy(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+            }
+        }
+
+        void moveFrom(small_function&& other) noexcept
+        {
+            if (other.m_ops) {
+                other.m_ops->relocate(m_storage, other.m_storage);
+                m_ops = other.m_ops;
+                other.m_ops = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) std::byte m_storage[Capacity < sizeof(void*) ? sizeof(void*) : Capacity];
+        const Ops* m_ops{ nullptr };
+    };
+}
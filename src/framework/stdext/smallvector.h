@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace stdext
+{
+    // vector with inline storage for the first N elements, only spilling to
+    // the heap when it grows past them
+    template<typename T, std::size_t N>
+    class small_vector
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        small_vector() = default;
+        small_vector(const small_vector& other)
+        {
+            reserve(other.m_size);
+            for (const auto& v : other)
+                emplace_back(v);
+        }
+        small_vector(small_vector&& other) noexcept { moveFrom(std::move(other)); }
+
+        ~small_vector() { reset(); }
+
+        small_vector& operator=(const small_vector& other)
+        {
+            if (this != &other) {
+                clear();
+                reserve(other.m_size);
+                for (const auto& v : other)
+                    emplace_back(v);
+            }
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& other) noexcept
+        {
+            if (this != &other) {
+                reset();
+                moveFrom(std::move(other));
+            }
+            return *this;
+        }
+
+        iterator begin() { return m_data; }
+        const_iterator begin() const { return m_data; }
+        iterator end() { return m_data + m_size; }
+        const_iterator end() const { return m_data + m_size; }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        T& operator[](size_type i) { return m_data[i]; }
+        const T& operator[](size_type i) const { return m_data[i]; }
+
+        T& front() { return m_data[0]; }
+        const T& front() const { return m_data[0]; }
+        T& back() { return m_data[m_size - 1]; }
+        const T& back() const { return m_data[m_size - 1]; }
+
+        size_type size() const { return m_size; }
+        size_type capacity() const { return m_capacity; }
+        bool empty() const { return m_size == 0; }
+
+        void reserve(size_type newCapacity)
+        {
+            if (newCapacity > m_capacity)
+                grow(newCapacity);
+        }
+
+        void clear()
+        {
+            std::destroy(begin(), end());
+            m_size = 0;
+        }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            if (m_size == m_capacity)
+                grow(m_capacity * 2);
+            T* slot = new (m_data + m_size) T(std::forward<Args>(args)...);
+            ++m_size;
+            return *slot;
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+        void pop_back() { m_data[--m_size].~T(); }
+
+        // by value so inserting an element of the vector itself survives growth
+        iterator insert(const_iterator pos, T value)
+        {
+            const size_type index = pos - m_data;
+            emplace_back(std::move(value));
+            std::rotate(m_data + index, m_data + m_size - 1, m_data + m_size);
+            return m_data + index;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            const size_type index = pos - m_data;
+            std::move(m_data + index + 1, m_data + m_size, m_data + index);
+            pop_back();
+            return m_data + index;
+        }
+
+    private:
+        void moveFrom(small_vector&& other) noexcept
+        {
+            if (other.m_data != other.inlineData()) {
+                // steal the heap buffer
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_capacity = other.m_capacity;
+            } else {
+                for (size_type i = 0; i < other.m_size; ++i)
+                    new (m_data + i) T(std::move(other.m_data[i]));
+                m_size = other.m_size;
+                std::destroy(other.begin(), other.end());
+            }
+
+            other.m_data = other.inlineData();
+            other.m_size = 0;
+            other.m_capacity = N;
+        }
+
+        void grow(size_type newCapacity)
+        {
+            T* newData = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+            for (size_type i = 0; i < m_size; ++i) {
+                new (newData + i) T(std::move(m_data[i]));
+                m_data[i].~T();
+            }
+
+            if (m_data != inlineData())
+                ::operator delete(m_data);
+
+            m_data = newData;
+            m_capacity = newCapacity;
+        }
+
+        void reset()
+        {
+            clear();
+            if (m_data != inlineData()) {
+                ::operator delete(m_data);
+                m_data = inlineData();
+                m_capacity = N;
+            }
+        }
+
+        T* inlineData() { return reinterpret_cast<T*>(m_storage); }
+
+        alignas(T) std::byte m_storage[N * sizeof(T)];
+        T* m_data{ inlineData() };
+        size_type m_size{ 0 };
+        size_type m_capacity{ N };
+    };
+}
@@ -23,6 +23,9 @@
 #pragma once
 
 #include "../pch.h"
+#include "smallvector.h"
+
+#include <variant>
 
 namespace stdext
 {
@@ -41,36 +44,62 @@ namespace stdext
     template<typename T>
     concept OnlyEnum = std::is_enum_v<T>;
 
-    template<OnlyEnum Key>
+    // typed attribute store: a handful of inline (key, value) slots with the
+    // value packed into a variant of the types the owner declares; instances
+    // rarely hold more than a few entries, so lookups are a short linear scan
+    // and typed reads never allocate or throw
+    template<OnlyEnum Key, typename... Types>
     class dynamic_storage
     {
     public:
         template<typename T>
-        void set(const Key& key, const T& value) { m_data[key] = value; }
-
-        bool remove(const Key& k) { return m_data.erase(k) > 0; }
+        void set(const Key& key, const T& value)
+        {
+            for (auto& [k, v] : m_data) {
+                if (k == key) {
+                    v = value;
+                    return;
+                }
+            }
+            m_data.emplace_back(key, value);
+        }
 
-        template<typename T> T get(const Key& k, const T defaultValue = T()) const
+        bool remove(const Key& key)
         {
-            auto it = m_data.find(k);
-            if (it == m_data.end()) {
-                return defaultValue;
+            for (auto it = m_data.begin(); it != m_data.end(); ++it) {
+                if (it->first == key) {
+                    m_data.erase(it);
+                    return true;
+                }
             }
+            return false;
+        }
 
-            try {
-                return std::any_cast<T>(it->second);
-            } catch (const std::exception&) {
-                return defaultValue;
+        template<typename T> T get(const Key& key, const T defaultValue = T()) const
+        {
+            for (const auto& [k, v] : m_data) {
+                if (k == key) {
+                    const auto* value = std::get_if<T>(&v);
+                    return value ? *value : defaultValue;
+                }
             }
+            return defaultValue;
         }
 
-        bool has(const Key& k) const { return m_data.contains(k); }
+        bool has(const Key& key) const
+        {
+            for (const auto& [k, v] : m_data) {
+                if (k == key)
+                    return true;
+            }
+            return false;
+        }
 
-        size_t size() const { return m_data.count(); }
+        size_t size() const { return m_data.size(); }
 
         void clear() { m_data.clear(); }
 
     private:
-        stdext::map<Key, std::any> m_data;
+        small_vector<std::pair<Key, std::variant<Types...>>, 4> m_data;
     };
 }
@@ -25,6 +25,7 @@
 
 #include "exception.h"
 #include "format.h"
+#include "string.h"
 #include "types.h"
 
 #ifdef _MSC_VER
@@ -36,16 +37,19 @@ namespace stdext
     std::string resolve_path(const std::string_view filePath, std::string_view sourcePath)
     {
         if (filePath.starts_with("/"))
-            return filePath.data();
+            return std::string{ filePath };
 
-        std::string _sourcePath(sourcePath);
         if (!sourcePath.ends_with("/")) {
             const std::size_t slashPos = sourcePath.find_last_of('/');
-            if (slashPos == std::string::npos)
+            if (slashPos == std::string_view::npos)
                 throw Exception("invalid source path '%s', for file '%s'", sourcePath, filePath);
-            _sourcePath = sourcePath.substr(0, slashPos + 1);
+            sourcePath = sourcePath.substr(0, slashPos + 1);
         }
-        return _sourcePath + filePath.data();
+
+        std::string result;
+        result.reserve(sourcePath.size() + filePath.size());
+        result.append(sourcePath).append(filePath);
+        return result;
     }
 
     std::string date_time_string(const char* format/* = "%b %d %Y %H:%M:%S"*/)
@@ -223,6 +227,51 @@ namespace stdext
         std::erase_if(str, isspace);
     }
 
+    std::string_view ltrim_view(std::string_view s)
+    {
+        while (!s.empty() && std::isspace(static_cast<uint8_t>(s.front())))
+            s.remove_prefix(1);
+        return s;
+    }
+
+    std::string_view rtrim_view(std::string_view s)
+    {
+        while (!s.empty() && std::isspace(static_cast<uint8_t>(s.back())))
+            s.remove_suffix(1);
+        return s;
+    }
+
+    std::string_view trim_view(std::string_view s)
+    {
+        return rtrim_view(ltrim_view(s));
+    }
+
+    bool iequals(const std::string_view a, const std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (::tolower(static_cast<uint8_t>(a[i])) != ::tolower(static_cast<uint8_t>(b[i])))
+                return false;
+        }
+        return true;
+    }
+
+    void split_view(const std::string_view str, split_string_views& out, const std::string_view separators)
+    {
+        size_t found = str.find(separators);
+        size_t startIndex = 0;
+
+        while (found != std::string_view::npos) {
+            out.emplace_back(str.substr(startIndex, found - startIndex));
+            startIndex = found + separators.size();
+            found = str.find(separators, startIndex);
+        }
+        if (startIndex != str.size())
+            out.emplace_back(str.substr(startIndex));
+    }
+
     std::vector<std::string> split(const std::string_view str, const std::string_view separators)
     {
         std::vector<std::string> result;
@@ -23,9 +23,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "cast.h"
+#include "smallvector.h"
 #include "types.h"
 
 namespace stdext
@@ -60,6 +62,19 @@ namespace stdext
     std::wstring latin1_to_utf16(const std::string_view src);
 #endif
 
+    // view variants of the trim helpers; the returned view aliases the
+    // input and must not outlive it
+    std::string_view ltrim_view(std::string_view s);
+    std::string_view rtrim_view(std::string_view s);
+    std::string_view trim_view(std::string_view s);
+
+    /// case-insensitive equality without lowercasing either side
+    bool iequals(std::string_view a, std::string_view b);
+
+    // splits into caller-provided inline storage, yielding views into str
+    using split_string_views = small_vector<std::string_view, 8>;
+    void split_view(std::string_view str, split_string_views& out, std::string_view separators = " ");
+
     // always returns at least one element in vector
     std::vector<std::string> split(const std::string_view str, const std::string_view separators = " ");
     template<typename T> std::vector<T> split(const std::string_view str, const std::string_view separators = " ")
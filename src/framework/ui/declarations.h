@@ -29,6 +29,8 @@ enum class DrawPoolType : uint8_t;
 class UIManager;
 class UIWidget;
 class UITextEdit;
+class UIConsoleBuffer;
+class UITween;
 class UILayout;
 class UIBoxLayout;
 class UIHorizontalLayout;
@@ -42,6 +44,8 @@ class UIParticles;
 using UIWidgetPtr = std::shared_ptr<UIWidget>;
 using UIParticlesPtr = std::shared_ptr<UIParticles>;
 using UITextEditPtr = std::shared_ptr<UITextEdit>;
+using UIConsoleBufferPtr = std::shared_ptr<UIConsoleBuffer>;
+using UITweenPtr = std::shared_ptr<UITween>;
 using UILayoutPtr = std::shared_ptr<UILayout>;
 using UIBoxLayoutPtr = std::shared_ptr<UIBoxLayout>;
 using UIHorizontalLayoutPtr = std::shared_ptr<UIHorizontalLayout>;
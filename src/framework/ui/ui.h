@@ -23,11 +23,13 @@
 #pragma once
 
 #include "uianchorlayout.h"
+#include "uiconsolebuffer.h"
 #include "uigridlayout.h"
 #include "uihorizontallayout.h"
 #include "uilayout.h"
 #include "uimanager.h"
 #include "uiparticles.h"
 #include "uitextedit.h"
+#include "uitween.h"
 #include "uiverticallayout.h"
 #include "uiwidget.h"
@@ -120,12 +120,14 @@ void UIAnchorLayout::addAnchor(const UIWidgetPtr& anchoredWidget, Fw::AnchorEdge
     anchorGroup->addAnchor(std::make_shared<UIAnchor>(anchoredEdge, hookedWidgetId, hookedEdge));
 
     // layout must be updated because a new anchor got in
+    invalidateSortedGroups();
     update();
 }
 
 void UIAnchorLayout::removeAnchors(const UIWidgetPtr& anchoredWidget)
 {
     m_anchorsGroups.erase(anchoredWidget);
+    invalidateSortedGroups();
     update();
 }
 
@@ -150,6 +152,8 @@ void UIAnchorLayout::fill(const UIWidgetPtr& anchoredWidget, const std::string_v
 
 void UIAnchorLayout::addWidget(const UIWidgetPtr&)
 {
+    // hooks resolved by id or next/prev may now point elsewhere
+    invalidateSortedGroups();
     update();
 }
 
@@ -246,16 +250,58 @@ bool UIAnchorLayout::updateWidget(const UIWidgetPtr& widget, const UIAnchorGroup
     return widget->setRect(newRect);
 }
 
+void UIAnchorLayout::collectSortedGroup(const UIWidgetPtr& widget, const UIAnchorGroupPtr& anchorGroup,
+                                        stdext::map<UIWidgetPtr, bool>& visited)
+{
+    auto& wasVisited = visited[widget];
+    if (wasVisited)
+        return;
+    wasVisited = true;
+
+    const auto& parentWidget = getParentWidget();
+    for (const auto& anchor : anchorGroup->getAnchors()) {
+        if (anchor->getHookedEdge() == Fw::AnchorNone)
+            continue;
+
+        const auto& hookedWidget = anchor->getHookedWidget(widget, parentWidget);
+        if (!hookedWidget || hookedWidget == parentWidget)
+            continue;
+
+        const auto it = m_anchorsGroups.find(hookedWidget);
+        if (it != m_anchorsGroups.end())
+            collectSortedGroup(hookedWidget, it->second, visited);
+    }
+
+    m_sortedGroups.emplace_back(widget, anchorGroup);
+}
+
+void UIAnchorLayout::rebuildSortedGroups()
+{
+    m_sortedGroups.clear();
+    m_sortedGroups.reserve(m_anchorsGroups.size());
+    m_sortedGroupsDirty = false;
+
+    stdext::map<UIWidgetPtr, bool> visited;
+    for (const auto& [widget, anchorGroup] : m_anchorsGroups)
+        collectSortedGroup(widget, anchorGroup, visited);
+}
+
 bool UIAnchorLayout::internalUpdate()
 {
+    if (m_sortedGroupsDirty)
+        rebuildSortedGroups();
+
     // reset all anchors groups update state
     for (auto& it : m_anchorsGroups)
         it.second->setUpdated(false);
 
     bool changed = false;
 
-    // update all anchors
-    for (const auto& [widget, anchorGroup] : m_anchorsGroups) {
+    // groups come pre-sorted in dependency order, so every hooked widget is
+    // already laid out when its dependents run; updateWidget only recurses
+    // when the cached order went stale (e.g. a next/prev hook after a child
+    // reorder), which keeps the result correct until the next rebuild
+    for (const auto& [widget, anchorGroup] : m_sortedGroups) {
         if (anchorGroup->isUpdated())
             continue;
 
@@ -84,4 +84,17 @@ protected:
     bool internalUpdate() override;
     virtual bool updateWidget(const UIWidgetPtr& widget, const UIAnchorGroupPtr& anchorGroup, UIWidgetPtr first = nullptr);
     stdext::map<UIWidgetPtr, UIAnchorGroupPtr> m_anchorsGroups;
+
+    // subclasses inserting into m_anchorsGroups directly must call this
+    void invalidateSortedGroups() { m_sortedGroupsDirty = true; }
+
+private:
+    void rebuildSortedGroups();
+    void collectSortedGroup(const UIWidgetPtr& widget, const UIAnchorGroupPtr& anchorGroup,
+                            stdext::map<UIWidgetPtr, bool>& visited);
+
+    // anchor groups in dependency order, so each pass is a linear sweep;
+    // rebuilt only when anchors or widgets change
+    std::vector<std::pair<UIWidgetPtr, UIAnchorGroupPtr>> m_sortedGroups;
+    bool m_sortedGroupsDirty{ true };
 };
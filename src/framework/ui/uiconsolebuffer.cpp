@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "uiconsolebuffer.h"
+#include <framework/graphics/bitmapfont.h>
+#include <framework/graphics/drawpoolmanager.h>
+
+namespace {
+    constexpr int MOUSE_WHEEL_ROWS = 3;
+}
+
+UIConsoleBuffer::UIConsoleBuffer()
+{
+    m_textAlign = Fw::AlignTopLeft;
+}
+
+void UIConsoleBuffer::drawSelf(const DrawPoolType drawPane)
+{
+    if (drawPane != DrawPoolType::FOREGROUND)
+        return;
+
+    UIWidget::drawSelf(DrawPoolType::FOREGROUND);
+
+    const auto& paddingRect = getPaddingRect();
+    const int width = paddingRect.width();
+    if (m_lines.empty() || width <= 0)
+        return;
+
+    const int lineHeight = rowHeight();
+
+    const auto& oldClipRect = g_drawPool.getClipRect();
+    g_drawPool.setClipRect(paddingRect);
+
+    // walk from the newest message upwards, wrapping only what can touch the
+    // viewport; lines above the top edge are never laid out or drawn
+    int bottom = paddingRect.bottom() + 1 + m_scrollOffset * lineHeight;
+    for (auto it = m_lines.rbegin(); it != m_lines.rend() && bottom > paddingRect.top(); ++it) {
+        ensureWrapped(*it, width);
+        const int height = it->rowCount * lineHeight;
+        bottom -= height;
+        if (bottom > paddingRect.bottom())
+            continue; // still below the scrolled viewport
+        m_font->drawText(it->wrapped, Rect(paddingRect.left(), bottom, width, height), it->color, Fw::AlignTopLeft);
+    }
+
+    g_drawPool.setClipRect(oldClipRect);
+}
+
+void UIConsoleBuffer::addLine(const std::string_view text, const Color& color)
+{
+    Line line;
+    line.text = text;
+    line.color = color;
+    m_lines.emplace_back(std::move(line));
+    while (m_lines.size() > m_maxLines)
+        m_lines.pop_front();
+
+    // while scrolled back, grow the offset so the view stays anchored
+    // instead of sliding as new lines arrive
+    if (m_scrollOffset > 0) {
+        const int width = getPaddingRect().width();
+        if (width > 0) {
+            ensureWrapped(m_lines.back(), width);
+            m_scrollOffset += m_lines.back().rowCount;
+        } else
+            ++m_scrollOffset;
+    }
+
+    repaint();
+}
+
+void UIConsoleBuffer::clearLines()
+{
+    m_lines.clear();
+    m_scrollOffset = 0;
+    repaint();
+}
+
+void UIConsoleBuffer::setMaxLines(const uint32_t maxLines)
+{
+    m_maxLines = std::max<uint32_t>(maxLines, 1);
+    while (m_lines.size() > m_maxLines)
+        m_lines.pop_front();
+    repaint();
+}
+
+void UIConsoleBuffer::setScrollOffset(int offset)
+{
+    offset = std::clamp<int>(offset, 0, getMaxScrollOffset());
+    if (offset == m_scrollOffset)
+        return;
+    m_scrollOffset = offset;
+    repaint();
+    callLuaField("onScrollChange", m_scrollOffset, getMaxScrollOffset());
+}
+
+std::string UIConsoleBuffer::getLine(const int index)
+{
+    if (index < 1 || index > static_cast<int>(m_lines.size()))
+        return {};
+    return m_lines[index - 1].text;
+}
+
+int UIConsoleBuffer::getTotalRowCount()
+{
+    const int width = getPaddingRect().width();
+    if (width <= 0)
+        return m_lines.size();
+
+    int rows = 0;
+    for (auto& line : m_lines) {
+        ensureWrapped(line, width);
+        rows += line.rowCount;
+    }
+    return rows;
+}
+
+int UIConsoleBuffer::getVisibleRowCount()
+{
+    const int lineHeight = rowHeight();
+    return lineHeight > 0 ? std::max<int>(getPaddingRect().height() / lineHeight, 1) : 1;
+}
+
+void UIConsoleBuffer::onStyleApply(const std::string_view styleName, const OTMLNodePtr& styleNode)
+{
+    UIWidget::onStyleApply(styleName, styleNode);
+
+    for (const auto& node : styleNode->children()) {
+        if (node->tag() == "max-lines")
+            setMaxLines(node->value<int>());
+    }
+}
+
+bool UIConsoleBuffer::onMouseWheel(const Point& mousePos, const Fw::MouseWheelDirection direction)
+{
+    if (direction == Fw::MouseWheelUp)
+        setScrollOffset(m_scrollOffset + MOUSE_WHEEL_ROWS);
+    else if (direction == Fw::MouseWheelDown)
+        setScrollOffset(m_scrollOffset - MOUSE_WHEEL_ROWS);
+    else
+        return UIWidget::onMouseWheel(mousePos, direction);
+    return true;
+}
+
+void UIConsoleBuffer::ensureWrapped(Line& line, const int width)
+{
+    if (line.wrapWidth == width)
+        return;
+    line.wrapped = m_font->wrapText(line.text, width);
+    line.rowCount = 1 + std::count(line.wrapped.begin(), line.wrapped.end(), '\n');
+    line.wrapWidth = width;
+}
+
+int UIConsoleBuffer::rowHeight() const
+{
+    return m_font->getGlyphHeight() + m_font->getGlyphSpacing().height();
+}
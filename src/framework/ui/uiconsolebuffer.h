@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "uiwidget.h"
+
+ // scrollback console that keeps its lines in a ring buffer instead of one
+ // child widget per message; appending is O(1) and drawing only lays out the
+ // rows that can touch the viewport, so scrollback depth never affects cost
+ // @bindclass
+class UIConsoleBuffer : public UIWidget
+{
+public:
+    UIConsoleBuffer();
+
+    void drawSelf(DrawPoolType drawPane) override;
+
+    void addLine(const std::string_view text, const Color& color);
+    void clearLines();
+
+    void setMaxLines(uint32_t maxLines);
+    void setScrollOffset(int offset);
+    void scroll(int rows) { setScrollOffset(m_scrollOffset + rows); }
+
+    uint32_t getMaxLines() { return m_maxLines; }
+    int getScrollOffset() { return m_scrollOffset; }
+    int getLineCount() { return m_lines.size(); }
+    std::string getLine(int index);
+    int getTotalRowCount();
+    int getVisibleRowCount();
+    int getMaxScrollOffset() { return std::max<int>(getTotalRowCount() - getVisibleRowCount(), 0); }
+
+protected:
+    void onStyleApply(const std::string_view styleName, const OTMLNodePtr& styleNode) override;
+    bool onMouseWheel(const Point& mousePos, Fw::MouseWheelDirection direction) override;
+
+private:
+    // one appended message; the wrap cache is rebuilt lazily whenever the
+    // width it was computed for no longer matches the widget
+    struct Line
+    {
+        std::string text;
+        Color color;
+        std::string wrapped;
+        int wrapWidth{ -1 };
+        int rowCount{ 1 };
+    };
+
+    void ensureWrapped(Line& line, int width);
+    int rowHeight() const;
+
+    std::deque<Line> m_lines;
+    uint32_t m_maxLines{ 1024 };
+    int m_scrollOffset{ 0 };
+};
@@ -52,6 +52,8 @@ void UIGridLayout::applyStyle(const OTMLNodePtr& styleNode)
             setAutoSpacing(node->value<bool>());
         else if (node->tag() == "flow")
             setFlow(node->value<bool>());
+        else if (node->tag() == "virtualized")
+            setVirtualized(node->value<bool>());
     }
 }
 
@@ -86,9 +88,23 @@ bool UIGridLayout::internalUpdate()
     if (m_autoSpacing && numColumns > 1)
         cellSpacing = (clippingRect.width() - numColumns * m_cellSize.width()) / (numColumns - 1);
 
+    // visible line window with one line of overscan on each side, so rows
+    // slide into the viewport already laid out
+    int firstLine = -1, lastLine = -1;
+    if (m_virtualized && m_cellSize.height() > 0) {
+        const int lineHeight = m_cellSize.height() + cellSpacing;
+        const int offsetY = parentWidget->getVirtualOffset().y;
+        firstLine = std::max<int>(offsetY / lineHeight - 1, 0);
+        lastLine = (offsetY + clippingRect.height()) / lineHeight + 1;
+    }
+    m_firstVisibleIndex = m_lastVisibleIndex = 0;
+
     int index = 0;
+    int childIndex = 0;
     int preferredHeight = 0;
     for (const auto& widget : widgets) {
+        ++childIndex;
+
         if (!widget->isExplicitlyVisible())
             continue;
 
@@ -96,6 +112,28 @@ bool UIGridLayout::internalUpdate()
         const int column = index % numColumns;
         const auto& virtualPos = Point(column * (m_cellSize.width() + cellSpacing), line * (m_cellSize.height() + cellSpacing));
         preferredHeight = virtualPos.y + m_cellSize.height();
+
+        ++index;
+
+        // off-viewport cells are not laid out at all; the only ones that
+        // cost a setRect are those parked out of a viewport they still
+        // overlap from a previous scroll position
+        if (firstLine >= 0 && (line < firstLine || line > lastLine)) {
+            if (widget->getRect().isValid() && clippingRect.intersects(widget->getRect())) {
+                const auto& pos = topLeft + virtualPos - parentWidget->getVirtualOffset();
+                if (widget->setRect(Rect(pos, m_cellSize)))
+                    changed = true;
+            }
+
+            if (m_numLines > 0 && index >= m_numColumns * m_numLines)
+                break;
+            continue;
+        }
+
+        if (m_firstVisibleIndex == 0)
+            m_firstVisibleIndex = childIndex;
+        m_lastVisibleIndex = childIndex;
+
         const auto& pos = topLeft + virtualPos - parentWidget->getVirtualOffset();
         auto dest = Rect(pos, m_cellSize);
         dest.expand(-widget->getMarginTop(), -widget->getMarginRight(), -widget->getMarginBottom(), -widget->getMarginLeft());
@@ -103,8 +141,6 @@ bool UIGridLayout::internalUpdate()
         if (widget->setRect(dest))
             changed = true;
 
-        ++index;
-
         if (m_numLines > 0 && index >= m_numColumns * m_numLines)
             break;
     }
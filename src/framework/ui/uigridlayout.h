@@ -43,11 +43,19 @@ public:
     void setAutoSpacing(bool enable) { m_autoSpacing = enable; update(); }
     void setFitChildren(bool enable) { m_fitChildren = enable; update(); }
     void setFlow(bool enable) { m_flow = enable; update(); }
+    void setVirtualized(bool enable) { m_virtualized = enable; update(); }
 
     Size getCellSize() { return m_cellSize; }
     uint8_t getCellSpacing() { return m_cellSpacing; }
     uint8_t getNumColumns() { return m_numColumns; }
     uint8_t getNumLines() { return m_numLines; }
+    bool isVirtualized() { return m_virtualized; }
+
+    // 1-based child indexes of the cells inside the viewport after the last
+    // update, 0 when nothing is visible; lua list modules use the range to
+    // rebind data into the few materialized rows while scrolling
+    int getFirstVisibleIndex() { return m_firstVisibleIndex; }
+    int getLastVisibleIndex() { return m_lastVisibleIndex; }
 
     bool isUIGridLayout() override { return true; }
 
@@ -56,10 +64,16 @@ protected:
 
 private:
     Size m_cellSize{ 16 };
+    int m_firstVisibleIndex{ 0 };
+    int m_lastVisibleIndex{ 0 };
     uint8_t m_cellSpacing{ 0 };
     uint8_t m_numColumns{ 1 };
     uint8_t m_numLines{ 0 };
     bool m_autoSpacing{ false };
     bool m_fitChildren{ false };
     bool m_flow{ false };
+
+    // when set, only cells around the viewport get their rects updated;
+    // off-viewport children are skipped in layout and stay out of draw
+    bool m_virtualized{ false };
 };
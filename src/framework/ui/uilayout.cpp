@@ -21,31 +21,35 @@
  */
 
 #include "uilayout.h"
+#include "uimanager.h"
 #include "uiwidget.h"
 
-#include <framework/core/eventdispatcher.h>
-
 void UILayout::update()
 {
     //logTraceCounter();
     if (!m_parentWidget)
         return;
 
-    /*
-    UIWidgetPtr parent = parentWidget;
-    do {
-        UILayoutPtr ownerLayout = parent->getLayout();
-        if(ownerLayout && ownerLayout->isUpdateDisabled())
-            return;
-        parent = parent->getParent();
-    } while(parent);
-    */
+    if (m_updateDisabled || m_updateScheduled)
+        return;
+
+    // just mark the layout dirty; the manager flushes every pending layout
+    // once per frame, so filling a container with a hundred widgets costs a
+    // single layout pass instead of a hundred
+    m_updateScheduled = true;
+    g_ui.scheduleLayoutUpdate(static_self_cast<UILayout>());
+}
+
+void UILayout::updateNow()
+{
+    m_updateScheduled = false;
 
-    if (m_updateDisabled)
+    if (!m_parentWidget || m_parentWidget->isDestroyed() || m_updateDisabled)
         return;
 
     if (m_updating) {
-        updateLater();
+        // reschedule for the next flush round
+        update();
         return;
     }
 
@@ -57,16 +61,5 @@ void UILayout::update()
 
 void UILayout::updateLater()
 {
-    if (m_updateDisabled || m_updateScheduled)
-        return;
-
-    if (!getParentWidget())
-        return;
-
-    auto self = static_self_cast<UILayout>();
-    g_dispatcher.addEvent([self] {
-        self->m_updateScheduled = false;
-        self->update();
-    });
-    m_updateScheduled = true;
+    update();
 }
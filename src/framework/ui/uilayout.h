@@ -35,6 +35,9 @@ public:
     UILayout(UIWidgetPtr parentWidget) : m_parentWidget(std::move(parentWidget)) { }
 
     void update();
+    // computes the layout immediately; normally only the manager's frame
+    // flush calls this, everything else marks dirty through update()
+    void updateNow();
     void updateLater();
 
     virtual void applyStyle(const OTMLNodePtr& /*styleNode*/) {}
@@ -24,6 +24,7 @@
 #include "ui.h"
 
 #include <framework/core/application.h>
+#include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/drawpoolmanager.h>
@@ -54,6 +55,38 @@ void UIManager::terminate()
     m_styles.clear();
     m_destroyedWidgets.clear();
     m_checkEvent = nullptr;
+    m_tweens.clear();
+
+    std::scoped_lock lock(m_layoutMutex);
+    m_pendingLayouts.clear();
+}
+
+void UIManager::scheduleLayoutUpdate(const UILayoutPtr& layout)
+{
+    std::scoped_lock lock(m_layoutMutex);
+    m_pendingLayouts.emplace_back(layout);
+}
+
+void UIManager::flushLayoutUpdates()
+{
+    // a layout pass can invalidate other layouts (children resizing their
+    // parent), so keep flushing until the set settles, but only a few
+    // rounds per frame; leftovers stay scheduled for the next one
+    for (int round = 0; round < 3; ++round) {
+        std::vector<UILayoutPtr> pending;
+        {
+            std::scoped_lock lock(m_layoutMutex);
+            if (m_pendingLayouts.empty())
+                return;
+            pending.swap(m_pendingLayouts);
+        }
+
+        for (const auto& layout : pending)
+            layout->updateNow();
+
+        // rects moved, the hit-test grid must be rebuilt
+        invalidateHitIndex();
+    }
 }
 
 void UIManager::render(DrawPoolType drawPane) const
@@ -71,6 +104,9 @@ void UIManager::resize(const Size&) const
 
 void UIManager::inputEvent(const InputEvent& event)
 {
+    // hit-testing needs up-to-date rects
+    flushLayoutUpdates();
+
     UIWidgetList widgetList;
     switch (event.type) {
         case Fw::KeyTextInputEvent:
@@ -86,8 +122,10 @@ void UIManager::inputEvent(const InputEvent& event)
             m_keyboardReceiver->propagateOnKeyUp(event.keyCode, event.keyboardModifiers);
             break;
         case Fw::MousePressInputEvent:
+            flushMouseMove();
             if (event.mouseButton == Fw::MouseLeftButton && m_mouseReceiver->isVisible()) {
-                auto pressedWidget = m_mouseReceiver->recursiveGetChildByPos(event.mousePos, false);
+                auto pressedWidget = m_mouseReceiver == m_rootWidget ? hitTest(event.mousePos)
+                    : m_mouseReceiver->recursiveGetChildByPos(event.mousePos, false);
                 if (pressedWidget && !pressedWidget->isEnabled())
                     pressedWidget = nullptr;
 
@@ -104,6 +142,8 @@ void UIManager::inputEvent(const InputEvent& event)
             break;
         case Fw::MouseReleaseInputEvent:
         {
+            flushMouseMove();
+
             // release dragging widget
             bool accepted = false;
             if (m_draggingWidget && event.mouseButton == Fw::MouseLeftButton)
@@ -131,37 +171,14 @@ void UIManager::inputEvent(const InputEvent& event)
             break;
         }
         case Fw::MouseMoveInputEvent:
-        {
-            // start dragging when moving a pressed widget
-            if (m_pressedWidget && m_pressedWidget->isDraggable() && m_draggingWidget != m_pressedWidget) {
-                // only drags when moving more than 4 pixels
-                if ((event.mousePos - m_pressedWidget->getLastClickPosition()).length() >= 4)
-                    updateDraggingWidget(m_pressedWidget, event.mousePos - event.mouseMoved);
-            }
-
-            // mouse move can change hovered widgets
-            updateHoveredWidget(true);
-
-            // first fire dragging move
-            if (m_draggingWidget) {
-                if (m_draggingWidget->onDragMove(event.mousePos, event.mouseMoved))
-                    break;
-            }
-
-            if (m_pressedWidget) {
-                if (m_pressedWidget->onMouseMove(event.mousePos, event.mouseMoved)) {
-                    break;
-                }
-            }
-
-            m_mouseReceiver->propagateOnMouseMove(event.mousePos, event.mouseMoved, widgetList);
-            for (const auto& widget : widgetList) {
-                if (widget->onMouseMove(event.mousePos, event.mouseMoved))
-                    break;
-            }
+            // the window can queue many moves per frame; keep only the last
+            // position with the summed delta and dispatch once per poll
+            m_pendingMousePos = event.mousePos;
+            m_pendingMouseMoved += event.mouseMoved;
+            m_mouseMovePending = true;
             break;
-        }
         case Fw::MouseWheelInputEvent:
+            flushMouseMove();
             m_rootWidget->propagateOnMouseEvent(event.mousePos, widgetList);
             for (const auto& widget : widgetList) {
                 if (widget->onMouseWheel(event.mousePos, event.wheelDirection))
@@ -173,6 +190,132 @@ void UIManager::inputEvent(const InputEvent& event)
     }
 }
 
+void UIManager::flushMouseMove()
+{
+    if (!m_mouseMovePending)
+        return;
+
+    m_mouseMovePending = false;
+    handleMouseMove(m_pendingMousePos, m_pendingMouseMoved);
+    m_pendingMouseMoved = {};
+}
+
+void UIManager::addTween(const UITweenPtr& tween)
+{
+    if (std::find(m_tweens.begin(), m_tweens.end(), tween) == m_tweens.end())
+        m_tweens.emplace_back(tween);
+}
+
+void UIManager::removeTween(const UITweenPtr& tween)
+{
+    std::erase(m_tweens, tween);
+}
+
+void UIManager::updateTweens()
+{
+    if (m_tweens.empty())
+        return;
+
+    const ticks_t now = g_clock.millis();
+
+    // indexed loop because an onFinish callback may start new tweens
+    for (size_t i = 0; i < m_tweens.size();) {
+        if (m_tweens[i]->update(now))
+            ++i;
+        else
+            m_tweens.erase(m_tweens.begin() + i);
+    }
+}
+
+void UIManager::handleMouseMove(const Point& mousePos, const Point& mouseMoved)
+{
+    // start dragging when moving a pressed widget
+    if (m_pressedWidget && m_pressedWidget->isDraggable() && m_draggingWidget != m_pressedWidget) {
+        // only drags when moving more than 4 pixels
+        if ((mousePos - m_pressedWidget->getLastClickPosition()).length() >= 4)
+            updateDraggingWidget(m_pressedWidget, mousePos - mouseMoved);
+    }
+
+    // mouse move can change hovered widgets
+    updateHoveredWidget(true);
+
+    // first fire dragging move
+    if (m_draggingWidget) {
+        if (m_draggingWidget->onDragMove(mousePos, mouseMoved))
+            return;
+    }
+
+    if (m_pressedWidget) {
+        if (m_pressedWidget->onMouseMove(mousePos, mouseMoved))
+            return;
+    }
+
+    UIWidgetList widgetList;
+    m_mouseReceiver->propagateOnMouseMove(mousePos, mouseMoved, widgetList);
+    for (const auto& widget : widgetList) {
+        if (widget->onMouseMove(mousePos, mouseMoved))
+            break;
+    }
+}
+
+UIWidgetPtr UIManager::hitTest(const Point& pos)
+{
+    if (pos.x < 0 || pos.y < 0)
+        return nullptr;
+
+    std::scoped_lock lock(m_hitIndexMutex);
+
+    if (m_hitIndexDirty.exchange(false, std::memory_order_relaxed))
+        rebuildHitIndex();
+
+    const auto it = m_hitIndex.find(hitIndexCell(pos.x, pos.y));
+    if (it == m_hitIndex.end())
+        return nullptr;
+
+    // entries are in paint order, so the first match scanning backwards is
+    // the topmost widget under the point
+    for (auto entry = it->second.rbegin(); entry != it->second.rend(); ++entry) {
+        if (entry->rect.contains(pos) && !entry->widget->isPhantom())
+            return entry->widget;
+    }
+    return nullptr;
+}
+
+void UIManager::rebuildHitIndex()
+{
+    m_hitIndex.clear();
+    if (!m_rootWidget)
+        return;
+
+    const auto& clipRect = m_rootWidget->getPaddingRect();
+    for (const auto& child : m_rootWidget->m_children)
+        indexWidget(child, clipRect);
+}
+
+void UIManager::indexWidget(const UIWidgetPtr& widget, const Rect& clipRect)
+{
+    if (!widget->isExplicitlyVisible() || widget->isDestroyed())
+        return;
+
+    // same reachability rule as recursiveGetChildByPos: the point must lie
+    // inside the widget rect and inside every ancestor rect and padding rect
+    const auto& rect = widget->getRect().intersection(clipRect);
+    if (!rect.isValid())
+        return;
+
+    for (int cy = rect.top() / HIT_INDEX_CELL_SIZE; cy <= rect.bottom() / HIT_INDEX_CELL_SIZE; ++cy) {
+        for (int cx = rect.left() / HIT_INDEX_CELL_SIZE; cx <= rect.right() / HIT_INDEX_CELL_SIZE; ++cx)
+            m_hitIndex[(cy << 16) | cx].emplace_back(HitEntry{ widget, rect });
+    }
+
+    const auto& childClip = rect.intersection(widget->getPaddingRect());
+    if (!childClip.isValid())
+        return;
+
+    for (const auto& child : widget->m_children)
+        indexWidget(child, childClip);
+}
+
 void UIManager::updatePressedWidget(const UIWidgetPtr& newPressedWidget, const Point& clickedPos, bool fireClicks)
 {
     const UIWidgetPtr oldPressedWidget = m_pressedWidget;
@@ -234,7 +377,7 @@ void UIManager::updateHoveredWidget(bool now)
 
         m_hoverUpdateScheduled = false;
         //if(!g_window.isMouseButtonPressed(Fw::MouseLeftButton) && !g_window.isMouseButtonPressed(Fw::MouseRightButton)) {
-        auto hoveredWidget = m_rootWidget->recursiveGetChildByPos(g_window.getMousePosition(), false);
+        auto hoveredWidget = hitTest(g_window.getMousePosition());
         if (hoveredWidget && !hoveredWidget->isEnabled())
             hoveredWidget = nullptr;
         //}
@@ -275,6 +418,11 @@ void UIManager::onWidgetDisappear(const UIWidgetPtr& widget)
 
 void UIManager::onWidgetDestroy(const UIWidgetPtr& widget)
 {
+    invalidateHitIndex();
+
+    // drop any running tween targeting the destroyed widget
+    std::erase_if(m_tweens, [&](const UITweenPtr& tween) { return tween->getWidget() == widget; });
+
     // release input grabs
     if (m_keyboardReceiver == widget)
         resetKeyboardReceiver();
@@ -301,18 +449,39 @@ void UIManager::onWidgetDestroy(const UIWidgetPtr& widget)
 
     m_checkEvent = g_dispatcher.scheduleEvent([this] {
         g_lua.collectGarbage();
-        UIWidgetList backupList = m_destroyedWidgets;
-        m_destroyedWidgets.clear();
-        g_dispatcher.scheduleEvent([backupList] {
+        g_dispatcher.scheduleEvent([this] {
+            // the second collect pass releases userdata that needed the
+            // first one to clear their __gc metamethods
             g_lua.collectGarbage();
-            for (const auto& widget : backupList) {
-                if (widget.use_count() != 1)
-                    g_logger.warning(stdext::format("widget '%s' destroyed but still have %d reference(s) left", widget->getId(), widget.use_count() - 1));
-            }
+            if (!m_releaseEvent || m_releaseEvent->isExecuted())
+                releaseDestroyedWidgets();
         }, 1);
     }, 1000);
 }
 
+void UIManager::releaseDestroyedWidgets()
+{
+    // dropping the final references of a big closed window all at once
+    // (the market alone holds ~2000 widgets) spikes the frame it lands on,
+    // so the queue drains in budgeted slices, one per poll cycle
+    static constexpr size_t RELEASE_BUDGET = 64;
+
+    {
+        const size_t count = std::min<size_t>(m_destroyedWidgets.size(), RELEASE_BUDGET);
+        const UIWidgetList releasing(std::make_move_iterator(m_destroyedWidgets.begin()),
+                                     std::make_move_iterator(m_destroyedWidgets.begin() + count));
+        m_destroyedWidgets.erase(m_destroyedWidgets.begin(), m_destroyedWidgets.begin() + count);
+
+        for (const auto& widget : releasing) {
+            if (widget.use_count() != 1)
+                g_logger.warning(stdext::format("widget '%s' destroyed but still have %d reference(s) left", widget->getId(), widget.use_count() - 1));
+        }
+    } // the popped references die here
+
+    if (!m_destroyedWidgets.empty())
+        m_releaseEvent = g_dispatcher.scheduleEvent([this] { releaseDestroyedWidgets(); }, 1);
+}
+
 void UIManager::clearStyles()
 {
     m_styles.clear();
@@ -350,17 +519,15 @@ bool UIManager::importStyle(const std::string& fl, bool checkDeviceStyles)
 void UIManager::importStyleFromOTML(const OTMLNodePtr& styleNode)
 {
     const std::string tag = styleNode->tag();
-    const std::vector<std::string> split = stdext::split(tag, "<");
+    stdext::split_string_views split;
+    stdext::split_view(tag, split, "<");
     if (split.size() != 2)
         throw OTMLException(styleNode, "not a valid style declaration");
 
-    std::string name = split[0];
-    std::string base = split[1];
+    std::string name{ stdext::trim_view(split[0]) };
+    std::string base{ stdext::trim_view(split[1]) };
     bool unique = false;
 
-    stdext::trim(name);
-    stdext::trim(base);
-
     if (name[0] == '#') {
         name = name.substr(1);
         unique = true;
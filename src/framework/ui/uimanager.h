@@ -38,6 +38,29 @@ public:
     void resize(const Size& size) const;
     void inputEvent(const InputEvent& event);
 
+    // @dontbind
+    void scheduleLayoutUpdate(const UILayoutPtr& layout);
+    // computes every layout marked dirty since the last flush; called by
+    // the poll loop once per frame and before input hit-testing
+    void flushLayoutUpdates();
+
+    // grid-indexed point lookup over the visible widget rects, equivalent
+    // to recursiveGetChildByPos from the root widget
+    UIWidgetPtr hitTest(const Point& pos);
+    void invalidateHitIndex() { m_hitIndexDirty.store(true, std::memory_order_relaxed); }
+    // @dontbind
+    // consecutive mouse moves within one poll cycle collapse into a single
+    // dispatch here, accumulated deltas included
+    void flushMouseMove();
+
+    // @dontbind
+    void addTween(const UITweenPtr& tween);
+    // @dontbind
+    void removeTween(const UITweenPtr& tween);
+    // advances every running widget tween; called once per frame from the
+    // poll loop
+    void updateTweens();
+
     void updatePressedWidget(const UIWidgetPtr& newPressedWidget, const Point& clickedPos = {}, bool fireClicks = true);
     bool updateDraggingWidget(const UIWidgetPtr& draggingWidget, const Point& clickedPos = {});
     void updateHoveredWidget(bool now = false);
@@ -74,6 +97,10 @@ public:
     bool isDrawingDebugBoxes() { return m_drawDebugBoxes; }
 
 protected:
+    void handleMouseMove(const Point& mousePos, const Point& mouseMoved);
+    void rebuildHitIndex();
+    void indexWidget(const UIWidgetPtr& widget, const Rect& clipRect);
+
     void onWidgetAppear(const UIWidgetPtr& widget);
     void onWidgetDisappear(const UIWidgetPtr& widget);
     void onWidgetDestroy(const UIWidgetPtr& widget);
@@ -90,8 +117,37 @@ private:
     bool m_hoverUpdateScheduled{ false };
     bool m_drawDebugBoxes{ false };
     stdext::map<std::string, OTMLNodePtr> m_styles;
+    void releaseDestroyedWidgets();
+
     UIWidgetList m_destroyedWidgets;
     ScheduledEventPtr m_checkEvent;
+    ScheduledEventPtr m_releaseEvent;
+
+    std::mutex m_layoutMutex;
+    std::vector<UILayoutPtr> m_pendingLayouts;
+
+    std::vector<UITweenPtr> m_tweens;
+
+    enum
+    {
+        HIT_INDEX_CELL_SIZE = 64
+    };
+
+    struct HitEntry
+    {
+        UIWidgetPtr widget;
+        Rect rect; // widget rect clipped by every ancestor
+    };
+
+    static uint32_t hitIndexCell(const int x, const int y) { return (y / HIT_INDEX_CELL_SIZE) << 16 | (x / HIT_INDEX_CELL_SIZE); }
+
+    std::mutex m_hitIndexMutex;
+    std::atomic_bool m_hitIndexDirty{ true };
+    stdext::map<uint32_t, std::vector<HitEntry>> m_hitIndex;
+
+    bool m_mouseMovePending{ false };
+    Point m_pendingMousePos;
+    Point m_pendingMouseMoved;
 };
 
 extern UIManager g_ui;
@@ -68,8 +68,10 @@ void UITextEdit::drawSelf(DrawPoolType drawPane)
     if (m_color != Color::alpha) {
         if (glyphsMustRecache) {
             m_glyphsTextRectCache.clear();
-            for (int i = -1; ++i < textLength;)
-                m_glyphsTextRectCache.emplace_back(m_glyphsCoords[i].first, m_glyphsCoords[i].second);
+            for (int i = -1; ++i < textLength;) {
+                if (m_glyphsCoords[i].first.isValid())
+                    m_glyphsTextRectCache.emplace_back(m_glyphsCoords[i].first, m_glyphsCoords[i].second);
+            }
         }
         for (const auto& [dest, src] : m_glyphsTextRectCache)
             g_drawPool.addTexturedRect(dest, texture, src, m_color);
@@ -78,8 +80,10 @@ void UITextEdit::drawSelf(DrawPoolType drawPane)
     if (hasSelection()) {
         if (glyphsMustRecache) {
             m_glyphsSelectRectCache.clear();
-            for (int i = m_selectionStart; i < m_selectionEnd; ++i)
-                m_glyphsSelectRectCache.emplace_back(m_glyphsCoords[i].first, m_glyphsCoords[i].second);
+            for (int i = m_selectionStart; i < m_selectionEnd; ++i) {
+                if (m_glyphsCoords[i].first.isValid())
+                    m_glyphsSelectRectCache.emplace_back(m_glyphsCoords[i].first, m_glyphsCoords[i].second);
+            }
         }
         for (const auto& [dest, src] : m_glyphsSelectRectCache)
             g_drawPool.addFilledRect(dest, m_selectionBackgroundColor);
@@ -109,6 +113,81 @@ void UITextEdit::drawSelf(DrawPoolType drawPane)
     }
 }
 
+const std::vector<Point>& UITextEdit::layoutGlyphs(const std::string& text, Size* textBoxSize)
+{
+    // incremental layout only handles the default top-left alignment;
+    // other alignments shift every line when the widest line changes, so
+    // they keep going through the font
+    if (m_textAlign != Fw::AlignTopLeft)
+        return m_font->calculateGlyphsPositions(text, m_textAlign, textBoxSize);
+
+    const int textLength = text.length();
+    const int glyphHeight = m_font->getGlyphHeight();
+
+    m_glyphsPositions.resize(textLength);
+
+    if (textLength == 0) {
+        m_lineLayouts.clear();
+        if (textBoxSize)
+            textBoxSize->resize(0, glyphHeight);
+        return m_glyphsPositions;
+    }
+
+    const Size* glyphsSize = m_font->getGlyphsSize();
+    const int spacingX = m_font->getGlyphSpacing().width();
+    const int lineHeight = glyphHeight + m_font->getGlyphSpacing().height();
+
+    int maxLineWidth = 0;
+    int line = 0;
+    int lineStart = 0;
+    int y = m_font->getYOffset();
+    for (int i = 0; i <= textLength; ++i) {
+        if (i < textLength && text[i] != '\n')
+            continue;
+
+        // [lineStart, i) is one line; relayout it only if its text changed
+        const std::string_view lineText(text.data() + lineStart, i - lineStart);
+        if (line >= static_cast<int>(m_lineLayouts.size()))
+            m_lineLayouts.resize(line + 1);
+
+        LineLayout& layout = m_lineLayouts[line];
+        if (layout.text != lineText) {
+            layout.text = lineText;
+            layout.glyphsX.resize(lineText.length());
+            int x = 0;
+            for (size_t j = 0; j < lineText.length(); ++j) {
+                layout.glyphsX[j] = x;
+                const auto glyph = static_cast<uint8_t>(lineText[j]);
+                if (glyph >= 32)
+                    x += glyphsSize[glyph].width() + spacingX;
+            }
+            layout.width = x > 0 ? x - spacingX : 0;
+        }
+
+        for (size_t j = 0; j < lineText.length(); ++j)
+            m_glyphsPositions[lineStart + j] = Point(layout.glyphsX[j], y);
+        maxLineWidth = std::max<int>(maxLineWidth, layout.width);
+
+        if (i < textLength) { // the '\n' maps to the start of the next line
+            y += lineHeight;
+            m_glyphsPositions[i] = Point(0, y);
+            ++line;
+            lineStart = i + 1;
+        }
+    }
+
+    // drop cached lines past the end so deleted text does not pin memory
+    if (static_cast<int>(m_lineLayouts.size()) > line + 1)
+        m_lineLayouts.resize(line + 1);
+
+    if (textBoxSize) {
+        textBoxSize->setWidth(maxLineWidth);
+        textBoxSize->setHeight(y + glyphHeight);
+    }
+
+    return m_glyphsPositions;
+}
+
 void UITextEdit::update(bool focusCursor)
 {
     if (!getProp(PropUpdatesEnabled))
@@ -128,9 +207,9 @@ void UITextEdit::update(bool focusCursor)
     // recache coords buffers
     recacheGlyphs();
 
-    // map glyphs positions
+    // map glyphs positions, reusing per-line layout for unchanged lines
     Size textBoxSize;
-    const auto& glyphsPositions = m_font->calculateGlyphsPositions(text, m_textAlign, &textBoxSize);
+    const auto& glyphsPositions = layoutGlyphs(text, &textBoxSize);
     const Rect* glyphsTextureCoords = m_font->getGlyphsTextureCoords();
     const Size* glyphsSize = m_font->getGlyphsSize();
     int glyph;
@@ -247,6 +326,7 @@ void UITextEdit::update(bool focusCursor)
     } else { // AlignLeft
     }
 
+    const int visibleBottom = m_textVirtualOffset.y + textScreenCoords.height();
     for (int i = 0; i < textLength; ++i) {
         glyph = static_cast<uint8_t>(text[i]);
         m_glyphsCoords[i].first.clear();
@@ -268,6 +348,14 @@ void UITextEdit::update(bool focusCursor)
             // nothing to do
         }
 
+        // glyph y positions are monotonic, so everything from the first
+        // glyph below the viewport onwards stays unmapped
+        if (glyphScreenCoords.top() > visibleBottom) {
+            for (int j = i + 1; j < textLength; ++j)
+                m_glyphsCoords[j].first.clear();
+            break;
+        }
+
         if (m_textAlign & Fw::AlignRight) {
             glyphScreenCoords.translate(textScreenCoords.width() - textBoxSize.width(), 0);
         } else if (m_textAlign & Fw::AlignHorizontalCenter) {
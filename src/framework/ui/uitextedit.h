@@ -120,7 +120,18 @@ private:
         PropGlyphsMustRecache = 1 << 10,
     };
 
+    // glyph layout cached per text line; only lines whose content changed
+    // are laid out again, so editing cost follows the edited line instead
+    // of the whole document
+    struct LineLayout
+    {
+        std::string text;
+        std::vector<int> glyphsX;
+        int width{ 0 };
+    };
+
     void updateDisplayedText();
+    const std::vector<Point>& layoutGlyphs(const std::string& text, Size* textBoxSize);
     void disableUpdates() { setProp(PropUpdatesEnabled, false); }
     void enableUpdates() { setProp(PropUpdatesEnabled, true); }
     void recacheGlyphs() { setProp(PropGlyphsMustRecache, true); }
@@ -146,6 +157,9 @@ private:
     Color m_selectionColor{ Color::white };
     Color m_selectionBackgroundColor{ Color::black };
 
+    std::vector<LineLayout> m_lineLayouts;
+    std::vector<Point> m_glyphsPositions;
+
     std::vector<std::pair<Rect, Rect>> m_glyphsCoords;
 
     std::vector<std::pair<Rect, Rect>> m_glyphsTextRectCache;
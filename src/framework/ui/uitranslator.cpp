@@ -23,107 +23,111 @@
 #include "uitranslator.h"
 #include <framework/stdext/string.h>
 
-Fw::AlignmentFlag Fw::translateAlignment(std::string aligment)
+Fw::AlignmentFlag Fw::translateAlignment(std::string_view aligment)
 {
-    stdext::tolower(aligment);
-    stdext::eraseWhiteSpace(aligment);
+    aligment = stdext::trim_view(aligment);
 
-    if (aligment == "topleft")
+    // interior whitespace ("top left") is rare, only then pay for a copy
+    std::string buffer;
+    if (aligment.find_first_of(" \t") != std::string_view::npos) {
+        buffer.assign(aligment);
+        stdext::eraseWhiteSpace(buffer);
+        aligment = buffer;
+    }
+
+    if (stdext::iequals(aligment, "topleft"))
         return AlignTopLeft;
 
-    if (aligment == "topright")
+    if (stdext::iequals(aligment, "topright"))
         return AlignTopRight;
 
-    if (aligment == "bottomleft")
+    if (stdext::iequals(aligment, "bottomleft"))
         return AlignBottomLeft;
 
-    if (aligment == "bottomright")
+    if (stdext::iequals(aligment, "bottomright"))
         return AlignBottomRight;
 
-    if (aligment == "left")
+    if (stdext::iequals(aligment, "left"))
         return AlignLeftCenter;
 
-    if (aligment == "right")
+    if (stdext::iequals(aligment, "right"))
         return AlignRightCenter;
 
-    if (aligment == "top")
+    if (stdext::iequals(aligment, "top"))
         return AlignTopCenter;
 
-    if (aligment == "bottom")
+    if (stdext::iequals(aligment, "bottom"))
         return AlignBottomCenter;
 
-    if (aligment == "center")
+    if (stdext::iequals(aligment, "center"))
         return AlignCenter;
 
     return AlignNone;
 }
 
-Fw::AnchorEdge Fw::translateAnchorEdge(std::string anchorEdge)
+Fw::AnchorEdge Fw::translateAnchorEdge(std::string_view anchorEdge)
 {
-    stdext::tolower(anchorEdge);
-    stdext::eraseWhiteSpace(anchorEdge);
+    anchorEdge = stdext::trim_view(anchorEdge);
 
-    if (anchorEdge == "left")
+    if (stdext::iequals(anchorEdge, "left"))
         return AnchorLeft;
 
-    if (anchorEdge == "right")
+    if (stdext::iequals(anchorEdge, "right"))
         return AnchorRight;
 
-    if (anchorEdge == "top")
+    if (stdext::iequals(anchorEdge, "top"))
         return AnchorTop;
 
-    if (anchorEdge == "bottom")
+    if (stdext::iequals(anchorEdge, "bottom"))
         return AnchorBottom;
 
-    if (anchorEdge == "horizontalcenter")
+    if (stdext::iequals(anchorEdge, "horizontalcenter"))
         return AnchorHorizontalCenter;
 
-    if (anchorEdge == "verticalcenter")
+    if (stdext::iequals(anchorEdge, "verticalcenter"))
         return AnchorVerticalCenter;
 
     return AnchorNone;
 }
 
-Fw::WidgetState Fw::translateState(std::string state)
+Fw::WidgetState Fw::translateState(std::string_view state)
 {
-    stdext::tolower(state);
-    stdext::trim(state);
-    if (state == "active")
+    state = stdext::trim_view(state);
+    if (stdext::iequals(state, "active"))
         return ActiveState;
-    if (state == "focus")
+    if (stdext::iequals(state, "focus"))
         return FocusState;
-    if (state == "hover")
+    if (stdext::iequals(state, "hover"))
         return HoverState;
-    if (state == "pressed")
+    if (stdext::iequals(state, "pressed"))
         return PressedState;
-    if (state == "checked")
+    if (stdext::iequals(state, "checked"))
         return CheckedState;
-    if (state == "disabled")
+    if (stdext::iequals(state, "disabled"))
         return DisabledState;
-    if (state == "on")
+    if (stdext::iequals(state, "on"))
         return OnState;
-    if (state == "first")
+    if (stdext::iequals(state, "first"))
         return FirstState;
-    if (state == "middle")
+    if (stdext::iequals(state, "middle"))
         return MiddleState;
-    if (state == "last")
+    if (stdext::iequals(state, "last"))
         return LastState;
-    if (state == "alternate")
+    if (stdext::iequals(state, "alternate"))
         return AlternateState;
-    if (state == "dragging")
+    if (stdext::iequals(state, "dragging"))
         return DraggingState;
-    if (state == "hidden")
+    if (stdext::iequals(state, "hidden"))
         return HiddenState;
     return InvalidState;
 }
 
-Fw::AutoFocusPolicy Fw::translateAutoFocusPolicy(std::string policy)
+Fw::AutoFocusPolicy Fw::translateAutoFocusPolicy(std::string_view policy)
 {
-    stdext::tolower(policy);
-    stdext::trim(policy);
-    if (policy == "first")
+    policy = stdext::trim_view(policy);
+    if (stdext::iequals(policy, "first"))
         return AutoFocusFirst;
-    if (policy == "last")
+    if (stdext::iequals(policy, "last"))
         return AutoFocusLast;
     return AutoFocusNone;
 }
@@ -22,13 +22,13 @@
 
 #pragma once
 
-#include <string>
+#include <string_view>
 #include "../const.h"
 
 namespace Fw
 {
-    AlignmentFlag translateAlignment(std::string aligment);
-    AnchorEdge translateAnchorEdge(std::string anchorEdge);
-    WidgetState translateState(std::string state);
-    AutoFocusPolicy translateAutoFocusPolicy(std::string policy);
+    AlignmentFlag translateAlignment(std::string_view aligment);
+    AnchorEdge translateAnchorEdge(std::string_view anchorEdge);
+    WidgetState translateState(std::string_view state);
+    AutoFocusPolicy translateAutoFocusPolicy(std::string_view policy);
 };
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "uitween.h"
+#include "uimanager.h"
+#include "uiwidget.h"
+
+#include <framework/core/clock.h>
+
+UITween::UITween(UIWidgetPtr widget) : m_widget(std::move(widget)) {}
+
+UITweenPtr UITween::fadeTo(const float opacity)
+{
+    m_tweenOpacity = true;
+    m_toOpacity = std::clamp<float>(opacity, 0.f, 1.f);
+    return static_self_cast<UITween>();
+}
+
+UITweenPtr UITween::moveTo(const Point& pos)
+{
+    m_tweenPos = true;
+    m_toPos = pos;
+    return static_self_cast<UITween>();
+}
+
+UITweenPtr UITween::colorTo(const Color& color)
+{
+    m_tweenColor = true;
+    m_toColor = color;
+    return static_self_cast<UITween>();
+}
+
+UITweenPtr UITween::setDuration(const int duration)
+{
+    m_duration = std::max<int>(duration, 1);
+    return static_self_cast<UITween>();
+}
+
+UITweenPtr UITween::setDelay(const int delay)
+{
+    m_delay = std::max<int>(delay, 0);
+    return static_self_cast<UITween>();
+}
+
+UITweenPtr UITween::setEasing(const std::string_view name)
+{
+    if (name == "linear")
+        m_easing = Easing::Linear;
+    else if (name == "inQuad")
+        m_easing = Easing::InQuad;
+    else if (name == "outQuad")
+        m_easing = Easing::OutQuad;
+    else if (name == "inOutQuad")
+        m_easing = Easing::InOutQuad;
+    else if (name == "inCubic")
+        m_easing = Easing::InCubic;
+    else if (name == "outCubic")
+        m_easing = Easing::OutCubic;
+    else if (name == "inOutCubic")
+        m_easing = Easing::InOutCubic;
+    else if (name == "inSine")
+        m_easing = Easing::InSine;
+    else if (name == "outSine")
+        m_easing = Easing::OutSine;
+    else if (name == "inOutSine")
+        m_easing = Easing::InOutSine;
+    else
+        g_logger.warning(stdext::format("unknown tween easing '%s'", std::string{ name }));
+    return static_self_cast<UITween>();
+}
+
+UITweenPtr UITween::setRepeat(const int count, const bool pingPong)
+{
+    m_repeatCount = std::max<int>(count, 0);
+    m_pingPong = pingPong;
+    return static_self_cast<UITween>();
+}
+
+void UITween::start()
+{
+    if (m_running || !m_widget)
+        return;
+
+    captureFrom();
+    m_startTicks = g_clock.millis() + m_delay;
+    m_running = true;
+    g_ui.addTween(static_self_cast<UITween>());
+}
+
+void UITween::stop()
+{
+    if (!m_running)
+        return;
+    m_running = false;
+    g_ui.removeTween(static_self_cast<UITween>());
+}
+
+void UITween::captureFrom()
+{
+    m_fromOpacity = m_widget->getOpacity();
+    m_fromPos = m_widget->getPosition();
+    m_fromColor = m_widget->getColor();
+}
+
+float UITween::ease(const Easing easing, const float t)
+{
+    switch (easing) {
+        case Easing::InQuad: return t * t;
+        case Easing::OutQuad: return 1.f - (1.f - t) * (1.f - t);
+        case Easing::InOutQuad: return t < 0.5f ? 2.f * t * t : 1.f - (2.f - 2.f * t) * (2.f - 2.f * t) / 2.f;
+        case Easing::InCubic: return t * t * t;
+        case Easing::OutCubic: return 1.f - (1.f - t) * (1.f - t) * (1.f - t);
+        case Easing::InOutCubic: return t < 0.5f ? 4.f * t * t * t : 1.f - (2.f - 2.f * t) * (2.f - 2.f * t) * (2.f - 2.f * t) / 2.f;
+        case Easing::InSine: return 1.f - std::cos(t * Fw::pi / 2.f);
+        case Easing::OutSine: return std::sin(t * Fw::pi / 2.f);
+        case Easing::InOutSine: return -(std::cos(t * Fw::pi) - 1.f) / 2.f;
+        default: return t;
+    }
+}
+
+void UITween::apply(const float t)
+{
+    const float v = ease(m_easing, t);
+
+    if (m_tweenOpacity)
+        m_widget->setOpacity(m_fromOpacity + (m_toOpacity - m_fromOpacity) * v);
+
+    if (m_tweenPos) {
+        const int x = m_fromPos.x + static_cast<int>(std::round((m_toPos.x - m_fromPos.x) * v));
+        const int y = m_fromPos.y + static_cast<int>(std::round((m_toPos.y - m_fromPos.y) * v));
+        m_widget->move(x, y);
+    }
+
+    if (m_tweenColor) {
+        m_widget->setColor(Color(m_fromColor.rF() + (m_toColor.rF() - m_fromColor.rF()) * v,
+                                 m_fromColor.gF() + (m_toColor.gF() - m_fromColor.gF()) * v,
+                                 m_fromColor.bF() + (m_toColor.bF() - m_fromColor.bF()) * v,
+                                 m_fromColor.aF() + (m_toColor.aF() - m_fromColor.aF()) * v));
+    }
+}
+
+bool UITween::update(const ticks_t now)
+{
+    if (!m_running)
+        return false;
+
+    if (now < m_startTicks)
+        return true; // still delayed
+
+    const ticks_t elapsed = now - m_startTicks;
+    const int cycle = elapsed / m_duration;
+
+    // finite tweens snap to their final value and fire onFinish once
+    if (m_repeatCount > 0 && cycle >= m_repeatCount) {
+        apply(m_pingPong && m_repeatCount % 2 == 0 ? 0.f : 1.f);
+        m_running = false;
+        callLuaField("onFinish");
+        return false;
+    }
+
+    float t = static_cast<float>(elapsed % m_duration) / m_duration;
+    if (m_pingPong && cycle % 2 == 1)
+        t = 1.f - t;
+    apply(t);
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+#include <framework/luaengine/luaobject.h>
+#include <framework/util/color.h>
+
+// native widget animation ticked once per frame by UIManager, replacing
+// per-effect Lua timers; configured through a chainable interface, e.g.
+//   widget:tween():fadeTo(0):setDuration(200):setEasing('outQuad'):start()
+// fires the onFinish lua field when the last cycle completes
+// @bindclass
+class UITween : public LuaObject
+{
+public:
+    UITween(UIWidgetPtr widget);
+
+    UITweenPtr fadeTo(float opacity);
+    UITweenPtr moveTo(const Point& pos);
+    UITweenPtr colorTo(const Color& color);
+    UITweenPtr setDuration(int duration);
+    UITweenPtr setDelay(int delay);
+    UITweenPtr setEasing(std::string_view name);
+    UITweenPtr setRepeat(int count, bool pingPong);
+
+    void start();
+    void stop();
+    bool isRunning() { return m_running; }
+    UIWidgetPtr getWidget() { return m_widget; }
+
+protected:
+    friend class UIManager;
+
+    // advances the animation; returns false once the tween finished
+    bool update(ticks_t now);
+
+private:
+    enum class Easing : uint8_t
+    {
+        Linear,
+        InQuad, OutQuad, InOutQuad,
+        InCubic, OutCubic, InOutCubic,
+        InSine, OutSine, InOutSine
+    };
+
+    static float ease(Easing easing, float t);
+    void apply(float t);
+    void captureFrom();
+
+    UIWidgetPtr m_widget;
+    Easing m_easing{ Easing::Linear };
+    int m_duration{ 250 };
+    int m_delay{ 0 };
+    int m_repeatCount{ 1 }; // 0 repeats until stopped
+    bool m_pingPong{ false };
+    bool m_running{ false };
+
+    bool m_tweenOpacity{ false };
+    bool m_tweenPos{ false };
+    bool m_tweenColor{ false };
+    float m_fromOpacity{ 1.f };
+    float m_toOpacity{ 1.f };
+    Point m_fromPos;
+    Point m_toPos;
+    Color m_fromColor;
+    Color m_toColor;
+
+    ticks_t m_startTicks{ 0 };
+};
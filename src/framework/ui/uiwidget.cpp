@@ -24,6 +24,7 @@
 #include "uianchorlayout.h"
 #include "uimanager.h"
 #include "uitranslator.h"
+#include "uitween.h"
 
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
@@ -32,6 +33,7 @@
 #include <framework/platform/platformwindow.h>
 
 #include "framework/graphics/drawpoolmanager.h"
+#include "framework/graphics/framebuffer.h"
 
 UIWidget::UIWidget()
 {
@@ -69,13 +71,34 @@ void UIWidget::draw(const Rect& visibleRect, DrawPoolType drawPane)
         g_drawPool.rotate(m_rect.center(), m_rotation * (Fw::pi / 180.0));
     }
 
-    drawSelf(drawPane);
+    if (canCacheRendering(drawPane)) {
+        if (m_cacheInvalid || !m_cacheBuffer || m_cacheBuffer->getSize() != m_rect.size()) {
+            m_cacheInvalid = false;
+            if (!m_cacheBuffer)
+                m_cacheBuffer = std::make_shared<FrameBuffer>();
 
-    if (!m_children.empty()) {
-        if (isClipping())
-            g_drawPool.setClipRect(visibleRect.intersection(getPaddingRect()));
+            g_drawPool.bindFrameBuffer(m_rect.size(), m_cacheBuffer);
 
-        drawChildren(visibleRect, drawPane);
+            // the subtree emits draws in screen coordinates, shift them to
+            // the framebuffer's origin
+            g_drawPool.translate(-m_rect.x(), -m_rect.y());
+
+            drawSelf(drawPane);
+            if (!m_children.empty())
+                drawChildren(m_rect, drawPane);
+
+            g_drawPool.releaseFrameBuffer(m_rect, m_cacheBuffer);
+        } else
+            g_drawPool.drawFrameBuffer(m_cacheBuffer, m_rect);
+    } else {
+        drawSelf(drawPane);
+
+        if (!m_children.empty()) {
+            if (isClipping())
+                g_drawPool.setClipRect(visibleRect.intersection(getPaddingRect()));
+
+            drawChildren(visibleRect, drawPane);
+        }
     }
 
     if (m_rotation != 0.0f)
@@ -86,6 +109,14 @@ void UIWidget::draw(const Rect& visibleRect, DrawPoolType drawPane)
     }
 }
 
+bool UIWidget::canCacheRendering(const DrawPoolType drawPane)
+{
+    // clipping widgets and debug boxes scissor/draw in screen space, both
+    // take the direct path
+    return hasProp(PropCachedRendering) && drawPane == DrawPoolType::FOREGROUND &&
+        m_rect.isValid() && !isClipping() && !g_ui.isDrawingDebugBoxes();
+}
+
 void UIWidget::drawSelf(DrawPoolType drawPane)
 {
     if (drawPane != DrawPoolType::FOREGROUND)
@@ -166,6 +197,7 @@ void UIWidget::addChild(const UIWidgetPtr& child)
 
     // add to layout and updates it
     m_layout->addWidget(child);
+    repaint();
 
     // update new child states
     child->updateStates();
@@ -231,6 +263,7 @@ void UIWidget::insertChild(size_t index, const UIWidgetPtr& child)
 
     // add to layout and updates it
     m_layout->addWidget(child);
+    repaint();
 
     // update new child states
     child->updateStates();
@@ -269,6 +302,7 @@ void UIWidget::removeChild(const UIWidgetPtr& child)
         child->setParent(nullptr);
 
         m_layout->removeWidget(child);
+        repaint();
 
         // remove access to child via widget.childId
         if (child->hasProp(PropCustomId)) {
@@ -585,6 +619,7 @@ void UIWidget::mergeStyle(const OTMLNodePtr& styleNode)
     m_style->merge(styleNode);
     m_style->setTag(name);
     m_style->setSource(source);
+    compileStateStyles();
     updateStyle();
 }
 
@@ -887,6 +922,11 @@ void UIWidget::destroyChildren()
         layout->enableUpdates();
 }
 
+UITweenPtr UIWidget::tween()
+{
+    return std::make_shared<UITween>(static_self_cast<UIWidget>());
+}
+
 void UIWidget::setId(const std::string_view id)
 {
     if (id == m_id)
@@ -983,6 +1023,7 @@ bool UIWidget::setRect(const Rect& rect)
 
     Rect oldRect = m_rect;
     m_rect = clampedRect;
+    repaint();
 
     // updates own layout
     updateLayout();
@@ -1021,6 +1062,7 @@ void UIWidget::setStyle(const std::string_view styleName)
     styleNode = styleNode->clone();
     applyStyle(styleNode);
     m_style = styleNode;
+    compileStateStyles();
     updateStyle();
 }
 
@@ -1028,6 +1070,7 @@ void UIWidget::setStyleFromNode(const OTMLNodePtr& styleNode)
 {
     applyStyle(styleNode);
     m_style = styleNode;
+    compileStateStyles();
     updateStyle();
 }
 
@@ -1050,6 +1093,8 @@ void UIWidget::setVisible(bool visible)
         return;
 
     setProp(PropVisible, visible);
+    g_ui.invalidateHitIndex();
+    repaint();
 
     // hiding a widget make it lose focus
     if (!visible && isFocused()) {
@@ -1555,6 +1600,21 @@ void UIWidget::updateStyle()
     if (!m_style)
         return;
 
+    // match the precompiled state selectors against the current states
+    int64_t matched = 0;
+    for (size_t i = 0; i < m_stateStyleSelectors.size(); ++i) {
+        const auto& selector = m_stateStyleSelectors[i];
+        if ((m_states & selector.statesOn) == selector.statesOn && (m_states & selector.statesOff) == 0)
+            matched |= static_cast<int64_t>(1) << i;
+    }
+
+    // the styled look only depends on which selectors match; when the set is
+    // unchanged (most state flips while hovering across widgets) there is
+    // nothing to re-apply and no OTML conversion happens at all
+    if (matched == m_matchedStateStyles && m_stateStyleSelectors.size() < 64)
+        return;
+    m_matchedStateStyles = matched;
+
     const auto& newStateStyle = OTMLNode::create();
 
     // copy only the changed styles from default style
@@ -1565,39 +1625,50 @@ void UIWidget::updateStyle()
         }
     }
 
-    // checks for states combination
-    for (const auto& style : m_style->children()) {
-        if (style->tag().starts_with("$")) {
-            std::string statesStr = style->tag().substr(1);
-            std::vector<std::string> statesSplit = stdext::split(statesStr, " ");
-
-            bool match = true;
-            for (std::string stateStr : statesSplit) {
-                if (stateStr.length() == 0)
-                    continue;
-
-                const bool notstate = (stateStr[0] == '!');
-                if (notstate)
-                    stateStr = stateStr.substr(1);
-
-                const bool stateOn = hasState(Fw::translateState(stateStr));
-                if ((!notstate && !stateOn) || (notstate && stateOn))
-                    match = false;
-            }
-
-            // merge states styles
-            if (match) {
-                newStateStyle->merge(style);
-            }
-        }
+    // merge states styles
+    for (size_t i = 0; i < m_stateStyleSelectors.size(); ++i) {
+        if (matched & (static_cast<int64_t>(1) << i))
+            newStateStyle->merge(m_stateStyleSelectors[i].node);
     }
 
-    //TODO: prevent setting already set proprieties
-
     applyStyle(newStateStyle);
     m_stateStyle = newStateStyle;
 }
 
+void UIWidget::compileStateStyles()
+{
+    m_stateStyleSelectors.clear();
+    m_matchedStateStyles = -1;
+
+    if (!m_style)
+        return;
+
+    for (const auto& style : m_style->children()) {
+        if (!style->tag().starts_with("$"))
+            continue;
+
+        StateStyleSelector selector;
+        selector.node = style;
+
+        for (std::string stateStr : stdext::split(style->tag().substr(1), " ")) {
+            if (stateStr.empty())
+                continue;
+
+            const bool notstate = (stateStr[0] == '!');
+            if (notstate)
+                stateStr = stateStr.substr(1);
+
+            const int32_t state = Fw::translateState(stateStr);
+            if (notstate)
+                selector.statesOff |= state;
+            else
+                selector.statesOn |= state;
+        }
+
+        m_stateStyleSelectors.emplace_back(std::move(selector));
+    }
+}
+
 void UIWidget::onStyleApply(const std::string_view, const OTMLNodePtr& styleNode)
 {
     if (isDestroyed())
@@ -1878,4 +1949,28 @@ void UIWidget::move(int x, int y) {
     m_rect = { x, y, getSize() };
 }
 
-void UIWidget::repaint() { g_app.repaint(); }
+void UIWidget::repaint()
+{
+    // any change that repaints also stales every cached surface it is part of
+    for (auto* widget = this; widget; widget = widget->m_parent.get()) {
+        if (widget->hasProp(PropCachedRendering))
+            widget->m_cacheInvalid = true;
+    }
+
+    g_app.repaint();
+}
+
+void UIWidget::setCachedRendering(const bool enable)
+{
+    if (hasProp(PropCachedRendering) == enable)
+        return;
+
+    setProp(PropCachedRendering, enable);
+    m_cacheInvalid = true;
+
+    // the framebuffer is recreated on demand when re-enabled
+    if (!enable)
+        m_cacheBuffer = nullptr;
+
+    repaint();
+}
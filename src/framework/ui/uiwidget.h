@@ -68,7 +68,8 @@ enum FlagProp : uint32_t
     PropImageFixedRatio = 1 << 19,
     PropImageRepeated = 1 << 20,
     PropImageSmooth = 1 << 21,
-    PropImageAutoResize = 1 << 22
+    PropImageAutoResize = 1 << 22,
+    PropCachedRendering = 1 << 23
 };
 
 // @bindclass
@@ -145,6 +146,9 @@ public:
     void destroy();
     void destroyChildren();
 
+    // creates a tween targeting this widget; configure and start() it
+    UITweenPtr tween();
+
     void setId(const std::string_view id);
     void setParent(const UIWidgetPtr& parent);
     void setLayout(const UILayoutPtr& layout);
@@ -160,6 +164,10 @@ public:
     void setDraggable(bool draggable);
     void setFixedSize(bool fixed);
     void setClipping(bool clipping) { setProp(PropClipping, clipping); }
+    // renders the subtree into an owned framebuffer and blits one quad per
+    // frame until something invalidates it; meant for mostly static panels,
+    // clipping children inside the subtree are not supported
+    void setCachedRendering(bool enable);
     void setLastFocusReason(Fw::FocusReason reason);
     void setAutoFocusPolicy(Fw::AutoFocusPolicy policy);
     void setAutoRepeatDelay(int delay) { m_autoRepeatDelay = delay; }
@@ -193,8 +201,14 @@ public:
     bool hasProp(FlagProp prop) { return (m_flagsProp & prop); }
 private:
     void repaint();
+    bool canCacheRendering(DrawPoolType drawPane);
+
     uint32_t m_flagsProp{ 0 };
 
+    // cached-surface rendering, see setCachedRendering()
+    FrameBufferPtr m_cacheBuffer;
+    bool m_cacheInvalid{ true };
+
     // state managment
 protected:
 
@@ -207,6 +221,19 @@ private:
     void updateStates();
     void updateChildrenIndexStates();
     void updateStyle();
+    void compileStateStyles();
+
+    // '$state' selectors parsed once per style, so state changes match with
+    // two bit tests instead of re-splitting and translating the tag strings
+    struct StateStyleSelector
+    {
+        int32_t statesOn{ 0 };
+        int32_t statesOff{ 0 };
+        OTMLNodePtr node;
+    };
+
+    std::vector<StateStyleSelector> m_stateStyleSelectors;
+    int64_t m_matchedStateStyles{ -1 };
 
     OTMLNodePtr m_stateStyle;
     int32_t m_states{ Fw::DefaultState };
@@ -276,6 +303,7 @@ public:
     bool isDraggable() { return hasProp(PropDraggable); }
     bool isFixedSize() { return hasProp(PropFixedSize); }
     bool isClipping() { return hasProp(PropClipping); }
+    bool isCachedRendering() { return hasProp(PropCachedRendering); }
     bool isDestroyed() { return hasProp(PropDestroyed); }
 
     bool isFirstChild() { return m_parent && m_childIndex == 1; }
@@ -446,7 +474,7 @@ private:
     void initImage();
     void parseImageStyle(const OTMLNodePtr& styleNode);
 
-    void updateImageCache() { if (!m_imageCachedScreenCoords.isNull()) m_imageCachedScreenCoords = {}; }
+    void updateImageCache() { if (!m_imageCachedScreenCoords.isNull()) m_imageCachedScreenCoords = {}; repaint(); }
     void configureBorderImage() { setProp(PropImageBordered, true); updateImageCache(); }
 
     std::vector<std::pair<Rect, Rect>> m_imageCoordsCache;
@@ -527,6 +555,7 @@ protected:
     std::string m_drawText;
     Fw::AlignmentFlag m_textAlign;
     Point m_textOffset;
+    float m_fontScale{ 1.f };
 
     BitmapFontPtr m_font;
 
@@ -543,6 +572,9 @@ public:
     void setTextVerticalAutoResize(bool textAutoResize) { setProp(PropTextVerticalAutoResize, textAutoResize); updateText(); }
     void setTextOnlyUpperCase(bool textOnlyUpperCase) { setProp(PropTextOnlyUpperCase, textOnlyUpperCase); setText(m_text); }
     void setFont(const std::string_view fontName);
+    // scaled text renders through the font's distance-field sheet, staying
+    // crisp at fractional factors instead of blurring the bitmap glyphs
+    void setFontScale(float scale) { m_fontScale = scale; updateText(); }
 
     std::string getText() { return m_text; }
     std::string getDrawText() { return m_drawText; }
@@ -550,5 +582,6 @@ public:
     Point getTextOffset() { return m_textOffset; }
     bool isTextWrap() { return hasProp(PropTextWrap); }
     std::string getFont() { return m_font->getName(); }
+    float getFontScale() { return m_fontScale; }
     Size getTextSize() { return m_textSize; }
 };
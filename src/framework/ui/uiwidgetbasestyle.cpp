@@ -163,6 +163,8 @@ void UIWidget::parseBaseStyle(const OTMLNodePtr& styleNode)
             setMaxSize(node->value<Size>());
         else if (node->tag() == "clipping")
             setClipping(node->value<bool>());
+        else if (node->tag() == "cached-rendering")
+            setCachedRendering(node->value<bool>());
         else if (node->tag() == "border") {
             const auto& split = stdext::split(node->value(), " ");
             if (split.size() == 2) {
@@ -321,11 +323,13 @@ void UIWidget::parseBaseStyle(const OTMLNodePtr& styleNode)
                 if (node->value() == "none") {
                     removeAnchor(anchoredEdge);
                 } else {
-                    std::vector<std::string> split = stdext::split(node->value(), ".");
+                    const auto& value = node->value();
+                    stdext::split_string_views split;
+                    stdext::split_view(value, split, ".");
                     if (split.size() != 2)
                         throw OTMLException(node, "invalid anchor description");
 
-                    std::string hookedWidgetId = split[0];
+                    const auto hookedWidgetId = split[0];
                     Fw::AnchorEdge hookedEdge = Fw::translateAnchorEdge(split[1]);
 
                     if (anchoredEdge == Fw::AnchorNone)
@@ -401,7 +405,7 @@ void UIWidget::drawIcon(const Rect& screenCoords) const
 void UIWidget::setIcon(const std::string& iconFile)
 {
     g_mainDispatcher.addEvent([&, iconFile = iconFile]() {
-        m_icon = iconFile.empty() ? nullptr : g_textures.getTexture(iconFile);
+        m_icon = iconFile.empty() ? nullptr : g_textures.getUiAtlasTexture(iconFile);
         if (m_icon && !m_iconClipRect.isValid()) {
             m_iconClipRect = Rect(0, 0, m_icon->getSize());
         }
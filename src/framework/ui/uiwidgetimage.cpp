@@ -181,7 +181,7 @@ void UIWidget::setImageSource(const std::string_view source)
         return;
     }
 
-    m_imageTexture = g_textures.getTexture(m_imageSource = source);
+    m_imageTexture = g_textures.getUiAtlasTexture(m_imageSource = source);
     if (!m_imageTexture)
         return;
 
@@ -23,6 +23,7 @@
 #include <framework/core/graphicalapplication.h>
 #include <framework/graphics/drawpoolmanager.h>
 #include <framework/graphics/fontmanager.h>
+#include <framework/graphics/painter.h>
 #include "uitranslator.h"
 #include "uiwidget.h"
 
@@ -36,13 +37,18 @@ void UIWidget::initText()
 void UIWidget::updateText()
 {
     if (isTextWrap() && m_rect.isValid())
-        m_drawText = m_font->wrapText(m_text, getWidth() - m_textOffset.x);
+        m_drawText = m_font->wrapText(m_text, static_cast<int>((getWidth() - m_textOffset.x) / m_fontScale));
     else
         m_drawText = m_text;
 
     if (m_font)
         m_glyphsPositionsCache = m_font->calculateGlyphsPositions(m_drawText, m_textAlign, &m_textSize);
 
+    // layout sees the scaled text box, the glyph quads grow to match in drawText
+    if (m_fontScale != 1.f)
+        m_textSize = Size(static_cast<int>(std::ceil(m_textSize.width() * m_fontScale)),
+                          static_cast<int>(std::ceil(m_textSize.height() * m_fontScale)));
+
     // update rect size
     if (!m_rect.isValid() || hasProp(PropTextHorizontalAutoResize) || hasProp(PropTextVerticalAutoResize)) {
         Size textBoxSize = m_textSize;
@@ -56,7 +62,7 @@ void UIWidget::updateText()
     }
 
     m_textCachedScreenCoords = {};
-    g_app.repaint();
+    repaint();
 }
 
 void UIWidget::resizeToText()
@@ -89,6 +95,8 @@ void UIWidget::parseTextStyle(const OTMLNodePtr& styleNode)
             setTextOnlyUpperCase(node->value<bool>());
         else if (node->tag() == "font")
             setFont(node->value());
+        else if (node->tag() == "font-scale")
+            setFontScale(node->value<float>());
     }
 }
 
@@ -102,10 +110,22 @@ void UIWidget::drawText(const Rect& screenCoords)
 
         auto coords = Rect(screenCoords.topLeft(), screenCoords.bottomRight());
         coords.translate(m_textOffset);
-        m_font->fillTextCoords(m_coordsBuffer, m_text, m_textSize, m_textAlign, coords, m_glyphsPositionsCache);
+        m_font->fillTextCoords(m_coordsBuffer, m_text, m_textSize, m_textAlign, coords, m_glyphsPositionsCache, m_fontScale);
     }
 
-    g_drawPool.addTexturedCoordsBuffer(m_font->getTexture(), m_coordsBuffer, m_color);
+    const auto& sdfTexture = m_fontScale != 1.f ? m_font->getSdfTexture() : nullptr;
+    if (sdfTexture) {
+        // distance-field glyphs keep a sharp outline at any scale, the
+        // smoothing window stays about one screen pixel wide
+        const float smoothing = BitmapFont::getSdfSmoothing(m_fontScale);
+        g_drawPool.setShaderProgram(g_painter->getTextSdfShader(), true, [smoothing] {
+            const auto& shader = g_painter->getTextSdfShader();
+            shader->bind();
+            shader->setUniformValue("u_Smoothing", smoothing);
+        });
+        g_drawPool.addTexturedCoordsBuffer(sdfTexture, m_coordsBuffer, m_color);
+    } else
+        g_drawPool.addTexturedCoordsBuffer(m_font->getTexture(), m_coordsBuffer, m_color);
 }
 
 void UIWidget::onTextChange(const std::string_view text, const std::string_view oldText)
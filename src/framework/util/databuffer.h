@@ -24,21 +24,29 @@
 
 #include <algorithm>
 
-template<class T>
+// buffers up to INLINE_CAPACITY elements live in the object itself; the
+// default covers ~256 bytes, enough for most OTML values and net payload
+// fragments, so small serialization buffers never touch the heap
+template<class T, uint32_t INLINE_CAPACITY = std::max<uint32_t>(1, 256 / sizeof(T))>
 class DataBuffer
 {
 public:
-    DataBuffer(uint32_t res = 64) : m_capacity(res), m_buffer(new T[m_capacity]) {}
-    ~DataBuffer() { delete[] m_buffer; }
+    DataBuffer(uint32_t res = INLINE_CAPACITY) { reserve(res); }
+    ~DataBuffer() { if (m_buffer != m_inline) delete[] m_buffer; }
+
+    DataBuffer(const DataBuffer&) = delete;
+    DataBuffer& operator=(const DataBuffer&) = delete;
 
     void reset() { m_size = 0; }
 
     void clear()
     {
         m_size = 0;
-        m_capacity = 0;
-        delete[] m_buffer;
-        m_buffer = nullptr;
+        if (m_buffer != m_inline) {
+            delete[] m_buffer;
+            m_buffer = m_inline;
+            m_capacity = INLINE_CAPACITY;
+        }
     }
 
     bool empty() const { return m_size == 0; }
@@ -58,7 +66,8 @@ public:
 
             std::copy(m_buffer, m_buffer + m_size, buffer);
 
-            delete[] m_buffer;
+            if (m_buffer != m_inline)
+                delete[] m_buffer;
             m_buffer = buffer;
             m_capacity = n;
         }
@@ -79,8 +88,13 @@ public:
         if (n <= m_size)
             return;
         if (n > m_capacity) {
-            uint32_t newcapacity = m_capacity;
-            do { newcapacity *= 2; } while (newcapacity < n);
+            // amortized 1.5x growth rounded up to whole blocks; fewer
+            // reallocations than element-wise doubling without doubling
+            // the waste on large streams
+            uint32_t newcapacity = m_capacity + (m_capacity / 2);
+            if (newcapacity < n)
+                newcapacity = n;
+            newcapacity = (newcapacity + GROWTH_BLOCK - 1) & ~(GROWTH_BLOCK - 1);
             reserve(newcapacity);
         }
         m_size = n;
@@ -92,28 +106,22 @@ public:
         m_buffer[m_size - 1] = v;
     }
 
-    void append(const DataBuffer<T>* v)
+    template<uint32_t N>
+    void append(const DataBuffer<T, N>* v)
     {
-        const uint32_t sumSize = m_size + v->m_size;
-        if (sumSize > m_capacity) {
-            m_capacity = sumSize * 2;
-            T* buffer = new T[m_capacity];
-
-            std::copy(v->m_buffer, v->m_buffer + v->m_size,
-                      std::copy(m_buffer, m_buffer + m_size, buffer));
-
-            delete[] m_buffer;
-            m_buffer = buffer;
-        } else {
-            std::copy(v->m_buffer, v->m_buffer + v->m_size, m_buffer + m_size);
-        }
+        const uint32_t sumSize = m_size + v->size();
+        reserve(std::max<uint32_t>(sumSize, m_capacity + m_capacity / 2));
+        std::copy(v->data(), v->data() + v->size(), m_buffer + m_size);
         m_size = sumSize;
     }
 
     DataBuffer& operator<<(const T& t) { add(t); return *this; }
 
 private:
+    static constexpr uint32_t GROWTH_BLOCK = 64;
+
     uint32_t m_size{ 0 };
-    uint32_t m_capacity;
-    T* m_buffer;
+    uint32_t m_capacity{ INLINE_CAPACITY };
+    T* m_buffer{ m_inline };
+    T m_inline[INLINE_CAPACITY];
 };
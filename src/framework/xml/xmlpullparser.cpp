@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "xmlpullparser.h"
+
+namespace
+{
+    bool isSpaceChar(const char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+}
+
+XmlPullParser::Token XmlPullParser::next()
+{
+    if (m_selfClosing) {
+        m_selfClosing = false;
+        --m_depth;
+        return Token::EndElement;
+    }
+
+    while (m_pos < m_buffer.size()) {
+        const size_t open = m_buffer.find('<', m_pos);
+        if (open == std::string_view::npos || open + 1 >= m_buffer.size())
+            break;
+        m_pos = open + 1;
+
+        const char c = m_buffer[m_pos];
+        if (c == '?') { // xml declaration
+            if ((m_pos = m_buffer.find("?>", m_pos)) == std::string_view::npos)
+                break;
+            m_pos += 2;
+            continue;
+        }
+
+        if (c == '!') { // comment, doctype or cdata
+            if (m_buffer.compare(m_pos, 3, "!--") == 0) {
+                if ((m_pos = m_buffer.find("-->", m_pos)) == std::string_view::npos)
+                    break;
+                m_pos += 3;
+            } else {
+                if ((m_pos = m_buffer.find('>', m_pos)) == std::string_view::npos)
+                    break;
+                ++m_pos;
+            }
+            continue;
+        }
+
+        if (c == '/') { // closing tag
+            ++m_pos;
+            const size_t end = m_buffer.find('>', m_pos);
+            if (end == std::string_view::npos)
+                break;
+
+            size_t nameEnd = m_pos;
+            while (nameEnd < end && !isSpaceChar(m_buffer[nameEnd]))
+                ++nameEnd;
+            m_name = m_buffer.substr(m_pos, nameEnd - m_pos);
+            m_attributes.clear();
+            m_pos = end + 1;
+            --m_depth;
+            return Token::EndElement;
+        }
+
+        // opening tag
+        const size_t end = m_buffer.find('>', m_pos);
+        if (end == std::string_view::npos)
+            break;
+
+        size_t nameEnd = m_pos;
+        while (nameEnd < end && !isSpaceChar(m_buffer[nameEnd]) && m_buffer[nameEnd] != '/')
+            ++nameEnd;
+        m_name = m_buffer.substr(m_pos, nameEnd - m_pos);
+        m_selfClosing = end > m_pos && m_buffer[end - 1] == '/';
+        parseAttributes(nameEnd, m_selfClosing ? end - 1 : end);
+        m_pos = end + 1;
+        ++m_depth;
+        return Token::StartElement;
+    }
+
+    m_pos = m_buffer.size();
+    return Token::End;
+}
+
+void XmlPullParser::parseAttributes(size_t pos, const size_t end)
+{
+    m_attributes.clear();
+
+    while (pos < end) {
+        while (pos < end && isSpaceChar(m_buffer[pos]))
+            ++pos;
+        if (pos >= end)
+            break;
+
+        const size_t nameStart = pos;
+        while (pos < end && m_buffer[pos] != '=' && !isSpaceChar(m_buffer[pos]))
+            ++pos;
+        const auto name = m_buffer.substr(nameStart, pos - nameStart);
+
+        while (pos < end && (isSpaceChar(m_buffer[pos]) || m_buffer[pos] == '='))
+            ++pos;
+        if (pos >= end)
+            break;
+
+        std::string_view value;
+        if (const char quote = m_buffer[pos]; quote == '"' || quote == '\'') {
+            ++pos;
+            const size_t valueEnd = m_buffer.find(quote, pos);
+            if (valueEnd == std::string_view::npos || valueEnd > end)
+                break;
+            value = m_buffer.substr(pos, valueEnd - pos);
+            pos = valueEnd + 1;
+        } else { // unquoted value, read until whitespace
+            const size_t valueStart = pos;
+            while (pos < end && !isSpaceChar(m_buffer[pos]))
+                ++pos;
+            value = m_buffer.substr(valueStart, pos - valueStart);
+        }
+
+        if (!name.empty())
+            m_attributes.emplace_back(name, value);
+    }
+}
+
+bool XmlPullParser::hasAttribute(const std::string_view name) const
+{
+    for (const auto& [attrName, value] : m_attributes) {
+        if (attrName == name)
+            return true;
+    }
+    return false;
+}
+
+std::string_view XmlPullParser::rawAttribute(const std::string_view name) const
+{
+    for (const auto& [attrName, value] : m_attributes) {
+        if (attrName == name)
+            return value;
+    }
+    return {};
+}
+
+std::string XmlPullParser::attribute(const std::string_view name) const
+{
+    const auto raw = rawAttribute(name);
+    if (raw.find('&') == std::string_view::npos)
+        return std::string{ raw };
+
+    static constexpr std::pair<std::string_view, char> ENTITIES[] = {
+        { "&amp;", '&' }, { "&lt;", '<' }, { "&gt;", '>' }, { "&quot;", '"' }, { "&apos;", '\'' }
+    };
+
+    std::string decoded;
+    decoded.reserve(raw.size());
+    for (size_t i = 0; i < raw.size();) {
+        bool matched = false;
+        if (raw[i] == '&') {
+            for (const auto& [sequence, character] : ENTITIES) {
+                if (raw.compare(i, sequence.size(), sequence) == 0) {
+                    decoded += character;
+                    i += sequence.size();
+                    matched = true;
+                    break;
+                }
+            }
+        }
+        if (!matched)
+            decoded += raw[i++];
+    }
+    return decoded;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2010-2022 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/stdext/string.h>
+
+ // streaming pull-parser for the attribute-only XML data files the client
+ // loads in bulk (spawns, monsters, houses); it walks the buffer in place
+ // and never builds a DOM, so a multi-megabyte spawn file parses without
+ // per-node heap allocations. it deliberately supports only the XML subset
+ // those files use: element values must not contain a literal '>'
+class XmlPullParser
+{
+public:
+    enum class Token { StartElement, EndElement, End };
+
+    // the buffer must outlive the parser, names and attributes are views
+    // into it
+    explicit XmlPullParser(const std::string_view buffer) : m_buffer(buffer) {}
+
+    // advances to the next element boundary; a self-closing tag yields a
+    // StartElement followed by an EndElement
+    Token next();
+
+    std::string_view name() const { return m_name; }
+
+    // nesting depth of the current element, the root element is at 1;
+    // decremented before an EndElement is reported
+    int depth() const { return m_depth; }
+
+    bool hasAttribute(std::string_view name) const;
+
+    // attribute value with the common entities decoded, empty when absent
+    std::string attribute(std::string_view name) const;
+
+    // typed attribute read mirroring TiXmlElement::readType, a missing
+    // attribute silently yields a default constructed value
+    template<typename T>
+    T readType(const std::string_view name) const
+    {
+        const auto value = rawAttribute(name);
+        if (value.empty())
+            return T();
+        return stdext::from_string<T>(value);
+    }
+
+private:
+    std::string_view rawAttribute(std::string_view name) const;
+    void parseAttributes(size_t pos, size_t end);
+
+    std::string_view m_buffer;
+    std::string_view m_name;
+    std::vector<std::pair<std::string_view, std::string_view>> m_attributes;
+    size_t m_pos{ 0 };
+    int m_depth{ 0 };
+    bool m_selfClosing{ false };
+};
@@ -89,6 +89,9 @@ int main(int argc, const char* argv[])
     g_app.terminate();
 #ifdef FRAMEWORK_NET
     g_http.terminate();
+#endif
+#if ENABLE_DISCORD_RPC == 1
+    g_discord.terminate();
 #endif
     return 0;
 }